@@ -0,0 +1,448 @@
+// Native benchmark suite. Every scenario initializes the library through the C API, runs the
+// producers and reports throughput and per-call latency percentiles as JSON.
+//
+//   mlogger_bench [--out <file>] [--filter <substring>] [--ops <per thread>] [--dir <log dir>]
+//                 [--list]
+//
+// JSON goes to stdout (or --out), a readable summary to stderr.
+
+// NOTE: every level compiled in, the filtered_inline scenarios measure the runtime check
+#define MLOGGER_ACTIVE_LEVEL LOG_TRACE
+#include "bridge/mlogger.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+enum class Operation
+{
+    message,           // logMessage() at a level that is written
+    filtered,          // logMessage() below min_log_level
+    filtered_inline,   // mlogger::log() below min_log_level, checked by the caller (mlogger.h)
+    exception,         // logException() with a Unity sized stack trace
+    utf16,             // logMessageUtf16() with the characters of a C# string
+};
+
+struct Scenario {
+    std::string name;
+    Operation   operation     = Operation::message;
+    int         async_mode    = ASYNC_MODE_OFF;
+    int         file_format   = LOG_FILE_TEXT;
+    int         file_writer   = LOG_WRITER_STDIO;
+    int         clock_source  = LOG_CLOCK_SYSTEM;
+    int         threads       = 1;
+    size_t      message_size  = 64;
+    uint64_t    max_file_size = 64 * 1024 * 1024;
+};
+
+struct Result {
+    size_t   ops         = 0;
+    double   ns_per_op   = 0.0;
+    double   ops_per_sec = 0.0;
+    uint64_t p50_ns      = 0;
+    uint64_t p99_ns      = 0;
+    uint64_t p999_ns     = 0;
+    uint64_t max_ns      = 0;
+    double   drain_ms    = 0.0;   // terminate(), the time the backend needs to catch up
+    uint64_t dropped     = 0;
+};
+
+struct Options {
+    std::string out_path;
+    std::string filter;
+    std::string log_dir        = "bench_logs";
+    size_t      ops_per_thread = 20000;
+    bool        list           = false;
+};
+
+const char* modeName(int async_mode)
+{
+    switch (async_mode) {
+    case ASYNC_MODE_THREAD_POOL: return "async";
+    case ASYNC_MODE_STAGING: return "staging";
+    default: return "sync";
+    }
+}
+
+const char* operationName(Operation operation)
+{
+    switch (operation) {
+    case Operation::filtered: return "filtered";
+    case Operation::filtered_inline: return "filtered_inline";
+    case Operation::exception: return "exception";
+    case Operation::utf16: return "utf16";
+    default: return "message";
+    }
+}
+
+std::string sizeName(size_t size)
+{
+    return size >= 1024 ? std::to_string(size / 1024) + "KB" : std::to_string(size) + "B";
+}
+
+std::vector<Scenario> buildScenarios()
+{
+    const int    async_modes[] = {ASYNC_MODE_OFF, ASYNC_MODE_THREAD_POOL, ASYNC_MODE_STAGING};
+    const size_t sizes[]       = {16, 256, 4096, 16384};
+
+    unsigned         hardware    = std::max(2u, std::thread::hardware_concurrency());
+    int              max_threads = static_cast<int>(std::min(hardware, 16u));
+    std::vector<int> thread_counts;
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        thread_counts.push_back(threads);
+    }
+
+    std::vector<Scenario> scenarios;
+    for (int mode : async_modes) {
+        for (int threads : thread_counts) {
+            for (size_t size : sizes) {
+                Scenario scenario;
+                scenario.name = std::string("message/") + modeName(mode) + "/" +
+                                std::to_string(threads) + "t/" + sizeName(size);
+                scenario.async_mode   = mode;
+                scenario.threads      = threads;
+                scenario.message_size = size;
+                scenarios.push_back(scenario);
+            }
+        }
+    }
+
+    for (int mode : async_modes) {
+        Scenario filtered;
+        filtered.name       = std::string("filtered/") + modeName(mode) + "/1t";
+        filtered.operation  = Operation::filtered;
+        filtered.async_mode = mode;
+        scenarios.push_back(filtered);
+
+        Scenario inline_filtered;
+        inline_filtered.name       = std::string("filtered/inline/") + modeName(mode) + "/1t";
+        inline_filtered.operation  = Operation::filtered_inline;
+        inline_filtered.async_mode = mode;
+        scenarios.push_back(inline_filtered);
+
+        Scenario exception;
+        exception.name         = std::string("exception/") + modeName(mode) + "/1t/8KB";
+        exception.operation    = Operation::exception;
+        exception.async_mode   = mode;
+        exception.message_size = 8 * 1024;
+        scenarios.push_back(exception);
+    }
+
+    // small files so a rotation happens every few hundred records, its cost shows in p999/max
+    for (int mode : {ASYNC_MODE_OFF, ASYNC_MODE_THREAD_POOL}) {
+        Scenario rotation;
+        rotation.name          = std::string("rotation/") + modeName(mode) + "/1t/256B";
+        rotation.async_mode    = mode;
+        rotation.message_size  = 256;
+        rotation.max_file_size = 64 * 1024;
+        scenarios.push_back(rotation);
+    }
+
+    Scenario binary;
+    binary.name         = "format/binary/sync/1t/256B";
+    binary.file_format  = LOG_FILE_BINARY;
+    binary.message_size = 256;
+    scenarios.push_back(binary);
+
+    Scenario mapped;
+    mapped.name         = "writer/mapped/sync/1t/256B";
+    mapped.file_writer  = LOG_WRITER_MAPPED;
+    mapped.message_size = 256;
+    scenarios.push_back(mapped);
+
+    // the producer side of timestamping, small records so the clock read is a visible share
+    for (int mode : {ASYNC_MODE_THREAD_POOL, ASYNC_MODE_STAGING}) {
+        Scenario clock;
+        clock.name         = std::string("clock/tsc/") + modeName(mode) + "/1t/16B";
+        clock.async_mode   = mode;
+        clock.clock_source = LOG_CLOCK_TSC;
+        clock.message_size = 16;
+        scenarios.push_back(clock);
+    }
+
+    // the same records as message/*, handed over as UTF-16 and converted by the writer
+    for (int mode : async_modes) {
+        for (size_t size : {size_t(256), size_t(4096)}) {
+            Scenario utf16;
+            utf16.name         = std::string("utf16/") + modeName(mode) + "/1t/" + sizeName(size);
+            utf16.operation    = Operation::utf16;
+            utf16.async_mode   = mode;
+            utf16.message_size = size;
+            scenarios.push_back(utf16);
+        }
+    }
+
+    return scenarios;
+}
+
+std::string makeStackTrace(size_t size)
+{
+    std::string trace;
+    for (int frame = 0; trace.size() < size; ++frame) {
+        trace += "  at Game.Systems.UpdateSystem.Frame" + std::to_string(frame) +
+                 " () [0x00010] in <6f1d5a3b>:0\n";
+    }
+    trace.resize(size);
+    return trace;
+}
+
+uint64_t percentile(std::vector<uint64_t>& samples, double fraction)
+{
+    if (samples.empty()) return 0;
+    size_t index = std::min(samples.size() - 1, static_cast<size_t>(fraction * samples.size()));
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
+
+bool runScenario(const Scenario& scenario, const Options& options, Result& result)
+{
+    std::filesystem::remove_all(options.log_dir);
+    std::string log_path = options.log_dir + "/bench.log";
+
+    MLoggerOptions init_options{};
+    init_options.struct_size      = sizeof(MLoggerOptions);
+    init_options.log_path         = log_path.c_str();
+    init_options.max_file_size    = scenario.max_file_size;
+    init_options.max_files        = 3;
+    init_options.async_mode       = scenario.async_mode;
+    init_options.thread_pool_size = 1;
+    init_options.min_log_level    = LOG_INFO;
+    init_options.file_format      = scenario.file_format;
+    init_options.file_writer      = scenario.file_writer;
+    init_options.clock_source     = scenario.clock_source;
+    if (initWithOptions(&init_options) != 1) {
+        return false;
+    }
+
+    // NOTE: large records are capped by volume so every scenario writes at most ~64MB
+    size_t ops = options.ops_per_thread;
+    if (scenario.operation != Operation::filtered &&
+        scenario.operation != Operation::filtered_inline) {
+        ops = std::max<size_t>(100, std::min(ops, (64u << 20) / scenario.message_size /
+                                                      static_cast<size_t>(scenario.threads)));
+    }
+
+    std::string payload(scenario.message_size, 'x');
+    std::string stack_trace = makeStackTrace(scenario.message_size);
+
+    std::u16string  wide(scenario.message_size, u'x');
+    const uint16_t* wide_units  = reinterpret_cast<const uint16_t*>(wide.data());
+    const int       wide_length = static_cast<int>(wide.size());
+
+    std::vector<std::vector<uint64_t>> latencies(static_cast<size_t>(scenario.threads));
+    std::atomic<int>                   ready{0};
+    std::atomic<bool>                  go{false};
+
+    auto producer = [&](int index) {
+        std::vector<uint64_t>& samples = latencies[static_cast<size_t>(index)];
+        samples.reserve(ops);
+        ready.fetch_add(1);
+        while (!go.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+
+        for (size_t i = 0; i < ops; ++i) {
+            auto start = Clock::now();
+            switch (scenario.operation) {
+            case Operation::message: logMessage(LOG_INFO, payload.c_str()); break;
+            case Operation::filtered: logMessage(LOG_DEBUG, payload.c_str()); break;
+            case Operation::filtered_inline: mlogger::log<LOG_DEBUG>(payload); break;
+            case Operation::exception:
+                logException("NullReferenceException", "bench", stack_trace.c_str());
+                break;
+            case Operation::utf16: logMessageUtf16(LOG_INFO, wide_units, wide_length); break;
+            }
+            auto stop = Clock::now();
+            samples.push_back(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count()));
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < scenario.threads; ++t) {
+        threads.emplace_back(producer, t);
+    }
+    while (ready.load() != scenario.threads) {
+        std::this_thread::yield();
+    }
+
+    auto start = Clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    auto produced = Clock::now();
+    result.dropped = getDroppedCount();
+    terminate();
+    auto drained = Clock::now();
+
+    std::vector<uint64_t> samples;
+    for (auto& thread_samples : latencies) {
+        samples.insert(samples.end(), thread_samples.begin(), thread_samples.end());
+    }
+
+    double wall_ns     = std::chrono::duration<double, std::nano>(produced - start).count();
+    result.ops         = samples.size();
+    result.ns_per_op   = wall_ns / static_cast<double>(result.ops);
+    result.ops_per_sec = static_cast<double>(result.ops) * 1e9 / wall_ns;
+    result.drain_ms    = std::chrono::duration<double, std::milli>(drained - produced).count();
+    result.max_ns      = *std::max_element(samples.begin(), samples.end());
+    result.p50_ns      = percentile(samples, 0.50);
+    result.p99_ns      = percentile(samples, 0.99);
+    result.p999_ns     = percentile(samples, 0.999);
+    return true;
+}
+
+std::string jsonString(const std::string& text)
+{
+    std::string quoted = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') quoted += '\\';
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+void writeJson(std::ostream& out, const std::vector<Scenario>& scenarios,
+               const std::vector<Result>& results, const Options& options)
+{
+    char buffer[640];
+    out << "{\n";
+    out << "  \"benchmark\": \"mlogger_bench\",\n";
+    out << "  \"timestamp\": " << static_cast<long long>(std::time(nullptr)) << ",\n";
+    out << "  \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n";
+    out << "  \"ops_per_thread\": " << options.ops_per_thread << ",\n";
+    out << "  \"results\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Scenario& scenario = scenarios[i];
+        const Result&   result   = results[i];
+        snprintf(buffer,
+                 sizeof(buffer),
+                 "\"operation\": \"%s\", \"mode\": \"%s\", \"format\": \"%s\", "
+                 "\"writer\": \"%s\", \"clock\": \"%s\", \"threads\": %d, \"message_size\": %zu, "
+                 "\"ops\": %zu, "
+                 "\"ns_per_op\": %.1f, \"ops_per_sec\": %.0f, \"p50_ns\": %llu, "
+                 "\"p99_ns\": %llu, \"p999_ns\": %llu, \"max_ns\": %llu, \"drain_ms\": %.2f, "
+                 "\"dropped\": %llu",
+                 operationName(scenario.operation),
+                 modeName(scenario.async_mode),
+                 scenario.file_format == LOG_FILE_BINARY ? "binary" : "text",
+                 scenario.file_writer == LOG_WRITER_MAPPED ? "mapped" : "stdio",
+                 scenario.clock_source == LOG_CLOCK_TSC ? "tsc" : "system",
+                 scenario.threads,
+                 scenario.message_size,
+                 result.ops,
+                 result.ns_per_op,
+                 result.ops_per_sec,
+                 static_cast<unsigned long long>(result.p50_ns),
+                 static_cast<unsigned long long>(result.p99_ns),
+                 static_cast<unsigned long long>(result.p999_ns),
+                 static_cast<unsigned long long>(result.max_ns),
+                 result.drain_ms,
+                 static_cast<unsigned long long>(result.dropped));
+        out << (i == 0 ? "\n" : ",\n") << "    {\"name\": " << jsonString(scenario.name) << ", "
+            << buffer << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+void printUsage(const char* program)
+{
+    std::cerr << "usage: " << program
+              << " [--out <file>] [--filter <substring>] [--ops <per thread>] [--dir <log dir>]"
+                 " [--list]\n";
+}
+
+bool parseOptions(int argc, char** argv, Options& options)
+{
+    for (int i = 1; i < argc; ++i) {
+        bool has_value = i + 1 < argc;
+        if (std::strcmp(argv[i], "--out") == 0 && has_value) {
+            options.out_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--filter") == 0 && has_value) {
+            options.filter = argv[++i];
+        } else if (std::strcmp(argv[i], "--dir") == 0 && has_value) {
+            options.log_dir = argv[++i];
+        } else if (std::strcmp(argv[i], "--ops") == 0 && has_value) {
+            options.ops_per_thread = std::strtoull(argv[++i], nullptr, 10);
+            if (options.ops_per_thread == 0) return false;
+        } else if (std::strcmp(argv[i], "--list") == 0) {
+            options.list = true;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+}   // namespace
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::vector<Scenario> scenarios;
+    for (const Scenario& scenario : buildScenarios()) {
+        if (scenario.name.find(options.filter) != std::string::npos) {
+            scenarios.push_back(scenario);
+        }
+    }
+    if (options.list) {
+        for (const Scenario& scenario : scenarios) {
+            std::cout << scenario.name << "\n";
+        }
+        return 0;
+    }
+
+    std::vector<Result> results;
+    for (const Scenario& scenario : scenarios) {
+        Result result;
+        if (!runScenario(scenario, options, result)) {
+            std::cerr << scenario.name << ": initialization failed\n";
+            return 1;
+        }
+        results.push_back(result);
+
+        char line[256];
+        snprintf(line,
+                 sizeof(line),
+                 "%-36s %10.1f ns/op  p50 %7llu  p99 %8llu  p999 %9llu ns\n",
+                 scenario.name.c_str(),
+                 result.ns_per_op,
+                 static_cast<unsigned long long>(result.p50_ns),
+                 static_cast<unsigned long long>(result.p99_ns),
+                 static_cast<unsigned long long>(result.p999_ns));
+        std::cerr << line;
+    }
+    std::filesystem::remove_all(options.log_dir);
+
+    if (options.out_path.empty()) {
+        writeJson(std::cout, scenarios, results, options);
+        return 0;
+    }
+    std::ofstream out(options.out_path);
+    if (!out.is_open()) {
+        std::cerr << options.out_path << ": cannot open file\n";
+        return 1;
+    }
+    writeJson(out, scenarios, results, options);
+    return out.good() ? 0 : 1;
+}
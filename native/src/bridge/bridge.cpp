@@ -1,33 +1,187 @@
 #include "bridge.h"
+#include "core/deferred_format.h"
 #include "core/logger_config.h"
 #include "core/logger_manager.h"
+#include "sinks/log_compressor.h"
+#include "sinks/uring_log_file.h"
+#include "utils/log_search.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
 #include <cstring>
+#include <vector>
 
 using namespace mlogger;
 
+static_assert(sizeof(std::atomic<int>) == sizeof(int) && std::atomic<int>::is_always_lock_free,
+              "level word must be readable as a plain int across the bridge");
+static_assert(LOG_TRACE == static_cast<int>(spdlog::level::trace) &&
+                  LOG_DEBUG == static_cast<int>(spdlog::level::debug) &&
+                  LOG_INFO == static_cast<int>(spdlog::level::info) &&
+                  LOG_WARN == static_cast<int>(spdlog::level::warn) &&
+                  LOG_ERROR == static_cast<int>(spdlog::level::err) &&
+                  LOG_CRITICAL == static_cast<int>(spdlog::level::critical),
+              "LogLevel values are passed to spdlog unchanged");
+static_assert(MLOGGER_LEVEL_INHERIT == LoggerManager::kLevelInherit &&
+                  MLOGGER_DEFAULT_CHANNEL == LoggerManager::kDefaultChannel,
+              "channel constants must match LoggerManager");
+static_assert(sizeof(LogRecord) == 24, "LogRecord layout is shared with managed code");
+static_assert(sizeof(LogField) == 24, "LogField layout is shared with managed code");
+static_assert(LOG_ARG_INT == static_cast<int>(FieldType::int64) &&
+                  LOG_ARG_DOUBLE == static_cast<int>(FieldType::float64) &&
+                  LOG_ARG_BOOL == static_cast<int>(FieldType::boolean) &&
+                  LOG_ARG_STRING == static_cast<int>(FieldType::string) &&
+                  LOG_ARG_FLOAT == static_cast<int>(FieldType::float32),
+              "argument types must match FieldType");
+static_assert(LOG_THREAD_NORMAL == static_cast<int>(ThreadPriority::normal) &&
+                  LOG_THREAD_LOW == static_cast<int>(ThreadPriority::low) &&
+                  LOG_THREAD_BACKGROUND == static_cast<int>(ThreadPriority::background),
+              "LogThreadPriority values must match ThreadPriority");
+static_assert(LOG_NETWORK_UDP == static_cast<int>(NetworkProtocol::udp) &&
+                  LOG_NETWORK_TCP == static_cast<int>(NetworkProtocol::tcp),
+              "LogNetworkProtocol values must match NetworkProtocol");
+static_assert(MLOGGER_LATENCY_BUCKETS == LoggerStats::kLatencyBuckets &&
+                  sizeof(MLoggerStats::messages) / sizeof(uint64_t) == LoggerStats::kLevels,
+              "MLoggerStats must match LoggerStats");
+
+// size of the first MLoggerOptions layout, later fields are appended after overflow_policy
+static constexpr size_t kMinOptionsSize =
+    offsetof(MLoggerOptions, overflow_policy) + sizeof(int32_t);
+
+// size of the first MLoggerStats layout, ending with latency_ns
+static constexpr size_t kMinStatsSize = offsetof(MLoggerStats, suppressed);
+
+// the LoggerConfig of `options`, false when they cannot be read
+static bool toConfig(const MLoggerOptions* options, LoggerConfig& config)
+{
+    if (!options || options->struct_size < kMinOptionsSize) {
+        return false;
+    }
+
+    // fields the caller does not know about stay zero, which means "default" for all of them
+    MLoggerOptions opts{};
+    std::memcpy(&opts, options, std::min<size_t>(options->struct_size, sizeof(MLoggerOptions)));
+    if (!opts.log_path) {
+        return false;
+    }
+
+    config.log_path         = opts.log_path;
+    config.max_file_size    = static_cast<size_t>(opts.max_file_size);
+    config.max_files        = opts.max_files;
+    config.async_mode       = (opts.async_mode != ASYNC_MODE_OFF);
+    config.async_backend    = opts.async_mode == ASYNC_MODE_STAGING ? AsyncBackend::staging_rings
+                                                                    : AsyncBackend::thread_pool;
+    config.thread_pool_size = opts.thread_pool_size;
+    config.min_log_level    = opts.min_log_level;
+    config.overflow_policy  = static_cast<OverflowPolicy>(opts.overflow_policy);
+    config.file_format      = static_cast<FileFormat>(opts.file_format);
+    config.file_writer      = static_cast<FileWriter>(opts.file_writer);
+    config.crash_handler    = (opts.crash_handler != 0);
+    config.compression      = static_cast<Compression>(opts.compression);
+    config.clock_source     = static_cast<ClockSource>(opts.clock_source);
+    if (opts.ring_buffer_size != 0) {
+        config.ring_buffer_size =
+            opts.ring_buffer_size > 0 ? static_cast<size_t>(opts.ring_buffer_size) : 1;
+    }
+    if (opts.crash_dump_path) {
+        config.crash_dump_path = opts.crash_dump_path;
+    }
+    if (opts.flush_interval_ms != 0) {
+        config.flush_interval_ms = std::max(opts.flush_interval_ms, 0);
+    }
+    if (opts.flush_bytes != 0) {
+        config.flush_bytes = opts.flush_bytes > 0 ? static_cast<size_t>(opts.flush_bytes) : 0;
+    }
+    if (opts.queue_size != 0) {
+        config.queue_size = opts.queue_size > 0 ? static_cast<size_t>(opts.queue_size) : 0;
+    }
+    if (opts.json_log_path) {
+        config.json_log_path = opts.json_log_path;
+    }
+    if (opts.tail_buffer_size != 0) {
+        config.tail_buffer_size =
+            opts.tail_buffer_size > 0 ? static_cast<size_t>(opts.tail_buffer_size) : 1;
+    }
+    if (opts.index_block_lines > 0) {
+        config.index_block_lines = opts.index_block_lines;
+    }
+    config.lazy_init = (opts.lazy_init != 0);
+    if (opts.lazy_buffer_size != 0) {
+        config.lazy_buffer_size =
+            opts.lazy_buffer_size > 0 ? static_cast<size_t>(opts.lazy_buffer_size) : 1;
+    }
+    config.writer_priority = static_cast<ThreadPriority>(opts.writer_priority);
+    config.writer_affinity = opts.writer_affinity;
+    if (opts.writer_thread_name) {
+        config.writer_thread_name = opts.writer_thread_name;
+    }
+    config.dedup_window_ms  = opts.dedup_window_ms;
+    config.rate_limit       = static_cast<uint32_t>(std::max(opts.rate_limit, 0));
+    config.rate_limit_burst = static_cast<uint32_t>(std::max(opts.rate_limit_burst, 0));
+    config.direct_io        = (opts.direct_io != 0);
+    if (opts.network_address) {
+        config.network_address = opts.network_address;
+    }
+    config.network_protocol    = static_cast<NetworkProtocol>(opts.network_protocol);
+    config.network_compression = static_cast<Compression>(opts.network_compression);
+    config.network_frame_size  = static_cast<size_t>(std::max(opts.network_frame_size, 0));
+    if (opts.network_buffer_size > 0) {
+        config.network_buffer_size = static_cast<size_t>(opts.network_buffer_size);
+    }
+    if (opts.shared_memory_name) {
+        config.shared_memory_name = opts.shared_memory_name;
+    }
+    if (opts.shared_memory_size > 0) {
+        config.shared_memory_size = static_cast<size_t>(opts.shared_memory_size);
+    }
+    return true;
+}
+
 #ifdef __cplusplus
 extern "C" {
 #endif   // __cplusplus extern begin
 
 EXPORT_API int init(const char* log_path, size_t max_file_size, int max_files, int async_mode,
                     int thread_pool_size, int min_log_level)
+{
+    MLoggerOptions options{};
+    options.struct_size      = sizeof(MLoggerOptions);
+    options.log_path         = log_path;
+    options.max_file_size    = max_file_size;
+    options.max_files        = max_files;
+    options.async_mode       = async_mode;
+    options.thread_pool_size = thread_pool_size;
+    options.min_log_level    = min_log_level;
+    return initWithOptions(&options);
+}
+
+EXPORT_API int initDefault(const char* log_path)
+{
+    LoggerManager& manager = LoggerManager::getInstance();
+    return manager.initialize(log_path) ? 1 : 0;
+}
+
+EXPORT_API int initWithOptions(const MLoggerOptions* options)
 {
     LoggerConfig config;
-    config.log_path         = log_path;
-    config.max_file_size    = max_file_size;
-    config.max_files        = max_files;
-    config.async_mode       = (async_mode != 0);
-    config.thread_pool_size = thread_pool_size;
-    config.min_log_level    = min_log_level;
+    if (!toConfig(options, config)) {
+        return 0;
+    }
 
     LoggerManager& manager = LoggerManager::getInstance();
     return manager.initialize(config) ? 1 : 0;
 }
 
-EXPORT_API int initDefault(const char* log_path)
+EXPORT_API int reconfigure(const MLoggerOptions* options)
 {
+    LoggerConfig config;
+    if (!toConfig(options, config)) {
+        return 0;
+    }
+
     LoggerManager& manager = LoggerManager::getInstance();
-    return manager.initialize(log_path) ? 1 : 0;
+    return manager.reconfigure(config) ? 1 : 0;
 }
 
 EXPORT_API void logMessage(int log_level, const char* message)
@@ -36,6 +190,123 @@ EXPORT_API void logMessage(int log_level, const char* message)
     manager.log(log_level, message);
 }
 
+EXPORT_API void logMessageLength(int log_level, const char* message, int length)
+{
+    if (length < 0) {
+        return;
+    }
+
+    LoggerManager& manager = LoggerManager::getInstance();
+    manager.log(log_level, message, static_cast<size_t>(length), 0);
+}
+
+EXPORT_API void logMessageUtf16(int log_level, const uint16_t* message, int length)
+{
+    if (!message || length < 0) {
+        return;
+    }
+
+    LoggerManager& manager = LoggerManager::getInstance();
+    manager.log(log_level, reinterpret_cast<const char*>(message),
+                static_cast<size_t>(length) * sizeof(uint16_t), 0, kUtf16Tag);
+}
+
+EXPORT_API int logBatch(const LogRecord* records, int count)
+{
+    if (!records || count <= 0) {
+        return 0;
+    }
+
+    LoggerManager&          manager    = LoggerManager::getInstance();
+    const std::atomic<int>& level_word = *manager.getLogLevelWord();
+    int                     submitted  = 0;
+    for (int i = 0; i < count; ++i) {
+        const LogRecord& record = records[i];
+        if (!record.message || record.length < 0) {
+            continue;
+        }
+        if (record.level >= 0 && record.level < level_word.load(std::memory_order_relaxed)) {
+            continue;
+        }
+
+        manager.log(record.level,
+                    record.message,
+                    static_cast<size_t>(record.length),
+                    record.timestamp_us);
+        ++submitted;
+    }
+    return submitted;
+}
+
+EXPORT_API void logStructured(int log_level, const char* message, const LogField* fields,
+                              int field_count)
+{
+    LoggerManager& manager = LoggerManager::getInstance();
+    if (!message) {
+        return;
+    }
+    if (log_level >= 0 && log_level < manager.getLogLevelWord()->load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    // NOTE: packed into a per-thread buffer, the sinks format the fields on the writer thread
+    thread_local StructuredPayloadWriter writer;
+    writer.begin(message, std::strlen(message));
+    for (int i = 0; fields && i < field_count; ++i) {
+        const LogField& field = fields[i];
+        if (!field.key) {
+            continue;
+        }
+        switch (field.type) {
+        case LOG_FIELD_INT: writer.addInt(field.key, field.key_length, field.int_value); break;
+        case LOG_FIELD_DOUBLE:
+            writer.addDouble(field.key, field.key_length, field.double_value);
+            break;
+        case LOG_FIELD_FLOAT:
+            writer.addFloat(field.key, field.key_length, field.float_value);
+            break;
+        case LOG_FIELD_BOOL:
+            writer.addBool(field.key, field.key_length, field.int_value != 0);
+            break;
+        case LOG_FIELD_STRING:
+            if (field.string_length >= 0 && (field.string_value || field.string_length == 0)) {
+                writer.addString(field.key,
+                                 field.key_length,
+                                 field.string_value,
+                                 static_cast<size_t>(field.string_length));
+            }
+            break;
+        default: break;
+        }
+    }
+    manager.logStructured(log_level, writer.view());
+}
+
+EXPORT_API int registerFormat(const char* format)
+{
+    return FormatRegistry::getInstance().registerFormat(format);
+}
+
+EXPORT_API void logFormatted(int log_level, int format_id, const void* args, int args_size)
+{
+    LoggerManager& manager = LoggerManager::getInstance();
+    if (log_level >= 0 && log_level < manager.getLogLevelWord()->load(std::memory_order_relaxed)) {
+        return;
+    }
+    if (format_id < 0 || static_cast<size_t>(format_id) >= FormatRegistry::getInstance().size() ||
+        args_size < 0 || (args_size > 0 && !args)) {
+        return;
+    }
+
+    // NOTE: the arguments are copied behind the id, the sinks format them on the writer thread
+    thread_local spdlog::memory_buf_t payload;
+    uint32_t                          id = static_cast<uint32_t>(format_id);
+    payload.clear();
+    payload.append(reinterpret_cast<const char*>(&id), reinterpret_cast<const char*>(&id + 1));
+    payload.append(static_cast<const char*>(args), static_cast<const char*>(args) + args_size);
+    manager.logFormatted(log_level, spdlog::string_view_t(payload.data(), payload.size()));
+}
+
 EXPORT_API void logException(const char* exception_type, const char* message,
                              const char* stack_trace)
 {
@@ -43,6 +314,105 @@ EXPORT_API void logException(const char* exception_type, const char* message,
     manager.logException(exception_type, message, stack_trace);
 }
 
+EXPORT_API void logExceptionWithLevel(int log_level, const char* exception_type,
+                                      const char* message, const char* stack_trace)
+{
+    LoggerManager& manager = LoggerManager::getInstance();
+    manager.logException(exception_type, message, stack_trace, log_level);
+}
+
+EXPORT_API int createChannel(const char* name)
+{
+    LoggerManager& manager = LoggerManager::getInstance();
+    return manager.createChannel(name);
+}
+
+EXPORT_API void logChannel(int channel, int log_level, const char* message)
+{
+    if (!message) {
+        return;
+    }
+
+    LoggerManager& manager = LoggerManager::getInstance();
+    manager.logChannel(channel, log_level, message, std::strlen(message), 0);
+}
+
+EXPORT_API void logChannelUtf16(int channel, int log_level, const uint16_t* message, int length)
+{
+    if (!message || length < 0) {
+        return;
+    }
+
+    LoggerManager& manager = LoggerManager::getInstance();
+    manager.logChannel(channel, log_level, reinterpret_cast<const char*>(message),
+                       static_cast<size_t>(length) * sizeof(uint16_t), 0, kUtf16Tag);
+}
+
+EXPORT_API int setChannelLevel(int channel, int log_level)
+{
+    LoggerManager& manager = LoggerManager::getInstance();
+    return manager.setChannelLevel(channel, log_level) ? 1 : 0;
+}
+
+EXPORT_API int getChannelLevel(int channel)
+{
+    LoggerManager& manager = LoggerManager::getInstance();
+    return manager.getChannelLevel(channel);
+}
+
+EXPORT_API int dumpRing(const char* path)
+{
+    LoggerManager& manager = LoggerManager::getInstance();
+    return manager.dumpRing(path) ? 1 : 0;
+}
+
+EXPORT_API int readSince(uint64_t* cursor, char* buffer, int buffer_size, int* skipped)
+{
+    if (skipped) *skipped = 0;
+    if (!cursor || !buffer || buffer_size <= 0) {
+        return 0;
+    }
+
+    LoggerManager& manager     = LoggerManager::getInstance();
+    bool           was_skipped = false;
+    size_t         copied      = manager.readTail(
+        *cursor, buffer, static_cast<size_t>(buffer_size), &was_skipped);
+    if (skipped) *skipped = was_skipped ? 1 : 0;
+    return static_cast<int>(copied);
+}
+
+EXPORT_API uint64_t tailEnd()
+{
+    LoggerManager& manager = LoggerManager::getInstance();
+    return manager.tailEnd();
+}
+
+EXPORT_API int64_t searchLog(const char* path, const char* text, int text_size, int flags,
+                             int level_mask, uint64_t* offsets, int max_offsets)
+{
+    if (!path || text_size < 0 || (text_size > 0 && !text) || max_offsets < 0 ||
+        (max_offsets > 0 && !offsets)) {
+        return -1;
+    }
+
+    LogSearchQuery query;
+    query.text.assign(text ? text : "", static_cast<size_t>(text_size));
+    query.ignore_case = (flags & MLOGGER_SEARCH_IGNORE_CASE) != 0;
+    query.level_mask  = static_cast<unsigned>(level_mask);
+
+    std::vector<uint64_t> found;
+    try {
+        if (!searchLogFile(path, query, found)) return -1;
+    } catch (...) {
+        return -1;
+    }
+
+    size_t count = std::min(found.size(), static_cast<size_t>(max_offsets));
+    size_t first = (flags & MLOGGER_SEARCH_NEWEST) != 0 ? found.size() - count : 0;
+    std::copy_n(found.begin() + first, count, offsets);
+    return static_cast<int64_t>(found.size());
+}
+
 EXPORT_API void flush()
 {
     LoggerManager& manager = LoggerManager::getInstance();
@@ -61,6 +431,64 @@ EXPORT_API int getLogLevel()
     return manager.getLogLevel();
 }
 
+EXPORT_API const volatile int* getLogLevelPtr()
+{
+    LoggerManager& manager = LoggerManager::getInstance();
+    return reinterpret_cast<const volatile int*>(manager.getLogLevelWord());
+}
+
+EXPORT_API uint64_t getDroppedCount()
+{
+    LoggerManager& manager = LoggerManager::getInstance();
+    return manager.getDroppedCount();
+}
+
+EXPORT_API int getStats(MLoggerStats* stats)
+{
+    if (!stats || stats->struct_size < kMinStatsSize) {
+        return 0;
+    }
+
+    LoggerManager& manager = LoggerManager::getInstance();
+    LoggerStats    current = manager.getStats();
+
+    MLoggerStats result{};
+    result.struct_size          = stats->struct_size;
+    result.latency_bucket_count = MLOGGER_LATENCY_BUCKETS;
+    std::copy(current.messages.begin(), current.messages.end(), result.messages);
+    result.bytes_written    = current.bytes_written;
+    result.rotations        = current.rotations;
+    result.flushes          = current.flushes;
+    result.dropped          = current.dropped;
+    result.queue_depth      = current.queue_depth;
+    result.queue_high_water = current.queue_high_water;
+    result.latency_samples  = current.latency_samples;
+    std::copy(current.latency_ns.begin(), current.latency_ns.end(), result.latency_ns);
+    result.suppressed   = current.suppressed;
+    result.rate_limited = current.rate_limited;
+    result.shipped      = current.shipped;
+    result.unshipped    = current.unshipped;
+
+    std::memcpy(stats, &result, std::min<size_t>(stats->struct_size, sizeof(MLoggerStats)));
+    return 1;
+}
+
+EXPORT_API int isCompressionSupported(int compression)
+{
+    if (compression < LOG_COMPRESSION_NONE || compression > LOG_COMPRESSION_ZSTD) {
+        return 0;
+    }
+    return LogCompressor::isAvailable(static_cast<Compression>(compression)) ? 1 : 0;
+}
+
+EXPORT_API int isFileWriterSupported(int file_writer)
+{
+    if (file_writer == LOG_WRITER_URING) {
+        return UringLogFile::isSupported() ? 1 : 0;
+    }
+    return file_writer == LOG_WRITER_STDIO || file_writer == LOG_WRITER_MAPPED ? 1 : 0;
+}
+
 EXPORT_API int isInit()
 {
     LoggerManager& manager = LoggerManager::getInstance();
@@ -73,6 +501,12 @@ EXPORT_API void terminate()
     manager.terminate();
 }
 
+EXPORT_API int terminateAsync(int timeout_ms)
+{
+    LoggerManager& manager = LoggerManager::getInstance();
+    return manager.terminateAsync(std::chrono::milliseconds(std::max(timeout_ms, 0))) ? 1 : 0;
+}
+
 #ifdef __cplusplus
 }
 #endif   // __cplusplus extern end
@@ -2,6 +2,7 @@
 #define BRIDGE_H
 
 #include <stddef.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -40,29 +41,341 @@ typedef enum {
     LOG_INFO     = 2,
     LOG_WARN     = 3,
     LOG_ERROR    = 4,
-    LOG_CRITICAL = 5
+    LOG_CRITICAL = 5,
+    LOG_OFF      = 6   // value of the level word while the logger is not initialized
 } LogLevel;
 
+// setChannelLevel() value that makes a channel follow setLogLevel()
+#define MLOGGER_LEVEL_INHERIT -1
+// channel id of the default logger, the one logMessage() writes to
+#define MLOGGER_DEFAULT_CHANNEL 0
+
+// values of init()'s async_mode
+typedef enum {
+    ASYNC_MODE_OFF         = 0,
+    ASYNC_MODE_THREAD_POOL = 1,   // spdlog thread pool owned by the logger, sized by queue_size
+    ASYNC_MODE_STAGING     = 2    // per-thread SPSC rings, single drain thread
+} AsyncMode;
+
+// values of MLoggerOptions::overflow_policy, applied when the async queue is full
+typedef enum {
+    OVERFLOW_BLOCK          = 0,   // wait for the worker thread
+    OVERFLOW_OVERRUN_OLDEST = 1,   // overwrite the oldest queued record
+    OVERFLOW_DROP_NEWEST    = 2    // discard the record being logged
+} QueueFullPolicy;
+
+// values of MLoggerOptions::file_format
+typedef enum {
+    LOG_FILE_TEXT   = 0,   // formatted lines
+    LOG_FILE_BINARY = 1    // compact records, decode with mlogger_decode
+} LogFileFormat;
+
+// values of MLoggerOptions::file_writer
+typedef enum {
+    LOG_WRITER_STDIO  = 0,   // buffered writes
+    LOG_WRITER_MAPPED = 1,   // memory-mapped files, no syscall per record or flush
+    LOG_WRITER_URING  = 2    // io_uring writes of flush_bytes chunks, Linux 5.6+; stdio elsewhere
+} LogFileWriter;
+
+// values of MLoggerOptions::compression, rotated files are compressed in the background
+typedef enum {
+    LOG_COMPRESSION_NONE = 0,
+    LOG_COMPRESSION_GZIP = 1,   // <file>.gz, needs zlib in the build
+    LOG_COMPRESSION_ZSTD = 2    // <file>.zst, needs libzstd in the build
+} LogCompression;
+
+// values of MLoggerOptions::clock_source, the time records are stamped with
+typedef enum {
+    LOG_CLOCK_SYSTEM = 0,   // the system clock
+    LOG_CLOCK_TSC    = 1    // the CPU cycle counter calibrated against the system clock, cheaper
+                            // to read; the system clock where the CPU has no usable counter
+} LogClockSource;
+
+// values of MLoggerOptions::writer_priority, the scheduling of the threads writing the files
+typedef enum {
+    LOG_THREAD_NORMAL     = 0,   // left as created
+    LOG_THREAD_LOW        = 1,   // below normal; utility QoS on Apple platforms
+    LOG_THREAD_BACKGROUND = 2    // lowest; background QoS on Apple platforms, which keeps the
+                                 // thread on the efficiency cores
+} LogThreadPriority;
+
+// values of MLoggerOptions::network_protocol
+typedef enum {
+    LOG_NETWORK_UDP = 0,   // one datagram per frame, lost frames show as sequence gaps
+    LOG_NETWORK_TCP = 1    // reconnected when the collector goes away or stops reading
+} LogNetworkProtocol;
+
+// Options for initWithOptions(). Set struct_size to sizeof(MLoggerOptions); fields past
+// struct_size keep their defaults, so new fields are only ever appended.
+typedef struct {
+    uint32_t    struct_size;
+    const char* log_path;
+    uint64_t    max_file_size;
+    int32_t     max_files;
+    int32_t     async_mode;   // AsyncMode
+    int32_t     thread_pool_size;
+    int32_t     min_log_level;     // LogLevel
+    int32_t     queue_size;        // records, 0 = default (8192)
+    int32_t     overflow_policy;   // QueueFullPolicy
+    int32_t     file_format;       // LogFileFormat
+    int32_t     file_writer;       // LogFileWriter
+    int32_t     ring_buffer_size;  // bytes of recent records of every level kept for dumpRing()
+    int32_t     crash_handler;     // 1 = dump the ring on fatal signals / unhandled exceptions
+    const char* crash_dump_path;   // null = <log_path stem>.crash<ext>
+    int32_t     compression;       // LogCompression, unsupported codecs leave files as they are
+    // flush policy, critical records and terminate() always flush at once
+    int32_t     flush_interval_ms; // periodic flush, 0 = default (1000), negative = none
+    int32_t     flush_bytes;       // pending bytes that trigger a write, 0 = default (64KB),
+                                   // negative = stdio's own buffer
+    const char* json_log_path;     // second file with one JSON object per record, null = none
+    int32_t     index_block_lines; // lines per block of the <file>.idx seek index of text files,
+                                   // 0 or negative = no index
+    int32_t     tail_buffer_size;  // bytes of recent lines kept for readSince(), 0 = none
+    int32_t     clock_source;      // LogClockSource
+    int32_t     lazy_init;         // 1 = return at once, open the files on a background thread
+    int32_t     lazy_buffer_size;  // bytes of records held until then, 0 = default (256KB)
+    // threads writing the files: thread pool workers, the staging drain thread, periodic flush
+    int32_t     writer_priority;    // LogThreadPriority
+    const char* writer_thread_name; // null = "mlogger", "" = left unnamed; cut to 15 bytes
+    uint64_t    writer_affinity;    // bit i = may run on CPU i, 0 = any CPU; not supported on
+                                    // Apple platforms, use writer_priority there
+    // repeats of a record within the window are counted and reported as "last message repeated
+    // N times" instead of written, 0 = off
+    int32_t     dedup_window_ms;
+    int32_t     rate_limit;         // records per second per channel and level, 0 = unlimited;
+                                    // critical records are never limited
+    int32_t     rate_limit_burst;   // records passing at once, 0 = rate_limit
+    int32_t     direct_io;          // 1 = LOG_WRITER_URING files bypass the page cache (O_DIRECT)
+    // log shipping: every record is also sent to a collector (mlogger_collect) from a thread of
+    // its own; records the network cannot take are counted in MLoggerStats::unshipped and stay
+    // in the log file
+    const char* network_address;      // "host:port", null = none
+    int32_t     network_protocol;     // LogNetworkProtocol
+    int32_t     network_compression;  // LogCompression of each frame, unsupported = none
+    int32_t     network_frame_size;   // record bytes per frame, 0 = default (UDP 1200, TCP 64KB)
+    int32_t     network_buffer_size;  // bytes of frames waiting to be sent, 0 = default (1MB)
+    // shared memory publishing: records go to a named segment that one mlogger_aggregate process
+    // per host writes into the files, this process writes none; the logger is then synchronous
+    // and the file options are the aggregator's. Records the segment has no room for are counted
+    // in MLoggerStats::dropped.
+    const char* shared_memory_name;   // 1 to 20 of [A-Za-z0-9._-], null = write the files
+    int32_t     shared_memory_size;   // ring bytes if the segment is created here, 0 = default
+                                      // (4MB)
+} MLoggerOptions;
+
+// One entry of a logBatch() submission, 24 bytes on every target.
+typedef struct {
+    int64_t timestamp_us;   // microseconds since the Unix epoch, 0 = time of submission
+    union {
+        const char* message;   // UTF-8, not null-terminated
+        uint64_t    message_storage;
+    };
+    int32_t length;   // message size in bytes
+    int32_t level;    // LogLevel
+} LogRecord;
+
+// values of LogField::type
+typedef enum {
+    LOG_FIELD_INT    = 0,   // int_value
+    LOG_FIELD_DOUBLE = 1,   // double_value
+    LOG_FIELD_BOOL   = 2,   // int_value, non-zero = true
+    LOG_FIELD_STRING = 3,   // string_value, string_length bytes
+    LOG_FIELD_FLOAT  = 4    // float_value
+} LogFieldType;
+
+// One key/value pair of a logStructured() call, 24 bytes on every target. Keys and strings are
+// UTF-8 and need no terminator.
+typedef struct {
+    union {
+        const char* key;
+        uint64_t    key_storage;
+    };
+    union {
+        int64_t     int_value;
+        double      double_value;
+        float       float_value;
+        const char* string_value;
+        uint64_t    value_storage;
+    };
+    uint16_t type;            // LogFieldType
+    uint16_t key_length;      // key size in bytes
+    int32_t  string_length;   // LOG_FIELD_STRING only
+} LogField;
+
+#define MLOGGER_LATENCY_BUCKETS 16
+
+// Counters filled by getStats(). Like MLoggerOptions, set struct_size to sizeof(MLoggerStats);
+// fields are only ever appended and the ones past struct_size are left untouched.
+typedef struct {
+    uint32_t struct_size;
+    uint32_t latency_bucket_count;   // MLOGGER_LATENCY_BUCKETS
+    uint64_t messages[6];            // records handed to the log file, indexed by LogLevel
+    uint64_t bytes_written;          // file bytes including binary headers
+    uint64_t rotations;
+    uint64_t flushes;
+    uint64_t dropped;                // same as getDroppedCount()
+    uint64_t queue_depth;            // records waiting for the async writer
+    uint64_t queue_high_water;       // most records seen waiting at once, sampled
+    uint64_t latency_samples;        // every 16th call of each thread is timed
+    // time spent handing a record to the logger (the write itself in sync mode, the enqueue in
+    // async modes); bucket i counts calls under 64 << i ns, the last bucket everything slower
+    uint64_t latency_ns[MLOGGER_LATENCY_BUCKETS];
+    uint64_t suppressed;             // repeats held back by dedup_window_ms
+    uint64_t rate_limited;           // records held back by rate_limit
+    uint64_t shipped;                // records sent to network_address
+    uint64_t unshipped;              // records the network could not take, in the file only
+} MLoggerStats;
+
 EXPORT_API int init(const char* log_path, size_t max_file_size, int max_files, int async_mode,
                     int thread_pool_size, int min_log_level);
 
 EXPORT_API int initDefault(const char* log_path);
 
+EXPORT_API int initWithOptions(const MLoggerOptions* options);
+
+// Applies new options to the running logger without stopping it: logging goes on while the new
+// file, level and sinks are set up, and records already queued are written by the old backend
+// in the background. A file kept under the same path and settings stays open. Initializes the
+// logger when it is not. Returns 1 on success; on failure the current settings stay in effect.
+EXPORT_API int reconfigure(const MLoggerOptions* options);
+
 EXPORT_API void logMessage(int log_level, const char* message);
 
+// Same with a message of `length` bytes that needs no terminator.
+EXPORT_API void logMessageLength(int log_level, const char* message, int length);
+
+// Same with `length` UTF-16 code units, such as the characters of a pinned C# string, so callers
+// need not convert. The sinks write UTF-8, converted on the writer thread in async modes;
+// unpaired surrogates become U+FFFD.
+EXPORT_API void logMessageUtf16(int log_level, const uint16_t* message, int length);
+
+// Submits `count` records in one call, returns how many passed the level filter.
+EXPORT_API int logBatch(const LogRecord* records, int count);
+
+// Logs `message` with typed fields, which the text file and the ring buffer show as
+// " key=value" after the message and the JSON-lines file (json_log_path) as members of the line's
+// object. The fields are copied before the call returns and formatted by the writer thread in
+// async modes. Fields with an unknown type, a null key or a negative length are skipped.
+EXPORT_API void logStructured(int log_level, const char* message, const LogField* fields,
+                              int field_count);
+
+// argument type bytes of a logFormatted() blob
+typedef enum {
+    LOG_ARG_INT    = 0,   // i64
+    LOG_ARG_DOUBLE = 1,   // f64
+    LOG_ARG_BOOL   = 2,   // u8, non-zero = true
+    LOG_ARG_STRING = 3,   // u32 size, UTF-8 bytes
+    LOG_ARG_FLOAT  = 4    // f32
+} LogArgType;
+
+// Interns an fmt format string ("{}", "{0}", "{:.2f}", ...) for logFormatted(). The same text
+// always yields the same id for the process lifetime, across terminate() and initialize().
+// Returns -1 for null or when 16384 formats are registered.
+EXPORT_API int registerFormat(const char* format);
+
+// Logs a registered format with its arguments, formatted by the writer thread in async modes.
+// `args` holds args_size bytes: per argument a LogArgType byte followed by its value, packed and
+// in native byte order. Binary files store the format and the raw arguments, mlogger_decode
+// formats them. A format the arguments do not satisfy is logged with " [format error: ...]".
+EXPORT_API void logFormatted(int log_level, int format_id, const void* args, int args_size);
+
 EXPORT_API void logException(const char* exception_type, const char* message,
                              const char* stack_trace);
 
+// LOG_CRITICAL also dumps the ring buffer to the crash dump path.
+EXPORT_API void logExceptionWithLevel(int log_level, const char* exception_type,
+                                      const char* message, const char* stack_trace);
+
+// Named channels share the log file and async backend, and each has its own level; records carry
+// the channel name instead of "mlogger". Returns the channel id (the same one for the same name,
+// valid across init()/terminate() for the process lifetime), or -1 when `name` is empty, longer
+// than 63 bytes or all 64 channels are taken. May be called before init().
+EXPORT_API int createChannel(const char* name);
+
+// Same as logMessage() on a channel, filtered by the channel's level first.
+EXPORT_API void logChannel(int channel, int log_level, const char* message);
+
+// Same as logMessageUtf16() on a channel.
+EXPORT_API void logChannelUtf16(int channel, int log_level, const uint16_t* message, int length);
+
+// LogLevel, LOG_OFF to silence the channel or MLOGGER_LEVEL_INHERIT (the default) to follow
+// setLogLevel(). Returns 0 for unknown channels and invalid levels. An explicit level also
+// filters what reaches the ring buffer.
+EXPORT_API int setChannelLevel(int channel, int log_level);
+
+// The level set for `channel`, MLOGGER_LEVEL_INHERIT when it follows setLogLevel() and LOG_OFF for
+// unknown channels.
+EXPORT_API int getChannelLevel(int channel);
+
+// Writes the ring buffer to `path` (null = crash dump path), returns 1 on success and 0 when the
+// ring is disabled or the file cannot be written.
+EXPORT_API int dumpRing(const char* path);
+
+// Live tail, enabled by MLoggerOptions::tail_buffer_size: the most recent lines, formatted like
+// the text file, kept in memory for viewers that poll. Copies the whole lines logged after
+// *cursor into `buffer` (line endings included, no terminator), oldest first, and moves *cursor
+// past them. Start with *cursor = 0 for the oldest line held or tailEnd() for new lines only.
+// Returns the bytes copied, 0 when nothing is new or the tail is disabled; a line longer than
+// `buffer_size` is cut. `skipped` (optional) is set to 1 when lines were overwritten before they
+// could be read, or *cursor is from before the last initialize(); reading then restarts at the
+// oldest line held.
+EXPORT_API int readSince(uint64_t* cursor, char* buffer, int buffer_size, int* skipped);
+
+// Cursor after the newest line of the live tail, 0 when it is disabled.
+EXPORT_API uint64_t tailEnd();
+
+// flags of searchLog()
+typedef enum {
+    MLOGGER_SEARCH_IGNORE_CASE = 1,   // ASCII letters match in either case
+    MLOGGER_SEARCH_NEWEST      = 2    // keep the last max_offsets matches instead of the first
+} MLoggerSearchFlags;
+
+// Searches the text log file at `path` for the lines holding `text` (UTF-8, `text_size` bytes,
+// 0 = every line) whose level is in `level_mask` (bit 1 << LogLevel, 0 = every level). Writes the
+// byte offsets of up to `max_offsets` of them, oldest first, to `offsets` and returns how many
+// lines matched in all, -1 when the file cannot be read. Needs no init(); the file is mapped and
+// scanned with SIMD across threads, see utils/log_search.h.
+EXPORT_API int64_t searchLog(const char* path, const char* text, int text_size, int flags,
+                             int level_mask, uint64_t* offsets, int max_offsets);
+
+// Writes everything logged before the call to the log files. In async modes this waits for the
+// background thread to get there, except under OVERFLOW_OVERRUN_OLDEST where the request is only
+// queued.
 EXPORT_API void flush();
 
 EXPORT_API void setLogLevel(int log_level);
 
 EXPORT_API int getLogLevel();
 
+// Messages with a level below *getLogLevelPtr() are dropped; callers may read it to skip
+// formatting and the bridge call entirely. The address never changes.
+EXPORT_API const volatile int* getLogLevelPtr();
+
+// Records lost to the overflow policy since the last successful init() or reconfigure().
+EXPORT_API uint64_t getDroppedCount();
+
+// Counters since the last init(), without rescanning the log file; reconfigure() keeps them,
+// except the overflow ones of the new backend. Returns 0 when `stats` is null or struct_size is
+// smaller than the first layout.
+EXPORT_API int getStats(MLoggerStats* stats);
+
+// 1 when this build can write `compression` (LogCompression).
+EXPORT_API int isCompressionSupported(int compression);
+
+// 1 when `file_writer` (LogFileWriter) works in this process; LOG_WRITER_URING needs the kernel
+// to allow io_uring, sandboxes and Android apps usually do not.
+EXPORT_API int isFileWriterSupported(int file_writer);
+
 EXPORT_API int isInit();
 
 EXPORT_API void terminate();
 
+// Stops logging like terminate(), but writes the queued records on a background thread and waits
+// at most `timeout_ms` for them (0 or negative = not at all). Returns 1 when everything was
+// written in time. Otherwise the files are completed in the background; terminate() and another
+// init() of the same file wait for that, and so does unloading the library.
+EXPORT_API int terminateAsync(int timeout_ms);
+
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,180 @@
+#ifndef MLOGGER_H
+#define MLOGGER_H
+
+// Header-only C++ front-end over the C API of bridge.h, for native plugins that log from hot
+// loops. Levels are template arguments or macro names, so:
+//
+// - calls below MLOGGER_ACTIVE_LEVEL compile to nothing
+// - the remaining calls check the level word of getLogLevelPtr() inline, a filtered call costs
+//   a couple of loads and a branch, no call into the library
+// - a written call goes straight to the library with its level already known to be valid
+//
+//   #define MLOGGER_ACTIVE_LEVEL LOG_INFO      // before the include, or -DMLOGGER_ACTIVE_LEVEL=2
+//   #include "bridge/mlogger.h"
+//
+//   mlogger::log<LOG_WARN>("budget exceeded");
+//   MLOGGER_INFO("spawned {} units in {:.2f} ms", count, elapsed_ms);
+//
+// The MLOGGER_<LEVEL> macros intern their format string, a literal, once per call site and hand
+// the arguments over unformatted (logFormatted()); unlike mlogger::log() they do not even
+// evaluate their arguments when the level is filtered. Arguments may be integers, bool, float,
+// double and strings (const char*, std::string, std::string_view).
+
+#include "bridge.h"
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Lowest level compiled in. Release builds (NDEBUG) drop Trace and Debug unless it is set.
+#ifndef MLOGGER_ACTIVE_LEVEL
+#    ifdef NDEBUG
+#        define MLOGGER_ACTIVE_LEVEL LOG_INFO
+#    else
+#        define MLOGGER_ACTIVE_LEVEL LOG_TRACE
+#    endif
+#endif
+
+namespace mlogger
+{
+
+// whether calls at `level` are compiled in
+constexpr bool isActive(int level)
+{
+    return level >= MLOGGER_ACTIVE_LEVEL;
+}
+
+// the level word never moves, one call per process
+inline const volatile int* levelWord()
+{
+    static const volatile int* const word = getLogLevelPtr();
+    return word;
+}
+
+// whether a call at `Level` would be written now, false while the logger is not initialized
+template <int Level>
+inline bool shouldLog()
+{
+    static_assert(Level >= LOG_TRACE && Level <= LOG_CRITICAL, "not a LogLevel to log at");
+    if constexpr (isActive(Level)) {
+        return Level >= *levelWord();
+    } else {
+        return false;
+    }
+}
+
+template <int Level>
+inline void log(std::string_view message)
+{
+    if (shouldLog<Level>()) {
+        logMessageLength(Level, message.data(), static_cast<int>(message.size()));
+    }
+}
+
+namespace detail
+{
+
+template <typename T>
+using Decay = std::remove_cv_t<std::remove_reference_t<T>>;
+
+template <typename T>
+constexpr bool kIsString = std::is_convertible_v<const T&, std::string_view>;
+
+template <typename T>
+size_t argSize(const T& value)
+{
+    using Type = Decay<T>;
+    if constexpr (std::is_same_v<Type, bool>) {
+        return 1 + 1;
+    } else if constexpr (std::is_integral_v<Type> || std::is_enum_v<Type>) {
+        return 1 + sizeof(int64_t);
+    } else if constexpr (std::is_same_v<Type, float>) {
+        return 1 + sizeof(float);
+    } else if constexpr (std::is_floating_point_v<Type>) {
+        return 1 + sizeof(double);
+    } else {
+        static_assert(kIsString<Type>, "arguments are integers, bool, float, double or strings");
+        return 1 + sizeof(uint32_t) + std::string_view(value).size();
+    }
+}
+
+template <typename T>
+char* putValue(char* dest, uint8_t type, const T& value)
+{
+    *dest++ = static_cast<char>(type);
+    std::memcpy(dest, &value, sizeof(value));
+    return dest + sizeof(value);
+}
+
+// writes one argument of a logFormatted() blob, see LogArgType
+template <typename T>
+char* putArg(char* dest, const T& value)
+{
+    using Type = Decay<T>;
+    if constexpr (std::is_same_v<Type, bool>) {
+        return putValue(dest, LOG_ARG_BOOL, static_cast<uint8_t>(value ? 1 : 0));
+    } else if constexpr (std::is_integral_v<Type> || std::is_enum_v<Type>) {
+        return putValue(dest, LOG_ARG_INT, static_cast<int64_t>(value));
+    } else if constexpr (std::is_same_v<Type, float>) {
+        return putValue(dest, LOG_ARG_FLOAT, value);
+    } else if constexpr (std::is_floating_point_v<Type>) {
+        return putValue(dest, LOG_ARG_DOUBLE, static_cast<double>(value));
+    } else {
+        std::string_view text(value);
+        dest = putValue(dest, LOG_ARG_STRING, static_cast<uint32_t>(text.size()));
+        std::memcpy(dest, text.data(), text.size());
+        return dest + text.size();
+    }
+}
+
+// `intern` is a lambda of the call site, whose static keeps the site's format id
+template <int Level, typename Intern, typename... Args>
+void logFormat(Intern intern, const char* format, const Args&... args)
+{
+    int    format_id = intern(format);
+    size_t size      = (size_t{0} + ... + argSize(args));
+
+    // NOTE: most argument lists fit on the stack, long strings take the heap
+    char                    stack[256];
+    std::unique_ptr<char[]> heap;
+    char*                   blob = stack;
+    if (size > sizeof(stack)) {
+        heap.reset(new char[size]);
+        blob = heap.get();
+    }
+
+    char* end = blob;
+    ((end = putArg(end, args)), ...);
+    (void)end;
+    logFormatted(Level, format_id, blob, static_cast<int>(size));
+}
+
+}   // namespace detail
+
+}   // namespace mlogger
+
+// Logs an fmt format string with its arguments at `level`, see the top of this file.
+#define MLOGGER_LOG(level, ...)                                                                \
+    do {                                                                                       \
+        if constexpr (::mlogger::isActive(level)) {                                            \
+            if (::mlogger::shouldLog<level>()) {                                               \
+                ::mlogger::detail::logFormat<level>(                                           \
+                    [](const char* format) {                                                   \
+                        static const int format_id = ::registerFormat(format);                 \
+                        return format_id;                                                      \
+                    },                                                                         \
+                    __VA_ARGS__);                                                              \
+            }                                                                                  \
+        }                                                                                      \
+    } while (0)
+
+#define MLOGGER_TRACE(...)    MLOGGER_LOG(LOG_TRACE, __VA_ARGS__)
+#define MLOGGER_DEBUG(...)    MLOGGER_LOG(LOG_DEBUG, __VA_ARGS__)
+#define MLOGGER_INFO(...)     MLOGGER_LOG(LOG_INFO, __VA_ARGS__)
+#define MLOGGER_WARN(...)     MLOGGER_LOG(LOG_WARN, __VA_ARGS__)
+#define MLOGGER_ERROR(...)    MLOGGER_LOG(LOG_ERROR, __VA_ARGS__)
+#define MLOGGER_CRITICAL(...) MLOGGER_LOG(LOG_CRITICAL, __VA_ARGS__)
+
+#endif   // MLOGGER_H
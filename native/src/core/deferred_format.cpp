@@ -0,0 +1,168 @@
+#include "deferred_format.h"
+#include "utils/utf16_utils.h"
+#include <cstring>
+#include <iterator>
+
+#if defined(SPDLOG_FMT_EXTERNAL)
+#    include <fmt/args.h>
+#else
+#    include <spdlog/fmt/bundled/args.h>
+#endif
+
+namespace mlogger
+{
+
+const char kFormattedTag[] = "mlogger.formatted";
+const char kUtf16Tag[]     = "mlogger.utf16";
+
+namespace
+{
+
+// reads one encoded argument into `store`, false at the end or on truncated data
+bool pushArgument(const char*& position, const char* end,
+                  spdlog::fmt_lib::dynamic_format_arg_store<spdlog::fmt_lib::format_context>& store)
+{
+    auto read = [&](void* dest, size_t size) {
+        if (static_cast<size_t>(end - position) < size) return false;
+        std::memcpy(dest, position, size);
+        position += size;
+        return true;
+    };
+
+    uint8_t type = 0;
+    if (!read(&type, sizeof(type))) return false;
+
+    switch (static_cast<FieldType>(type)) {
+    case FieldType::int64: {
+        int64_t value = 0;
+        if (!read(&value, sizeof(value))) return false;
+        store.push_back(value);
+        return true;
+    }
+    case FieldType::float64: {
+        double value = 0;
+        if (!read(&value, sizeof(value))) return false;
+        store.push_back(value);
+        return true;
+    }
+    case FieldType::float32: {
+        float value = 0;
+        if (!read(&value, sizeof(value))) return false;
+        store.push_back(value);
+        return true;
+    }
+    case FieldType::boolean: {
+        uint8_t value = 0;
+        if (!read(&value, sizeof(value))) return false;
+        store.push_back(value != 0);
+        return true;
+    }
+    case FieldType::string: {
+        uint32_t size = 0;
+        if (!read(&size, sizeof(size)) || static_cast<size_t>(end - position) < size) {
+            return false;
+        }
+        // NOTE: views into the payload, which outlives the store's use
+        store.push_back(spdlog::fmt_lib::string_view(position, size));
+        position += size;
+        return true;
+    }
+    }
+    return false;
+}
+
+}   // namespace
+
+FormatRegistry& FormatRegistry::getInstance()
+{
+    static FormatRegistry instance;
+    return instance;
+}
+
+int FormatRegistry::registerFormat(const char* format)
+{
+    if (!format) {
+        return -1;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto                        found = ids_.find(format);
+    if (found != ids_.end()) {
+        return found->second;
+    }
+
+    size_t id = owned_.size();
+    if (id >= kMaxFormats) {
+        return -1;
+    }
+    owned_.push_back(std::make_unique<std::string>(format));
+    ids_.emplace(*owned_.back(), static_cast<int>(id));
+    slots_[id].store(owned_.back().get(), std::memory_order_relaxed);
+    count_.store(id + 1, std::memory_order_release);
+    return static_cast<int>(id);
+}
+
+spdlog::string_view_t FormatRegistry::get(uint32_t id) const
+{
+    if (id >= count_.load(std::memory_order_acquire)) {
+        return {};
+    }
+    const std::string* format = slots_[id].load(std::memory_order_relaxed);
+    return {format->data(), format->size()};
+}
+
+bool formatArguments(spdlog::string_view_t format, const char* arguments, size_t size,
+                     spdlog::memory_buf_t& dest)
+{
+    // NOTE: one store per thread, clear() keeps its capacity for the next record
+    thread_local spdlog::fmt_lib::dynamic_format_arg_store<spdlog::fmt_lib::format_context> store;
+    store.clear();
+
+    const char* position = arguments;
+    const char* end      = arguments + size;
+    while (position != end && pushArgument(position, end, store)) {
+    }
+
+    size_t start = dest.size();
+    try {
+        spdlog::fmt_lib::vformat_to(std::back_inserter(dest),
+                                    spdlog::fmt_lib::string_view(format.data(), format.size()),
+                                    store);
+        return position == end;
+    } catch (const std::exception& e) {
+        dest.resize(start);
+        dest.append(format);
+        dest.append(spdlog::string_view_t(" [format error: "));
+        dest.append(spdlog::string_view_t(e.what()));
+        dest.push_back(']');
+        return false;
+    }
+}
+
+void appendPayloadText(const char* tag, spdlog::string_view_t payload, spdlog::memory_buf_t& dest)
+{
+    if (tag == kStructuredTag) {
+        appendStructuredText(payload, dest);
+        return;
+    }
+    if (tag == kUtf16Tag) {
+        appendUtf16AsUtf8(payload.data(), payload.size() / 2, dest);
+        return;
+    }
+    if (tag != kFormattedTag) {
+        dest.append(payload);
+        return;
+    }
+
+    uint32_t id = 0;
+    if (payload.size() < sizeof(id)) {
+        return;
+    }
+    std::memcpy(&id, payload.data(), sizeof(id));
+    formatArguments(FormatRegistry::getInstance().get(id),
+                    payload.data() + sizeof(id),
+                    payload.size() - sizeof(id),
+                    dest);
+}
+
+}   // namespace mlogger
@@ -0,0 +1,88 @@
+#ifndef DEFERRED_FORMAT_H
+#define DEFERRED_FORMAT_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include "structured_payload.h"
+#include <spdlog/details/log_msg.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mlogger
+{
+
+// Process-wide table of fmt format strings registered once and referenced by id afterwards, so a
+// record only carries the id and its arguments. Entries are never removed, lookups take no lock.
+class FormatRegistry final
+{
+public:
+    static constexpr size_t kMaxFormats = 16384;
+
+    static FormatRegistry& getInstance();
+
+    // same id for the same text, -1 for null or when the table is full
+    int registerFormat(const char* format);
+    // empty for unknown ids
+    spdlog::string_view_t get(uint32_t id) const;
+    size_t                size() const { return count_.load(std::memory_order_acquire); }
+
+    FormatRegistry(const FormatRegistry&)            = delete;
+    FormatRegistry& operator=(const FormatRegistry&) = delete;
+
+private:
+    FormatRegistry() = default;
+
+    std::array<std::atomic<const std::string*>, kMaxFormats> slots_{};
+    std::atomic<size_t>                                      count_{0};
+    std::mutex                                               mutex_;
+    std::vector<std::unique_ptr<std::string>>                owned_;   // guarded by mutex_
+    std::unordered_map<std::string, int>                     ids_;     // guarded by mutex_
+};
+
+// Payload of a formatted record: u32 format id followed by the argument bytes. Arguments are
+// encoded like structured field values without keys, in native byte order:
+//
+//   u8 type (FieldType), then i64 / f64: 8 bytes, f32: 4 bytes, bool: 1 byte,
+//   string: u32 size + bytes
+//
+// Records carrying such a payload have source.funcname == kFormattedTag.
+extern const char kFormattedTag[];
+
+inline bool isFormatted(const spdlog::details::log_msg& msg)
+{
+    return msg.source.funcname == kFormattedTag;
+}
+
+// Payload of a UTF-16 record: the code units as a C# string holds them, in native byte order.
+// The sinks convert them to UTF-8, so in async modes the writer thread does. Records carrying
+// such a payload have source.funcname == kUtf16Tag.
+extern const char kUtf16Tag[];
+
+inline bool isUtf16(const spdlog::details::log_msg& msg)
+{
+    return msg.source.funcname == kUtf16Tag;
+}
+
+// true for records whose payload is not final text
+inline bool needsRendering(const spdlog::details::log_msg& msg)
+{
+    return isStructured(msg) || isFormatted(msg) || isUtf16(msg);
+}
+
+// Formats `format` with the encoded `arguments` into `dest`. A format the arguments do not
+// satisfy is written as it is, followed by " [format error: ...]"; false in that case.
+bool formatArguments(spdlog::string_view_t format, const char* arguments, size_t size,
+                     spdlog::memory_buf_t& dest);
+
+// Text of a payload whose record has source.funcname == `tag`: plain payloads as they are,
+// structured and formatted ones rendered, UTF-16 ones converted.
+void appendPayloadText(const char* tag, spdlog::string_view_t payload, spdlog::memory_buf_t& dest);
+
+}   // namespace mlogger
+
+#endif   // DEFERRED_FORMAT_H
@@ -9,7 +9,30 @@ bool LoggerConfig::isValid() const
     if (max_file_size == 0) return false;
     if (max_files <= 0) return false;
     if (thread_pool_size <= 0) return false;
+    if (queue_size == 0) return false;
+    if (overflow_policy < OverflowPolicy::block) return false;
+    if (overflow_policy > OverflowPolicy::drop_newest) return false;
+    if (file_format < FileFormat::text || file_format > FileFormat::binary) return false;
+    if (file_writer < FileWriter::stdio || file_writer > FileWriter::uring) return false;
+    if (compression < Compression::none || compression > Compression::zstd) return false;
+    if (network_protocol < NetworkProtocol::udp) return false;
+    if (network_protocol > NetworkProtocol::tcp) return false;
+    if (network_compression < Compression::none) return false;
+    if (network_compression > Compression::zstd) return false;
+    if (clock_source < ClockSource::system || clock_source > ClockSource::tsc) return false;
+    if (writer_priority < ThreadPriority::normal) return false;
+    if (writer_priority > ThreadPriority::background) return false;
+    if (dedup_window_ms < 0) return false;
+    if (json_log_path == log_path) return false;
     if (min_log_level < 0 || min_log_level > 5) return false;
+    if (flush_interval_ms < 0) return false;
+    if (index_block_lines < 0) return false;
+    if (async_backend == AsyncBackend::staging_rings && staging_ring_size < 4096) return false;
+    if (ring_buffer_size != 0 && ring_buffer_size < 4096) return false;
+    if (tail_buffer_size != 0 && tail_buffer_size < 4096) return false;
+    if (crash_handler && ring_buffer_size == 0) return false;
+    if (lazy_init && lazy_buffer_size < 4096) return false;
+    if (!shared_memory_name.empty() && shared_memory_size < 64 * 1024) return false;
 
     return true;
 }
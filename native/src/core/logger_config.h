@@ -2,18 +2,149 @@
 #define LOGGER_CONFIG_H
 
 #include <cstddef>
+#include <cstdint>
 #include <string>
 
 namespace mlogger
 {
 
+enum class AsyncBackend : int
+{
+    thread_pool   = 0,   // spdlog thread pool, one MPMC queue shared by all producers
+    staging_rings = 1,   // per-thread SPSC rings merged by a single drain thread
+};
+
+// what a producer does when the async queue is full
+enum class OverflowPolicy : int
+{
+    block          = 0,   // wait for the worker
+    overrun_oldest = 1,   // overwrite the oldest queued record
+    drop_newest    = 2,   // discard the record being logged
+};
+
+// encoding of the rotating log files
+enum class FileFormat : int
+{
+    text   = 0,   // formatted lines
+    binary = 1,   // compact records, see sinks/binary_format.h
+};
+
+// how the rotating log files are written
+enum class FileWriter : int
+{
+    stdio  = 0,   // buffered stdio writes
+    mapped = 1,   // memory-mapped, preallocated files, see sinks/mapped_log_file.h
+    uring  = 2,   // io_uring writes, Linux only, see sinks/uring_log_file.h
+};
+
+// transport of LoggerConfig::network_address, see sinks/network_sink.h
+enum class NetworkProtocol : int
+{
+    udp = 0,   // one datagram per frame, lost frames show as sequence gaps
+    tcp = 1,   // reconnected when the collector goes away or stops reading
+};
+
+// codec for rotated log files, compressed in the background, see sinks/log_compressor.h
+enum class Compression : int
+{
+    none = 0,
+    gzip = 1,   // .gz, needs zlib at build time
+    zstd = 2,   // .zst, needs libzstd at build time
+};
+
+// what records are stamped with when the caller gives no timestamp
+enum class ClockSource : int
+{
+    system = 0,   // std::chrono::system_clock::now()
+    tsc    = 1,   // the cycle counter scaled to wall-clock time, see utils/tsc_clock.h
+};
+
+// OS scheduling class of the threads writing the files, see utils/thread_utils.h
+enum class ThreadPriority : int
+{
+    normal     = 0,   // left as created
+    low        = 1,   // below normal, utility QoS on Apple platforms
+    background = 2,   // lowest, background QoS on Apple platforms (efficiency cores)
+};
+
 struct LoggerConfig final {
-    std::string log_path;
-    size_t      max_file_size    = 10 * 1024 * 1024;   // 10MB default
-    int         max_files        = 5;
-    bool        async_mode       = true;
-    int         thread_pool_size = 1;
-    int         min_log_level    = 2;   // filter LOG_INFO by default
+    std::string  log_path;
+    size_t       max_file_size     = 10 * 1024 * 1024;   // 10MB default
+    int          max_files         = 5;
+    bool         async_mode        = true;
+    AsyncBackend async_backend     = AsyncBackend::thread_pool;
+    size_t       staging_ring_size = 256 * 1024;   // bytes per producer thread
+    int          thread_pool_size  = 1;
+    size_t       queue_size        = 8192;   // records, thread pool backend only
+    int          min_log_level     = 2;      // filter LOG_INFO by default
+
+    OverflowPolicy overflow_policy = OverflowPolicy::block;
+    FileFormat     file_format     = FileFormat::text;
+    FileWriter     file_writer     = FileWriter::stdio;
+    Compression    compression     = Compression::none;
+
+    // second file receiving every record as one JSON object per line, see
+    // sinks/json_lines_sink.h; rotated and compressed like log_path, empty = none
+    std::string json_log_path;
+
+    // lines per block of the <file>.idx seek index kept next to every text log file, see
+    // sinks/log_index.h; opt-in, 0 = no index
+    int index_block_lines = 0;
+
+    // flush policy: written records reach the OS once flush_bytes are pending or at the next
+    // flush_interval_ms tick, whichever comes first; critical records and terminate() flush at once
+    size_t flush_bytes       = 64 * 1024;   // stdio and io_uring writers, 0 = stdio's own buffer
+    int    flush_interval_ms = 1000;        // 0 = no periodic flush
+
+    // io_uring writer: files opened with O_DIRECT, bypassing the page cache; flush_bytes is the
+    // size of its writes (at least 64KB)
+    bool direct_io = false;
+
+    // flight recorder: bytes of recent records of every level kept in memory, 0 disables it
+    size_t      ring_buffer_size = 0;
+    bool        crash_handler    = false;   // dump the ring when the process crashes
+    std::string crash_dump_path;            // where the ring is dumped, empty = <log>.crash<ext>
+
+    // live tail: bytes of recent formatted lines kept for readers polling with a cursor, see
+    // sinks/tail_sink.h, 0 disables it
+    size_t tail_buffer_size = 0;
+
+    // CPUs without a usable counter keep the system clock
+    ClockSource clock_source = ClockSource::system;
+
+    // lazy initialization: initialize() only buffers records in memory, the directories, files
+    // and async backend are set up on a thread of its own and the buffered records replayed, see
+    // sinks/deferred_sink.h
+    bool   lazy_init        = false;
+    size_t lazy_buffer_size = 256 * 1024;   // bytes held until the file is open
+
+    // threads writing the files: thread pool workers, the staging drain thread, the periodic
+    // flush ("<name>-flush") and the network sender ("<name>-net"); names are cut to 15 bytes,
+    // empty = left as created
+    uint64_t       writer_affinity    = 0;   // bit i = may run on CPU i, 0 = any CPU
+    ThreadPriority writer_priority    = ThreadPriority::normal;
+    std::string    writer_thread_name = "mlogger";
+
+    // duplicate suppression and rate limits, see core/message_filter.h
+    int      dedup_window_ms  = 0;   // repeats within the window are counted, not written; 0 = off
+    uint32_t rate_limit       = 0;   // records per second per channel and level, 0 = unlimited
+    uint32_t rate_limit_burst = 0;   // records passing at once, 0 = rate_limit
+
+    // log shipping: every record also goes to a collector, see sinks/network_sink.h and
+    // tools/mlogger_collect.cpp; the log file keeps whatever the network drops
+    std::string     network_address;   // "host:port", empty = none
+    NetworkProtocol network_protocol    = NetworkProtocol::udp;
+    Compression     network_compression = Compression::none;   // per frame
+    size_t          network_frame_size  = 0;   // record bytes per frame, 0 = UDP 1200, TCP 64KB
+    size_t          network_buffer_size = 1024 * 1024;   // bytes of frames waiting to be sent
+
+    // shared memory publishing: records go to the named segment instead of the files, and one
+    // mlogger_aggregate process per host writes the files of every process publishing there,
+    // see sinks/shared_memory_sink.h. The logger is then synchronous and no thread of this
+    // process writes files; the file settings are the aggregator's, log_path only names the
+    // crash dump.
+    std::string shared_memory_name;                      // empty = write the files
+    size_t      shared_memory_size = 4 * 1024 * 1024;   // ring bytes, if this process creates it
 
     LoggerConfig() = default;
     explicit LoggerConfig(const std::string& path)
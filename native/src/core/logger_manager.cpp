@@ -1,16 +1,235 @@
 #include "logger_manager.h"
+#include "core/deferred_format.h"
 #include "core/logger_config.h"
+#include "core/message_filter.h"
+#include "sinks/binary_file_sink.h"
+#include "sinks/json_lines_sink.h"
+#include "sinks/log_file.h"
+#include "sinks/mapped_log_file.h"
+#include "sinks/network_sink.h"
+#include "sinks/rotating_file_sink.h"
+#include "sinks/shared_memory_sink.h"
+#include "sinks/uring_log_file.h"
+#include "utils/crash_handler.h"
 #include "utils/path_utils.h"
+#include "utils/periodic_worker.h"
+#include "utils/shared_ring.h"
 #include "utils/str_utils.h"
+#include "utils/thread_utils.h"
+#include "utils/tsc_clock.h"
+#include <chrono>
+#include <cstring>
 #include <filesystem>
 #include <iostream>
 #include <mutex>
 #include <spdlog/async.h>
-#include <spdlog/sinks/rotating_file_sink.h>
+#include <spdlog/details/file_helper.h>
+#include <thread>
+#include <tuple>
 
 namespace mlogger
 {
 
+namespace
+{
+
+// longest flush() waits for the thread pool, which may be stuck behind a full queue
+constexpr auto kAsyncFlushWait = std::chrono::seconds(5);
+
+// how often the cycle counter clock is fitted against the system clock again
+constexpr auto kClockCalibrationInterval = std::chrono::milliseconds(1000);
+// how often rate limited counts are reported without duplicate suppression
+constexpr auto kFilterSweepInterval = std::chrono::milliseconds(1000);
+
+// waitForDrains() timeout of terminate() and of files about to be reopened
+constexpr auto kWaitForever = std::chrono::milliseconds::max();
+
+size_t currentInFlightSlot(size_t slot_count)
+{
+    static std::atomic<size_t> next_slot{0};
+    thread_local size_t        slot = next_slot.fetch_add(1, std::memory_order_relaxed);
+    return slot % slot_count;
+}
+
+spdlog::log_clock::time_point toTimePoint(int64_t timestamp_us)
+{
+    if (timestamp_us <= 0) {
+        return spdlog::log_clock::now();
+    }
+    auto since_epoch = std::chrono::duration_cast<spdlog::log_clock::duration>(
+        std::chrono::microseconds(timestamp_us));
+    return spdlog::log_clock::time_point(since_epoch);
+}
+
+// Per-thread text buffer for logException(), reused so exception storms do not churn the heap.
+// Buffers grown by an unusually large trace are given back instead of being kept forever.
+class ExceptionBuffer final
+{
+public:
+    static constexpr size_t kMaxRetained = 64 * 1024;
+
+    ExceptionBuffer()
+        : text_(buffer())
+    {
+    }
+
+    ~ExceptionBuffer()
+    {
+        if (text_.capacity() > kMaxRetained) {
+            std::string().swap(text_);
+        }
+    }
+
+    std::string& text() { return text_; }
+
+    ExceptionBuffer(const ExceptionBuffer&)            = delete;
+    ExceptionBuffer& operator=(const ExceptionBuffer&) = delete;
+
+private:
+    static std::string& buffer()
+    {
+        thread_local std::string text;
+        return text;
+    }
+
+    std::string& text_;
+};
+
+// Counts one record handed to the logger, and times the call for every few records.
+class DeliveryProbe final
+{
+public:
+    DeliveryProbe(LogStats& stats, int level)
+        : stats_(stats)
+        , sampled_(stats.sampleLatency())
+    {
+        stats_.countMessage(level);
+        if (sampled_) start_ = std::chrono::steady_clock::now();
+    }
+
+    ~DeliveryProbe()
+    {
+        if (sampled_) {
+            auto elapsed = std::chrono::steady_clock::now() - start_;
+            stats_.recordLatency(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        }
+    }
+
+    DeliveryProbe(const DeliveryProbe&)            = delete;
+    DeliveryProbe& operator=(const DeliveryProbe&) = delete;
+
+private:
+    LogStats&                             stats_;
+    bool                                  sampled_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+std::unique_ptr<LogFile> createLogFile(const LoggerConfig& config)
+{
+    if (config.file_writer == FileWriter::mapped) {
+        return std::make_unique<MappedLogFile>(config.max_file_size);
+    }
+    if (config.file_writer == FileWriter::uring && UringLogFile::isSupported()) {
+        return std::make_unique<UringLogFile>(config.flush_bytes, config.direct_io);
+    }
+    return std::make_unique<StdioLogFile>(config.flush_bytes);
+}
+
+// "last message repeated N times: <record>" or "N messages rate limited"
+void appendSummaryText(const MessageFilter::Summary& summary, spdlog::memory_buf_t& dest)
+{
+    std::string count = std::to_string(summary.count);
+    if (summary.rate_limited) {
+        dest.append(count.data(), count.data() + count.size());
+        dest.append(spdlog::string_view_t(" messages rate limited"));
+        return;
+    }
+
+    dest.append(spdlog::string_view_t("last message repeated "));
+    dest.append(count.data(), count.data() + count.size());
+    dest.append(spdlog::string_view_t(" times"));
+    spdlog::string_view_t payload(summary.payload, summary.payload_size);
+    if (!summary.payload_tag) {
+        dest.append(spdlog::string_view_t(": "));
+        dest.append(payload);
+        if (summary.truncated) dest.append(spdlog::string_view_t("..."));
+    } else if (!summary.truncated) {
+        // NOTE: only a whole structured or formatted payload can be rendered
+        dest.append(spdlog::string_view_t(": "));
+        appendPayloadText(summary.payload_tag, payload, dest);
+    }
+}
+
+// game.log -> game.crash.log
+std::string defaultCrashDumpPath(const std::string& log_path)
+{
+    std::string basename, ext;
+    std::tie(basename, ext) = spdlog::details::file_helper::split_by_extension(log_path);
+    return basename + ".crash" + ext;
+}
+
+// whether a file sink built for `previous` can go on writing for `config`
+bool sameFileSettings(const LoggerConfig& previous, const LoggerConfig& config)
+{
+    // NOTE: mapped files are preallocated to max_file_size
+    return previous.file_format == config.file_format &&
+           previous.file_writer == config.file_writer &&
+           previous.compression == config.compression && previous.max_files == config.max_files &&
+           previous.flush_bytes == config.flush_bytes && previous.direct_io == config.direct_io &&
+           (config.file_writer != FileWriter::mapped ||
+            previous.max_file_size == config.max_file_size);
+}
+
+bool keepsFileSink(const LoggerConfig& previous, const LoggerConfig& config)
+{
+    return previous.log_path == config.log_path && sameFileSettings(previous, config) &&
+           previous.index_block_lines == config.index_block_lines;
+}
+
+bool keepsJsonSink(const LoggerConfig& previous, const LoggerConfig& config)
+{
+    return !config.json_log_path.empty() && previous.json_log_path == config.json_log_path &&
+           sameFileSettings(previous, config);
+}
+
+bool keepsNetworkSink(const LoggerConfig& previous, const LoggerConfig& config)
+{
+    return previous.network_address == config.network_address &&
+           previous.network_protocol == config.network_protocol &&
+           previous.network_compression == config.network_compression &&
+           previous.network_frame_size == config.network_frame_size &&
+           previous.network_buffer_size == config.network_buffer_size;
+}
+
+bool keepsSharedMemorySink(const LoggerConfig& previous, const LoggerConfig& config)
+{
+    // NOTE: an existing segment keeps its capacity, the size does not matter
+    return previous.shared_memory_name == config.shared_memory_name;
+}
+
+bool writesFile(const LoggerConfig& config, const std::string& path)
+{
+    return !path.empty() && (path == config.log_path || path == config.json_log_path);
+}
+
+}   // namespace
+
+LoggerManager::LoggerSnapshot::LoggerSnapshot(const LoggerManager& manager)
+    : slot_(manager.in_flight_[currentInFlightSlot(kInFlightSlots)])
+    , phase_(manager.generation_.load() & 1)
+{
+    // NOTE: seq_cst on both sides pairs with swapBackend(): either we observe the new pointer, or
+    // swapBackend() observes our slot count and waits for us.
+    slot_.count[phase_].fetch_add(1);
+    backend_ = manager.active_backend_.load();
+}
+
+LoggerManager::LoggerSnapshot::~LoggerSnapshot()
+{
+    slot_.count[phase_].fetch_sub(1, std::memory_order_release);
+}
+
 LoggerManager& LoggerManager::getInstance()
 {
     static LoggerManager instance;
@@ -18,113 +237,561 @@ LoggerManager& LoggerManager::getInstance()
 }
 
 bool LoggerManager::initialize(const LoggerConfig& config)
+{
+    return replaceBackend(config, true);
+}
+
+bool LoggerManager::initialize(const std::string& log_path)
+{
+    LoggerConfig config(log_path);
+    return initialize(config);
+}
+
+bool LoggerManager::reconfigure(const LoggerConfig& config)
+{
+    return replaceBackend(config, false);
+}
+
+bool LoggerManager::replaceBackend(const LoggerConfig& config, bool fresh)
 {
     if (!config.isValid()) {
         return false;
     }
 
-    bool need_terminate = false;
-    {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (initialized_) need_terminate = true;
-    }
-    if (need_terminate) terminate();
-
     std::lock_guard<std::mutex> lock(mutex_);
 
     try {
-        // prepare directory
-        if (!ensureDirectoryExists(config.log_path)) {
-            throw std::runtime_error("Failed to create log directory");
+        // NOTE: a file the running backend writes with other settings is closed before it is
+        // opened again, logging pauses until the old backend is drained. A deferred backend has
+        // no files yet.
+        const Backend* previous  = backend_ && backend_->file_sink ? backend_.get() : nullptr;
+        bool           keep_file = previous && keepsFileSink(previous->config, config);
+        bool           keep_json =
+            previous && previous->json_sink && keepsJsonSink(previous->config, config);
+        if (previous &&
+            ((!keep_file && writesFile(previous->config, config.log_path)) ||
+             (!keep_json && writesFile(previous->config, config.json_log_path)))) {
+            std::unique_ptr<Backend> retired = swapBackend(nullptr);
+            initialized_                     = false;
+            releaseBackend(*retired);
+            keep_file = false;
+            keep_json = false;
         }
+        // files still written by backends draining on their own
+        if (!keep_file) waitForDrains(config.log_path, kWaitForever);
+        if (!keep_json && !config.json_log_path.empty()) {
+            waitForDrains(config.json_log_path, kWaitForever);
+        }
+
+        if (fresh) stats_.reset();
+        // NOTE: lazy only while no file is open, a running logger is reconfigured as usual
+        bool                     lazy = config.lazy_init && (!backend_ || backend_->deferred_sink);
+        std::unique_ptr<Backend> next = lazy ? createDeferredBackend(config)
+                                             : createBackend(config, backend_.get(), fresh);
+
+        spdlog::drop(kDefaultLoggerName);
+        spdlog::register_logger(next->logger);
+        if (backend_ && backend_->deferred_sink) forwardDeferred(*backend_, *next);
+
+        log_level_.store(config.min_log_level, std::memory_order_relaxed);
+        active_level_.store(next->ring_sink ? 0 : config.min_log_level, std::memory_order_relaxed);
+        std::unique_ptr<Backend> retired = swapBackend(std::move(next));
+        initialized_                     = true;
+        if (retired && retired->deferred_sink) {
+            releaseBackend(*retired);
+        } else if (retired) {
+            startDrain(std::move(retired));
+        }
+
+        updateCrashHandler(config.crash_handler);
+        if (lazy) startLazyBuild();
+        return true;
+    } catch (const std::exception& e) {
+        initialized_ = backend_ != nullptr;
+        reportError("initialize", e.what());
+        return false;
+    } catch (...) {
+        initialized_ = backend_ != nullptr;
+        reportError("initialize", "Unknown exception occurred during initialization");
+        return false;
+    }
+}
+
+std::unique_ptr<LoggerManager::Backend> LoggerManager::createBackend(const LoggerConfig& config,
+                                                                     const Backend* previous,
+                                                                     bool           fresh)
+{
+    auto backend    = std::make_unique<Backend>();
+    backend->config = config;
+    // NOTE: publishing to shared memory, the aggregator has the files
+    bool shared = !config.shared_memory_name.empty();
+    bool async  = config.async_mode && !shared;
+
+    // prepare directory
+    if (!shared && !ensureDirectoryExists(config.log_path)) {
+        throw std::runtime_error("Failed to create log directory");
+    }
+
+    auto error_handler = [this](const char* message) { reportError("compression", message); };
+    bool compress      = false;
+    if (!shared && config.compression != Compression::none) {
+        compress = LogCompressor::isAvailable(config.compression);
+        if (!compress) {
+            reportError("initialize",
+                        "Compression codec not built in, rotated files stay uncompressed");
+        }
+    }
+    if (!shared && config.file_writer == FileWriter::uring && !UringLogFile::isSupported()) {
+        reportError("initialize", "io_uring is not available, writing the log files with stdio");
+    }
 
-        // prepare configs
-        auto rotating_sink = std::make_shared<spdlog::sinks::rotating_file_sink_mt>(
-            config.log_path, config.max_file_size, config.max_files);
+    // prepare configs
+    std::shared_ptr<RotatingFileSink> rotating_sink;
+    if (shared) {
+        // NOTE: a kept sink keeps its mapping
+        if (!fresh && previous && previous->shared_sink &&
+            keepsSharedMemorySink(previous->config, config)) {
+            backend->shared_sink = previous->shared_sink;
+        } else {
+            std::string                 error;
+            std::shared_ptr<SharedRing> ring =
+                SharedRing::open(config.shared_memory_name, config.shared_memory_size, error);
+            if (!ring) {
+                throw std::runtime_error(error);
+            }
+            backend->shared_sink = std::make_shared<SharedMemorySink>(std::move(ring));
+        }
+    } else if (previous && previous->file_sink && keepsFileSink(previous->config, config)) {
+        rotating_sink = previous->file_sink;
+        rotating_sink->setMaxSize(config.max_file_size);
+    } else {
+        if (config.file_format == FileFormat::binary) {
+            rotating_sink = std::make_shared<BinaryFileSink>(
+                config.log_path, config.max_file_size, config.max_files, createLogFile(config));
+        } else {
+            rotating_sink = std::make_shared<RotatingFileSink>(
+                config.log_path, config.max_file_size, config.max_files, createLogFile(config));
+        }
         if (rotating_sink == nullptr) {
             throw std::runtime_error("Failed to create rotating file sink");
         }
-        spdlog::level::level_enum min_level = convertLogLevel(config.min_log_level);
-        rotating_sink->set_level(min_level);
-        async_mode_ = config.async_mode;
+        rotating_sink->setStats(&stats_);
+        if (config.file_format == FileFormat::text && config.index_block_lines > 0) {
+            rotating_sink->setIndex(static_cast<uint32_t>(config.index_block_lines));
+        }
+        if (compress) rotating_sink->setCompression(config.compression, error_handler);
+    }
 
-        // create specific logger
-        if (async_mode_) {
-            auto tp = spdlog::thread_pool();
-            if (tp == nullptr) {
-                spdlog::init_thread_pool(8192, config.thread_pool_size);
-            }
-            tp = spdlog::thread_pool();
-            if (tp == nullptr) {
-                throw std::runtime_error("Failed to create thread pool");
-            }
+    // optional JSON-lines copy, written by the same backend thread as the main file
+    if (!shared && previous && previous->json_sink && keepsJsonSink(previous->config, config)) {
+        backend->json_sink = previous->json_sink;
+        backend->json_sink->setMaxSize(config.max_file_size);
+    } else if (!shared && !config.json_log_path.empty()) {
+        if (!ensureDirectoryExists(config.json_log_path)) {
+            throw std::runtime_error("Failed to create JSON log directory");
+        }
+        backend->json_sink = std::make_shared<JsonLinesSink>(config.json_log_path,
+                                                             config.max_file_size,
+                                                             config.max_files,
+                                                             createLogFile(config));
+        if (compress) backend->json_sink->setCompression(config.compression, error_handler);
+    }
 
-            async_logger_ =
-                std::make_shared<spdlog::async_logger>("mlogger",
-                                                       rotating_sink,
-                                                       spdlog::thread_pool(),
-                                                       spdlog::async_overflow_policy::block);
-            if (async_logger_ == nullptr) {
-                throw std::runtime_error("Failed to create async logger");
-            }
+    // NOTE: levels are filtered by the loggers only, channels may be more verbose than the
+    // default logger
+    backend->file_sink = rotating_sink;
+
+    // NOTE: the ring is fed by the logging thread itself, records below min_level never enter
+    // the async queue
+    if (!fresh && previous && previous->ring_sink &&
+        previous->config.ring_buffer_size == config.ring_buffer_size) {
+        backend->ring_sink = previous->ring_sink;
+    } else if (config.ring_buffer_size > 0) {
+        backend->ring_sink = std::make_shared<RingBufferSink>(config.ring_buffer_size);
+    }
+    if (backend->ring_sink) {
+        backend->crash_dump_path = config.crash_dump_path.empty()
+                                       ? defaultCrashDumpPath(config.log_path)
+                                       : config.crash_dump_path;
+    }
+
+    // create the backend shared by the default logger and every channel
+    if (async && config.async_backend == AsyncBackend::staging_rings) {
+        backend->staging_backend = std::make_shared<StagingBackend>(
+            config.staging_ring_size,
+            config.overflow_policy,
+            [this](const char* message) { reportError("staging", message); },
+            writerThreadStart(config));
+    } else if (async) {
+        // NOTE: the pool is ours rather than spdlog's global one, so queue_size applies on every
+        // initialize()
+        backend->thread_pool = std::make_shared<spdlog::details::thread_pool>(
+            config.queue_size, static_cast<size_t>(config.thread_pool_size),
+            writerThreadStart(config));
+        if (backend->thread_pool == nullptr) {
+            throw std::runtime_error("Failed to create thread pool");
+        }
+
+        backend->overflow_sink = std::make_shared<OverflowSink>(
+            rotating_sink, config.overflow_policy, config.queue_size, backend->thread_pool.get());
+        if (config.overflow_policy == OverflowPolicy::drop_newest) {
+            backend->admission = backend->overflow_sink.get();
+        }
+    }
+
+    if (backend->shared_sink) {
+        backend->sinks.assign(1, backend->shared_sink);
+    } else {
+        backend->sinks.assign(1, backend->overflow_sink ? spdlog::sink_ptr(backend->overflow_sink)
+                                                        : rotating_sink);
+    }
+    if (backend->json_sink) backend->sinks.push_back(backend->json_sink);
+    // NOTE: a kept sink keeps its connection and the frames not sent yet
+    if (!fresh && previous && previous->network_sink &&
+        keepsNetworkSink(previous->config, config)) {
+        backend->network_sink = previous->network_sink;
+    } else if (!config.network_address.empty()) {
+        Compression codec = config.network_compression;
+        if (codec != Compression::none && !LogCompressor::isAvailable(codec)) {
+            reportError("initialize",
+                        "Compression codec not built in, network frames stay uncompressed");
+            codec = Compression::none;
+        }
+        backend->network_sink = std::make_shared<NetworkSink>(
+            config.network_address, config.network_protocol, config.network_frame_size,
+            config.network_buffer_size, codec,
+            [this](const char* message) { reportError("network", message); },
+            writerThreadStart(config, "-net"));
+        backend->network_sink->setStats(&stats_);
+    }
+    if (backend->network_sink) backend->sinks.push_back(backend->network_sink);
+    // NOTE: last, so a line reaches the tail only once the files have it
+    if (!fresh && previous && previous->tail_sink &&
+        previous->config.tail_buffer_size == config.tail_buffer_size) {
+        backend->tail_sink = previous->tail_sink;
+    } else if (config.tail_buffer_size > 0) {
+        backend->tail_sink = std::make_shared<TailSink>(config.tail_buffer_size);
+    }
+    if (backend->tail_sink) backend->sinks.push_back(backend->tail_sink);
+
+    backend->logger = createLogger(*backend, kDefaultLoggerName, config.min_log_level);
+    if (backend->logger == nullptr) {
+        throw std::runtime_error("Failed to create logger");
+    }
+    backend->async_logger = std::dynamic_pointer_cast<spdlog::async_logger>(backend->logger);
+    // NOTE: under overrun_oldest the barrier's request could be evicted, and its own post could
+    // evict a record; flush() then only queues the flush
+    if (backend->thread_pool && config.overflow_policy != OverflowPolicy::overrun_oldest) {
+        backend->flush_barrier =
+            std::make_unique<FlushBarrier>(backend->sinks, backend->thread_pool,
+                                           static_cast<size_t>(config.thread_pool_size));
+    }
+
+    createChannelLoggers(*backend, config.min_log_level);
+
+    // NOTE: flushes the sink directly instead of through logger->flush(), so nothing is queued
+    // behind the records and idle intervals cost no syscall
+    if (config.flush_interval_ms > 0 && (rotating_sink || backend->network_sink)) {
+        std::shared_ptr<RotatingFileSink> json_sink    = backend->json_sink;
+        std::shared_ptr<NetworkSink>      network_sink = backend->network_sink;
+        backend->flush_worker = std::make_unique<PeriodicWorker>(
+            [this, rotating_sink, json_sink, network_sink]() {
+                try {
+                    if (rotating_sink) rotating_sink->flushIfDirty();
+                    if (json_sink) json_sink->flushIfDirty();
+                    if (network_sink) network_sink->flush();
+                } catch (const std::exception& e) {
+                    reportError("flush", e.what());
+                } catch (...) {
+                    reportError("flush", "Unknown exception occurred while flushing");
+                }
+            },
+            std::chrono::milliseconds(config.flush_interval_ms),
+            writerThreadStart(config, "-flush"));
+    }
 
-            async_logger_->set_level(min_level);
-            async_logger_->flush_on(spdlog::level::err);
-            spdlog::register_logger(async_logger_);
+    // NOTE: the worker reports repeats and limited records of buckets that went quiet, busy ones
+    // report with their own next record
+    if (config.dedup_window_ms > 0 || config.rate_limit > 0) {
+        backend->filter = std::make_unique<MessageFilter>(
+            kMaxChannels, config.dedup_window_ms, config.rate_limit, config.rate_limit_burst);
+        Backend* owner    = backend.get();
+        auto     interval = config.dedup_window_ms > 0
+                                ? std::chrono::milliseconds(config.dedup_window_ms)
+                                : kFilterSweepInterval;
+        backend->filter_worker = std::make_unique<PeriodicWorker>(
+            [this, owner]() { sweepFilter(*owner, false); }, interval,
+            writerThreadStart(config, "-filter"));
+    }
 
-            logger_ = async_logger_;
+    // NOTE: the producers scale the counter with whatever calibration is published, the worker
+    // only keeps it current
+    if (config.clock_source == ClockSource::tsc) {
+        if (TscClock::isSupported()) {
+            TscClock::recalibrate();
+            backend->clock_worker = std::make_unique<PeriodicWorker>(
+                []() { TscClock::recalibrate(); }, kClockCalibrationInterval,
+                writerThreadStart(config, "-clock"));
+            backend->tsc_clock = true;
         } else {
-            logger_ = std::make_shared<spdlog::logger>("mlogger", rotating_sink);
-            if (logger_ == nullptr) {
-                throw std::runtime_error("Failed to create logger");
-            }
+            reportError("initialize", "No invariant cycle counter, using the system clock");
+        }
+    }
+    return backend;
+}
+
+std::unique_ptr<LoggerManager::Backend> LoggerManager::createDeferredBackend(
+    const LoggerConfig& config)
+{
+    auto backend           = std::make_unique<Backend>();
+    backend->config        = config;
+    backend->deferred_sink = std::make_shared<DeferredSink>(config.lazy_buffer_size);
+
+    // memory only, so crash dumps cover the start as well; the backend with the files keeps it
+    if (config.ring_buffer_size > 0) {
+        backend->ring_sink       = std::make_shared<RingBufferSink>(config.ring_buffer_size);
+        backend->crash_dump_path = config.crash_dump_path.empty()
+                                       ? defaultCrashDumpPath(config.log_path)
+                                       : config.crash_dump_path;
+    }
+
+    backend->sinks.assign(1, backend->deferred_sink);
+    backend->logger = createLogger(*backend, kDefaultLoggerName, config.min_log_level);
+    createChannelLoggers(*backend, config.min_log_level);
+    return backend;
+}
 
-            logger_->set_level(min_level);
-            logger_->flush_on(spdlog::level::err);
-            spdlog::register_logger(logger_);
+void LoggerManager::createChannelLoggers(Backend& backend, int default_level)
+{
+    // channels created earlier keep their ids and levels
+    for (size_t i = 1; i < channel_count_; ++i) {
+        int level                 = channels_[i].level.load(std::memory_order_relaxed);
+        backend.channel_owners[i] = createLogger(
+            backend, channels_[i].name, level == kLevelInherit ? default_level : level);
+        backend.channel_loggers[i].store(backend.channel_owners[i].get(),
+                                         std::memory_order_relaxed);
+    }
+}
+
+void LoggerManager::forwardDeferred(Backend& pending, const Backend& next)
+{
+    // NOTE: records go to the logger of their channel, by name; the dropped summary has none.
+    // They take a drop_newest slot like any other record, or the queue count would underflow.
+    pending.deferred_sink->forward([&next](const spdlog::details::log_msg& msg) {
+        spdlog::logger* logger = next.logger.get();
+        if (msg.logger_name != spdlog::string_view_t(kDefaultLoggerName)) {
+            for (const std::shared_ptr<spdlog::logger>& owner : next.channel_owners) {
+                if (owner && spdlog::string_view_t(owner->name()) == msg.logger_name) {
+                    logger = owner.get();
+                    break;
+                }
+            }
+        }
+        if (logger->should_log(msg.level) && admit(next, logger, msg.level)) {
+            logger->log(msg.time, msg.source, msg.level, msg.payload);
         }
+    });
+}
 
-        initialized_ = true;
-        return true;
+void LoggerManager::completeBackend()
+{
+    if (!backend_ || !backend_->deferred_sink) {
+        return;
+    }
+
+    try {
+        LoggerConfig config  = backend_->config;
+        config.min_log_level = log_level_.load(std::memory_order_relaxed);
+        std::unique_ptr<Backend> next = createBackend(config, backend_.get(), false);
+
+        spdlog::drop(kDefaultLoggerName);
+        spdlog::register_logger(next->logger);
+        forwardDeferred(*backend_, *next);
+
+        std::unique_ptr<Backend> retired = swapBackend(std::move(next));
+        releaseBackend(*retired);
     } catch (const std::exception& e) {
-        initialized_ = false;
         reportError("initialize", e.what());
-        return false;
     } catch (...) {
-        initialized_ = false;
         reportError("initialize", "Unknown exception occurred during initialization");
-        return false;
     }
 }
 
-bool LoggerManager::initialize(const std::string& log_path)
+void LoggerManager::startLazyBuild()
 {
-    LoggerConfig config(log_path);
-    return initialize(config);
+    // a build already waiting for the lock completes whatever backend is deferred by then
+    if (lazy_build_running_) {
+        return;
+    }
+
+    lazy_build_running_ = true;
+    try {
+        lazy_build_ = std::async(std::launch::async, [this]() {
+                          std::lock_guard<std::mutex> lock(mutex_);
+                          completeBackend();
+                          lazy_build_running_ = false;
+                      }).share();
+    } catch (...) {
+        // no thread to spare, open the files here
+        lazy_build_running_ = false;
+        completeBackend();
+    }
+}
+
+void LoggerManager::waitForLazyBuild()
+{
+    std::shared_future<void> build;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        build = lazy_build_;
+    }
+    if (build.valid()) build.wait();
 }
 
 void LoggerManager::log(int level, const char* message)
 {
-    if (!initialized_ || !message) {
+    if (!message) {
         return;
     }
 
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (!logger_) {
+    // NOTE: out of range levels fall through so convertLogLevel() can report them
+    if (level >= 0 && level < active_level_.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    log(level, message, std::strlen(message), 0);
+}
+
+void LoggerManager::log(int level, const char* message, size_t length, int64_t timestamp_us,
+                        const char* payload_tag)
+{
+    if (!message) {
+        return;
+    }
+
+    if (level >= 0 && level < active_level_.load(std::memory_order_relaxed)) {
         return;
     }
 
-    spdlog::level::level_enum spdlog_level = convertLogLevel(level);
+    LoggerSnapshot  snapshot(*this);
+    spdlog::logger* logger = snapshot.get();
+    if (!logger) {
+        return;
+    }
+
+    write(*snapshot.backend(), logger, kDefaultChannel, level, message, length, timestamp_us,
+          payload_tag);
+}
+
+void LoggerManager::logStructured(int level, spdlog::string_view_t payload)
+{
+    if (level >= 0 && level < active_level_.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    LoggerSnapshot  snapshot(*this);
+    spdlog::logger* logger = snapshot.get();
+    if (!logger) {
+        return;
+    }
+
+    write(*snapshot.backend(), logger, kDefaultChannel, level, payload.data(), payload.size(), 0,
+          kStructuredTag);
+}
+
+void LoggerManager::logFormatted(int level, spdlog::string_view_t payload)
+{
+    if (level >= 0 && level < active_level_.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    LoggerSnapshot  snapshot(*this);
+    spdlog::logger* logger = snapshot.get();
+    if (!logger) {
+        return;
+    }
+
+    write(*snapshot.backend(), logger, kDefaultChannel, level, payload.data(), payload.size(), 0,
+          kFormattedTag);
+}
+
+void LoggerManager::logChannel(int channel, int level, const char* message, size_t length,
+                               int64_t timestamp_us, const char* payload_tag)
+{
+    if (channel == kDefaultChannel) {
+        log(level, message, length, timestamp_us, payload_tag);
+        return;
+    }
+    if (!message || channel < 0 || channel >= static_cast<int>(kMaxChannels)) {
+        return;
+    }
 
+    const Channel& entry         = channels_[channel];
+    int            channel_level = entry.level.load(std::memory_order_relaxed);
+    int            gate          = channel_level == kLevelInherit
+                                       ? active_level_.load(std::memory_order_relaxed)
+                                       : channel_level;
+    if (level >= 0 && level < gate) {
+        return;
+    }
+
+    // NOTE: channel loggers belong to the backend, the snapshot keeps them
+    LoggerSnapshot snapshot(*this);
+    const Backend* backend = snapshot.backend();
+    if (!backend) {
+        return;
+    }
+    spdlog::logger* logger = backend->channel_loggers[channel].load(std::memory_order_acquire);
+    if (!logger) {
+        return;
+    }
+
+    // the gate above already applied an explicit channel level to the flight recorder
+    write(*backend, logger, channel, level, message, length, timestamp_us, payload_tag);
+}
+
+void LoggerManager::write(const Backend& backend, spdlog::logger* logger, int channel, int level,
+                          const char* message, size_t length, int64_t timestamp_us,
+                          const char* payload_tag)
+{
     try {
-        switch (spdlog_level) {
-        case spdlog::level::trace: logger_->trace(message); break;
-        case spdlog::level::debug: logger_->debug(message); break;
-        case spdlog::level::info: logger_->info(message); break;
-        case spdlog::level::warn: logger_->warn(message); break;
-        case spdlog::level::err: logger_->error(message); break;
-        case spdlog::level::critical: logger_->critical(message); break;
-        default: throw std::runtime_error("Invalid log level");
+        RingBufferSink*           ring         = backend.ring_sink.get();
+        spdlog::level::level_enum spdlog_level = convertLogLevel(level);
+        spdlog::string_view_t     payload(message, length);
+        spdlog::source_loc        source;
+        source.funcname = payload_tag;
+
+        if (ring) {
+            spdlog::log_clock::time_point time = recordTime(backend, timestamp_us);
+            if (payload_tag) {
+                // the ring keeps text, render the payload here rather than at dump time
+                thread_local spdlog::memory_buf_t text;
+                text.clear();
+                appendPayloadText(payload_tag, payload, text);
+                ring->record(time, spdlog_level, spdlog::string_view_t(text.data(), text.size()));
+            } else {
+                ring->record(time, spdlog_level, payload);
+            }
+            if (logger->should_log(spdlog_level) &&
+                passFilter(backend, channel, level, payload_tag, payload) &&
+                admit(backend, logger, spdlog_level)) {
+                DeliveryProbe probe(stats_, level);
+                logger->log(time, source, spdlog_level, payload);
+            }
+            return;
+        }
+
+        if (!logger->should_log(spdlog_level) ||
+            !passFilter(backend, channel, level, payload_tag, payload) ||
+            !admit(backend, logger, spdlog_level)) {
+            return;
+        }
+
+        DeliveryProbe probe(stats_, level);
+        if (timestamp_us > 0 || backend.tsc_clock) {
+            logger->log(recordTime(backend, timestamp_us), source, spdlog_level, payload);
+        } else {
+            logger->log(source, spdlog_level, payload);
         }
     } catch (const std::exception& e) {
         reportError("log", e.what());
@@ -133,21 +800,55 @@ void LoggerManager::log(int level, const char* message)
     }
 }
 
-void LoggerManager::logException(const char* exception_type, const char* message,
-                                 const char* stack_trace)
+spdlog::log_clock::time_point LoggerManager::recordTime(const Backend& backend,
+                                                        int64_t        timestamp_us)
 {
-    if (!initialized_) {
-        return;
+    if (timestamp_us <= 0 && backend.tsc_clock) {
+        return TscClock::now();
     }
+    return toTimePoint(timestamp_us);
+}
 
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (!logger_) {
+void LoggerManager::logException(const char* exception_type, const char* message,
+                                 const char* stack_trace, int level)
+{
+    LoggerSnapshot  snapshot(*this);
+    spdlog::logger* logger = snapshot.get();
+    if (!logger) {
         return;
     }
 
     try {
-        std::string full_message = formatExceptionMessage(exception_type, message, stack_trace);
-        logger_->error(full_message);
+        const Backend&            backend      = *snapshot.backend();
+        spdlog::level::level_enum spdlog_level = convertLogLevel(level);
+        RingBufferSink*           ring         = snapshot.ring();
+        bool                      to_file      = logger->should_log(spdlog_level);
+        if (!ring && !to_file) {
+            return;
+        }
+
+        // NOTE: the logger copies the text (sync sinks format it in place, the async queue keeps
+        // its own copy), so the reused buffer is free again once log() returns
+        ExceptionBuffer buffer;
+        formatExceptionMessage(exception_type, message, stack_trace, buffer.text());
+        spdlog::string_view_t full_message(buffer.text());
+        spdlog::log_clock::time_point time = recordTime(backend, 0);
+        if (ring) {
+            ring->record(time, spdlog_level, full_message);
+            if (to_file && passFilter(backend, kDefaultChannel, level, nullptr, full_message) &&
+                admit(backend, logger, spdlog_level)) {
+                DeliveryProbe probe(stats_, level);
+                logger->log(time, spdlog::source_loc{}, spdlog_level, full_message);
+            }
+            if (spdlog_level == spdlog::level::critical &&
+                !ring->dump(backend.crash_dump_path.c_str())) {
+                reportError("logException", "Failed to dump the ring buffer");
+            }
+        } else if (passFilter(backend, kDefaultChannel, level, nullptr, full_message) &&
+                   admit(backend, logger, spdlog_level)) {
+            DeliveryProbe probe(stats_, level);
+            logger->log(time, spdlog::source_loc{}, spdlog_level, full_message);
+        }
     } catch (const std::exception& e) {
         reportError("logException", e.what());
     } catch (...) {
@@ -157,17 +858,32 @@ void LoggerManager::logException(const char* exception_type, const char* message
 
 void LoggerManager::flush()
 {
-    if (!initialized_) {
-        return;
+    // records handed to a backend retired by reconfigure() are older, they go first
+    waitForLazyBuild();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!waitForDrains(std::string(), kAsyncFlushWait)) {
+            reportError("flush", "Timed out waiting for a retired backend");
+        }
     }
 
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (!logger_) {
+    LoggerSnapshot snapshot(*this);
+    const Backend* backend = snapshot.backend();
+    if (!backend) {
         return;
     }
 
+    // NOTE: async_logger::flush() only queues the request behind the records, the barrier
+    // waits for the pool to reach a request of its own so what was logged before the call is
+    // written when it returns
     try {
-        logger_->flush();
+        if (backend->flush_barrier) {
+            if (!backend->flush_barrier->flush(kAsyncFlushWait)) {
+                reportError("flush", "Timed out waiting for the thread pool");
+            }
+        } else {
+            backend->logger->flush();
+        }
     } catch (const std::exception& e) {
         reportError("flush", e.what());
     } catch (...) {
@@ -175,26 +891,89 @@ void LoggerManager::flush()
     }
 }
 
-int LoggerManager::getLogLevel() const
+bool LoggerManager::dumpRing(const char* path)
 {
-    if (!initialized_) {
-        return 2;   // Default to INFO
+    LoggerSnapshot  snapshot(*this);
+    RingBufferSink* ring = snapshot.ring();
+    if (!ring) {
+        return false;
+    }
+    return ring->dump(path ? path : snapshot.backend()->crash_dump_path.c_str());
+}
+
+size_t LoggerManager::readTail(uint64_t& cursor, char* dest, size_t size, bool* skipped)
+{
+    std::shared_ptr<TailSink> tail;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (backend_) tail = backend_->tail_sink;
+    }
+    if (!tail) {
+        if (skipped) *skipped = false;
+        return 0;
     }
+    return tail->read(cursor, dest, size, skipped);
+}
 
+uint64_t LoggerManager::tailEnd() const
+{
     std::lock_guard<std::mutex> lock(mutex_);
-    if (!logger_) {
-        return 2;
+    return backend_ && backend_->tail_sink ? backend_->tail_sink->end() : 0;
+}
+
+uint64_t LoggerManager::getDroppedCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!backend_) {
+        return 0;
+    }
+    if (backend_->deferred_sink) {
+        return backend_->deferred_sink->droppedCount();
+    }
+    if (backend_->overflow_sink) {
+        return backend_->overflow_sink->droppedCount();
+    }
+    if (backend_->staging_backend) {
+        return backend_->staging_backend->droppedCount();
     }
+    if (backend_->shared_sink) {
+        return backend_->shared_sink->droppedCount();
+    }
+    return 0;
+}
 
-    try {
-        return convertToInt(logger_->level());
-    } catch (const std::exception& e) {
-        reportError("getLogLevel", e.what());
-        return 2;   // Default to INFO on error
-    } catch (...) {
-        reportError("getLogLevel", "Unknown exception occurred while getting log level");
-        return 2;   // Default to INFO on error
+LoggerStats LoggerManager::getStats() const
+{
+    LoggerStats stats;
+    stats_.snapshot(stats);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!backend_) {
+        return stats;
     }
+    if (const DeferredSink* deferred = backend_->deferred_sink.get()) {
+        stats.dropped = deferred->droppedCount();
+    } else if (const OverflowSink* overflow = backend_->overflow_sink.get()) {
+        stats.dropped          = overflow->droppedCount();
+        stats.queue_depth      = overflow->queueDepth();
+        stats.queue_high_water = overflow->queueHighWater();
+    } else if (StagingBackend* staging = backend_->staging_backend.get()) {
+        stats.dropped          = staging->droppedCount();
+        stats.queue_depth      = staging->queueDepth();
+        stats.queue_high_water = staging->queueHighWater();
+    } else if (const SharedMemorySink* shared = backend_->shared_sink.get()) {
+        stats.dropped = shared->droppedCount();
+    }
+    return stats;
+}
+
+int LoggerManager::getLogLevel() const
+{
+    if (!initialized_) {
+        return 2;   // Default to INFO
+    }
+
+    return log_level_.load(std::memory_order_relaxed);
 }
 
 void LoggerManager::setLogLevel(int level)
@@ -204,13 +983,23 @@ void LoggerManager::setLogLevel(int level)
     }
 
     std::lock_guard<std::mutex> lock(mutex_);
-    if (!logger_) {
+    if (!backend_) {
         return;
     }
 
     try {
         spdlog::level::level_enum spdlog_level = convertLogLevel(level);
-        logger_->set_level(spdlog_level);
+        backend_->logger->set_level(spdlog_level);
+        for (size_t i = 1; i < channel_count_; ++i) {
+            const std::shared_ptr<spdlog::logger>& owner = backend_->channel_owners[i];
+            if (owner && channels_[i].level.load(std::memory_order_relaxed) == kLevelInherit) {
+                owner->set_level(spdlog_level);
+            }
+        }
+        log_level_.store(level, std::memory_order_relaxed);
+        if (!backend_->ring_sink) {
+            active_level_.store(level, std::memory_order_relaxed);
+        }
     } catch (const std::exception& e) {
         reportError("setLogLevel", e.what());
     } catch (...) {
@@ -218,34 +1007,204 @@ void LoggerManager::setLogLevel(int level)
     }
 }
 
-void LoggerManager::setErrorCallback(ErrorCallback callback)
+int LoggerManager::createChannel(const char* name)
 {
+    if (!name || *name == '\0' || std::strlen(name) > kMaxChannelName) {
+        return -1;
+    }
+
     std::lock_guard<std::mutex> lock(mutex_);
+    if (std::strcmp(name, kDefaultLoggerName) == 0) {
+        return kDefaultChannel;
+    }
+    for (size_t i = 1; i < channel_count_; ++i) {
+        if (channels_[i].name == name) {
+            return static_cast<int>(i);
+        }
+    }
+    if (channel_count_ == kMaxChannels) {
+        reportError("createChannel", "Too many channels");
+        return -1;
+    }
+
+    Channel& channel = channels_[channel_count_];
+    channel.name     = name;
+    channel.level.store(kLevelInherit, std::memory_order_relaxed);
+    if (backend_) {
+        try {
+            int                              level = log_level_.load(std::memory_order_relaxed);
+            std::shared_ptr<spdlog::logger>& owner = backend_->channel_owners[channel_count_];
+            owner = createLogger(*backend_, channel.name, level);
+            backend_->channel_loggers[channel_count_].store(owner.get(), std::memory_order_release);
+        } catch (const std::exception& e) {
+            reportError("createChannel", e.what());
+            return -1;
+        } catch (...) {
+            reportError("createChannel", "Unknown exception occurred while creating a channel");
+            return -1;
+        }
+    }
+    return static_cast<int>(channel_count_++);
+}
+
+bool LoggerManager::setChannelLevel(int channel, int level)
+{
+    if (channel == kDefaultChannel) {
+        if (level < 0 || level >= kLevelOff || !initialized_) return false;
+        setLogLevel(level);
+        return true;
+    }
+    if (level < kLevelInherit || level > kLevelOff) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (channel < 1 || static_cast<size_t>(channel) >= channel_count_) {
+        return false;
+    }
+
+    channels_[channel].level.store(level, std::memory_order_relaxed);
+    if (backend_ && backend_->channel_owners[channel]) {
+        backend_->channel_owners[channel]->set_level(toSpdlogLevel(
+            level == kLevelInherit ? log_level_.load(std::memory_order_relaxed) : level));
+    }
+    return true;
+}
+
+int LoggerManager::getChannelLevel(int channel) const
+{
+    if (channel == kDefaultChannel) {
+        return getLogLevel();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (channel < 1 || static_cast<size_t>(channel) >= channel_count_) {
+        return kLevelOff;
+    }
+    return channels_[channel].level.load(std::memory_order_relaxed);
+}
+
+void LoggerManager::setErrorCallback(ErrorCallback callback)
+{
+    std::lock_guard<std::mutex> lock(callback_mutex_);
     error_callback_ = std::move(callback);
 }
 
 bool LoggerManager::isInitialized() const
 {
-    std::lock_guard<std::mutex> lock(mutex_);
     return initialized_;
 }
 
 void LoggerManager::terminate()
 {
+    waitForLazyBuild();
     std::lock_guard<std::mutex> lock(mutex_);
 
+    // records still held for lazy initialization are written too
+    completeBackend();
+    updateCrashHandler(false);
+    std::unique_ptr<Backend> retired = swapBackend(nullptr);
+    initialized_                     = false;
+
+    // backends retired earlier hold older records
+    waitForDrains(std::string(), kWaitForever);
+    if (retired) {
+        dropLogger();
+        releaseBackend(*retired);
+    }
+}
+
+bool LoggerManager::terminateAsync(std::chrono::milliseconds timeout)
+{
+    waitForLazyBuild();
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    completeBackend();
+    updateCrashHandler(false);
+    std::unique_ptr<Backend> retired = swapBackend(nullptr);
+    initialized_                     = false;
+    if (retired) {
+        dropLogger();
+        startDrain(std::move(retired));
+    }
+    return waitForDrains(std::string(), timeout);
+}
+
+LoggerManager::~LoggerManager() noexcept
+{
+    terminate();
+}
+
+std::shared_ptr<spdlog::logger> LoggerManager::createLogger(const Backend&     backend,
+                                                            const std::string& name, int level)
+{
+    std::shared_ptr<spdlog::logger> logger;
+    const std::vector<spdlog::sink_ptr>& sinks = backend.sinks;
+    if (backend.staging_backend) {
+        logger = std::make_shared<StagingLogger>(name, sinks, backend.staging_backend);
+    } else if (backend.thread_pool) {
+        // drop_newest is decided by admit() before the record reaches the queue
+        auto policy = backend.overflow_sink->policy() == OverflowPolicy::overrun_oldest
+                          ? spdlog::async_overflow_policy::overrun_oldest
+                          : spdlog::async_overflow_policy::block;
+        logger = std::make_shared<spdlog::async_logger>(
+            name, sinks.begin(), sinks.end(), backend.thread_pool, policy);
+    } else {
+        logger = std::make_shared<spdlog::logger>(name, sinks.begin(), sinks.end());
+    }
+
+    logger->set_level(toSpdlogLevel(level));
+    logger->flush_on(spdlog::level::critical);
+    return logger;
+}
+
+std::unique_ptr<LoggerManager::Backend> LoggerManager::swapBackend(std::unique_ptr<Backend> next)
+{
+    if (!next) {
+        active_level_.store(kLevelOff, std::memory_order_relaxed);
+    }
+    active_backend_.store(next.get());
+
+    // NOTE: a reader may have read the phase before the last flip and the pointer after it, so
+    // both phases are flipped away from and drained in turn; new readers take the other phase
+    for (int round = 0; round < 2; ++round) {
+        unsigned phase = generation_.fetch_add(1) & 1;
+        for (const InFlightSlot& slot : in_flight_) {
+            while (slot.count[phase].load() != 0) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    backend_.swap(next);
+    return next;
+}
+
+void LoggerManager::releaseBackend(Backend& backend)
+{
+    backend.flush_worker.reset();
+    backend.clock_worker.reset();
+    backend.filter_worker.reset();
+    // counts still pending go out ahead of the final flush
+    if (backend.filter) {
+        sweepFilter(backend, true);
+    }
+
     // flush before terminating
-    if (logger_ && !async_mode_) {
+    if (backend.logger && !backend.thread_pool) {
         try {
-            logger_->flush();
+            backend.logger->flush();
         } catch (const std::exception& e) {
             reportError("terminate::flush", e.what());
         } catch (...) {
             reportError("terminate::flush", "Unknown exception during flush");
         }
-    } else if (async_logger_) {
+    } else if (backend.async_logger &&
+               backend.overflow_sink->policy() != OverflowPolicy::overrun_oldest) {
+        // NOTE: a flush request queued under overrun_oldest could evict a record, the pool
+        // drains and the sink closes on reset anyway
         try {
-            async_logger_->flush();
+            backend.async_logger->flush();
         } catch (const std::exception& e) {
             reportError("terminate::flush_async", e.what());
         } catch (...) {
@@ -253,35 +1212,172 @@ void LoggerManager::terminate()
         }
     }
 
-    // unregister logger from spdlog registry
-    if (logger_) {
-        try {
-            spdlog::drop("mlogger");
-        } catch (const std::exception& e) {
-            reportError("terminate::drop", e.what());
-        } catch (...) {
-            reportError("terminate::drop", "Unknown exception during logger drop");
+    // reset shared ptrs, the pool goes last and drains what is still queued. Channels keep their
+    // names and levels for the next initialize().
+    for (std::shared_ptr<spdlog::logger>& owner : backend.channel_owners) {
+        owner.reset();
+    }
+    backend.flush_barrier.reset();
+    backend.async_logger.reset();
+    backend.logger.reset();
+    backend.overflow_sink.reset();
+    backend.staging_backend.reset();
+    backend.thread_pool.reset();
+    backend.ring_sink.reset();
+    backend.sinks.clear();
+    backend.file_sink.reset();
+    backend.json_sink.reset();
+    backend.tail_sink.reset();
+    backend.network_sink.reset();
+    backend.shared_sink.reset();
+}
+
+void LoggerManager::startDrain(std::unique_ptr<Backend> backend)
+{
+    Drain drain;
+    drain.log_path      = backend->config.log_path;
+    drain.json_log_path = backend->config.json_log_path;
+
+    std::shared_ptr<Backend> retired(std::move(backend));
+    try {
+        drain.done = std::async(std::launch::async, [this, retired]() {
+                         releaseBackend(*retired);
+                     }).share();
+    } catch (...) {
+        // no thread to spare, drain here
+        releaseBackend(*retired);
+        return;
+    }
+
+    // finished drains are forgotten as new ones start
+    waitForDrains(std::string(), std::chrono::milliseconds(0));
+    drains_.push_back(std::move(drain));
+}
+
+bool LoggerManager::waitForDrains(const std::string& path, std::chrono::milliseconds timeout)
+{
+    auto deadline = std::chrono::steady_clock::now();
+    if (timeout != kWaitForever) deadline += timeout;
+
+    bool done = true;
+    for (auto it = drains_.begin(); it != drains_.end();) {
+        bool match = path.empty() || it->log_path == path || it->json_log_path == path;
+        if (match && timeout == kWaitForever) {
+            it->done.wait();
+        } else if (match) {
+            it->done.wait_until(deadline);
+        }
+
+        if (it->done.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+            it = drains_.erase(it);
+        } else {
+            done = done && !match;
+            ++it;
         }
     }
+    return done;
+}
 
-    // reset shared ptrs
-    if (async_logger_) async_logger_.reset();
-    if (logger_) logger_.reset();
+void LoggerManager::dropLogger()
+{
+    // unregister logger from spdlog registry
+    try {
+        spdlog::drop(kDefaultLoggerName);
+    } catch (const std::exception& e) {
+        reportError("terminate::drop", e.what());
+    } catch (...) {
+        reportError("terminate::drop", "Unknown exception during logger drop");
+    }
+}
 
-    initialized_ = false;
-    async_mode_  = false;
+void LoggerManager::updateCrashHandler(bool enabled)
+{
+    if (enabled == crash_handler_) {
+        return;
+    }
+    if (!enabled) {
+        uninstallCrashHandler();
+        crash_handler_ = false;
+        return;
+    }
+    crash_handler_ = installCrashHandler(&LoggerManager::onCrash);
+    if (!crash_handler_) {
+        reportError("initialize", "Failed to install the crash handler");
+    }
 }
 
-LoggerManager::~LoggerManager() noexcept
+bool LoggerManager::passFilter(const Backend& backend, int channel, int level,
+                               const char* payload_tag, spdlog::string_view_t payload)
 {
-    terminate();
+    if (!backend.filter) {
+        return true;
+    }
+
+    MessageFilter::Summaries summaries;
+    MessageFilter::Verdict   verdict = backend.filter->check(channel, level, payload_tag, payload,
+                                                             MessageFilter::now(), summaries);
+    for (size_t i = 0; i < summaries.count; ++i) {
+        writeSummary(backend, summaries.items[i]);
+    }
+    if (verdict == MessageFilter::Verdict::pass) {
+        return true;
+    }
+    stats_.countFiltered(verdict == MessageFilter::Verdict::rate_limited);
+    return false;
+}
+
+void LoggerManager::sweepFilter(const Backend& backend, bool all)
+{
+    try {
+        backend.filter->sweep(MessageFilter::now(), all,
+                              [this, &backend](const MessageFilter::Summary& summary) {
+                                  writeSummary(backend, summary);
+                              });
+    } catch (const std::exception& e) {
+        reportError("filter", e.what());
+    } catch (...) {
+        reportError("filter", "Unknown exception occurred while reporting filtered records");
+    }
+}
+
+void LoggerManager::writeSummary(const Backend& backend, const MessageFilter::Summary& summary)
+{
+    spdlog::logger* logger = summary.channel == kDefaultChannel
+                                 ? backend.logger.get()
+                                 : backend.channel_loggers[summary.channel].load();
+    spdlog::level::level_enum spdlog_level = convertLogLevel(summary.level);
+    if (!logger || !admit(backend, logger, spdlog_level)) {
+        return;
+    }
+
+    thread_local spdlog::memory_buf_t text;
+    text.clear();
+    appendSummaryText(summary, text);
+    logger->log(recordTime(backend, 0), spdlog::source_loc{}, spdlog_level,
+                spdlog::string_view_t(text.data(), text.size()));
+}
+
+bool LoggerManager::admit(const Backend& backend, spdlog::logger* logger,
+                          spdlog::level::level_enum level)
+{
+    // NOTE: only records that will really be queued may take a slot
+    if (!backend.admission || !logger->should_log(level)) {
+        return true;
+    }
+    return backend.admission->tryAdmit();
 }
 
 void LoggerManager::reportError(const char* function_name, const char* error_message) const
 {
-    if (error_callback_) {
+    ErrorCallback callback;
+    {
+        std::lock_guard<std::mutex> lock(callback_mutex_);
+        callback = error_callback_;
+    }
+
+    if (callback) {
         try {
-            error_callback_(error_message, function_name);
+            callback(error_message, function_name);
         } catch (...) {
             // NOTE: if callback itself throws, fall back to stderr
             std::cerr << "[MLogger Error in " << function_name << "] " << error_message
@@ -292,17 +1388,47 @@ void LoggerManager::reportError(const char* function_name, const char* error_mes
     }
 }
 
+std::function<void()> LoggerManager::writerThreadStart(const LoggerConfig& config,
+                                                       const char*         suffix)
+{
+    ThreadSettings settings;
+    settings.affinity = config.writer_affinity;
+    settings.priority = config.writer_priority;
+    if (!config.writer_thread_name.empty()) {
+        settings.name = config.writer_thread_name + suffix;
+    }
+    if (settings.affinity == 0 && settings.priority == ThreadPriority::normal &&
+        settings.name.empty()) {
+        return nullptr;
+    }
+    return [this, settings]() {
+        applyThreadSettings(settings, [this](const char* message) {
+            reportError("thread", message);
+        });
+    };
+}
+
+void LoggerManager::onCrash()
+{
+    // NOTE: signal context, only the ring dump itself is allowed here
+    const Backend* backend = getInstance().active_backend_.load();
+    if (backend && backend->ring_sink) {
+        backend->ring_sink->dump(backend->crash_dump_path.c_str(), true);
+    }
+}
+
 spdlog::level::level_enum LoggerManager::convertLogLevel(int level)
 {
-    switch (level) {
-    case 0: return spdlog::level::trace;
-    case 1: return spdlog::level::debug;
-    case 2: return spdlog::level::info;
-    case 3: return spdlog::level::warn;
-    case 4: return spdlog::level::err;
-    case 5: return spdlog::level::critical;
-    default: throw std::invalid_argument("Invalid log level int val: " + std::to_string(level));
+    // NOTE: only the range is checked, LogLevel has spdlog's values for trace..critical
+    if (level < spdlog::level::trace || level > spdlog::level::critical) {
+        throw std::invalid_argument("Invalid log level int val: " + std::to_string(level));
     }
+    return static_cast<spdlog::level::level_enum>(level);
+}
+
+spdlog::level::level_enum LoggerManager::toSpdlogLevel(int level)
+{
+    return level == kLevelOff ? spdlog::level::off : convertLogLevel(level);
 }
 
 int LoggerManager::convertToInt(spdlog::level::level_enum level)
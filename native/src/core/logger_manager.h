@@ -2,35 +2,119 @@
 #define LOGGER_MANAGER_H
 
 #include "logger_config.h"
+#include "logger_stats.h"
+#include "message_filter.h"
+#include "sinks/deferred_sink.h"
+#include "sinks/flush_barrier.h"
+#include "sinks/overflow_sink.h"
+#include "sinks/ring_buffer_sink.h"
+#include "sinks/tail_sink.h"
+#include "staging_logger.h"
+#include "utils/periodic_worker.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <functional>
+#include <future>
 #include <memory>
 #include <mutex>
 #include <spdlog/async.h>
-#include <spdlog/sinks/rotating_file_sink.h>
 #include <spdlog/spdlog.h>
+#include <string>
+#include <vector>
 
 namespace mlogger
 {
 
+class NetworkSink;
+class RotatingFileSink;
+class SharedMemorySink;
+
 using ErrorCallback = std::function<void(const char*, const char*)>;
 
 class LoggerManager final
 {
 public:
+    static constexpr int kLevelOff = 6;
+    // channel level that follows setLogLevel(), the default of every new channel
+    static constexpr int kLevelInherit = -1;
+    // id of the default logger, accepted wherever a channel id is
+    static constexpr int    kDefaultChannel      = 0;
+    static constexpr size_t kMaxChannels         = 64;
+    static constexpr size_t kMaxChannelName      = 63;
+    static constexpr char   kDefaultLoggerName[] = "mlogger";
+
     static LoggerManager& getInstance();
 
+    // With config.lazy_init the files are opened on a thread of its own, records logged until
+    // then are buffered and replayed; flush() and terminate() wait for it.
     bool initialize(const LoggerConfig& config);
     bool initialize(const std::string& log_path);
+    // Replaces the backend with one built from `config` while logging goes on: records keep
+    // flowing into the old backend until the new one is published, and the old one is drained on
+    // a thread of its own. Files whose path and settings did not change stay open (new rotation
+    // limits apply), the flight recorder and the live tail carry over when their sizes did not
+    // change, statistics are kept. A file reopened with other settings waits for the old backend
+    // like terminate(). Starts the logger when it is not initialized; on failure the running
+    // backend is left as it was.
+    bool reconfigure(const LoggerConfig& config);
     bool isInitialized() const;
+    // stops logging, writes every queued record and closes the files, including backends still
+    // draining after reconfigure() or terminateAsync()
     void terminate();
+    // Stops logging and drains the backend on a thread of its own, waiting at most `timeout`.
+    // True when everything was written in time; otherwise the drain goes on in the background
+    // and terminate(), initialize() of the same file or unloading the library waits for it.
+    bool terminateAsync(std::chrono::milliseconds timeout);
 
     void log(int level, const char* message);
-    void logException(const char* exception_type, const char* message, const char* stack_trace);
+    // `message` needs no terminator; timestamp_us is microseconds since the Unix epoch, 0 = now.
+    // `payload_tag` marks a payload the sinks render, kUtf16Tag for UTF-16 code units.
+    void log(int level, const char* message, size_t length, int64_t timestamp_us,
+             const char* payload_tag = nullptr);
+    // `payload` was packed by StructuredPayloadWriter; the text file and the flight recorder get
+    // the logfmt rendering, the JSON-lines file typed members
+    void logStructured(int level, spdlog::string_view_t payload);
+    // `payload` is a format id from FormatRegistry followed by encoded arguments, see
+    // deferred_format.h; formatted by the sinks, binary files keep the format and the arguments
+    void logFormatted(int level, spdlog::string_view_t payload);
+    // Channels share the log file and the async backend of the default logger, records carry the
+    // channel name. Ids stay valid across terminate() and initialize() for the process lifetime;
+    // the same name always yields the same id, -1 for an invalid name or when all are taken.
+    int createChannel(const char* name);
+    void logChannel(int channel, int level, const char* message, size_t length,
+                    int64_t timestamp_us, const char* payload_tag = nullptr);
+    // `level` is a log level, kLevelInherit or kLevelOff. An explicit level also filters what the
+    // flight recorder sees, inheriting channels behave like the default logger.
+    bool setChannelLevel(int channel, int level);
+    // kLevelOff for unknown ids
+    int getChannelLevel(int channel) const;
+    // a critical `level` also dumps the flight recorder ring to the crash dump path
+    void logException(const char* exception_type, const char* message, const char* stack_trace,
+                      int level = 4);
+
+    // writes the flight recorder ring to `path` (the crash dump path when null), false when the
+    // ring is disabled or the file cannot be written
+    bool dumpRing(const char* path);
+
+    // live tail reads, see TailSink::read(); nothing is copied while the tail is disabled
+    size_t   readTail(uint64_t& cursor, char* dest, size_t size, bool* skipped);
+    uint64_t tailEnd() const;
 
     void flush();
 
+    // records lost to the overflow policy since the last initialize()
+    uint64_t getDroppedCount() const;
+    // counters collected since the last initialize(); the queue and drop figures read the live
+    // backend and are zero once terminated
+    LoggerStats getStats() const;
+
     int  getLogLevel() const;
     void setLogLevel(int level);
+    // Address of the level word checked by the hot path, stable for the process lifetime.
+    // Holds kLevelOff while the logger is not initialized.
+    const std::atomic<int>* getLogLevelWord() const { return &active_level_; }
     void setErrorCallback(ErrorCallback callback);
 
     LoggerManager(const LoggerManager&)            = delete;
@@ -42,16 +126,160 @@ private:
     LoggerManager() = default;
     ~LoggerManager() noexcept;
 
-    std::shared_ptr<spdlog::logger>       logger_;
-    std::shared_ptr<spdlog::async_logger> async_logger_;
-    bool                                  initialized_ = false;
-    bool                                  async_mode_  = false;
-    ErrorCallback                         error_callback_;
-    mutable std::mutex                    mutex_;
+    // NOTE: readers announce themselves in one of these slots, under the phase of generation_
+    // they read, before loading active_backend_. Retiring a backend replaces the pointer and then
+    // waits for both phases in turn, see swapBackend().
+    struct alignas(64) InFlightSlot {
+        std::array<std::atomic<int>, 2> count{};
+    };
+    static constexpr size_t kInFlightSlots = 16;
+
+    // NOTE: slots are never reused, so the hot path reads the level without a lock
+    struct Channel {
+        std::string      name;   // guarded by mutex_
+        std::atomic<int> level{kLevelInherit};
+    };
+
+    // Everything one initialize() or reconfigure() creates. The hot path reaches it through
+    // LoggerSnapshot; a retired backend is drained and destroyed, by terminate() or on a thread
+    // of its own. Fixed once published, except for the channel loggers.
+    struct Backend {
+        LoggerConfig                                  config;
+        std::shared_ptr<spdlog::logger>               logger;
+        std::shared_ptr<spdlog::async_logger>         async_logger;
+        std::shared_ptr<spdlog::details::thread_pool> thread_pool;
+        std::shared_ptr<OverflowSink>                 overflow_sink;
+        // what flush() waits on in thread pool mode, null under overrun_oldest
+        std::unique_ptr<FlushBarrier>                 flush_barrier;
+        std::shared_ptr<StagingBackend>               staging_backend;
+        std::shared_ptr<RingBufferSink>               ring_sink;
+        std::shared_ptr<RotatingFileSink>             file_sink;
+        std::shared_ptr<RotatingFileSink>             json_sink;
+        std::shared_ptr<TailSink>                     tail_sink;
+        std::shared_ptr<NetworkSink>                  network_sink;
+        // shared memory publishing, in place of file_sink and json_sink
+        std::shared_ptr<SharedMemorySink>             shared_sink;
+        // lazy initialization, the only sink until the backend with the files takes over
+        std::shared_ptr<DeferredSink>                 deferred_sink;
+        // what every logger writes to: the file (or overflow_sink in front of it, or
+        // shared_sink), json_sink, network_sink and tail_sink
+        std::vector<spdlog::sink_ptr>                 sinks;
+        std::unique_ptr<PeriodicWorker>               flush_worker;
+        std::unique_ptr<PeriodicWorker>               clock_worker;   // recalibrates TscClock
+        // duplicate suppression and rate limits, null when both are off
+        std::unique_ptr<MessageFilter>                filter;
+        std::unique_ptr<PeriodicWorker>               filter_worker;   // reports quiet buckets
+        // by channel id, slot 0 is unused; owners are guarded by mutex_, the hot path reads
+        // channel_loggers
+        std::array<std::shared_ptr<spdlog::logger>, kMaxChannels> channel_owners;
+        std::array<std::atomic<spdlog::logger*>, kMaxChannels>    channel_loggers{};
+        // producer gate of overflow_sink, only set for drop_newest
+        OverflowSink* admission = nullptr;
+        bool          tsc_clock = false;   // ClockSource::tsc
+        std::string   crash_dump_path;
+    };
+
+    // a retired backend being drained on a thread of its own, with the files it still writes
+    struct Drain {
+        std::shared_future<void> done;
+        std::string              log_path;
+        std::string              json_log_path;
+    };
 
+    // RAII snapshot of active_backend_ used by the lock-free paths
+    class LoggerSnapshot final
+    {
+    public:
+        explicit LoggerSnapshot(const LoggerManager& manager);
+        ~LoggerSnapshot();
+
+        const Backend*  backend() const { return backend_; }
+        spdlog::logger* get() const { return backend_ ? backend_->logger.get() : nullptr; }
+        RingBufferSink* ring() const { return backend_ ? backend_->ring_sink.get() : nullptr; }
+
+        LoggerSnapshot(const LoggerSnapshot&)            = delete;
+        LoggerSnapshot& operator=(const LoggerSnapshot&) = delete;
+
+    private:
+        InFlightSlot&  slot_;
+        unsigned       phase_;
+        const Backend* backend_;
+    };
+
+    std::unique_ptr<Backend> backend_;   // guarded by mutex_
+    std::atomic<Backend*>    active_backend_{nullptr};
+    std::atomic<unsigned>    generation_{0};
+    std::vector<Drain>       drains_;   // guarded by mutex_
+    // lazy initialization, the thread completing the backend; guarded by mutex_
+    std::shared_future<void> lazy_build_;
+    bool                     lazy_build_running_ = false;
+    // NOTE: with the ring enabled the hot path admits every level, log_level_ keeps the file's
+    std::atomic<int>         active_level_{kLevelOff};
+    std::atomic<int>         log_level_{2};
+    std::atomic<bool>        initialized_{false};
+    bool                     crash_handler_ = false;
+    LogStats                 stats_;
+    ErrorCallback            error_callback_;
+    mutable std::mutex       mutex_;
+    mutable std::mutex       callback_mutex_;
+
+    mutable std::array<InFlightSlot, kInFlightSlots> in_flight_;
+
+    std::array<Channel, kMaxChannels> channels_;
+    size_t                            channel_count_ = 1;   // slot 0 is the default logger
+
+    // builds the backend for `config`. Files and, unless `fresh`, the flight recorder and the
+    // live tail of `previous` are carried over when their settings did not change.
+    std::unique_ptr<Backend> createBackend(const LoggerConfig& config, const Backend* previous,
+                                           bool fresh);
+    // lazy initialization: the flight recorder and loggers writing to a DeferredSink
+    std::unique_ptr<Backend> createDeferredBackend(const LoggerConfig& config);
+    void                     createChannelLoggers(Backend& backend, int default_level);
+    // hands the records held by `pending` over to `next`, in order
+    static void forwardDeferred(Backend& pending, const Backend& next);
+    // replaces a deferred backend with the one writing the files, on the calling thread
+    void completeBackend();
+    void startLazyBuild();
+    void waitForLazyBuild();
+    bool replaceBackend(const LoggerConfig& config, bool fresh);
+    // publishes `next` (null to stop logging) and returns the backend it replaced once no reader
+    // uses it anymore
+    std::unique_ptr<Backend> swapBackend(std::unique_ptr<Backend> next);
+    // flushes and destroys a retired backend, the thread pool drains what is still queued
+    void releaseBackend(Backend& backend);
+    // releases `backend` on a thread of its own, see drains_
+    void startDrain(std::unique_ptr<Backend> backend);
+    // waits for the drains writing `path` (every drain when empty), false on timeout
+    bool waitForDrains(const std::string& path, std::chrono::milliseconds timeout);
+    // removes the default logger from spdlog's registry
+    void dropLogger();
+    void updateCrashHandler(bool enabled);
+    // a logger on `backend`, used for the default logger and every channel
+    static std::shared_ptr<spdlog::logger> createLogger(const Backend&     backend,
+                                                        const std::string& name, int level);
+    void write(const Backend& backend, spdlog::logger* logger, int channel, int level,
+               const char* message, size_t length, int64_t timestamp_us,
+               const char* payload_tag = nullptr);
+    // false when backend.filter drops the record; writes the summaries it produced either way
+    bool passFilter(const Backend& backend, int channel, int level, const char* payload_tag,
+                    spdlog::string_view_t payload);
+    // reports what backend.filter holds back, see MessageFilter::sweep()
+    void sweepFilter(const Backend& backend, bool all);
+    void writeSummary(const Backend& backend, const MessageFilter::Summary& summary);
+    // `timestamp_us` when given, otherwise now on the backend's clock
+    static spdlog::log_clock::time_point recordTime(const Backend& backend, int64_t timestamp_us);
+    static bool admit(const Backend& backend, spdlog::logger* logger,
+                      spdlog::level::level_enum level);
     void reportError(const char* function_name, const char* error_message) const;
+    // applies the writer_* settings of `config` on the thread it is called on, the thread is
+    // named "<writer_thread_name><suffix>"
+    std::function<void()> writerThreadStart(const LoggerConfig& config, const char* suffix = "");
+
+    static void onCrash();
 
     static spdlog::level::level_enum convertLogLevel(int level);
+    // also maps kLevelOff
+    static spdlog::level::level_enum toSpdlogLevel(int level);
     static int                       convertToInt(spdlog::level::level_enum level);
 };
 
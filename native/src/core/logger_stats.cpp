@@ -0,0 +1,99 @@
+#include "logger_stats.h"
+
+namespace mlogger
+{
+
+namespace
+{
+
+size_t currentStripe(size_t stripe_count)
+{
+    static std::atomic<size_t> next_stripe{0};
+    thread_local size_t        stripe = next_stripe.fetch_add(1, std::memory_order_relaxed);
+    return stripe % stripe_count;
+}
+
+}   // namespace
+
+void LogStats::countMessage(int level)
+{
+    if (level < 0 || level >= static_cast<int>(LoggerStats::kLevels)) {
+        return;
+    }
+    localStripe().messages[static_cast<size_t>(level)].fetch_add(1, std::memory_order_relaxed);
+}
+
+bool LogStats::sampleLatency() const
+{
+    thread_local uint32_t calls = 0;
+    return calls++ % kLatencySampleInterval == 0;
+}
+
+void LogStats::recordLatency(uint64_t ns)
+{
+    localStripe().latency[latencyBucket(ns)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void LogStats::countFiltered(bool rate_limited)
+{
+    Stripe& stripe = localStripe();
+    std::atomic<uint64_t>& count = rate_limited ? stripe.rate_limited : stripe.suppressed;
+    count.fetch_add(1, std::memory_order_relaxed);
+}
+
+void LogStats::reset()
+{
+    for (Stripe& stripe : stripes_) {
+        for (auto& count : stripe.messages) count.store(0, std::memory_order_relaxed);
+        for (auto& count : stripe.latency) count.store(0, std::memory_order_relaxed);
+        stripe.suppressed.store(0, std::memory_order_relaxed);
+        stripe.rate_limited.store(0, std::memory_order_relaxed);
+    }
+    bytes_written_.store(0, std::memory_order_relaxed);
+    rotations_.store(0, std::memory_order_relaxed);
+    flushes_.store(0, std::memory_order_relaxed);
+    shipped_.store(0, std::memory_order_relaxed);
+    unshipped_.store(0, std::memory_order_relaxed);
+}
+
+void LogStats::snapshot(LoggerStats& stats) const
+{
+    stats.messages.fill(0);
+    stats.latency_ns.fill(0);
+    stats.latency_samples = 0;
+    stats.suppressed      = 0;
+    stats.rate_limited    = 0;
+    for (const Stripe& stripe : stripes_) {
+        stats.suppressed += stripe.suppressed.load(std::memory_order_relaxed);
+        stats.rate_limited += stripe.rate_limited.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < LoggerStats::kLevels; ++i) {
+            stats.messages[i] += stripe.messages[i].load(std::memory_order_relaxed);
+        }
+        for (size_t i = 0; i < LoggerStats::kLatencyBuckets; ++i) {
+            uint64_t count = stripe.latency[i].load(std::memory_order_relaxed);
+            stats.latency_ns[i] += count;
+            stats.latency_samples += count;
+        }
+    }
+    stats.bytes_written = bytes_written_.load(std::memory_order_relaxed);
+    stats.rotations     = rotations_.load(std::memory_order_relaxed);
+    stats.flushes       = flushes_.load(std::memory_order_relaxed);
+    stats.shipped       = shipped_.load(std::memory_order_relaxed);
+    stats.unshipped     = unshipped_.load(std::memory_order_relaxed);
+}
+
+size_t LogStats::latencyBucket(uint64_t ns)
+{
+    size_t bucket = 0;
+    while (bucket + 1 < LoggerStats::kLatencyBuckets && ns >= (uint64_t{64} << bucket)) {
+        ++bucket;
+    }
+    return bucket;
+}
+
+LogStats::Stripe& LogStats::localStripe()
+{
+    return stripes_[currentStripe(kStripes)];
+}
+
+}   // namespace mlogger
@@ -0,0 +1,95 @@
+#ifndef LOGGER_STATS_H
+#define LOGGER_STATS_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace mlogger
+{
+
+// Point-in-time copy of the counters, see MLoggerStats in bridge.h for the meaning of each field.
+struct LoggerStats {
+    static constexpr size_t kLevels         = 6;
+    static constexpr size_t kLatencyBuckets = 16;
+
+    std::array<uint64_t, kLevels>         messages{};
+    uint64_t                              bytes_written    = 0;
+    uint64_t                              rotations        = 0;
+    uint64_t                              flushes          = 0;
+    uint64_t                              dropped          = 0;
+    uint64_t                              suppressed       = 0;
+    uint64_t                              rate_limited     = 0;
+    uint64_t                              shipped          = 0;
+    uint64_t                              unshipped        = 0;
+    uint64_t                              queue_depth      = 0;
+    uint64_t                              queue_high_water = 0;
+    uint64_t                              latency_samples  = 0;
+    std::array<uint64_t, kLatencyBuckets> latency_ns{};
+};
+
+// Lock-free counters updated by the logging threads and the sinks. Producers count into one of
+// several cache-line sized stripes picked per thread, so concurrent loggers do not share a line;
+// the sink side counters are only touched under the sink's own lock.
+class LogStats final
+{
+public:
+    // every Nth record of a thread is timed, reading the clock twice per call costs more than
+    // the rest of the bookkeeping
+    static constexpr uint32_t kLatencySampleInterval = 16;
+
+    // producer side
+    void countMessage(int level);
+    bool sampleLatency() const;
+    void recordLatency(uint64_t ns);
+    // a record held back by MessageFilter
+    void countFiltered(bool rate_limited);
+
+    // sink side
+    void addBytesWritten(size_t bytes)
+    {
+        bytes_written_.fetch_add(bytes, std::memory_order_relaxed);
+    }
+    void countRotation() { rotations_.fetch_add(1, std::memory_order_relaxed); }
+    void countFlush() { flushes_.fetch_add(1, std::memory_order_relaxed); }
+    // records NetworkSink sent, and the ones it could not
+    void countShipped(uint64_t records)
+    {
+        shipped_.fetch_add(records, std::memory_order_relaxed);
+    }
+    void countUnshipped(uint64_t records)
+    {
+        unshipped_.fetch_add(records, std::memory_order_relaxed);
+    }
+
+    // zeroes everything, only while no logger is using the counters
+    void reset();
+    // fills the fields owned by this class, the queue and drop fields are left alone
+    void snapshot(LoggerStats& stats) const;
+
+    // bucket i counts samples below 64 << i ns, the last one everything longer
+    static size_t latencyBucket(uint64_t ns);
+
+private:
+    struct alignas(64) Stripe {
+        std::array<std::atomic<uint64_t>, LoggerStats::kLevels>         messages{};
+        std::array<std::atomic<uint64_t>, LoggerStats::kLatencyBuckets> latency{};
+        std::atomic<uint64_t>                                           suppressed{0};
+        std::atomic<uint64_t>                                           rate_limited{0};
+    };
+    static constexpr size_t kStripes = 16;
+
+    Stripe& localStripe();
+
+    std::array<Stripe, kStripes> stripes_;
+    alignas(64) std::atomic<uint64_t> bytes_written_{0};
+    std::atomic<uint64_t>             rotations_{0};
+    std::atomic<uint64_t>             flushes_{0};
+    std::atomic<uint64_t>             shipped_{0};
+    std::atomic<uint64_t>             unshipped_{0};
+};
+
+}   // namespace mlogger
+
+#endif   // LOGGER_STATS_H
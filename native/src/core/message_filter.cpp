@@ -0,0 +1,197 @@
+#include "message_filter.h"
+#include "logger_stats.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace mlogger
+{
+
+namespace
+{
+
+constexpr uint64_t kHashMultiplier = 0x9E3779B97F4A7C15ull;
+// the level critical records have, never rate limited
+constexpr int kCriticalLevel = 5;
+
+uint64_t mix(uint64_t hash, uint64_t word)
+{
+    hash ^= word;
+    hash *= kHashMultiplier;
+    return hash ^ (hash >> 29);
+}
+
+// identity of a record, 8 bytes at a time
+uint64_t recordHash(int channel, int level, const char* payload_tag, spdlog::string_view_t payload)
+{
+    uint64_t hash = mix(0, (static_cast<uint64_t>(channel) << 8) | static_cast<uint8_t>(level));
+    hash          = mix(hash, reinterpret_cast<uintptr_t>(payload_tag));
+    const char* data = payload.data();
+    size_t      size = payload.size();
+    for (; size >= 8; data += 8, size -= 8) {
+        uint64_t word;
+        std::memcpy(&word, data, 8);
+        hash = mix(hash, word);
+    }
+    uint64_t tail = 0;
+    std::memcpy(&tail, data, size);
+    hash = mix(hash, tail ^ (static_cast<uint64_t>(payload.size()) << 56));
+    // zero marks an empty slot
+    return hash ? hash : 1;
+}
+
+}   // namespace
+
+MessageFilter::MessageFilter(size_t channels, int window_ms, uint32_t rate, uint32_t burst)
+    : channels_(channels)
+    , window_ns_(static_cast<int64_t>(window_ms) * 1000000)
+    , interval_ns_(rate > 0 ? 1000000000 / static_cast<int64_t>(rate) : 0)
+    , tolerance_ns_(interval_ns_ * (static_cast<int64_t>(burst > 0 ? burst : rate) - 1))
+{
+    if (window_ns_ > 0) {
+        slots_ = std::make_unique<Slot[]>(kSlots);
+    }
+    if (interval_ns_ > 0) {
+        buckets_ = std::make_unique<Bucket[]>(channels_ * LoggerStats::kLevels);
+    }
+}
+
+MessageFilter::~MessageFilter() = default;
+
+int64_t MessageFilter::now()
+{
+    auto since_start = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(since_start).count();
+}
+
+MessageFilter::Verdict MessageFilter::check(int channel, int level, const char* payload_tag,
+                                            spdlog::string_view_t payload, int64_t now_ns,
+                                            Summaries& summaries)
+{
+    summaries.count = 0;
+    if (level < 0 || level >= static_cast<int>(LoggerStats::kLevels) || channel < 0 ||
+        static_cast<size_t>(channel) >= channels_) {
+        return Verdict::pass;
+    }
+    if (slots_ && checkDuplicate(channel, level, payload_tag, payload, now_ns, summaries)) {
+        return Verdict::repeated;
+    }
+    if (buckets_ && !checkRate(channel, level, now_ns, summaries)) {
+        return Verdict::rate_limited;
+    }
+    return Verdict::pass;
+}
+
+bool MessageFilter::checkDuplicate(int channel, int level, const char* payload_tag,
+                                   spdlog::string_view_t payload, int64_t now_ns,
+                                   Summaries& summaries)
+{
+    uint64_t hash = recordHash(channel, level, payload_tag, payload);
+    Slot&    slot = slots_[hash & (kSlots - 1)];
+    if (slot.busy.exchange(true, std::memory_order_acquire)) {
+        return false;
+    }
+
+    // NOTE: a hash match is taken as a repeat, a collision between two different records within
+    // one window costs the second one its line
+    bool repeated = slot.hash == hash && now_ns < slot.window_end;
+    if (repeated) {
+        ++slot.repeats;
+    } else {
+        // the slot's earlier record, or this one coming back after its window
+        if (slot.repeats > 0) {
+            takeSummary(slot, summaries.items[summaries.count++]);
+        }
+        if (slot.hash != hash) {
+            size_t kept       = std::min(payload.size(), kMaxPreview);
+            slot.hash         = hash;
+            slot.channel      = channel;
+            slot.level        = level;
+            slot.payload_tag  = payload_tag;
+            slot.truncated    = kept < payload.size();
+            slot.payload_size = static_cast<uint32_t>(kept);
+            std::memcpy(slot.payload, payload.data(), kept);
+        }
+        slot.window_end = now_ns + window_ns_;
+    }
+    slot.busy.store(false, std::memory_order_release);
+    return repeated;
+}
+
+bool MessageFilter::checkRate(int channel, int level, int64_t now_ns, Summaries& summaries)
+{
+    if (level >= kCriticalLevel) {
+        return true;
+    }
+
+    Bucket& bucket  = buckets_[static_cast<size_t>(channel) * LoggerStats::kLevels + level];
+    int64_t arrival = bucket.arrival.load(std::memory_order_relaxed);
+    for (;;) {
+        int64_t from = std::max(arrival, now_ns);
+        if (from - now_ns > tolerance_ns_) {
+            bucket.limited.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        if (bucket.arrival.compare_exchange_weak(arrival, from + interval_ns_,
+                                                 std::memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    if (bucket.limited.load(std::memory_order_relaxed) > 0) {
+        uint64_t limited = bucket.limited.exchange(0, std::memory_order_relaxed);
+        if (limited > 0) {
+            Summary& summary     = summaries.items[summaries.count++];
+            summary.channel      = channel;
+            summary.level        = level;
+            summary.count        = limited;
+            summary.rate_limited = true;
+        }
+    }
+    return true;
+}
+
+void MessageFilter::takeSummary(Slot& slot, Summary& summary)
+{
+    summary.channel      = slot.channel;
+    summary.level        = slot.level;
+    summary.count        = slot.repeats;
+    summary.rate_limited = false;
+    summary.payload_tag  = slot.payload_tag;
+    summary.truncated    = slot.truncated;
+    summary.payload_size = slot.payload_size;
+    std::memcpy(summary.payload, slot.payload, slot.payload_size);
+    slot.repeats = 0;
+}
+
+void MessageFilter::sweep(int64_t now_ns, bool all,
+                          const std::function<void(const Summary&)>& emit)
+{
+    Summary summary;
+    for (size_t i = 0; slots_ && i < kSlots; ++i) {
+        Slot& slot = slots_[i];
+        // NOTE: a busy slot is left for the next sweep, unless this is the last one
+        bool busy = slot.busy.exchange(true, std::memory_order_acquire);
+        while (busy && all) {
+            busy = slot.busy.exchange(true, std::memory_order_acquire);
+        }
+        if (busy) continue;
+
+        bool report = slot.repeats > 0 && (all || now_ns >= slot.window_end);
+        if (report) takeSummary(slot, summary);
+        slot.busy.store(false, std::memory_order_release);
+        if (report) emit(summary);
+    }
+
+    for (size_t i = 0; buckets_ && i < channels_ * LoggerStats::kLevels; ++i) {
+        uint64_t limited = buckets_[i].limited.exchange(0, std::memory_order_relaxed);
+        if (limited == 0) continue;
+        summary.channel      = static_cast<int>(i / LoggerStats::kLevels);
+        summary.level        = static_cast<int>(i % LoggerStats::kLevels);
+        summary.count        = limited;
+        summary.rate_limited = true;
+        emit(summary);
+    }
+}
+
+}   // namespace mlogger
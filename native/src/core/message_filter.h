@@ -0,0 +1,109 @@
+#ifndef MESSAGE_FILTER_H
+#define MESSAGE_FILTER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <spdlog/common.h>
+
+namespace mlogger
+{
+
+// Duplicate suppression and rate limiting in front of the sinks, consulted by the logging thread
+// before a record is queued. See LoggerConfig::dedup_window_ms and rate_limit.
+//
+// Duplicates: records are hashed (channel, level, payload) into a fixed table. A repeat within
+// the window that started with the last written copy is counted instead of written; the count is
+// reported once the slot is reused, the record comes back after the window or sweep() finds the
+// window over, so a record repeated forever still gets one line per window.
+// A slot another thread holds lets the record through, so producers never wait.
+//
+// Rate limits: a token bucket per channel and level (GCRA, one atomic per bucket), critical
+// records are never limited. Records over the limit are counted and reported with the next
+// record of the bucket that passes, or by sweep().
+class MessageFilter final
+{
+public:
+    static constexpr size_t kSlots      = 1024;
+    static constexpr size_t kMaxPreview = 160;   // payload bytes kept to describe repeats
+
+    enum class Verdict
+    {
+        pass,
+        repeated,       // a duplicate within the window
+        rate_limited,   // over the bucket's limit
+    };
+
+    // a record to write in place of the ones filtered out
+    struct Summary {
+        int         channel      = 0;
+        int         level        = 0;
+        uint64_t    count        = 0;
+        bool        rate_limited = false;   // false = repeats of `payload`
+        const char* payload_tag  = nullptr;
+        bool        truncated    = false;   // `payload` holds only the start of the record
+        uint32_t    payload_size = 0;
+        char        payload[kMaxPreview];
+    };
+
+    // what to write before the record being checked, even when it is filtered out itself
+    struct Summaries {
+        size_t  count = 0;
+        Summary items[2];
+    };
+
+    // `window_ms` 0 disables duplicate suppression, `rate` (records per second) 0 rate limits;
+    // `burst` records may pass at once, 0 = `rate`
+    MessageFilter(size_t channels, int window_ms, uint32_t rate, uint32_t burst);
+    ~MessageFilter();
+
+    Verdict check(int channel, int level, const char* payload_tag, spdlog::string_view_t payload,
+                  int64_t now_ns, Summaries& summaries);
+
+    // reports windows that ended before `now_ns` and buckets that limited records, everything
+    // pending when `all`
+    void sweep(int64_t now_ns, bool all, const std::function<void(const Summary&)>& emit);
+
+    // steady clock, the time base of check() and sweep()
+    static int64_t now();
+
+    MessageFilter(const MessageFilter&)            = delete;
+    MessageFilter& operator=(const MessageFilter&) = delete;
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<bool> busy{false};
+        uint64_t          hash         = 0;   // 0 = empty
+        int64_t           window_end   = 0;
+        uint64_t          repeats      = 0;
+        int               channel      = 0;
+        int               level        = 0;
+        const char*       payload_tag  = nullptr;
+        bool              truncated    = false;
+        uint32_t          payload_size = 0;
+        char              payload[kMaxPreview];
+    };
+
+    struct Bucket {
+        std::atomic<int64_t>  arrival{0};   // theoretical arrival time of the next record
+        std::atomic<uint64_t> limited{0};
+    };
+
+    bool checkDuplicate(int channel, int level, const char* payload_tag,
+                        spdlog::string_view_t payload, int64_t now_ns, Summaries& summaries);
+    bool checkRate(int channel, int level, int64_t now_ns, Summaries& summaries);
+    static void takeSummary(Slot& slot, Summary& summary);
+
+    size_t                    channels_;
+    int64_t                   window_ns_;
+    int64_t                   interval_ns_;    // between records at the limit, 0 = none
+    int64_t                   tolerance_ns_;   // how far ahead of now the bucket may run
+    std::unique_ptr<Slot[]>   slots_;
+    std::unique_ptr<Bucket[]> buckets_;   // channel * kLevels + level
+};
+
+}   // namespace mlogger
+
+#endif   // MESSAGE_FILTER_H
@@ -0,0 +1,434 @@
+#include "staging_logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <spdlog/sinks/sink.h>
+#include <string>
+
+namespace mlogger
+{
+
+namespace
+{
+
+constexpr int  kSpinsBeforeSleep = 64;
+constexpr auto kIdleWait         = std::chrono::milliseconds(5);
+
+std::atomic<uint64_t> next_backend_id{1};
+
+}   // namespace
+
+// fixed part of every ring block, the payload follows unless it lives in the producer's arena
+struct StagingBackend::Record {
+    StagingLogger*                logger;
+    spdlog::log_clock::time_point time;
+    size_t                        thread_id;
+    char*                         arena_payload;
+    SlabArena::Slab*              slab;
+    const char*                   source_function;   // tags structured and formatted payloads
+    uint32_t                      payload_size;
+    int32_t                       level;
+};
+
+StagingBackend::StagingBackend(size_t ring_size, OverflowPolicy overflow_policy,
+                               ErrorHandler error_handler, std::function<void()> on_thread_start)
+    : id_(next_backend_id.fetch_add(1, std::memory_order_relaxed))
+    , ring_size_(ring_size)
+    , overflow_policy_(overflow_policy)
+    , error_handler_(std::move(error_handler))
+{
+    worker_ = std::thread([this, on_thread_start = std::move(on_thread_start)]() {
+        if (on_thread_start) on_thread_start();
+        workerLoop();
+    });
+}
+
+StagingBackend::~StagingBackend()
+{
+    stop_.store(true, std::memory_order_release);
+    wake();
+    if (worker_.joinable()) worker_.join();
+
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    for (auto& ring : rings_) {
+        ring->closed.store(true, std::memory_order_release);
+    }
+}
+
+void StagingBackend::enqueue(StagingLogger* logger, const spdlog::details::log_msg& msg)
+{
+    ProducerRing& producer = localRing();
+    SpscRing&     ring     = producer.ring;
+
+    Record record{};
+    record.logger          = logger;
+    record.time            = msg.time;
+    record.thread_id       = msg.thread_id;
+    record.source_function = msg.source.funcname;
+    record.payload_size    = static_cast<uint32_t>(msg.payload.size());
+    record.level           = static_cast<int32_t>(msg.level);
+
+    // NOTE: oversized payloads are copied to the arena, the ring only carries the pointer
+    bool   inline_payload = sizeof(Record) + msg.payload.size() <= ring.maxBlockSize();
+    size_t block_size     = sizeof(Record) + (inline_payload ? msg.payload.size() : 0);
+
+    void* block = ring.tryReserve(block_size);
+    if (block == nullptr && overflow_policy_ != OverflowPolicy::block) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        wake();
+        return;
+    }
+    while (block == nullptr) {
+        wake();
+        std::this_thread::yield();
+        block = ring.tryReserve(block_size);
+    }
+
+    auto* bytes = static_cast<unsigned char*>(block);
+    if (inline_payload) {
+        std::memcpy(bytes + sizeof(Record), msg.payload.data(), msg.payload.size());
+    } else {
+        record.arena_payload = producer.arena.allocate(msg.payload.size(), record.slab);
+        std::memcpy(record.arena_payload, msg.payload.data(), msg.payload.size());
+    }
+    std::memcpy(bytes, &record, sizeof(Record));
+    ring.commit();
+    producer.pushed.store(producer.pushed.load(std::memory_order_relaxed) + 1,
+                          std::memory_order_relaxed);
+
+    if (sleeping_.load(std::memory_order_relaxed)) wake();
+}
+
+void StagingBackend::flush()
+{
+    if (std::this_thread::get_id() == worker_.get_id()) {
+        flushSinks();
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(flush_mutex_);
+    uint64_t                     ticket = flush_requested_.fetch_add(1) + 1;
+    lock.unlock();
+    wake();
+    lock.lock();
+    flush_cv_.wait(lock, [&]() { return flush_completed_.load() >= ticket; });
+}
+
+void StagingBackend::attach(StagingLogger* logger)
+{
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    loggers_.push_back(logger);
+}
+
+void StagingBackend::detach(StagingLogger* logger)
+{
+    // drain every record that still points at this logger
+    flush();
+
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    loggers_.erase(std::remove(loggers_.begin(), loggers_.end(), logger), loggers_.end());
+}
+
+uint64_t StagingBackend::queueDepth()
+{
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    uint64_t                    depth = 0;
+    for (const auto& ring : rings_) {
+        // NOTE: popped first, a record drained in between is then counted rather than wrapping
+        uint64_t popped = ring->popped.load(std::memory_order_relaxed);
+        depth += ring->pushed.load(std::memory_order_relaxed) - popped;
+    }
+    return depth;
+}
+
+uint64_t StagingBackend::queueHighWater()
+{
+    return std::max(high_water_.load(std::memory_order_relaxed), queueDepth());
+}
+
+StagingBackend::ProducerRing& StagingBackend::localRing()
+{
+    struct LocalRings {
+        std::vector<std::pair<uint64_t, std::shared_ptr<ProducerRing>>> entries;
+
+        ~LocalRings()
+        {
+            for (auto& entry : entries) {
+                entry.second->detached.store(true, std::memory_order_release);
+            }
+        }
+    };
+    thread_local LocalRings local;
+
+    for (auto& entry : local.entries) {
+        if (entry.first == id_) return *entry.second;
+    }
+
+    // first message from this thread: forget rings of destroyed backends, register a new one
+    local.entries.erase(std::remove_if(local.entries.begin(),
+                                       local.entries.end(),
+                                       [](const auto& entry) {
+                                           return entry.second->closed.load(
+                                               std::memory_order_acquire);
+                                       }),
+                        local.entries.end());
+
+    auto ring = std::make_shared<ProducerRing>(ring_size_);
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex_);
+        rings_.push_back(ring);
+        registry_version_.fetch_add(1, std::memory_order_release);
+    }
+    local.entries.emplace_back(id_, ring);
+    return *ring;
+}
+
+void StagingBackend::wake()
+{
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+    }
+    wake_cv_.notify_one();
+}
+
+void StagingBackend::workerLoop()
+{
+    int idle_spins = 0;
+    for (;;) {
+        size_t drained = drain();
+
+        uint64_t requested = flush_requested_.load(std::memory_order_acquire);
+        if (requested != flush_completed_.load(std::memory_order_relaxed)) {
+            drain();
+            flushSinks();
+            {
+                std::lock_guard<std::mutex> lock(flush_mutex_);
+                flush_completed_.store(requested, std::memory_order_release);
+            }
+            flush_cv_.notify_all();
+            continue;
+        }
+
+        if (drained > 0) {
+            idle_spins = 0;
+            continue;
+        }
+        if (stop_.load(std::memory_order_acquire)) {
+            if (drain() == 0) break;
+            continue;
+        }
+        if (++idle_spins < kSpinsBeforeSleep) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        pruneDetachedRings();
+
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        sleeping_.store(true);
+        wake_cv_.wait_for(lock, kIdleWait, [this]() {
+            return stop_.load() || flush_requested_.load() != flush_completed_.load() ||
+                   hasPending();
+        });
+        sleeping_.store(false);
+        idle_spins = 0;
+    }
+
+    flushSinks();
+}
+
+size_t StagingBackend::drain()
+{
+    if (registry_version_.load(std::memory_order_acquire) != drain_version_) {
+        std::lock_guard<std::mutex> lock(registry_mutex_);
+        drain_rings_   = rings_;
+        drain_version_ = registry_version_.load(std::memory_order_relaxed);
+    }
+
+    const size_t ring_count = drain_rings_.size();
+    head_blocks_.assign(ring_count, nullptr);
+    head_records_.resize(ring_count);
+
+    // the backlog found at the start of a pass is what producers queued while we were away
+    uint64_t depth = 0;
+    for (size_t i = 0; i < ring_count; ++i) {
+        peekHead(i);
+        const ProducerRing& ring = *drain_rings_[i];
+        depth += ring.pushed.load(std::memory_order_relaxed) -
+                 ring.popped.load(std::memory_order_relaxed);
+    }
+    if (depth > high_water_.load(std::memory_order_relaxed)) {
+        high_water_.store(depth, std::memory_order_relaxed);
+    }
+
+    size_t drained = 0;
+    for (;;) {
+        // merge by timestamp: always write the oldest head next
+        size_t best = ring_count;
+        for (size_t i = 0; i < ring_count; ++i) {
+            if (head_blocks_[i] == nullptr) continue;
+            if (best == ring_count || head_records_[i].time < head_records_[best].time) best = i;
+        }
+        if (best == ring_count) break;
+
+        const Record& record  = head_records_[best];
+        const char*   payload = record.arena_payload
+                                    ? record.arena_payload
+                                    : reinterpret_cast<const char*>(head_blocks_[best]) +
+                                          sizeof(Record);
+        try {
+            spdlog::details::log_msg msg(record.time,
+                                         spdlog::source_loc{nullptr, 0, record.source_function},
+                                         record.logger->name(),
+                                         static_cast<spdlog::level::level_enum>(record.level),
+                                         spdlog::string_view_t(payload, record.payload_size));
+            msg.thread_id = record.thread_id;
+            record.logger->drainRecord(msg);
+        } catch (const std::exception& e) {
+            reportError(e.what());
+        } catch (...) {
+            reportError("Unknown exception occurred while draining staging ring");
+        }
+
+        if (record.slab) SlabArena::release(record.slab);
+        ProducerRing& drained_ring = *drain_rings_[best];
+        drained_ring.ring.pop();
+        drained_ring.popped.store(drained_ring.popped.load(std::memory_order_relaxed) + 1,
+                                  std::memory_order_relaxed);
+        peekHead(best);
+        ++drained;
+    }
+
+    if (dropped_.load(std::memory_order_relaxed) != reported_) {
+        reportDrops();
+    }
+
+    return drained;
+}
+
+void StagingBackend::peekHead(size_t index)
+{
+    const void* block    = drain_rings_[index]->ring.front();
+    head_blocks_[index] = static_cast<const unsigned char*>(block);
+    if (block) std::memcpy(&head_records_[index], block, sizeof(Record));
+}
+
+bool StagingBackend::hasPending() const
+{
+    if (registry_version_.load(std::memory_order_acquire) != drain_version_) return true;
+    for (const auto& ring : drain_rings_) {
+        if (!ring->ring.empty()) return true;
+    }
+    return false;
+}
+
+void StagingBackend::pruneDetachedRings()
+{
+    bool has_detached = std::any_of(drain_rings_.begin(), drain_rings_.end(), [](const auto& ring) {
+        return ring->detached.load(std::memory_order_acquire) && ring->ring.empty();
+    });
+    if (!has_detached) return;
+
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    rings_.erase(std::remove_if(rings_.begin(),
+                                rings_.end(),
+                                [](const auto& ring) {
+                                    return ring->detached.load(std::memory_order_acquire) &&
+                                           ring->ring.empty();
+                                }),
+                 rings_.end());
+    registry_version_.fetch_add(1, std::memory_order_release);
+}
+
+void StagingBackend::reportDrops()
+{
+    // every ring was just drained, so the backlog that caused the drops is gone
+    uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+    uint64_t count   = dropped - reported_;
+    reported_        = dropped;
+
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    if (loggers_.empty()) {
+        return;
+    }
+
+    try {
+        StagingLogger*           logger = loggers_.front();
+        std::string              text   = std::to_string(count) + " messages dropped";
+        spdlog::details::log_msg msg(logger->name(), spdlog::level::warn, text);
+        logger->drainRecord(msg);
+    } catch (const std::exception& e) {
+        reportError(e.what());
+    } catch (...) {
+        reportError("Unknown exception occurred while reporting dropped records");
+    }
+}
+
+void StagingBackend::flushSinks()
+{
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    for (StagingLogger* logger : loggers_) {
+        try {
+            logger->flushSinks();
+        } catch (const std::exception& e) {
+            reportError(e.what());
+        } catch (...) {
+            reportError("Unknown exception occurred while flushing staging sinks");
+        }
+    }
+}
+
+void StagingBackend::reportError(const char* message) const
+{
+    if (error_handler_) {
+        error_handler_(message);
+    } else {
+        std::cerr << "[MLogger Error in staging] " << message << std::endl;
+    }
+}
+
+StagingLogger::StagingLogger(std::string name, const std::vector<spdlog::sink_ptr>& sinks,
+                             std::shared_ptr<StagingBackend> backend)
+    : spdlog::logger(std::move(name), sinks.begin(), sinks.end())
+    , backend_(std::move(backend))
+{
+    backend_->attach(this);
+}
+
+StagingLogger::~StagingLogger()
+{
+    backend_->detach(this);
+}
+
+void StagingLogger::drainRecord(const spdlog::details::log_msg& msg)
+{
+    for (auto& sink : sinks_) {
+        if (sink->should_log(msg.level)) {
+            sink->log(msg);
+        }
+    }
+
+    if (should_flush_(msg)) {
+        flushSinks();
+    }
+}
+
+void StagingLogger::flushSinks()
+{
+    for (auto& sink : sinks_) {
+        sink->flush();
+    }
+}
+
+void StagingLogger::sink_it_(const spdlog::details::log_msg& msg)
+{
+    backend_->enqueue(this, msg);
+}
+
+void StagingLogger::flush_()
+{
+    backend_->flush();
+}
+
+}   // namespace mlogger
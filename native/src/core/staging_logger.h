@@ -0,0 +1,136 @@
+#ifndef STAGING_LOGGER_H
+#define STAGING_LOGGER_H
+
+#include "core/logger_config.h"
+#include "utils/slab_arena.h"
+#include "utils/spsc_ring.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <spdlog/logger.h>
+#include <thread>
+#include <vector>
+
+namespace mlogger
+{
+
+class StagingLogger;
+
+// Async backend where every producing thread owns a private SPSC ring (created lazily on its
+// first message) and a single drain thread merges all rings by timestamp into the sinks.
+class StagingBackend final
+{
+public:
+    using ErrorHandler = std::function<void(const char*)>;
+
+    // NOTE: a producer cannot reclaim blocks of its own ring, overrun_oldest drops the newest
+    // `on_thread_start` runs first on the worker thread
+    StagingBackend(size_t ring_size, OverflowPolicy overflow_policy,
+                   ErrorHandler          error_handler   = nullptr,
+                   std::function<void()> on_thread_start = nullptr);
+    ~StagingBackend();
+
+    // producer side, called from StagingLogger::sink_it_
+    void enqueue(StagingLogger* logger, const spdlog::details::log_msg& msg);
+    // blocks until everything enqueued before the call reached the sinks, then flushes them
+    void flush();
+
+    void attach(StagingLogger* logger);
+    void detach(StagingLogger* logger);
+
+    // records discarded because their ring was full
+    uint64_t droppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+    // records enqueued but not yet drained, and the most the drain thread found at once
+    uint64_t queueDepth();
+    uint64_t queueHighWater();
+
+    StagingBackend(const StagingBackend&)            = delete;
+    StagingBackend& operator=(const StagingBackend&) = delete;
+
+private:
+    struct Record;
+
+    struct ProducerRing {
+        explicit ProducerRing(size_t capacity)
+            : ring(capacity)
+        {
+        }
+
+        SpscRing              ring;
+        SlabArena             arena;             // payloads too large for the ring
+        std::atomic<uint64_t> pushed{0};         // producer owned
+        std::atomic<uint64_t> popped{0};         // consumer owned
+        std::atomic<bool>     detached{false};   // owning thread exited
+        std::atomic<bool>     closed{false};     // backend destroyed
+    };
+
+    ProducerRing& localRing();
+    void      wake();
+    void      workerLoop();
+    size_t    drain();
+    void      peekHead(size_t index);
+    bool      hasPending() const;
+    void      pruneDetachedRings();
+    void      reportDrops();
+    void      flushSinks();
+    void      reportError(const char* message) const;
+
+    const uint64_t       id_;
+    const size_t         ring_size_;
+    const OverflowPolicy overflow_policy_;
+    ErrorHandler         error_handler_;
+
+    std::atomic<uint64_t> dropped_{0};
+    uint64_t              reported_ = 0;   // consumer owned
+    std::atomic<uint64_t> high_water_{0};
+
+    std::mutex                                 registry_mutex_;
+    std::vector<std::shared_ptr<ProducerRing>> rings_;
+    std::vector<StagingLogger*>                loggers_;
+    std::atomic<uint64_t>                      registry_version_{0};
+
+    // consumer owned snapshot of rings_
+    std::vector<std::shared_ptr<ProducerRing>> drain_rings_;
+    uint64_t                                   drain_version_ = ~0ull;
+    std::vector<const unsigned char*>          head_blocks_;
+    std::vector<Record>                        head_records_;
+
+    std::atomic<bool>       stop_{false};
+    std::atomic<bool>       sleeping_{false};
+    std::mutex              wake_mutex_;
+    std::condition_variable wake_cv_;
+
+    std::atomic<uint64_t>   flush_requested_{0};
+    std::atomic<uint64_t>   flush_completed_{0};
+    std::mutex              flush_mutex_;
+    std::condition_variable flush_cv_;
+
+    std::thread worker_;
+};
+
+// spdlog logger front-end for StagingBackend, the counterpart of spdlog::async_logger
+class StagingLogger final : public spdlog::logger
+{
+public:
+    StagingLogger(std::string name, const std::vector<spdlog::sink_ptr>& sinks,
+                  std::shared_ptr<StagingBackend> backend);
+    ~StagingLogger() override;
+
+    // consumer side, writes one drained record to the sinks
+    void drainRecord(const spdlog::details::log_msg& msg);
+    void flushSinks();
+
+protected:
+    void sink_it_(const spdlog::details::log_msg& msg) override;
+    void flush_() override;
+
+private:
+    std::shared_ptr<StagingBackend> backend_;
+};
+
+}   // namespace mlogger
+
+#endif   // STAGING_LOGGER_H
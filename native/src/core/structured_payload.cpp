@@ -0,0 +1,198 @@
+#include "structured_payload.h"
+#include <cstring>
+#include <iterator>
+#include <spdlog/details/fmt_helper.h>
+
+namespace mlogger
+{
+
+const char kStructuredTag[] = "mlogger.structured";
+
+namespace
+{
+
+constexpr size_t kMaxKeySize = 0xFFFF;
+
+bool needsQuotes(spdlog::string_view_t text)
+{
+    if (text.size() == 0) return true;
+    for (char c : text) {
+        if (c == ' ' || c == '"' || c == '=' || static_cast<unsigned char>(c) < 0x20) return true;
+    }
+    return false;
+}
+
+void appendQuoted(spdlog::string_view_t text, spdlog::memory_buf_t& dest)
+{
+    dest.push_back('"');
+    for (char c : text) {
+        switch (c) {
+        case '"': dest.append(spdlog::string_view_t("\\\"")); break;
+        case '\\': dest.append(spdlog::string_view_t("\\\\")); break;
+        case '\n': dest.append(spdlog::string_view_t("\\n")); break;
+        case '\r': dest.append(spdlog::string_view_t("\\r")); break;
+        case '\t': dest.append(spdlog::string_view_t("\\t")); break;
+        default: dest.push_back(c); break;
+        }
+    }
+    dest.push_back('"');
+}
+
+}   // namespace
+
+void StructuredPayloadWriter::begin(const char* message, size_t length)
+{
+    uint32_t size = static_cast<uint32_t>(length);
+    buffer_.clear();
+    append(&size, sizeof(size));
+    append(message, size);
+}
+
+void StructuredPayloadWriter::addInt(const char* key, size_t key_length, int64_t value)
+{
+    addKey(FieldType::int64, key, key_length);
+    append(&value, sizeof(value));
+}
+
+void StructuredPayloadWriter::addDouble(const char* key, size_t key_length, double value)
+{
+    addKey(FieldType::float64, key, key_length);
+    append(&value, sizeof(value));
+}
+
+void StructuredPayloadWriter::addFloat(const char* key, size_t key_length, float value)
+{
+    addKey(FieldType::float32, key, key_length);
+    append(&value, sizeof(value));
+}
+
+void StructuredPayloadWriter::addBool(const char* key, size_t key_length, bool value)
+{
+    addKey(FieldType::boolean, key, key_length);
+    buffer_.push_back(value ? 1 : 0);
+}
+
+void StructuredPayloadWriter::addString(const char* key, size_t key_length, const char* value,
+                                        size_t length)
+{
+    uint32_t size = static_cast<uint32_t>(length);
+    addKey(FieldType::string, key, key_length);
+    append(&size, sizeof(size));
+    append(value, size);
+}
+
+void StructuredPayloadWriter::addKey(FieldType type, const char* key, size_t key_length)
+{
+    uint16_t size = static_cast<uint16_t>(key_length < kMaxKeySize ? key_length : kMaxKeySize);
+    buffer_.push_back(static_cast<char>(type));
+    append(&size, sizeof(size));
+    append(key, size);
+}
+
+void StructuredPayloadWriter::append(const void* data, size_t size)
+{
+    const char* bytes = static_cast<const char*>(data);
+    buffer_.append(bytes, bytes + size);
+}
+
+StructuredPayloadReader::StructuredPayloadReader(spdlog::string_view_t payload)
+    : position_(payload.data())
+    , end_(payload.data() + payload.size())
+{
+    uint32_t size = 0;
+    if (!read(&size, sizeof(size))) {
+        return;
+    }
+    size_t available = static_cast<size_t>(end_ - position_);
+    size_t length    = size < available ? size : available;
+    message_         = spdlog::string_view_t(position_, length);
+    position_ += length;
+}
+
+bool StructuredPayloadReader::next(StructuredField& field)
+{
+    uint8_t  type     = 0;
+    uint16_t key_size = 0;
+    if (!read(&type, sizeof(type)) || !read(&key_size, sizeof(key_size))) {
+        return false;
+    }
+    if (static_cast<size_t>(end_ - position_) < key_size) {
+        position_ = end_;
+        return false;
+    }
+    field.key = spdlog::string_view_t(position_, key_size);
+    position_ += key_size;
+    field.type = static_cast<FieldType>(type);
+
+    switch (field.type) {
+    case FieldType::int64: return read(&field.int_value, sizeof(field.int_value));
+    case FieldType::float64: return read(&field.double_value, sizeof(field.double_value));
+    case FieldType::float32: return read(&field.float_value, sizeof(field.float_value));
+    case FieldType::boolean: {
+        uint8_t value = 0;
+        if (!read(&value, sizeof(value))) return false;
+        field.bool_value = value != 0;
+        return true;
+    }
+    case FieldType::string: {
+        uint32_t size = 0;
+        if (!read(&size, sizeof(size)) || static_cast<size_t>(end_ - position_) < size) {
+            position_ = end_;
+            return false;
+        }
+        field.string_value = spdlog::string_view_t(position_, size);
+        position_ += size;
+        return true;
+    }
+    }
+
+    position_ = end_;
+    return false;
+}
+
+bool StructuredPayloadReader::read(void* dest, size_t size)
+{
+    if (static_cast<size_t>(end_ - position_) < size) {
+        position_ = end_;
+        return false;
+    }
+    std::memcpy(dest, position_, size);
+    position_ += size;
+    return true;
+}
+
+void appendStructuredText(spdlog::string_view_t payload, spdlog::memory_buf_t& dest)
+{
+    StructuredPayloadReader reader(payload);
+    StructuredField         field;
+    dest.append(reader.message());
+
+    while (reader.next(field)) {
+        dest.push_back(' ');
+        dest.append(field.key);
+        dest.push_back('=');
+        switch (field.type) {
+        case FieldType::int64:
+            spdlog::details::fmt_helper::append_int(field.int_value, dest);
+            break;
+        case FieldType::float64:
+            spdlog::fmt_lib::format_to(std::back_inserter(dest), "{}", field.double_value);
+            break;
+        case FieldType::float32:
+            spdlog::fmt_lib::format_to(std::back_inserter(dest), "{}", field.float_value);
+            break;
+        case FieldType::boolean:
+            dest.append(spdlog::string_view_t(field.bool_value ? "true" : "false"));
+            break;
+        case FieldType::string:
+            if (needsQuotes(field.string_value)) {
+                appendQuoted(field.string_value, dest);
+            } else {
+                dest.append(field.string_value);
+            }
+            break;
+        }
+    }
+}
+
+}   // namespace mlogger
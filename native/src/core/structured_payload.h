@@ -0,0 +1,91 @@
+#ifndef STRUCTURED_PAYLOAD_H
+#define STRUCTURED_PAYLOAD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <spdlog/details/log_msg.h>
+
+namespace mlogger
+{
+
+enum class FieldType : uint8_t
+{
+    int64   = 0,
+    float64 = 1,
+    boolean = 2,
+    string  = 3,
+    float32 = 4,
+};
+
+// Payload of a structured record: the message followed by typed key/value fields, packed by the
+// logging thread so nothing is formatted before the record reaches a sink. Native byte order:
+//
+//   u32 message size, message bytes, then per field:
+//   u8 type, u16 key size, key bytes, value (i64 / f64: 8 bytes, f32: 4 bytes, bool: 1 byte,
+//   string: u32 size + bytes)
+//
+// Records carrying such a payload have source.funcname == kStructuredTag (compared by address,
+// source.line stays 0 so patterns print no source location).
+extern const char kStructuredTag[];
+
+inline bool isStructured(const spdlog::details::log_msg& msg)
+{
+    return msg.source.funcname == kStructuredTag;
+}
+
+// Packs one payload into a buffer that is reused by the next begin().
+class StructuredPayloadWriter final
+{
+public:
+    void begin(const char* message, size_t length);
+    // keys longer than 65535 bytes are cut
+    void addInt(const char* key, size_t key_length, int64_t value);
+    void addDouble(const char* key, size_t key_length, double value);
+    void addFloat(const char* key, size_t key_length, float value);
+    void addBool(const char* key, size_t key_length, bool value);
+    void addString(const char* key, size_t key_length, const char* value, size_t length);
+
+    spdlog::string_view_t view() const { return {buffer_.data(), buffer_.size()}; }
+
+private:
+    void addKey(FieldType type, const char* key, size_t key_length);
+    void append(const void* data, size_t size);
+
+    spdlog::memory_buf_t buffer_;
+};
+
+struct StructuredField {
+    spdlog::string_view_t key;
+    FieldType             type         = FieldType::int64;
+    int64_t               int_value    = 0;
+    double                double_value = 0.0;
+    float                 float_value  = 0.0f;
+    bool                  bool_value   = false;
+    spdlog::string_view_t string_value;
+};
+
+// Reads a packed payload front to back, never past its end.
+class StructuredPayloadReader final
+{
+public:
+    explicit StructuredPayloadReader(spdlog::string_view_t payload);
+
+    spdlog::string_view_t message() const { return message_; }
+    // false after the last field and on truncated data
+    bool next(StructuredField& field);
+
+private:
+    bool read(void* dest, size_t size);
+
+    const char*           position_;
+    const char*           end_;
+    spdlog::string_view_t message_;
+};
+
+// The message followed by " key=value" for every field (logfmt). Strings are quoted when empty or
+// when they contain spaces, quotes, '=' or control characters.
+void appendStructuredText(spdlog::string_view_t payload, spdlog::memory_buf_t& dest);
+
+}   // namespace mlogger
+
+#endif   // STRUCTURED_PAYLOAD_H
@@ -0,0 +1,131 @@
+#include "binary_file_sink.h"
+#include "binary_format.h"
+#include "core/deferred_format.h"
+#include <cstring>
+#include <chrono>
+
+namespace mlogger
+{
+
+namespace
+{
+
+void appendBytes(spdlog::memory_buf_t& dest, const void* data, size_t size)
+{
+    const char* bytes = static_cast<const char*>(data);
+    dest.append(bytes, bytes + size);
+}
+
+void appendVarint(spdlog::memory_buf_t& dest, uint64_t value)
+{
+    while (value >= 0x80) {
+        dest.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    dest.push_back(static_cast<char>(value));
+}
+
+uint64_t zigzagEncode(int64_t value)
+{
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+// a string reference as described in binary_format.h, `text` is written inline when not interned
+void appendRef(spdlog::memory_buf_t& dest, uint64_t ref, spdlog::string_view_t text)
+{
+    appendVarint(dest, ref);
+    if (ref == 0) {
+        appendVarint(dest, text.size());
+        appendBytes(dest, text.data(), text.size());
+    }
+}
+
+int64_t toNanoseconds(spdlog::log_clock::time_point time)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+}   // namespace
+
+BinaryFileSink::BinaryFileSink(spdlog::filename_t base_filename, size_t max_size,
+                               size_t max_files, std::unique_ptr<LogFile> file)
+    : RotatingFileSink(std::move(base_filename), max_size, max_files, std::move(file))
+{
+}
+
+void BinaryFileSink::encode(const spdlog::details::log_msg& msg, spdlog::memory_buf_t& dest)
+{
+    // NOTE: formatted records keep the format as their text and the encoded arguments next to it,
+    // so repeats of one format share a string; structured records are stored as their logfmt text
+    spdlog::string_view_t payload;
+    spdlog::string_view_t arguments;
+    uint32_t              format_id = 0;
+    if (isFormatted(msg) && msg.payload.size() > sizeof(format_id)) {
+        std::memcpy(&format_id, msg.payload.data(), sizeof(format_id));
+        payload   = FormatRegistry::getInstance().get(format_id);
+        arguments = spdlog::string_view_t(msg.payload.data() + sizeof(format_id),
+                                          msg.payload.size() - sizeof(format_id));
+    } else {
+        // an empty argument list marks final text, so formats without arguments are rendered
+        payload = payloadText(msg);
+    }
+    // every entry names its channel, records of several loggers can share one file
+    int64_t  time_ns  = toNanoseconds(msg.time);
+    uint64_t name_ref = intern(msg.logger_name, dest);
+    uint64_t text_ref = intern(payload, dest);
+
+    dest.push_back(static_cast<char>(binary_format::kEntry));
+    appendVarint(dest, zigzagEncode(time_ns - last_time_ns_));
+    dest.push_back(static_cast<char>(msg.level));
+    appendVarint(dest, msg.thread_id);
+    appendRef(dest, name_ref, msg.logger_name);
+    appendRef(dest, text_ref, payload);
+    appendVarint(dest, arguments.size());
+    appendBytes(dest, arguments.data(), arguments.size());
+
+    last_time_ns_ = time_ns;
+}
+
+void BinaryFileSink::beginFile(const spdlog::details::log_msg& first, bool fresh_file,
+                               spdlog::memory_buf_t& dest)
+{
+    if (fresh_file) {
+        appendBytes(dest, binary_format::kMagic.data(), binary_format::kMagic.size());
+        appendBytes(dest, &binary_format::kVersion, sizeof(binary_format::kVersion));
+    }
+
+    // a new session resets both the string table and the time base of the reader
+    strings_.clear();
+    last_time_ns_ = toNanoseconds(first.time);
+
+    dest.push_back(static_cast<char>(binary_format::kSession));
+    appendBytes(dest, &last_time_ns_, sizeof(last_time_ns_));
+}
+
+uint64_t BinaryFileSink::intern(spdlog::string_view_t text, spdlog::memory_buf_t& dest)
+{
+    // NOTE: only short texts are interned, long ones are rarely repeated verbatim
+    if (text.size() > kMaxInternedSize) {
+        return 0;
+    }
+
+    std::string key(text.data(), text.size());
+    auto        found = strings_.find(key);
+    if (found != strings_.end()) {
+        return found->second + 1;
+    }
+    if (strings_.size() >= kMaxInternedStrings) {
+        return 0;
+    }
+
+    uint32_t id = static_cast<uint32_t>(strings_.size());
+    dest.push_back(static_cast<char>(binary_format::kDefine));
+    appendVarint(dest, id);
+    appendVarint(dest, key.size());
+    appendBytes(dest, key.data(), key.size());
+
+    strings_.emplace(std::move(key), id);
+    return id + 1;
+}
+
+}   // namespace mlogger
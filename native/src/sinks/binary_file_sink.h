@@ -0,0 +1,39 @@
+#ifndef BINARY_FILE_SINK_H
+#define BINARY_FILE_SINK_H
+
+#include "rotating_file_sink.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace mlogger
+{
+
+// Rotating sink writing the compact format described in binary_format.h. Nothing is formatted
+// here, repeated texts are written once per file and referenced by id afterwards.
+// Decode with the mlogger_decode tool or BinaryLogReader.
+class BinaryFileSink final : public RotatingFileSink
+{
+public:
+    BinaryFileSink(spdlog::filename_t base_filename, size_t max_size, size_t max_files,
+                   std::unique_ptr<LogFile> file = nullptr);
+
+protected:
+    void encode(const spdlog::details::log_msg& msg, spdlog::memory_buf_t& dest) override;
+    void beginFile(const spdlog::details::log_msg& first, bool fresh_file,
+                   spdlog::memory_buf_t& dest) override;
+
+private:
+    // string reference for `text`, defining it in `dest` first when it is new; 0 = not interned
+    uint64_t intern(spdlog::string_view_t text, spdlog::memory_buf_t& dest);
+
+    static constexpr size_t kMaxInternedStrings = 4096;
+    static constexpr size_t kMaxInternedSize    = 256;
+
+    std::unordered_map<std::string, uint32_t> strings_;
+    int64_t                                   last_time_ns_ = 0;
+};
+
+}   // namespace mlogger
+
+#endif   // BINARY_FILE_SINK_H
@@ -0,0 +1,176 @@
+#include "binary_format.h"
+#include <cstring>
+
+namespace mlogger
+{
+
+namespace
+{
+
+// sanity limit so a corrupt size cannot trigger a huge allocation
+constexpr uint64_t kMaxFieldSize = 64 * 1024 * 1024;
+
+int64_t zigzagDecode(uint64_t value)
+{
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+}   // namespace
+
+BinaryLogReader::BinaryLogReader(std::istream& input)
+    : input_(input)
+{
+}
+
+bool BinaryLogReader::next(BinaryLogEntry& entry)
+{
+    if (!header_read_ && !readHeader()) {
+        return false;
+    }
+
+    for (;;) {
+        uint8_t kind;
+        if (!input_.read(reinterpret_cast<char*>(&kind), 1)) {
+            return false;   // clean end of input
+        }
+
+        switch (kind) {
+        case binary_format::kSession:
+            if (!readSession()) return false;
+            break;
+        case binary_format::kDefine:
+            if (!readDefine()) return false;
+            break;
+        case binary_format::kEntry: return readEntry(entry);
+        default: return fail("unknown record kind");
+        }
+    }
+}
+
+bool BinaryLogReader::readHeader()
+{
+    std::array<char, 8> magic{};
+    uint32_t            version = 0;
+    if (!readBytes(magic.data(), magic.size()) || magic != binary_format::kMagic) {
+        return fail("not an MLogger binary log");
+    }
+    if (!readBytes(&version, sizeof(version)) || version != binary_format::kVersion) {
+        return fail("unsupported binary log version");
+    }
+
+    header_read_ = true;
+    return true;
+}
+
+bool BinaryLogReader::readSession()
+{
+    if (!readBytes(&last_time_ns_, sizeof(last_time_ns_))) {
+        return fail("truncated session record");
+    }
+
+    strings_.clear();
+    return true;
+}
+
+bool BinaryLogReader::readDefine()
+{
+    uint64_t id   = 0;
+    uint64_t size = 0;
+    if (!readVarint(id) || !readVarint(size) || size > kMaxFieldSize) {
+        return fail("truncated string definition");
+    }
+    if (id != strings_.size()) {
+        return fail("string definitions out of order");
+    }
+
+    std::string text(size, '\0');
+    if (!readBytes(text.data(), size)) {
+        return fail("truncated string definition");
+    }
+    strings_.push_back(std::move(text));
+    return true;
+}
+
+bool BinaryLogReader::readEntry(BinaryLogEntry& entry)
+{
+    uint64_t delta     = 0;
+    uint8_t  level     = 0;
+    uint64_t thread_id = 0;
+    if (!readVarint(delta) || !readBytes(&level, 1) || !readVarint(thread_id)) {
+        return fail("truncated entry");
+    }
+    if (!readRef(entry.logger_name) || !readRef(entry.text)) {
+        return false;
+    }
+
+    uint64_t argument_size = 0;
+    if (!readVarint(argument_size) || argument_size > kMaxFieldSize) {
+        return fail("truncated entry");
+    }
+    entry.arguments.resize(argument_size);
+    if (!readBytes(entry.arguments.data(), argument_size)) {
+        return fail("truncated entry");
+    }
+
+    last_time_ns_ += zigzagDecode(delta);
+    entry.time_ns   = last_time_ns_;
+    entry.level     = level;
+    entry.thread_id = thread_id;
+    return true;
+}
+
+bool BinaryLogReader::readRef(std::string& text)
+{
+    uint64_t ref = 0;
+    if (!readVarint(ref)) {
+        return fail("truncated entry");
+    }
+
+    if (ref == 0) {
+        uint64_t size = 0;
+        if (!readVarint(size) || size > kMaxFieldSize) {
+            return fail("truncated entry");
+        }
+        text.resize(size);
+        if (!readBytes(text.data(), size)) {
+            return fail("truncated entry");
+        }
+    } else if (ref - 1 < strings_.size()) {
+        text = strings_[ref - 1];
+    } else {
+        return fail("entry references an undefined string");
+    }
+    return true;
+}
+
+bool BinaryLogReader::readBytes(void* dest, size_t size)
+{
+    if (size == 0) {
+        return true;
+    }
+    return static_cast<bool>(input_.read(static_cast<char*>(dest), size));
+}
+
+bool BinaryLogReader::readVarint(uint64_t& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int byte = input_.get();
+        if (byte == std::char_traits<char>::eof()) {
+            return false;
+        }
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool BinaryLogReader::fail(const char* message)
+{
+    error_ = message;
+    return false;
+}
+
+}   // namespace mlogger
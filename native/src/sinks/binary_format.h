@@ -0,0 +1,87 @@
+#ifndef BINARY_FORMAT_H
+#define BINARY_FORMAT_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace mlogger
+{
+
+// Layout of files written by BinaryFileSink. Integers are little endian, "varint" is LEB128 and
+// signed varints are zig-zag encoded.
+//
+//   header   : magic "MLOGBIN\0", u32 version
+//   session  : u8 kind, i64 base time (ns since epoch)
+//   define   : u8 kind, varint string id, varint size, bytes
+//   entry    : u8 kind, svarint time delta (ns), u8 level, varint thread id, logger name ref,
+//              text ref, varint argument size, argument bytes
+//   ref      : varint string id + 1, or 0 then varint size + bytes
+//
+// Every file starts with a header and every process appends a session record first, which
+// resets the string table and the time base, so each file decodes on its own. Logger names and
+// texts share the string table, so a channel name is written once per session.
+//
+// An entry without arguments carries final text. Otherwise the text is an fmt format string and
+// the arguments are encoded as described in core/deferred_format.h (native byte order), see
+// formatArguments().
+namespace binary_format
+{
+
+constexpr std::array<char, 8> kMagic   = {'M', 'L', 'O', 'G', 'B', 'I', 'N', '\0'};
+constexpr uint32_t            kVersion = 2;
+
+enum RecordKind : uint8_t
+{
+    kSession = 1,
+    kDefine  = 2,
+    kEntry   = 3,
+};
+
+}   // namespace binary_format
+
+// One decoded record of a binary log file.
+struct BinaryLogEntry {
+    int64_t              time_ns   = 0;   // since the Unix epoch
+    int                  level     = 0;   // spdlog level
+    uint64_t             thread_id = 0;
+    std::string          logger_name;
+    std::string          text;
+    std::vector<uint8_t> arguments;   // raw argument bytes for `text`, empty for plain messages
+};
+
+// Sequential reader for files written by BinaryFileSink.
+class BinaryLogReader final
+{
+public:
+    explicit BinaryLogReader(std::istream& input);
+
+    // false at the end of the input or on the first malformed record, see error()
+    bool next(BinaryLogEntry& entry);
+
+    // empty unless the input was not a complete binary log
+    const std::string& error() const { return error_; }
+
+private:
+    bool readHeader();
+    bool readSession();
+    bool readDefine();
+    bool readEntry(BinaryLogEntry& entry);
+    bool readRef(std::string& text);
+    bool readBytes(void* dest, size_t size);
+    bool readVarint(uint64_t& value);
+    bool fail(const char* message);
+
+    std::istream&            input_;
+    bool                     header_read_  = false;
+    int64_t                  last_time_ns_ = 0;
+    std::vector<std::string> strings_;
+    std::string              error_;
+};
+
+}   // namespace mlogger
+
+#endif   // BINARY_FORMAT_H
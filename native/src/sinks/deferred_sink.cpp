@@ -0,0 +1,81 @@
+#include "deferred_sink.h"
+#include <cstring>
+#include <string>
+#include <utility>
+
+namespace mlogger
+{
+
+DeferredSink::DeferredSink(size_t capacity)
+    : capacity_(capacity)
+{
+    // untouched until records arrive, and never reallocated under the lock
+    data_.reserve(capacity_);
+}
+
+void DeferredSink::forward(Target target)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t offset = 0; offset < data_.size();) {
+        Header header;
+        std::memcpy(&header, data_.data() + offset, sizeof(header));
+        const char* name = data_.data() + offset + sizeof(header);
+
+        spdlog::details::log_msg msg(
+            header.time,
+            spdlog::source_loc(nullptr, 0, header.funcname),
+            spdlog::string_view_t(name, header.name_size),
+            header.level,
+            spdlog::string_view_t(name + header.name_size, header.payload_size));
+        msg.thread_id = header.thread_id;
+        target(msg);
+        offset += sizeof(header) + header.name_size + header.payload_size;
+    }
+
+    uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+    if (dropped > 0) {
+        std::string text = std::to_string(dropped) + " messages dropped before the log file opened";
+        target(spdlog::details::log_msg(spdlog::string_view_t(), spdlog::level::warn, text));
+    }
+
+    std::vector<char>().swap(data_);
+    target_ = std::move(target);
+}
+
+void DeferredSink::log(const spdlog::details::log_msg& msg)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (target_) {
+        target_(msg);
+        return;
+    }
+
+    size_t size = sizeof(Header) + msg.logger_name.size() + msg.payload.size();
+    if (data_.size() + size > capacity_) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    Header header;
+    header.time         = msg.time;
+    header.funcname     = msg.source.funcname;
+    header.thread_id    = msg.thread_id;
+    header.name_size    = static_cast<uint32_t>(msg.logger_name.size());
+    header.payload_size = static_cast<uint32_t>(msg.payload.size());
+    header.level        = msg.level;
+
+    size_t offset = data_.size();
+    data_.resize(offset + size);
+    char* dest = data_.data() + offset;
+    std::memcpy(dest, &header, sizeof(header));
+    std::memcpy(dest + sizeof(header), msg.logger_name.data(), msg.logger_name.size());
+    std::memcpy(dest + sizeof(header) + header.name_size, msg.payload.data(), msg.payload.size());
+}
+
+void DeferredSink::flush() {}
+
+void DeferredSink::set_pattern(const std::string&) {}
+
+void DeferredSink::set_formatter(std::unique_ptr<spdlog::formatter>) {}
+
+}   // namespace mlogger
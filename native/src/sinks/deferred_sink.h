@@ -0,0 +1,62 @@
+#ifndef DEFERRED_SINK_H
+#define DEFERRED_SINK_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <spdlog/details/log_msg.h>
+#include <spdlog/sinks/sink.h>
+#include <vector>
+
+namespace mlogger
+{
+
+// Lazy initialization (LoggerConfig::lazy_init): holds the records logged before the log file is
+// open, up to `capacity` bytes; records past it are counted as dropped. forward() replays them
+// in order and then sends every later record straight on, so a record logged while the real
+// backend takes over is neither lost nor written ahead of the buffered ones.
+class DeferredSink final : public spdlog::sinks::sink
+{
+public:
+    using Target = std::function<void(const spdlog::details::log_msg&)>;
+
+    explicit DeferredSink(size_t capacity);
+
+    // Replays the buffered records through `target`, followed by an "N messages dropped" warning
+    // with an empty logger name when records were dropped, and passes every later record on.
+    void forward(Target target);
+
+    uint64_t droppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+
+    void log(const spdlog::details::log_msg& msg) override;
+    void flush() override;
+    // records are formatted by the sinks they are forwarded to
+    void set_pattern(const std::string& pattern) override;
+    void set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) override;
+
+    DeferredSink(const DeferredSink&)            = delete;
+    DeferredSink& operator=(const DeferredSink&) = delete;
+
+private:
+    // every record is a Header followed by its logger name and payload
+    struct Header {
+        spdlog::log_clock::time_point time;
+        const char*                   funcname;   // payload tag, static strings only
+        size_t                        thread_id;
+        uint32_t                      name_size;
+        uint32_t                      payload_size;
+        spdlog::level::level_enum     level;
+    };
+
+    std::mutex            mutex_;
+    std::vector<char>     data_;
+    size_t                capacity_;
+    std::atomic<uint64_t> dropped_{0};
+    Target                target_;
+};
+
+}   // namespace mlogger
+
+#endif   // DEFERRED_SINK_H
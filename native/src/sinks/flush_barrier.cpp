@@ -0,0 +1,90 @@
+#include "flush_barrier.h"
+#include <exception>
+#include <spdlog/sinks/sink.h>
+
+namespace mlogger
+{
+
+// Sink of the barrier logger. A ticket is `workers` flushes, each held on the worker that dequeued
+// it until all of them were dequeued: the workers then cannot be busy with an earlier record, so
+// the last one to arrive flushes the sinks and serves the ticket.
+class FlushBarrier::TicketSink final : public spdlog::sinks::sink
+{
+public:
+    TicketSink(std::vector<spdlog::sink_ptr> sinks, size_t workers)
+        : sinks_(std::move(sinks))
+        , workers_(workers)
+    {
+    }
+
+    void log(const spdlog::details::log_msg&) override {}
+
+    void flush() override
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (++arrived_ < workers_) {
+            uint64_t ticket = served_ + 1;
+            served_changed_.wait(lock, [&]() { return served_ >= ticket; });
+            return;
+        }
+
+        arrived_ = 0;
+        // NOTE: the ticket is served even when a sink throws, the held workers would wait forever
+        std::exception_ptr error;
+        for (auto& sink : sinks_) {
+            try {
+                sink->flush();
+            } catch (...) {
+                if (!error) error = std::current_exception();
+            }
+        }
+        ++served_;
+        served_changed_.notify_all();
+        if (error) std::rethrow_exception(error);
+    }
+
+    void set_pattern(const std::string&) override {}
+    void set_formatter(std::unique_ptr<spdlog::formatter>) override {}
+
+    bool wait(uint64_t ticket, std::chrono::milliseconds timeout)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return served_changed_.wait_for(lock, timeout, [&]() { return served_ >= ticket; });
+    }
+
+private:
+    const std::vector<spdlog::sink_ptr> sinks_;
+    const size_t                        workers_;
+    std::mutex                          mutex_;
+    std::condition_variable             served_changed_;
+    size_t                              arrived_ = 0;
+    uint64_t                            served_  = 0;
+};
+
+FlushBarrier::FlushBarrier(const std::vector<spdlog::sink_ptr>&        sinks,
+                           std::shared_ptr<spdlog::details::thread_pool> pool, size_t workers)
+    : tickets_(std::make_shared<TicketSink>(sinks, workers))
+    , workers_(workers)
+{
+    logger_ = std::make_shared<spdlog::async_logger>(
+        "flush_barrier", tickets_, std::move(pool), spdlog::async_overflow_policy::block);
+    // never logs, only flushes
+    logger_->set_level(spdlog::level::off);
+}
+
+FlushBarrier::~FlushBarrier() = default;
+
+bool FlushBarrier::flush(std::chrono::milliseconds timeout)
+{
+    uint64_t ticket;
+    {
+        // NOTE: tickets are served in the order of the queue, so the requests of one ticket have
+        // to enter it together and in the order the tickets are issued
+        std::lock_guard<std::mutex> lock(post_mutex_);
+        ticket = ++issued_;
+        for (size_t i = 0; i < workers_; ++i) logger_->flush();
+    }
+    return tickets_->wait(ticket, timeout);
+}
+
+}   // namespace mlogger
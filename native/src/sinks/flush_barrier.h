@@ -0,0 +1,50 @@
+#ifndef FLUSH_BARRIER_H
+#define FLUSH_BARRIER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <spdlog/async_logger.h>
+#include <spdlog/details/thread_pool.h>
+#include <vector>
+
+namespace mlogger
+{
+
+// Lets a caller wait until the records queued to a thread pool before it are written. Every
+// flush() queues a ticket of its own, one request per pool worker, and waits for the pool to
+// serve it: a worker that dequeues a request waits for the others to dequeue theirs, so no worker
+// is still writing an earlier record when `sinks` are flushed. Flushes queued by the loggers or
+// done on the pool threads (flush_on) cannot end the wait early.
+//
+// The request is queued with the block policy, it must not share a queue with overrun_oldest
+// producers: their records could evict it.
+class FlushBarrier final
+{
+public:
+    // `workers` must be the number of threads of `pool`
+    FlushBarrier(const std::vector<spdlog::sink_ptr>&        sinks,
+                 std::shared_ptr<spdlog::details::thread_pool> pool, size_t workers);
+    ~FlushBarrier();
+
+    // false when the pool did not get to the request within `timeout`
+    bool flush(std::chrono::milliseconds timeout);
+
+    FlushBarrier(const FlushBarrier&)            = delete;
+    FlushBarrier& operator=(const FlushBarrier&) = delete;
+
+private:
+    class TicketSink;
+
+    std::shared_ptr<TicketSink>           tickets_;
+    std::shared_ptr<spdlog::async_logger> logger_;   // queues the requests to tickets_
+    size_t                                workers_;
+    std::mutex                            post_mutex_;
+    uint64_t                              issued_ = 0;   // guarded by post_mutex_
+};
+
+}   // namespace mlogger
+
+#endif   // FLUSH_BARRIER_H
@@ -0,0 +1,139 @@
+#include "json_lines_sink.h"
+#include "core/structured_payload.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <iterator>
+#include <spdlog/details/fmt_helper.h>
+#include <spdlog/details/os.h>
+
+namespace mlogger
+{
+
+namespace
+{
+
+constexpr char kHexDigits[] = "0123456789abcdef";
+
+void appendLiteral(spdlog::memory_buf_t& dest, const char* text)
+{
+    dest.append(spdlog::string_view_t(text));
+}
+
+// JSON string body, quotes included
+void appendString(spdlog::string_view_t text, spdlog::memory_buf_t& dest)
+{
+    dest.push_back('"');
+    const char* run = text.data();
+    const char* end = text.data() + text.size();
+    for (const char* c = run; c != end; ++c) {
+        unsigned char byte = static_cast<unsigned char>(*c);
+        if (byte >= 0x20 && byte != '"' && byte != '\\') {
+            continue;
+        }
+
+        // copy the clean run in one go, then the escape
+        dest.append(run, c);
+        run = c + 1;
+        switch (byte) {
+        case '"': appendLiteral(dest, "\\\""); break;
+        case '\\': appendLiteral(dest, "\\\\"); break;
+        case '\n': appendLiteral(dest, "\\n"); break;
+        case '\r': appendLiteral(dest, "\\r"); break;
+        case '\t': appendLiteral(dest, "\\t"); break;
+        default: {
+            char escape[6] = {'\\', 'u', '0', '0', kHexDigits[byte >> 4], kHexDigits[byte & 0xF]};
+            dest.append(escape, escape + sizeof(escape));
+            break;
+        }
+        }
+    }
+    dest.append(run, end);
+    dest.push_back('"');
+}
+
+void appendField(const StructuredField& field, spdlog::memory_buf_t& dest)
+{
+    dest.push_back(',');
+    appendString(field.key, dest);
+    dest.push_back(':');
+    switch (field.type) {
+    case FieldType::int64: spdlog::details::fmt_helper::append_int(field.int_value, dest); break;
+    case FieldType::float64:
+        if (std::isfinite(field.double_value)) {
+            spdlog::fmt_lib::format_to(std::back_inserter(dest), "{}", field.double_value);
+        } else {
+            appendLiteral(dest, "null");
+        }
+        break;
+    case FieldType::float32:
+        if (std::isfinite(field.float_value)) {
+            spdlog::fmt_lib::format_to(std::back_inserter(dest), "{}", field.float_value);
+        } else {
+            appendLiteral(dest, "null");
+        }
+        break;
+    case FieldType::boolean: appendLiteral(dest, field.bool_value ? "true" : "false"); break;
+    case FieldType::string: appendString(field.string_value, dest); break;
+    }
+}
+
+}   // namespace
+
+JsonLinesSink::JsonLinesSink(spdlog::filename_t base_filename, size_t max_size, size_t max_files,
+                             std::unique_ptr<LogFile> file)
+    : RotatingFileSink(std::move(base_filename), max_size, max_files, std::move(file))
+{
+}
+
+void JsonLinesSink::encode(const spdlog::details::log_msg& msg, spdlog::memory_buf_t& dest)
+{
+    appendLiteral(dest, "{\"time\":");
+    appendTime(msg.time, dest);
+    appendLiteral(dest, ",\"level\":\"");
+    dest.append(spdlog::level::to_string_view(msg.level));
+    appendLiteral(dest, "\",\"logger\":");
+    appendString(msg.logger_name, dest);
+    appendLiteral(dest, ",\"thread\":");
+    spdlog::details::fmt_helper::append_int(msg.thread_id, dest);
+    appendLiteral(dest, ",\"message\":");
+
+    if (isStructured(msg)) {
+        StructuredPayloadReader reader(msg.payload);
+        StructuredField         field;
+        appendString(reader.message(), dest);
+        while (reader.next(field)) {
+            appendField(field, dest);
+        }
+    } else {
+        appendString(payloadText(msg), dest);
+    }
+    appendLiteral(dest, "}\n");
+}
+
+void JsonLinesSink::appendTime(spdlog::log_clock::time_point time, spdlog::memory_buf_t& dest)
+{
+    using std::chrono::duration_cast;
+
+    auto    since_epoch = duration_cast<std::chrono::microseconds>(time.time_since_epoch());
+    int64_t micros      = since_epoch.count();
+    int64_t seconds     = micros >= 0 ? micros / 1000000 : (micros - 999999) / 1000000;
+    if (seconds != cached_seconds_) {
+        std::tm tm = spdlog::details::os::gmtime(static_cast<std::time_t>(seconds));
+        char    text[64];
+        std::snprintf(text, sizeof(text), "%04d-%02d-%02dT%02d:%02d:%02d", tm.tm_year + 1900,
+                      tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec);
+        std::copy(text, text + cached_time_.size(), cached_time_.begin());
+        cached_seconds_ = seconds;
+    }
+
+    dest.push_back('"');
+    dest.append(cached_time_.data(), cached_time_.data() + cached_time_.size());
+    dest.push_back('.');
+    spdlog::details::fmt_helper::pad6(static_cast<size_t>(micros - seconds * 1000000), dest);
+    appendLiteral(dest, "Z\"");
+}
+
+}   // namespace mlogger
@@ -0,0 +1,40 @@
+#ifndef JSON_LINES_SINK_H
+#define JSON_LINES_SINK_H
+
+#include "rotating_file_sink.h"
+#include <array>
+#include <cstdint>
+
+namespace mlogger
+{
+
+// Rotating sink writing one JSON object per line, for collectors that ingest JSON-lines without a
+// pattern to parse:
+//
+//   {"time":"2026-01-02T03:04:05.678901Z","level":"info","logger":"mlogger","thread":42,
+//    "message":"...","key":value,...}
+//
+// Fields of structured records follow the fixed members in the order they were given, as JSON
+// numbers, booleans and strings (non-finite doubles become null). Bytes are escaped, not
+// validated, so invalid UTF-8 in a message is written as it is. The pattern of the logger is
+// ignored.
+class JsonLinesSink final : public RotatingFileSink
+{
+public:
+    JsonLinesSink(spdlog::filename_t base_filename, size_t max_size, size_t max_files,
+                  std::unique_ptr<LogFile> file = nullptr);
+
+protected:
+    void encode(const spdlog::details::log_msg& msg, spdlog::memory_buf_t& dest) override;
+
+private:
+    void appendTime(spdlog::log_clock::time_point time, spdlog::memory_buf_t& dest);
+
+    // "YYYY-MM-DDTHH:MM:SS" of cached_seconds_, rebuilt once per second
+    std::array<char, 19> cached_time_{};
+    int64_t              cached_seconds_ = -1;
+};
+
+}   // namespace mlogger
+
+#endif   // JSON_LINES_SINK_H
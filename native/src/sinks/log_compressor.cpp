@@ -0,0 +1,504 @@
+#include "log_compressor.h"
+#include "rotating_file_sink.h"
+#include "utils/thread_utils.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <spdlog/details/os.h>
+#include <vector>
+
+#ifdef MLOGGER_HAVE_ZLIB
+#    include <zlib.h>
+#endif
+#ifdef MLOGGER_HAVE_ZSTD
+#    include <zstd.h>
+#endif
+
+namespace mlogger
+{
+
+namespace
+{
+
+constexpr size_t kOutputBufferSize = 16 * 1024;
+
+// Streaming compressor, encode() appends the compressed form of each chunk to `out`.
+class Encoder
+{
+public:
+    virtual ~Encoder() = default;
+
+    // `last` ends the stream, no further call is allowed until reset()
+    virtual bool encode(const char* data, size_t size, bool last, std::string& out) = 0;
+    // starts the next stream, keeping the codec state allocated
+    virtual void reset() = 0;
+
+    const std::string& error() const { return error_; }
+
+protected:
+    bool fail(const char* message)
+    {
+        error_ = message;
+        return false;
+    }
+
+private:
+    std::string error_;
+};
+
+#ifdef MLOGGER_HAVE_ZLIB
+
+// gzip container, so the files open with any stock tool. About 270KB of state.
+class GzipEncoder final : public Encoder
+{
+public:
+    GzipEncoder()
+    {
+        // 15 + 16 = 32KB window with a gzip header
+        ready_ = deflateInit2(&stream_, 6, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) == Z_OK;
+    }
+
+    ~GzipEncoder() override
+    {
+        if (ready_) deflateEnd(&stream_);
+    }
+
+    bool encode(const char* data, size_t size, bool last, std::string& out) override
+    {
+        if (!ready_) {
+            return fail("failed to initialize zlib");
+        }
+
+        stream_.next_in  = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+        stream_.avail_in = static_cast<uInt>(size);
+        int flush        = last ? Z_FINISH : Z_NO_FLUSH;
+        int result       = Z_OK;
+        do {
+            stream_.next_out  = buffer_;
+            stream_.avail_out = sizeof(buffer_);
+            result            = deflate(&stream_, flush);
+            if (result == Z_STREAM_ERROR) {
+                return fail("zlib stream error");
+            }
+            out.append(reinterpret_cast<const char*>(buffer_),
+                       sizeof(buffer_) - stream_.avail_out);
+        } while (last ? result != Z_STREAM_END : stream_.avail_out == 0);
+        return true;
+    }
+
+    void reset() override
+    {
+        if (ready_) deflateReset(&stream_);
+    }
+
+private:
+    z_stream      stream_{};
+    bool          ready_ = false;
+    unsigned char buffer_[kOutputBufferSize];
+};
+
+#endif   // MLOGGER_HAVE_ZLIB
+
+#ifdef MLOGGER_HAVE_ZSTD
+
+// Level 3 with a 1MB window keeps the state around 2MB while still matching across lines.
+class ZstdEncoder final : public Encoder
+{
+public:
+    ZstdEncoder()
+        : context_(ZSTD_createCCtx())
+    {
+        if (context_) {
+            ZSTD_CCtx_setParameter(context_, ZSTD_c_compressionLevel, 3);
+            ZSTD_CCtx_setParameter(context_, ZSTD_c_windowLog, 20);
+        }
+    }
+
+    ~ZstdEncoder() override { ZSTD_freeCCtx(context_); }
+
+    bool encode(const char* data, size_t size, bool last, std::string& out) override
+    {
+        if (!context_) {
+            return fail("failed to create the zstd context");
+        }
+
+        ZSTD_inBuffer     input{data, size, 0};
+        ZSTD_EndDirective mode = last ? ZSTD_e_end : ZSTD_e_continue;
+        for (;;) {
+            ZSTD_outBuffer output{buffer_, sizeof(buffer_), 0};
+            size_t         remaining = ZSTD_compressStream2(context_, &output, &input, mode);
+            if (ZSTD_isError(remaining)) {
+                return fail(ZSTD_getErrorName(remaining));
+            }
+            out.append(buffer_, output.pos);
+            if (last ? remaining == 0 : input.pos == input.size) {
+                return true;
+            }
+        }
+    }
+
+    void reset() override
+    {
+        if (context_) ZSTD_CCtx_reset(context_, ZSTD_reset_session_only);
+    }
+
+private:
+    ZSTD_CCtx* context_;
+    char       buffer_[kOutputBufferSize];
+};
+
+#endif   // MLOGGER_HAVE_ZSTD
+
+std::unique_ptr<Encoder> createEncoder(Compression codec)
+{
+    switch (codec) {
+#ifdef MLOGGER_HAVE_ZLIB
+    case Compression::gzip: return std::make_unique<GzipEncoder>();
+#endif
+#ifdef MLOGGER_HAVE_ZSTD
+    case Compression::zstd: return std::make_unique<ZstdEncoder>();
+#endif
+    default: return nullptr;
+    }
+}
+
+bool setError(std::string* error, const char* message)
+{
+    if (error) *error = message;
+    return false;
+}
+
+#ifdef MLOGGER_HAVE_ZLIB
+
+bool inflateGzip(std::istream& input, std::string& data, std::string* error)
+{
+    z_stream stream{};
+    // 15 + 32 accepts both zlib and gzip headers
+    if (inflateInit2(&stream, 15 + 32) != Z_OK) {
+        return setError(error, "failed to initialize zlib");
+    }
+
+    std::vector<char> chunk(LogCompressor::kChunkSize);
+    unsigned char     buffer[kOutputBufferSize];
+    int               result = Z_OK;
+    while (input.read(chunk.data(), static_cast<std::streamsize>(chunk.size())) ||
+           input.gcount() > 0) {
+        stream.next_in  = reinterpret_cast<Bytef*>(chunk.data());
+        stream.avail_in = static_cast<uInt>(input.gcount());
+        for (;;) {
+            // NOTE: concatenated gzip members are valid, start over after each one
+            if (result == Z_STREAM_END) {
+                if (stream.avail_in == 0) break;
+                inflateReset(&stream);
+            }
+            stream.next_out  = buffer;
+            stream.avail_out = sizeof(buffer);
+            result           = inflate(&stream, Z_NO_FLUSH);
+            if (result == Z_BUF_ERROR) {
+                result = Z_OK;   // no progress possible, needs the next chunk
+                break;
+            }
+            if (result != Z_OK && result != Z_STREAM_END) {
+                inflateEnd(&stream);
+                return setError(error, "corrupt gzip data");
+            }
+            data.append(reinterpret_cast<const char*>(buffer), sizeof(buffer) - stream.avail_out);
+            if (stream.avail_in == 0 && stream.avail_out != 0) break;
+        }
+    }
+
+    inflateEnd(&stream);
+    return result == Z_STREAM_END || setError(error, "truncated gzip data");
+}
+
+#endif   // MLOGGER_HAVE_ZLIB
+
+#ifdef MLOGGER_HAVE_ZSTD
+
+bool decompressZstd(std::istream& input, std::string& data, std::string* error)
+{
+    std::unique_ptr<ZSTD_DCtx, size_t (*)(ZSTD_DCtx*)> context(ZSTD_createDCtx(), ZSTD_freeDCtx);
+    if (!context) {
+        return setError(error, "failed to create the zstd context");
+    }
+
+    std::vector<char> chunk(LogCompressor::kChunkSize);
+    char              buffer[kOutputBufferSize];
+    size_t            pending = 0;   // 0 once a frame is complete
+    while (input.read(chunk.data(), static_cast<std::streamsize>(chunk.size())) ||
+           input.gcount() > 0) {
+        ZSTD_inBuffer in{chunk.data(), static_cast<size_t>(input.gcount()), 0};
+        for (;;) {
+            ZSTD_outBuffer out{buffer, sizeof(buffer), 0};
+            pending = ZSTD_decompressStream(context.get(), &out, &in);
+            if (ZSTD_isError(pending)) {
+                return setError(error, ZSTD_getErrorName(pending));
+            }
+            data.append(buffer, out.pos);
+            if (in.pos == in.size && out.pos < out.size) break;
+        }
+    }
+    return pending == 0 || setError(error, "truncated zstd data");
+}
+
+#endif   // MLOGGER_HAVE_ZSTD
+
+// file or buffer, detected by its magic
+bool decompressStream(std::istream& input, std::string& data, std::string* error)
+{
+    unsigned char magic[4] = {};
+    input.read(reinterpret_cast<char*>(magic), sizeof(magic));
+    input.clear();
+    input.seekg(0);
+
+    data.clear();
+    if (magic[0] == 0x1f && magic[1] == 0x8b) {
+#ifdef MLOGGER_HAVE_ZLIB
+        return inflateGzip(input, data, error);
+#else
+        return setError(error, "gzip support is not built in");
+#endif
+    }
+    if (magic[0] == 0x28 && magic[1] == 0xb5 && magic[2] == 0x2f && magic[3] == 0xfd) {
+#ifdef MLOGGER_HAVE_ZSTD
+        return decompressZstd(input, data, error);
+#else
+        return setError(error, "zstd support is not built in");
+#endif
+    }
+    return setError(error, "not a compressed file");
+}
+
+}   // namespace
+
+LogCompressor::LogCompressor(spdlog::filename_t base_filename, size_t max_files,
+                             Compression codec, ErrorHandler error_handler)
+    : base_filename_(std::move(base_filename))
+    , max_files_(max_files)
+    , codec_(codec)
+    , error_handler_(std::move(error_handler))
+{
+    worker_ = std::thread([this]() { workerLoop(); });
+}
+
+LogCompressor::~LogCompressor()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_cv_.notify_all();
+    if (worker_.joinable()) worker_.join();
+}
+
+bool LogCompressor::isAvailable(Compression codec)
+{
+    switch (codec) {
+    case Compression::none: return true;
+#ifdef MLOGGER_HAVE_ZLIB
+    case Compression::gzip: return true;
+#endif
+#ifdef MLOGGER_HAVE_ZSTD
+    case Compression::zstd: return true;
+#endif
+    default: return false;
+    }
+}
+
+const char* LogCompressor::extension(Compression codec)
+{
+    switch (codec) {
+    case Compression::gzip: return ".gz";
+    case Compression::zstd: return ".zst";
+    default: return "";
+    }
+}
+
+bool LogCompressor::decompressFile(const spdlog::filename_t& path, std::string& data,
+                                   std::string* error)
+{
+    std::ifstream input(path, std::ios::binary);
+    if (!input.is_open()) {
+        return setError(error, "cannot open file");
+    }
+    return decompressStream(input, data, error);
+}
+
+bool LogCompressor::decompressBuffer(const char* source, size_t size, std::string& data,
+                                     std::string* error)
+{
+    std::istringstream input(std::string(source, size));
+    return decompressStream(input, data, error);
+}
+
+struct BufferCompressor::Codec {
+    std::unique_ptr<Encoder> encoder;
+};
+
+BufferCompressor::BufferCompressor(Compression codec)
+    : codec_(std::make_unique<Codec>())
+{
+    codec_->encoder = createEncoder(codec);
+}
+
+BufferCompressor::~BufferCompressor() = default;
+
+bool BufferCompressor::compress(const char* data, size_t size, std::string& out, std::string* error)
+{
+    Encoder* encoder = codec_->encoder.get();
+    if (!encoder) {
+        return setError(error, "codec not built in");
+    }
+    bool done = encoder->encode(data, size, true, out);
+    if (!done) setError(error, encoder->error().c_str());
+    encoder->reset();
+    return done;
+}
+
+void LogCompressor::rotated()
+{
+    // NOTE: a file pushed past max_files was overwritten by the rotation, its job is gone
+    if (running_ != 0) ++running_;
+    for (size_t& index : queued_) {
+        ++index;
+    }
+    queued_.erase(std::remove_if(queued_.begin(),
+                                 queued_.end(),
+                                 [this](size_t index) { return index > max_files_; }),
+                  queued_.end());
+    if (max_files_ > 0) {
+        queued_.push_back(1);
+    }
+    wake_cv_.notify_one();
+}
+
+void LogCompressor::queueExisting()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    // oldest first, those are the next to be rotated away
+    for (size_t i = max_files_; i > 0; --i) {
+        if (spdlog::details::os::path_exists(RotatingFileSink::calcFilename(base_filename_, i))) {
+            queued_.push_back(i);
+        }
+    }
+    wake_cv_.notify_one();
+}
+
+bool LogCompressor::busy()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return running_ != 0 || !queued_.empty();
+}
+
+void LogCompressor::workerLoop()
+{
+    if (!setCurrentThreadBackground()) {
+        reportError("failed to lower the compression thread priority");
+    }
+
+    // NOTE: one worker, so one fixed temp name; a leftover from a killed run is replaced
+    spdlog::filename_t temp_path = base_filename_ + extension() + ".tmp";
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        wake_cv_.wait(lock, [this]() { return stop_ || !queued_.empty(); });
+        if (stop_) break;
+
+        running_ = queued_.front();
+        queued_.pop_front();
+        lock.unlock();
+
+        bool done = compress(temp_path);
+        if (!done) {
+            (void)spdlog::details::os::remove(temp_path);
+        }
+
+        lock.lock();
+        running_ = 0;
+    }
+}
+
+bool LogCompressor::compress(const spdlog::filename_t& temp_path)
+{
+    using spdlog::details::os::path_exists;
+
+    std::unique_ptr<Encoder> encoder = createEncoder(codec_);
+    if (!encoder) {
+        reportError("compression codec is not available");
+        return false;
+    }
+
+    std::ofstream output(temp_path, std::ios::binary | std::ios::trunc);
+    if (!output.is_open()) {
+        reportError("cannot create " + spdlog::details::os::filename_to_str(temp_path));
+        return false;
+    }
+
+    std::vector<char> chunk(kChunkSize);
+    std::string       compressed;
+    compressed.reserve(kChunkSize);
+    std::streamoff offset = 0;
+    for (;;) {
+        size_t read = 0;
+        {
+            // the index may move between chunks, reopen the file by its current name
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stop_ || running_ > max_files_) return false;
+
+            spdlog::filename_t source = RotatingFileSink::calcFilename(base_filename_, running_);
+            std::ifstream      input(source, std::ios::binary);
+            if (!input.is_open()) {
+                return false;   // already compressed or removed
+            }
+            input.seekg(offset);
+            input.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+            read = static_cast<size_t>(input.gcount());
+        }
+        offset += static_cast<std::streamoff>(read);
+
+        compressed.clear();
+        if (!encoder->encode(chunk.data(), read, read < chunk.size(), compressed)) {
+            reportError(encoder->error());
+            return false;
+        }
+        output.write(compressed.data(), static_cast<std::streamsize>(compressed.size()));
+        if (!output) {
+            reportError("failed writing " + spdlog::details::os::filename_to_str(temp_path));
+            return false;
+        }
+        if (read < chunk.size()) break;
+    }
+    output.close();
+    if (!output) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stop_ || running_ > max_files_) return false;
+
+    spdlog::filename_t source = RotatingFileSink::calcFilename(base_filename_, running_);
+    spdlog::filename_t target = source + extension();
+    (void)spdlog::details::os::remove(target);
+    if (spdlog::details::os::rename(temp_path, target) != 0) {
+        reportError("failed renaming " + spdlog::details::os::filename_to_str(temp_path) +
+                    " to " + spdlog::details::os::filename_to_str(target));
+        return false;
+    }
+    if (path_exists(source) && spdlog::details::os::remove(source) != 0) {
+        reportError("failed removing " + spdlog::details::os::filename_to_str(source));
+    }
+    return true;
+}
+
+void LogCompressor::reportError(const std::string& message) const
+{
+    if (error_handler_) {
+        error_handler_(message.c_str());
+    } else {
+        std::cerr << "[MLogger Error in compression] " << message << std::endl;
+    }
+}
+
+}   // namespace mlogger
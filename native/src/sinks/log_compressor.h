@@ -0,0 +1,107 @@
+#ifndef LOG_COMPRESSOR_H
+#define LOG_COMPRESSOR_H
+
+#include "core/logger_config.h"
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <spdlog/common.h>
+#include <string>
+#include <thread>
+
+namespace mlogger
+{
+
+// Compresses the rotated files of a RotatingFileSink (log.1.txt -> log.1.txt.gz) on a
+// low-priority thread of its own, and deletes each original once its compressed copy is complete.
+//
+// Rotation keeps renaming files while a job runs, so the worker only tracks the index of its
+// file. Renames and the worker's reads both happen under lockFiles(); the worker reads in
+// bounded chunks and never keeps the source open between them, so a rotation waits at most for
+// one chunk. Memory stays bounded by the codec state plus one chunk, whatever the file size.
+class LogCompressor final
+{
+public:
+    using ErrorHandler = std::function<void(const char*)>;
+
+    static constexpr size_t kChunkSize = 64 * 1024;
+
+    // `codec` must be available, see isAvailable()
+    LogCompressor(spdlog::filename_t base_filename, size_t max_files, Compression codec,
+                  ErrorHandler error_handler = nullptr);
+    // the running job is abandoned, its file stays uncompressed until the next queueExisting()
+    ~LogCompressor();
+
+    static bool isAvailable(Compression codec);
+    // suffix appended to compressed files, empty for Compression::none
+    static const char* extension(Compression codec);
+    // decompresses a whole .gz or .zst file (detected by its magic) into `data`
+    static bool decompressFile(const spdlog::filename_t& path, std::string& data,
+                               std::string* error = nullptr);
+    // the same for data in memory, e.g. a frame written by BufferCompressor
+    static bool decompressBuffer(const char* source, size_t size, std::string& data,
+                                 std::string* error = nullptr);
+
+    const char* extension() const { return extension(codec_); }
+
+    // held by the sink while it renames rotated files
+    std::unique_lock<std::mutex> lockFiles() { return std::unique_lock<std::mutex>(mutex_); }
+    // with lockFiles() held, right after index i became i + 1 for every rotated file: queued and
+    // running jobs follow their file, index 1 is queued
+    void rotated();
+    // queues every rotated file left uncompressed, e.g. by an earlier run that exited mid-job
+    void queueExisting();
+
+    // true while jobs are queued or running
+    bool busy();
+
+    LogCompressor(const LogCompressor&)            = delete;
+    LogCompressor& operator=(const LogCompressor&) = delete;
+
+private:
+    void workerLoop();
+    bool compress(const spdlog::filename_t& temp_path);
+    void reportError(const std::string& message) const;
+
+    const spdlog::filename_t base_filename_;
+    const size_t             max_files_;
+    const Compression        codec_;
+    ErrorHandler             error_handler_;
+
+    // every member below is guarded by mutex_
+    std::mutex              mutex_;
+    std::condition_variable wake_cv_;
+    std::deque<size_t>      queued_;
+    size_t                  running_ = 0;   // index of the file being compressed, 0 = none
+    bool                    stop_    = false;
+
+    std::thread worker_;
+};
+
+// Compresses independent buffers, each into a complete .gz member or .zst frame, e.g. the frames
+// of NetworkSink. The codec state is allocated once and reset between buffers.
+class BufferCompressor final
+{
+public:
+    // `codec` must be available, see LogCompressor::isAvailable()
+    explicit BufferCompressor(Compression codec);
+    ~BufferCompressor();
+
+    // appends the compressed form of `data` to `out`
+    bool compress(const char* data, size_t size, std::string& out, std::string* error = nullptr);
+
+    BufferCompressor(const BufferCompressor&)            = delete;
+    BufferCompressor& operator=(const BufferCompressor&) = delete;
+
+private:
+    struct Codec;
+
+    std::unique_ptr<Codec> codec_;
+};
+
+}   // namespace mlogger
+
+#endif   // LOG_COMPRESSOR_H
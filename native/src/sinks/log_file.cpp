@@ -0,0 +1,77 @@
+#include "log_file.h"
+
+namespace mlogger
+{
+
+StdioLogFile::StdioLogFile(size_t buffer_size)
+    : buffer_size_(buffer_size)
+{
+    pending_.reserve(buffer_size_);
+}
+
+StdioLogFile::~StdioLogFile()
+{
+    try {
+        close();
+    } catch (...) {
+        // NOTE: nowhere to report from here, the pending records are lost like a full disk's
+    }
+}
+
+void StdioLogFile::open(const spdlog::filename_t& filename, bool truncate)
+{
+    pending_.clear();
+    file_helper_.open(filename, truncate);
+}
+
+void StdioLogFile::close()
+{
+    writePending();
+    file_helper_.close();
+}
+
+void StdioLogFile::write(const spdlog::memory_buf_t& buffer)
+{
+    if (buffer_size_ == 0) {
+        file_helper_.write(buffer);
+        return;
+    }
+    if (pending_.size() + buffer.size() < buffer_size_) {
+        pending_.append(buffer.data(), buffer.data() + buffer.size());
+        return;
+    }
+
+    // the buffer is full: one write for what is pending plus this record
+    pending_.append(buffer.data(), buffer.data() + buffer.size());
+    writePending();
+}
+
+void StdioLogFile::flush()
+{
+    writePending();
+    file_helper_.flush();
+}
+
+size_t StdioLogFile::size() const
+{
+    // NOTE: file_helper::size() only sees bytes that left the stdio buffer, the sink flushes
+    // before it needs the exact size
+    return file_helper_.size() + pending_.size();
+}
+
+const spdlog::filename_t& StdioLogFile::filename() const
+{
+    return file_helper_.filename();
+}
+
+void StdioLogFile::writePending()
+{
+    if (pending_.size() == 0) {
+        return;
+    }
+    file_helper_.write(pending_);
+    file_helper_.flush();
+    pending_.clear();
+}
+
+}   // namespace mlogger
@@ -0,0 +1,53 @@
+#ifndef LOG_FILE_H
+#define LOG_FILE_H
+
+#include <cstddef>
+#include <spdlog/common.h>
+#include <spdlog/details/file_helper.h>
+
+namespace mlogger
+{
+
+// Append-only file used by RotatingFileSink, one implementation per way of writing to disk.
+class LogFile
+{
+public:
+    virtual ~LogFile() = default;
+
+    virtual void open(const spdlog::filename_t& filename, bool truncate) = 0;
+    virtual void close() = 0;
+    virtual void write(const spdlog::memory_buf_t& buffer) = 0;
+    virtual void flush() = 0;
+
+    // bytes of log data in the file
+    virtual size_t                    size() const     = 0;
+    virtual const spdlog::filename_t& filename() const = 0;
+};
+
+// stdio based file, what spdlog's file sinks use. With a `buffer_size`, records are collected
+// until that many bytes are pending and then handed to the OS in one write, so bursts cost one
+// syscall per buffer instead of one per stdio buffer (or per record when flushing on every one).
+class StdioLogFile final : public LogFile
+{
+public:
+    explicit StdioLogFile(size_t buffer_size = 0);
+    ~StdioLogFile() override;
+
+    void                      open(const spdlog::filename_t& filename, bool truncate) override;
+    void                      close() override;
+    void                      write(const spdlog::memory_buf_t& buffer) override;
+    void                      flush() override;
+    size_t                    size() const override;
+    const spdlog::filename_t& filename() const override;
+
+private:
+    void writePending();
+
+    spdlog::details::file_helper file_helper_;
+    spdlog::memory_buf_t         pending_;
+    size_t                       buffer_size_;
+};
+
+}   // namespace mlogger
+
+#endif   // LOG_FILE_H
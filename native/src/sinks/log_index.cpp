@@ -0,0 +1,248 @@
+#include "log_index.h"
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <spdlog/details/os.h>
+#include <system_error>
+
+namespace mlogger
+{
+
+namespace
+{
+
+// NOTE: byte by byte so the files are little endian whatever the host
+void putUint(char* dest, uint64_t value, size_t size)
+{
+    for (size_t i = 0; i < size; ++i) {
+        dest[i] = static_cast<char>(value >> (8 * i));
+    }
+}
+
+uint64_t getUint(const char* src, size_t size)
+{
+    uint64_t value = 0;
+    for (size_t i = 0; i < size; ++i) {
+        value |= static_cast<uint64_t>(static_cast<unsigned char>(src[i])) << (8 * i);
+    }
+    return value;
+}
+
+void encodeHeader(uint32_t block_lines, char* dest)
+{
+    std::memcpy(dest, log_index::kMagic.data(), log_index::kMagic.size());
+    putUint(dest + 8, log_index::kVersion, 4);
+    putUint(dest + 12, block_lines, 4);
+}
+
+// the block lines of a valid header, 0 otherwise
+uint32_t decodeHeader(const char* src)
+{
+    if (std::memcmp(src, log_index::kMagic.data(), log_index::kMagic.size()) != 0 ||
+        getUint(src + 8, 4) != log_index::kVersion) {
+        return 0;
+    }
+    return static_cast<uint32_t>(getUint(src + 12, 4));
+}
+
+void encodeBlock(const LogIndexBlock& block, char* dest)
+{
+    putUint(dest, block.offset, 8);
+    putUint(dest + 8, block.size, 8);
+    putUint(dest + 16, static_cast<uint64_t>(block.first_time_ns), 8);
+    putUint(dest + 24, static_cast<uint64_t>(block.last_time_ns), 8);
+    putUint(dest + 32, block.lines, 4);
+    putUint(dest + 36, block.records, 4);
+    for (size_t i = 0; i < log_index::kLevels; ++i) {
+        putUint(dest + 40 + 4 * i, block.level_counts[i], 4);
+    }
+}
+
+LogIndexBlock decodeBlock(const char* src)
+{
+    LogIndexBlock block;
+    block.offset        = getUint(src, 8);
+    block.size          = getUint(src + 8, 8);
+    block.first_time_ns = static_cast<int64_t>(getUint(src + 16, 8));
+    block.last_time_ns  = static_cast<int64_t>(getUint(src + 24, 8));
+    block.lines         = static_cast<uint32_t>(getUint(src + 32, 4));
+    block.records       = static_cast<uint32_t>(getUint(src + 36, 4));
+    for (size_t i = 0; i < log_index::kLevels; ++i) {
+        block.level_counts[i] = static_cast<uint32_t>(getUint(src + 40 + 4 * i, 4));
+    }
+    return block;
+}
+
+uint32_t countLines(const char* data, size_t size)
+{
+    uint32_t    lines = 0;
+    const char* end   = data + size;
+    while ((data = static_cast<const char*>(std::memchr(data, '\n', end - data))) != nullptr) {
+        ++lines;
+        ++data;
+    }
+    return lines;
+}
+
+}   // namespace
+
+bool readLogIndex(std::istream& input, LogIndex& index, std::string* error)
+{
+    char header[log_index::kHeaderSize];
+    if (!input.read(header, sizeof(header)) || (index.block_lines = decodeHeader(header)) == 0) {
+        if (error) *error = "not an MLogger log index";
+        return false;
+    }
+
+    index.blocks.clear();
+    char block[log_index::kBlockSize];
+    while (input.read(block, sizeof(block))) {
+        index.blocks.push_back(decodeBlock(block));
+    }
+    return true;
+}
+
+LogIndexWriter::LogIndexWriter(uint32_t block_lines)
+    : block_lines_(block_lines)
+{
+}
+
+LogIndexWriter::~LogIndexWriter()
+{
+    close();
+}
+
+spdlog::filename_t LogIndexWriter::indexFilename(const spdlog::filename_t& log_filename)
+{
+    return log_filename + SPDLOG_FILENAME_T(".idx");
+}
+
+void LogIndexWriter::open(const spdlog::filename_t& log_filename, size_t log_size)
+{
+    close();
+
+    spdlog::filename_t filename = indexFilename(log_filename);
+    if (log_size > 0 && resume(filename, log_size)) {
+        return;
+    }
+
+    if (spdlog::details::os::fopen_s(&file_, filename, SPDLOG_FILENAME_T("wb"))) {
+        file_ = nullptr;
+        return;
+    }
+    char header[log_index::kHeaderSize];
+    encodeHeader(block_lines_, header);
+    if (std::fwrite(header, sizeof(header), 1, file_) != 1) {
+        close();
+    }
+}
+
+void LogIndexWriter::close()
+{
+    if (!file_) {
+        return;
+    }
+    if (block_.records > 0) {
+        writeBlock();
+    }
+    if (file_) {
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+}
+
+void LogIndexWriter::flush()
+{
+    if (file_) {
+        std::fflush(file_);
+    }
+}
+
+void LogIndexWriter::add(uint64_t offset, const char* data, size_t size,
+                         spdlog::log_clock::time_point time, spdlog::level::level_enum level)
+{
+    if (!file_) {
+        return;
+    }
+
+    int64_t time_ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+    if (block_.records == 0) {
+        block_.offset        = offset;
+        block_.first_time_ns = time_ns;
+    }
+    block_.size         = offset + size - block_.offset;
+    block_.last_time_ns = time_ns;
+    block_.lines += countLines(data, size);
+    ++block_.records;
+    if (static_cast<size_t>(level) < log_index::kLevels) {
+        ++block_.level_counts[level];
+    }
+
+    if (block_.lines >= block_lines_) {
+        writeBlock();
+    }
+}
+
+bool LogIndexWriter::resume(const spdlog::filename_t& filename, size_t log_size)
+{
+    std::FILE* file = nullptr;
+    if (spdlog::details::os::fopen_s(&file, filename, SPDLOG_FILENAME_T("rb"))) {
+        return false;
+    }
+
+    // continue only an index written with the same settings that ends inside the log file
+    char header[log_index::kHeaderSize];
+    long file_size = -1;
+    if (std::fread(header, sizeof(header), 1, file) == 1 &&
+        decodeHeader(header) == block_lines_ && std::fseek(file, 0, SEEK_END) == 0) {
+        file_size = std::ftell(file);
+    }
+
+    size_t blocks = 0;
+    bool   valid  = file_size >= static_cast<long>(log_index::kHeaderSize);
+    if (valid) {
+        blocks = (static_cast<size_t>(file_size) - log_index::kHeaderSize) / log_index::kBlockSize;
+    }
+    if (valid && blocks > 0) {
+        char   block[log_index::kBlockSize];
+        size_t last = log_index::kHeaderSize + (blocks - 1) * log_index::kBlockSize;
+        valid       = std::fseek(file, static_cast<long>(last), SEEK_SET) == 0 &&
+                std::fread(block, sizeof(block), 1, file) == 1;
+        if (valid) {
+            LogIndexBlock last_block = decodeBlock(block);
+            valid                    = last_block.offset + last_block.size <= log_size;
+        }
+    }
+    std::fclose(file);
+    if (!valid) {
+        return false;
+    }
+
+    // drop a block torn by a crash
+    size_t complete_size = log_index::kHeaderSize + blocks * log_index::kBlockSize;
+    if (static_cast<size_t>(file_size) != complete_size) {
+        std::error_code ec;
+        std::filesystem::resize_file(std::filesystem::path(filename), complete_size, ec);
+        if (ec) return false;
+    }
+
+    if (spdlog::details::os::fopen_s(&file_, filename, SPDLOG_FILENAME_T("ab"))) {
+        file_ = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void LogIndexWriter::writeBlock()
+{
+    char block[log_index::kBlockSize];
+    encodeBlock(block_, block);
+    block_ = LogIndexBlock();
+    if (std::fwrite(block, sizeof(block), 1, file_) != 1) {
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+}
+
+}   // namespace mlogger
@@ -0,0 +1,92 @@
+#ifndef LOG_INDEX_H
+#define LOG_INDEX_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <istream>
+#include <spdlog/common.h>
+#include <string>
+#include <vector>
+
+namespace mlogger
+{
+
+// Layout of the sidecar index RotatingFileSink keeps next to each text log file, named
+// "<log file>.idx" (game.log.idx, game.1.log.idx, ...). Integers are little endian.
+//
+//   header : magic "MLOGIDX\0", u32 version, u32 block lines
+//   block  : u64 offset, u64 size, i64 first time, i64 last time (ns since epoch), u32 lines,
+//            u32 records, u32 records per level x 6 (trace ... critical)
+//
+// A block covers `block lines` lines of the log file, the last one written before the file is
+// closed or rotated may cover fewer. Offsets are absolute, so bytes no block covers (an earlier
+// run that did not index, the records since the last block of a running process, a crash) are
+// simply not summarized and readers scan them. A torn trailing block is ignored.
+namespace log_index
+{
+
+constexpr std::array<char, 8> kMagic      = {'M', 'L', 'O', 'G', 'I', 'D', 'X', '\0'};
+constexpr uint32_t            kVersion    = 1;
+constexpr size_t              kHeaderSize = 16;
+constexpr size_t              kBlockSize  = 64;
+constexpr size_t              kLevels     = 6;
+
+}   // namespace log_index
+
+// Summary of one block of lines.
+struct LogIndexBlock {
+    uint64_t                                 offset        = 0;
+    uint64_t                                 size          = 0;
+    int64_t                                  first_time_ns = 0;
+    int64_t                                  last_time_ns  = 0;
+    uint32_t                                 lines         = 0;
+    uint32_t                                 records       = 0;
+    std::array<uint32_t, log_index::kLevels> level_counts{};
+};
+
+struct LogIndex {
+    uint32_t                   block_lines = 0;
+    std::vector<LogIndexBlock> blocks;
+};
+
+// reads a whole index, false when `input` is not one (see `error`)
+bool readLogIndex(std::istream& input, LogIndex& index, std::string* error = nullptr);
+
+// Builds the index of one log file while it is written. Indexing is best effort: when the index
+// cannot be opened or written, it is dropped until the next open() and only costs readers a scan.
+class LogIndexWriter final
+{
+public:
+    explicit LogIndexWriter(uint32_t block_lines);
+    ~LogIndexWriter();
+
+    static spdlog::filename_t indexFilename(const spdlog::filename_t& log_filename);
+
+    // starts indexing `log_filename`, which holds `log_size` bytes. The index of a non-empty
+    // file is continued when it is complete up to the end of its last block.
+    void open(const spdlog::filename_t& log_filename, size_t log_size);
+    // writes the current block, even if partial, and closes the index
+    void close();
+    void flush();
+
+    // one record of `size` bytes written at `offset` of the log file
+    void add(uint64_t offset, const char* data, size_t size, spdlog::log_clock::time_point time,
+             spdlog::level::level_enum level);
+
+    LogIndexWriter(const LogIndexWriter&)            = delete;
+    LogIndexWriter& operator=(const LogIndexWriter&) = delete;
+
+private:
+    bool resume(const spdlog::filename_t& filename, size_t log_size);
+    void writeBlock();
+
+    uint32_t      block_lines_;
+    std::FILE*    file_ = nullptr;
+    LogIndexBlock block_;
+};
+
+}   // namespace mlogger
+
+#endif   // LOG_INDEX_H
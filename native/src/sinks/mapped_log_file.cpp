@@ -0,0 +1,292 @@
+#include "mapped_log_file.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <spdlog/details/os.h>
+
+#if defined(_WIN32) || defined(_WIN64)
+#    include <windows.h>
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+namespace mlogger
+{
+
+namespace
+{
+
+constexpr char kTrailerMagic[8] = {'M', 'L', 'O', 'G', 'M', 'A', 'P', '\0'};
+
+size_t roundUp8(size_t value)
+{
+    return (value + 7) & ~static_cast<size_t>(7);
+}
+
+template <typename Trailer>
+size_t trailerLength(const Trailer& trailer, size_t file_size)
+{
+    if (std::memcmp(trailer.magic, kTrailerMagic, sizeof(kTrailerMagic)) == 0 &&
+        trailer.length <= file_size - sizeof(Trailer)) {
+        return static_cast<size_t>(trailer.length);
+    }
+    return file_size;
+}
+
+[[noreturn]] void throwFileError(const char* what, const spdlog::filename_t& filename)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    int error = static_cast<int>(::GetLastError());
+#else
+    int error = errno;
+#endif
+    spdlog::throw_spdlog_ex(std::string("mapped log file: ") + what + " " +
+                                spdlog::details::os::filename_to_str(filename),
+                            error);
+}
+
+}   // namespace
+
+MappedLogFile::MappedLogFile(size_t capacity)
+    : capacity_hint_(capacity)
+{
+}
+
+MappedLogFile::~MappedLogFile()
+{
+    try {
+        close();
+    } catch (...) {
+        // NOTE: the file keeps its trailer and is trimmed on the next open
+    }
+}
+
+void MappedLogFile::open(const spdlog::filename_t& filename, bool truncate)
+{
+    close();
+    filename_ = filename;
+    spdlog::details::os::create_dir(spdlog::details::os::dir_name(filename));
+
+#if defined(_WIN32) || defined(_WIN64)
+#    ifdef SPDLOG_WCHAR_FILENAMES
+    HANDLE file = ::CreateFileW(filename.c_str(),
+#    else
+    HANDLE file = ::CreateFileA(filename.c_str(),
+#    endif
+                                GENERIC_READ | GENERIC_WRITE,
+                                FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                nullptr,
+                                truncate ? CREATE_ALWAYS : OPEN_ALWAYS,
+                                FILE_ATTRIBUTE_NORMAL,
+                                nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throwFileError("failed opening", filename);
+    }
+    file_ = file;
+#else
+    fd_ = ::open(filename.c_str(), O_RDWR | O_CREAT | O_CLOEXEC | (truncate ? O_TRUNC : 0), 0644);
+    if (fd_ < 0) {
+        throwFileError("failed opening", filename);
+    }
+#endif
+
+    // NOTE: a failed open must not trim the file, close() would cut it to a stale length
+    try {
+        length_ = recoverLength();
+        map(std::max(capacity_hint_, length_));
+    } catch (...) {
+        release();
+        throw;
+    }
+}
+
+void MappedLogFile::close()
+{
+#if defined(_WIN32) || defined(_WIN64)
+    if (!file_) return;
+#else
+    if (fd_ < 0) return;
+#endif
+
+    unmap();
+
+#if defined(_WIN32) || defined(_WIN64)
+    LARGE_INTEGER end;
+    end.QuadPart = static_cast<LONGLONG>(length_);
+    bool trimmed = ::SetFilePointerEx(file_, end, nullptr, FILE_BEGIN) && ::SetEndOfFile(file_);
+#else
+    bool trimmed = ::ftruncate(fd_, static_cast<off_t>(length_)) == 0;
+#endif
+
+    release();
+    if (!trimmed) {
+        throwFileError("failed truncating", filename_);
+    }
+}
+
+void MappedLogFile::write(const spdlog::memory_buf_t& buffer)
+{
+    size_t needed = length_ + buffer.size();
+    if (needed > capacity_ || !data_) {
+        // NOTE: only a record larger than the whole file gets here, the sink rotates before
+        unmap();
+        map(std::max(capacity_ * 2, needed));
+    }
+
+    std::memcpy(data_ + length_, buffer.data(), buffer.size());
+    length_ = needed;
+    writeTrailer();
+}
+
+void MappedLogFile::flush()
+{
+    // nothing to do, the data already is in the page cache
+}
+
+size_t MappedLogFile::size() const
+{
+    return length_;
+}
+
+const spdlog::filename_t& MappedLogFile::filename() const
+{
+    return filename_;
+}
+
+size_t MappedLogFile::dataLength(const void* file_data, size_t file_size)
+{
+    if (file_size < sizeof(Trailer)) return file_size;
+
+    Trailer trailer;
+    std::memcpy(&trailer,
+                static_cast<const unsigned char*>(file_data) + file_size - sizeof(Trailer),
+                sizeof(Trailer));
+    return trailerLength(trailer, file_size);
+}
+
+size_t MappedLogFile::recoverLength()
+{
+    size_t  file_size   = 0;
+    Trailer trailer     = {};
+    bool    has_trailer = false;
+
+#if defined(_WIN32) || defined(_WIN64)
+    LARGE_INTEGER size;
+    if (!::GetFileSizeEx(file_, &size)) {
+        throwFileError("failed reading the size of", filename_);
+    }
+    file_size = static_cast<size_t>(size.QuadPart);
+    if (file_size >= sizeof(Trailer)) {
+        uint64_t   offset = file_size - sizeof(Trailer);
+        OVERLAPPED at     = {};
+        DWORD      read   = 0;
+        at.Offset         = static_cast<DWORD>(offset);
+        at.OffsetHigh     = static_cast<DWORD>(offset >> 32);
+        has_trailer       = ::ReadFile(file_, &trailer, sizeof(Trailer), &read, &at) &&
+                      read == sizeof(Trailer);
+    }
+#else
+    struct stat info;
+    if (::fstat(fd_, &info) != 0) {
+        throwFileError("failed reading the size of", filename_);
+    }
+    file_size = static_cast<size_t>(info.st_size);
+    if (file_size >= sizeof(Trailer)) {
+        has_trailer = ::pread(fd_, &trailer, sizeof(Trailer), file_size - sizeof(Trailer)) ==
+                      static_cast<ssize_t>(sizeof(Trailer));
+    }
+#endif
+
+    // a trailer means the previous writer did not get to close(), keep only its data
+    return has_trailer ? trailerLength(trailer, file_size) : file_size;
+}
+
+void MappedLogFile::map(size_t data_capacity)
+{
+    capacity_         = roundUp8(data_capacity);
+    size_t total_size = capacity_ + sizeof(Trailer);
+
+#if defined(_WIN32) || defined(_WIN64)
+    LARGE_INTEGER end;
+    end.QuadPart = static_cast<LONGLONG>(total_size);
+    if (!::SetFilePointerEx(file_, end, nullptr, FILE_BEGIN) || !::SetEndOfFile(file_)) {
+        throwFileError("failed preallocating", filename_);
+    }
+
+    mapping_ = ::CreateFileMappingW(file_,
+                                    nullptr,
+                                    PAGE_READWRITE,
+                                    static_cast<DWORD>(static_cast<uint64_t>(total_size) >> 32),
+                                    static_cast<DWORD>(total_size),
+                                    nullptr);
+    if (!mapping_) {
+        throwFileError("failed mapping", filename_);
+    }
+    void* data = ::MapViewOfFile(mapping_, FILE_MAP_WRITE, 0, 0, total_size);
+    if (!data) {
+        ::CloseHandle(mapping_);
+        mapping_ = nullptr;
+        throwFileError("failed mapping", filename_);
+    }
+    data_ = static_cast<unsigned char*>(data);
+#else
+    if (::ftruncate(fd_, static_cast<off_t>(total_size)) != 0) {
+        throwFileError("failed preallocating", filename_);
+    }
+#    if defined(__linux__) && !defined(__ANDROID__)
+    // NOTE: best effort, reserving real blocks turns a full disk into an error here instead of
+    // SIGBUS on a later memcpy; not every file system supports it
+    (void)::posix_fallocate(fd_, 0, static_cast<off_t>(total_size));
+#    endif
+
+    void* data = ::mmap(nullptr, total_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (data == MAP_FAILED) {
+        throwFileError("failed mapping", filename_);
+    }
+    data_ = static_cast<unsigned char*>(data);
+#endif
+
+    unsigned char* trailer = data_ + capacity_;
+    std::memcpy(trailer + offsetof(Trailer, magic), kTrailerMagic, sizeof(kTrailerMagic));
+    writeTrailer();
+}
+
+void MappedLogFile::unmap()
+{
+    if (!data_) return;
+
+#if defined(_WIN32) || defined(_WIN64)
+    ::UnmapViewOfFile(data_);
+    ::CloseHandle(mapping_);
+    mapping_ = nullptr;
+#else
+    ::munmap(data_, capacity_ + sizeof(Trailer));
+#endif
+    data_ = nullptr;
+}
+
+void MappedLogFile::release()
+{
+    unmap();
+
+#if defined(_WIN32) || defined(_WIN64)
+    if (file_) ::CloseHandle(file_);
+    file_ = nullptr;
+#else
+    if (fd_ >= 0) ::close(fd_);
+    fd_ = -1;
+#endif
+    length_ = 0;
+}
+
+void MappedLogFile::writeTrailer()
+{
+    uint64_t length = length_;
+    std::memcpy(data_ + capacity_ + offsetof(Trailer, length), &length, sizeof(length));
+}
+
+}   // namespace mlogger
@@ -0,0 +1,66 @@
+#ifndef MAPPED_LOG_FILE_H
+#define MAPPED_LOG_FILE_H
+
+#include "log_file.h"
+#include <cstdint>
+
+namespace mlogger
+{
+
+// LogFile that preallocates the file, maps it into memory and appends with memcpy, so writing
+// and flushing cost no syscalls. The mapping is shared with the page cache, records survive a
+// crash of the process (not of the OS) without any flush.
+//
+// While open the file is larger than its data and ends with a trailer holding the data length;
+// close() truncates it to the data. A file left behind by a crash is trimmed on the next open.
+class MappedLogFile final : public LogFile
+{
+public:
+    // `capacity` is how many bytes of data to preallocate per file
+    explicit MappedLogFile(size_t capacity);
+    ~MappedLogFile() override;
+
+    void                      open(const spdlog::filename_t& filename, bool truncate) override;
+    void                      close() override;
+    void                      write(const spdlog::memory_buf_t& buffer) override;
+    void                      flush() override;
+    size_t                    size() const override;
+    const spdlog::filename_t& filename() const override;
+
+    // Data bytes of a whole file held in memory, `file_size` unless it ends with the trailer of a
+    // file still open (or left behind by a crash).
+    static size_t dataLength(const void* file_data, size_t file_size);
+
+    MappedLogFile(const MappedLogFile&)            = delete;
+    MappedLogFile& operator=(const MappedLogFile&) = delete;
+
+private:
+    struct Trailer {
+        uint64_t length;
+        char     magic[8];
+    };
+
+    size_t recoverLength();
+    void   map(size_t data_capacity);
+    void   unmap();
+    // closes the file as it is, without trimming it
+    void release();
+    void writeTrailer();
+
+    size_t             capacity_hint_;
+    spdlog::filename_t filename_;
+    unsigned char*     data_     = nullptr;
+    size_t             capacity_ = 0;   // data bytes the current mapping holds
+    size_t             length_   = 0;   // data bytes written
+
+#if defined(_WIN32) || defined(_WIN64)
+    void* file_    = nullptr;
+    void* mapping_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+};
+
+}   // namespace mlogger
+
+#endif   // MAPPED_LOG_FILE_H
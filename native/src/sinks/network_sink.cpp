@@ -0,0 +1,393 @@
+#include "network_sink.h"
+#include "core/deferred_format.h"
+#include "core/logger_stats.h"
+#include "log_compressor.h"
+#include <algorithm>
+#include <cstring>
+#include <random>
+
+namespace mlogger
+{
+
+namespace
+{
+
+constexpr char    kMagic[4]     = {'M', 'L', 'G', 'F'};
+constexpr uint8_t kVersion      = 1;
+constexpr size_t  kMaxDatagram  = 65507;
+constexpr size_t  kMaxPayload   = 64 * 1024 * 1024;   // anything larger is taken as garbage
+constexpr int     kPollInterval = 100;                // ms between checks of a full socket
+// NOTE: the logger name of the notices, the default logger's
+constexpr char kNoticeLogger[] = "mlogger";
+
+void putU16(char* dest, uint16_t value)
+{
+    dest[0] = static_cast<char>(value & 0xff);
+    dest[1] = static_cast<char>(value >> 8);
+}
+
+void putU32(char* dest, uint32_t value)
+{
+    for (int i = 0; i < 4; ++i) {
+        dest[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+    }
+}
+
+uint32_t getU32(const char* source)
+{
+    uint32_t value = 0;
+    for (int i = 3; i >= 0; --i) {
+        value = (value << 8) | static_cast<uint8_t>(source[i]);
+    }
+    return value;
+}
+
+uint16_t getU16(const char* source)
+{
+    return static_cast<uint16_t>(static_cast<uint8_t>(source[0]) |
+                                 (static_cast<uint8_t>(source[1]) << 8));
+}
+
+bool setError(std::string* error, const char* message)
+{
+    if (error) *error = message;
+    return false;
+}
+
+uint32_t randomSession()
+{
+    std::random_device device;
+    auto               now = std::chrono::steady_clock::now().time_since_epoch().count();
+    return device() ^ static_cast<uint32_t>(now) ^ static_cast<uint32_t>(now >> 32);
+}
+
+size_t effectiveFrameSize(NetworkProtocol protocol, size_t frame_size)
+{
+    if (protocol == NetworkProtocol::udp) {
+        // NOTE: room for the header and a notice, compressed frames are sent raw when larger
+        size_t size = frame_size > 0 ? frame_size : NetworkSink::kUdpFrameSize;
+        return std::min(size, kMaxDatagram - NetworkSink::kHeaderSize - 256);
+    }
+    return frame_size > 0 ? frame_size : NetworkSink::kTcpFrameSize;
+}
+
+}   // namespace
+
+NetworkSink::NetworkSink(std::string address, NetworkProtocol protocol, size_t frame_size,
+                         size_t buffer_size, Compression compression, ErrorHandler error_handler,
+                         std::function<void()> on_thread_start)
+    : address_(std::move(address))
+    , protocol_(protocol)
+    , frame_size_(effectiveFrameSize(protocol, frame_size))
+    , compression_(compression)
+    , error_handler_(std::move(error_handler))
+    , on_thread_start_(std::move(on_thread_start))
+    , frames_(std::max(buffer_size / frame_size_, kMinFrames))
+    , session_(randomSession())
+{
+    if (compression_ != Compression::none && LogCompressor::isAvailable(compression_)) {
+        compressor_ = std::make_unique<BufferCompressor>(compression_);
+    }
+    batch_.reserve(frame_size_);
+    sender_ = std::thread([this]() { senderLoop(); });
+}
+
+NetworkSink::~NetworkSink()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queueBatch();
+    }
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        stop_         = true;
+        linger_until_ = Clock::now() + kLingerTimeout;
+    }
+    queue_cv_.notify_all();
+    if (sender_.joinable()) sender_.join();
+}
+
+void NetworkSink::sink_it_(const spdlog::details::log_msg& msg)
+{
+    formatted_.clear();
+    if (needsRendering(msg)) {
+        text_.clear();
+        appendPayloadText(msg.source.funcname, msg.payload, text_);
+
+        spdlog::details::log_msg text_msg(msg);
+        text_msg.payload = spdlog::string_view_t(text_.data(), text_.size());
+        formatter_->format(text_msg, formatted_);
+    } else {
+        formatter_->format(msg, formatted_);
+    }
+
+    // NOTE: an oversized line keeps its start and its line ending, the file has all of it
+    if (formatted_.size() > frame_size_) {
+        formatted_.resize(frame_size_);
+        formatted_[frame_size_ - 1] = '\n';
+    }
+
+    if (!batch_.empty() &&
+        (batch_.size() + formatted_.size() > frame_size_ || batch_records_ == UINT16_MAX)) {
+        queueBatch();
+    }
+    if (batch_.empty() && unshipped_ > 0) {
+        appendNotice(msg);
+    }
+    batch_.append(formatted_.data(), formatted_.size());
+    ++batch_records_;
+}
+
+void NetworkSink::flush_()
+{
+    // NOTE: hands the partial frame over without waiting for the network
+    queueBatch();
+}
+
+void NetworkSink::queueBatch()
+{
+    if (batch_.empty()) {
+        return;
+    }
+
+    bool queued = false;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        if (count_ < frames_.size()) {
+            // NOTE: swapped, the frame's old buffer becomes the next batch
+            Frame& frame = frames_[(head_ + count_) % frames_.size()];
+            frame.text.swap(batch_);
+            frame.records = batch_records_;
+            ++count_;
+            queued = true;
+        }
+    }
+
+    if (queued) {
+        queue_cv_.notify_one();
+    } else {
+        unshipped_ += batch_notice_ + batch_records_;
+        countUnshipped(batch_records_);
+    }
+    batch_.clear();
+    batch_records_ = 0;
+    batch_notice_  = 0;
+}
+
+void NetworkSink::appendNotice(const spdlog::details::log_msg& msg)
+{
+    std::string text = std::to_string(unshipped_) + " records not shipped, see the log file";
+    spdlog::details::log_msg notice(msg.time, spdlog::source_loc{}, kNoticeLogger,
+                                    spdlog::level::warn, text);
+    text_.clear();
+    formatter_->format(notice, text_);
+    batch_.append(text_.data(), text_.size());
+    batch_notice_ = unshipped_;
+    unshipped_    = 0;
+}
+
+void NetworkSink::senderLoop()
+{
+    if (on_thread_start_) on_thread_start_();
+
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    for (;;) {
+        queue_cv_.wait(lock, [this]() { return stop_ || count_ > 0; });
+        if (count_ == 0 || (stop_ && Clock::now() >= linger_until_)) {
+            break;
+        }
+
+        // NOTE: the backend never touches a queued frame, it is read without the lock
+        const Frame&      frame    = frames_[head_];
+        bool              stopping = stop_;
+        Clock::time_point deadline = stopping ? linger_until_ : Clock::time_point::max();
+        lock.unlock();
+        bool done = sendFrame(frame, deadline);
+        lock.lock();
+
+        if (done) {
+            head_ = (head_ + 1) % frames_.size();
+            --count_;
+        } else {
+            // waits for the next connection attempt, woken early only by the destructor
+            queue_cv_.wait_until(lock, stopping ? linger_until_ : retry_at_,
+                                 [this, stopping]() { return stop_ != stopping; });
+        }
+    }
+
+    // NOTE: frames still queued once the linger time is over stay in the log file only
+    uint64_t left = 0;
+    for (; count_ > 0; --count_, head_ = (head_ + 1) % frames_.size()) {
+        left += frames_[head_].records;
+    }
+    lock.unlock();
+    countUnshipped(left);
+    closeSocket(socket_);
+    socket_ = kInvalidSocket;
+}
+
+bool NetworkSink::sendFrame(const Frame& frame, Clock::time_point deadline)
+{
+    if (socket_ == kInvalidSocket && !connect(deadline)) {
+        return false;
+    }
+
+    buildPacket(frame);
+    bool              udp      = protocol_ == NetworkProtocol::udp;
+    size_t            offset   = 0;
+    Clock::time_point progress = Clock::now();
+    while (offset < packet_.size()) {
+        long sent = sendSocket(socket_, packet_.data() + offset, packet_.size() - offset);
+        if (sent > 0) {
+            // NOTE: a datagram goes out whole or not at all
+            offset   = udp ? packet_.size() : offset + static_cast<size_t>(sent);
+            progress = Clock::now();
+            continue;
+        }
+
+        bool failed = sent != kSocketWouldBlock;
+        auto now    = Clock::now();
+        if (!failed && now < deadline && now - progress < kStallTimeout) {
+            waitSocket(socket_, true, kPollInterval);
+            continue;
+        }
+
+        if (udp) {
+            // NOTE: a refused datagram (nothing listening, a full socket) loses only its frame
+            reportError(failed ? "Cannot send to " + address_ + ": " + socketError()
+                               : "Cannot send to " + address_ + ": socket full");
+            ++sequence_;
+            countUnshipped(frame.records);
+            return true;
+        }
+        disconnect(failed ? "Connection to " + address_ + " lost: " + socketError()
+                          : "Collector at " + address_ + " stopped reading");
+        return false;
+    }
+
+    ++sequence_;
+    reported_ = false;
+    if (stats_) stats_->countShipped(frame.records);
+    return true;
+}
+
+bool NetworkSink::connect(Clock::time_point deadline)
+{
+    auto now = Clock::now();
+    if (now < retry_at_ || now >= deadline) {
+        return false;
+    }
+
+    auto timeout = std::chrono::duration_cast<std::chrono::milliseconds>(kStallTimeout);
+    if (deadline != Clock::time_point::max()) {
+        timeout = std::min(
+            timeout, std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now));
+    }
+
+    std::string error;
+    SocketType  type = protocol_ == NetworkProtocol::udp ? SocketType::udp : SocketType::tcp;
+    socket_          = connectSocket(address_, type, static_cast<int>(timeout.count()), error);
+    if (socket_ == kInvalidSocket) {
+        retry_at_ = Clock::now() + kReconnectInterval;
+        reportError(error + ", records stay in the log file");
+        return false;
+    }
+    if (type == SocketType::tcp) {
+        setSendBuffer(socket_, kTcpWindowFrames * (frame_size_ + kHeaderSize));
+    }
+    return true;
+}
+
+void NetworkSink::disconnect(const std::string& reason)
+{
+    closeSocket(socket_);
+    socket_   = kInvalidSocket;
+    retry_at_ = Clock::now() + kReconnectInterval;
+    reportError(reason + ", records stay in the log file");
+}
+
+void NetworkSink::buildPacket(const Frame& frame)
+{
+    const std::string* payload = &frame.text;
+    Compression        codec   = Compression::none;
+    if (compressor_) {
+        compressed_.clear();
+        // NOTE: short frames may grow, those go out as they are
+        if (compressor_->compress(frame.text.data(), frame.text.size(), compressed_) &&
+            compressed_.size() < frame.text.size()) {
+            payload = &compressed_;
+            codec   = compression_;
+        }
+    }
+
+    char header[kHeaderSize];
+    std::memcpy(header, kMagic, sizeof(kMagic));
+    header[4] = static_cast<char>(kVersion);
+    header[5] = static_cast<char>(codec);
+    putU16(header + 6, frame.records);
+    putU32(header + 8, session_);
+    putU32(header + 12, sequence_);
+    putU32(header + 16, static_cast<uint32_t>(payload->size()));
+    putU32(header + 20, static_cast<uint32_t>(frame.text.size()));
+
+    packet_.clear();
+    packet_.append(header, kHeaderSize);
+    packet_.append(*payload);
+}
+
+void NetworkSink::reportError(const std::string& message)
+{
+    // NOTE: once per outage, a collector that is down would otherwise report every second
+    if (reported_) return;
+    reported_ = true;
+    if (error_handler_) error_handler_(message.c_str());
+}
+
+void NetworkSink::countUnshipped(uint64_t records)
+{
+    if (stats_ && records > 0) stats_->countUnshipped(records);
+}
+
+long NetworkSink::decodeFrame(const char* data, size_t size, NetworkFrame& frame,
+                              std::string* error)
+{
+    if (size < kHeaderSize) {
+        return 0;
+    }
+    if (std::memcmp(data, kMagic, sizeof(kMagic)) != 0 ||
+        static_cast<uint8_t>(data[4]) != kVersion) {
+        setError(error, "not an MLogger frame");
+        return -1;
+    }
+
+    auto     codec        = static_cast<Compression>(static_cast<uint8_t>(data[5]));
+    uint32_t payload_size = getU32(data + 16);
+    uint32_t text_size    = getU32(data + 20);
+    if (payload_size > kMaxPayload || text_size > kMaxPayload) {
+        setError(error, "frame too large");
+        return -1;
+    }
+    if (size - kHeaderSize < payload_size) {
+        return 0;
+    }
+
+    frame.records  = getU16(data + 6);
+    frame.session  = getU32(data + 8);
+    frame.sequence = getU32(data + 12);
+    const char* payload = data + kHeaderSize;
+    if (codec == Compression::none) {
+        frame.text.assign(payload, payload_size);
+    } else if (codec != Compression::gzip && codec != Compression::zstd) {
+        setError(error, "unknown codec");
+        return -1;
+    } else if (!LogCompressor::decompressBuffer(payload, payload_size, frame.text, error)) {
+        return -1;
+    }
+    if (frame.text.size() != text_size) {
+        setError(error, "frame text size mismatch");
+        return -1;
+    }
+    return static_cast<long>(kHeaderSize + payload_size);
+}
+
+}   // namespace mlogger
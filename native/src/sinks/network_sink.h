@@ -0,0 +1,156 @@
+#ifndef NETWORK_SINK_H
+#define NETWORK_SINK_H
+
+#include "core/logger_config.h"
+#include "utils/socket_utils.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <spdlog/sinks/base_sink.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace mlogger
+{
+
+class BufferCompressor;
+class LogStats;
+
+// a frame decoded by NetworkSink::decodeFrame()
+struct NetworkFrame {
+    uint32_t    session  = 0;
+    uint32_t    sequence = 0;
+    uint16_t    records  = 0;
+    std::string text;   // lines as in the text file
+};
+
+// Ships every record to a collector over UDP or TCP, see LoggerConfig::network_address.
+//
+// The backend thread formats records like the text file and packs them into frames of up to
+// `frame_size` bytes. Full frames, and partial ones on flush, are handed to a fixed set of
+// buffers that a sender thread of its own compresses and sends, so neither the producers nor the
+// backend thread ever wait for the network. While the collector is unreachable or stops reading,
+// frames wait in the buffers; once all of them are taken, new records are not shipped. They are
+// counted (LoggerStats::unshipped) and announced at the start of the next frame that is. The log
+// file always gets every record.
+//
+// UDP sends one frame per datagram and drops a frame the socket refuses. TCP keeps at most
+// kTcpWindowFrames frames in the kernel's send buffer; a connection that accepts nothing for
+// kStallTimeout is dropped and the frame it was on sent again on the next one. Connections are
+// retried every kReconnectInterval.
+//
+// Frame layout, little-endian; TCP frames follow each other on the stream:
+//   0  char[4]  "MLGF"
+//   4  u8       version, 1
+//   5  u8       codec of the payload, a Compression value
+//   6  u16      records in the frame
+//   8  u32      session, random per sink
+//   12 u32      sequence, counts up from 0 per session, gaps are lost frames
+//   16 u32      payload bytes following the header
+//   20 u32      text bytes once decompressed
+class NetworkSink final : public spdlog::sinks::base_sink<std::mutex>
+{
+public:
+    using ErrorHandler = std::function<void(const char*)>;
+
+    static constexpr size_t kHeaderSize = 24;
+    // record bytes per frame when none are given, a UDP frame fits an Internet MTU
+    static constexpr size_t kUdpFrameSize      = 1200;
+    static constexpr size_t kTcpFrameSize      = 64 * 1024;
+    static constexpr size_t kMinFrames         = 4;
+    static constexpr size_t kTcpWindowFrames   = 4;
+    static constexpr auto   kStallTimeout      = std::chrono::seconds(5);
+    static constexpr auto   kReconnectInterval = std::chrono::seconds(1);
+    // how long the destructor goes on sending what is queued
+    static constexpr auto   kLingerTimeout     = std::chrono::seconds(1);
+
+    // `frame_size` 0 = the protocol's default; `buffer_size` bytes of frames wait for the
+    // network, at least kMinFrames; `compression` must be available, see LogCompressor
+    NetworkSink(std::string address, NetworkProtocol protocol, size_t frame_size,
+                size_t buffer_size, Compression compression, ErrorHandler error_handler = nullptr,
+                std::function<void()> on_thread_start = nullptr);
+    ~NetworkSink() override;
+
+    // counts shipped and unshipped records, set before the first record
+    void setStats(LogStats* stats) { stats_ = stats; }
+
+    // Decodes the frame at the start of `data`: the bytes it takes, 0 when `size` holds only part
+    // of it, -1 when `data` is not a valid frame.
+    static long decodeFrame(const char* data, size_t size, NetworkFrame& frame,
+                            std::string* error = nullptr);
+
+    NetworkSink(const NetworkSink&)            = delete;
+    NetworkSink& operator=(const NetworkSink&) = delete;
+
+protected:
+    void sink_it_(const spdlog::details::log_msg& msg) override;
+    void flush_() override;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Frame {
+        std::string text;
+        uint16_t    records = 0;
+    };
+
+    // hands batch_ to the sender, or counts it unshipped when every frame is taken
+    void queueBatch();
+    // "N records not shipped" at the start of batch_
+    void appendNotice(const spdlog::details::log_msg& msg);
+    void senderLoop();
+    // true once `frame` is done with (sent, or dropped by UDP); false leaves it queued
+    bool sendFrame(const Frame& frame, Clock::time_point deadline);
+    bool connect(Clock::time_point deadline);
+    void disconnect(const std::string& reason);
+    void buildPacket(const Frame& frame);
+    void reportError(const std::string& message);
+    void countUnshipped(uint64_t records);
+
+    const std::string     address_;
+    const NetworkProtocol protocol_;
+    const size_t          frame_size_;
+    const Compression     compression_;
+    ErrorHandler          error_handler_;
+    std::function<void()> on_thread_start_;
+    LogStats*             stats_ = nullptr;
+
+    // backend side, guarded by the sink's mutex_
+    std::string          batch_;
+    uint16_t             batch_records_ = 0;
+    uint64_t             batch_notice_  = 0;   // unshipped records announced in batch_
+    uint64_t             unshipped_     = 0;   // not announced yet
+    spdlog::memory_buf_t formatted_;
+    spdlog::memory_buf_t text_;   // rendered structured or formatted payload
+
+    // frames [head_, head_ + count_) are the sender's, the others the backend's; guarded by
+    // queue_mutex_
+    std::mutex              queue_mutex_;
+    std::condition_variable queue_cv_;
+    std::vector<Frame>      frames_;
+    size_t                  head_  = 0;
+    size_t                  count_ = 0;
+    bool                    stop_  = false;
+    Clock::time_point       linger_until_;
+
+    // sender thread only
+    std::unique_ptr<BufferCompressor> compressor_;
+    std::string                       packet_;
+    std::string                       compressed_;
+    SocketHandle                      socket_ = kInvalidSocket;
+    Clock::time_point                 retry_at_;
+    bool                              reported_ = false;   // the current outage was reported
+    uint32_t                          session_  = 0;
+    uint32_t                          sequence_ = 0;
+
+    std::thread sender_;
+};
+
+}   // namespace mlogger
+
+#endif   // NETWORK_SINK_H
@@ -0,0 +1,119 @@
+#include "overflow_sink.h"
+#include <algorithm>
+#include <string>
+
+namespace mlogger
+{
+
+OverflowSink::OverflowSink(spdlog::sink_ptr target, OverflowPolicy policy, size_t queue_size,
+                           spdlog::details::thread_pool* pool)
+    : target_(std::move(target))
+    , policy_(policy)
+    , queue_size_(queue_size)
+    , pool_(pool)
+{
+}
+
+bool OverflowSink::tryAdmit()
+{
+    if (pending_.fetch_add(1, std::memory_order_relaxed) >= queue_size_) {
+        pending_.fetch_sub(1, std::memory_order_relaxed);
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+uint64_t OverflowSink::droppedCount() const
+{
+    uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+    if (policy_ == OverflowPolicy::overrun_oldest && pool_) {
+        dropped += pool_->overrun_counter();
+    }
+    return dropped;
+}
+
+uint64_t OverflowSink::queueDepth() const
+{
+    return pool_ ? pool_->queue_size() : 0;
+}
+
+uint64_t OverflowSink::queueHighWater() const
+{
+    return std::max(high_water_.load(std::memory_order_relaxed), queueDepth());
+}
+
+void OverflowSink::log(const spdlog::details::log_msg& msg)
+{
+    if (policy_ == OverflowPolicy::drop_newest) {
+        pending_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    if (target_->should_log(msg.level)) {
+        target_->log(msg);
+    }
+
+    // NOTE: the pool counters take the queue lock, so only look every few records
+    size_t depth      = 0;
+    bool   check_pool = false;
+    if (pool_) {
+        uint32_t count = since_check_.fetch_add(1, std::memory_order_relaxed);
+        check_pool     = count % kQueueCheckInterval == 0;
+    }
+    if (check_pool) {
+        depth         = pool_->queue_size();
+        uint64_t peak = high_water_.load(std::memory_order_relaxed);
+        while (depth > peak &&
+               !high_water_.compare_exchange_weak(peak, depth, std::memory_order_relaxed)) {
+        }
+    }
+
+    bool recovered = false;
+    if (policy_ == OverflowPolicy::drop_newest) {
+        recovered = dropped_.load(std::memory_order_relaxed) !=
+                        reported_.load(std::memory_order_relaxed) &&
+                    pending_.load(std::memory_order_relaxed) < queue_size_ / 2;
+    } else if (policy_ == OverflowPolicy::overrun_oldest && check_pool) {
+        recovered = pool_->overrun_counter() != reported_.load(std::memory_order_relaxed) &&
+                    depth < queue_size_ / 2;
+    }
+
+    if (recovered) {
+        reportDrops(msg);
+    }
+}
+
+void OverflowSink::flush()
+{
+    target_->flush();
+}
+
+void OverflowSink::set_pattern(const std::string& pattern)
+{
+    target_->set_pattern(pattern);
+}
+
+void OverflowSink::set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter)
+{
+    target_->set_formatter(std::move(sink_formatter));
+}
+
+void OverflowSink::reportDrops(const spdlog::details::log_msg& msg)
+{
+    // NOTE: several pool workers may get here at once, only one of them reports each drop
+    uint64_t total    = droppedCount();
+    uint64_t previous = reported_.load(std::memory_order_relaxed);
+    do {
+        if (total <= previous) {
+            return;
+        }
+    } while (!reported_.compare_exchange_weak(previous, total, std::memory_order_relaxed));
+
+    std::string text = std::to_string(total - previous) + " messages dropped";
+    spdlog::details::log_msg summary(msg.logger_name, spdlog::level::warn, text);
+    if (target_->should_log(summary.level)) {
+        target_->log(summary);
+    }
+}
+
+}   // namespace mlogger
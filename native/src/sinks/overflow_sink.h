@@ -0,0 +1,62 @@
+#ifndef OVERFLOW_SINK_H
+#define OVERFLOW_SINK_H
+
+#include "core/logger_config.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <spdlog/async_logger.h>
+#include <spdlog/details/thread_pool.h>
+#include <spdlog/sinks/sink.h>
+
+namespace mlogger
+{
+
+// Sits between the async thread pool and the real sink. It tracks how many records are queued so
+// producers can drop instead of blocking, and writes a "N messages dropped" line once the queue
+// has drained below half of its capacity again.
+class OverflowSink final : public spdlog::sinks::sink
+{
+public:
+    // `pool` feeds this sink and must outlive it
+    OverflowSink(spdlog::sink_ptr target, OverflowPolicy policy, size_t queue_size,
+                 spdlog::details::thread_pool* pool);
+
+    OverflowPolicy policy() const { return policy_; }
+
+    // producer side for drop_newest, false when the record must be dropped.
+    // Every admitted record has to reach the queue.
+    bool tryAdmit();
+    // records rejected by tryAdmit() plus records overwritten in the thread pool queue
+    uint64_t droppedCount() const;
+    // records waiting in the pool queue, and the most seen at once. The queue is only looked at
+    // every few records, so short peaks may be missed.
+    uint64_t queueDepth() const;
+    uint64_t queueHighWater() const;
+
+    void log(const spdlog::details::log_msg& msg) override;
+    void flush() override;
+    void set_pattern(const std::string& pattern) override;
+    void set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) override;
+
+private:
+    static constexpr uint32_t kQueueCheckInterval = 64;
+
+    void reportDrops(const spdlog::details::log_msg& msg);
+
+    spdlog::sink_ptr              target_;
+    OverflowPolicy                policy_;
+    size_t                        queue_size_;
+    spdlog::details::thread_pool* pool_;
+
+    std::atomic<size_t>   pending_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> reported_{0};
+    std::atomic<uint32_t> since_check_{0};
+    std::atomic<uint64_t> high_water_{0};
+};
+
+}   // namespace mlogger
+
+#endif   // OVERFLOW_SINK_H
@@ -0,0 +1,321 @@
+#include "ring_buffer_sink.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <spdlog/details/os.h>
+#include <thread>
+
+#if defined(_WIN32) || defined(_WIN64)
+#    include <windows.h>
+#else
+#    include <fcntl.h>
+#    include <unistd.h>
+#endif
+
+namespace mlogger
+{
+
+namespace
+{
+
+constexpr size_t   kMinCapacity    = 4096;
+constexpr uint8_t  kTruncated      = 1;
+constexpr uint32_t kCrashLockSpins = 10000;
+
+size_t roundUpPow2(size_t value)
+{
+    size_t result = kMinCapacity;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+// Buffered writer over the raw file API, usable from a signal handler.
+class DumpFile final
+{
+public:
+    explicit DumpFile(const char* path)
+    {
+#if defined(_WIN32) || defined(_WIN64)
+        file_ = ::CreateFileA(path,
+                              GENERIC_WRITE,
+                              FILE_SHARE_READ,
+                              nullptr,
+                              CREATE_ALWAYS,
+                              FILE_ATTRIBUTE_NORMAL,
+                              nullptr);
+        failed_ = file_ == INVALID_HANDLE_VALUE;
+#else
+        fd_     = ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        failed_ = fd_ < 0;
+#endif
+    }
+
+    ~DumpFile() { close(); }
+
+    bool isOpen() const { return !failed_; }
+
+    void append(const char* data, size_t size)
+    {
+        while (size > 0) {
+            if (used_ == sizeof(buffer_)) {
+                writeOut();
+            }
+            size_t chunk = std::min(size, sizeof(buffer_) - used_);
+            std::memcpy(buffer_ + used_, data, chunk);
+            used_ += chunk;
+            data += chunk;
+            size -= chunk;
+        }
+    }
+
+    void append(spdlog::string_view_t text) { append(text.data(), text.size()); }
+
+    void appendNumber(uint64_t value, int width = 1)
+    {
+        char digits[20];
+        int  count = 0;
+        do {
+            digits[count++] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value > 0);
+        for (; width > count; --width) {
+            append("0", 1);
+        }
+        while (count > 0) {
+            append(&digits[--count], 1);
+        }
+    }
+
+    // false when the file could not be opened or a write failed
+    bool close()
+    {
+        writeOut();
+#if defined(_WIN32) || defined(_WIN64)
+        if (file_ != INVALID_HANDLE_VALUE) ::CloseHandle(file_);
+        file_ = INVALID_HANDLE_VALUE;
+#else
+        if (fd_ >= 0) ::close(fd_);
+        fd_ = -1;
+#endif
+        return !failed_;
+    }
+
+private:
+    void writeOut()
+    {
+        const char* data = buffer_;
+        size_t      size = used_;
+        used_            = 0;
+        while (size > 0 && !failed_) {
+#if defined(_WIN32) || defined(_WIN64)
+            DWORD written = 0;
+            if (!::WriteFile(file_, data, static_cast<DWORD>(size), &written, nullptr)) {
+                failed_ = true;
+                break;
+            }
+#else
+            ssize_t written = ::write(fd_, data, size);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                failed_ = true;
+                break;
+            }
+#endif
+            data += written;
+            size -= static_cast<size_t>(written);
+        }
+    }
+
+    char   buffer_[4096];
+    size_t used_   = 0;
+    bool   failed_ = false;
+#if defined(_WIN32) || defined(_WIN64)
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+#else
+    int fd_ = -1;
+#endif
+};
+
+// NOTE: hand-rolled UTC conversion, gmtime/localtime are not async-signal-safe
+void appendTimestamp(DumpFile& file, int64_t time_ns)
+{
+    int64_t seconds = time_ns / 1000000000;
+    int64_t nanos   = time_ns % 1000000000;
+    if (nanos < 0) {
+        seconds -= 1;
+        nanos += 1000000000;
+    }
+    int64_t days      = seconds / 86400;
+    int64_t remainder = seconds % 86400;
+    if (remainder < 0) {
+        days -= 1;
+        remainder += 86400;
+    }
+
+    // days since 1970-01-01 to a civil date, see howardhinnant.github.io/date_algorithms.html
+    days += 719468;
+    int64_t  era   = (days >= 0 ? days : days - 146096) / 146097;
+    unsigned doe   = static_cast<unsigned>(days - era * 146097);
+    unsigned yoe   = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    unsigned doy   = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    unsigned mp    = (5 * doy + 2) / 153;
+    unsigned day   = doy - (153 * mp + 2) / 5 + 1;
+    unsigned month = mp < 10 ? mp + 3 : mp - 9;
+    int64_t  year  = static_cast<int64_t>(yoe) + era * 400 + (month <= 2 ? 1 : 0);
+
+    file.append("[", 1);
+    file.appendNumber(static_cast<uint64_t>(std::max<int64_t>(year, 0)), 4);
+    file.append("-", 1);
+    file.appendNumber(month, 2);
+    file.append("-", 1);
+    file.appendNumber(day, 2);
+    file.append(" ", 1);
+    file.appendNumber(static_cast<uint64_t>(remainder / 3600), 2);
+    file.append(":", 1);
+    file.appendNumber(static_cast<uint64_t>(remainder / 60 % 60), 2);
+    file.append(":", 1);
+    file.appendNumber(static_cast<uint64_t>(remainder % 60), 2);
+    file.append(".", 1);
+    file.appendNumber(static_cast<uint64_t>(nanos / 1000), 6);
+    file.append("] ", 2);
+}
+
+}   // namespace
+
+RingBufferSink::RingBufferSink(size_t capacity)
+    : capacity_(roundUpPow2(capacity))
+    , mask_(capacity_ - 1)
+    , max_text_(std::min<size_t>(UINT16_MAX, capacity_ / 4 - sizeof(Header)))
+{
+    data_ = std::make_unique<unsigned char[]>(capacity_);
+}
+
+void RingBufferSink::record(spdlog::log_clock::time_point time, spdlog::level::level_enum level,
+                            spdlog::string_view_t payload)
+{
+    store(time, spdlog::details::os::thread_id(), level, payload);
+}
+
+bool RingBufferSink::dump(const char* path, bool crashing)
+{
+    if (!path || !*path) {
+        return false;
+    }
+
+    DumpFile file(path);
+    if (!file.isOpen()) {
+        return false;
+    }
+
+    // NOTE: producers wait while the ring is written out, dumps are rare
+    bool     locked   = lock(crashing);
+    uint64_t position = tail_;
+    uint64_t end      = head_;
+    while (end - position >= sizeof(Header)) {
+        Header header;
+        copyOut(position, &header, sizeof(header));
+        uint64_t next = position + sizeof(Header) + header.length;
+        if (next > end || header.level >= spdlog::level::n_levels) {
+            break;   // torn record, only possible when reading without the lock
+        }
+
+        appendTimestamp(file, header.time_ns);
+        file.append("[", 1);
+        file.append(spdlog::level::to_string_view(
+            static_cast<spdlog::level::level_enum>(header.level)));
+        file.append("] [", 3);
+        file.appendNumber(header.thread_id);
+        file.append("] ", 2);
+
+        size_t offset = static_cast<size_t>((position + sizeof(Header)) & mask_);
+        size_t first  = std::min<size_t>(header.length, capacity_ - offset);
+        file.append(reinterpret_cast<const char*>(data_.get()) + offset, first);
+        file.append(reinterpret_cast<const char*>(data_.get()), header.length - first);
+        if (header.flags & kTruncated) {
+            file.append(" [truncated]", 12);
+        }
+        file.append("\n", 1);
+        position = next;
+    }
+    if (locked) {
+        unlock();
+    }
+
+    return file.close();
+}
+
+void RingBufferSink::log(const spdlog::details::log_msg& msg)
+{
+    store(msg.time, msg.thread_id, msg.level, msg.payload);
+}
+
+void RingBufferSink::flush()
+{
+    // nothing to do, records only leave memory through dump()
+}
+
+void RingBufferSink::set_pattern(const std::string&) {}
+
+void RingBufferSink::set_formatter(std::unique_ptr<spdlog::formatter>) {}
+
+void RingBufferSink::store(spdlog::log_clock::time_point time, size_t thread_id,
+                           spdlog::level::level_enum level, spdlog::string_view_t payload)
+{
+    Header header{};
+    header.time_ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+    header.thread_id = static_cast<uint32_t>(thread_id);
+    header.level     = static_cast<uint8_t>(level);
+    header.length    = static_cast<uint16_t>(std::min(payload.size(), max_text_));
+    header.flags     = payload.size() > max_text_ ? kTruncated : 0;
+
+    size_t size = sizeof(Header) + header.length;
+
+    lock(false);
+    while (head_ + size - tail_ > capacity_) {
+        Header oldest;
+        copyOut(tail_, &oldest, sizeof(oldest));
+        tail_ += sizeof(Header) + oldest.length;
+    }
+    copyIn(head_, &header, sizeof(header));
+    copyIn(head_ + sizeof(Header), payload.data(), header.length);
+    head_ += size;
+    unlock();
+}
+
+void RingBufferSink::copyIn(uint64_t position, const void* source, size_t size)
+{
+    size_t offset = static_cast<size_t>(position & mask_);
+    size_t first  = std::min(size, capacity_ - offset);
+    std::memcpy(data_.get() + offset, source, first);
+    std::memcpy(data_.get(), static_cast<const unsigned char*>(source) + first, size - first);
+}
+
+void RingBufferSink::copyOut(uint64_t position, void* dest, size_t size) const
+{
+    size_t offset = static_cast<size_t>(position & mask_);
+    size_t first  = std::min(size, capacity_ - offset);
+    std::memcpy(dest, data_.get() + offset, first);
+    std::memcpy(static_cast<unsigned char*>(dest) + first, data_.get(), size - first);
+}
+
+bool RingBufferSink::lock(bool crashing)
+{
+    for (uint32_t spins = 0; locked_.exchange(true, std::memory_order_acquire); ++spins) {
+        if (crashing && spins >= kCrashLockSpins) {
+            return false;
+        }
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+void RingBufferSink::unlock()
+{
+    locked_.store(false, std::memory_order_release);
+}
+
+}   // namespace mlogger
@@ -0,0 +1,71 @@
+#ifndef RING_BUFFER_SINK_H
+#define RING_BUFFER_SINK_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <spdlog/sinks/sink.h>
+
+namespace mlogger
+{
+
+// Flight recorder: keeps the most recent records of every level in a fixed block of memory, the
+// oldest ones are overwritten. Nothing reaches the disk until dump() writes the ring out as text.
+//
+// dump() may run from a crash handler: it does not allocate, formats times itself (in UTC) and
+// only waits a bounded time for the ring's lock.
+class RingBufferSink final : public spdlog::sinks::sink
+{
+public:
+    // capacity is rounded up to a power of two
+    explicit RingBufferSink(size_t capacity);
+
+    size_t capacity() const { return capacity_; }
+
+    void record(spdlog::log_clock::time_point time, spdlog::level::level_enum level,
+                spdlog::string_view_t payload);
+
+    // Writes the buffered records to `path` as text lines, oldest first, replacing the file.
+    // With `crashing` set, a ring locked by another thread is read anyway after a short wait.
+    bool dump(const char* path, bool crashing = false);
+
+    void log(const spdlog::details::log_msg& msg) override;
+    void flush() override;
+    // the dump has a fixed format
+    void set_pattern(const std::string& pattern) override;
+    void set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) override;
+
+    RingBufferSink(const RingBufferSink&)            = delete;
+    RingBufferSink& operator=(const RingBufferSink&) = delete;
+
+private:
+    struct Header {
+        int64_t  time_ns;
+        uint32_t thread_id;
+        uint8_t  level;
+        uint8_t  flags;
+        uint16_t length;
+    };
+
+    void store(spdlog::log_clock::time_point time, size_t thread_id,
+               spdlog::level::level_enum level, spdlog::string_view_t payload);
+    void copyIn(uint64_t position, const void* source, size_t size);
+    void copyOut(uint64_t position, void* dest, size_t size) const;
+    bool lock(bool crashing);
+    void unlock();
+
+    std::unique_ptr<unsigned char[]> data_;
+    size_t                           capacity_;
+    size_t                           mask_;
+    size_t                           max_text_;
+
+    // positions grow forever, the byte index is position & mask_
+    uint64_t          head_ = 0;   // end of the newest record
+    uint64_t          tail_ = 0;   // start of the oldest record
+    std::atomic<bool> locked_{false};
+};
+
+}   // namespace mlogger
+
+#endif   // RING_BUFFER_SINK_H
@@ -0,0 +1,238 @@
+#include "rotating_file_sink.h"
+#include "core/deferred_format.h"
+#include <cerrno>
+#include <spdlog/details/file_helper.h>
+#include <spdlog/details/os.h>
+#include <spdlog/fmt/fmt.h>
+#include <tuple>
+
+namespace mlogger
+{
+
+namespace
+{
+
+bool renameFile(const spdlog::filename_t& src, const spdlog::filename_t& target)
+{
+    // try to delete the target file in case it already exists
+    (void)spdlog::details::os::remove(target);
+    return spdlog::details::os::rename(src, target) == 0;
+}
+
+}   // namespace
+
+RotatingFileSink::RotatingFileSink(spdlog::filename_t base_filename, size_t max_size,
+                                   size_t max_files, std::unique_ptr<LogFile> file)
+    : base_filename_(std::move(base_filename))
+    , max_size_(max_size)
+    , max_files_(max_files)
+    , file_(file ? std::move(file) : std::make_unique<StdioLogFile>())
+{
+    if (max_size == 0) {
+        spdlog::throw_spdlog_ex("rotating sink constructor: max_size arg cannot be zero");
+    }
+    if (max_files > 200000) {
+        spdlog::throw_spdlog_ex("rotating sink constructor: max_files arg cannot exceed 200000");
+    }
+
+    file_->open(calcFilename(base_filename_, 0), false);
+    current_size_ = file_->size();   // expensive, called only once
+}
+
+spdlog::filename_t RotatingFileSink::calcFilename(const spdlog::filename_t& filename, size_t index)
+{
+    if (index == 0u) {
+        return filename;
+    }
+
+    spdlog::filename_t basename, ext;
+    std::tie(basename, ext) = spdlog::details::file_helper::split_by_extension(filename);
+    return spdlog::fmt_lib::format(SPDLOG_FILENAME_T("{}.{}{}"), basename, index, ext);
+}
+
+spdlog::filename_t RotatingFileSink::filename()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return file_->filename();
+}
+
+void RotatingFileSink::setCompression(Compression codec,
+                                      LogCompressor::ErrorHandler error_handler)
+{
+    compressor_.reset();
+    if (codec == Compression::none) {
+        return;
+    }
+    compressor_ = std::make_unique<LogCompressor>(
+        base_filename_, max_files_, codec, std::move(error_handler));
+    compressor_->queueExisting();
+}
+
+void RotatingFileSink::setIndex(uint32_t block_lines)
+{
+    index_ = std::make_unique<LogIndexWriter>(block_lines);
+    index_->open(base_filename_, current_size_);
+}
+
+void RotatingFileSink::setMaxSize(size_t max_size)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    max_size_ = max_size;
+}
+
+void RotatingFileSink::sink_it_(const spdlog::details::log_msg& msg)
+{
+    if (!file_started_) {
+        startFile(msg);
+    }
+
+    encoded_.clear();
+    encode(msg, encoded_);
+
+    // NOTE: only check the real size when the estimate overflows, and never rotate an empty
+    // file, same as spdlog (full disks)
+    if (current_size_ + encoded_.size() > max_size_) {
+        file_->flush();
+        if (file_->size() > 0) {
+            rotate();
+            startFile(msg);
+
+            // the encoding may depend on what the file already holds
+            encoded_.clear();
+            encode(msg, encoded_);
+        }
+    }
+
+    uint64_t offset = current_size_;
+    write(encoded_);
+    if (index_) index_->add(offset, encoded_.data(), encoded_.size(), msg.time, msg.level);
+}
+
+void RotatingFileSink::flushIfDirty()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (dirty_) {
+        flush_();
+    }
+}
+
+void RotatingFileSink::flush_()
+{
+    file_->flush();
+    if (index_) index_->flush();
+    dirty_ = false;
+    if (stats_) stats_->countFlush();
+}
+
+void RotatingFileSink::encode(const spdlog::details::log_msg& msg, spdlog::memory_buf_t& dest)
+{
+    if (!needsRendering(msg)) {
+        formatter_->format(msg, dest);
+        return;
+    }
+
+    spdlog::details::log_msg text_msg(msg);
+    text_msg.payload = payloadText(msg);
+    formatter_->format(text_msg, dest);
+}
+
+spdlog::string_view_t RotatingFileSink::payloadText(const spdlog::details::log_msg& msg)
+{
+    if (!needsRendering(msg)) {
+        return msg.payload;
+    }
+    text_.clear();
+    appendPayloadText(msg.source.funcname, msg.payload, text_);
+    return {text_.data(), text_.size()};
+}
+
+void RotatingFileSink::beginFile(const spdlog::details::log_msg&, bool, spdlog::memory_buf_t&) {}
+
+void RotatingFileSink::startFile(const spdlog::details::log_msg& first)
+{
+    spdlog::memory_buf_t preamble;
+    beginFile(first, current_size_ == 0, preamble);
+    if (preamble.size() > 0) {
+        write(preamble);
+    }
+    file_started_ = true;
+}
+
+void RotatingFileSink::rotate()
+{
+    using spdlog::details::os::path_exists;
+
+    file_->close();
+    if (index_) index_->close();
+
+    // the compressor reads rotated files by index, they must not move under it
+    std::unique_lock<std::mutex> files_lock;
+    if (compressor_) {
+        files_lock = compressor_->lockFiles();
+    }
+
+    for (size_t i = max_files_; i > 0; --i) {
+        spdlog::filename_t src    = calcFilename(base_filename_, i - 1);
+        spdlog::filename_t target = calcFilename(base_filename_, i);
+        if (compressor_) {
+            // whichever form of file i - 1 exists replaces both forms of file i
+            spdlog::filename_t extension = compressor_->extension();
+            (void)spdlog::details::os::remove(target + extension);
+            if (i > 1 && path_exists(src + extension)) {
+                (void)spdlog::details::os::remove(target);
+                shiftFile(src + extension, target + extension);
+            }
+        }
+        if (path_exists(src)) {
+            shiftFile(src, target);
+        }
+        if (index_) {
+            // NOTE: best effort, a stale index is dropped when its file is reopened
+            spdlog::filename_t src_index    = LogIndexWriter::indexFilename(src);
+            spdlog::filename_t target_index = LogIndexWriter::indexFilename(target);
+            (void)spdlog::details::os::remove(target_index);
+            if (path_exists(src_index)) (void)renameFile(src_index, target_index);
+        }
+    }
+    reopen();
+    if (compressor_) compressor_->rotated();
+    if (stats_) stats_->countRotation();
+}
+
+void RotatingFileSink::shiftFile(const spdlog::filename_t& src, const spdlog::filename_t& target)
+{
+    using spdlog::details::os::filename_to_str;
+
+    if (renameFile(src, target)) {
+        return;
+    }
+
+    // NOTE: retry once after a short delay, antivirus tools on Windows can briefly hold the file
+    // at high rotation rates
+    spdlog::details::os::sleep_for_millis(100);
+    if (!renameFile(src, target)) {
+        // truncate anyway so the file cannot grow beyond its limit
+        reopen();
+        spdlog::throw_spdlog_ex("rotating_file_sink: failed renaming " + filename_to_str(src) +
+                                    " to " + filename_to_str(target),
+                                errno);
+    }
+}
+
+void RotatingFileSink::reopen()
+{
+    file_->open(base_filename_, true);
+    current_size_ = 0;
+    file_started_ = false;
+    if (index_) index_->open(base_filename_, 0);
+}
+
+void RotatingFileSink::write(const spdlog::memory_buf_t& buffer)
+{
+    file_->write(buffer);
+    current_size_ += buffer.size();
+    dirty_ = true;
+    if (stats_) stats_->addBytesWritten(buffer.size());
+}
+
+}   // namespace mlogger
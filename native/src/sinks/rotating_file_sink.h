@@ -0,0 +1,82 @@
+#ifndef ROTATING_FILE_SINK_H
+#define ROTATING_FILE_SINK_H
+
+#include "core/logger_stats.h"
+#include "log_compressor.h"
+#include "log_file.h"
+#include "log_index.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <spdlog/sinks/base_sink.h>
+
+namespace mlogger
+{
+
+// Size based rotation with the same file naming and rename rules as
+// spdlog::sinks::rotating_file_sink (log.txt, log.1.txt, ... log.N.txt). Records are turned into
+// bytes by encode(), which writes formatted text lines unless a subclass overrides it, and written
+// through `file`, a StdioLogFile unless given.
+class RotatingFileSink : public spdlog::sinks::base_sink<std::mutex>
+{
+public:
+    RotatingFileSink(spdlog::filename_t base_filename, size_t max_size, size_t max_files,
+                     std::unique_ptr<LogFile> file = nullptr);
+
+    static spdlog::filename_t calcFilename(const spdlog::filename_t& filename, size_t index);
+    spdlog::filename_t        filename();
+
+    // bytes, rotations and flushes are counted into `stats` when set, before the sink is in use
+    void setStats(LogStats* stats) { stats_ = stats; }
+    // hands every rotated file to a background LogCompressor, also before the sink is in use.
+    // Rotated files left uncompressed by an earlier run are queued right away.
+    void setCompression(Compression codec, LogCompressor::ErrorHandler error_handler = nullptr);
+    // keeps a LogIndexWriter sidecar next to every file, with one block per `block_lines` lines,
+    // also before the sink is in use. Only meaningful for text output.
+    void setIndex(uint32_t block_lines);
+    // rotation size of the records written from now on, for a sink kept across a reconfiguration
+    void setMaxSize(size_t max_size);
+
+    // flushes the file when records were written since the last flush, for periodic flushing
+    // from a thread other than the logging ones
+    void flushIfDirty();
+
+protected:
+    void sink_it_(const spdlog::details::log_msg& msg) override;
+    void flush_() override;
+
+    // bytes for one record in the current file
+    virtual void encode(const spdlog::details::log_msg& msg, spdlog::memory_buf_t& dest);
+    // the record's text: the payload itself, or the rendering of a structured or formatted one
+    // (valid until the next call)
+    spdlog::string_view_t payloadText(const spdlog::details::log_msg& msg);
+    // bytes written once before `first`, the first record of every file opened by this sink.
+    // `fresh_file` is false when appending to a file left by an earlier run.
+    virtual void beginFile(const spdlog::details::log_msg& first, bool fresh_file,
+                           spdlog::memory_buf_t& dest);
+
+private:
+    void startFile(const spdlog::details::log_msg& first);
+    void rotate();
+    void shiftFile(const spdlog::filename_t& src, const spdlog::filename_t& target);
+    void write(const spdlog::memory_buf_t& buffer);
+    void reopen();
+
+    spdlog::filename_t              base_filename_;
+    size_t                          max_size_;
+    size_t                          max_files_;
+    size_t                          current_size_ = 0;
+    bool                            file_started_ = false;
+    bool                            dirty_        = false;   // written since the last flush
+    std::unique_ptr<LogFile>        file_;
+    LogStats*                       stats_ = nullptr;
+    std::unique_ptr<LogCompressor>  compressor_;
+    std::unique_ptr<LogIndexWriter> index_;
+    spdlog::memory_buf_t            encoded_;   // reused for every record
+    spdlog::memory_buf_t            text_;      // rendered structured or formatted payload
+};
+
+}   // namespace mlogger
+
+#endif   // ROTATING_FILE_SINK_H
@@ -0,0 +1,163 @@
+#include "shared_memory_sink.h"
+#include "core/deferred_format.h"
+#include <algorithm>
+#include <cstring>
+#include <spdlog/details/os.h>
+
+namespace mlogger
+{
+
+namespace
+{
+
+enum PayloadKind : uint8_t
+{
+    kText       = 0,
+    kStructured = 1,
+    kFormatted  = 2,
+    kUtf16      = 3,
+};
+
+int64_t toNanoseconds(spdlog::log_clock::time_point time)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+}   // namespace
+
+SharedMemorySink::SharedMemorySink(std::shared_ptr<SharedRing> ring)
+    : ring_(std::move(ring))
+    , process_id_(static_cast<uint32_t>(spdlog::details::os::pid()))
+{
+}
+
+void SharedMemorySink::log(const spdlog::details::log_msg& msg)
+{
+    uint8_t               kind = kText;
+    spdlog::string_view_t format;
+    spdlog::string_view_t payload   = msg.payload;
+    uint32_t              format_id = 0;
+    if (isStructured(msg)) {
+        kind = kStructured;
+    } else if (isUtf16(msg)) {
+        kind = kUtf16;
+    } else if (isFormatted(msg) && payload.size() >= sizeof(format_id)) {
+        std::memcpy(&format_id, payload.data(), sizeof(format_id));
+        format  = FormatRegistry::getInstance().get(format_id);
+        payload = spdlog::string_view_t(payload.data() + sizeof(format_id),
+                                        payload.size() - sizeof(format_id));
+        kind    = kFormatted;
+    }
+
+    size_t fixed = kRecordHeaderSize + msg.logger_name.size() +
+                   (kind == kFormatted ? sizeof(uint32_t) + format.size() : 0);
+    if (fixed + payload.size() <= ring_->maxBlockSize()) {
+        publish(msg, kind, format, payload);
+        return;
+    }
+
+    // NOTE: a record too large for one block is published as its text, cut to fit
+    thread_local spdlog::memory_buf_t text;
+    text.clear();
+    if (needsRendering(msg)) {
+        appendPayloadText(msg.source.funcname, msg.payload, text);
+    } else {
+        text.append(msg.payload);
+    }
+    size_t room = ring_->maxBlockSize() - kRecordHeaderSize - msg.logger_name.size();
+    publish(msg, kText, spdlog::string_view_t(),
+            spdlog::string_view_t(text.data(), std::min(text.size(), room)));
+}
+
+bool SharedMemorySink::publish(const spdlog::details::log_msg& msg, uint8_t kind,
+                               spdlog::string_view_t format, spdlog::string_view_t payload)
+{
+    size_t size = kRecordHeaderSize + msg.logger_name.size() + payload.size() +
+                  (kind == kFormatted ? sizeof(uint32_t) + format.size() : 0);
+    SharedRing::Block block;
+    if (!ring_->tryReserve(size, block)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    unsigned char* dest      = static_cast<unsigned char*>(block.data);
+    int64_t        time_ns   = toNanoseconds(msg.time);
+    uint64_t       thread_id = msg.thread_id;
+    uint16_t       name_size = static_cast<uint16_t>(msg.logger_name.size());
+    std::memcpy(dest, &time_ns, sizeof(time_ns));
+    std::memcpy(dest + 8, &thread_id, sizeof(thread_id));
+    std::memcpy(dest + 16, &process_id_, sizeof(process_id_));
+    dest[20] = static_cast<unsigned char>(msg.level);
+    dest[21] = kind;
+    std::memcpy(dest + 22, &name_size, sizeof(name_size));
+    dest += kRecordHeaderSize;
+    std::memcpy(dest, msg.logger_name.data(), name_size);
+    dest += name_size;
+    if (kind == kFormatted) {
+        uint32_t format_size = static_cast<uint32_t>(format.size());
+        std::memcpy(dest, &format_size, sizeof(format_size));
+        std::memcpy(dest + sizeof(format_size), format.data(), format.size());
+        dest += sizeof(format_size) + format.size();
+    }
+    if (payload.size() > 0) std::memcpy(dest, payload.data(), payload.size());
+
+    if (!ring_->commit(block)) {
+        // stalled past SharedRing::kAbandonTimeout, the reader skipped the block
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+void SharedMemorySink::flush()
+{
+    ring_->waitUntilRead(kFlushStallTimeout);
+}
+
+void SharedMemorySink::set_pattern(const std::string&) {}
+
+void SharedMemorySink::set_formatter(std::unique_ptr<spdlog::formatter>) {}
+
+bool SharedMemorySink::decodeRecord(const void* data, size_t size, SharedRecord& record)
+{
+    if (size < kRecordHeaderSize) {
+        return false;
+    }
+
+    const char* bytes = static_cast<const char*>(data);
+    uint16_t    name_size;
+    std::memcpy(&record.time_ns, bytes, sizeof(record.time_ns));
+    std::memcpy(&record.thread_id, bytes + 8, sizeof(record.thread_id));
+    std::memcpy(&record.process_id, bytes + 16, sizeof(record.process_id));
+    std::memcpy(&name_size, bytes + 22, sizeof(name_size));
+    record.level = static_cast<uint8_t>(bytes[20]);
+    uint8_t kind = static_cast<uint8_t>(bytes[21]);
+    if (record.level > spdlog::level::critical || kind > kUtf16 ||
+        name_size > size - kRecordHeaderSize) {
+        return false;
+    }
+    record.logger_name = spdlog::string_view_t(bytes + kRecordHeaderSize, name_size);
+
+    size_t offset = kRecordHeaderSize + name_size;
+    record.format = spdlog::string_view_t();
+    if (kind == kFormatted) {
+        uint32_t format_size;
+        if (size - offset < sizeof(format_size)) return false;
+        std::memcpy(&format_size, bytes + offset, sizeof(format_size));
+        offset += sizeof(format_size);
+        if (format_size > size - offset) return false;
+        record.format = spdlog::string_view_t(bytes + offset, format_size);
+        offset += format_size;
+    }
+    record.payload = spdlog::string_view_t(bytes + offset, size - offset);
+
+    switch (kind) {
+    case kStructured: record.payload_tag = kStructuredTag; break;
+    case kFormatted: record.payload_tag = kFormattedTag; break;
+    case kUtf16: record.payload_tag = kUtf16Tag; break;
+    default: record.payload_tag = nullptr; break;
+    }
+    return true;
+}
+
+}   // namespace mlogger
@@ -0,0 +1,83 @@
+#ifndef SHARED_MEMORY_SINK_H
+#define SHARED_MEMORY_SINK_H
+
+#include "utils/shared_ring.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <spdlog/sinks/sink.h>
+
+namespace mlogger
+{
+
+// a record decoded by SharedMemorySink::decodeRecord(), viewing the ring's bytes
+struct SharedRecord {
+    int64_t               time_ns    = 0;   // since the Unix epoch
+    uint64_t              thread_id  = 0;
+    uint32_t              process_id = 0;
+    int                   level      = 0;   // spdlog level
+    // nullptr for text, else kStructuredTag, kFormattedTag or kUtf16Tag like log_msg's
+    // source.funcname
+    const char*           payload_tag = nullptr;
+    spdlog::string_view_t logger_name;
+    spdlog::string_view_t format;   // formatted records: the format string, payload the arguments
+    spdlog::string_view_t payload;
+};
+
+// Publishes every record to a SharedRing that another process drains into the files, see
+// LoggerConfig::shared_memory_name and tools/mlogger_aggregate.cpp.
+//
+// The logging thread itself copies the record into the ring, nothing is formatted: structured
+// and UTF-16 payloads travel as they are, formatted ones with their format string since format
+// ids are only known to this process. No lock is taken, threads publish concurrently. Records
+// the ring has no room for are dropped and counted, the aggregator reports them.
+//
+// Block layout, native byte order (the ring never leaves the host):
+//   0  i64  time, ns since the Unix epoch
+//   8  u64  thread id
+//   16 u32  process id
+//   20 u8   level
+//   21 u8   payload kind: 0 text, 1 structured, 2 formatted, 3 UTF-16
+//   22 u16  logger name bytes
+//   24      logger name, then for formatted records u32 format bytes and the format, then the
+//           payload
+class SharedMemorySink final : public spdlog::sinks::sink
+{
+public:
+    static constexpr size_t kRecordHeaderSize = 24;
+    // how long flush() waits for an aggregator that stopped reading
+    static constexpr auto kFlushStallTimeout = std::chrono::milliseconds(200);
+
+    explicit SharedMemorySink(std::shared_ptr<SharedRing> ring);
+
+    const std::shared_ptr<SharedRing>& ring() const { return ring_; }
+    // records of this process the ring had no room for, or the reader skipped as abandoned
+    uint64_t droppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+
+    // false when `data` is not a whole record
+    static bool decodeRecord(const void* data, size_t size, SharedRecord& record);
+
+    void log(const spdlog::details::log_msg& msg) override;
+    // waits until the aggregator read what was published, while one is attached
+    void flush() override;
+    // records are published unformatted
+    void set_pattern(const std::string& pattern) override;
+    void set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) override;
+
+    SharedMemorySink(const SharedMemorySink&)            = delete;
+    SharedMemorySink& operator=(const SharedMemorySink&) = delete;
+
+private:
+    bool publish(const spdlog::details::log_msg& msg, uint8_t kind,
+                 spdlog::string_view_t format, spdlog::string_view_t payload);
+
+    std::shared_ptr<SharedRing> ring_;
+    uint32_t                    process_id_;
+    std::atomic<uint64_t>       dropped_{0};
+};
+
+}   // namespace mlogger
+
+#endif   // SHARED_MEMORY_SINK_H
@@ -0,0 +1,129 @@
+#include "tail_sink.h"
+#include "core/deferred_format.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace mlogger
+{
+
+namespace
+{
+
+constexpr size_t kMinCapacity = 4096;
+constexpr size_t kLengthSize  = sizeof(uint32_t);
+
+size_t roundUpPow2(size_t value)
+{
+    size_t result = kMinCapacity;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+// NOTE: positions of a new sink start past any cursor handed out by an earlier one
+uint64_t streamStart()
+{
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+}
+
+}   // namespace
+
+TailSink::TailSink(size_t capacity)
+    : capacity_(roundUpPow2(capacity))
+    , mask_(capacity_ - 1)
+    , max_line_(capacity_ / 4 - kLengthSize)
+    , head_(streamStart())
+    , tail_(head_)
+{
+    data_ = std::make_unique<char[]>(capacity_);
+}
+
+size_t TailSink::read(uint64_t& cursor, char* dest, size_t size, bool* skipped)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool valid = cursor >= tail_ && cursor <= head_;
+    if (skipped) *skipped = cursor != 0 && !valid;
+    if (!valid) {
+        cursor = tail_;
+    }
+
+    size_t copied = 0;
+    while (cursor < head_ && copied < size) {
+        uint32_t length = 0;
+        copyOut(cursor, &length, kLengthSize);
+        size_t take = length;
+        if (copied + length > size) {
+            if (copied > 0) break;
+            take = size;   // cut, the rest of the line is dropped
+        }
+        copyOut(cursor + kLengthSize, dest + copied, take);
+        copied += take;
+        cursor += kLengthSize + length;
+    }
+    return copied;
+}
+
+uint64_t TailSink::end()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return head_;
+}
+
+void TailSink::sink_it_(const spdlog::details::log_msg& msg)
+{
+    formatted_.clear();
+    if (needsRendering(msg)) {
+        text_.clear();
+        appendPayloadText(msg.source.funcname, msg.payload, text_);
+
+        spdlog::details::log_msg text_msg(msg);
+        text_msg.payload = spdlog::string_view_t(text_.data(), text_.size());
+        formatter_->format(text_msg, formatted_);
+    } else {
+        formatter_->format(msg, formatted_);
+    }
+
+    // NOTE: an oversized line keeps its start and its line ending
+    if (formatted_.size() > max_line_) {
+        formatted_.resize(max_line_);
+        formatted_[max_line_ - 1] = '\n';
+    }
+
+    uint32_t length = static_cast<uint32_t>(formatted_.size());
+    size_t   size   = kLengthSize + length;
+    while (head_ + size - tail_ > capacity_) {
+        uint32_t oldest = 0;
+        copyOut(tail_, &oldest, kLengthSize);
+        tail_ += kLengthSize + oldest;
+    }
+    copyIn(head_, &length, kLengthSize);
+    copyIn(head_ + kLengthSize, formatted_.data(), length);
+    head_ += size;
+}
+
+void TailSink::flush_()
+{
+    // nothing to do, lines only leave memory through read()
+}
+
+void TailSink::copyIn(uint64_t position, const void* source, size_t size)
+{
+    size_t offset = static_cast<size_t>(position & mask_);
+    size_t first  = std::min(size, capacity_ - offset);
+    std::memcpy(data_.get() + offset, source, first);
+    std::memcpy(data_.get(), static_cast<const char*>(source) + first, size - first);
+}
+
+void TailSink::copyOut(uint64_t position, void* dest, size_t size) const
+{
+    size_t offset = static_cast<size_t>(position & mask_);
+    size_t first  = std::min(size, capacity_ - offset);
+    std::memcpy(dest, data_.get() + offset, first);
+    std::memcpy(static_cast<char*>(dest) + first, data_.get(), size - first);
+}
+
+}   // namespace mlogger
@@ -0,0 +1,62 @@
+#ifndef TAIL_SINK_H
+#define TAIL_SINK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <spdlog/sinks/base_sink.h>
+
+namespace mlogger
+{
+
+// Live tail: keeps the most recent lines, formatted like the text file, in a fixed block of
+// memory for readers that poll with a cursor. A viewer receives only what was logged since its
+// last read, without touching the log file; the oldest lines are overwritten.
+//
+// Cursors are positions in the stream of lines and only grow. Every sink starts its stream at the
+// time it was created, so a cursor kept from an earlier session is never mistaken for one of its
+// own: like cursor 0, it reads from the oldest line still held.
+class TailSink final : public spdlog::sinks::base_sink<std::mutex>
+{
+public:
+    // capacity is rounded up to a power of two
+    explicit TailSink(size_t capacity);
+
+    size_t capacity() const { return capacity_; }
+
+    // Copies the whole lines after `cursor` into `dest`, oldest first, moves `cursor` past them
+    // and returns the bytes copied. A line longer than `size` is cut to it. `skipped` is set when
+    // lines after a non-zero `cursor` were overwritten before this read, or the cursor is not one
+    // of this sink's.
+    size_t read(uint64_t& cursor, char* dest, size_t size, bool* skipped = nullptr);
+    // cursor after the newest line, to tail only what is logged from now on
+    uint64_t end();
+
+    TailSink(const TailSink&)            = delete;
+    TailSink& operator=(const TailSink&) = delete;
+
+protected:
+    void sink_it_(const spdlog::details::log_msg& msg) override;
+    void flush_() override;
+
+private:
+    void copyIn(uint64_t position, const void* source, size_t size);
+    void copyOut(uint64_t position, void* dest, size_t size) const;
+
+    std::unique_ptr<char[]> data_;
+    size_t                  capacity_;
+    size_t                  mask_;
+    size_t                  max_line_;
+    spdlog::memory_buf_t    formatted_;   // reused for every record
+    spdlog::memory_buf_t    text_;        // rendered structured or formatted payload
+
+    // positions grow forever, the byte index is position & mask_; every line is stored as a u32
+    // length followed by its bytes
+    uint64_t head_;   // end of the newest line
+    uint64_t tail_;   // start of the oldest line
+};
+
+}   // namespace mlogger
+
+#endif   // TAIL_SINK_H
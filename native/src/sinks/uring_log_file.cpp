@@ -0,0 +1,532 @@
+#include "uring_log_file.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <spdlog/details/os.h>
+
+#if defined(__linux__) && defined(__has_include)
+#    if __has_include(<linux/io_uring.h>)
+#        define MLOGGER_HAS_URING 1
+#    endif
+#endif
+
+#if defined(MLOGGER_HAS_URING)
+#    include <fcntl.h>
+#    include <linux/io_uring.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <sys/syscall.h>
+#    include <unistd.h>
+#endif
+
+namespace mlogger
+{
+
+namespace
+{
+
+// O_DIRECT offsets, lengths and buffers; the largest logical block size in use
+constexpr size_t kAlign    = 4096;
+constexpr size_t kMinChunk = 64 * 1024;
+// buffered files: writeback is started per window, the window before it released
+constexpr uint64_t kDropWindow = 8 * 1024 * 1024;
+// submissions and completions: every chunk plus the drop behind advice of a few windows
+constexpr unsigned kRingEntries = 32;
+// user_data of sync_file_range and fadvise requests, chunks are 1-based
+constexpr uint64_t kAdviceTag = 0;
+
+size_t roundUp(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+}   // namespace
+
+#if defined(MLOGGER_HAS_URING)
+
+// NOTE: the raw interface rather than liburing, the three mappings and two syscalls are all a
+// single submitter needs
+struct UringLogFile::Ring {
+    int           fd        = -1;
+    void*         sq_map    = MAP_FAILED;
+    size_t        sq_size   = 0;
+    void*         cq_map    = MAP_FAILED;
+    size_t        cq_size   = 0;
+    io_uring_sqe* sqes      = nullptr;
+    size_t        sqes_size = 0;
+    unsigned*     sq_tail   = nullptr;
+    unsigned*     sq_mask   = nullptr;
+    unsigned*     sq_array  = nullptr;
+    unsigned*     cq_head   = nullptr;
+    unsigned*     cq_tail   = nullptr;
+    unsigned*     cq_mask   = nullptr;
+    io_uring_cqe* cqes      = nullptr;
+
+    // false with errno set when the kernel refuses
+    bool setup(unsigned entries)
+    {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (fd < 0) {
+            return false;
+        }
+        // NOTE: IORING_OP_WRITE and FADVISE came with 5.6, as did this feature bit
+        if (!(params.features & IORING_FEAT_RW_CUR_POS)) {
+            errno = ENOSYS;
+            return false;
+        }
+
+        sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single_map = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single_map) {
+            sq_size = cq_size = std::max(sq_size, cq_size);
+        }
+        sq_map = mmap(nullptr, sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                      IORING_OFF_SQ_RING);
+        if (sq_map == MAP_FAILED) {
+            return false;
+        }
+        if (!single_map) {
+            cq_map = mmap(nullptr, cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                          IORING_OFF_CQ_RING);
+            if (cq_map == MAP_FAILED) {
+                return false;
+            }
+        }
+        sqes_size      = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqes_map = mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE,
+                              MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+        if (sqes_map == MAP_FAILED) {
+            return false;
+        }
+        sqes = static_cast<io_uring_sqe*>(sqes_map);
+
+        auto* sq = static_cast<unsigned char*>(sq_map);
+        auto* cq = static_cast<unsigned char*>(single_map ? sq_map : cq_map);
+        sq_tail  = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_mask  = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        cq_head  = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail  = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask  = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes     = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    ~Ring()
+    {
+        if (sqes) munmap(sqes, sqes_size);
+        if (cq_map != MAP_FAILED) munmap(cq_map, cq_size);
+        if (sq_map != MAP_FAILED) munmap(sq_map, sq_size);
+        if (fd >= 0) ::close(fd);
+    }
+
+    // an entry to fill, submitted by submit(); every queued entry is submitted at once, so the
+    // queue never holds more than one
+    io_uring_sqe& prepare()
+    {
+        unsigned      tail  = *sq_tail;
+        unsigned      index = tail & *sq_mask;
+        io_uring_sqe& entry = sqes[index];
+        std::memset(&entry, 0, sizeof(entry));
+        sq_array[index] = index;
+        return entry;
+    }
+
+    // false with errno set
+    bool submit()
+    {
+        __atomic_store_n(sq_tail, *sq_tail + 1, __ATOMIC_RELEASE);
+        for (;;) {
+            long done = syscall(__NR_io_uring_enter, fd, 1, 0, 0, nullptr, 0);
+            if (done >= 0) return true;
+            if (errno != EINTR) return false;
+        }
+    }
+
+    bool waitCompletion()
+    {
+        for (;;) {
+            long done = syscall(__NR_io_uring_enter, fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+            if (done >= 0) return true;
+            if (errno != EINTR) return false;
+        }
+    }
+
+    // the oldest completion, null when there is none
+    const io_uring_cqe* peek() const
+    {
+        unsigned head = *cq_head;
+        if (head == __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE)) {
+            return nullptr;
+        }
+        return &cqes[head & *cq_mask];
+    }
+
+    void pop() { __atomic_store_n(cq_head, *cq_head + 1, __ATOMIC_RELEASE); }
+};
+
+UringLogFile::UringLogFile(size_t chunk_size, bool direct)
+    : chunk_size_(roundUp(std::max(chunk_size, kMinChunk), kAlign))
+    , direct_requested_(direct)
+{
+    for (Chunk& chunk : chunks_) {
+        // NOTE: room for the padding of a partial write
+        chunk.data = static_cast<unsigned char*>(std::aligned_alloc(kAlign, chunk_size_));
+        if (!chunk.data) {
+            throw spdlog::spdlog_ex("uring log file: failed allocating the chunks");
+        }
+    }
+}
+
+UringLogFile::~UringLogFile()
+{
+    try {
+        close();
+    } catch (...) {
+        // NOTE: nowhere to report from here, like StdioLogFile
+    }
+    ring_.reset();
+    for (Chunk& chunk : chunks_) {
+        std::free(chunk.data);
+    }
+}
+
+bool UringLogFile::isSupported()
+{
+    static const bool supported = []() {
+        Ring ring;
+        return ring.setup(1);
+    }();
+    return supported;
+}
+
+void UringLogFile::open(const spdlog::filename_t& filename, bool truncate)
+{
+    close();
+    filename_ = filename;
+    spdlog::details::os::create_dir(spdlog::details::os::dir_name(filename));
+
+    if (!ring_) {
+        auto ring = std::make_unique<Ring>();
+        if (!ring->setup(kRingEntries)) {
+            throwError("io_uring unavailable for", errno);
+        }
+        ring_ = std::move(ring);
+    }
+
+    int flags = O_CLOEXEC | O_CREAT | (truncate ? O_TRUNC : 0);
+    direct_   = direct_requested_;
+    if (direct_) {
+        // NOTE: read back the partial last block of a file being appended to
+        fd_ = ::open(filename.c_str(), flags | O_RDWR | O_DIRECT, 0644);
+        if (fd_ < 0 && errno == EINVAL) {
+            direct_ = false;   // tmpfs and some network filesystems
+        }
+    }
+    if (!direct_) {
+        fd_ = ::open(filename.c_str(), flags | O_WRONLY, 0644);
+    }
+    if (fd_ < 0) {
+        throwError("failed opening", errno);
+    }
+
+    struct stat info;
+    if (::fstat(fd_, &info) != 0) {
+        int error = errno;
+        ::close(fd_);
+        fd_ = -1;
+        throwError("failed reading the size of", error);
+    }
+    size_          = static_cast<uint64_t>(info.st_size);
+    synced_until_  = size_;
+    dropped_until_ = size_;
+    overlap_       = -1;
+    current_       = 0;
+
+    Chunk& first = chunks_[current_];
+    first.offset = size_;
+    first.length = 0;
+    if (direct_ && size_ % kAlign != 0) {
+        first.offset = size_ / kAlign * kAlign;
+        first.length = static_cast<size_t>(size_ - first.offset);
+        ssize_t read = ::pread(fd_, first.data, kAlign, static_cast<off_t>(first.offset));
+        if (read < static_cast<ssize_t>(first.length)) {
+            int error = read < 0 ? errno : EIO;
+            ::close(fd_);
+            fd_ = -1;
+            throwError("failed reading the end of", error);
+        }
+    }
+}
+
+void UringLogFile::close()
+{
+    if (fd_ < 0) {
+        return;
+    }
+
+    int error = 0;
+    try {
+        flush();
+    } catch (...) {
+        // NOTE: the chunks must outlive the writes still reading them
+        try {
+            drain();
+        } catch (...) {
+        }
+        ::close(fd_);
+        fd_ = -1;
+        throw;
+    }
+    if (direct_ && ::ftruncate(fd_, static_cast<off_t>(size_)) != 0) {
+        error = errno;
+    }
+    if (!direct_) {
+        // NOTE: only pages written back by now are released, a rotated file keeps the rest
+        // until the kernel writes them
+        ::posix_fadvise(fd_, 0, 0, POSIX_FADV_DONTNEED);
+    }
+    ::close(fd_);
+    fd_ = -1;
+    if (error != 0) {
+        throwError("failed truncating", error);
+    }
+}
+
+void UringLogFile::write(const spdlog::memory_buf_t& buffer)
+{
+    reap(false);
+
+    const char* data      = buffer.data();
+    size_t      remaining = buffer.size();
+    while (remaining > 0) {
+        Chunk& chunk = chunks_[current_];
+        size_t count = std::min(chunk_size_ - chunk.length, remaining);
+        std::memcpy(chunk.data + chunk.length, data, count);
+        chunk.length += count;
+        size_ += count;
+        data += count;
+        remaining -= count;
+        if (chunk.length == chunk_size_) {
+            submitCurrent();
+        }
+    }
+}
+
+void UringLogFile::flush()
+{
+    if (fd_ < 0) {
+        return;
+    }
+    submitCurrent();
+    drain();
+}
+
+size_t UringLogFile::size() const
+{
+    return static_cast<size_t>(size_);
+}
+
+const spdlog::filename_t& UringLogFile::filename() const
+{
+    return filename_;
+}
+
+void UringLogFile::submitCurrent()
+{
+    Chunk& chunk = chunks_[current_];
+    if (chunk.length == 0) {
+        return;
+    }
+
+    // NOTE: two writes of the same block in flight may land in either order
+    if (overlap_ >= 0) {
+        waitFor(static_cast<size_t>(overlap_));
+        overlap_ = -1;
+    }
+
+    size_t   carry = 0;
+    uint64_t end   = chunk.offset + chunk.length;
+    chunk.submitted = chunk.length;
+    if (direct_) {
+        chunk.submitted = roundUp(chunk.length, kAlign);
+        std::memset(chunk.data + chunk.length, 0, chunk.submitted - chunk.length);
+        carry = chunk.length % kAlign;
+    }
+    queueWrite(current_);
+
+    size_t next = (current_ + 1) % kChunks;
+    waitFor(next);
+    Chunk& following = chunks_[next];
+    following.offset = end - carry;
+    following.length = carry;
+    if (carry > 0) {
+        std::memcpy(following.data, chunk.data + chunk.length - carry, carry);
+        overlap_ = static_cast<int>(current_);
+    }
+    current_ = next;
+
+    if (!direct_) {
+        dropBehind(chunk.offset);
+    }
+}
+
+void UringLogFile::queueWrite(size_t index)
+{
+    Chunk&        chunk = chunks_[index];
+    io_uring_sqe& entry = ring_->prepare();
+    entry.opcode        = IORING_OP_WRITE;
+    entry.fd            = fd_;
+    entry.addr          = reinterpret_cast<uintptr_t>(chunk.data);
+    entry.len           = static_cast<uint32_t>(chunk.submitted);
+    entry.off           = chunk.offset;
+    entry.user_data     = index + 1;
+    if (!ring_->submit()) {
+        throwError("failed submitting a write to", errno);
+    }
+    chunk.in_flight = true;
+    ++in_flight_;
+}
+
+void UringLogFile::dropBehind(uint64_t written)
+{
+    if (written < synced_until_ + kDropWindow || in_flight_ + 2 > kRingEntries) {
+        return;
+    }
+
+    // the window before was handed to writeback a window ago, its pages are clean by now
+    if (synced_until_ > dropped_until_) {
+        queueAdvice(IORING_OP_FADVISE, dropped_until_, synced_until_ - dropped_until_);
+        dropped_until_ = synced_until_;
+    }
+    queueAdvice(IORING_OP_SYNC_FILE_RANGE, synced_until_, written - synced_until_);
+    synced_until_ = written;
+}
+
+void UringLogFile::queueAdvice(uint8_t opcode, uint64_t offset, uint64_t length)
+{
+    io_uring_sqe& entry = ring_->prepare();
+    entry.opcode        = opcode;
+    entry.fd            = fd_;
+    entry.off           = offset;
+    entry.len           = static_cast<uint32_t>(std::min<uint64_t>(length, UINT32_MAX));
+    entry.user_data     = kAdviceTag;
+    if (opcode == IORING_OP_FADVISE) {
+        entry.fadvise_advice = POSIX_FADV_DONTNEED;
+    } else {
+        entry.sync_range_flags = SYNC_FILE_RANGE_WRITE;
+    }
+    // NOTE: advice only, a refused request costs nothing but the pages
+    if (ring_->submit()) {
+        ++in_flight_;
+    }
+}
+
+void UringLogFile::reap(bool wait)
+{
+    if (!ring_ || in_flight_ == 0) {
+        return;
+    }
+    if (wait && !ring_->peek() && !ring_->waitCompletion()) {
+        throwError("failed waiting for a write to", errno);
+    }
+
+    int error = 0;
+    while (const io_uring_cqe* done = ring_->peek()) {
+        uint64_t tag    = done->user_data;
+        int      result = done->res;
+        ring_->pop();
+        --in_flight_;
+        if (tag == kAdviceTag || tag > kChunks) {
+            continue;
+        }
+
+        Chunk& chunk    = chunks_[tag - 1];
+        chunk.in_flight = false;
+        // NOTE: regular files only come back short on a full disk or a failing device
+        if (result < 0) {
+            error = -result;
+        } else if (static_cast<size_t>(result) < chunk.submitted && error == 0) {
+            error = ENOSPC;
+        }
+    }
+    if (error != 0) {
+        throwError("failed writing", error);
+    }
+}
+
+void UringLogFile::waitFor(size_t index)
+{
+    while (chunks_[index].in_flight) {
+        reap(true);
+    }
+}
+
+void UringLogFile::drain()
+{
+    while (in_flight_ > 0) {
+        reap(true);
+    }
+}
+
+void UringLogFile::throwError(const char* what, int error) const
+{
+    spdlog::throw_spdlog_ex(std::string("uring log file: ") + what + " " +
+                                spdlog::details::os::filename_to_str(filename_),
+                            error);
+}
+
+#else   // MLOGGER_HAS_URING
+
+struct UringLogFile::Ring {
+};
+
+UringLogFile::UringLogFile(size_t chunk_size, bool direct)
+    : chunk_size_(roundUp(std::max(chunk_size, kMinChunk), kAlign))
+    , direct_requested_(direct)
+{
+}
+
+UringLogFile::~UringLogFile() = default;
+
+bool UringLogFile::isSupported()
+{
+    return false;
+}
+
+void UringLogFile::open(const spdlog::filename_t& filename, bool)
+{
+    filename_ = filename;
+    throwError("io_uring unavailable for", ENOSYS);
+}
+
+void UringLogFile::close() {}
+
+void UringLogFile::write(const spdlog::memory_buf_t&) {}
+
+void UringLogFile::flush() {}
+
+size_t UringLogFile::size() const
+{
+    return static_cast<size_t>(size_);
+}
+
+const spdlog::filename_t& UringLogFile::filename() const
+{
+    return filename_;
+}
+
+void UringLogFile::throwError(const char* what, int error) const
+{
+    spdlog::throw_spdlog_ex(std::string("uring log file: ") + what + " " +
+                                spdlog::details::os::filename_to_str(filename_),
+                            error);
+}
+
+#endif   // MLOGGER_HAS_URING
+
+}   // namespace mlogger
@@ -0,0 +1,86 @@
+#ifndef URING_LOG_FILE_H
+#define URING_LOG_FILE_H
+
+#include "log_file.h"
+#include <array>
+#include <cstdint>
+#include <memory>
+
+namespace mlogger
+{
+
+// Linux only LogFile that collects records into aligned chunks and submits each full chunk as
+// one write through io_uring, so the writing thread hands the data to the kernel without
+// waiting for it; it only waits when every chunk is still in flight. flush() submits the partial
+// chunk and waits for the writes, so what was flushed is in the file when it returns.
+//
+// Files are opened with O_DIRECT when `direct`, bypassing the page cache. A partial chunk is then
+// written padded to the alignment and its last block rewritten by the next chunk; close() trims
+// the file to its data. Filesystems refusing O_DIRECT get buffered writes. Buffered files drop
+// their pages behind the writes instead: every few megabytes the writeback of the last window is
+// started and the window before it released (sync_file_range and posix_fadvise(DONTNEED), both
+// submitted through the ring).
+class UringLogFile final : public LogFile
+{
+public:
+    // `chunk_size` bytes per write (rounded up to the alignment, at least 64KB)
+    UringLogFile(size_t chunk_size, bool direct);
+    ~UringLogFile() override;
+
+    void                      open(const spdlog::filename_t& filename, bool truncate) override;
+    void                      close() override;
+    void                      write(const spdlog::memory_buf_t& buffer) override;
+    void                      flush() override;
+    size_t                    size() const override;
+    const spdlog::filename_t& filename() const override;
+
+    // whether this process may use io_uring: Linux 5.6 or later, not disabled by
+    // kernel.io_uring_disabled or a seccomp filter (Android apps, many containers)
+    static bool isSupported();
+
+    UringLogFile(const UringLogFile&)            = delete;
+    UringLogFile& operator=(const UringLogFile&) = delete;
+
+private:
+    static constexpr size_t kChunks = 8;
+
+    struct Chunk {
+        unsigned char* data      = nullptr;
+        uint64_t       offset    = 0;   // file offset of data[0]
+        size_t         length    = 0;   // bytes collected
+        size_t         submitted = 0;   // bytes of the write in flight, padding included
+        bool           in_flight = false;
+    };
+    struct Ring;
+
+    // queues the current chunk and moves on to the next one, carrying a partial last block over
+    // when writing direct
+    void submitCurrent();
+    void queueWrite(size_t index);
+    // sync_file_range / posix_fadvise behind the writes of buffered files
+    void dropBehind(uint64_t written);
+    void queueAdvice(uint8_t opcode, uint64_t offset, uint64_t length);
+    // handles completions, waiting for one when `wait`
+    void reap(bool wait);
+    void waitFor(size_t index);
+    void drain();
+    [[noreturn]] void throwError(const char* what, int error) const;
+
+    size_t                     chunk_size_;
+    bool                       direct_requested_;
+    std::unique_ptr<Ring>      ring_;
+    std::array<Chunk, kChunks> chunks_;
+    size_t                     current_       = 0;
+    int                        overlap_       = -1;   // chunk whose last block the current rewrites
+    size_t                     in_flight_     = 0;    // writes and advice
+    uint64_t                   size_          = 0;
+    uint64_t                   synced_until_  = 0;    // writeback started below
+    uint64_t                   dropped_until_ = 0;    // pages released below
+    bool                       direct_        = false;
+    int                        fd_            = -1;
+    spdlog::filename_t         filename_;
+};
+
+}   // namespace mlogger
+
+#endif   // URING_LOG_FILE_H
@@ -0,0 +1,267 @@
+#include "crash_handler.h"
+#include <atomic>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+
+#if defined(_WIN32) || defined(_WIN64)
+#    include <windows.h>
+#else
+#    include <type_traits>
+#endif
+
+namespace mlogger
+{
+
+namespace
+{
+
+std::atomic<CrashCallback> g_callback{nullptr};
+std::atomic<bool>          g_crashed{false};
+std::mutex                 g_install_mutex;
+bool                       g_installed = false;
+
+void runCallback()
+{
+    // NOTE: a crash inside the callback or a second crashing thread must not re-enter it
+    CrashCallback callback = g_callback.load();
+    if (callback && !g_crashed.exchange(true)) {
+        callback();
+    }
+}
+
+#if defined(_WIN32) || defined(_WIN64)
+
+using SignalHandler = void (*)(int);
+
+LPTOP_LEVEL_EXCEPTION_FILTER g_previous_filter = nullptr;
+SignalHandler                g_previous_abort  = SIG_DFL;
+
+LONG WINAPI handleException(EXCEPTION_POINTERS* info)
+{
+    runCallback();
+    return g_previous_filter ? g_previous_filter(info) : EXCEPTION_CONTINUE_SEARCH;
+}
+
+void handleAbort(int signal)
+{
+    runCallback();
+    std::signal(SIGABRT, g_previous_abort);
+    std::raise(signal);
+}
+
+#else
+
+constexpr int    kSignals[]   = {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT};
+constexpr size_t kSignalCount = sizeof(kSignals) / sizeof(kSignals[0]);
+// room for the ring dump on the alternate stack, the thread's own one may be what overflowed
+constexpr size_t kAltStackSize = 64 * 1024;
+
+struct sigaction g_previous[kSignalCount];
+// alternate stack of the thread that installed the handlers, null when it already had one
+std::unique_ptr<char[]> g_alt_stack;
+// fault that came back unchanged from the previous handler, see handleSignal()
+std::atomic<uintptr_t> g_pending_fault{0};
+
+bool hasHandler(const struct sigaction& action)
+{
+    if (action.sa_flags & SA_SIGINFO) {
+        return action.sa_sigaction != nullptr;
+    }
+    return action.sa_handler != SIG_DFL && action.sa_handler != SIG_IGN;
+}
+
+void callHandler(const struct sigaction& action, int signal, siginfo_t* info, void* context)
+{
+    if (action.sa_flags & SA_SIGINFO) {
+        action.sa_sigaction(signal, info, context);
+    } else {
+        action.sa_handler(signal);
+    }
+}
+
+#    if defined(__APPLE__)
+using MachineContext = std::remove_pointer_t<decltype(ucontext_t::uc_mcontext)>;
+MachineContext& machineContext(void* context)
+{
+    return *static_cast<ucontext_t*>(context)->uc_mcontext;
+}
+#    else
+using MachineContext = decltype(ucontext_t::uc_mcontext);
+MachineContext& machineContext(void* context)
+{
+    return static_cast<ucontext_t*>(context)->uc_mcontext;
+}
+#    endif
+
+// restores the default action, it is taken as soon as the handler returns
+void resetToDefault(int signal)
+{
+    struct sigaction fallback = {};
+    fallback.sa_handler       = SIG_DFL;
+    sigemptyset(&fallback.sa_mask);
+    sigaction(signal, &fallback, nullptr);
+}
+
+void handleSignal(int signal, siginfo_t* info, void* context)
+{
+    struct sigaction previous = {};
+    for (size_t i = 0; i < kSignalCount; ++i) {
+        if (kSignals[i] == signal) previous = g_previous[i];
+    }
+
+    if (!hasHandler(previous)) {
+        runCallback();
+        // default action: the signal is delivered again once this handler returns
+        resetToDefault(signal);
+        raise(signal);
+        return;
+    }
+
+    // NOTE: nothing recovers from abort(), and it terminates without calling us again once the
+    // previous handler returns, so the ring goes out first
+    if (signal == SIGABRT) {
+        runCallback();
+        callHandler(previous, signal, info, context);
+        g_crashed.store(false);
+        return;
+    }
+
+    // NOTE: the previous handler goes first, it may recover. Mono turns a fault in managed code
+    // into a NullReferenceException by pointing the context somewhere else and returning; a
+    // handler that recovers by jumping out never comes back here at all.
+    MachineContext before = {};
+    if (context) std::memcpy(&before, &machineContext(context), sizeof(before));
+    callHandler(previous, signal, info, context);
+    if (!context || std::memcmp(&before, &machineContext(context), sizeof(before)) != 0) {
+        g_pending_fault.store(0);
+        return;
+    }
+
+    // sent with raise() or kill(): the previous handler chose to carry on
+    if (!info || info->si_code <= 0) {
+        return;
+    }
+
+    // the faulting instruction runs again. When it faults again the same way the previous handler
+    // could not deal with it: the crash is real, and the default action ends it after the dump
+    uintptr_t fault = reinterpret_cast<uintptr_t>(info->si_addr) ^ static_cast<uintptr_t>(signal);
+    if (g_pending_fault.exchange(fault) == fault) {
+        runCallback();
+        resetToDefault(signal);
+    }
+}
+
+// the dump must not need the stack that just overflowed. Only covers the installing thread,
+// every thread has a stack of its own.
+void installAltStack()
+{
+    stack_t current = {};
+    if (g_alt_stack || sigaltstack(nullptr, &current) != 0 || !(current.ss_flags & SS_DISABLE)) {
+        return;   // the thread already has one, e.g. from the scripting runtime
+    }
+
+    std::unique_ptr<char[]> memory(new (std::nothrow) char[kAltStackSize]);
+    if (!memory) {
+        return;
+    }
+    stack_t stack  = {};
+    stack.ss_sp    = memory.get();
+    stack.ss_size  = kAltStackSize;
+    stack.ss_flags = 0;
+    if (sigaltstack(&stack, nullptr) == 0) {
+        g_alt_stack = std::move(memory);
+    }
+}
+
+void uninstallAltStack()
+{
+    stack_t current = {};
+    if (!g_alt_stack || sigaltstack(nullptr, &current) != 0 ||
+        current.ss_sp != g_alt_stack.get() || (current.ss_flags & SS_ONSTACK)) {
+        // NOTE: installed on another thread or replaced, left as it is
+        return;
+    }
+    stack_t disable  = {};
+    disable.ss_flags = SS_DISABLE;
+    if (sigaltstack(&disable, nullptr) == 0) {
+        g_alt_stack.reset();
+    }
+}
+
+#endif
+
+}   // namespace
+
+bool installCrashHandler(CrashCallback callback)
+{
+    std::lock_guard<std::mutex> lock(g_install_mutex);
+    g_callback.store(callback);
+    g_crashed.store(false);
+    if (g_installed) {
+        return true;
+    }
+
+#if defined(_WIN32) || defined(_WIN64)
+    g_previous_filter = ::SetUnhandledExceptionFilter(handleException);
+    g_previous_abort  = std::signal(SIGABRT, handleAbort);
+    if (g_previous_abort == SIG_ERR) {
+        g_previous_abort = SIG_DFL;
+    }
+#else
+    struct sigaction action = {};
+    action.sa_sigaction     = handleSignal;
+    action.sa_flags         = SA_SIGINFO | SA_ONSTACK;
+    sigemptyset(&action.sa_mask);
+
+    for (size_t i = 0; i < kSignalCount; ++i) {
+        if (sigaction(kSignals[i], &action, &g_previous[i]) != 0) {
+            while (i-- > 0) {
+                sigaction(kSignals[i], &g_previous[i], nullptr);
+            }
+            g_callback.store(nullptr);
+            return false;
+        }
+    }
+    installAltStack();
+#endif
+
+    g_installed = true;
+    return true;
+}
+
+void uninstallCrashHandler()
+{
+    std::lock_guard<std::mutex> lock(g_install_mutex);
+    g_callback.store(nullptr);
+    if (!g_installed) {
+        return;
+    }
+
+#if defined(_WIN32) || defined(_WIN64)
+    ::SetUnhandledExceptionFilter(g_previous_filter);
+    std::signal(SIGABRT, g_previous_abort);
+    g_installed = false;
+#else
+    // NOTE: handlers installed after ours may chain to us, then ours stays as a pass-through
+    bool restored = true;
+    for (size_t i = 0; i < kSignalCount; ++i) {
+        struct sigaction current = {};
+        if (sigaction(kSignals[i], nullptr, &current) == 0 &&
+            (current.sa_flags & SA_SIGINFO) && current.sa_sigaction == handleSignal) {
+            sigaction(kSignals[i], &g_previous[i], nullptr);
+        } else {
+            restored = false;
+        }
+    }
+    g_installed = !restored;
+    if (!g_installed) {
+        uninstallAltStack();
+    }
+#endif
+}
+
+}   // namespace mlogger
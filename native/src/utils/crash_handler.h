@@ -0,0 +1,22 @@
+#ifndef CRASH_HANDLER_H
+#define CRASH_HANDLER_H
+
+namespace mlogger
+{
+
+// Called once when the process dies from a fatal signal (SIGSEGV, SIGBUS, SIGFPE, SIGILL,
+// SIGABRT) or, on Windows, an unhandled SEH exception. Runs inside the signal handler, so it
+// must be async-signal-safe.
+using CrashCallback = void (*)();
+
+// Installs process-wide handlers that hand the crash on to whatever handler was installed before,
+// so other crash reporters keep working, and call `callback` when it turns out to be fatal. A fault
+// the previous handler recovers from (Mono turns faults in managed code into exceptions) is not a
+// crash; SIGABRT always is, and `callback` runs before the previous handler for it. The installing
+// thread also gets an alternate signal stack, for stack overflows.
+bool installCrashHandler(CrashCallback callback);
+void uninstallCrashHandler();
+
+}   // namespace mlogger
+
+#endif   // CRASH_HANDLER_H
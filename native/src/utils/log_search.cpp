@@ -0,0 +1,508 @@
+#include "log_search.h"
+#include "sinks/mapped_log_file.h"
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <spdlog/common.h>
+#include <thread>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define MLOGGER_SEARCH_X86 1
+#    include <immintrin.h>
+#    if defined(_MSC_VER)
+#        include <intrin.h>
+#    endif
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#    define MLOGGER_SEARCH_NEON 1
+#    include <arm_neon.h>
+#    if defined(_MSC_VER)
+#        include <intrin.h>
+#    endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#    define MLOGGER_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#    define MLOGGER_TARGET_AVX2
+#endif
+
+#if defined(_WIN32) || defined(_WIN64)
+#    include <windows.h>
+#else
+#    include <cerrno>
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+namespace mlogger
+{
+
+namespace
+{
+
+constexpr size_t   kMinBytesPerThread = 8 * 1024 * 1024;
+constexpr size_t   kLevelScan         = 128;   // bytes at the start of a line holding its level
+constexpr int      kLevelCount        = 6;     // trace .. critical, LogLevel and spdlog agree
+constexpr int      kDefaultLevel      = spdlog::level::info;
+constexpr unsigned kAllLevels         = (1u << kLevelCount) - 1;
+
+unsigned char foldCase(unsigned char c)
+{
+    return c >= 'A' && c <= 'Z' ? static_cast<unsigned char>(c | 0x20) : c;
+}
+
+bool isLower(unsigned char c)
+{
+    return c >= 'a' && c <= 'z';
+}
+
+// The kernels compare the first and the last byte of the needle at every position of a block
+// and only check the candidates where both match, so the bytes in between are rarely read.
+// Ignoring case, a letter is compared after OR-ing 0x20 into the text: only its two cases turn
+// into the lower case letter, no other byte does.
+struct Needle {
+    std::string   bytes;   // lower case when case is ignored
+    bool          ignore_case;
+    unsigned char first;
+    unsigned char last;
+    unsigned char first_fold;   // 0x20 when `first` is a letter and case is ignored, else 0
+    unsigned char last_fold;
+
+    Needle(const std::string& text, bool ignore)
+        : bytes(text)
+        , ignore_case(ignore)
+    {
+        if (ignore_case) {
+            for (char& c : bytes) {
+                c = static_cast<char>(foldCase(static_cast<unsigned char>(c)));
+            }
+        }
+        first      = static_cast<unsigned char>(bytes.front());
+        last       = static_cast<unsigned char>(bytes.back());
+        first_fold = ignore_case && isLower(first) ? 0x20 : 0;
+        last_fold  = ignore_case && isLower(last) ? 0x20 : 0;
+    }
+
+    bool matchesAt(const char* text) const
+    {
+        if (!ignore_case) return std::memcmp(text, bytes.data(), bytes.size()) == 0;
+        for (size_t i = 0; i < bytes.size(); ++i) {
+            if (foldCase(static_cast<unsigned char>(text[i])) !=
+                static_cast<unsigned char>(bytes[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+// first match in [begin, end), null when there is none
+using FindFn = const char* (*)(const char* begin, const char* end, const Needle& needle);
+
+const char* findScalar(const char* begin, const char* end, const Needle& needle)
+{
+    size_t size = needle.bytes.size();
+    if (static_cast<size_t>(end - begin) < size) return nullptr;
+
+    const char* last = end - size;
+    if (!needle.first_fold) {
+        for (const char* p = begin; p <= last; ++p) {
+            p = static_cast<const char*>(std::memchr(p, needle.first, last - p + 1));
+            if (!p) return nullptr;
+            if (needle.matchesAt(p)) return p;
+        }
+        return nullptr;
+    }
+
+    for (const char* p = begin; p <= last; ++p) {
+        if ((static_cast<unsigned char>(*p) | 0x20) == needle.first && needle.matchesAt(p)) {
+            return p;
+        }
+    }
+    return nullptr;
+}
+
+#if defined(MLOGGER_SEARCH_X86)
+
+unsigned countTrailingZeros(unsigned value)
+{
+#    if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, value);
+    return static_cast<unsigned>(index);
+#    else
+    return static_cast<unsigned>(__builtin_ctz(value));
+#    endif
+}
+
+const char* findSse2(const char* begin, const char* end, const Needle& needle)
+{
+    size_t        size       = needle.bytes.size();
+    const __m128i first      = _mm_set1_epi8(static_cast<char>(needle.first));
+    const __m128i last       = _mm_set1_epi8(static_cast<char>(needle.last));
+    const __m128i first_fold = _mm_set1_epi8(static_cast<char>(needle.first_fold));
+    const __m128i last_fold  = _mm_set1_epi8(static_cast<char>(needle.last_fold));
+
+    const char* p = begin;
+    for (; static_cast<size_t>(end - p) >= size - 1 + 16; p += 16) {
+        __m128i block_first =
+            _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), first_fold);
+        __m128i block_last = _mm_or_si128(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + size - 1)), last_fold);
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(block_first, first), _mm_cmpeq_epi8(block_last, last))));
+        for (; mask != 0; mask &= mask - 1) {
+            const char* candidate = p + countTrailingZeros(mask);
+            if (needle.matchesAt(candidate)) return candidate;
+        }
+    }
+    return findScalar(p, end, needle);
+}
+
+MLOGGER_TARGET_AVX2 const char* findAvx2(const char* begin, const char* end, const Needle& needle)
+{
+    size_t        size       = needle.bytes.size();
+    const __m256i first      = _mm256_set1_epi8(static_cast<char>(needle.first));
+    const __m256i last       = _mm256_set1_epi8(static_cast<char>(needle.last));
+    const __m256i first_fold = _mm256_set1_epi8(static_cast<char>(needle.first_fold));
+    const __m256i last_fold  = _mm256_set1_epi8(static_cast<char>(needle.last_fold));
+
+    const char* p = begin;
+    for (; static_cast<size_t>(end - p) >= size - 1 + 32; p += 32) {
+        __m256i block_first = _mm256_or_si256(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)), first_fold);
+        __m256i block_last = _mm256_or_si256(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + size - 1)), last_fold);
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_and_si256(
+            _mm256_cmpeq_epi8(block_first, first), _mm256_cmpeq_epi8(block_last, last))));
+        for (; mask != 0; mask &= mask - 1) {
+            const char* candidate = p + countTrailingZeros(mask);
+            if (needle.matchesAt(candidate)) return candidate;
+        }
+    }
+    return findSse2(p, end, needle);
+}
+
+bool cpuHasAvx2()
+{
+#    if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+
+    // the OS has to save the YMM registers too
+    __cpuid(info, 1);
+    bool avx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0;
+    if (!avx || (_xgetbv(0) & 6) != 6) return false;
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#    else
+    return __builtin_cpu_supports("avx2");
+#    endif
+}
+
+#elif defined(MLOGGER_SEARCH_NEON)
+
+unsigned countTrailingZeros64(uint64_t value)
+{
+#    if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return static_cast<unsigned>(index);
+#    else
+    return static_cast<unsigned>(__builtin_ctzll(value));
+#    endif
+}
+
+const char* findNeon(const char* begin, const char* end, const Needle& needle)
+{
+    size_t           size       = needle.bytes.size();
+    const uint8x16_t first      = vdupq_n_u8(needle.first);
+    const uint8x16_t last       = vdupq_n_u8(needle.last);
+    const uint8x16_t first_fold = vdupq_n_u8(needle.first_fold);
+    const uint8x16_t last_fold  = vdupq_n_u8(needle.last_fold);
+
+    const char* p = begin;
+    for (; static_cast<size_t>(end - p) >= size - 1 + 16; p += 16) {
+        uint8x16_t block_first =
+            vorrq_u8(vld1q_u8(reinterpret_cast<const uint8_t*>(p)), first_fold);
+        uint8x16_t block_last =
+            vorrq_u8(vld1q_u8(reinterpret_cast<const uint8_t*>(p + size - 1)), last_fold);
+        uint8x16_t matches = vandq_u8(vceqq_u8(block_first, first), vceqq_u8(block_last, last));
+
+        // NEON has no movemask: narrowing keeps a nibble per byte, 0xF where it matched
+        uint64_t mask = vget_lane_u64(
+            vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(matches), 4)), 0);
+        while (mask != 0) {
+            unsigned    bit       = countTrailingZeros64(mask);
+            const char* candidate = p + bit / 4;
+            if (needle.matchesAt(candidate)) return candidate;
+            mask &= ~(static_cast<uint64_t>(0xF) << (bit & ~3u));
+        }
+    }
+    return findScalar(p, end, needle);
+}
+
+#endif
+
+struct Kernel {
+    FindFn      find;
+    const char* name;
+};
+
+Kernel selectKernel()
+{
+#if defined(MLOGGER_SEARCH_X86)
+    if (cpuHasAvx2()) return {findAvx2, "avx2"};
+    return {findSse2, "sse2"};
+#elif defined(MLOGGER_SEARCH_NEON)
+    return {findNeon, "neon"};
+#else
+    return {findScalar, "scalar"};
+#endif
+}
+
+const Kernel& bestKernel()
+{
+    static const Kernel kernel = selectKernel();
+    return kernel;
+}
+
+int lineLevel(const char* line, const char* end)
+{
+    static const auto names = [] {
+        std::vector<std::string> result;
+        for (int level = 0; level < kLevelCount; ++level) {
+            auto name = spdlog::level::to_string_view(
+                static_cast<spdlog::level::level_enum>(level));
+            result.emplace_back(name.data(), name.size());
+        }
+        return result;
+    }();
+
+    const char* limit = line + std::min(static_cast<size_t>(end - line), kLevelScan);
+    for (const char* p = line; p < limit; ++p) {
+        p = static_cast<const char*>(std::memchr(p, '[', limit - p));
+        if (!p) break;
+        const char* close = static_cast<const char*>(std::memchr(p + 1, ']', limit - p - 1));
+        if (!close) break;
+
+        size_t length = static_cast<size_t>(close - p - 1);
+        for (int level = 0; level < kLevelCount; ++level) {
+            const std::string& name = names[level];
+            if (name.size() == length && std::memcmp(p + 1, name.data(), length) == 0) {
+                return level;
+            }
+        }
+    }
+    return kDefaultLevel;
+}
+
+// `begin` is at the start of a line, `end` at the end of one or of the data
+void searchRange(const char* data, size_t begin, size_t end, const Needle* needle, FindFn find,
+                 unsigned level_mask, std::vector<uint64_t>& offsets)
+{
+    const char* p    = data + begin;
+    const char* stop = data + end;
+    while (p < stop) {
+        const char* line = p;
+        if (needle) {
+            const char* hit = find(p, stop, *needle);
+            if (!hit) return;
+            for (line = hit; line > p && line[-1] != '\n'; --line) {
+            }
+            p = hit;
+        }
+
+        auto line_end = static_cast<const char*>(std::memchr(p, '\n', stop - p));
+        if (!line_end) line_end = stop;
+        if (level_mask == kAllLevels || ((level_mask >> lineLevel(line, line_end)) & 1) != 0) {
+            offsets.push_back(static_cast<uint64_t>(line - data));
+        }
+        p = line_end + 1;
+    }
+}
+
+// The whole file mapped read-only, empty when it has no data.
+class FileView
+{
+public:
+    bool open(const std::string& path, std::string* error);
+    ~FileView();
+
+    const char* data() const { return static_cast<const char*>(data_); }
+    size_t      size() const { return size_; }
+
+private:
+    void*  data_ = nullptr;
+    size_t size_ = 0;
+
+#if defined(_WIN32) || defined(_WIN64)
+    HANDLE file_    = INVALID_HANDLE_VALUE;
+    HANDLE mapping_ = nullptr;
+#endif
+};
+
+bool setError(std::string* error, const std::string& what)
+{
+    if (error) *error = what;
+    return false;
+}
+
+bool FileView::open(const std::string& path, std::string* error)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    // NOTE: shared like the writer's handle, the file stays writable and can be rotated
+    file_ = ::CreateFileA(path.c_str(), GENERIC_READ,
+                          FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                          OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                          nullptr);
+    if (file_ == INVALID_HANDLE_VALUE) return setError(error, "cannot open " + path);
+
+    LARGE_INTEGER size;
+    if (!::GetFileSizeEx(file_, &size)) return setError(error, "cannot read the size of " + path);
+    if (static_cast<uint64_t>(size.QuadPart) > std::numeric_limits<size_t>::max()) {
+        return setError(error, path + " is too large to map");
+    }
+    if (size.QuadPart == 0) return true;
+
+    mapping_ = ::CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping_) return setError(error, "cannot map " + path);
+    data_ = ::MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0);
+    if (!data_) return setError(error, "cannot map " + path);
+    size_ = static_cast<size_t>(size.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return setError(error, "cannot open " + path + ": " + std::strerror(errno));
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        return setError(error, "cannot read the size of " + path);
+    }
+    if (static_cast<uint64_t>(info.st_size) > std::numeric_limits<size_t>::max()) {
+        ::close(fd);
+        return setError(error, path + " is too large to map");
+    }
+    if (info.st_size == 0) {
+        ::close(fd);
+        return true;
+    }
+
+    size_t size = static_cast<size_t>(info.st_size);
+    void*  data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        return setError(error, "cannot map " + path + ": " + std::strerror(errno));
+    }
+    ::madvise(data, size, MADV_SEQUENTIAL);
+    data_ = data;
+    size_ = size;
+#endif
+    return true;
+}
+
+FileView::~FileView()
+{
+#if defined(_WIN32) || defined(_WIN64)
+    if (data_) ::UnmapViewOfFile(data_);
+    if (mapping_) ::CloseHandle(mapping_);
+    if (file_ != INVALID_HANDLE_VALUE) ::CloseHandle(file_);
+#else
+    if (data_) ::munmap(data_, size_);
+#endif
+}
+
+}   // namespace
+
+void searchLines(const char* data, size_t size, const LogSearchQuery& query,
+                 std::vector<uint64_t>& offsets)
+{
+    unsigned level_mask = query.level_mask == 0 ? kAllLevels : query.level_mask & kAllLevels;
+    if (size == 0 || level_mask == 0) return;
+
+    std::unique_ptr<Needle> needle;
+    if (!query.text.empty()) needle = std::make_unique<Needle>(query.text, query.ignore_case);
+    FindFn find = query.scalar ? findScalar : bestKernel().find;
+
+    size_t threads = query.threads;
+    if (threads == 0) {
+        threads = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()),
+                                   size / kMinBytesPerThread);
+    }
+    threads = std::max<size_t>(1, std::min(threads, size));
+    if (threads == 1) {
+        searchRange(data, 0, size, needle.get(), find, level_mask, offsets);
+        return;
+    }
+
+    // every part starts at a line, so no line is cut between two of them
+    std::vector<size_t> bounds(threads + 1, size);
+    bounds[0] = 0;
+    for (size_t i = 1; i < threads; ++i) {
+        size_t from = std::max(size / threads * i, bounds[i - 1]);
+        auto   end  = static_cast<const char*>(std::memchr(data + from, '\n', size - from));
+        bounds[i]   = end ? static_cast<size_t>(end - data) + 1 : size;
+    }
+
+    std::vector<std::vector<uint64_t>> parts(threads);
+    std::vector<std::exception_ptr>    failures(threads);
+    auto                               searchPart = [&](size_t i) {
+        try {
+            searchRange(data, bounds[i], bounds[i + 1], needle.get(), find, level_mask, parts[i]);
+        } catch (...) {
+            failures[i] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (size_t i = 1; i < threads; ++i) {
+        try {
+            workers.emplace_back(searchPart, i);
+        } catch (...) {
+            searchPart(i);   // no thread left, search the part here
+        }
+    }
+    searchPart(0);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    for (const std::exception_ptr& failure : failures) {
+        if (failure) std::rethrow_exception(failure);
+    }
+
+    size_t total = offsets.size();
+    for (const auto& part : parts) {
+        total += part.size();
+    }
+    offsets.reserve(total);
+    for (const auto& part : parts) {
+        offsets.insert(offsets.end(), part.begin(), part.end());
+    }
+}
+
+bool searchLogFile(const std::string& path, const LogSearchQuery& query,
+                   std::vector<uint64_t>& offsets, std::string* error)
+{
+    FileView view;
+    if (!view.open(path, error)) return false;
+
+    // NOTE: a file open in a MappedLogFile ends with preallocated space, only its data counts
+    size_t size = MappedLogFile::dataLength(view.data(), view.size());
+    searchLines(view.data(), size, query, offsets);
+    return true;
+}
+
+const char* searchKernelName()
+{
+    return bestKernel().name;
+}
+
+}   // namespace mlogger
@@ -0,0 +1,41 @@
+#ifndef LOG_SEARCH_H
+#define LOG_SEARCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mlogger
+{
+
+// Search of text log files for the viewer: the lines holding a substring, optionally of some
+// levels only. The file is mapped rather than read, scanned with SIMD (AVX2 or SSE2 on x86, NEON
+// on ARM, a scalar loop elsewhere) and split across threads when it is large, so a search costs
+// about one pass over the page cache.
+//
+// A line's level is the first "[<level name>]" field near its start, as the default pattern
+// writes it; lines without one, such as the continuation of a multi-line message, count as info.
+struct LogSearchQuery {
+    std::string text;                       // empty matches every line
+    bool        ignore_case = false;        // ASCII letters only
+    unsigned    level_mask  = 0;            // bit per LogLevel, 0 = every level
+    unsigned    threads     = 0;            // 0 = by file size and hardware concurrency
+    bool        scalar      = false;        // skip the SIMD kernels, for tests
+};
+
+// Appends the offsets of the matching lines of `data` to `offsets`, in file order.
+void searchLines(const char* data, size_t size, const LogSearchQuery& query,
+                 std::vector<uint64_t>& offsets);
+
+// Same for the file at `path`. The writer may keep appending, what was in the file when it was
+// mapped is searched. False with `error` set when the file cannot be read.
+bool searchLogFile(const std::string& path, const LogSearchQuery& query,
+                   std::vector<uint64_t>& offsets, std::string* error = nullptr);
+
+// "avx2", "sse2", "neon" or "scalar": the kernel searchLines() uses on this machine
+const char* searchKernelName();
+
+}   // namespace mlogger
+
+#endif   // LOG_SEARCH_H
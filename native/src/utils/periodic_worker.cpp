@@ -0,0 +1,31 @@
+#include "periodic_worker.h"
+
+namespace mlogger
+{
+
+PeriodicWorker::PeriodicWorker(std::function<void()> callback, std::chrono::milliseconds interval,
+                               std::function<void()> on_start)
+{
+    worker_ = std::thread([this, callback = std::move(callback), interval,
+                           on_start = std::move(on_start)]() {
+        if (on_start) on_start();
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stop_cv_.wait_for(lock, interval, [this]() { return stop_; })) {
+            lock.unlock();
+            callback();
+            lock.lock();
+        }
+    });
+}
+
+PeriodicWorker::~PeriodicWorker()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    stop_cv_.notify_all();
+    if (worker_.joinable()) worker_.join();
+}
+
+}   // namespace mlogger
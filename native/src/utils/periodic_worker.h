@@ -0,0 +1,36 @@
+#ifndef PERIODIC_WORKER_H
+#define PERIODIC_WORKER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace mlogger
+{
+
+// Calls `callback` every `interval` on a thread of its own until destroyed. Like
+// spdlog::details::periodic_worker, but with millisecond intervals on every spdlog version.
+class PeriodicWorker final
+{
+public:
+    // `on_start` runs once on the worker thread before the first interval
+    PeriodicWorker(std::function<void()> callback, std::chrono::milliseconds interval,
+                   std::function<void()> on_start = nullptr);
+    // waits for a running callback, the callback is not invoked again
+    ~PeriodicWorker();
+
+    PeriodicWorker(const PeriodicWorker&)            = delete;
+    PeriodicWorker& operator=(const PeriodicWorker&) = delete;
+
+private:
+    std::mutex              mutex_;
+    std::condition_variable stop_cv_;
+    bool                    stop_ = false;
+    std::thread             worker_;
+};
+
+}   // namespace mlogger
+
+#endif   // PERIODIC_WORKER_H
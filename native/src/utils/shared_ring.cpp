@@ -0,0 +1,446 @@
+#include "shared_ring.h"
+#include <cerrno>
+#include <cstring>
+#include <thread>
+
+#if defined(_WIN32) || defined(_WIN64)
+#    include <windows.h>
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#    if defined(__APPLE__)
+#        include <TargetConditionals.h>
+#    endif
+#endif
+
+#if defined(__ANDROID__) || (defined(__APPLE__) && TARGET_OS_IPHONE)
+#    define MLOGGER_NO_SHARED_MEMORY
+#endif
+
+namespace mlogger
+{
+
+// NOTE: the fields are shared with other processes, which may run another build of the library;
+// anything changing the layout bumps kVersion
+struct SharedRing::Segment {
+    char                  magic[8];
+    uint32_t              version;
+    std::atomic<uint32_t> ready;   // set once the fields above are written
+    uint64_t              capacity;
+
+    alignas(64) std::atomic<uint64_t> reserve_pos;
+    std::atomic<uint64_t>             dropped;
+
+    alignas(64) std::atomic<uint64_t> read_pos;
+    std::atomic<uint64_t>             skipped;
+    std::atomic<uint32_t>             reader;   // 1 while a reader is attached
+};
+
+// NOTE: sequence carries the state of the block at `position`: position + 1 tagged kReserved once
+// size and kind are written, untagged once published, tagged kAbandoned once the reader gave up
+// on it. Anything else is left from an earlier lap of the ring.
+struct SharedRing::BlockHeader {
+    std::atomic<uint64_t> sequence;
+    uint32_t              size;   // bytes following the header
+    uint32_t              kind;
+};
+
+namespace
+{
+
+constexpr char     kMagic[8]    = {'M', 'L', 'O', 'G', 'S', 'H', 'M', '\0'};
+constexpr uint32_t kVersion     = 2;
+constexpr size_t   kSegmentSize = 256;   // bytes before the ring
+constexpr uint32_t kDataBlock   = 0;
+constexpr uint32_t kPadding     = 1;     // the rest of the ring, skipped
+// BlockHeader::sequence tags, positions never get near them
+constexpr uint64_t kReserved  = uint64_t(1) << 63;
+constexpr uint64_t kAbandoned = uint64_t(1) << 62;
+// how long open() waits for another process creating the segment
+constexpr auto kCreateTimeout = std::chrono::seconds(1);
+// how often waitUntilRead() looks at the reader
+constexpr auto kReadPollInterval = std::chrono::milliseconds(1);
+
+// NOTE: the atomics are used across processes, which is only sound when they are lock-free
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "64-bit atomics must be lock-free");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "32-bit atomics must be lock-free");
+
+size_t roundUp16(size_t value)
+{
+    return (value + 15) & ~static_cast<size_t>(15);
+}
+
+size_t roundUpPow2(size_t value)
+{
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+bool fail(std::string& error, const std::string& message)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    error = message + " (error " + std::to_string(::GetLastError()) + ")";
+#else
+    error = message + ": " + std::strerror(errno);
+#endif
+    return false;
+}
+
+#if !defined(MLOGGER_NO_SHARED_MEMORY)
+std::string segmentName(const std::string& name)
+{
+#    if defined(_WIN32) || defined(_WIN64)
+    return "Local\\mlogger." + name;
+#    else
+    return "/mlogger." + name;
+#    endif
+}
+#endif
+
+}   // namespace
+
+bool SharedRing::isSupported()
+{
+#if defined(MLOGGER_NO_SHARED_MEMORY)
+    return false;
+#else
+    return true;
+#endif
+}
+
+bool SharedRing::isValidName(const std::string& name)
+{
+    if (name.empty() || name.size() > kMaxNameLength) {
+        return false;
+    }
+    for (char c : name) {
+        bool letter = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+        if (!letter && c != '.' && c != '_' && c != '-') return false;
+    }
+    return true;
+}
+
+std::unique_ptr<SharedRing> SharedRing::open(const std::string& name, size_t capacity,
+                                             std::string& error)
+{
+    if (!isSupported()) {
+        error = "shared memory segments are not supported on this platform";
+        return nullptr;
+    }
+    if (!isValidName(name)) {
+        error = "invalid shared memory segment name '" + name + "'";
+        return nullptr;
+    }
+
+    std::unique_ptr<SharedRing> ring(new SharedRing());
+    capacity           = roundUpPow2(capacity < kMinCapacity ? kMinCapacity : capacity);
+    size_t total       = kSegmentSize + capacity;
+    bool   created     = false;
+    void*  memory      = nullptr;
+    size_t mapped_size = 0;
+
+#if defined(MLOGGER_NO_SHARED_MEMORY)
+    (void)total;
+    return nullptr;
+#elif defined(_WIN32) || defined(_WIN64)
+    // NOTE: pagefile backed, created zeroed; an existing mapping keeps its size
+    HANDLE mapping = ::CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                          static_cast<DWORD>(static_cast<uint64_t>(total) >> 32),
+                                          static_cast<DWORD>(total & 0xffffffffu),
+                                          segmentName(name).c_str());
+    if (!mapping) {
+        fail(error, "failed creating the shared memory segment");
+        return nullptr;
+    }
+    created       = ::GetLastError() != ERROR_ALREADY_EXISTS;
+    ring->mapping_ = mapping;
+    memory        = ::MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+    if (!memory) {
+        fail(error, "failed mapping the shared memory segment");
+        return nullptr;
+    }
+    MEMORY_BASIC_INFORMATION info;
+    if (::VirtualQuery(memory, &info, sizeof(info)) == 0) {
+        ::UnmapViewOfFile(memory);
+        fail(error, "failed querying the shared memory segment");
+        return nullptr;
+    }
+    mapped_size = info.RegionSize;
+#else
+    std::string path = segmentName(name);
+    int         fd   = ::shm_open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0660);
+    created          = fd >= 0;
+    if (!created && errno == EEXIST) {
+        fd = ::shm_open(path.c_str(), O_RDWR, 0);
+    }
+    if (fd < 0) {
+        fail(error, "failed opening the shared memory segment " + path);
+        return nullptr;
+    }
+
+    if (created && ::ftruncate(fd, static_cast<off_t>(total)) != 0) {
+        fail(error, "failed sizing the shared memory segment " + path);
+        ::close(fd);
+        ::shm_unlink(path.c_str());
+        return nullptr;
+    }
+    // NOTE: a segment another process just created may not be sized yet
+    auto deadline = std::chrono::steady_clock::now() + kCreateTimeout;
+    for (;;) {
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            fail(error, "failed reading the shared memory segment " + path);
+            ::close(fd);
+            return nullptr;
+        }
+        mapped_size = static_cast<size_t>(info.st_size);
+        if (mapped_size > kSegmentSize || std::chrono::steady_clock::now() >= deadline) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    if (mapped_size <= kSegmentSize) {
+        error = "shared memory segment " + path + " was never set up, remove it";
+        ::close(fd);
+        return nullptr;
+    }
+
+    memory = ::mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (memory == MAP_FAILED) {
+        fail(error, "failed mapping the shared memory segment " + path);
+        return nullptr;
+    }
+#endif
+
+    ring->segment_ = static_cast<Segment*>(memory);
+    ring->mapped_  = mapped_size;
+    Segment& segment = *ring->segment_;
+    if (created) {
+        std::memcpy(segment.magic, kMagic, sizeof(kMagic));
+        segment.version  = kVersion;
+        segment.capacity = capacity;
+        segment.ready.store(1, std::memory_order_release);
+    } else {
+        auto deadline = std::chrono::steady_clock::now() + kCreateTimeout;
+        while (segment.ready.load(std::memory_order_acquire) == 0 &&
+               std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (segment.ready.load(std::memory_order_acquire) == 0 ||
+            std::memcmp(segment.magic, kMagic, sizeof(kMagic)) != 0) {
+            error = "shared memory segment '" + name + "' was not set up by MLogger";
+            return nullptr;
+        }
+        if (segment.version != kVersion) {
+            error = "shared memory segment '" + name + "' has layout version " +
+                    std::to_string(segment.version) + ", expected " + std::to_string(kVersion);
+            return nullptr;
+        }
+        capacity = static_cast<size_t>(segment.capacity);
+        if (capacity < kMinCapacity || (capacity & (capacity - 1)) != 0 ||
+            capacity > mapped_size - kSegmentSize) {
+            error = "shared memory segment '" + name + "' is damaged";
+            return nullptr;
+        }
+    }
+
+    ring->data_     = static_cast<unsigned char*>(memory) + kSegmentSize;
+    ring->capacity_ = capacity;
+    ring->mask_     = capacity - 1;
+    return ring;
+}
+
+bool SharedRing::remove(const std::string& name)
+{
+#if defined(MLOGGER_NO_SHARED_MEMORY) || defined(_WIN32) || defined(_WIN64)
+    (void)name;
+    return false;
+#else
+    return isValidName(name) && ::shm_unlink(segmentName(name).c_str()) == 0;
+#endif
+}
+
+SharedRing::~SharedRing()
+{
+    unmap();
+}
+
+void SharedRing::unmap()
+{
+#if defined(_WIN32) || defined(_WIN64)
+    if (segment_) ::UnmapViewOfFile(segment_);
+    if (mapping_) ::CloseHandle(mapping_);
+    mapping_ = nullptr;
+#elif !defined(MLOGGER_NO_SHARED_MEMORY)
+    if (segment_) ::munmap(segment_, mapped_);
+#endif
+    segment_ = nullptr;
+    data_    = nullptr;
+}
+
+SharedRing::BlockHeader* SharedRing::blockAt(uint64_t position) const
+{
+    return reinterpret_cast<BlockHeader*>(data_ + (position & mask_));
+}
+
+bool SharedRing::tryReserve(size_t size, Block& block)
+{
+    size_t total = roundUp16(kBlockHeaderSize + size);
+    if (size > maxBlockSize()) {
+        segment_->dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // NOTE: a block that would straddle the end claims the rest of the ring as padding too
+    uint64_t position = segment_->reserve_pos.load(std::memory_order_relaxed);
+    size_t   padding  = 0;
+    for (;;) {
+        size_t   offset = static_cast<size_t>(position & mask_);
+        padding         = offset + total > capacity_ ? capacity_ - offset : 0;
+        uint64_t end    = position + padding + total;
+        if (end - segment_->read_pos.load(std::memory_order_acquire) > capacity_) {
+            segment_->dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        if (segment_->reserve_pos.compare_exchange_weak(position, end, std::memory_order_acq_rel,
+                                                        std::memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    if (padding > 0) {
+        BlockHeader* skip = blockAt(position);
+        skip->size        = static_cast<uint32_t>(padding - kBlockHeaderSize);
+        skip->kind        = kPadding;
+        skip->sequence.store(position + 1, std::memory_order_release);
+        position += padding;
+    }
+
+    BlockHeader* header = blockAt(position);
+    header->size        = static_cast<uint32_t>(size);
+    header->kind        = kDataBlock;
+    header->sequence.store((position + 1) | kReserved, std::memory_order_release);
+    block.data     = header + 1;
+    block.position = position;
+    return true;
+}
+
+bool SharedRing::commit(const Block& block)
+{
+    uint64_t reserved = (block.position + 1) | kReserved;
+    return blockAt(block.position)
+        ->sequence.compare_exchange_strong(reserved, block.position + 1,
+                                           std::memory_order_acq_rel, std::memory_order_relaxed);
+}
+
+bool SharedRing::waitUntilRead(std::chrono::milliseconds stall_timeout)
+{
+    uint64_t target   = segment_->reserve_pos.load(std::memory_order_acquire);
+    uint64_t last     = segment_->read_pos.load(std::memory_order_acquire);
+    auto     progress = std::chrono::steady_clock::now();
+    for (;;) {
+        uint64_t read = segment_->read_pos.load(std::memory_order_acquire);
+        if (read >= target) {
+            return true;
+        }
+        if (segment_->reader.load(std::memory_order_relaxed) == 0) {
+            return false;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (read != last) {
+            last     = read;
+            progress = now;
+        } else if (now - progress >= stall_timeout) {
+            return false;
+        }
+        std::this_thread::sleep_for(kReadPollInterval);
+    }
+}
+
+const void* SharedRing::front(size_t* size)
+{
+    uint64_t read = segment_->read_pos.load(std::memory_order_relaxed);
+    for (;;) {
+        if (read == segment_->reserve_pos.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+
+        BlockHeader* header   = blockAt(read);
+        uint64_t     sequence = header->sequence.load(std::memory_order_acquire);
+        if (sequence != read + 1) {
+            // claimed but not published: a writer still copying, or one that stalled or died
+            // doing so
+            auto now = std::chrono::steady_clock::now();
+            if (stalled_at_ != read) {
+                stalled_at_    = read;
+                stalled_since_ = now;
+                return nullptr;
+            }
+            if (now - stalled_since_ < kAbandonTimeout) {
+                return nullptr;
+            }
+            stalled_at_ = UINT64_MAX;
+
+            uint64_t end = segment_->reserve_pos.load(std::memory_order_acquire);
+            if (sequence == ((read + 1) | kReserved)) {
+                // its size is known, only this block goes. A late commit() sees the tag and
+                // fails, the block stays unread.
+                if (!header->sequence.compare_exchange_strong(sequence, (read + 1) | kAbandoned,
+                                                              std::memory_order_acq_rel)) {
+                    continue;   // published after all
+                }
+                end = read + roundUp16(kBlockHeaderSize + header->size);
+            }
+            // NOTE: otherwise the writer never got to the header, and the blocks claimed since
+            // cannot be found without its size; they go with it
+            segment_->skipped.fetch_add(end - read, std::memory_order_relaxed);
+            segment_->read_pos.store(end, std::memory_order_release);
+            read = end;
+            continue;
+        }
+
+        if (header->kind == kPadding) {
+            read += kBlockHeaderSize + header->size;
+            segment_->read_pos.store(read, std::memory_order_release);
+            continue;
+        }
+        if (size) *size = header->size;
+        return header + 1;
+    }
+}
+
+void SharedRing::pop()
+{
+    uint64_t     read   = segment_->read_pos.load(std::memory_order_relaxed);
+    BlockHeader* header = blockAt(read);
+    segment_->read_pos.store(read + roundUp16(kBlockHeaderSize + header->size),
+                             std::memory_order_release);
+}
+
+void SharedRing::setReaderAttached(bool attached)
+{
+    segment_->reader.store(attached ? 1 : 0, std::memory_order_relaxed);
+}
+
+uint64_t SharedRing::droppedCount() const
+{
+    return segment_->dropped.load(std::memory_order_relaxed);
+}
+
+uint64_t SharedRing::skippedBytes() const
+{
+    return segment_->skipped.load(std::memory_order_relaxed);
+}
+
+size_t SharedRing::usedBytes() const
+{
+    return static_cast<size_t>(segment_->reserve_pos.load(std::memory_order_relaxed) -
+                               segment_->read_pos.load(std::memory_order_relaxed));
+}
+
+}   // namespace mlogger
@@ -0,0 +1,120 @@
+#ifndef SHARED_RING_H
+#define SHARED_RING_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace mlogger
+{
+
+// Ring of variable sized blocks in a named shared memory segment, written by any number of
+// threads in any number of processes and read by one, see SharedMemorySink.
+//
+// Writers claim space with a compare-and-swap on the reserve position and publish a block by
+// stamping its header with its position once the bytes are in, so no writer ever waits for a
+// lock another process may hold. The reader takes blocks in the order they were claimed. A writer
+// dying or stalling in between leaves a block that is not published; once it has held the reader
+// up for kAbandonTimeout, that block is skipped and commit() fails for it, so a writer waking up
+// late cannot publish into space the reader already gave back. Only when the writer stopped
+// before writing the block header, a few instructions after claiming it, is its size unknown and
+// everything claimed until then skipped with it.
+//
+// NOTE: a late writer may still be copying into the skipped block. That only touches another
+// writer's block when the ring went around once more during the stall, writers reach skipped
+// space only after everything claimed after it.
+//
+// The segment outlives the processes mapping it (until remove(), on Windows until the last of
+// them closes it), so what is published while no reader runs is read by the next one, as much as
+// the ring holds. Blocks are 16-byte aligned and never straddle the end of the ring.
+class SharedRing final
+{
+public:
+    static constexpr size_t kMinCapacity    = 64 * 1024;
+    static constexpr size_t kMaxNameLength  = 20;
+    static constexpr auto   kAbandonTimeout = std::chrono::seconds(1);
+
+    // a block claimed by tryReserve(), `data` holds its bytes until commit()
+    struct Block {
+        void*    data     = nullptr;
+        uint64_t position = 0;
+    };
+
+    // named shared memory: POSIX shm_open, Windows file mappings; not on Android and iOS
+    static bool isSupported();
+    // 1 to kMaxNameLength characters of [A-Za-z0-9._-]
+    static bool isValidName(const std::string& name);
+
+    // Maps the segment `name`, creating it with a ring of `capacity` bytes (at least
+    // kMinCapacity, rounded up to a power of two) when there is none; an existing segment keeps
+    // its capacity. Null on failure, with the reason in `error`.
+    static std::unique_ptr<SharedRing> open(const std::string& name, size_t capacity,
+                                            std::string& error);
+    // deletes the name, segments already mapped stay usable; a no-op on Windows
+    static bool remove(const std::string& name);
+
+    ~SharedRing();
+
+    size_t capacity() const { return capacity_; }
+    // largest block tryReserve() accepts
+    size_t maxBlockSize() const { return capacity_ / 4 - kBlockHeaderSize; }
+
+    // writer side, any thread of any process: claims `size` bytes, false when the ring has no
+    // room for them, which counts the block as dropped
+    bool tryReserve(size_t size, Block& block);
+    // publishes the block, false when the reader skipped it for taking longer than
+    // kAbandonTimeout
+    bool commit(const Block& block);
+    // Waits until everything claimed before the call was read. False at once while no reader is
+    // attached, and once the reader made no progress for `stall_timeout`.
+    bool waitUntilRead(std::chrono::milliseconds stall_timeout);
+
+    // reader side, one thread of one process: the next published block or nullptr
+    const void* front(size_t* size = nullptr);
+    void        pop();
+    // announces the reader to the writers, see waitUntilRead(); one reader per segment
+    void setReaderAttached(bool attached);
+
+    // blocks refused for want of room since the segment was created
+    uint64_t droppedCount() const;
+    // bytes of blocks the reader skipped since the segment was created, claimed by writers that
+    // died or stalled
+    uint64_t skippedBytes() const;
+    // claimed bytes not read yet
+    size_t usedBytes() const;
+
+    SharedRing(const SharedRing&)            = delete;
+    SharedRing& operator=(const SharedRing&) = delete;
+
+private:
+    struct Segment;
+    struct BlockHeader;
+
+    static constexpr size_t kBlockHeaderSize = 16;
+
+    SharedRing() = default;
+
+    BlockHeader* blockAt(uint64_t position) const;
+    void         unmap();
+
+    Segment*       segment_  = nullptr;
+    unsigned char* data_     = nullptr;
+    size_t         capacity_ = 0;
+    size_t         mask_     = 0;
+    size_t         mapped_   = 0;   // bytes of the mapping
+
+    // reader owned
+    uint64_t                              stalled_at_ = UINT64_MAX;   // unpublished block seen
+    std::chrono::steady_clock::time_point stalled_since_;
+
+#if defined(_WIN32) || defined(_WIN64)
+    void* mapping_ = nullptr;
+#endif
+};
+
+}   // namespace mlogger
+
+#endif   // SHARED_RING_H
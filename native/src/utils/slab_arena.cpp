@@ -0,0 +1,95 @@
+#include "slab_arena.h"
+
+namespace mlogger
+{
+
+namespace
+{
+
+size_t align8(size_t value)
+{
+    return (value + 7) & ~static_cast<size_t>(7);
+}
+
+}   // namespace
+
+SlabArena::~SlabArena()
+{
+    // NOTE: the owner guarantees that nothing is left to release
+    delete current_;
+    while (retired_) {
+        Slab* next = retired_->next;
+        delete retired_;
+        retired_ = next;
+    }
+}
+
+char* SlabArena::allocate(size_t size, Slab*& slab)
+{
+    size_t need = align8(size);
+    if (need > kSlabSize) {
+        // NOTE: not pooled, a rare large payload must not stay allocated for the producer's life
+        slab            = new Slab();
+        slab->capacity  = need;
+        slab->oversized = true;
+        slab->data      = std::make_unique<char[]>(need);
+        slab->used      = need;
+        slab->allocated = 1;
+        return slab->data.get();
+    }
+
+    if (current_ && current_->idle()) {
+        // everything carved out so far was released, start over at the front
+        current_->used = 0;
+    }
+    if (!current_ || current_->capacity - current_->used < need) {
+        current_ = nextSlab();
+    }
+
+    char* data = current_->data.get() + current_->used;
+    current_->used += need;
+    ++current_->allocated;
+    slab = current_;
+    return data;
+}
+
+void SlabArena::release(Slab* slab)
+{
+    if (slab->oversized) {
+        delete slab;
+        return;
+    }
+    slab->released.fetch_add(1, std::memory_order_release);
+}
+
+SlabArena::Slab* SlabArena::nextSlab()
+{
+    if (current_) {
+        current_->next = nullptr;
+        if (retired_end_) {
+            retired_end_->next = current_;
+        } else {
+            retired_ = current_;
+        }
+        retired_end_ = current_;
+    }
+
+    // slabs are released in the order they were filled, so only the oldest can be idle first
+    if (retired_ && retired_->idle()) {
+        Slab* slab = retired_;
+        retired_   = slab->next;
+        if (!retired_) retired_end_ = nullptr;
+
+        slab->used = 0;
+        slab->next = nullptr;
+        return slab;
+    }
+
+    auto* slab     = new Slab();
+    slab->capacity = kSlabSize;
+    slab->data     = std::make_unique<char[]>(slab->capacity);
+    ++slab_count_;
+    return slab;
+}
+
+}   // namespace mlogger
@@ -0,0 +1,66 @@
+#ifndef SLAB_ARENA_H
+#define SLAB_ARENA_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace mlogger
+{
+
+// Single-producer bump allocator whose allocations are released by one consumer in the order
+// they were made. Memory comes from slabs of kSlabSize bytes; a slab is reused as a whole once
+// every allocation carved out of it was released, so a producer that keeps pace with its consumer
+// stops calling malloc after its first few slabs.
+//
+// A request larger than kSlabSize gets a slab of its own, which release() frees: the arena keeps
+// no memory for it once it was released, only its pooled kSlabSize slabs.
+class SlabArena final
+{
+public:
+    static constexpr size_t kSlabSize = 64 * 1024;
+
+    struct Slab;
+
+    SlabArena() = default;
+    ~SlabArena();
+
+    // producer side: `size` bytes that stay valid until release() is called with `slab`
+    char* allocate(size_t size, Slab*& slab);
+    // consumer side, once per allocation
+    static void release(Slab* slab);
+
+    // pooled slabs owned by the arena, in use or idle; oversized ones are not counted
+    size_t slabCount() const { return slab_count_; }
+
+    SlabArena(const SlabArena&)            = delete;
+    SlabArena& operator=(const SlabArena&) = delete;
+
+private:
+    Slab* nextSlab();
+
+    // producer owned
+    Slab*  current_     = nullptr;
+    Slab*  retired_     = nullptr;   // oldest first, linked through Slab::next
+    Slab*  retired_end_ = nullptr;
+    size_t slab_count_  = 0;
+};
+
+struct SlabArena::Slab {
+    std::unique_ptr<char[]> data;
+    size_t                  capacity  = 0;
+    bool                    oversized = false;     // one allocation, freed by release()
+    size_t                  used      = 0;         // producer owned
+    uint64_t                allocated = 0;         // producer owned, never reset
+    Slab*                   next      = nullptr;   // producer owned
+
+    // consumer owned, never reset: the slab is idle while released == allocated
+    alignas(64) std::atomic<uint64_t> released{0};
+
+    bool idle() const { return released.load(std::memory_order_acquire) == allocated; }
+};
+
+}   // namespace mlogger
+
+#endif   // SLAB_ARENA_H
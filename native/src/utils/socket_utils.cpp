@@ -0,0 +1,364 @@
+#include "socket_utils.h"
+#include <cstring>
+
+#if defined(_WIN32) || defined(_WIN64)
+#    include <winsock2.h>
+#    include <ws2tcpip.h>
+#else
+#    include <cerrno>
+#    include <fcntl.h>
+#    include <netdb.h>
+#    include <netinet/in.h>
+#    include <netinet/tcp.h>
+#    include <poll.h>
+#    include <sys/socket.h>
+#    include <unistd.h>
+#endif
+
+namespace mlogger
+{
+
+namespace
+{
+
+#if defined(_WIN32) || defined(_WIN64)
+
+using NativeSocket = SOCKET;
+
+bool startSockets()
+{
+    // NOTE: never paired with WSACleanup, other sockets of the process may outlive the logger
+    static const bool started = []() {
+        WSADATA data;
+        return ::WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }();
+    return started;
+}
+
+int lastError()
+{
+    return ::WSAGetLastError();
+}
+
+bool wouldBlock(int error)
+{
+    return error == WSAEWOULDBLOCK || error == WSAEINPROGRESS;
+}
+
+bool setNonBlocking(NativeSocket socket)
+{
+    u_long enabled = 1;
+    return ::ioctlsocket(socket, FIONBIO, &enabled) == 0;
+}
+
+int pollOne(NativeSocket socket, short events, int timeout_ms)
+{
+    WSAPOLLFD entry{};
+    entry.fd     = socket;
+    entry.events = events;
+    return ::WSAPoll(&entry, 1, timeout_ms);
+}
+
+#else
+
+using NativeSocket = int;
+
+bool startSockets()
+{
+    return true;
+}
+
+int lastError()
+{
+    return errno;
+}
+
+bool wouldBlock(int error)
+{
+    return error == EAGAIN || error == EWOULDBLOCK || error == EINPROGRESS;
+}
+
+bool setNonBlocking(NativeSocket socket)
+{
+    int flags = ::fcntl(socket, F_GETFL, 0);
+    return flags >= 0 && ::fcntl(socket, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+int pollOne(NativeSocket socket, short events, int timeout_ms)
+{
+    pollfd entry{};
+    entry.fd     = socket;
+    entry.events = events;
+    int ready    = 0;
+    do {
+        ready = ::poll(&entry, 1, timeout_ms);
+    } while (ready < 0 && errno == EINTR);
+    return ready;
+}
+
+#endif
+
+#if defined(MSG_NOSIGNAL)
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = 0;
+#endif
+
+NativeSocket native(SocketHandle socket)
+{
+    return static_cast<NativeSocket>(socket);
+}
+
+std::string errorText(int error)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    char text[256] = {};
+    ::FormatMessageA(FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS, nullptr,
+                     static_cast<DWORD>(error), 0, text, sizeof(text), nullptr);
+    size_t length = std::strlen(text);
+    while (length > 0 && (text[length - 1] == '\n' || text[length - 1] == '\r')) {
+        text[--length] = '\0';
+    }
+    return text;
+#else
+    return std::strerror(error);
+#endif
+}
+
+bool splitAddress(const std::string& address, std::string& host, std::string& port)
+{
+    size_t colon = address.rfind(':');
+    if (colon == std::string::npos || colon + 1 == address.size()) {
+        return false;
+    }
+    host = address.substr(0, colon);
+    port = address.substr(colon + 1);
+    if (host.size() >= 2 && host.front() == '[' && host.back() == ']') {
+        host = host.substr(1, host.size() - 2);
+    }
+    return true;
+}
+
+addrinfo* resolve(const std::string& address, SocketType type, bool passive, std::string& error)
+{
+    std::string host, port;
+    if (!splitAddress(address, host, port)) {
+        error = "expected host:port, got \"" + address + "\"";
+        return nullptr;
+    }
+
+    addrinfo hints{};
+    hints.ai_family   = AF_UNSPEC;
+    hints.ai_socktype = type == SocketType::tcp ? SOCK_STREAM : SOCK_DGRAM;
+    hints.ai_flags    = passive ? AI_PASSIVE : 0;
+    addrinfo* found   = nullptr;
+    int       result  = ::getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints,
+                                      &found);
+    if (result != 0) {
+        error = "cannot resolve " + address + ": " + ::gai_strerror(result);
+        return nullptr;
+    }
+    return found;
+}
+
+SocketHandle openSocket(const addrinfo& entry)
+{
+    NativeSocket created = ::socket(entry.ai_family, entry.ai_socktype, entry.ai_protocol);
+#if defined(_WIN32) || defined(_WIN64)
+    if (created == INVALID_SOCKET) return kInvalidSocket;
+#else
+    if (created < 0) return kInvalidSocket;
+#endif
+    SocketHandle socket = static_cast<SocketHandle>(created);
+    if (!setNonBlocking(created)) {
+        closeSocket(socket);
+        return kInvalidSocket;
+    }
+#if defined(SO_NOSIGPIPE)
+    int enabled = 1;
+    ::setsockopt(created, SOL_SOCKET, SO_NOSIGPIPE, &enabled, sizeof(enabled));
+#endif
+    return socket;
+}
+
+}   // namespace
+
+SocketHandle connectSocket(const std::string& address, SocketType type, int timeout_ms,
+                           std::string& error)
+{
+    if (!startSockets()) {
+        error = "cannot start Winsock";
+        return kInvalidSocket;
+    }
+    addrinfo* found = resolve(address, type, false, error);
+    if (!found) {
+        return kInvalidSocket;
+    }
+
+    SocketHandle connected = kInvalidSocket;
+    for (addrinfo* entry = found; entry && connected == kInvalidSocket; entry = entry->ai_next) {
+        SocketHandle socket = openSocket(*entry);
+        if (socket == kInvalidSocket) {
+            error = "cannot create a socket: " + socketError();
+            continue;
+        }
+        if (type == SocketType::tcp) {
+            int enabled = 1;
+            ::setsockopt(native(socket), IPPROTO_TCP, TCP_NODELAY,
+                         reinterpret_cast<const char*>(&enabled), sizeof(enabled));
+        }
+
+        bool done = ::connect(native(socket), entry->ai_addr,
+                              static_cast<socklen_t>(entry->ai_addrlen)) == 0;
+        if (!done && wouldBlock(lastError())) {
+            // NOTE: SO_ERROR holds the outcome once the socket turns writable
+            int       result = 0;
+            socklen_t length = sizeof(result);
+            done = waitSocket(socket, true, timeout_ms) == 1 &&
+                   ::getsockopt(native(socket), SOL_SOCKET, SO_ERROR,
+                                reinterpret_cast<char*>(&result), &length) == 0 &&
+                   result == 0;
+            if (!done) {
+                error = "cannot connect to " + address + ": " +
+                        (result != 0 ? errorText(result) : std::string("timed out"));
+            }
+        } else if (!done) {
+            error = "cannot connect to " + address + ": " + socketError();
+        }
+
+        if (done) {
+            connected = socket;
+        } else {
+            closeSocket(socket);
+        }
+    }
+    ::freeaddrinfo(found);
+    return connected;
+}
+
+SocketHandle listenSocket(const std::string& address, SocketType type, std::string& error)
+{
+    if (!startSockets()) {
+        error = "cannot start Winsock";
+        return kInvalidSocket;
+    }
+    addrinfo* found = resolve(address, type, true, error);
+    if (!found) {
+        return kInvalidSocket;
+    }
+
+    SocketHandle listening = kInvalidSocket;
+    for (addrinfo* entry = found; entry && listening == kInvalidSocket; entry = entry->ai_next) {
+        SocketHandle socket = openSocket(*entry);
+        if (socket == kInvalidSocket) {
+            error = "cannot create a socket: " + socketError();
+            continue;
+        }
+        int enabled = 1;
+        ::setsockopt(native(socket), SOL_SOCKET, SO_REUSEADDR,
+                     reinterpret_cast<const char*>(&enabled), sizeof(enabled));
+        bool bound = ::bind(native(socket), entry->ai_addr,
+                            static_cast<socklen_t>(entry->ai_addrlen)) == 0 &&
+                     (type != SocketType::tcp || ::listen(native(socket), SOMAXCONN) == 0);
+        if (bound) {
+            listening = socket;
+        } else {
+            error = "cannot listen on " + address + ": " + socketError();
+            closeSocket(socket);
+        }
+    }
+    ::freeaddrinfo(found);
+    return listening;
+}
+
+SocketHandle acceptSocket(SocketHandle listener)
+{
+    NativeSocket accepted = ::accept(native(listener), nullptr, nullptr);
+#if defined(_WIN32) || defined(_WIN64)
+    if (accepted == INVALID_SOCKET) return kInvalidSocket;
+#else
+    if (accepted < 0) return kInvalidSocket;
+#endif
+    SocketHandle socket = static_cast<SocketHandle>(accepted);
+    if (!setNonBlocking(accepted)) {
+        closeSocket(socket);
+        return kInvalidSocket;
+    }
+    return socket;
+}
+
+void closeSocket(SocketHandle socket)
+{
+    if (socket == kInvalidSocket) {
+        return;
+    }
+#if defined(_WIN32) || defined(_WIN64)
+    ::closesocket(native(socket));
+#else
+    ::close(native(socket));
+#endif
+}
+
+int localPort(SocketHandle socket)
+{
+    sockaddr_storage address{};
+    socklen_t        length = sizeof(address);
+    if (::getsockname(native(socket), reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+        return 0;
+    }
+    if (address.ss_family == AF_INET) {
+        return ntohs(reinterpret_cast<const sockaddr_in&>(address).sin_port);
+    }
+    if (address.ss_family == AF_INET6) {
+        return ntohs(reinterpret_cast<const sockaddr_in6&>(address).sin6_port);
+    }
+    return 0;
+}
+
+void setSendBuffer(SocketHandle socket, size_t bytes)
+{
+    int size = static_cast<int>(bytes);
+    ::setsockopt(native(socket), SOL_SOCKET, SO_SNDBUF, reinterpret_cast<const char*>(&size),
+                 sizeof(size));
+}
+
+long sendSocket(SocketHandle socket, const char* data, size_t size)
+{
+    for (;;) {
+#if defined(_WIN32) || defined(_WIN64)
+        long sent = ::send(native(socket), data, static_cast<int>(size), 0);
+#else
+        long sent = static_cast<long>(::send(native(socket), data, size, kSendFlags));
+        if (sent < 0 && errno == EINTR) continue;
+#endif
+        if (sent >= 0) return sent;
+        return wouldBlock(lastError()) ? kSocketWouldBlock : -1;
+    }
+}
+
+long receiveSocket(SocketHandle socket, char* data, size_t size)
+{
+    for (;;) {
+#if defined(_WIN32) || defined(_WIN64)
+        long received = ::recv(native(socket), data, static_cast<int>(size), 0);
+#else
+        long received = static_cast<long>(::recv(native(socket), data, size, 0));
+        if (received < 0 && errno == EINTR) continue;
+#endif
+        if (received >= 0) return received;
+        return wouldBlock(lastError()) ? kSocketWouldBlock : -1;
+    }
+}
+
+int waitSocket(SocketHandle socket, bool write, int timeout_ms)
+{
+    int ready = pollOne(native(socket), write ? POLLOUT : POLLIN, timeout_ms);
+    return ready > 0 ? 1 : ready;
+}
+
+std::string socketError()
+{
+    return errorText(lastError());
+}
+
+}   // namespace mlogger
@@ -0,0 +1,54 @@
+#ifndef SOCKET_UTILS_H
+#define SOCKET_UTILS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace mlogger
+{
+
+// Non-blocking sockets over BSD sockets and Winsock, just what NetworkSink and mlogger_collect
+// need. Addresses are "host:port" ("[::1]:port" for IPv6 literals); host names are resolved with
+// getaddrinfo, which may block.
+
+using SocketHandle = intptr_t;
+
+constexpr SocketHandle kInvalidSocket = -1;
+// result of sendSocket() / receiveSocket() when the call would have to wait
+constexpr long kSocketWouldBlock = -2;
+
+enum class SocketType
+{
+    udp,
+    tcp,
+};
+
+// A socket connected to `address`. TCP connections are waited for at most `timeout_ms`.
+// kInvalidSocket on failure, with the reason in `error`.
+SocketHandle connectSocket(const std::string& address, SocketType type, int timeout_ms,
+                           std::string& error);
+// A socket bound to `address` (port 0 = any free port), listening for TCP.
+SocketHandle listenSocket(const std::string& address, SocketType type, std::string& error);
+// the next pending connection of a TCP listener, kInvalidSocket when there is none
+SocketHandle acceptSocket(SocketHandle listener);
+void         closeSocket(SocketHandle socket);
+
+// 0 when unknown
+int localPort(SocketHandle socket);
+// caps the kernel's send buffer, i.e. the bytes in flight of a TCP connection
+void setSendBuffer(SocketHandle socket, size_t bytes);
+
+// bytes sent, kSocketWouldBlock or -1 on error (see socketError())
+long sendSocket(SocketHandle socket, const char* data, size_t size);
+// bytes received, 0 once a TCP peer closed, kSocketWouldBlock or -1 on error
+long receiveSocket(SocketHandle socket, char* data, size_t size);
+// 1 once the socket can be written (`write`) or read, 0 after `timeout_ms`, -1 on error
+int waitSocket(SocketHandle socket, bool write, int timeout_ms);
+
+// description of the last failed socket call of this thread
+std::string socketError();
+
+}   // namespace mlogger
+
+#endif   // SOCKET_UTILS_H
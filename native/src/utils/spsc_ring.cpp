@@ -0,0 +1,115 @@
+#include "spsc_ring.h"
+#include <cstring>
+
+namespace mlogger
+{
+
+namespace
+{
+
+size_t roundUpPow2(size_t value)
+{
+    size_t result = 64;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+size_t align8(size_t value)
+{
+    return (value + 7) & ~static_cast<size_t>(7);
+}
+
+}   // namespace
+
+SpscRing::SpscRing(size_t capacity)
+    : capacity_(roundUpPow2(capacity))
+    , mask_(capacity_ - 1)
+{
+    data_ = std::make_unique<unsigned char[]>(capacity_);
+}
+
+void* SpscRing::tryReserve(size_t size)
+{
+    if (size > maxBlockSize()) {
+        return nullptr;
+    }
+
+    size_t need       = align8(kHeaderSize + size);
+    size_t pos        = write_pos_.load(std::memory_order_relaxed);
+    size_t offset     = pos & mask_;
+    size_t contiguous = capacity_ - offset;
+    size_t total      = contiguous < need ? contiguous + need : need;
+
+    if (pos + total - cached_read_ > capacity_) {
+        cached_read_ = read_pos_.load(std::memory_order_acquire);
+        if (pos + total - cached_read_ > capacity_) {
+            return nullptr;
+        }
+    }
+
+    if (contiguous < need) {
+        // NOTE: offsets are 8-byte aligned, so there is always room for the marker
+        std::memcpy(data_.get() + offset, &kWrapMarker, sizeof(kWrapMarker));
+        pos += contiguous;
+        offset = 0;
+    }
+
+    uint32_t block_size = static_cast<uint32_t>(size);
+    std::memcpy(data_.get() + offset, &block_size, sizeof(block_size));
+    reserve_pos_ = pos + need;
+    return data_.get() + offset + kHeaderSize;
+}
+
+void SpscRing::commit()
+{
+    write_pos_.store(reserve_pos_, std::memory_order_release);
+}
+
+const void* SpscRing::front(size_t* size)
+{
+    size_t pos = read_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+        if (pos == cached_write_) {
+            cached_write_ = write_pos_.load(std::memory_order_acquire);
+            if (pos == cached_write_) {
+                return nullptr;
+            }
+        }
+
+        size_t   offset = pos & mask_;
+        uint32_t block_size;
+        std::memcpy(&block_size, data_.get() + offset, sizeof(block_size));
+        if (block_size == kWrapMarker) {
+            pos += capacity_ - offset;
+            read_pos_.store(pos, std::memory_order_release);
+            continue;
+        }
+
+        if (size) *size = block_size;
+        return data_.get() + offset + kHeaderSize;
+    }
+}
+
+void SpscRing::pop()
+{
+    size_t   pos    = read_pos_.load(std::memory_order_relaxed);
+    size_t   offset = pos & mask_;
+    uint32_t block_size;
+    std::memcpy(&block_size, data_.get() + offset, sizeof(block_size));
+    read_pos_.store(pos + align8(kHeaderSize + block_size), std::memory_order_release);
+}
+
+bool SpscRing::empty() const
+{
+    return usedBytes() == 0;
+}
+
+size_t SpscRing::usedBytes() const
+{
+    size_t read = read_pos_.load(std::memory_order_acquire);
+    return write_pos_.load(std::memory_order_acquire) - read;
+}
+
+}   // namespace mlogger
@@ -0,0 +1,58 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace mlogger
+{
+
+// Single-producer/single-consumer ring of variable sized blocks.
+// Blocks are 8-byte aligned and never straddle the end of the storage.
+class SpscRing final
+{
+public:
+    // capacity is rounded up to a power of two
+    explicit SpscRing(size_t capacity);
+
+    size_t capacity() const { return capacity_; }
+    // largest block tryReserve() can ever return
+    size_t maxBlockSize() const { return capacity_ / 2 - kHeaderSize; }
+
+    // producer side: reserve `size` bytes, nullptr when the ring is full
+    void* tryReserve(size_t size);
+    void  commit();
+
+    // consumer side: next committed block or nullptr
+    const void* front(size_t* size = nullptr);
+    void        pop();
+    bool        empty() const;
+    // committed bytes not yet consumed, callable from any thread
+    size_t usedBytes() const;
+
+    SpscRing(const SpscRing&)            = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+private:
+    static constexpr size_t   kHeaderSize = 8;
+    static constexpr uint32_t kWrapMarker = 0xFFFFFFFFu;
+
+    std::unique_ptr<unsigned char[]> data_;
+    size_t                           capacity_;
+    size_t                           mask_;
+
+    // producer owned
+    alignas(64) std::atomic<size_t> write_pos_{0};
+    size_t reserve_pos_ = 0;
+    size_t cached_read_ = 0;
+
+    // consumer owned
+    alignas(64) std::atomic<size_t> read_pos_{0};
+    size_t cached_write_ = 0;
+};
+
+}   // namespace mlogger
+
+#endif   // SPSC_RING_H
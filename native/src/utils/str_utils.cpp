@@ -1,27 +1,44 @@
 #include "str_utils.h"
+#include <cstring>
 
 namespace mlogger
 {
 
-std::string formatExceptionMessage(const char* exception_type, const char* message,
-                                   const char* stack_trace)
+void formatExceptionMessage(const char* exception_type, const char* message,
+                            const char* stack_trace, std::string& dest)
 {
-    std::string result = "[EXCEPTION] ";
+    static constexpr char kPrefix[] = "[EXCEPTION] ";
+
+    size_t type_length    = exception_type ? std::strlen(exception_type) : 0;
+    size_t message_length = message ? std::strlen(message) : 0;
+    size_t stack_length   = stack_trace ? std::strlen(stack_trace) : 0;
+
+    dest.clear();
+    dest.reserve(sizeof(kPrefix) - 1 + (exception_type ? type_length + 2 : 0) + message_length +
+                 (stack_trace ? stack_length + 1 : 0));
+
+    dest.append(kPrefix, sizeof(kPrefix) - 1);
 
     if (exception_type) {
-        result += exception_type;
-        result += ": ";
+        dest.append(exception_type, type_length);
+        dest.append(": ", 2);
     }
 
     if (message) {
-        result += message;
+        dest.append(message, message_length);
     }
 
     if (stack_trace) {
-        result += "\n";
-        result += stack_trace;
+        dest.push_back('\n');
+        dest.append(stack_trace, stack_length);
     }
+}
 
+std::string formatExceptionMessage(const char* exception_type, const char* message,
+                                   const char* stack_trace)
+{
+    std::string result;
+    formatExceptionMessage(exception_type, message, stack_trace, result);
     return result;
 }
 
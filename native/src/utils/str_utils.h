@@ -6,6 +6,10 @@
 namespace mlogger
 {
 
+// Formats into `dest`, replacing its content. The size is computed up front, so a reused `dest`
+// only allocates when a message outgrows every earlier one.
+void        formatExceptionMessage(const char* exception_type, const char* message,
+                                   const char* stack_trace, std::string& dest);
 std::string formatExceptionMessage(const char* exception_type, const char* message,
                                    const char* stack_trace);
 std::string safeString(const char* str);
@@ -0,0 +1,122 @@
+#include "thread_utils.h"
+
+#if defined(_WIN32) || defined(_WIN64)
+#    include <windows.h>
+#    include <vector>
+#elif defined(__APPLE__)
+#    include <pthread.h>
+#    include <sys/qos.h>
+#else
+#    include <pthread.h>
+#    include <sched.h>
+#    include <sys/resource.h>
+#    include <sys/syscall.h>
+#    include <unistd.h>
+#endif
+
+namespace mlogger
+{
+
+namespace
+{
+
+// the longest name every platform keeps whole
+constexpr size_t kMaxThreadName = 15;
+
+#if defined(_WIN32) || defined(_WIN64)
+// NOTE: SetThreadDescription exists from Windows 10 1607 on, looked up so older systems load us
+using SetThreadDescriptionFn = HRESULT(WINAPI*)(HANDLE, PCWSTR);
+#endif
+
+bool setCurrentThreadPriority(ThreadPriority priority)
+{
+    if (priority == ThreadPriority::normal) {
+        return true;
+    }
+    bool lowest = priority == ThreadPriority::background;
+#if defined(_WIN32) || defined(_WIN64)
+    if (lowest) return setCurrentThreadBackground();
+    return ::SetThreadPriority(::GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL) != 0;
+#elif defined(__APPLE__)
+    // NOTE: background QoS is what keeps a thread on the efficiency cores
+    qos_class_t qos = lowest ? QOS_CLASS_BACKGROUND : QOS_CLASS_UTILITY;
+    return pthread_set_qos_class_self_np(qos, 0) == 0;
+#else
+    if (lowest) return setCurrentThreadBackground();
+    return setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 10) == 0;
+#endif
+}
+
+bool setCurrentThreadAffinity(uint64_t mask)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    return ::SetThreadAffinityMask(::GetCurrentThread(), static_cast<DWORD_PTR>(mask)) != 0;
+#elif defined(__APPLE__)
+    // NOTE: no affinity on Apple platforms, the QoS class picks the cores
+    (void)mask;
+    return false;
+#else
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    for (int cpu = 0; cpu < 64 && cpu < CPU_SETSIZE; ++cpu) {
+        if (mask & (uint64_t{1} << cpu)) CPU_SET(cpu, &cpus);
+    }
+    // pid 0 is the calling thread
+    return sched_setaffinity(0, sizeof(cpus), &cpus) == 0;
+#endif
+}
+
+bool setCurrentThreadName(const std::string& name)
+{
+    std::string cut = name.substr(0, kMaxThreadName);
+#if defined(_WIN32) || defined(_WIN64)
+    auto set_description = reinterpret_cast<SetThreadDescriptionFn>(::GetProcAddress(
+        ::GetModuleHandleW(L"kernel32.dll"), "SetThreadDescription"));
+    if (!set_description) {
+        return false;
+    }
+    int size = ::MultiByteToWideChar(CP_UTF8, 0, cut.c_str(), -1, nullptr, 0);
+    std::vector<wchar_t> wide(static_cast<size_t>(size > 0 ? size : 1));
+    ::MultiByteToWideChar(CP_UTF8, 0, cut.c_str(), -1, wide.data(), size);
+    return SUCCEEDED(set_description(::GetCurrentThread(), wide.data()));
+#elif defined(__APPLE__)
+    return pthread_setname_np(cut.c_str()) == 0;
+#else
+    return pthread_setname_np(pthread_self(), cut.c_str()) == 0;
+#endif
+}
+
+}   // namespace
+
+bool setCurrentThreadBackground()
+{
+#if defined(_WIN32) || defined(_WIN64)
+    // background mode also lowers the I/O and memory priority of the thread
+    return ::SetThreadPriority(::GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN) != 0;
+#elif defined(__APPLE__)
+    return pthread_set_qos_class_self_np(QOS_CLASS_UTILITY, 0) == 0;
+#else
+    // NOTE: on Linux the nice value is per thread when addressed by tid
+    return setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 19) == 0;
+#endif
+}
+
+void applyThreadSettings(const ThreadSettings&                    settings,
+                         const std::function<void(const char*)>& error_handler)
+{
+    auto report = [&error_handler](const char* message) {
+        if (error_handler) error_handler(message);
+    };
+
+    if (!settings.name.empty() && !setCurrentThreadName(settings.name)) {
+        report("Failed to name the writer thread");
+    }
+    if (settings.affinity != 0 && !setCurrentThreadAffinity(settings.affinity)) {
+        report("Failed to set the writer thread's CPU affinity");
+    }
+    if (!setCurrentThreadPriority(settings.priority)) {
+        report("Failed to lower the writer thread's priority");
+    }
+}
+
+}   // namespace mlogger
@@ -0,0 +1,31 @@
+#ifndef THREAD_UTILS_H
+#define THREAD_UTILS_H
+
+#include "core/logger_config.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace mlogger
+{
+
+// Lowers the CPU (and where the platform supports it, I/O) priority of the calling thread so
+// housekeeping work yields to the game. Best effort, false when the platform refused.
+bool setCurrentThreadBackground();
+
+// Scheduling of a thread the logger starts, applied by the thread itself when it starts.
+struct ThreadSettings {
+    uint64_t       affinity = 0;   // bit i = may run on CPU i, 0 = any CPU
+    ThreadPriority priority = ThreadPriority::normal;
+    std::string    name;   // cut to 15 bytes (the Linux limit), empty = left as created
+};
+
+// Applies `settings` to the calling thread. Best effort: a setting the platform refuses (CPU
+// affinity on Apple platforms, a mask without an online CPU) is reported to `error_handler`
+// (optional) and the others are still applied.
+void applyThreadSettings(const ThreadSettings&                    settings,
+                         const std::function<void(const char*)>& error_handler = nullptr);
+
+}   // namespace mlogger
+
+#endif   // THREAD_UTILS_H
@@ -0,0 +1,212 @@
+#include "tsc_clock.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <thread>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#    define MLOGGER_TSC_X86 1
+#    if defined(_MSC_VER)
+#        include <intrin.h>
+#    else
+#        include <cpuid.h>
+#        include <x86intrin.h>
+#    endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#    define MLOGGER_TSC_ARM64 1
+#    if defined(_MSC_VER)
+#        include <intrin.h>
+#    endif
+#endif
+
+namespace mlogger
+{
+
+namespace
+{
+
+using Nanoseconds = std::chrono::nanoseconds;
+
+// first calibration, the frequency is measured over this window
+constexpr auto kInitialWindow = std::chrono::milliseconds(2);
+// a fitted rate further than this from the last one means the system clock was stepped
+constexpr double kMaxRateChange = 1e-3;
+// samples whose counter reads are further apart are retried, the system clock call was preempted
+constexpr uint64_t kMaxSampleTicks = 100000;
+constexpr int      kSampleAttempts = 5;
+
+struct Sample {
+    uint64_t ticks = 0;
+    int64_t  ns    = 0;   // system clock, since the Unix epoch
+};
+
+// NOTE: published as a seqlock, readers retry while `sequence` is odd or changed under them.
+// Zero means not calibrated yet.
+std::atomic<uint32_t> sequence{0};
+std::atomic<uint64_t> base_ticks{0};
+std::atomic<int64_t>  base_ns{0};
+std::atomic<uint64_t> multiplier{0};
+std::atomic<uint32_t> shift{0};
+
+// writer side, guarded by calibration_mutex
+std::mutex calibration_mutex;
+Sample     last_sample;
+double     ns_per_tick = 0.0;
+
+int64_t systemNanoseconds()
+{
+    auto since_epoch = std::chrono::system_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<Nanoseconds>(since_epoch).count();
+}
+
+// the system clock read between two counter reads, stamped with their midpoint
+Sample takeSample()
+{
+    Sample   best;
+    uint64_t best_window = UINT64_MAX;
+    for (int i = 0; i < kSampleAttempts && best_window > kMaxSampleTicks; ++i) {
+        uint64_t before = TscClock::ticks();
+        int64_t  ns     = systemNanoseconds();
+        uint64_t after  = TscClock::ticks();
+        if (after - before < best_window) {
+            best_window = after - before;
+            best.ticks  = before + (after - before) / 2;
+            best.ns     = ns;
+        }
+    }
+    return best;
+}
+
+// (delta * mult) >> shift without overflowing 64 bits, mult < 2^32
+uint64_t scale(uint64_t delta, uint64_t mult, uint32_t bits)
+{
+    uint64_t high = delta >> bits;
+    uint64_t low  = delta & ((uint64_t{1} << bits) - 1);
+    return high * mult + ((low * mult) >> bits);
+}
+
+void publish(const Sample& base, double rate)
+{
+    // the largest shift that keeps the multiplier within 32 bits, for the split in scale()
+    uint32_t bits = 32;
+    while (bits > 0 && std::ldexp(rate, static_cast<int>(bits)) >= 4294967296.0) {
+        --bits;
+    }
+    auto mult = static_cast<uint64_t>(std::llround(std::ldexp(rate, static_cast<int>(bits))));
+
+    uint32_t current = sequence.load(std::memory_order_relaxed);
+    sequence.store(current + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    base_ticks.store(base.ticks, std::memory_order_relaxed);
+    base_ns.store(base.ns, std::memory_order_relaxed);
+    multiplier.store(mult, std::memory_order_relaxed);
+    shift.store(bits, std::memory_order_relaxed);
+    sequence.store(current + 2, std::memory_order_release);
+}
+
+}   // namespace
+
+bool TscClock::isSupported()
+{
+#if defined(MLOGGER_TSC_X86)
+    // NOTE: only an invariant TSC ticks at a constant rate through frequency changes and sleep
+    // states, and is synchronized across cores
+    static const bool supported = []() {
+#    if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0x80000000);
+        if (static_cast<unsigned>(info[0]) < 0x80000007u) return false;
+        __cpuid(info, 0x80000007);
+        return (info[3] & (1 << 8)) != 0;
+#    else
+        unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+        if (__get_cpuid_max(0x80000000u, nullptr) < 0x80000007u) return false;
+        __get_cpuid(0x80000007u, &eax, &ebx, &ecx, &edx);
+        return (edx & (1u << 8)) != 0;
+#    endif
+    }();
+    return supported;
+#elif defined(MLOGGER_TSC_ARM64)
+    // the generic timer's virtual count is constant rate and readable from user space
+    return true;
+#else
+    return false;
+#endif
+}
+
+uint64_t TscClock::ticks()
+{
+#if defined(MLOGGER_TSC_X86)
+    return __rdtsc();
+#elif defined(MLOGGER_TSC_ARM64) && defined(_MSC_VER)
+    return static_cast<uint64_t>(_ReadStatusReg(ARM64_CNTVCT));
+#elif defined(MLOGGER_TSC_ARM64)
+    uint64_t value;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+    return value;
+#else
+    return 0;
+#endif
+}
+
+spdlog::log_clock::time_point TscClock::now()
+{
+    uint64_t tick = ticks();
+
+    uint32_t seen;
+    uint64_t from;
+    int64_t  ns;
+    uint64_t mult;
+    uint32_t bits;
+    do {
+        seen = sequence.load(std::memory_order_acquire);
+        if (seen == 0) {
+            return spdlog::log_clock::now();
+        }
+        from = base_ticks.load(std::memory_order_relaxed);
+        ns   = base_ns.load(std::memory_order_relaxed);
+        mult = multiplier.load(std::memory_order_relaxed);
+        bits = shift.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while ((seen & 1) != 0 || sequence.load(std::memory_order_relaxed) != seen);
+
+    // NOTE: a counter read just before a concurrent calibration sample lies behind its base
+    if (tick >= from) {
+        ns += static_cast<int64_t>(scale(tick - from, mult, bits));
+    } else {
+        ns -= static_cast<int64_t>(scale(from - tick, mult, bits));
+    }
+    return spdlog::log_clock::time_point(
+        std::chrono::duration_cast<spdlog::log_clock::duration>(Nanoseconds(ns)));
+}
+
+void TscClock::recalibrate()
+{
+    if (!isSupported()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(calibration_mutex);
+    if (ns_per_tick == 0.0) {
+        last_sample = takeSample();
+        std::this_thread::sleep_for(kInitialWindow);
+    }
+
+    Sample sample = takeSample();
+    if (sample.ticks > last_sample.ticks && sample.ns > last_sample.ns) {
+        double rate = static_cast<double>(sample.ns - last_sample.ns) /
+                      static_cast<double>(sample.ticks - last_sample.ticks);
+        if (ns_per_tick == 0.0 || std::fabs(rate / ns_per_tick - 1.0) <= kMaxRateChange) {
+            ns_per_tick = rate;
+        }
+    }
+    // NOTE: a system clock stepped since the last sample (or a window too short to measure)
+    // keeps the known rate and only moves the base
+    last_sample = sample;
+    if (ns_per_tick > 0.0) {
+        publish(sample, ns_per_tick);
+    }
+}
+
+}   // namespace mlogger
@@ -0,0 +1,37 @@
+#ifndef TSC_CLOCK_H
+#define TSC_CLOCK_H
+
+#include <cstdint>
+#include <spdlog/common.h>
+
+namespace mlogger
+{
+
+// Wall-clock time from the CPU's cycle counter: rdtsc on x86 with an invariant TSC, cntvct_el0
+// on ARM64. Reading the counter and scaling it costs a few nanoseconds, against a vDSO call (a
+// syscall on some Android kernels) for std::chrono::system_clock::now().
+//
+// The scale is fitted against the system clock by recalibrate(), which LoggerManager calls from
+// a background thread. Each calibration rebases on a fresh sample, so a stepped or slewed system
+// clock is followed within one interval; the time read right after it may step by the
+// extrapolation error, microseconds at most.
+class TscClock final
+{
+public:
+    // whether the counter is a usable clock on this CPU, false = now() reads the system clock
+    static bool isSupported();
+
+    // raw counter value, 0 when not supported
+    static uint64_t ticks();
+
+    // the system clock until the first calibration
+    static spdlog::log_clock::time_point now();
+
+    // samples the system clock against the counter and publishes the new scale. The first call
+    // also measures the counter frequency, which takes a couple of milliseconds.
+    static void recalibrate();
+};
+
+}   // namespace mlogger
+
+#endif   // TSC_CLOCK_H
@@ -0,0 +1,107 @@
+#include "utf16_utils.h"
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define MLOGGER_UTF16_SSE2 1
+#    include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#    define MLOGGER_UTF16_NEON 1
+#    include <arm_neon.h>
+#endif
+
+namespace mlogger
+{
+
+namespace
+{
+
+constexpr size_t kBlockUnits = 16;
+
+uint16_t loadUnit(const char* text, size_t index)
+{
+    uint16_t unit = 0;
+    std::memcpy(&unit, text + index * sizeof(unit), sizeof(unit));
+    return unit;
+}
+
+// narrows the block at `text` into `out` when all of its 16 units are ASCII
+bool narrowBlock(const char* text, char* out)
+{
+#if defined(MLOGGER_UTF16_SSE2)
+    __m128i low   = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text));
+    __m128i high  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + 16));
+    __m128i above = _mm_and_si128(_mm_or_si128(low, high), _mm_set1_epi16(-0x80));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi16(above, _mm_setzero_si128())) != 0xffff) {
+        return false;
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(low, high));
+    return true;
+#elif defined(MLOGGER_UTF16_NEON)
+    uint16x8_t low  = vreinterpretq_u16_u8(vld1q_u8(reinterpret_cast<const uint8_t*>(text)));
+    uint16x8_t high = vreinterpretq_u16_u8(vld1q_u8(reinterpret_cast<const uint8_t*>(text + 16)));
+    if (vmaxvq_u16(vorrq_u16(low, high)) >= 0x80) {
+        return false;
+    }
+    vst1q_u8(reinterpret_cast<uint8_t*>(out), vcombine_u8(vmovn_u16(low), vmovn_u16(high)));
+    return true;
+#else
+    (void)text;
+    (void)out;
+    return false;
+#endif
+}
+
+}   // namespace
+
+void appendUtf16AsUtf8(const char* text, size_t units, spdlog::memory_buf_t& dest, bool scalar)
+{
+    // NOTE: a unit takes at most 3 bytes, a surrogate pair 4 for its two units
+    size_t start = dest.size();
+    dest.resize(start + units * 3);
+    char* out = dest.data() + start;
+
+    size_t i = 0;
+    while (i < units) {
+        if (!scalar) {
+            while (units - i >= kBlockUnits && narrowBlock(text + i * 2, out)) {
+                i += kBlockUnits;
+                out += kBlockUnits;
+            }
+            if (i == units) break;
+        }
+
+        uint32_t unit = loadUnit(text, i++);
+        if (unit < 0x80) {
+            *out++ = static_cast<char>(unit);
+            continue;
+        }
+        if (unit < 0x800) {
+            *out++ = static_cast<char>(0xc0 | (unit >> 6));
+            *out++ = static_cast<char>(0x80 | (unit & 0x3f));
+            continue;
+        }
+
+        uint32_t code_point = unit;
+        if (unit >= 0xd800 && unit <= 0xdfff) {
+            uint32_t next = i < units ? loadUnit(text, i) : 0;
+            if (unit <= 0xdbff && next >= 0xdc00 && next <= 0xdfff) {
+                code_point = 0x10000 + ((unit - 0xd800) << 10) + (next - 0xdc00);
+                ++i;
+                *out++ = static_cast<char>(0xf0 | (code_point >> 18));
+                *out++ = static_cast<char>(0x80 | ((code_point >> 12) & 0x3f));
+                *out++ = static_cast<char>(0x80 | ((code_point >> 6) & 0x3f));
+                *out++ = static_cast<char>(0x80 | (code_point & 0x3f));
+                continue;
+            }
+            code_point = 0xfffd;
+        }
+        *out++ = static_cast<char>(0xe0 | (code_point >> 12));
+        *out++ = static_cast<char>(0x80 | ((code_point >> 6) & 0x3f));
+        *out++ = static_cast<char>(0x80 | (code_point & 0x3f));
+    }
+    dest.resize(static_cast<size_t>(out - dest.data()));
+}
+
+}   // namespace mlogger
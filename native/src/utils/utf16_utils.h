@@ -0,0 +1,19 @@
+#ifndef UTF16_UTILS_H
+#define UTF16_UTILS_H
+
+#include <cstddef>
+#include <spdlog/common.h>
+
+namespace mlogger
+{
+
+// Appends the UTF-8 form of the `units` UTF-16 code units at `text`, native byte order, which
+// need not be aligned. Unpaired surrogates become U+FFFD, as .NET's Encoding.UTF8 writes them.
+// Runs of ASCII are narrowed 16 units at a time with SSE2 on x86 and NEON on ARM64; `scalar`
+// skips that, for tests.
+void appendUtf16AsUtf8(const char* text, size_t units, spdlog::memory_buf_t& dest,
+                       bool scalar = false);
+
+}   // namespace mlogger
+
+#endif   // UTF16_UTILS_H
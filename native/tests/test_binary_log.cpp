@@ -0,0 +1,265 @@
+#include "../src/bridge/bridge.h"
+#include "../src/sinks/binary_format.h"
+#include "../src/sinks/rotating_file_sink.h"
+#include "test_options.h"
+#include <cassert>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+bool initFormat(const char* log_path, size_t max_file_size, int file_format, int async_mode)
+{
+    MLoggerOptions options = defaultOptions(log_path, async_mode);
+    options.max_file_size  = max_file_size;
+    options.max_files      = 5;
+    options.file_format    = file_format;
+    return initWithOptions(&options) == 1;
+}
+
+std::vector<mlogger::BinaryLogEntry> readEntries(const std::string& path)
+{
+    std::ifstream                        input(path, std::ios::binary);
+    mlogger::BinaryLogReader             reader(input);
+    std::vector<mlogger::BinaryLogEntry> entries;
+    mlogger::BinaryLogEntry              entry;
+    while (reader.next(entry)) {
+        entries.push_back(entry);
+    }
+    assert(reader.error().empty());
+    return entries;
+}
+
+void removeLogs(const char* log_path)
+{
+    for (size_t i = 0; i <= 5; ++i) {
+        std::filesystem::remove(mlogger::RotatingFileSink::calcFilename(log_path, i));
+    }
+}
+
+void test_binary_round_trip()
+{
+    std::cout << "[TEST] Testing binary log round trip...\n";
+
+    const char* log_path = "test_logs/test_binary.mlog";
+    removeLogs(log_path);
+    bool ok = initFormat(log_path, 10 * 1024 * 1024, LOG_FILE_BINARY, ASYNC_MODE_THREAD_POOL);
+    assert(ok);
+
+    const int repeats = 1000;
+    for (int i = 0; i < repeats; ++i) {
+        logMessage(LOG_INFO, "Player position updated");
+        char buffer[64];
+        snprintf(buffer, sizeof(buffer), "Frame %d", i);
+        logMessage(LOG_DEBUG, buffer);
+    }
+    std::string long_text(1000, 'L');
+    logMessage(LOG_CRITICAL, long_text.c_str());
+    terminate();
+
+    // Test 1: every record decodes with its text, level and order
+    auto entries = readEntries(log_path);
+    assert(entries.size() == static_cast<size_t>(repeats * 2 + 1));
+    for (int i = 0; i < repeats; ++i) {
+        assert(entries[i * 2].text == "Player position updated");
+        assert(entries[i * 2].level == 2);
+        assert(entries[i * 2 + 1].text == "Frame " + std::to_string(i));
+        assert(entries[i * 2 + 1].level == 1);
+        assert(entries[i * 2].logger_name == "mlogger");
+    }
+    assert(entries.back().text == long_text);
+    assert(entries.back().level == 5);
+    std::cout << "  [OK] Texts, levels and order preserved\n";
+
+    // Test 2: timestamps are absolute and non-decreasing
+    for (size_t i = 1; i < entries.size(); ++i) {
+        assert(entries[i].time_ns >= entries[i - 1].time_ns);
+    }
+    assert(entries.front().time_ns > 1000000000LL * 1000000000LL);   // after 2001
+    std::cout << "  [OK] Timestamps restored from deltas\n";
+
+    // Test 3: repeated texts are interned, so the file is smaller than the text log
+    const char* text_path = "test_logs/test_binary_text.log";
+    removeLogs(text_path);
+    ok = initFormat(text_path, 10 * 1024 * 1024, LOG_FILE_TEXT, ASYNC_MODE_OFF);
+    assert(ok);
+    for (int i = 0; i < repeats; ++i) {
+        logMessage(LOG_INFO, "Player position updated");
+        char buffer[64];
+        snprintf(buffer, sizeof(buffer), "Frame %d", i);
+        logMessage(LOG_DEBUG, buffer);
+    }
+    logMessage(LOG_CRITICAL, long_text.c_str());
+    terminate();
+    assert(std::filesystem::file_size(log_path) * 3 < std::filesystem::file_size(text_path));
+    std::cout << "  [OK] Binary file is " << std::filesystem::file_size(log_path) << " bytes vs "
+              << std::filesystem::file_size(text_path) << " bytes of text\n";
+
+    // Test 4: appending in a new session keeps the file decodable
+    ok = initFormat(log_path, 10 * 1024 * 1024, LOG_FILE_BINARY, ASYNC_MODE_OFF);
+    assert(ok);
+    (void)ok;
+    logMessage(LOG_WARN, "Player position updated");
+    logMessage(LOG_WARN, "Second session");
+    terminate();
+    entries = readEntries(log_path);
+    assert(entries.size() == static_cast<size_t>(repeats * 2 + 3));
+    assert(entries[entries.size() - 2].text == "Player position updated");
+    assert(entries.back().text == "Second session");
+    std::cout << "  [OK] Appended sessions decode\n";
+
+    std::cout << "[PASS] Binary log round trip tests passed\n\n";
+}
+
+void test_binary_channels()
+{
+    std::cout << "[TEST] Testing binary log channels...\n";
+
+    const char* log_path = "test_logs/test_binary_channels.mlog";
+    removeLogs(log_path);
+    int  net     = createChannel("net");
+    int  physics = createChannel("physics");
+    bool ok      = initFormat(log_path, 10 * 1024 * 1024, LOG_FILE_BINARY, ASYNC_MODE_OFF);
+    assert(ok);
+    (void)ok;
+
+    // Test 1: interleaved records keep their own channel, the default logger included
+    logChannel(physics, LOG_INFO, "physics first");
+    logChannel(net, LOG_INFO, "net second");
+    logMessage(LOG_INFO, "default third");
+    logChannel(physics, LOG_WARN, "physics fourth");
+    terminate();
+
+    auto entries = readEntries(log_path);
+    assert(entries.size() == 4);
+    assert(entries[0].logger_name == "physics" && entries[0].text == "physics first");
+    assert(entries[1].logger_name == "net" && entries[1].text == "net second");
+    assert(entries[2].logger_name == "mlogger" && entries[2].text == "default third");
+    assert(entries[3].logger_name == "physics" && entries[3].text == "physics fourth");
+    std::cout << "  [OK] Every entry decodes with its channel name\n";
+
+    std::cout << "[PASS] Binary log channel tests passed\n\n";
+}
+
+void test_binary_rotation()
+{
+    std::cout << "[TEST] Testing binary log rotation...\n";
+
+    const char* log_path = "test_logs/test_binary_rotation.mlog";
+    removeLogs(log_path);
+    bool ok = initFormat(log_path, 4 * 1024, LOG_FILE_BINARY, ASYNC_MODE_OFF);
+    assert(ok);
+    (void)ok;
+
+    const int num_logs = 600;
+    for (int i = 0; i < num_logs; ++i) {
+        char buffer[64];
+        snprintf(buffer, sizeof(buffer), "Rotating record %d", i);
+        logMessage(LOG_INFO, buffer);
+        logMessage(LOG_INFO, "Shared text");
+    }
+    terminate();
+
+    // Test 1: rotation happened and no file exceeds the limit
+    assert(std::filesystem::exists(mlogger::RotatingFileSink::calcFilename(log_path, 1)));
+    for (size_t i = 0; i <= 5; ++i) {
+        auto file = mlogger::RotatingFileSink::calcFilename(log_path, i);
+        if (std::filesystem::exists(file)) {
+            assert(std::filesystem::file_size(file) <= 4 * 1024);
+        }
+    }
+    std::cout << "  [OK] Files rotated within the size limit\n";
+
+    // Test 2: each file decodes on its own and the newest records are intact
+    int last_seq = -1;
+    for (size_t i = 5;; --i) {
+        auto file = mlogger::RotatingFileSink::calcFilename(log_path, i);
+        if (std::filesystem::exists(file)) {
+            for (const auto& entry : readEntries(file)) {
+                int seq = -1;
+                if (sscanf(entry.text.c_str(), "Rotating record %d", &seq) == 1) {
+                    assert(seq == last_seq + 1 || last_seq == -1);
+                    last_seq = seq;
+                } else {
+                    assert(entry.text == "Shared text");
+                }
+            }
+        }
+        if (i == 0) break;
+    }
+    assert(last_seq == num_logs - 1);
+    (void)last_seq;
+    std::cout << "  [OK] Rotated files decode independently\n";
+
+    std::cout << "[PASS] Binary log rotation tests passed\n\n";
+}
+
+void test_binary_reader_errors()
+{
+    std::cout << "[TEST] Testing binary reader errors...\n";
+
+    // Test 1: text files are rejected
+    std::ofstream("test_logs/test_binary_invalid.mlog") << "[2024-01-01] plain text\n";
+    std::ifstream            input("test_logs/test_binary_invalid.mlog", std::ios::binary);
+    mlogger::BinaryLogReader reader(input);
+    mlogger::BinaryLogEntry  entry;
+    bool                     read = reader.next(entry);
+    assert(!read);
+    assert(!reader.error().empty());
+    std::cout << "  [OK] Non-binary input rejected\n";
+
+    // Test 2: truncated files report an error instead of a partial record
+    const char* log_path = "test_logs/test_binary_truncated.mlog";
+    removeLogs(log_path);
+    bool ok = initFormat(log_path, 1024 * 1024, LOG_FILE_BINARY, ASYNC_MODE_OFF);
+    assert(ok);
+    (void)ok;
+    logMessage(LOG_INFO, "Complete record");
+    logMessage(LOG_INFO, "Truncated record");
+    terminate();
+    std::filesystem::resize_file(log_path, std::filesystem::file_size(log_path) - 4);
+
+    std::ifstream            truncated(log_path, std::ios::binary);
+    mlogger::BinaryLogReader truncated_reader(truncated);
+    read = truncated_reader.next(entry);
+    assert(read && entry.text == "Complete record");
+    read = truncated_reader.next(entry);
+    assert(!read);
+    assert(!truncated_reader.error().empty());
+    (void)read;
+    std::cout << "  [OK] Truncated input reported\n";
+
+    std::cout << "[PASS] Binary reader error tests passed\n\n";
+}
+
+int main()
+{
+    std::cout << "========================================\n";
+    std::cout << "MLogger Binary Log Test Suite\n";
+    std::cout << "========================================\n\n";
+
+    std::filesystem::create_directories("test_logs");
+
+    try {
+        test_binary_round_trip();
+        test_binary_channels();
+        test_binary_rotation();
+        test_binary_reader_errors();
+
+        std::cout << "========================================\n";
+        std::cout << "All binary log tests passed! [OK]\n";
+        std::cout << "========================================\n";
+
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "\n[FAIL] Test failed with exception: " << e.what() << "\n";
+        terminate();
+        return 1;
+    } catch (...) {
+        std::cerr << "\n[FAIL] Test failed with unknown exception\n";
+        terminate();
+        return 1;
+    }
+}
@@ -0,0 +1,297 @@
+#include "../src/bridge/bridge.h"
+#include "test_options.h"
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+bool initChannels(const char* log_path, int async_mode, int min_level, int ring_buffer_size = 0)
+{
+    std::filesystem::remove(log_path);
+
+    MLoggerOptions options   = defaultOptions(log_path, async_mode);
+    options.min_log_level    = min_level;
+    options.ring_buffer_size = ring_buffer_size;
+    return initWithOptions(&options) == 1;
+}
+
+std::string readFile(const std::string& path)
+{
+    std::ifstream      input(path, std::ios::binary);
+    std::ostringstream content;
+    content << input.rdbuf();
+    return content.str();
+}
+
+size_t countOccurrences(const std::string& text, const std::string& needle)
+{
+    size_t count = 0;
+    for (size_t pos = text.find(needle); pos != std::string::npos;
+         pos        = text.find(needle, pos + needle.size())) {
+        ++count;
+    }
+    return count;
+}
+
+void test_channel_registry()
+{
+    std::cout << "[TEST] Testing channel registry...\n";
+
+    // Test 1: invalid names are rejected, the default logger has id 0
+    int result = createChannel(nullptr);
+    assert(result == -1);
+    result = createChannel("");
+    assert(result == -1);
+    result = createChannel(std::string(64, 'n').c_str());
+    assert(result == -1);
+    result = createChannel("mlogger");
+    assert(result == MLOGGER_DEFAULT_CHANNEL);
+    std::cout << "  [OK] Invalid names rejected\n";
+
+    // Test 2: channels exist before init, one id per name
+    int net = createChannel("net");
+    assert(net > MLOGGER_DEFAULT_CHANNEL);
+    result = createChannel("net");
+    assert(result == net);
+    int ai = createChannel(std::string(63, 'a').c_str());
+    assert(ai > net);
+    assert(getChannelLevel(net) == MLOGGER_LEVEL_INHERIT);
+    std::cout << "  [OK] Ids " << net << " and " << ai << " assigned before init\n";
+
+    // Test 3: unknown ids and levels are refused
+    result = setChannelLevel(1000, LOG_DEBUG);
+    assert(result == 0);
+    result = setChannelLevel(-1, LOG_DEBUG);
+    assert(result == 0);
+    result = setChannelLevel(net, 7);
+    assert(result == 0);
+    result = setChannelLevel(net, -2);
+    assert(result == 0);
+    assert(getChannelLevel(1000) == LOG_OFF);
+    logChannel(1000, LOG_ERROR, "unknown channel");
+    logChannel(-3, LOG_ERROR, "negative channel");
+    logChannel(net, LOG_ERROR, nullptr);
+    (void)result;
+    std::cout << "  [OK] Unknown channels ignored\n";
+
+    std::cout << "[PASS] Channel registry tests passed\n\n";
+}
+
+void test_channel_levels()
+{
+    std::cout << "[TEST] Testing per-channel levels...\n";
+
+    const char* log_path = "test_logs/test_channels_levels.log";
+    int         net      = createChannel("net");
+    int         physics  = createChannel("physics");
+    int         audio    = createChannel("audio");
+    int         result   = setChannelLevel(net, LOG_DEBUG);
+    assert(result == 1);
+    result = setChannelLevel(physics, LOG_OFF);
+    assert(result == 1);
+    bool ok = initChannels(log_path, ASYNC_MODE_OFF, LOG_INFO);
+    assert(ok);
+
+    // Test 1: each channel filters on its own level, records carry the channel name
+    logMessage(LOG_DEBUG, "default debug hidden");
+    logChannel(net, LOG_DEBUG, "net debug shown");
+    logChannel(physics, LOG_CRITICAL, "physics hidden");
+    logChannel(audio, LOG_DEBUG, "audio debug hidden");
+    logChannel(audio, LOG_INFO, "audio info shown");
+    logChannel(MLOGGER_DEFAULT_CHANNEL, LOG_INFO, "default channel shown");
+    flush();
+
+    std::string content = readFile(log_path);
+    assert(content.find("[net] [debug] net debug shown") != std::string::npos);
+    assert(content.find("[audio] [info] audio info shown") != std::string::npos);
+    assert(content.find("[mlogger] [info] default channel shown") != std::string::npos);
+    assert(content.find("hidden") == std::string::npos);
+    std::cout << "  [OK] Channel levels applied\n";
+
+    // Test 2: inheriting channels follow setLogLevel, explicit ones keep their level
+    setLogLevel(LOG_WARN);
+    logChannel(audio, LOG_INFO, "audio info after warn");
+    logChannel(net, LOG_DEBUG, "net debug after warn");
+    result = setChannelLevel(net, MLOGGER_LEVEL_INHERIT);
+    assert(result == 1);
+    logChannel(net, LOG_INFO, "net info inherited");
+    result = setChannelLevel(MLOGGER_DEFAULT_CHANNEL, LOG_TRACE);
+    assert(result == 1);
+    assert(getChannelLevel(MLOGGER_DEFAULT_CHANNEL) == LOG_TRACE);
+    logChannel(audio, LOG_TRACE, "audio trace inherited");
+    flush();
+
+    content = readFile(log_path);
+    assert(content.find("audio info after warn") == std::string::npos);
+    assert(content.find("net debug after warn") != std::string::npos);
+    assert(content.find("net info inherited") == std::string::npos);
+    assert(content.find("[audio] [trace] audio trace inherited") != std::string::npos);
+    terminate();
+    std::cout << "  [OK] Inherited levels follow setLogLevel\n";
+
+    // Test 3: ids and levels survive a new session
+    result = createChannel("physics");
+    assert(result == physics);
+    assert(getChannelLevel(physics) == LOG_OFF);
+    ok = initChannels(log_path, ASYNC_MODE_OFF, LOG_INFO);
+    assert(ok);
+    logChannel(physics, LOG_CRITICAL, "physics still off");
+    result = setChannelLevel(physics, LOG_INFO);
+    assert(result == 1);
+    logChannel(physics, LOG_INFO, "physics back on");
+    int late = createChannel("late");
+    logChannel(late, LOG_INFO, "late channel");
+    terminate();
+
+    content = readFile(log_path);
+    assert(content.find("physics still off") == std::string::npos);
+    assert(content.find("[physics] [info] physics back on") != std::string::npos);
+    assert(content.find("[late] [info] late channel") != std::string::npos);
+    (void)result;
+    (void)ok;
+    std::cout << "  [OK] Channels kept across sessions\n";
+
+    std::cout << "[PASS] Per-channel level tests passed\n\n";
+}
+
+void test_channel_ring()
+{
+    std::cout << "[TEST] Testing channels and the flight recorder...\n";
+
+    const char* log_path  = "test_logs/test_channels_ring.log";
+    const char* dump_path = "test_logs/test_channels_ring.dump.log";
+    int         ai        = createChannel("ai");
+    int         input     = createChannel("input");
+    int         result    = setChannelLevel(ai, LOG_WARN);
+    assert(result == 1);
+    bool ok = initChannels(log_path, ASYNC_MODE_OFF, LOG_INFO, 64 * 1024);
+    assert(ok);
+
+    // Test 1: inheriting channels feed the ring at every level, explicit levels filter it
+    logChannel(input, LOG_TRACE, "input trace in ring");
+    logChannel(ai, LOG_DEBUG, "ai debug filtered");
+    logChannel(ai, LOG_ERROR, "ai error kept");
+    result = dumpRing(dump_path);
+    assert(result == 1);
+    (void)result;
+    (void)ok;
+    terminate();
+
+    std::string dump = readFile(dump_path);
+    std::string file = readFile(log_path);
+    assert(dump.find("input trace in ring") != std::string::npos);
+    assert(dump.find("ai debug filtered") == std::string::npos);
+    assert(dump.find("ai error kept") != std::string::npos);
+    assert(file.find("input trace in ring") == std::string::npos);
+    assert(file.find("[ai] [error] ai error kept") != std::string::npos);
+    std::cout << "  [OK] Ring sees inherited channels only below their file level\n";
+
+    std::cout << "[PASS] Channel ring tests passed\n\n";
+}
+
+void test_channels_async(int async_mode, const char* name)
+{
+    std::cout << "[TEST] Testing channels with " << name << "...\n";
+
+    std::string log_path = std::string("test_logs/test_channels_") + name + ".log";
+    const char* names[]  = {"net", "ai", "physics", "audio"};
+    int         ids[4];
+    int         result = 0;
+    for (int i = 0; i < 4; ++i) {
+        ids[i] = createChannel(names[i]);
+        result = setChannelLevel(ids[i], MLOGGER_LEVEL_INHERIT);
+        assert(result == 1);
+    }
+    result = setChannelLevel(ids[3], LOG_OFF);
+    assert(result == 1);
+    bool ok = initChannels(log_path.c_str(), async_mode, LOG_INFO);
+    assert(ok);
+    (void)ok;
+
+    // Test 1: producers on several channels share one backend, nothing lost or misattributed
+    const int                logs_per_thread = 5000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([t, &ids]() {
+            for (int i = 0; i < logs_per_thread; ++i) {
+                logChannel(ids[t], LOG_INFO, "channel record");
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    terminate();
+
+    std::string content = readFile(log_path);
+    for (int t = 0; t < 3; ++t) {
+        std::string tag = std::string("[") + names[t] + "] [info] channel record";
+        assert(countOccurrences(content, tag) == static_cast<size_t>(logs_per_thread));
+    }
+    assert(content.find("[audio]") == std::string::npos);
+    std::cout << "  [OK] " << 3 * logs_per_thread << " records on 3 channels, audio off\n";
+
+    result = setChannelLevel(ids[3], MLOGGER_LEVEL_INHERIT);
+    assert(result == 1);
+    (void)result;
+    std::cout << "[PASS] " << name << " channel tests passed\n\n";
+}
+
+void test_channel_limit()
+{
+    std::cout << "[TEST] Testing channel limit...\n";
+
+    // Test 1: ids run out after 63 named channels, existing names still resolve
+    int last = 0;
+    for (int i = 0; i < 64; ++i) {
+        int id = createChannel(("filler" + std::to_string(i)).c_str());
+        if (id < 0) break;
+        last = id;
+    }
+    assert(last == 63);
+    int result = createChannel("one too many");
+    assert(result == -1);
+    result = createChannel("net");
+    assert(result > 0);
+    (void)last;
+    (void)result;
+    std::cout << "  [OK] 63 named channels plus the default one\n";
+
+    std::cout << "[PASS] Channel limit tests passed\n\n";
+}
+
+int main()
+{
+    std::cout << "========================================\n";
+    std::cout << "MLogger Channel Test Suite\n";
+    std::cout << "========================================\n\n";
+
+    std::filesystem::create_directories("test_logs");
+
+    try {
+        test_channel_registry();
+        test_channel_levels();
+        test_channel_ring();
+        test_channels_async(ASYNC_MODE_THREAD_POOL, "thread_pool");
+        test_channels_async(ASYNC_MODE_STAGING, "staging");
+        test_channel_limit();
+
+        std::cout << "========================================\n";
+        std::cout << "All channel tests passed! [OK]\n";
+        std::cout << "========================================\n";
+
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "\n[FAIL] Test failed with exception: " << e.what() << "\n";
+        terminate();
+        return 1;
+    } catch (...) {
+        std::cerr << "\n[FAIL] Test failed with unknown exception\n";
+        terminate();
+        return 1;
+    }
+}
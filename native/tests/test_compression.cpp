@@ -0,0 +1,274 @@
+#include "../src/bridge/bridge.h"
+#include "../src/sinks/log_compressor.h"
+#include "test_options.h"
+#include <cassert>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+bool initCompressed(const char* log_path, size_t max_file_size, int max_files, int compression,
+                    int async_mode = ASYNC_MODE_OFF)
+{
+    MLoggerOptions options = defaultOptions(log_path, async_mode);
+    options.max_file_size  = max_file_size;
+    options.max_files      = max_files;
+    options.compression    = compression;
+    return initWithOptions(&options) == 1;
+}
+
+std::string rotatedName(const std::string& stem, int index)
+{
+    return index == 0 ? stem + ".log" : stem + "." + std::to_string(index) + ".log";
+}
+
+void removeFiles(const std::string& stem, int max_files)
+{
+    for (int i = 0; i <= max_files + 1; ++i) {
+        std::filesystem::remove(rotatedName(stem, i));
+        std::filesystem::remove(rotatedName(stem, i) + ".gz");
+    }
+    std::filesystem::remove(stem + ".log.gz.tmp");
+}
+
+// rotated files still waiting for the worker
+int countPlainRotated(const std::string& stem, int max_files)
+{
+    int count = 0;
+    for (int i = 1; i <= max_files; ++i) {
+        if (std::filesystem::exists(rotatedName(stem, i))) ++count;
+    }
+    return count;
+}
+
+bool waitForCompression(const std::string& stem, int max_files)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(20);
+    while (countPlainRotated(stem, max_files) > 0) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return true;
+}
+
+std::string readFile(const std::string& path)
+{
+    std::ifstream      input(path, std::ios::binary);
+    std::ostringstream content;
+    content << input.rdbuf();
+    return content.str();
+}
+
+// async flush() does not wait for the writer, the last record shows when it caught up
+bool waitForRecord(const std::string& path, const std::string& record)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(20);
+    while (readFile(path).find(record) == std::string::npos) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return true;
+}
+
+void test_compression_support()
+{
+    std::cout << "[TEST] Testing compression support queries...\n";
+
+    // Test 1: none is always supported, unknown codecs never
+    assert(isCompressionSupported(LOG_COMPRESSION_NONE) == 1);
+    assert(isCompressionSupported(-1) == 0);
+    assert(isCompressionSupported(LOG_COMPRESSION_ZSTD + 1) == 0);
+    std::cout << "  [OK] gzip " << isCompressionSupported(LOG_COMPRESSION_GZIP) << ", zstd "
+              << isCompressionSupported(LOG_COMPRESSION_ZSTD) << "\n";
+
+    // Test 2: an unsupported codec still initializes, rotated files stay plain
+    const std::string stem = "test_logs/test_compression_fallback";
+    removeFiles(stem, 3);
+    int unsupported = !isCompressionSupported(LOG_COMPRESSION_ZSTD)   ? LOG_COMPRESSION_ZSTD
+                      : !isCompressionSupported(LOG_COMPRESSION_GZIP) ? LOG_COMPRESSION_GZIP
+                                                                      : -1;
+    if (unsupported >= 0) {
+        bool ok = initCompressed((stem + ".log").c_str(), 1024, 3, unsupported);
+        assert(ok);
+        (void)ok;
+        std::string message(100, 'f');
+        for (int i = 0; i < 30; ++i) logMessage(LOG_INFO, message.c_str());
+        terminate();
+        assert(std::filesystem::exists(rotatedName(stem, 1)));
+        std::cout << "  [OK] Unsupported codec keeps plain files\n";
+    }
+
+    // Test 3: out of range values are rejected
+    bool ok = initCompressed((stem + ".log").c_str(), 1024, 3, 7);
+    assert(!ok);
+    (void)ok;
+    std::cout << "  [OK] Invalid codec rejected\n";
+
+    std::cout << "[PASS] Compression support tests passed\n\n";
+}
+
+void test_gzip_rotation(int async_mode)
+{
+    std::cout << "[TEST] Testing gzip rotation (async_mode " << async_mode << ")...\n";
+
+    const std::string stem      = "test_logs/test_compression_gzip";
+    const int         max_files = 20;
+    removeFiles(stem, max_files);
+    bool ok = initCompressed((stem + ".log").c_str(), 8 * 1024, max_files, LOG_COMPRESSION_GZIP,
+                             async_mode);
+    assert(ok);
+
+    // Test 1: every rotated file is replaced by a .gz copy
+    const int num_logs = 1000;
+    for (int i = 0; i < num_logs; ++i) {
+        std::string message = "compressed record " + std::to_string(i) + " " + std::string(64, 'z');
+        logMessage(LOG_INFO, message.c_str());
+    }
+    flush();
+    std::string last_record = "compressed record " + std::to_string(num_logs - 1) + " ";
+    ok = waitForRecord(rotatedName(stem, 0), last_record);
+    assert(ok);
+    ok = waitForCompression(stem, max_files);
+    assert(ok);
+    terminate();
+
+    int compressed = 0;
+    for (int i = 1; i <= max_files; ++i) {
+        if (std::filesystem::exists(rotatedName(stem, i) + ".gz")) ++compressed;
+    }
+    assert(compressed >= 5);
+    assert(!std::filesystem::exists(stem + ".log.gz.tmp"));
+    std::cout << "  [OK] " << compressed << " rotated files compressed\n";
+
+    // Test 2: oldest first, the files decompress back to every record in order
+    std::string text;
+    for (int i = max_files; i >= 1; --i) {
+        std::string path = rotatedName(stem, i) + ".gz";
+        if (!std::filesystem::exists(path)) continue;
+        std::string data, error;
+        ok = mlogger::LogCompressor::decompressFile(path, data, &error);
+        assert(ok);
+        assert(std::filesystem::file_size(path) < data.size() / 4);
+        text += data;
+    }
+    text += readFile(rotatedName(stem, 0));
+
+    size_t position = 0;
+    for (int i = 0; i < num_logs; ++i) {
+        position = text.find("compressed record " + std::to_string(i) + " ", position);
+        assert(position != std::string::npos);
+    }
+    (void)ok;
+    std::cout << "  [OK] All " << num_logs << " records recovered in order\n";
+
+    std::cout << "[PASS] gzip rotation tests passed\n\n";
+}
+
+void test_rotation_outpaces_worker()
+{
+    std::cout << "[TEST] Testing rotation faster than compression...\n";
+
+    const std::string stem      = "test_logs/test_compression_fast";
+    const int         max_files = 3;
+    removeFiles(stem, max_files);
+    bool ok = initCompressed((stem + ".log").c_str(), 4 * 1024, max_files, LOG_COMPRESSION_GZIP);
+    assert(ok);
+
+    // Test 1: files rotated away mid-job are skipped, retention is unchanged
+    std::string message(200, 'q');
+    for (int i = 0; i < 5000; ++i) logMessage(LOG_INFO, message.c_str());
+    ok = waitForCompression(stem, max_files);
+    assert(ok);
+    terminate();
+
+    assert(!std::filesystem::exists(rotatedName(stem, max_files + 1)));
+    assert(!std::filesystem::exists(rotatedName(stem, max_files + 1) + ".gz"));
+    assert(!std::filesystem::exists(stem + ".log.gz.tmp"));
+    for (int i = 1; i <= max_files; ++i) {
+        std::string data;
+        ok = mlogger::LogCompressor::decompressFile(rotatedName(stem, i) + ".gz", data);
+        assert(ok);
+        assert(data.size() <= 4 * 1024 && data.find(message) != std::string::npos);
+    }
+    (void)ok;
+    std::cout << "  [OK] " << max_files << " compressed files kept, no leftovers\n";
+
+    std::cout << "[PASS] Rotation faster than compression tests passed\n\n";
+}
+
+void test_leftover_files()
+{
+    std::cout << "[TEST] Testing files left by an earlier run...\n";
+
+    const std::string stem = "test_logs/test_compression_leftover";
+    removeFiles(stem, 5);
+
+    // Test 1: plain rotated files found at startup are compressed
+    {
+        std::ofstream left(rotatedName(stem, 2), std::ios::binary);
+        left << "left over by a crashed session\n";
+        std::ofstream temp(stem + ".log.gz.tmp", std::ios::binary);
+        temp << "half written";
+    }
+    bool ok = initCompressed((stem + ".log").c_str(), 1024 * 1024, 5, LOG_COMPRESSION_GZIP);
+    assert(ok);
+    ok = waitForCompression(stem, 5);
+    assert(ok);
+    terminate();
+
+    std::string data;
+    ok = mlogger::LogCompressor::decompressFile(rotatedName(stem, 2) + ".gz", data);
+    assert(ok);
+    assert(data == "left over by a crashed session\n");
+    assert(!std::filesystem::exists(stem + ".log.gz.tmp"));
+    std::cout << "  [OK] Leftover file compressed\n";
+
+    // Test 2: plain files are not mistaken for compressed ones
+    std::string error;
+    ok = mlogger::LogCompressor::decompressFile(rotatedName(stem, 0), data, &error);
+    assert(!ok);
+    assert(!error.empty());
+    (void)ok;
+    std::cout << "  [OK] " << error << "\n";
+
+    std::cout << "[PASS] Leftover file tests passed\n\n";
+}
+
+int main()
+{
+    std::cout << "========================================\n";
+    std::cout << "MLogger Compression Test Suite\n";
+    std::cout << "========================================\n\n";
+
+    std::filesystem::create_directories("test_logs");
+
+    try {
+        test_compression_support();
+        if (isCompressionSupported(LOG_COMPRESSION_GZIP)) {
+            test_gzip_rotation(ASYNC_MODE_OFF);
+            test_gzip_rotation(ASYNC_MODE_THREAD_POOL);
+            test_rotation_outpaces_worker();
+            test_leftover_files();
+        } else {
+            std::cout << "[SKIP] Built without zlib, gzip tests skipped\n\n";
+        }
+
+        std::cout << "========================================\n";
+        std::cout << "All compression tests passed! [OK]\n";
+        std::cout << "========================================\n";
+
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "\n[FAIL] Test failed with exception: " << e.what() << "\n";
+        terminate();
+        return 1;
+    } catch (...) {
+        std::cerr << "\n[FAIL] Test failed with unknown exception\n";
+        terminate();
+        return 1;
+    }
+}
@@ -0,0 +1,138 @@
+#include "../src/bridge/bridge.h"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Runs `logs_per_thread` logMessage() calls on each of `num_threads` threads released together,
+// returns the wall time of the slowest thread in milliseconds.
+double runContended(int num_threads, int logs_per_thread, int level)
+{
+    std::atomic<int>         ready{0};
+    std::atomic<bool>        go{false};
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&, t]() {
+            char buffer[128];
+            ready.fetch_add(1);
+            while (!go.load()) {
+                std::this_thread::yield();
+            }
+            for (int i = 0; i < logs_per_thread; ++i) {
+                snprintf(buffer, sizeof(buffer), "Contention thread %d message %d", t, i);
+                logMessage(level, buffer);
+            }
+        });
+    }
+
+    while (ready.load() != num_threads) {
+        std::this_thread::yield();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    go.store(true);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void printRow(int num_threads, int total, double ms)
+{
+    double per_sec = ms > 0.0 ? (total * 1000.0) / ms : 0.0;
+    double ns_op   = total > 0 ? (ms * 1e6) / total : 0.0;
+    printf("  %7d | %10d | %10.2f | %14.0f | %8.1f\n", num_threads, total, ms, per_sec, ns_op);
+}
+
+void test_contention_scaling()
+{
+    std::cout << "[TEST] Testing log path contention scaling...\n";
+
+    const char* log_path = "test_logs/test_contention.log";
+    int         result   = init(log_path, 10 * 1024 * 1024, 3, 1, 1, LOG_INFO);
+    assert(result == 1);
+    (void)result;
+
+    const int thread_counts[] = {1, 2, 4, 8, 16, 32};
+
+    // Test 1: accepted messages, bounded by the async queue and the writer thread
+    std::cout << "  accepted (LOG_INFO):\n";
+    std::cout << "  threads |   messages |    time ms |       msgs/sec |    ns/op\n";
+    for (int num_threads : thread_counts) {
+        const int logs_per_thread = 4000;
+        double    ms              = runContended(num_threads, logs_per_thread, LOG_INFO);
+        printRow(num_threads, num_threads * logs_per_thread, ms);
+    }
+    flush();
+    std::cout << "  [OK] Accepted messages scale across 1-32 threads\n";
+
+    // Test 2: filtered messages, the pure hot path without any queue traffic
+    std::cout << "  filtered (LOG_DEBUG):\n";
+    std::cout << "  threads |   messages |    time ms |       msgs/sec |    ns/op\n";
+    for (int num_threads : thread_counts) {
+        const int logs_per_thread = 100000;
+        double    ms              = runContended(num_threads, logs_per_thread, LOG_DEBUG);
+        printRow(num_threads, num_threads * logs_per_thread, ms);
+    }
+    std::cout << "  [OK] Filtered messages scale across 1-32 threads\n";
+
+    // Test 3: terminate while producers are still logging must not crash
+    std::atomic<bool>        stop{false};
+    std::vector<std::thread> producers;
+    for (int t = 0; t < 8; ++t) {
+        producers.emplace_back([&stop]() {
+            while (!stop.load()) {
+                logMessage(LOG_INFO, "Logging across terminate");
+            }
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    terminate();
+    assert(isInit() == 0);
+    result = init(log_path, 10 * 1024 * 1024, 3, 1, 1, LOG_INFO);
+    assert(result == 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    stop.store(true);
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    std::cout << "  [OK] Terminate/initialize while logging handled correctly\n";
+
+    terminate();
+    std::cout << "[PASS] Contention scaling tests passed\n\n";
+}
+
+int main()
+{
+    std::cout << "========================================\n";
+    std::cout << "MLogger Contention Benchmark\n";
+    std::cout << "========================================\n\n";
+
+    std::filesystem::create_directories("test_logs");
+
+    try {
+        test_contention_scaling();
+
+        std::cout << "========================================\n";
+        std::cout << "All contention tests passed! [OK]\n";
+        std::cout << "========================================\n";
+
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "\n[FAIL] Test failed with exception: " << e.what() << "\n";
+        terminate();
+        return 1;
+    } catch (...) {
+        std::cerr << "\n[FAIL] Test failed with unknown exception\n";
+        terminate();
+        return 1;
+    }
+}
@@ -0,0 +1,318 @@
+#include "../src/bridge/bridge.h"
+#include "../src/core/deferred_format.h"
+#include "../src/sinks/binary_format.h"
+#include "test_options.h"
+#include <cassert>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Packs logFormatted() arguments the way managed callers do.
+class ArgumentBlob
+{
+public:
+    ArgumentBlob& addInt(int64_t value) { return add(LOG_ARG_INT, &value, sizeof(value)); }
+    ArgumentBlob& addDouble(double value) { return add(LOG_ARG_DOUBLE, &value, sizeof(value)); }
+    ArgumentBlob& addFloat(float value) { return add(LOG_ARG_FLOAT, &value, sizeof(value)); }
+    ArgumentBlob& addBool(bool value)
+    {
+        uint8_t byte = value ? 1 : 0;
+        return add(LOG_ARG_BOOL, &byte, sizeof(byte));
+    }
+    ArgumentBlob& addString(const std::string& value)
+    {
+        uint32_t size = static_cast<uint32_t>(value.size());
+        add(LOG_ARG_STRING, &size, sizeof(size));
+        bytes_.insert(bytes_.end(), value.begin(), value.end());
+        return *this;
+    }
+
+    const char* data() const { return bytes_.data(); }
+    int         size() const { return static_cast<int>(bytes_.size()); }
+
+private:
+    ArgumentBlob& add(uint8_t type, const void* value, size_t size)
+    {
+        bytes_.push_back(static_cast<char>(type));
+        const char* begin = static_cast<const char*>(value);
+        bytes_.insert(bytes_.end(), begin, begin + size);
+        return *this;
+    }
+
+    std::vector<char> bytes_;
+};
+
+bool initFormatted(const char* log_path, const char* json_path, int async_mode,
+                   int file_format = LOG_FILE_TEXT, int ring_buffer_size = 0)
+{
+    std::filesystem::remove(log_path);
+    if (json_path) std::filesystem::remove(json_path);
+
+    MLoggerOptions options   = defaultOptions(log_path, async_mode);
+    options.min_log_level    = LOG_INFO;
+    options.file_format      = file_format;
+    options.ring_buffer_size = ring_buffer_size;
+    options.json_log_path    = json_path;
+    return initWithOptions(&options) == 1;
+}
+
+std::vector<std::string> readLines(const std::string& path)
+{
+    std::ifstream            input(path);
+    std::vector<std::string> lines;
+    std::string              line;
+    while (std::getline(input, line)) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+std::string findLine(const std::vector<std::string>& lines, const std::string& text)
+{
+    for (const auto& line : lines) {
+        if (line.find(text) != std::string::npos) return line;
+    }
+    return "";
+}
+
+std::string formatBlob(const std::string& text, const ArgumentBlob& args)
+{
+    spdlog::memory_buf_t dest;
+    mlogger::formatArguments(text, args.data(), static_cast<size_t>(args.size()), dest);
+    return std::string(dest.data(), dest.size());
+}
+
+void test_format_registry()
+{
+    std::cout << "[TEST] Testing format registration...\n";
+
+    // Test 1: the same text yields the same id, ids survive re-initialization
+    int first = registerFormat("registry {}");
+    assert(first >= 0);
+    int again = registerFormat("registry {}");
+    assert(again == first);
+    int second = registerFormat("registry {} {}");
+    assert(second >= 0 && second != first);
+    int invalid = registerFormat(nullptr);
+    assert(invalid == -1);
+    (void)again;
+    (void)invalid;
+    assert(mlogger::FormatRegistry::getInstance().get(static_cast<uint32_t>(second)) ==
+           spdlog::string_view_t("registry {} {}"));
+    assert(mlogger::FormatRegistry::getInstance().get(1u << 30).size() == 0);
+    std::cout << "  [OK] Ids " << first << " and " << second << " registered\n";
+
+    // Test 2: every argument type formats like fmt would
+    ArgumentBlob args;
+    args.addInt(-42).addDouble(0.25).addFloat(0.1f).addBool(true).addString("orc");
+    assert(formatBlob("{} {} {} {} {}", args) == "-42 0.25 0.1 true orc");
+    assert(formatBlob("{4}:{0:05d}:{1:.1f}", args) == "orc:-0042:0.2");
+    assert(formatBlob("{{{}}}", ArgumentBlob().addInt(7)) == "{7}");
+    std::cout << "  [OK] Int, double, float, bool and string arguments\n";
+
+    // Test 3: missing or mismatched arguments keep the format and say why
+    std::string missing = formatBlob("{} and {}", ArgumentBlob().addInt(1));
+    assert(missing.find("{} and {} [format error: ") == 0 && missing.back() == ']');
+    std::string mismatch = formatBlob("{:d}", ArgumentBlob().addString("text"));
+    assert(mismatch.find("{:d} [format error: ") == 0);
+    std::cout << "  [OK] Format errors: " << missing << "\n";
+
+    // Test 4: truncated arguments are dropped rather than read past the end
+    ArgumentBlob truncated;
+    truncated.addInt(5).addString("long string");
+    assert(formatBlob("{}", ArgumentBlob().addInt(5)) == "5");
+    spdlog::memory_buf_t dest;
+    bool ok = mlogger::formatArguments("{}", truncated.data(), truncated.size() - 3, dest);
+    assert(!ok);
+    (void)ok;
+    assert(std::string(dest.data(), dest.size()) == "5");
+    std::cout << "  [OK] Truncated arguments ignored\n";
+
+    std::cout << "[PASS] Format registry tests passed\n\n";
+}
+
+void test_formatted_sync()
+{
+    std::cout << "[TEST] Testing formatted records in text and JSON files...\n";
+
+    const char* log_path  = "test_logs/test_formatted.log";
+    const char* json_path = "test_logs/test_formatted.jsonl";
+    bool ok = initFormatted(log_path, json_path, ASYNC_MODE_OFF);
+    assert(ok);
+    (void)ok;
+
+    int spawned = registerFormat("spawned {} at ({:.1f}, {:.1f}) boss={}");
+    int quoted  = registerFormat("name \"{}\"");
+    int broken  = registerFormat("broken {} {}");
+    ArgumentBlob args;
+    args.addString("orc").addFloat(1.25f).addDouble(-3.0).addBool(false);
+    logFormatted(LOG_INFO, spawned, args.data(), args.size());
+    logFormatted(LOG_DEBUG, spawned, args.data(), args.size());
+    logFormatted(LOG_WARN, quoted, nullptr, 0);
+    ArgumentBlob one;
+    one.addInt(1);
+    logFormatted(LOG_ERROR, broken, one.data(), one.size());
+    logFormatted(LOG_ERROR, 1 << 20, one.data(), one.size());
+    logFormatted(LOG_ERROR, spawned, nullptr, 4);
+    terminate();
+
+    // Test 1: the text file gets the formatted message, unknown ids are dropped
+    std::vector<std::string> text = readLines(log_path);
+    assert(text.size() == 3);
+    assert(findLine(text, "[info] spawned orc at (1.2, -3.0) boss=false") != "");
+    assert(findLine(text, "[warning] name \"{}\" [format error: ") != "");
+    assert(findLine(text, "[error] broken {} {} [format error: ") != "");
+    std::cout << "  [OK] Text file: " << findLine(text, "spawned") << "\n";
+
+    // Test 2: the JSON file gets the formatted message as a string
+    std::vector<std::string> json = readLines(json_path);
+    assert(json.size() == 3);
+    assert(findLine(json, "\"message\":\"spawned orc at (1.2, -3.0) boss=false\"}") != "");
+    assert(findLine(json, "\"message\":\"name \\\"{}\\\" [format error: ") != "");
+    std::cout << "  [OK] JSON file holds the formatted text\n";
+
+    std::cout << "[PASS] Formatted sync tests passed\n\n";
+}
+
+void test_formatted_ring_and_binary()
+{
+    std::cout << "[TEST] Testing formatted records in the ring and binary files...\n";
+
+    const char* log_path  = "test_logs/test_formatted.bin.log";
+    const char* dump_path = "test_logs/test_formatted.dump.log";
+    bool ok = initFormatted(log_path, nullptr, ASYNC_MODE_OFF, LOG_FILE_BINARY, 64 * 1024);
+    assert(ok);
+
+    int          frame = registerFormat("frame {} took {:.2f}ms");
+    int          plain = registerFormat("{{no arguments}}");
+    ArgumentBlob args;
+    args.addInt(7).addDouble(16.666);
+    logFormatted(LOG_TRACE, frame, args.data(), args.size());
+    for (int i = 0; i < 3; ++i) {
+        logFormatted(LOG_INFO, frame, args.data(), args.size());
+    }
+    logFormatted(LOG_INFO, plain, nullptr, 0);
+    int result = dumpRing(dump_path);
+    assert(result == 1);
+    (void)result;
+    terminate();
+
+    // Test 1: the ring keeps the formatted text of every level
+    std::vector<std::string> dump = readLines(dump_path);
+    assert(findLine(dump, "[trace]").find("frame 7 took 16.67ms") != std::string::npos);
+    assert(findLine(dump, "{no arguments}") != "");
+
+    // Test 2: binary files keep the format and the raw arguments
+    std::ifstream            input(log_path, std::ios::binary);
+    mlogger::BinaryLogReader reader(input);
+    mlogger::BinaryLogEntry  entry;
+    std::vector<std::string> texts;
+    while (reader.next(entry)) {
+        if (entry.arguments.empty()) {
+            texts.push_back(entry.text);
+            continue;
+        }
+        assert(entry.text == "frame {} took {:.2f}ms");
+        assert(entry.arguments.size() == static_cast<size_t>(args.size()));
+        spdlog::memory_buf_t dest;
+        ok = mlogger::formatArguments(entry.text,
+                                      reinterpret_cast<const char*>(entry.arguments.data()),
+                                      entry.arguments.size(),
+                                      dest);
+        assert(ok);
+        texts.push_back(std::string(dest.data(), dest.size()));
+    }
+    assert(reader.error().empty());
+    assert(texts.size() == 4);
+    assert(texts[0] == "frame 7 took 16.67ms" && texts[2] == texts[0]);
+    assert(texts[3] == "{no arguments}");
+    (void)ok;
+    std::cout << "  [OK] Binary file: format plus " << args.size() << " argument bytes\n";
+
+    std::cout << "[PASS] Ring and binary tests passed\n\n";
+}
+
+void test_formatted_async(int async_mode, const char* name)
+{
+    std::cout << "[TEST] Testing formatted records with " << name << "...\n";
+
+    std::string log_path = std::string("test_logs/test_formatted_") + name + ".log";
+    bool ok = initFormatted(log_path.c_str(), nullptr, async_mode);
+    assert(ok);
+    (void)ok;
+
+    // Test 1: arguments survive the async queue and are formatted by the writer
+    const int                num_threads     = 4;
+    const int                logs_per_thread = 2500;
+    int                      tick            = registerFormat("tick thread={} seq={} label={}");
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([t, tick]() {
+            std::string label = "worker" + std::to_string(t);
+            for (int i = 0; i < logs_per_thread; ++i) {
+                ArgumentBlob args;
+                args.addInt(t).addInt(i).addString(label);
+                logFormatted(LOG_INFO, tick, args.data(), args.size());
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    terminate();
+
+    std::vector<std::string> text = readLines(log_path);
+    assert(text.size() == static_cast<size_t>(num_threads * logs_per_thread));
+    std::vector<int> counts(num_threads, 0);
+    for (const auto& line : text) {
+        size_t at = line.find("tick thread=");
+        assert(at != std::string::npos);
+        int t = line[at + std::strlen("tick thread=")] - '0';
+        assert(t >= 0 && t < num_threads);
+        assert(line.find(" label=worker" + std::to_string(t)) != std::string::npos);
+        ++counts[t];
+    }
+    for (int count : counts) {
+        assert(count == logs_per_thread);
+        (void)count;
+    }
+    assert(findLine(text, "tick thread=3 seq=2499 label=worker3") != "");
+    std::cout << "  [OK] " << text.size() << " records formatted\n";
+
+    std::cout << "[PASS] " << name << " formatted tests passed\n\n";
+}
+
+int main()
+{
+    std::cout << "========================================\n";
+    std::cout << "MLogger Deferred Formatting Test Suite\n";
+    std::cout << "========================================\n\n";
+
+    std::filesystem::create_directories("test_logs");
+
+    try {
+        test_format_registry();
+        test_formatted_sync();
+        test_formatted_ring_and_binary();
+        test_formatted_async(ASYNC_MODE_THREAD_POOL, "thread_pool");
+        test_formatted_async(ASYNC_MODE_STAGING, "staging");
+
+        std::cout << "========================================\n";
+        std::cout << "All deferred formatting tests passed! [OK]\n";
+        std::cout << "========================================\n";
+
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "\n[FAIL] Test failed with exception: " << e.what() << "\n";
+        terminate();
+        return 1;
+    } catch (...) {
+        std::cerr << "\n[FAIL] Test failed with unknown exception\n";
+        terminate();
+        return 1;
+    }
+}
@@ -0,0 +1,149 @@
+// Trace and Debug are compiled out here, as in a release build
+#define MLOGGER_ACTIVE_LEVEL LOG_INFO
+
+#include "../src/bridge/mlogger.h"
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <string_view>
+
+static_assert(!mlogger::isActive(LOG_TRACE) && !mlogger::isActive(LOG_DEBUG),
+              "below MLOGGER_ACTIVE_LEVEL");
+static_assert(mlogger::isActive(LOG_INFO) && mlogger::isActive(LOG_CRITICAL),
+              "at or above MLOGGER_ACTIVE_LEVEL");
+
+const char* kLogPath = "test_logs/test_frontend.log";
+
+std::string readLog()
+{
+    flush();
+    std::ifstream input(kLogPath, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+}
+
+bool contains(const std::string& text, const std::string& part)
+{
+    return text.find(part) != std::string::npos;
+}
+
+void test_not_initialized()
+{
+    std::cout << "[TEST] Testing the front-end before init...\n";
+
+    int evaluated = 0;
+    assert(!mlogger::shouldLog<LOG_CRITICAL>() && "nothing is written before init");
+    MLOGGER_CRITICAL("value {}", ++evaluated);
+    mlogger::log<LOG_CRITICAL>("dropped");
+    assert(evaluated == 0 && "arguments not evaluated");
+    std::cout << "  [OK] Dropped without evaluating arguments\n";
+
+    std::cout << "[PASS] Before init tests passed\n\n";
+}
+
+void test_levels()
+{
+    std::cout << "[TEST] Testing compile-time and runtime levels...\n";
+
+    std::filesystem::remove(kLogPath);
+    int result = initDefault(kLogPath);
+    assert(result == 1);
+    (void)result;
+    setLogLevel(LOG_WARN);
+
+    int evaluated = 0;
+    MLOGGER_DEBUG("compiled out {}", ++evaluated);
+    MLOGGER_INFO("below the runtime level {}", ++evaluated);
+    mlogger::log<LOG_TRACE>("compiled out");
+    mlogger::log<LOG_INFO>("below the runtime level");
+    assert(evaluated == 0 && "filtered arguments not evaluated");
+    assert(!mlogger::shouldLog<LOG_INFO>() && mlogger::shouldLog<LOG_WARN>());
+
+    MLOGGER_WARN("warn {}", ++evaluated);
+    mlogger::log<LOG_ERROR>("error message");
+    assert(evaluated == 1);
+
+    // lowering the runtime level brings Info back, Trace and Debug stay compiled out
+    setLogLevel(LOG_TRACE);
+    MLOGGER_INFO("info {}", 1);
+    MLOGGER_DEBUG("debug {}", 1);
+    mlogger::log<LOG_DEBUG>("debug message");
+
+    std::string content = readLog();
+    assert(contains(content, "warn 1") && contains(content, "error message"));
+    assert(contains(content, "info 1"));
+    assert(!contains(content, "below the runtime level") && !contains(content, "compiled out"));
+    assert(!contains(content, "debug"));
+    std::cout << "  [OK] Filtered at compile time and at runtime\n";
+
+    terminate();
+    std::cout << "[PASS] Level tests passed\n\n";
+}
+
+void test_arguments()
+{
+    std::cout << "[TEST] Testing message and argument types...\n";
+
+    std::filesystem::remove(kLogPath);
+    int result = initDefault(kLogPath);
+    assert(result == 1);
+    (void)result;
+
+    std::string_view view("sized message, not terminated", 13);
+    mlogger::log<LOG_INFO>(view);
+
+    std::string name = "alpha";
+    MLOGGER_INFO("int {} neg {} ratio {:.2f} ok {} f {} name {} view {} literal {}", 42, -7LL, 0.5,
+                 true, 1.5f, name, std::string_view("beta"), "gamma");
+    MLOGGER_WARN("no arguments");
+
+    // arguments beyond the stack buffer
+    std::string long_text(1000, 'z');
+    MLOGGER_ERROR("long {} end", long_text);
+
+    logMessageLength(LOG_INFO, "negative length", -1);
+
+    std::string content = readLog();
+    assert(contains(content, "sized message\n") && "only the given bytes");
+    assert(contains(content, "int 42 neg -7 ratio 0.50 ok true f 1.5 name alpha view beta "
+                             "literal gamma"));
+    assert(contains(content, "no arguments"));
+    assert(contains(content, "long " + long_text + " end"));
+    assert(!contains(content, "negative length"));
+    std::cout << "  [OK] Strings, numbers and long arguments\n";
+
+    terminate();
+    assert(!mlogger::shouldLog<LOG_CRITICAL>() && "nothing is written once terminated");
+    std::cout << "[PASS] Argument tests passed\n\n";
+}
+
+int main()
+{
+    std::cout << "========================================\n";
+    std::cout << "MLogger Front-end Test Suite\n";
+    std::cout << "========================================\n\n";
+
+    std::filesystem::create_directories("test_logs");
+
+    try {
+        test_not_initialized();
+        test_levels();
+        test_arguments();
+
+        std::cout << "========================================\n";
+        std::cout << "All front-end tests passed! [OK]\n";
+        std::cout << "========================================\n";
+
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "\n[FAIL] Test failed with exception: " << e.what() << "\n";
+        terminate();
+        return 1;
+    } catch (...) {
+        std::cerr << "\n[FAIL] Test failed with unknown exception\n";
+        terminate();
+        return 1;
+    }
+}
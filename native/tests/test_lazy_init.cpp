@@ -0,0 +1,282 @@
+#include "../src/bridge/bridge.h"
+#include "../src/sinks/deferred_sink.h"
+#include "../src/sinks/rotating_file_sink.h"
+#include "test_options.h"
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <spdlog/logger.h>
+#include <string>
+#include <vector>
+
+using namespace mlogger;
+
+std::string readFile(const std::string& path)
+{
+    std::ifstream input(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+}
+
+size_t countOf(const std::string& text, const std::string& part)
+{
+    size_t count = 0;
+    for (size_t at = text.find(part); at != std::string::npos; at = text.find(part, at + 1)) {
+        ++count;
+    }
+    return count;
+}
+
+// "rec <index>" records, in the order the files were written
+void checkRecords(const std::vector<std::string>& contents, int count)
+{
+    int next = 0;
+    for (const std::string& content : contents) {
+        for (size_t at = content.find("rec "); at != std::string::npos;
+             at        = content.find("rec ", at + 1)) {
+            assert(std::stoi(content.substr(at + 4)) == next && "every record once, in order");
+            ++next;
+        }
+    }
+    assert(next == count && "no record lost");
+    (void)count;
+}
+
+MLoggerOptions lazyOptions(const char* log_path, int async_mode)
+{
+    MLoggerOptions options = defaultOptions(log_path, async_mode);
+    options.lazy_init      = 1;
+    return options;
+}
+
+void test_deferred_sink()
+{
+    std::cout << "[TEST] Testing the deferred sink...\n";
+
+    auto           sink = std::make_shared<DeferredSink>(64 * 1024);
+    spdlog::logger logger("deferred", sink);
+    for (int i = 0; i < 5; ++i) {
+        logger.info("held {}", i);
+    }
+
+    std::vector<std::string> forwarded;
+    sink->forward([&forwarded](const spdlog::details::log_msg& msg) {
+        forwarded.emplace_back(msg.payload.data(), msg.payload.size());
+    });
+    assert(forwarded.size() == 5 && forwarded.front() == "held 0" && forwarded.back() == "held 4");
+    logger.warn("after forward");
+    assert(forwarded.size() == 6 && forwarded.back() == "after forward");
+    assert(sink->droppedCount() == 0);
+    std::cout << "  [OK] Replayed in order, later records passed on\n";
+
+    // records past the capacity are counted and summarised
+    auto           small = std::make_shared<DeferredSink>(4096);
+    spdlog::logger small_logger("deferred", small);
+    for (int i = 0; i < 1000; ++i) {
+        small_logger.info("record {}", i);
+    }
+    uint64_t dropped = small->droppedCount();
+    assert(dropped > 0 && dropped < 1000);
+
+    std::vector<std::string> names;
+    forwarded.clear();
+    small->forward([&forwarded, &names](const spdlog::details::log_msg& msg) {
+        forwarded.emplace_back(msg.payload.data(), msg.payload.size());
+        names.emplace_back(msg.logger_name.data(), msg.logger_name.size());
+    });
+    assert(forwarded.size() == 1000 - dropped + 1);
+    assert(forwarded.front() == "record 0");
+    assert(forwarded.back() ==
+           std::to_string(dropped) + " messages dropped before the log file opened");
+    assert(names.front() == "deferred" && names.back().empty());
+    std::cout << "  [OK] " << dropped << " records past the capacity dropped and reported\n";
+
+    std::cout << "[PASS] Deferred sink tests passed\n\n";
+}
+
+void test_lazy_init(int async_mode, const char* name)
+{
+    std::cout << "[TEST] Testing lazy init, " << name << "...\n";
+
+    // the directory is created by the background thread
+    std::string directory = std::string("test_logs/lazy_") + name;
+    std::string log_path  = directory + "/game.log";
+    std::filesystem::remove_all(directory);
+
+    MLoggerOptions options = lazyOptions(log_path.c_str(), async_mode);
+    int            result  = initWithOptions(&options);
+    assert(result == 1);
+    assert(isInit() == 1);
+    (void)result;
+
+    const int count = 2000;
+    int       net   = createChannel("lazy_net");
+    assert(net > 0);
+    for (int i = 0; i < count / 2; ++i) {
+        logMessage(LOG_INFO, ("rec " + std::to_string(i)).c_str());
+    }
+    logChannel(net, LOG_WARN, "channel record");
+
+    // flush() waits for the files
+    flush();
+    assert(std::filesystem::exists(log_path));
+    checkRecords({readFile(log_path)}, count / 2);
+
+    for (int i = count / 2; i < count; ++i) {
+        logMessage(LOG_INFO, ("rec " + std::to_string(i)).c_str());
+    }
+    terminate();
+
+    std::string content = readFile(log_path);
+    checkRecords({content}, count);
+    assert(countOf(content, "[lazy_net]") == 1 && countOf(content, "channel record") == 1);
+    std::cout << "  [OK] Records before and after the file opened, in order\n";
+
+    std::cout << "[PASS] " << name << " lazy init tests passed\n\n";
+}
+
+void test_lazy_terminate()
+{
+    std::cout << "[TEST] Testing terminate and settings right after a lazy init...\n";
+
+    std::string log_path = "test_logs/test_lazy_init_terminate.log";
+    std::filesystem::remove(log_path);
+
+    MLoggerOptions options = lazyOptions(log_path.c_str(), ASYNC_MODE_THREAD_POOL);
+    int            result  = initWithOptions(&options);
+    assert(result == 1);
+    (void)result;
+    setLogLevel(LOG_WARN);
+    logMessage(LOG_INFO, "below the new level");
+    logMessage(LOG_ERROR, "error record");
+    assert(getLogLevel() == LOG_WARN);
+    terminate();
+
+    std::string content = readFile(log_path);
+    assert(countOf(content, "error record") == 1);
+    assert(countOf(content, "below the new level") == 0);
+    std::cout << "  [OK] Held records written by terminate(), level kept\n";
+
+    std::cout << "[PASS] Lazy terminate tests passed\n\n";
+}
+
+void test_lazy_reconfigure()
+{
+    std::cout << "[TEST] Testing reconfigure right after a lazy init...\n";
+
+    std::string first  = "test_logs/test_lazy_init_first.log";
+    std::string second = "test_logs/test_lazy_init_second.log";
+    std::filesystem::remove(first);
+    std::filesystem::remove(second);
+
+    MLoggerOptions options = lazyOptions(first.c_str(), ASYNC_MODE_THREAD_POOL);
+    int            result  = initWithOptions(&options);
+    assert(result == 1);
+    const int count = 2000;
+    for (int i = 0; i < count / 2; ++i) {
+        logMessage(LOG_INFO, ("rec " + std::to_string(i)).c_str());
+    }
+
+    // held records move to the new backend when the first file is not open yet
+    options           = lazyOptions(second.c_str(), ASYNC_MODE_OFF);
+    options.lazy_init = 0;
+    result            = reconfigure(&options);
+    assert(result == 1);
+    (void)result;
+    for (int i = count / 2; i < count; ++i) {
+        logMessage(LOG_INFO, ("rec " + std::to_string(i)).c_str());
+    }
+    terminate();
+
+    checkRecords({readFile(first), readFile(second)}, count);
+    std::cout << "  [OK] No record lost or reordered\n";
+
+    std::cout << "[PASS] Lazy reconfigure tests passed\n\n";
+}
+
+void test_lazy_drop_newest()
+{
+    std::cout << "[TEST] Testing lazy init with the drop_newest policy...\n";
+
+    std::string log_path = "test_logs/test_lazy_init_drop_newest.log";
+    std::filesystem::remove(log_path);
+
+    MLoggerOptions options  = lazyOptions(log_path.c_str(), ASYNC_MODE_THREAD_POOL);
+    options.overflow_policy = OVERFLOW_DROP_NEWEST;
+    int result              = initWithOptions(&options);
+    assert(result == 1);
+    (void)result;
+
+    const int count = 2000;
+    for (int i = 0; i < count / 2; ++i) {
+        logMessage(LOG_INFO, ("rec " + std::to_string(i)).c_str());
+    }
+    // NOTE: the held records are replayed through the queue, each of them takes a slot
+    flush();
+    for (int i = count / 2; i < count; ++i) {
+        logMessage(LOG_INFO, ("rec " + std::to_string(i)).c_str());
+    }
+    flush();
+    uint64_t dropped = getDroppedCount();
+    terminate();
+
+    assert(dropped == 0 && "the queue had room for every record");
+    (void)dropped;
+    checkRecords({readFile(log_path)}, count);
+    std::cout << "  [OK] Records after the file opened still admitted\n";
+
+    std::cout << "[PASS] Lazy drop_newest tests passed\n\n";
+}
+
+void test_invalid_buffer()
+{
+    std::cout << "[TEST] Testing lazy buffer validation...\n";
+
+    MLoggerOptions options   = lazyOptions("test_logs/test_lazy_init_invalid.log", ASYNC_MODE_OFF);
+    options.lazy_buffer_size = 1024;
+    int result               = initWithOptions(&options);
+    assert(result == 0);
+    options.lazy_buffer_size = -1;
+    result                   = initWithOptions(&options);
+    assert(result == 0);
+    assert(isInit() == 0);
+    (void)result;
+    std::cout << "  [OK] Buffers under 4KB rejected\n";
+
+    std::cout << "[PASS] Validation tests passed\n\n";
+}
+
+int main()
+{
+    std::cout << "========================================\n";
+    std::cout << "MLogger Lazy Init Test Suite\n";
+    std::cout << "========================================\n\n";
+
+    std::filesystem::create_directories("test_logs");
+
+    try {
+        test_deferred_sink();
+        test_lazy_init(ASYNC_MODE_OFF, "sync");
+        test_lazy_init(ASYNC_MODE_THREAD_POOL, "thread_pool");
+        test_lazy_init(ASYNC_MODE_STAGING, "staging");
+        test_lazy_terminate();
+        test_lazy_reconfigure();
+        test_lazy_drop_newest();
+        test_invalid_buffer();
+
+        std::cout << "========================================\n";
+        std::cout << "All lazy init tests passed! [OK]\n";
+        std::cout << "========================================\n";
+
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "\n[FAIL] Test failed with exception: " << e.what() << "\n";
+        terminate();
+        return 1;
+    } catch (...) {
+        std::cerr << "\n[FAIL] Test failed with unknown exception\n";
+        terminate();
+        return 1;
+    }
+}
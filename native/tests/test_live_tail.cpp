@@ -0,0 +1,231 @@
+#include "../src/bridge/bridge.h"
+#include "../src/sinks/tail_sink.h"
+#include "test_options.h"
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <spdlog/logger.h>
+#include <string>
+#include <vector>
+
+using namespace mlogger;
+
+std::vector<std::string> splitLines(const std::string& text)
+{
+    std::vector<std::string> lines;
+    size_t                   start = 0;
+    for (size_t end; (end = text.find('\n', start)) != std::string::npos; start = end + 1) {
+        lines.push_back(text.substr(start, end - start));
+    }
+    assert(start == text.size() && "only whole lines");
+    return lines;
+}
+
+std::string readAll(TailSink& sink, uint64_t& cursor, size_t chunk = 4096)
+{
+    std::string       text;
+    std::vector<char> buffer(chunk);
+    while (size_t copied = sink.read(cursor, buffer.data(), buffer.size())) {
+        text.append(buffer.data(), copied);
+    }
+    return text;
+}
+
+void test_tail_sink()
+{
+    std::cout << "[TEST] Testing the tail sink...\n";
+
+    auto sink = std::make_shared<TailSink>(4096);
+    sink->set_pattern("%v");
+    spdlog::logger logger("tail", sink);
+
+    uint64_t    cursor = 0;
+    std::string text   = readAll(*sink, cursor);
+    assert(text.empty() && "nothing logged yet");
+
+    logger.info("first");
+    logger.info("second");
+    text = readAll(*sink, cursor);
+    assert(text == "first\nsecond\n");
+    text = readAll(*sink, cursor);
+    assert(text.empty() && "nothing new");
+    assert(cursor == sink->end());
+
+    logger.warn("third");
+    text = readAll(*sink, cursor);
+    assert(text == "third\n" && "only the new line");
+    std::cout << "  [OK] Reads return only new lines\n";
+
+    // a small buffer takes whole lines, or cuts a line longer than itself
+    logger.info("0123456789");
+    logger.info("abc");
+    std::vector<char> small(8);
+    size_t            copied = sink->read(cursor, small.data(), small.size());
+    assert(copied == 8);
+    assert(std::string(small.data(), 8) == "01234567" && "long line cut");
+    copied = sink->read(cursor, small.data(), small.size());
+    assert(copied == 4);
+    assert(std::string(small.data(), 4) == "abc\n");
+    std::cout << "  [OK] Small buffers\n";
+
+    // a reader that falls behind skips what was overwritten
+    uint64_t slow = cursor;
+    for (int i = 0; i < 1000; ++i) {
+        logger.info("line {}", i);
+    }
+    bool skipped = false;
+    char buffer[8192];
+    copied = sink->read(slow, buffer, sizeof(buffer), &skipped);
+    text.assign(buffer, copied);
+    assert(skipped && "overwritten lines reported");
+    std::vector<std::string> lines = splitLines(text);
+    assert(!lines.empty() && lines.back() == "line 999");
+    copied = sink->read(slow, buffer, sizeof(buffer), &skipped);
+    assert(copied == 0 && !skipped);
+    std::cout << "  [OK] Slow reader skipped to " << lines.front() << "\n";
+
+    // a cursor of an earlier sink reads the new one from its oldest line
+    auto later = std::make_shared<TailSink>(4096);
+    later->set_pattern("%v");
+    spdlog::logger later_logger("later", later);
+    later_logger.info("new session");
+    copied = later->read(slow, buffer, sizeof(buffer), &skipped);
+    assert(copied == 12 && skipped);
+    (void)copied;
+    std::cout << "  [OK] Cursor of an earlier sink starts over\n";
+
+    // an oversized line keeps its start and line ending
+    logger.info(std::string(4000, 'x'));
+    cursor = 0;
+    text   = readAll(*sink, cursor);
+    lines  = splitLines(text);
+    assert(lines.back().size() == sink->capacity() / 4 - 5 && "oversized line cut");
+    std::cout << "  [OK] Oversized line cut to " << lines.back().size() << " bytes\n";
+
+    std::cout << "[PASS] Tail sink tests passed\n\n";
+}
+
+bool initTail(const char* log_path, int async_mode, int tail_buffer_size)
+{
+    std::filesystem::remove(log_path);
+
+    MLoggerOptions options   = defaultOptions(log_path, async_mode);
+    options.min_log_level    = LOG_INFO;
+    options.tail_buffer_size = tail_buffer_size;
+    return initWithOptions(&options) == 1;
+}
+
+std::string readTail(uint64_t& cursor)
+{
+    std::string text;
+    char        buffer[4096];
+    while (int copied = readSince(&cursor, buffer, sizeof(buffer), nullptr)) {
+        text.append(buffer, static_cast<size_t>(copied));
+    }
+    return text;
+}
+
+std::vector<std::string> readFileLines(const std::string& path)
+{
+    std::ifstream input(path, std::ios::binary);
+    return splitLines(std::string(std::istreambuf_iterator<char>(input), {}));
+}
+
+void test_live_tail(int async_mode, const char* name)
+{
+    std::cout << "[TEST] Testing the live tail with " << name << "...\n";
+
+    std::string log_path = std::string("test_logs/test_live_tail_") + name + ".log";
+    bool ok = initTail(log_path.c_str(), async_mode, 64 * 1024);
+    assert(ok);
+    (void)ok;
+
+    uint64_t cursor = 0;
+    for (int i = 0; i < 100; ++i) {
+        logMessage(LOG_INFO, ("tail message " + std::to_string(i)).c_str());
+    }
+    logMessage(LOG_DEBUG, "filtered out");
+    flush();
+
+    std::vector<std::string> lines = splitLines(readTail(cursor));
+    assert(lines.size() == 100 && "every record tailed");
+    assert(lines.back().find("tail message 99") != std::string::npos);
+    assert(lines == readFileLines(log_path) && "tail matches the file");
+    std::cout << "  [OK] " << lines.size() << " lines, identical to the file\n";
+
+    // only the lines logged after tailEnd()
+    uint64_t from_now = tailEnd();
+    assert(from_now == cursor);
+    logMessage(LOG_WARN, "after the cursor");
+    flush();
+    lines = splitLines(readTail(from_now));
+    assert(lines.size() == 1 && lines[0].find("after the cursor") != std::string::npos);
+    std::cout << "  [OK] tailEnd() skips older lines\n";
+
+    terminate();
+    char buffer[64];
+    int  copied = readSince(&cursor, buffer, sizeof(buffer), nullptr);
+    assert(copied == 0 && "no tail once terminated");
+    (void)copied;
+
+    std::cout << "[PASS] " << name << " live tail tests passed\n\n";
+}
+
+void test_tail_disabled()
+{
+    std::cout << "[TEST] Testing a disabled live tail...\n";
+
+    bool ok = initTail("test_logs/test_live_tail_off.log", ASYNC_MODE_OFF, 0);
+    assert(ok);
+    logMessage(LOG_INFO, "not tailed");
+
+    uint64_t cursor  = 0;
+    int      skipped = 1;
+    char     buffer[64];
+    int      copied  = readSince(&cursor, buffer, sizeof(buffer), &skipped);
+    assert(copied == 0 && skipped == 0);
+    assert(tailEnd() == 0);
+    copied = readSince(nullptr, buffer, sizeof(buffer), nullptr);
+    assert(copied == 0);
+    terminate();
+
+    ok = initTail("test_logs/test_live_tail_off.log", ASYNC_MODE_OFF, 100);
+    assert(!ok && "tail below 4KB rejected");
+    (void)ok;
+    (void)copied;
+    std::cout << "  [OK] Nothing tailed and invalid sizes rejected\n";
+
+    std::cout << "[PASS] Disabled tail tests passed\n\n";
+}
+
+int main()
+{
+    std::cout << "========================================\n";
+    std::cout << "MLogger Live Tail Test Suite\n";
+    std::cout << "========================================\n\n";
+
+    std::filesystem::create_directories("test_logs");
+
+    try {
+        test_tail_sink();
+        test_live_tail(ASYNC_MODE_OFF, "sync");
+        test_live_tail(ASYNC_MODE_THREAD_POOL, "thread_pool");
+        test_live_tail(ASYNC_MODE_STAGING, "staging");
+        test_tail_disabled();
+
+        std::cout << "========================================\n";
+        std::cout << "All live tail tests passed! [OK]\n";
+        std::cout << "========================================\n";
+
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "\n[FAIL] Test failed with exception: " << e.what() << "\n";
+        terminate();
+        return 1;
+    } catch (...) {
+        std::cerr << "\n[FAIL] Test failed with unknown exception\n";
+        terminate();
+        return 1;
+    }
+}
@@ -0,0 +1,264 @@
+#include "../src/bridge/bridge.h"
+#include "../src/sinks/log_index.h"
+#include "../src/sinks/rotating_file_sink.h"
+#include "test_options.h"
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <spdlog/logger.h>
+#include <string>
+
+using namespace mlogger;
+
+LogIndex readIndex(const std::string& log_path)
+{
+    std::ifstream input(log_path + ".idx", std::ios::binary);
+    LogIndex      index;
+    bool          ok = readLogIndex(input, index);
+    assert(ok && "index readable");
+    (void)ok;
+    return index;
+}
+
+std::string readFile(const std::string& path)
+{
+    std::ifstream input(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+}
+
+void addLine(LogIndexWriter& writer, std::ofstream& log, uint64_t& offset, const std::string& line,
+             spdlog::level::level_enum level)
+{
+    log << line;
+    writer.add(offset, line.data(), line.size(), spdlog::log_clock::now(), level);
+    offset += line.size();
+}
+
+// every block starts at a line and the blocks are contiguous up to the last one
+void checkBlocks(const LogIndex& index, const std::string& content)
+{
+    uint64_t expected_offset = index.blocks.empty() ? 0 : index.blocks.front().offset;
+    for (const LogIndexBlock& block : index.blocks) {
+        assert(block.offset == expected_offset && "blocks contiguous");
+        assert(block.offset + block.size <= content.size() && "block inside the file");
+        assert((block.offset == 0 || content[block.offset - 1] == '\n') && "block starts a line");
+        assert(block.first_time_ns <= block.last_time_ns && "time range ordered");
+
+        uint32_t lines = 0;
+        for (uint64_t i = block.offset; i < block.offset + block.size; ++i) {
+            if (content[i] == '\n') ++lines;
+        }
+        assert(lines == block.lines && "line count matches the file");
+
+        uint32_t records = 0;
+        for (uint32_t count : block.level_counts) records += count;
+        assert(records == block.records && "level counts add up");
+        expected_offset = block.offset + block.size;
+    }
+    (void)expected_offset;
+}
+
+void test_index_writer()
+{
+    std::cout << "[TEST] Testing the index writer...\n";
+
+    const std::string log_path = "test_logs/test_log_index_writer.log";
+    std::filesystem::remove(log_path);
+
+    {
+        std::ofstream  log(log_path, std::ios::binary);
+        LogIndexWriter writer(4);
+        writer.open(log_path, 0);
+        uint64_t offset = 0;
+        for (int i = 0; i < 10; ++i) {
+            auto level = i % 2 ? spdlog::level::warn : spdlog::level::info;
+            addLine(writer, log, offset, "line " + std::to_string(i) + "\n", level);
+        }
+        // one record spanning two lines
+        addLine(writer, log, offset, "first\nsecond\n", spdlog::level::err);
+    }
+
+    LogIndex index = readIndex(log_path);
+    assert(index.block_lines == 4);
+    assert(index.blocks.size() == 3 && "two full blocks and the partial one");
+    assert(index.blocks[0].lines == 4 && index.blocks[0].records == 4);
+    assert(index.blocks[0].level_counts[spdlog::level::info] == 2);
+    assert(index.blocks[0].level_counts[spdlog::level::warn] == 2);
+    assert(index.blocks[2].lines == 4 && index.blocks[2].records == 3);
+    assert(index.blocks[2].level_counts[spdlog::level::err] == 1);
+    checkBlocks(index, readFile(log_path));
+    std::cout << "  [OK] " << index.blocks.size() << " blocks over 12 lines\n";
+
+    // a reopened file continues its index
+    {
+        std::ofstream  log(log_path, std::ios::binary | std::ios::app);
+        uint64_t       offset = std::filesystem::file_size(log_path);
+        LogIndexWriter writer(4);
+        writer.open(log_path, offset);
+        for (int i = 0; i < 4; ++i) {
+            addLine(writer, log, offset, "more\n", spdlog::level::debug);
+        }
+    }
+    index = readIndex(log_path);
+    assert(index.blocks.size() == 4 && "index continued");
+    assert(index.blocks[3].level_counts[spdlog::level::debug] == 4);
+    checkBlocks(index, readFile(log_path));
+    std::cout << "  [OK] Index continued after reopening\n";
+
+    // a torn trailing block is dropped before continuing
+    std::filesystem::resize_file(log_path + ".idx", log_index::kHeaderSize +
+                                                        3 * log_index::kBlockSize + 10);
+    {
+        LogIndexWriter writer(4);
+        writer.open(log_path, std::filesystem::file_size(log_path));
+    }
+    assert(std::filesystem::file_size(log_path + ".idx") ==
+           log_index::kHeaderSize + 3 * log_index::kBlockSize);
+    std::cout << "  [OK] Torn block dropped\n";
+
+    // an index reaching past its file, or written with other settings, starts over
+    {
+        LogIndexWriter writer(4);
+        writer.open(log_path, 8);
+    }
+    assert(readIndex(log_path).blocks.empty() && "stale index restarted");
+    {
+        LogIndexWriter writer(8);
+        writer.open(log_path, std::filesystem::file_size(log_path));
+    }
+    assert(readIndex(log_path).block_lines == 8 && "index with other settings restarted");
+    std::cout << "  [OK] Stale indexes restarted\n";
+
+    std::ifstream not_index(log_path, std::ios::binary);
+    LogIndex      ignored;
+    bool          ok = readLogIndex(not_index, ignored);
+    assert(!ok && "log file is not an index");
+    (void)ok;
+
+    std::cout << "[PASS] Index writer tests passed\n\n";
+}
+
+void test_index_rotation()
+{
+    std::cout << "[TEST] Testing indexes of rotated files...\n";
+
+    const std::string log_path = "test_logs/test_log_index_rotation.log";
+    for (int i = 0; i < 3; ++i) {
+        std::string file = RotatingFileSink::calcFilename(log_path, i);
+        std::filesystem::remove(file);
+        std::filesystem::remove(file + ".idx");
+    }
+
+    {
+        auto sink = std::make_shared<RotatingFileSink>(log_path, 4096, 2);
+        sink->setIndex(8);
+        spdlog::logger logger("index", sink);
+        logger.set_level(spdlog::level::trace);
+        for (int i = 0; i < 300; ++i) {
+            logger.log(static_cast<spdlog::level::level_enum>(i % 6), "record {}", i);
+        }
+    }
+
+    size_t total_records = 0;
+    for (int i = 0; i < 3; ++i) {
+        std::string file = RotatingFileSink::calcFilename(log_path, i);
+        assert(std::filesystem::exists(file + ".idx") && "every file has its index");
+
+        std::string content = readFile(file);
+        LogIndex    index   = readIndex(file);
+        checkBlocks(index, content);
+        assert(!index.blocks.empty() && index.blocks.front().offset == 0);
+        assert(index.blocks.back().offset + index.blocks.back().size == content.size() &&
+               "closed index covers its whole file");
+        for (const LogIndexBlock& block : index.blocks) total_records += block.records;
+    }
+    assert(total_records > 0 && total_records < 300 && "oldest file rotated out");
+    std::cout << "  [OK] " << total_records << " records indexed across 3 files\n";
+
+    std::cout << "[PASS] Rotation tests passed\n\n";
+}
+
+bool initIndexed(const char* log_path, int index_block_lines, int file_format = LOG_FILE_TEXT)
+{
+    std::filesystem::remove(log_path);
+    std::filesystem::remove(std::string(log_path) + ".idx");
+
+    MLoggerOptions options    = defaultOptions(log_path, ASYNC_MODE_OFF);
+    options.file_format       = file_format;
+    options.index_block_lines = index_block_lines;
+    return initWithOptions(&options) == 1;
+}
+
+void test_index_options()
+{
+    std::cout << "[TEST] Testing index options...\n";
+
+    const char* log_path = "test_logs/test_log_index_options.log";
+    bool ok = initIndexed(log_path, 16);
+    assert(ok);
+    for (int i = 0; i < 100; ++i) {
+        logMessage(i % 10 == 0 ? LOG_ERROR : LOG_INFO, "indexed message");
+    }
+    terminate();
+
+    LogIndex index = readIndex(log_path);
+    assert(index.block_lines == 16);
+    checkBlocks(index, readFile(log_path));
+    uint32_t errors = 0;
+    for (const LogIndexBlock& block : index.blocks) errors += block.level_counts[LOG_ERROR];
+    assert(errors == 10 && "error records counted");
+    std::cout << "  [OK] " << index.blocks.size() << " blocks, " << errors << " errors\n";
+
+    ok = initIndexed(log_path, 0);
+    assert(ok);
+    logMessage(LOG_INFO, "not indexed");
+    terminate();
+    assert(!std::filesystem::exists(std::string(log_path) + ".idx") && "index is opt-in");
+
+    ok = initIndexed(log_path, -1);
+    assert(ok);
+    logMessage(LOG_INFO, "not indexed");
+    terminate();
+    assert(!std::filesystem::exists(std::string(log_path) + ".idx") && "index disabled");
+
+    ok = initIndexed(log_path, 16, LOG_FILE_BINARY);
+    assert(ok);
+    (void)ok;
+    logMessage(LOG_INFO, "binary");
+    terminate();
+    assert(!std::filesystem::exists(std::string(log_path) + ".idx") && "binary files unindexed");
+    std::cout << "  [OK] No index by default, when disabled or for binary files\n";
+
+    std::cout << "[PASS] Index option tests passed\n\n";
+}
+
+int main()
+{
+    std::cout << "========================================\n";
+    std::cout << "MLogger Log Index Test Suite\n";
+    std::cout << "========================================\n\n";
+
+    std::filesystem::create_directories("test_logs");
+
+    try {
+        test_index_writer();
+        test_index_rotation();
+        test_index_options();
+
+        std::cout << "========================================\n";
+        std::cout << "All log index tests passed! [OK]\n";
+        std::cout << "========================================\n";
+
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "\n[FAIL] Test failed with exception: " << e.what() << "\n";
+        terminate();
+        return 1;
+    } catch (...) {
+        std::cerr << "\n[FAIL] Test failed with unknown exception\n";
+        terminate();
+        return 1;
+    }
+}
@@ -0,0 +1,239 @@
+#include "../src/bridge/bridge.h"
+#include "../src/utils/log_search.h"
+#include "test_options.h"
+#include <cassert>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace mlogger;
+
+// what searchLines() must return, one line at a time
+std::vector<uint64_t> naiveSearch(const std::string& data, const std::string& text,
+                                  bool ignore_case)
+{
+    auto fold = [](std::string value) {
+        for (char& c : value) {
+            if (c >= 'A' && c <= 'Z') c = static_cast<char>(c | 0x20);
+        }
+        return value;
+    };
+    std::string needle = ignore_case ? fold(text) : text;
+
+    std::vector<uint64_t> offsets;
+    for (size_t start = 0; start < data.size();) {
+        size_t      end  = std::min(data.find('\n', start), data.size());
+        std::string line = data.substr(start, end - start);
+        if ((ignore_case ? fold(line) : line).find(needle) != std::string::npos) {
+            offsets.push_back(start);
+        }
+        start = end + 1;
+    }
+    return offsets;
+}
+
+std::vector<uint64_t> search(const std::string& data, const std::string& text, bool ignore_case,
+                             bool scalar, unsigned threads, unsigned level_mask = 0)
+{
+    LogSearchQuery query;
+    query.text        = text;
+    query.ignore_case = ignore_case;
+    query.scalar      = scalar;
+    query.threads     = threads;
+    query.level_mask  = level_mask;
+
+    std::vector<uint64_t> offsets;
+    searchLines(data.data(), data.size(), query, offsets);
+    return offsets;
+}
+
+void test_matches_naive_search()
+{
+    std::cout << "[TEST] Testing search against a naive scan (" << searchKernelName() << ")...\n";
+
+    // few distinct bytes, so partial matches straddle every block boundary
+    std::mt19937 random(42);
+    std::string  data;
+    for (int i = 0; i < 200000; ++i) {
+        int pick = static_cast<int>(random() % 16);
+        data += pick == 0 ? '\n' : "abAB-x"[pick % 6];
+    }
+    data += "tail without line ending ab";
+
+    const char* needles[] = {"a", "B", "ab", "aB-", "xab", "abab", "ABABA", "-x-x-", "bAbx-aB"};
+    size_t      checked   = 0;
+    for (const char* needle : needles) {
+        for (bool ignore_case : {false, true}) {
+            std::vector<uint64_t> expected = naiveSearch(data, needle, ignore_case);
+            for (bool scalar : {false, true}) {
+                for (unsigned threads : {1u, 3u, 8u}) {
+                    auto found = search(data, needle, ignore_case, scalar, threads);
+                    assert(found == expected);
+                    ++checked;
+                }
+            }
+        }
+    }
+    assert(search(data, "not there", false, false, 4).empty());
+    assert(search(data, "", false, false, 4).size() == naiveSearch(data, "", false).size());
+    std::cout << "  [OK] " << checked << " searches match the naive scan\n";
+
+    // matches at the very start and end of the data, and a needle longer than it
+    assert(search("needle", "needle", false, false, 1) == std::vector<uint64_t>{0});
+    assert(search("x\nneedle", "needle", false, false, 1) == std::vector<uint64_t>{2});
+    assert(search("need", "needle", false, false, 1).empty());
+    std::cout << "  [OK] Edges of the data\n";
+
+    std::cout << "[PASS] Naive search tests passed\n\n";
+}
+
+void test_level_filter()
+{
+    std::cout << "[TEST] Testing level filtering...\n";
+
+    std::string data = "[2024-01-01 00:00:00.000] [MLogger] [info] loading level 1\n"
+                       "[2024-01-01 00:00:00.001] [MLogger] [warning] level 1 is slow\n"
+                       "[2024-01-01 00:00:00.002] [MLogger] [error] level 1 failed\n"
+                       "  at Loader.Load()\n"
+                       "[2024-01-01 00:00:00.003] [MLogger] [debug] [info] retry level 1\n";
+
+    assert(search(data, "level", false, false, 1).size() == 4 && "every level");
+
+    unsigned warn_error = (1u << LOG_WARN) | (1u << LOG_ERROR);
+    auto     found      = search(data, "level", false, false, 1, warn_error);
+    assert(found.size() == 2 && data.compare(found[0], 26, "[2024-01-01 00:00:00.001] ") == 0);
+
+    // the first level field counts, lines without one are info
+    found = search(data, "", false, false, 1, 1u << LOG_INFO);
+    assert(found.size() == 2 && data.compare(found[1], 4, "  at") == 0);
+    found = search(data, "retry", false, false, 1, 1u << LOG_DEBUG);
+    assert(found.size() == 1);
+    assert(search(data, "", false, false, 1, 1u << LOG_CRITICAL).empty());
+    std::cout << "  [OK] Levels taken from the [level] field\n";
+
+    std::cout << "[PASS] Level filter tests passed\n\n";
+}
+
+bool initSearchLog(const char* log_path, int file_writer)
+{
+    std::filesystem::remove(log_path);
+
+    MLoggerOptions options = defaultOptions(log_path, ASYNC_MODE_OFF);
+    options.file_writer    = file_writer;
+    return initWithOptions(&options) == 1;
+}
+
+void test_search_log(int file_writer, const char* name)
+{
+    std::cout << "[TEST] Testing searchLog() on a " << name << " file...\n";
+
+    std::string log_path = std::string("test_logs/test_log_search_") + name + ".log";
+    bool ok = initSearchLog(log_path.c_str(), file_writer);
+    assert(ok);
+    (void)ok;
+    for (int i = 0; i < 1000; ++i) {
+        logMessage(i % 10 == 0 ? LOG_ERROR : LOG_INFO, ("Player " + std::to_string(i)).c_str());
+    }
+    flush();
+
+    // the file is searched while the logger keeps it open
+    std::vector<uint64_t> offsets(2000);
+    int64_t count = searchLog(log_path.c_str(), "player", 6, MLOGGER_SEARCH_IGNORE_CASE, 0,
+                              offsets.data(), static_cast<int>(offsets.size()));
+    assert(count == 1000 && "every line, no match in the mapped file's free space");
+    count = searchLog(log_path.c_str(), "player", 6, 0, 0, offsets.data(), 10);
+    assert(count == 0);
+
+    count = searchLog(log_path.c_str(), "Player 99", 9, 0, 0, offsets.data(), 2000);
+    assert(count == 11 && "99 and 990..999");
+
+    // only errors, the newest three
+    count = searchLog(log_path.c_str(), "Player", 6, MLOGGER_SEARCH_NEWEST, 1 << LOG_ERROR,
+                      offsets.data(), 3);
+    assert(count == 100);
+    terminate();
+
+    std::ifstream input(log_path, std::ios::binary);
+    std::string   content(std::istreambuf_iterator<char>(input), {});
+    for (int i = 0; i < 3; ++i) {
+        size_t      end      = content.find('\n', offsets[i]);
+        std::string expected = "Player 9" + std::to_string(7 + i) + "0";
+        assert(content.substr(offsets[i], end - offsets[i]).find(expected) != std::string::npos);
+        (void)end;
+    }
+    std::cout << "  [OK] Counts, levels and the newest matches\n";
+
+    count = searchLog("test_logs/missing.log", "x", 1, 0, 0, offsets.data(), 1);
+    assert(count == -1);
+    count = searchLog(nullptr, "x", 1, 0, 0, offsets.data(), 1);
+    assert(count == -1);
+    count = searchLog(log_path.c_str(), "x", 1, 0, 0, nullptr, 1);
+    assert(count == -1);
+    count = searchLog(log_path.c_str(), nullptr, 0, 0, 0, nullptr, 0);
+    assert(count == 1000 && "count only");
+    (void)count;
+    std::cout << "  [OK] Invalid arguments rejected\n";
+
+    std::cout << "[PASS] " << name << " searchLog tests passed\n\n";
+}
+
+void test_throughput()
+{
+    std::cout << "[TEST] Testing search throughput...\n";
+
+    std::string line = "[2024-01-01 00:00:00.000] [MLogger] [info] Player moved to (12.5, 3.0)\n";
+    std::string data;
+    data.reserve(64 * 1024 * 1024);
+    while (data.size() + line.size() <= data.capacity()) {
+        data += line;
+    }
+
+    for (unsigned threads : {1u, 0u}) {
+        auto start = std::chrono::steady_clock::now();
+        auto found = search(data, "connection lost", true, false, threads);
+        auto end   = std::chrono::steady_clock::now();
+        assert(found.empty());
+
+        double seconds = std::chrono::duration<double>(end - start).count();
+        std::cout << "  [OK] " << (threads == 1 ? "1 thread: " : "all threads: ")
+                  << static_cast<int>(data.size() / (1024.0 * 1024.0) / seconds) << " MB/s\n";
+    }
+
+    std::cout << "[PASS] Throughput tests passed\n\n";
+}
+
+int main()
+{
+    std::cout << "========================================\n";
+    std::cout << "MLogger Log Search Test Suite\n";
+    std::cout << "========================================\n\n";
+
+    std::filesystem::create_directories("test_logs");
+
+    try {
+        test_matches_naive_search();
+        test_level_filter();
+        test_search_log(LOG_WRITER_STDIO, "stdio");
+        test_search_log(LOG_WRITER_MAPPED, "mapped");
+        test_throughput();
+
+        std::cout << "========================================\n";
+        std::cout << "All log search tests passed! [OK]\n";
+        std::cout << "========================================\n";
+
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "\n[FAIL] Test failed with exception: " << e.what() << "\n";
+        terminate();
+        return 1;
+    } catch (...) {
+        std::cerr << "\n[FAIL] Test failed with unknown exception\n";
+        terminate();
+        return 1;
+    }
+}
@@ -0,0 +1,256 @@
+#include "../src/bridge/bridge.h"
+#include "../src/sinks/binary_format.h"
+#include "../src/sinks/mapped_log_file.h"
+#include "../src/sinks/rotating_file_sink.h"
+#include "test_options.h"
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+bool initMapped(const char* log_path, size_t max_file_size, int file_format, int async_mode)
+{
+    MLoggerOptions options = defaultOptions(log_path, async_mode);
+    options.max_file_size  = max_file_size;
+    options.max_files      = 5;
+    options.file_format    = file_format;
+    options.file_writer    = LOG_WRITER_MAPPED;
+    return initWithOptions(&options) == 1;
+}
+
+std::string readFile(const std::string& path)
+{
+    std::ifstream      input(path, std::ios::binary);
+    std::ostringstream content;
+    content << input.rdbuf();
+    return content.str();
+}
+
+std::vector<std::string> readLines(const std::string& path)
+{
+    std::ifstream            input(path);
+    std::vector<std::string> lines;
+    std::string              line;
+    while (std::getline(input, line)) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+void removeLogs(const char* log_path)
+{
+    for (size_t i = 0; i <= 5; ++i) {
+        std::filesystem::remove(mlogger::RotatingFileSink::calcFilename(log_path, i));
+    }
+}
+
+void test_mapped_text()
+{
+    std::cout << "[TEST] Testing mapped text log...\n";
+
+    const char* log_path = "test_logs/test_mapped.log";
+    removeLogs(log_path);
+    bool ok = initMapped(log_path, 1024 * 1024, LOG_FILE_TEXT, ASYNC_MODE_OFF);
+    assert(ok);
+
+    // Test 1: records reach the file without a flush, the file is preallocated while open
+    logMessage(LOG_INFO, "First mapped record");
+    assert(readFile(log_path).find("First mapped record") != std::string::npos);
+    assert(std::filesystem::file_size(log_path) > 1024 * 1024);
+    std::cout << "  [OK] Records visible before any flush\n";
+
+    // Test 2: terminate trims the file to its data
+    const int num_logs = 1000;
+    for (int i = 0; i < num_logs; ++i) {
+        char buffer[64];
+        snprintf(buffer, sizeof(buffer), "Mapped record %d", i);
+        logMessage(LOG_INFO, buffer);
+    }
+    terminate();
+
+    auto lines = readLines(log_path);
+    assert(lines.size() == static_cast<size_t>(num_logs + 1));
+    assert(lines.back().find("Mapped record 999") != std::string::npos);
+    assert(readFile(log_path).find('\0') == std::string::npos);
+    std::cout << "  [OK] File trimmed to " << std::filesystem::file_size(log_path) << " bytes\n";
+
+    // Test 3: a new session appends after the existing data
+    ok = initMapped(log_path, 1024 * 1024, LOG_FILE_TEXT, ASYNC_MODE_THREAD_POOL);
+    assert(ok);
+    (void)ok;
+    logMessage(LOG_WARN, "Second session");
+    terminate();
+    lines = readLines(log_path);
+    assert(lines.size() == static_cast<size_t>(num_logs + 2));
+    assert(lines.back().find("Second session") != std::string::npos);
+    std::cout << "  [OK] Appended session\n";
+
+    std::cout << "[PASS] Mapped text log tests passed\n\n";
+}
+
+void test_mapped_rotation()
+{
+    std::cout << "[TEST] Testing mapped log rotation...\n";
+
+    const char* log_path = "test_logs/test_mapped_rotation.log";
+    removeLogs(log_path);
+    bool ok = initMapped(log_path, 4 * 1024, LOG_FILE_TEXT, ASYNC_MODE_THREAD_POOL);
+    assert(ok);
+    (void)ok;
+
+    const int num_logs = 300;
+    for (int i = 0; i < num_logs; ++i) {
+        char buffer[64];
+        snprintf(buffer, sizeof(buffer), "Rotating mapped record %d", i);
+        logMessage(LOG_INFO, buffer);
+    }
+    terminate();
+
+    // Test 1: rotation happened and every file was trimmed within the limit
+    assert(std::filesystem::exists(mlogger::RotatingFileSink::calcFilename(log_path, 1)));
+    for (size_t i = 0; i <= 5; ++i) {
+        auto file = mlogger::RotatingFileSink::calcFilename(log_path, i);
+        if (std::filesystem::exists(file)) {
+            assert(std::filesystem::file_size(file) <= 4 * 1024);
+            assert(readFile(file).find('\0') == std::string::npos);
+        }
+    }
+    std::cout << "  [OK] Files rotated within the size limit\n";
+
+    // Test 2: the newest records are intact and in order
+    int last_seq = -1;
+    for (size_t i = 5;; --i) {
+        auto file = mlogger::RotatingFileSink::calcFilename(log_path, i);
+        if (std::filesystem::exists(file)) {
+            for (const auto& line : readLines(file)) {
+                size_t at     = line.find("Rotating mapped record ");
+                int    seq    = -1;
+                int    parsed = at == std::string::npos
+                                    ? 0
+                                    : sscanf(line.c_str() + at, "Rotating mapped record %d", &seq);
+                assert(parsed == 1);
+                assert(seq == last_seq + 1 || last_seq == -1);
+                (void)parsed;
+                last_seq = seq;
+            }
+        }
+        if (i == 0) break;
+    }
+    assert(last_seq == num_logs - 1);
+    (void)last_seq;
+    std::cout << "  [OK] Records continuous across files\n";
+
+    std::cout << "[PASS] Mapped log rotation tests passed\n\n";
+}
+
+void test_mapped_recovery()
+{
+    std::cout << "[TEST] Testing mapped file crash recovery...\n";
+
+    // a file as a crashed writer leaves it: data, zero padding and the trailer
+    const char*       path = "test_logs/test_mapped_crash.log";
+    const std::string data = "line written before the crash\n";
+    {
+        std::ofstream output(path, std::ios::binary | std::ios::trunc);
+        output << data << std::string(4096, '\0');
+        uint64_t length = data.size();
+        output.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        output.write("MLOGMAP\0", 8);
+    }
+
+    // Test 1: reopening keeps only the data
+    mlogger::MappedLogFile file(64 * 1024);
+    file.open(path, false);
+    assert(file.size() == data.size());
+    std::cout << "  [OK] Length restored from the trailer\n";
+
+    // Test 2: appends continue right after the data and close trims the padding
+    spdlog::memory_buf_t buffer;
+    std::string          more = "line written after the restart\n";
+    buffer.append(more.data(), more.data() + more.size());
+    file.write(buffer);
+    file.close();
+    assert(readFile(path) == data + more);
+    std::cout << "  [OK] Appended after the recovered data\n";
+
+    // Test 3: a record larger than the mapping grows it
+    mlogger::MappedLogFile small(64);
+    small.open(path, true);
+    std::string large(10000, 'x');
+    buffer.clear();
+    buffer.append(large.data(), large.data() + large.size());
+    small.write(buffer);
+    small.write(buffer);
+    small.close();
+    assert(readFile(path) == large + large);
+    std::cout << "  [OK] Mapping grown for oversized records\n";
+
+    std::cout << "[PASS] Mapped file crash recovery tests passed\n\n";
+}
+
+void test_mapped_binary()
+{
+    std::cout << "[TEST] Testing mapped binary log...\n";
+
+    const char* log_path = "test_logs/test_mapped.mlog";
+    removeLogs(log_path);
+    bool ok = initMapped(log_path, 1024 * 1024, LOG_FILE_BINARY, ASYNC_MODE_THREAD_POOL);
+    assert(ok);
+    (void)ok;
+    const int num_logs = 500;
+    for (int i = 0; i < num_logs; ++i) {
+        logMessage(LOG_INFO, "Shared binary text");
+    }
+    terminate();
+
+    // Test 1: the trimmed file decodes completely
+    std::ifstream            input(log_path, std::ios::binary);
+    mlogger::BinaryLogReader reader(input);
+    mlogger::BinaryLogEntry  entry;
+    int                      count = 0;
+    while (reader.next(entry)) {
+        assert(entry.text == "Shared binary text");
+        ++count;
+    }
+    assert(reader.error().empty());
+    assert(count == num_logs);
+    std::cout << "  [OK] Binary records decode from the mapped file\n";
+
+    std::cout << "[PASS] Mapped binary log tests passed\n\n";
+}
+
+int main()
+{
+    std::cout << "========================================\n";
+    std::cout << "MLogger Mapped File Test Suite\n";
+    std::cout << "========================================\n\n";
+
+    std::filesystem::create_directories("test_logs");
+
+    try {
+        test_mapped_text();
+        test_mapped_rotation();
+        test_mapped_recovery();
+        test_mapped_binary();
+
+        std::cout << "========================================\n";
+        std::cout << "All mapped file tests passed! [OK]\n";
+        std::cout << "========================================\n";
+
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "\n[FAIL] Test failed with exception: " << e.what() << "\n";
+        terminate();
+        return 1;
+    } catch (...) {
+        std::cerr << "\n[FAIL] Test failed with unknown exception\n";
+        terminate();
+        return 1;
+    }
+}
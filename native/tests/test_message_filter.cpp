@@ -0,0 +1,298 @@
+#include "../src/bridge/bridge.h"
+#include "../src/core/message_filter.h"
+#include "../src/sinks/rotating_file_sink.h"
+#include "test_options.h"
+#include <atomic>
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mlogger;
+
+constexpr int64_t kMs = 1000000;
+
+std::string readFile(const std::string& path)
+{
+    std::ifstream input(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+}
+
+size_t countOf(const std::string& text, const std::string& part)
+{
+    size_t count = 0;
+    for (size_t at = text.find(part); at != std::string::npos; at = text.find(part, at + 1)) {
+        ++count;
+    }
+    return count;
+}
+
+using Verdict = MessageFilter::Verdict;
+
+Verdict check(MessageFilter& filter, int channel, int level, const std::string& text, int64_t now,
+              MessageFilter::Summaries& summaries)
+{
+    return filter.check(channel, level, nullptr, spdlog::string_view_t(text), now, summaries);
+}
+
+void test_duplicates()
+{
+    std::cout << "[TEST] Testing duplicate suppression...\n";
+
+    MessageFilter            filter(4, 1000, 0, 0);
+    MessageFilter::Summaries summaries;
+    Verdict verdict = check(filter, 0, 4, "NullReference in Update", 0, summaries);
+    assert(verdict == Verdict::pass);
+    for (int i = 1; i < 100; ++i) {
+        verdict = check(filter, 0, 4, "NullReference in Update", i * kMs, summaries);
+        assert(verdict == Verdict::repeated);
+        assert(summaries.count == 0);
+    }
+
+    // same text on another level or channel is another record
+    verdict = check(filter, 0, 3, "NullReference in Update", 100 * kMs, summaries);
+    assert(verdict == Verdict::pass);
+    verdict = check(filter, 1, 4, "NullReference in Update", 100 * kMs, summaries);
+    assert(verdict == Verdict::pass);
+    std::cout << "  [OK] Repeats within the window held back\n";
+
+    // back after the window: one copy written, preceded by the count
+    verdict = check(filter, 0, 4, "NullReference in Update", 1000 * kMs, summaries);
+    assert(verdict == Verdict::pass);
+    assert(summaries.count == 1);
+    const MessageFilter::Summary& summary = summaries.items[0];
+    assert(!summary.rate_limited && summary.count == 99 && summary.level == 4);
+    assert(std::string(summary.payload, summary.payload_size) == "NullReference in Update");
+    (void)verdict;
+    (void)summary;
+    std::cout << "  [OK] Reported when the record comes back\n";
+
+    // quiet records are reported by the sweep
+    for (int i = 0; i < 5; ++i) {
+        check(filter, 2, 2, "quiet", 1001 * kMs, summaries);
+    }
+    std::vector<MessageFilter::Summary> swept;
+    auto collect = [&swept](const MessageFilter::Summary& item) { swept.push_back(item); };
+    filter.sweep(1500 * kMs, false, collect);
+    assert(swept.empty() && "windows still open");
+    filter.sweep(2001 * kMs, false, collect);
+    assert(swept.size() == 1 && swept[0].count == 4 && swept[0].channel == 2);
+    filter.sweep(3000 * kMs, false, collect);
+    assert(swept.size() == 1 && "reported once");
+
+    check(filter, 2, 2, "quiet", 3000 * kMs, summaries);
+    check(filter, 2, 2, "quiet", 3001 * kMs, summaries);
+    filter.sweep(3002 * kMs, true, collect);
+    assert(swept.size() == 2 && swept[1].count == 1 && "everything pending when all");
+    std::cout << "  [OK] Quiet records swept\n";
+
+    // long records keep the start
+    std::string long_text(500, 'x');
+    check(filter, 3, 2, long_text, 0, summaries);
+    check(filter, 3, 2, long_text, 1, summaries);
+    swept.clear();
+    filter.sweep(0, true, collect);
+    assert(swept.size() == 1 && swept[0].truncated);
+    assert(swept[0].payload_size == MessageFilter::kMaxPreview);
+    std::cout << "  [OK] Long records truncated in the summary\n";
+
+    std::cout << "[PASS] Duplicate tests passed\n\n";
+}
+
+void test_rate_limit()
+{
+    std::cout << "[TEST] Testing rate limits...\n";
+
+    // 10 per second, bursts of 5
+    MessageFilter            filter(4, 0, 10, 5);
+    MessageFilter::Summaries summaries;
+    int                      passed = 0;
+    for (int i = 0; i < 100; ++i) {
+        if (check(filter, 0, 2, "record " + std::to_string(i), 0, summaries) == Verdict::pass) {
+            ++passed;
+        }
+    }
+    assert(passed == 5 && "the burst");
+
+    // other levels and channels have buckets of their own, critical records none
+    Verdict verdict = check(filter, 0, 3, "warning", 0, summaries);
+    assert(verdict == Verdict::pass);
+    verdict = check(filter, 1, 2, "other channel", 0, summaries);
+    assert(verdict == Verdict::pass);
+    for (int i = 0; i < 100; ++i) {
+        verdict = check(filter, 0, 5, "critical", 0, summaries);
+        assert(verdict == Verdict::pass);
+    }
+    std::cout << "  [OK] Burst admitted, the rest limited\n";
+
+    // one token back after 100ms, reporting what was limited
+    verdict = check(filter, 0, 2, "later", 99 * kMs, summaries);
+    assert(verdict == Verdict::rate_limited);
+    verdict = check(filter, 0, 2, "later", 100 * kMs, summaries);
+    assert(verdict == Verdict::pass);
+    assert(summaries.count == 1 && summaries.items[0].rate_limited);
+    assert(summaries.items[0].count == 96);
+    (void)verdict;
+    std::cout << "  [OK] Refilled at the rate, limited records reported\n";
+
+    for (int i = 0; i < 3; ++i) {
+        check(filter, 0, 2, "over", 100 * kMs, summaries);
+    }
+    std::vector<MessageFilter::Summary> swept;
+    filter.sweep(100 * kMs, false, [&swept](const MessageFilter::Summary& item) {
+        swept.push_back(item);
+    });
+    assert(swept.size() == 1 && swept[0].rate_limited && swept[0].count == 3);
+    std::cout << "  [OK] Limited records swept\n";
+
+    std::cout << "[PASS] Rate limit tests passed\n\n";
+}
+
+void test_concurrent()
+{
+    std::cout << "[TEST] Testing concurrent producers...\n";
+
+    MessageFilter            filter(4, 60000, 0, 0);
+    const int                threads = 4;
+    const int                count   = 50000;
+    std::atomic<uint64_t>    passed{0};
+    std::atomic<uint64_t>    reported{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&filter, &passed, &reported]() {
+            MessageFilter::Summaries summaries;
+            for (int i = 0; i < count; ++i) {
+                std::string text = "record " + std::to_string(i % 16);
+                if (check(filter, 0, 2, text, MessageFilter::now(), summaries) == Verdict::pass) {
+                    passed.fetch_add(1);
+                }
+                for (size_t s = 0; s < summaries.count; ++s) {
+                    reported.fetch_add(summaries.items[s].count);
+                }
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    filter.sweep(MessageFilter::now(), true, [&reported](const MessageFilter::Summary& item) {
+        reported.fetch_add(item.count);
+    });
+
+    // a busy slot lets a record through, every held back one is reported
+    assert(passed.load() >= 16 && passed.load() < threads * count / 4);
+    assert(passed.load() + reported.load() == static_cast<uint64_t>(threads * count));
+    std::cout << "  [OK] " << passed.load() << " written, every other record counted\n";
+
+    std::cout << "[PASS] Concurrent tests passed\n\n";
+}
+
+void test_logger(int async_mode, const char* name)
+{
+    std::cout << "[TEST] Testing the logger with filters, " << name << "...\n";
+
+    std::string log_path = std::string("test_logs/test_message_filter_") + name + ".log";
+    for (size_t i = 0; i <= 3; ++i) {
+        std::filesystem::remove(RotatingFileSink::calcFilename(log_path, i));
+    }
+
+    MLoggerOptions options   = defaultOptions(log_path.c_str(), async_mode);
+    options.dedup_window_ms  = 60000;
+    options.rate_limit       = 10;
+    options.rate_limit_burst = 20;
+    int result               = initWithOptions(&options);
+    assert(result == 1);
+
+    // the error of a broken Update(), once per frame
+    for (int frame = 0; frame < 10000; ++frame) {
+        logMessage(LOG_ERROR, "Object reference not set to an instance of an object");
+    }
+    for (int i = 0; i < 1000; ++i) {
+        logMessage(LOG_DEBUG, ("debug " + std::to_string(i)).c_str());
+    }
+    int net = createChannel("filter_net");
+    logChannel(net, LOG_DEBUG, "channel record");
+    logMessage(LOG_CRITICAL, "critical record");
+
+    MLoggerStats stats{};
+    stats.struct_size = sizeof(MLoggerStats);
+    result            = getStats(&stats);
+    assert(result == 1);
+    (void)result;
+    assert(stats.suppressed == 9999);
+    assert(stats.rate_limited >= 900 && stats.rate_limited <= 980);
+    terminate();
+
+    std::string content = readFile(log_path);
+    assert(countOf(content, "Object reference not set") == 2);
+    assert(countOf(content, "last message repeated 9999 times: Object reference not set") == 1);
+    assert(countOf(content, "debug ") >= 20 && countOf(content, "debug ") <= 100);
+    assert(content.find(std::to_string(stats.rate_limited) + " messages rate limited") !=
+           std::string::npos);
+    assert(countOf(content, "channel record") == 1 && countOf(content, "critical record") == 1);
+    std::cout << "  [OK] 11000 records down to " << countOf(content, "\n") << " lines\n";
+
+    std::cout << "[PASS] " << name << " logger tests passed\n\n";
+}
+
+void test_off_and_validation()
+{
+    std::cout << "[TEST] Testing filters off and validation...\n";
+
+    std::string log_path = "test_logs/test_message_filter_off.log";
+    std::filesystem::remove(log_path);
+    MLoggerOptions options = defaultOptions(log_path.c_str(), ASYNC_MODE_OFF);
+    int            result  = initWithOptions(&options);
+    assert(result == 1);
+    for (int i = 0; i < 100; ++i) {
+        logMessage(LOG_INFO, "same again");
+    }
+    terminate();
+    assert(countOf(readFile(log_path), "same again") == 100);
+    std::cout << "  [OK] Off by default\n";
+
+    options.dedup_window_ms = -1;
+    result                  = initWithOptions(&options);
+    assert(result == 0 && isInit() == 0);
+    (void)result;
+    std::cout << "  [OK] Negative windows rejected\n";
+
+    std::cout << "[PASS] Off and validation tests passed\n\n";
+}
+
+int main()
+{
+    std::cout << "========================================\n";
+    std::cout << "MLogger Message Filter Test Suite\n";
+    std::cout << "========================================\n\n";
+
+    std::filesystem::create_directories("test_logs");
+
+    try {
+        test_duplicates();
+        test_rate_limit();
+        test_concurrent();
+        test_logger(ASYNC_MODE_OFF, "sync");
+        test_logger(ASYNC_MODE_THREAD_POOL, "thread_pool");
+        test_logger(ASYNC_MODE_STAGING, "staging");
+        test_off_and_validation();
+
+        std::cout << "========================================\n";
+        std::cout << "All message filter tests passed! [OK]\n";
+        std::cout << "========================================\n";
+
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "\n[FAIL] Test failed with exception: " << e.what() << "\n";
+        terminate();
+        return 1;
+    } catch (...) {
+        std::cerr << "\n[FAIL] Test failed with unknown exception\n";
+        terminate();
+        return 1;
+    }
+}
@@ -1,13 +1,18 @@
 #include "../src/bridge/bridge.h"
 #include "../src/core/logger_config.h"
 #include "../src/core/logger_manager.h"
+#include "../src/sinks/flush_barrier.h"
+#include "../src/utils/str_utils.h"
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <cstdio>
 #include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <mutex>
+#include <spdlog/sinks/sink.h>
 #include <string>
 #include <thread>
 #include <vector>
@@ -50,6 +55,7 @@ void test_initialization()
     int         result   = initDefault(log_path);
     assert(result == 1);
     assert(isInit() == 1);
+    (void)result;
     std::cout << "  [OK] initDefault() succeeds\n";
 
     // Test 3: terminate
@@ -173,6 +179,96 @@ void test_set_get_log_level()
     std::cout << "[PASS] Set/get log level tests passed\n\n";
 }
 
+void test_log_level_ptr()
+{
+    std::cout << "[TEST] Testing log level pointer...\n";
+
+    // Test 1: the level word rejects everything before initialization
+    const volatile int* level_ptr = getLogLevelPtr();
+    assert(level_ptr != nullptr);
+    assert(*level_ptr == LOG_OFF);
+    std::cout << "  [OK] Level word is LOG_OFF when not initialized\n";
+
+    // Test 2: the level word follows init() and setLogLevel()
+    init("test_logs/test_level_ptr.log", 1024 * 1024, 3, 0, 1, LOG_WARN);
+    assert(*level_ptr == LOG_WARN);
+    setLogLevel(LOG_DEBUG);
+    assert(*level_ptr == LOG_DEBUG);
+    assert(getLogLevelPtr() == level_ptr);
+    std::cout << "  [OK] Level word tracks the active level\n";
+
+    // Test 3: invalid levels leave the level word untouched
+    setLogLevel(99);
+    assert(*level_ptr == LOG_DEBUG);
+    std::cout << "  [OK] Invalid level keeps the level word\n";
+
+    terminate();
+    assert(*level_ptr == LOG_OFF);
+    (void)level_ptr;
+    std::cout << "  [OK] Level word resets on terminate()\n";
+
+    std::cout << "[PASS] Log level pointer tests passed\n\n";
+}
+
+void test_log_batch()
+{
+    std::cout << "[TEST] Testing batch logging...\n";
+
+    const char* log_path = "test_logs/test_batch.log";
+    init(log_path, 1024 * 1024, 3, 0, 1, LOG_INFO);
+
+    // records point into one shared buffer without terminators
+    const char buffer[] = "Batch first|Batch second|Batch filtered|Batch stamped";
+    LogRecord  records[4]{};
+    records[0].message = buffer;
+    records[0].length  = 11;
+    records[0].level   = LOG_INFO;
+
+    records[1].message = buffer + 12;
+    records[1].length  = 12;
+    records[1].level   = LOG_ERROR;
+
+    records[2].message = buffer + 25;
+    records[2].length  = 14;
+    records[2].level   = LOG_DEBUG;
+
+    records[3].message      = buffer + 40;
+    records[3].length       = 13;
+    records[3].level        = LOG_WARN;
+    records[3].timestamp_us = 1000000000LL * 1000000LL;   // 2001-09-09
+
+    // Test 1: filtered records are not submitted
+    int submitted = logBatch(records, 4);
+    assert(submitted == 3);
+    std::cout << "  [OK] logBatch() submits records above the level filter\n";
+
+    // Test 2: messages honour their lengths
+    flush();
+    std::string content = readFileContent(log_path);
+    assert(content.find("Batch first\n") != std::string::npos);
+    assert(content.find("Batch second\n") != std::string::npos);
+    assert(content.find("Batch filtered") == std::string::npos);
+    assert(content.find("Batch stamped\n") != std::string::npos);
+    std::cout << "  [OK] Length-delimited messages written correctly\n";
+
+    // Test 3: caller supplied timestamps are kept
+    assert(content.find("[2001-09-") != std::string::npos);
+    std::cout << "  [OK] Record timestamps preserved\n";
+
+    // Test 4: invalid input
+    submitted = logBatch(nullptr, 4);
+    assert(submitted == 0);
+    submitted = logBatch(records, 0);
+    assert(submitted == 0);
+    terminate();
+    submitted = logBatch(records, 4);
+    assert(submitted == 0);
+    (void)submitted;
+    std::cout << "  [OK] Invalid batches handled gracefully\n";
+
+    std::cout << "[PASS] Batch logging tests passed\n\n";
+}
+
 void test_exception_logging()
 {
     std::cout << "[TEST] Testing exception logging...\n";
@@ -225,6 +321,55 @@ void test_exception_logging()
     std::cout << "  [OK] Exception logging works correctly\n";
 
     terminate();
+
+    // Test 2: the reusable buffer keeps the layout, missing parts are left out
+    std::string buffer = "stale content";
+    mlogger::formatExceptionMessage("System.Exception", "boom", "at A()", buffer);
+    assert(buffer == "[EXCEPTION] System.Exception: boom\nat A()");
+    mlogger::formatExceptionMessage(nullptr, "boom", nullptr, buffer);
+    assert(buffer == "[EXCEPTION] boom");
+    assert(mlogger::formatExceptionMessage("E", nullptr, "trace") == "[EXCEPTION] E: \ntrace");
+    std::cout << "  [OK] Exception layout preserved\n";
+
+    // Test 3: multi-kilobyte traces from many threads arrive intact
+    const char* storm_path = "test_logs/test_exception_storm.log";
+    std::filesystem::remove(storm_path);
+    init(storm_path, 64 * 1024 * 1024, 3, 1, 2, LOG_ERROR);
+    std::string storm_trace;
+    for (int i = 0; storm_trace.size() < 8 * 1024; ++i) {
+        storm_trace += "  at Game.Systems.Frame" + std::to_string(i) + " () [0x00010]\n";
+    }
+    storm_trace += "  at End()";
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([t, &storm_trace]() {
+            for (int i = 0; i < 250; ++i) {
+                std::string storm_message = "storm " + std::to_string(t) + "/" + std::to_string(i);
+                logException("NullReferenceException", storm_message.c_str(), storm_trace.c_str());
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    terminate();
+
+    std::string storm = readFileContent(storm_path);
+    auto count = [&storm](const std::string& text) {
+        size_t found = 0;
+        for (size_t at = storm.find(text); at != std::string::npos; at = storm.find(text, at + 1)) {
+            ++found;
+        }
+        return found;
+    };
+    size_t records = count("[EXCEPTION] ");
+    size_t traces  = count(storm_trace);
+    assert(records == 1000);
+    assert(traces == 1000);
+    (void)traces;
+    std::cout << "  [OK] " << records << " exceptions with 8KB traces logged intact\n";
+
     std::cout << "[PASS] Exception logging tests passed\n\n";
 }
 
@@ -299,6 +444,238 @@ void test_async_mode()
     std::cout << "[PASS] Async mode tests passed\n\n";
 }
 
+void test_overflow_policy()
+{
+    std::cout << "[TEST] Testing overflow policies...\n";
+
+    const int  num_logs   = 20000;
+    const char marker[]   = "Overflow message ";
+    auto       run_policy = [&](const char* log_path, int policy) {
+        std::filesystem::remove(log_path);
+
+        MLoggerOptions options{};
+        options.struct_size      = sizeof(MLoggerOptions);
+        options.log_path         = log_path;
+        options.max_file_size    = 50 * 1024 * 1024;
+        options.max_files        = 3;
+        options.async_mode       = ASYNC_MODE_THREAD_POOL;
+        options.thread_pool_size = 1;
+        options.min_log_level    = LOG_INFO;
+        options.queue_size       = 8;
+        options.overflow_policy  = policy;
+        int result               = initWithOptions(&options);
+        assert(result == 1);
+        (void)result;
+
+        for (int i = 0; i < num_logs; ++i) {
+            char buffer[128];
+            snprintf(buffer, sizeof(buffer), "%s%d", marker, i);
+            logMessage(LOG_INFO, buffer);
+        }
+        uint64_t dropped = getDroppedCount();
+        terminate();
+
+        // every record is either written or counted as dropped
+        std::string content = readFileContent(log_path);
+        size_t      written = 0;
+        for (size_t pos = content.find(marker); pos != std::string::npos;
+             pos        = content.find(marker, pos + 1)) {
+            ++written;
+        }
+        assert(written + dropped == static_cast<size_t>(num_logs));
+        return std::make_pair(dropped, content);
+    };
+
+    // Test 1: block never loses records
+    auto blocked = run_policy("test_logs/test_overflow_block.log", OVERFLOW_BLOCK);
+    assert(blocked.first == 0);
+    std::cout << "  [OK] Block policy keeps every record\n";
+
+    // Test 2: overrun_oldest accounts for every overwritten record
+    run_policy("test_logs/test_overflow_overrun.log", OVERFLOW_OVERRUN_OLDEST);
+    std::cout << "  [OK] Overrun policy counts overwritten records\n";
+
+    // Test 3: drop_newest reports each drop once in a summary line
+    auto dropped = run_policy("test_logs/test_overflow_drop.log", OVERFLOW_DROP_NEWEST);
+    uint64_t reported = 0;
+    for (size_t pos = dropped.second.find(" messages dropped"); pos != std::string::npos;
+         pos        = dropped.second.find(" messages dropped", pos + 1)) {
+        size_t start = dropped.second.rfind(' ', pos - 1) + 1;
+        reported += std::stoull(dropped.second.substr(start, pos - start));
+    }
+    assert(reported == dropped.first);
+    std::cout << "  [OK] Drop policy counts and reports " << dropped.first << " dropped records\n";
+
+    // Test 4: invalid options are rejected
+    MLoggerOptions invalid{};
+    invalid.struct_size = 8;
+    invalid.log_path    = "test_logs/test_overflow_invalid.log";
+    int result          = initWithOptions(&invalid);
+    assert(result == 0);
+    result = initWithOptions(nullptr);
+    assert(result == 0);
+    assert(getDroppedCount() == 0);
+    (void)result;
+    std::cout << "  [OK] Invalid options rejected\n";
+
+    std::cout << "[PASS] Overflow policy tests passed\n\n";
+}
+
+// takes a while per record without holding a lock flush() waits for, like a worker busy with
+// another sink of the record
+class SlowSink final : public spdlog::sinks::sink
+{
+public:
+    std::atomic<bool> written{false};
+
+    void log(const spdlog::details::log_msg&) override
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        written = true;
+    }
+    void flush() override {}
+    void set_pattern(const std::string&) override {}
+    void set_formatter(std::unique_ptr<spdlog::formatter>) override {}
+};
+
+void test_flush_policy()
+{
+    std::cout << "[TEST] Testing flush policy...\n";
+
+    auto init_flush = [](const char* log_path, int flush_interval_ms, int flush_bytes) {
+        std::filesystem::remove(log_path);
+
+        MLoggerOptions options{};
+        options.struct_size       = sizeof(MLoggerOptions);
+        options.log_path          = log_path;
+        options.max_file_size     = 10 * 1024 * 1024;
+        options.max_files         = 3;
+        options.async_mode        = ASYNC_MODE_OFF;
+        options.thread_pool_size  = 1;
+        options.min_log_level     = LOG_INFO;
+        options.flush_interval_ms = flush_interval_ms;
+        options.flush_bytes       = flush_bytes;
+        int result                = initWithOptions(&options);
+        assert(result == 1);
+        (void)result;
+    };
+
+    // Test 1: errors are buffered, a critical record flushes everything before it
+    const char* log_path = "test_logs/test_flush_policy.log";
+    init_flush(log_path, -1, 0);
+    for (int i = 0; i < 10; ++i) logMessage(LOG_ERROR, "buffered error");
+    assert(getFileSize(log_path) == 0);
+    logMessage(LOG_CRITICAL, "critical flushes");
+    std::string content = readFileContent(log_path);
+    assert(content.find("buffered error") != std::string::npos);
+    assert(content.find("critical flushes") != std::string::npos);
+    terminate();
+    std::cout << "  [OK] Errors buffered, critical records flush\n";
+
+    // Test 2: pending bytes are written in one go once the buffer is full
+    init_flush(log_path, -1, 16 * 1024);
+    std::string message(100, 'b');
+    size_t      written  = 0;
+    auto        deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (getFileSize(log_path) == 0 && written < 1000 &&
+           std::chrono::steady_clock::now() < deadline) {
+        logMessage(LOG_INFO, message.c_str());
+        ++written;
+    }
+    assert(getFileSize(log_path) >= 16 * 1024);
+    terminate();
+    std::cout << "  [OK] Size trigger wrote " << getFileSize(log_path) << " bytes after "
+              << written << " records\n";
+
+    // Test 3: the periodic flush bounds how long a record stays in memory
+    init_flush(log_path, 50, 0);
+    logMessage(LOG_INFO, "picked up by the timer");
+    deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (readFileContent(log_path).find("picked up by the timer") == std::string::npos &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    assert(readFileContent(log_path).find("picked up by the timer") != std::string::npos);
+    terminate();
+    std::cout << "  [OK] Periodic flush wrote the record\n";
+
+    // Test 4: terminate writes whatever is still pending
+    init_flush(log_path, -1, 0);
+    logMessage(LOG_INFO, "written on terminate");
+    terminate();
+    assert(readFileContent(log_path).find("written on terminate") != std::string::npos);
+    std::cout << "  [OK] Terminate flushes pending records\n";
+
+    // Test 5: in thread pool mode flush() waits for its own request, a critical record flushed
+    // by the pool ahead of it does not end the wait
+    auto init_pool = [](const char* path, int overflow_policy, int thread_pool_size) {
+        std::filesystem::remove(path);
+
+        MLoggerOptions options{};
+        options.struct_size       = sizeof(MLoggerOptions);
+        options.log_path          = path;
+        options.max_file_size     = 10 * 1024 * 1024;
+        options.max_files         = 3;
+        options.async_mode        = ASYNC_MODE_THREAD_POOL;
+        options.thread_pool_size  = thread_pool_size;
+        options.min_log_level     = LOG_INFO;
+        options.overflow_policy   = overflow_policy;
+        options.flush_interval_ms = -1;
+        int result                = initWithOptions(&options);
+        assert(result == 1);
+        (void)result;
+    };
+    init_pool(log_path, OVERFLOW_BLOCK, 1);
+    logMessage(LOG_CRITICAL, "flushed by the pool");
+    for (int i = 0; i < 2000; ++i) logMessage(LOG_INFO, "queued after the critical record");
+    logMessage(LOG_INFO, "last before flush");
+    flush();
+    assert(readFileContent(log_path).find("last before flush") != std::string::npos);
+    terminate();
+    std::cout << "  [OK] Thread pool flush waits for its own request\n";
+
+    // Test 6: under overrun_oldest the flush request may be evicted, flush() does not wait
+    init_pool(log_path, OVERFLOW_OVERRUN_OLDEST, 1);
+    logMessage(LOG_INFO, "overrun flush");
+    auto started = std::chrono::steady_clock::now();
+    flush();
+    auto elapsed = std::chrono::steady_clock::now() - started;
+    assert(elapsed < std::chrono::seconds(1));
+    (void)elapsed;
+    terminate();
+    assert(readFileContent(log_path).find("overrun flush") != std::string::npos);
+    std::cout << "  [OK] Overrun flush returns without waiting\n";
+
+    // Test 7: with several workers, flush() also waits for the records other workers still write
+    init_pool(log_path, OVERFLOW_BLOCK, 2);
+    for (int round = 0; round < 20; ++round) {
+        for (int i = 0; i < 500; ++i) logMessage(LOG_INFO, "queued to two workers");
+        std::string last = "last of round " + std::to_string(round);
+        logMessage(LOG_INFO, last.c_str());
+        flush();
+        assert(readFileContent(log_path).find(last) != std::string::npos);
+    }
+    terminate();
+    std::cout << "  [OK] Two worker flush waits for every worker\n";
+
+    // Test 8: the barrier is not served while another worker is still writing an earlier record
+    {
+        auto pool   = std::make_shared<spdlog::details::thread_pool>(64, 2);
+        auto sink   = std::make_shared<SlowSink>();
+        auto logger = std::make_shared<spdlog::async_logger>(
+            "slow", sink, pool, spdlog::async_overflow_policy::block);
+        mlogger::FlushBarrier barrier({sink}, pool, 2);
+        logger->info("slow record");
+        bool served = barrier.flush(std::chrono::seconds(5));
+        assert(served);
+        (void)served;
+        assert(sink->written.load());
+    }
+    std::cout << "  [OK] Flush barrier waits for a record in progress\n";
+
+    std::cout << "[PASS] Flush policy tests passed\n\n";
+}
+
 void test_concurrent_logging()
 {
     std::cout << "[TEST] Testing concurrent logging...\n";
@@ -436,6 +813,7 @@ void test_error_callback()
         invalid_config.log_path = "";
         bool result             = manager.initialize(invalid_config);
         assert(result == false);
+        (void)result;
         std::this_thread::sleep_for(std::chrono::milliseconds(10));
     }
 
@@ -504,9 +882,13 @@ int main()
         test_log_levels();
         test_log_level_filtering();
         test_set_get_log_level();
+        test_log_level_ptr();
+        test_log_batch();
         test_exception_logging();
         test_file_rotation();
         test_async_mode();
+        test_overflow_policy();
+        test_flush_policy();
         test_concurrent_logging();
         test_reinitialization();
         test_error_callback();
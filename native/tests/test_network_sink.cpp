@@ -0,0 +1,418 @@
+#include "../src/bridge/bridge.h"
+#include "../src/core/logger_stats.h"
+#include "../src/sinks/log_compressor.h"
+#include "../src/sinks/network_sink.h"
+#include "../src/utils/socket_utils.h"
+#include "test_options.h"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <spdlog/logger.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mlogger;
+
+using Clock = std::chrono::steady_clock;
+
+std::vector<std::string> splitLines(const std::string& text)
+{
+    std::vector<std::string> lines;
+    size_t                   start = 0;
+    for (size_t end; (end = text.find('\n', start)) != std::string::npos; start = end + 1) {
+        lines.push_back(text.substr(start, end - start));
+    }
+    assert(start == text.size() && "only whole lines");
+    return lines;
+}
+
+// a local collector, frames are decoded as they come in
+class Receiver
+{
+public:
+    explicit Receiver(SocketType type, int port = 0)
+        : type_(type)
+    {
+        std::string error;
+        listener_ = listenSocket("127.0.0.1:" + std::to_string(port), type, error);
+        assert(listener_ != kInvalidSocket && "receiver listening");
+        port_ = localPort(listener_);
+    }
+    ~Receiver()
+    {
+        closeSocket(stream_);
+        closeSocket(listener_);
+    }
+
+    std::string address() const { return "127.0.0.1:" + std::to_string(port_); }
+    int         port() const { return port_; }
+
+    // receives until `records` records arrived or `timeout` passed
+    bool receive(size_t records, std::chrono::milliseconds timeout = std::chrono::seconds(10))
+    {
+        auto deadline = Clock::now() + timeout;
+        while (received_records_ < records && Clock::now() < deadline) {
+            if (!poll()) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return received_records_ >= records;
+    }
+
+    std::vector<NetworkFrame> frames;
+    std::string               raw;   // bytes of every frame as received
+
+private:
+    bool poll()
+    {
+        char buffer[64 * 1024];
+        if (type_ == SocketType::udp) {
+            long got = receiveSocket(listener_, buffer, sizeof(buffer));
+            if (got <= 0) return false;
+            raw.append(buffer, static_cast<size_t>(got));
+            NetworkFrame frame;
+            long used = NetworkSink::decodeFrame(buffer, static_cast<size_t>(got), frame);
+            assert(used == got && "one frame per datagram");
+            (void)used;
+            add(frame);
+            return true;
+        }
+
+        if (stream_ == kInvalidSocket) {
+            stream_ = acceptSocket(listener_);
+            if (stream_ == kInvalidSocket) return false;
+        }
+        long got = receiveSocket(stream_, buffer, sizeof(buffer));
+        if (got == 0 || got == -1) {
+            // the sink reconnects on a new stream
+            closeSocket(stream_);
+            stream_ = kInvalidSocket;
+            pending_.clear();
+            return false;
+        }
+        if (got < 0) return false;
+        raw.append(buffer, static_cast<size_t>(got));
+        pending_.append(buffer, static_cast<size_t>(got));
+
+        NetworkFrame frame;
+        long         used;
+        while ((used = NetworkSink::decodeFrame(pending_.data(), pending_.size(), frame)) > 0) {
+            add(frame);
+            pending_.erase(0, static_cast<size_t>(used));
+        }
+        assert(used == 0 && "valid stream");
+        return true;
+    }
+
+    void add(const NetworkFrame& frame)
+    {
+        received_records_ += frame.records;
+        frames.push_back(frame);
+    }
+
+    SocketType   type_;
+    SocketHandle listener_ = kInvalidSocket;
+    SocketHandle stream_   = kInvalidSocket;
+    int          port_     = 0;
+    std::string  pending_;
+    size_t       received_records_ = 0;
+};
+
+std::string framesText(const std::vector<NetworkFrame>& frames)
+{
+    std::string text;
+    for (const NetworkFrame& frame : frames) {
+        text += frame.text;
+    }
+    return text;
+}
+
+// NOTE: a record counts as shipped once send() returned, a moment after the receiver has it
+template <typename Done>
+bool waitFor(Done done)
+{
+    auto deadline = Clock::now() + std::chrono::seconds(5);
+    while (!done() && Clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return done();
+}
+
+// a port nothing listens on, for a while at least
+int freePort()
+{
+    std::string  error;
+    SocketHandle probe = listenSocket("127.0.0.1:0", SocketType::tcp, error);
+    int          port  = localPort(probe);
+    closeSocket(probe);
+    return port;
+}
+
+void test_frame_encoding()
+{
+    std::cout << "[TEST] Testing the frame format...\n";
+
+    NetworkFrame frame;
+    std::string  error;
+    long         used = NetworkSink::decodeFrame("MLG", 3, frame);
+    assert(used == 0 && "short header incomplete");
+    char garbage[NetworkSink::kHeaderSize] = "not a frame at all";
+    used = NetworkSink::decodeFrame(garbage, sizeof(garbage), frame, &error);
+    assert(used == -1);
+    assert(!error.empty());
+    (void)used;
+    std::cout << "  [OK] Incomplete and invalid frames told apart (" << error << ")\n";
+
+    Receiver receiver(SocketType::udp);
+    LogStats stats;
+    {
+        auto sink = std::make_shared<NetworkSink>(receiver.address(), NetworkProtocol::udp, 0, 0,
+                                                  Compression::none);
+        sink->set_pattern("%v");
+        sink->setStats(&stats);
+        spdlog::logger logger("net", sink);
+        for (int i = 0; i < 200; ++i) {
+            logger.info("udp record {}", i);
+        }
+        logger.flush();
+        bool received = receiver.receive(200);
+        assert(received && "every record received");
+        (void)received;
+    }
+
+    std::vector<std::string> lines = splitLines(framesText(receiver.frames));
+    assert(lines.size() == 200 && lines.front() == "udp record 0");
+    assert(lines.back() == "udp record 199");
+    for (size_t i = 0; i < receiver.frames.size(); ++i) {
+        assert(receiver.frames[i].sequence == i && "sequence counts up");
+        assert(receiver.frames[i].session == receiver.frames[0].session && "one session");
+        assert(receiver.frames[i].text.size() <= NetworkSink::kUdpFrameSize && "frames fit");
+    }
+    assert(receiver.frames.size() > 1 && "records split across datagrams");
+
+    LoggerStats counters{};
+    stats.snapshot(counters);
+    assert(counters.shipped == 200 && counters.unshipped == 0);
+    std::cout << "  [OK] 200 records in " << receiver.frames.size() << " datagrams\n";
+
+    std::cout << "[PASS] Frame format tests passed\n\n";
+}
+
+void test_tcp_stream(Compression compression, const char* name)
+{
+    std::cout << "[TEST] Testing the TCP stream with " << name << "...\n";
+
+    Receiver receiver(SocketType::tcp);
+    {
+        auto sink = std::make_shared<NetworkSink>(receiver.address(), NetworkProtocol::tcp, 8192,
+                                                  1024 * 1024, compression);
+        sink->set_pattern("[%l] %v");
+        spdlog::logger logger("net", sink);
+        for (int i = 0; i < 5000; ++i) {
+            logger.warn("tcp record {} with some repeated text to compress", i);
+        }
+        // an oversized record keeps its start and ends the line
+        logger.info(std::string(10000, 'x'));
+        logger.flush();
+        bool received = receiver.receive(5001);
+        assert(received && "every record received");
+        (void)received;
+    }
+
+    std::vector<std::string> lines = splitLines(framesText(receiver.frames));
+    assert(lines.size() == 5001);
+    assert(lines[4999] == "[warning] tcp record 4999 with some repeated text to compress");
+    assert(lines.back().size() == 8191 && "oversized record cut to a frame");
+    for (size_t i = 0; i < receiver.frames.size(); ++i) {
+        assert(receiver.frames[i].sequence == i);
+    }
+
+    // the codec byte of the first header
+    assert(static_cast<Compression>(receiver.raw[5]) == compression &&
+           "frames compressed as asked");
+    std::cout << "  [OK] " << lines.size() << " records in " << receiver.frames.size()
+              << " frames, " << receiver.raw.size() << " bytes on the wire\n";
+
+    std::cout << "[PASS] " << name << " TCP stream tests passed\n\n";
+}
+
+void test_collector_down()
+{
+    std::cout << "[TEST] Testing a collector that is down...\n";
+
+    int              port = freePort();
+    LogStats         stats;
+    std::atomic<int> reports{0};
+    auto             sink = std::make_shared<NetworkSink>(
+        "127.0.0.1:" + std::to_string(port), NetworkProtocol::tcp, 4096, 0, Compression::none,
+        [&reports](const char*) { ++reports; });
+    sink->set_pattern("%v");
+    sink->setStats(&stats);
+    spdlog::logger logger("net", sink);
+
+    // NOTE: kMinFrames of 4KB take far fewer records than these, the rest are not shipped
+    auto start = Clock::now();
+    for (int i = 0; i < 2000; ++i) {
+        logger.info("while down {}", i);
+    }
+    logger.flush();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start);
+    assert(elapsed < std::chrono::seconds(1) && "producers never wait for the network");
+
+    LoggerStats counters{};
+    stats.snapshot(counters);
+    assert(counters.unshipped > 0 && counters.shipped == 0);
+    uint64_t unshipped = counters.unshipped;
+    std::cout << "  [OK] " << unshipped << " records not shipped in " << elapsed.count()
+              << " ms\n";
+
+    // the collector comes up after a failed attempt, the queued frames go out and the next
+    // frame tells what is missing
+    bool reported = waitFor([&]() { return reports > 0; });
+    assert(reported && "the outage reported");
+    Receiver receiver(SocketType::tcp, port);
+    bool     received = receiver.receive(2000 - unshipped);
+    assert(received && "queued frames sent once connected");
+    assert(reports == 1 && "reported once per outage");
+    std::cout << "  [OK] Reconnected\n";
+
+    logger.info("back up");
+    logger.flush();
+    received = receiver.receive(2000 - unshipped + 1);
+    assert(received);
+    std::vector<std::string> lines = splitLines(receiver.frames.back().text);
+    assert(lines.size() == 2);
+    assert(lines[0] == std::to_string(unshipped) + " records not shipped, see the log file");
+    assert(lines[1] == "back up");
+    std::cout << "  [OK] Notice: " << lines[0] << "\n";
+
+    bool shipped = waitFor([&]() {
+        stats.snapshot(counters);
+        return counters.shipped == 2000 - unshipped + 1;
+    });
+    assert(shipped);
+    assert(counters.unshipped == unshipped && "only the records lost while down");
+    (void)reported;
+    (void)received;
+    (void)shipped;
+
+    std::cout << "[PASS] Collector down tests passed\n\n";
+}
+
+void test_udp_refused()
+{
+    std::cout << "[TEST] Testing UDP without a collector...\n";
+
+    LogStats stats;
+    {
+        auto sink = std::make_shared<NetworkSink>("127.0.0.1:" + std::to_string(freePort()),
+                                                  NetworkProtocol::udp, 0, 0, Compression::none);
+        sink->set_pattern("%v");
+        sink->setStats(&stats);
+        spdlog::logger logger("net", sink);
+        for (int i = 0; i < 3; ++i) {
+            logger.info("nobody listens {}", i);
+            logger.flush();
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+    }
+
+    // NOTE: a datagram leaves, the refusal it gets back fails the send after it
+    LoggerStats counters{};
+    stats.snapshot(counters);
+    assert(counters.shipped + counters.unshipped == 3 && "every record accounted for");
+    std::cout << "  [OK] " << counters.shipped << " sent, " << counters.unshipped
+              << " refused\n";
+
+    std::cout << "[PASS] UDP without a collector tests passed\n\n";
+}
+
+std::vector<std::string> readFileLines(const std::string& path)
+{
+    std::ifstream input(path, std::ios::binary);
+    return splitLines(std::string(std::istreambuf_iterator<char>(input), {}));
+}
+
+void test_shipping(int async_mode, const char* name)
+{
+    std::cout << "[TEST] Testing log shipping with " << name << "...\n";
+
+    std::string log_path = std::string("test_logs/test_network_") + name + ".log";
+    std::filesystem::remove(log_path);
+
+    Receiver    receiver(SocketType::udp);
+    std::string address = receiver.address();
+
+    MLoggerOptions options   = defaultOptions(log_path.c_str(), async_mode);
+    options.min_log_level    = LOG_INFO;
+    options.network_address  = address.c_str();
+    options.network_protocol = LOG_NETWORK_UDP;
+    int result               = initWithOptions(&options);
+    assert(result == 1);
+
+    for (int i = 0; i < 500; ++i) {
+        logMessage(LOG_INFO, ("shipped message " + std::to_string(i)).c_str());
+    }
+    logMessage(LOG_DEBUG, "filtered out");
+    flush();
+    bool received = receiver.receive(500);
+    assert(received && "every record shipped");
+
+    std::vector<std::string> lines = splitLines(framesText(receiver.frames));
+    assert(lines.size() == 500 && lines.back().find("shipped message 499") != std::string::npos);
+    assert(lines == readFileLines(log_path) && "shipped lines match the file");
+
+    MLoggerStats stats{};
+    stats.struct_size = sizeof(MLoggerStats);
+    bool shipped = waitFor([&]() { return getStats(&stats) == 1 && stats.shipped == 500; });
+    assert(shipped);
+    assert(stats.unshipped == 0);
+    (void)result;
+    (void)received;
+    (void)shipped;
+    std::cout << "  [OK] " << lines.size() << " lines, identical to the file\n";
+
+    terminate();
+    std::cout << "[PASS] " << name << " log shipping tests passed\n\n";
+}
+
+int main()
+{
+    std::cout << "========================================\n";
+    std::cout << "MLogger Network Sink Test Suite\n";
+    std::cout << "========================================\n\n";
+
+    std::filesystem::create_directories("test_logs");
+
+    try {
+        test_frame_encoding();
+        test_tcp_stream(Compression::none, "no compression");
+        if (LogCompressor::isAvailable(Compression::gzip)) {
+            test_tcp_stream(Compression::gzip, "gzip");
+        }
+        if (LogCompressor::isAvailable(Compression::zstd)) {
+            test_tcp_stream(Compression::zstd, "zstd");
+        }
+        test_collector_down();
+        test_udp_refused();
+        test_shipping(ASYNC_MODE_OFF, "sync");
+        test_shipping(ASYNC_MODE_THREAD_POOL, "thread_pool");
+        test_shipping(ASYNC_MODE_STAGING, "staging");
+
+        std::cout << "========================================\n";
+        std::cout << "All network sink tests passed! [OK]\n";
+        std::cout << "========================================\n";
+
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "\n[FAIL] Test failed with exception: " << e.what() << "\n";
+        terminate();
+        return 1;
+    } catch (...) {
+        std::cerr << "\n[FAIL] Test failed with unknown exception\n";
+        terminate();
+        return 1;
+    }
+}
@@ -0,0 +1,21 @@
+#ifndef TEST_OPTIONS_H
+#define TEST_OPTIONS_H
+
+#include "../src/bridge/bridge.h"
+
+// Options the tests start from: up to 3 files of 50MB at `log_path`, one writer thread and every
+// level logged. Tests set only the fields they exercise on top.
+inline MLoggerOptions defaultOptions(const char* log_path, int async_mode)
+{
+    MLoggerOptions options{};
+    options.struct_size      = sizeof(MLoggerOptions);
+    options.log_path         = log_path;
+    options.max_file_size    = 50 * 1024 * 1024;
+    options.max_files        = 3;
+    options.async_mode       = async_mode;
+    options.thread_pool_size = 1;
+    options.min_log_level    = LOG_TRACE;
+    return options;
+}
+
+#endif   // TEST_OPTIONS_H
@@ -0,0 +1,355 @@
+#include "../src/bridge/bridge.h"
+#include "../src/sinks/rotating_file_sink.h"
+#include "test_options.h"
+#include <atomic>
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mlogger;
+
+void removeLogs(const char* log_path)
+{
+    for (size_t i = 0; i <= 3; ++i) {
+        std::filesystem::remove(RotatingFileSink::calcFilename(log_path, i));
+    }
+}
+
+std::string readFile(const char* path)
+{
+    std::ifstream input(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+}
+
+size_t countOf(const std::string& text, const std::string& part)
+{
+    size_t count = 0;
+    for (size_t at = text.find(part); at != std::string::npos; at = text.find(part, at + 1)) {
+        ++count;
+    }
+    return count;
+}
+
+// "rec <thread>:<index>" records, in the order the files were written
+void checkRecords(const std::vector<std::string>& contents, int threads, int count)
+{
+    std::vector<int> next(threads, 0);
+    for (const std::string& content : contents) {
+        for (size_t at = content.find("rec "); at != std::string::npos;
+             at        = content.find("rec ", at + 1)) {
+            size_t colon  = content.find(':', at);
+            int    thread = std::stoi(content.substr(at + 4, colon - at - 4));
+            int    index  = std::stoi(content.substr(colon + 1));
+            assert(thread >= 0 && thread < threads);
+            assert(index == next[thread] && "every record once, in order");
+            (void)index;
+            ++next[thread];
+        }
+    }
+    for (int t = 0; t < threads; ++t) {
+        assert(next[t] == count && "no record lost");
+    }
+    (void)count;
+}
+
+void test_switch_while_logging()
+{
+    std::cout << "[TEST] Testing reconfigure while threads log...\n";
+
+    const char* paths[] = {"test_logs/test_reconfigure_a.log", "test_logs/test_reconfigure_b.log",
+                           "test_logs/test_reconfigure_c.log"};
+    int         modes[] = {ASYNC_MODE_THREAD_POOL, ASYNC_MODE_OFF, ASYNC_MODE_STAGING};
+    for (const char* path : paths) {
+        removeLogs(path);
+    }
+
+    MLoggerOptions options = defaultOptions(paths[0], modes[0]);
+    int            result  = initWithOptions(&options);
+    assert(result == 1);
+
+    const int                threads = 4;
+    const int                count   = 20000;
+    std::atomic<int>         started{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([t, &started]() {
+            started.fetch_add(1);
+            for (int i = 0; i < count; ++i) {
+                std::string message = "rec " + std::to_string(t) + ":" + std::to_string(i);
+                logMessage(LOG_INFO, message.c_str());
+            }
+        });
+    }
+    while (started.load() < threads) {
+        std::this_thread::yield();
+    }
+
+    for (int i = 1; i < 3; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        options = defaultOptions(paths[i], modes[i]);
+        result = reconfigure(&options);
+        assert(result == 1);
+        assert(isInit() == 1);
+    }
+    (void)result;
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    terminate();
+
+    checkRecords({readFile(paths[0]), readFile(paths[1]), readFile(paths[2])}, threads, count);
+    std::cout << "  [OK] Switched file and async mode without losing a record\n";
+
+    std::cout << "[PASS] Concurrent reconfigure tests passed\n\n";
+}
+
+void test_same_file()
+{
+    std::cout << "[TEST] Testing reconfigure of the same file...\n";
+
+    const char* log_path = "test_logs/test_reconfigure_same.log";
+    removeLogs(log_path);
+
+    MLoggerOptions options = defaultOptions(log_path, ASYNC_MODE_THREAD_POOL);
+    int            result  = initWithOptions(&options);
+    assert(result == 1);
+    logMessage(LOG_INFO, "before the change");
+
+    // level and rotation limit only, the file sink carries over
+    options.min_log_level = LOG_WARN;
+    options.max_file_size = 2048;
+    result = reconfigure(&options);
+    assert(result == 1);
+    assert(getLogLevel() == LOG_WARN);
+    logMessage(LOG_INFO, "filtered by the new level");
+    logMessage(LOG_WARN, "after the change");
+
+    MLoggerStats stats{};
+    stats.struct_size = sizeof(MLoggerStats);
+    result = getStats(&stats);
+    assert(result == 1);
+    assert(stats.messages[LOG_INFO] == 1 && stats.messages[LOG_WARN] == 1 && "stats kept");
+
+    // the new limit rotates the file
+    std::string filler(100, 'f');
+    for (int i = 0; i < 100; ++i) {
+        logMessage(LOG_ERROR, filler.c_str());
+    }
+    flush();
+    assert(std::filesystem::exists(RotatingFileSink::calcFilename(log_path, 1)));
+
+    // a different writer setting reopens the file once the old backend has written it
+    terminate();
+    removeLogs(log_path);
+    options = defaultOptions(log_path, ASYNC_MODE_THREAD_POOL);
+    result = initWithOptions(&options);
+    assert(result == 1);
+    logMessage(LOG_INFO, "first settings");
+    options.flush_bytes = -1;
+    options.async_mode  = ASYNC_MODE_OFF;
+    result = reconfigure(&options);
+    assert(result == 1);
+    (void)result;
+    logMessage(LOG_INFO, "second settings");
+    terminate();
+
+    std::string content = readFile(log_path);
+    size_t      first   = content.find("first settings");
+    assert(first != std::string::npos && countOf(content, "first settings") == 1);
+    assert(content.find("second settings") > first && countOf(content, "second settings") == 1);
+    (void)first;
+    std::cout << "  [OK] Kept open for new limits, reopened for new settings\n";
+
+    std::cout << "[PASS] Same file tests passed\n\n";
+}
+
+void test_flush_waits()
+{
+    std::cout << "[TEST] Testing flush after reconfigure...\n";
+
+    const char* old_path = "test_logs/test_reconfigure_old.log";
+    const char* new_path = "test_logs/test_reconfigure_new.log";
+    removeLogs(old_path);
+    removeLogs(new_path);
+
+    MLoggerOptions options = defaultOptions(old_path, ASYNC_MODE_THREAD_POOL);
+    int            result  = initWithOptions(&options);
+    assert(result == 1);
+    const int count = 5000;
+    for (int i = 0; i < count; ++i) {
+        logMessage(LOG_INFO, ("rec 0:" + std::to_string(i)).c_str());
+    }
+
+    options = defaultOptions(new_path, ASYNC_MODE_THREAD_POOL);
+    result = reconfigure(&options);
+    assert(result == 1);
+    (void)result;
+    logMessage(LOG_INFO, "in the new file");
+    flush();
+
+    // both written before terminate()
+    checkRecords({readFile(old_path)}, 1, count);
+    assert(countOf(readFile(new_path), "in the new file") == 1);
+    terminate();
+    std::cout << "  [OK] flush() covers the retired backend\n";
+
+    std::cout << "[PASS] Flush tests passed\n\n";
+}
+
+void test_channels_and_tail()
+{
+    std::cout << "[TEST] Testing channels and the live tail across reconfigure...\n";
+
+    const char* first_path  = "test_logs/test_reconfigure_tail_a.log";
+    const char* second_path = "test_logs/test_reconfigure_tail_b.log";
+    removeLogs(first_path);
+    removeLogs(second_path);
+
+    int net = createChannel("net");
+    assert(net > 0);
+
+    MLoggerOptions options   = defaultOptions(first_path, ASYNC_MODE_OFF);
+    options.tail_buffer_size = 64 * 1024;
+    int result               = initWithOptions(&options);
+    assert(result == 1);
+    result = setChannelLevel(net, LOG_ERROR);
+    assert(result == 1);
+    logChannel(net, LOG_ERROR, "net before");
+
+    uint64_t cursor = 0;
+    char     buffer[4096];
+    int      skipped = 0;
+    int      copied  = readSince(&cursor, buffer, sizeof(buffer), &skipped);
+    assert(copied > 0 && !skipped);
+    assert(countOf(std::string(buffer, copied), "net before") == 1);
+
+    options.log_path = second_path;
+    result = reconfigure(&options);
+    assert(result == 1);
+    (void)result;
+    logChannel(net, LOG_WARN, "below the channel level");
+    logChannel(net, LOG_ERROR, "net after");
+
+    // the tail and its cursor carry over
+    copied = readSince(&cursor, buffer, sizeof(buffer), &skipped);
+    assert(copied > 0 && !skipped);
+    std::string text(buffer, copied);
+    assert(countOf(text, "net after") == 1 && countOf(text, "net before") == 0);
+    terminate();
+
+    std::string content = readFile(second_path);
+    assert(countOf(content, "[net]") == 1 && countOf(content, "net after") == 1);
+    assert(countOf(content, "below the channel level") == 0 && "channel level kept");
+    std::cout << "  [OK] Channel levels and tail cursor kept\n";
+
+    std::cout << "[PASS] Channel and tail tests passed\n\n";
+}
+
+void test_invalid_reconfigure()
+{
+    std::cout << "[TEST] Testing a rejected reconfigure...\n";
+
+    const char* log_path = "test_logs/test_reconfigure_invalid.log";
+    removeLogs(log_path);
+
+    int result = reconfigure(nullptr);
+    assert(result == 0);
+    MLoggerOptions options = defaultOptions(log_path, ASYNC_MODE_OFF);
+    result = reconfigure(&options);
+    assert(result == 1 && isInit() == 1 && "starts the logger");
+
+    MLoggerOptions invalid = options;
+    invalid.clock_source   = 7;
+    result = reconfigure(&invalid);
+    assert(result == 0);
+    invalid          = options;
+    invalid.log_path = nullptr;
+    result = reconfigure(&invalid);
+    assert(result == 0);
+    (void)result;
+
+    assert(isInit() == 1);
+    logMessage(LOG_INFO, "still logging");
+    terminate();
+    assert(countOf(readFile(log_path), "still logging") == 1);
+    std::cout << "  [OK] The running backend is left as it was\n";
+
+    std::cout << "[PASS] Rejected reconfigure tests passed\n\n";
+}
+
+void test_terminate_async()
+{
+    std::cout << "[TEST] Testing terminateAsync...\n";
+
+    const char* log_path = "test_logs/test_reconfigure_async.log";
+    const int   count    = 20000;
+    for (int timeout_ms : {10000, 0}) {
+        removeLogs(log_path);
+        MLoggerOptions options = defaultOptions(log_path, ASYNC_MODE_THREAD_POOL);
+        int            result  = initWithOptions(&options);
+        assert(result == 1);
+        for (int i = 0; i < count; ++i) {
+            logMessage(LOG_INFO, ("rec 0:" + std::to_string(i)).c_str());
+        }
+
+        int done = terminateAsync(timeout_ms);
+        assert(isInit() == 0);
+        logMessage(LOG_INFO, "after terminateAsync");
+        if (timeout_ms > 0) {
+            assert(done == 1 && "drained within the timeout");
+        }
+        (void)done;
+
+        // the same file opened again waits for the drain
+        result = initDefault(log_path);
+        assert(result == 1);
+        (void)result;
+        terminate();
+        std::string content = readFile(log_path);
+        checkRecords({content}, 1, count);
+        assert(countOf(content, "after terminateAsync") == 0);
+    }
+    std::cout << "  [OK] Every queued record written, with and without waiting\n";
+
+    int done = terminateAsync(100);
+    assert(done == 1 && "nothing to drain");
+    (void)done;
+    std::cout << "[PASS] terminateAsync tests passed\n\n";
+}
+
+int main()
+{
+    std::cout << "========================================\n";
+    std::cout << "MLogger Reconfigure Test Suite\n";
+    std::cout << "========================================\n\n";
+
+    std::filesystem::create_directories("test_logs");
+
+    try {
+        test_switch_while_logging();
+        test_same_file();
+        test_flush_waits();
+        test_channels_and_tail();
+        test_invalid_reconfigure();
+        test_terminate_async();
+
+        std::cout << "========================================\n";
+        std::cout << "All reconfigure tests passed! [OK]\n";
+        std::cout << "========================================\n";
+
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "\n[FAIL] Test failed with exception: " << e.what() << "\n";
+        terminate();
+        return 1;
+    } catch (...) {
+        std::cerr << "\n[FAIL] Test failed with unknown exception\n";
+        terminate();
+        return 1;
+    }
+}
@@ -0,0 +1,350 @@
+#include "../src/bridge/bridge.h"
+#include "../src/sinks/ring_buffer_sink.h"
+#include "test_options.h"
+#include <cassert>
+#include <chrono>
+#include <csetjmp>
+#include <csignal>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if !defined(_WIN32) && !defined(_WIN64)
+#    include <sys/wait.h>
+#    include <unistd.h>
+#endif
+
+bool initRing(const char* log_path, int ring_size, int min_level, int async_mode,
+              int crash_handler = 0)
+{
+    MLoggerOptions options   = defaultOptions(log_path, async_mode);
+    options.max_file_size    = 1024 * 1024;
+    options.max_files        = 5;
+    options.min_log_level    = min_level;
+    options.ring_buffer_size = ring_size;
+    options.crash_handler    = crash_handler;
+    return initWithOptions(&options) == 1;
+}
+
+std::vector<std::string> readLines(const std::string& path)
+{
+    std::ifstream            input(path);
+    std::vector<std::string> lines;
+    std::string              line;
+    while (std::getline(input, line)) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+bool contains(const std::vector<std::string>& lines, const std::string& text)
+{
+    for (const auto& line : lines) {
+        if (line.find(text) != std::string::npos) return true;
+    }
+    return false;
+}
+
+void test_ring_captures_all_levels()
+{
+    std::cout << "[TEST] Testing ring buffer level capture...\n";
+
+    const char* log_path  = "test_logs/test_ring.log";
+    const char* dump_path = "test_logs/test_ring_dump.log";
+    std::filesystem::remove(log_path);
+    std::filesystem::remove(dump_path);
+
+    // Test 1: without a ring there is nothing to dump
+    bool ok     = initRing(log_path, 0, LOG_WARN, ASYNC_MODE_OFF);
+    int  result = dumpRing(dump_path);
+    assert(ok && result == 0);
+    terminate();
+
+    // Test 2: levels below min_log_level reach the ring but not the file
+    ok = initRing(log_path, 64 * 1024, LOG_WARN, ASYNC_MODE_OFF);
+    assert(ok);
+    assert(getLogLevel() == LOG_WARN);
+    assert(*getLogLevelPtr() == LOG_TRACE);
+    logMessage(LOG_TRACE, "ring trace record");
+    logMessage(LOG_DEBUG, "ring debug record");
+    logMessage(LOG_WARN, "ring warn record");
+    result = dumpRing(dump_path);
+    assert(result == 1);
+    terminate();
+
+    auto file = readLines(log_path);
+    assert(file.size() == 1);
+    assert(contains(file, "ring warn record"));
+
+    auto dump = readLines(dump_path);
+    assert(dump.size() == 3);
+    assert(dump[0].find("[trace]") != std::string::npos);
+    assert(dump[0].find("ring trace record") != std::string::npos);
+    assert(dump[1].find("[debug] ") != std::string::npos);
+    assert(dump[2].find("ring warn record") != std::string::npos);
+    std::cout << "  [OK] Ring holds every level, the file only " << file.size() << " record\n";
+
+    // Test 3: setLogLevel changes the file level, the ring keeps capturing
+    ok = initRing(log_path, 64 * 1024, LOG_WARN, ASYNC_MODE_THREAD_POOL);
+    assert(ok);
+    setLogLevel(LOG_ERROR);
+    assert(getLogLevel() == LOG_ERROR);
+    assert(*getLogLevelPtr() == LOG_TRACE);
+    logMessage(LOG_INFO, "async info record");
+    logMessage(LOG_WARN, "async warn record");
+    result = dumpRing(dump_path);
+    assert(result == 1);
+    (void)ok;
+    (void)result;
+    terminate();
+
+    file = readLines(log_path);
+    assert(!contains(file, "async warn record"));
+    dump = readLines(dump_path);
+    assert(dump.size() == 2);
+    assert(contains(dump, "async info record") && contains(dump, "async warn record"));
+    std::cout << "  [OK] Level changes only apply to the file\n";
+
+    std::cout << "[PASS] Ring buffer level capture tests passed\n\n";
+}
+
+void test_ring_wraps()
+{
+    std::cout << "[TEST] Testing ring buffer wrap around...\n";
+
+    const char* dump_path = "test_logs/test_ring_wrap.log";
+    mlogger::RingBufferSink ring(4096);
+    assert(ring.capacity() == 4096);
+
+    // Test 1: the newest records survive, in order and without gaps
+    const int num_logs = 1000;
+    for (int i = 0; i < num_logs; ++i) {
+        std::string text = "wrapped record " + std::to_string(i);
+        ring.record(std::chrono::system_clock::now(), spdlog::level::info, text);
+    }
+    bool ok = ring.dump(dump_path);
+    assert(ok);
+    auto dump = readLines(dump_path);
+    assert(!dump.empty() && dump.size() < static_cast<size_t>(num_logs));
+    int expected = num_logs - static_cast<int>(dump.size());
+    for (const auto& line : dump) {
+        assert(line.find("wrapped record " + std::to_string(expected)) != std::string::npos);
+        (void)line;
+        ++expected;
+    }
+    std::cout << "  [OK] Kept the newest " << dump.size() << " records\n";
+
+    // Test 2: records longer than a quarter of the ring are cut
+    ring.record(std::chrono::system_clock::now(), spdlog::level::err, std::string(5000, 'x'));
+    ok = ring.dump(dump_path);
+    assert(ok);
+    dump = readLines(dump_path);
+    assert(dump.back().find(" [truncated]") != std::string::npos);
+    assert(dump.back().size() < 1100);
+    std::cout << "  [OK] Oversized records truncated\n";
+
+    // Test 3: timestamps are written in UTC
+    auto time = std::chrono::system_clock::time_point(std::chrono::microseconds(1709210096789012));
+    mlogger::RingBufferSink dated(4096);
+    dated.record(time, spdlog::level::warn, "dated record");
+    ok = dated.dump(dump_path);
+    assert(ok);
+    (void)ok;
+    dump = readLines(dump_path);
+    assert(dump.size() == 1);
+    assert(dump[0].rfind("[2024-02-29 12:34:56.789012] [warning] [", 0) == 0);
+    assert(dump[0].find("] dated record") != std::string::npos);
+    std::cout << "  [OK] " << dump[0] << "\n";
+
+    std::cout << "[PASS] Ring buffer wrap around tests passed\n\n";
+}
+
+void test_ring_critical_exception()
+{
+    std::cout << "[TEST] Testing dump on critical exception...\n";
+
+    const char* log_path   = "test_logs/test_ring_exception.log";
+    const char* crash_path = "test_logs/test_ring_exception.crash.log";
+    std::filesystem::remove(crash_path);
+    bool ok = initRing(log_path, 64 * 1024, LOG_ERROR, ASYNC_MODE_THREAD_POOL);
+    assert(ok);
+    (void)ok;
+
+    // Test 1: an error exception leaves the dump alone
+    logMessage(LOG_DEBUG, "context before the exception");
+    logException("InvalidOperationException", "recoverable", "at Game.Update()");
+    assert(!std::filesystem::exists(crash_path));
+    std::cout << "  [OK] Error exceptions do not dump\n";
+
+    // Test 2: a critical exception dumps the ring next to the log file
+    logExceptionWithLevel(LOG_CRITICAL, "NullReferenceException", "fatal", "at Game.Load()");
+    assert(std::filesystem::exists(crash_path));
+    auto dump = readLines(crash_path);
+    assert(contains(dump, "context before the exception"));
+    assert(contains(dump, "recoverable"));
+    assert(contains(dump, "[critical] ") && contains(dump, "NullReferenceException"));
+    terminate();
+    std::cout << "  [OK] Critical exception dumped " << dump.size() << " lines\n";
+
+    std::cout << "[PASS] Dump on critical exception tests passed\n\n";
+}
+
+#if !defined(_WIN32) && !defined(_WIN64)
+sigjmp_buf            g_recover_point;
+volatile sig_atomic_t g_recover = 1;
+volatile int          g_depth_limit = -1;
+
+// stands in for a runtime that turns faults into exceptions while g_recover is set
+void recoveringHandler(int, siginfo_t*, void*)
+{
+    if (g_recover) siglongjmp(g_recover_point, 1);
+}
+
+void fault()
+{
+    volatile int* volatile address = nullptr;
+    *address = 1;
+}
+
+int overflowStack(int depth)
+{
+    volatile char frame[4096];
+    frame[0] = static_cast<char>(depth);
+    if (depth == g_depth_limit) return frame[0];
+    return overflowStack(depth + 1) + frame[0];
+}
+
+// runs `body` in a child process and returns its wait status
+int runChild(void (*body)())
+{
+    pid_t child = fork();
+    assert(child >= 0);
+    if (child == 0) {
+        body();
+        _exit(3);
+    }
+    int   status = 0;
+    pid_t waited = waitpid(child, &status, 0);
+    assert(waited == child);
+    (void)waited;
+    return status;
+}
+
+void recoverThenCrash()
+{
+    struct sigaction action = {};
+    action.sa_sigaction     = recoveringHandler;
+    action.sa_flags         = SA_SIGINFO;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGSEGV, &action, nullptr);
+    // the crash handler goes in on top of this one and chains to it
+    if (!initRing("test_logs/test_ring_recover.log", 64 * 1024, LOG_ERROR, ASYNC_MODE_OFF, 1)) {
+        _exit(2);
+    }
+    logMessage(LOG_DEBUG, "before the recovered fault");
+    if (sigsetjmp(g_recover_point, 1) == 0) {
+        fault();
+        _exit(4);
+    }
+    if (std::filesystem::exists("test_logs/test_ring_recover.crash.log")) _exit(5);
+    g_recover = 0;
+    logMessage(LOG_DEBUG, "last words after recovering");
+    fault();
+}
+
+void test_ring_crash_handler()
+{
+    std::cout << "[TEST] Testing crash handler...\n";
+
+    const char* log_path   = "test_logs/test_ring_crash.log";
+    const char* crash_path = "test_logs/test_ring_crash.crash.log";
+    std::filesystem::remove(crash_path);
+
+    // Test 1: the ring is dumped and the signal still terminates the process
+    pid_t child = fork();
+    assert(child >= 0);
+    if (child == 0) {
+        if (!initRing(log_path, 64 * 1024, LOG_ERROR, ASYNC_MODE_THREAD_POOL, 1)) _exit(2);
+        logMessage(LOG_DEBUG, "last words before the crash");
+        std::raise(SIGSEGV);
+        _exit(3);
+    }
+    int   status = 0;
+    pid_t waited = waitpid(child, &status, 0);
+    assert(waited == child);
+    assert(WIFSIGNALED(status) && WTERMSIG(status) == SIGSEGV);
+    assert(contains(readLines(crash_path), "last words before the crash"));
+    std::cout << "  [OK] Ring dumped, process terminated by the signal\n";
+
+    // Test 2: terminate() removes the handler again
+    bool ok = initRing(log_path, 64 * 1024, LOG_ERROR, ASYNC_MODE_OFF, 1);
+    terminate();
+    struct sigaction current = {};
+    int              result  = sigaction(SIGSEGV, nullptr, &current);
+    assert(ok && result == 0);
+    assert(current.sa_handler == SIG_DFL);
+    (void)waited;
+    (void)ok;
+    (void)result;
+    std::cout << "  [OK] Handler uninstalled on terminate\n";
+
+    // Test 3: a fault the previous handler recovers from is no crash, a later real one still is
+    const char* recover_path = "test_logs/test_ring_recover.crash.log";
+    std::filesystem::remove(recover_path);
+    status = runChild(recoverThenCrash);
+    assert(WIFSIGNALED(status) && WTERMSIG(status) == SIGSEGV);
+    assert(contains(readLines(recover_path), "last words after recovering"));
+    std::cout << "  [OK] Recovered fault not dumped, the real crash after it is\n";
+
+    // Test 4: a stack overflow is dumped from the alternate stack
+    std::filesystem::remove(crash_path);
+    status = runChild([]() {
+        if (!initRing("test_logs/test_ring_crash.log", 64 * 1024, LOG_ERROR, ASYNC_MODE_OFF, 1)) {
+            _exit(2);
+        }
+        logMessage(LOG_DEBUG, "last words before the overflow");
+        overflowStack(0);
+    });
+    assert(WIFSIGNALED(status) && WTERMSIG(status) == SIGSEGV);
+    assert(contains(readLines(crash_path), "last words before the overflow"));
+    std::cout << "  [OK] Stack overflow dumped\n";
+
+    std::cout << "[PASS] Crash handler tests passed\n\n";
+}
+#endif
+
+int main()
+{
+    std::cout << "========================================\n";
+    std::cout << "MLogger Ring Buffer Test Suite\n";
+    std::cout << "========================================\n\n";
+
+    std::filesystem::create_directories("test_logs");
+
+    try {
+        test_ring_captures_all_levels();
+        test_ring_wraps();
+        test_ring_critical_exception();
+#if !defined(_WIN32) && !defined(_WIN64)
+        test_ring_crash_handler();
+#endif
+
+        std::cout << "========================================\n";
+        std::cout << "All ring buffer tests passed! [OK]\n";
+        std::cout << "========================================\n";
+
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "\n[FAIL] Test failed with exception: " << e.what() << "\n";
+        terminate();
+        return 1;
+    } catch (...) {
+        std::cerr << "\n[FAIL] Test failed with unknown exception\n";
+        terminate();
+        return 1;
+    }
+}
@@ -0,0 +1,537 @@
+#include "../src/bridge/bridge.h"
+#include "../src/core/deferred_format.h"
+#include "../src/sinks/shared_memory_sink.h"
+#include "../src/utils/shared_ring.h"
+#include "test_options.h"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <random>
+#include <spdlog/details/os.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if !defined(_WIN32) && !defined(_WIN64)
+#    include <sys/wait.h>
+#    include <unistd.h>
+#endif
+
+using namespace mlogger;
+
+using Clock = std::chrono::steady_clock;
+
+// a segment name of this run, so parallel runs do not share segments
+std::string segmentName(const char* base)
+{
+    std::string name = std::string(base) + "-" + std::to_string(spdlog::details::os::pid());
+    SharedRing::remove(name);
+    return name;
+}
+
+// a decoded record owning its bytes
+struct Received {
+    SharedRecord record;
+    std::string  logger_name, format, payload;
+
+    // the text the sinks would write
+    std::string text() const
+    {
+        spdlog::memory_buf_t dest;
+        if (record.payload_tag == kFormattedTag) {
+            formatArguments(format, payload.data(), payload.size(), dest);
+        } else {
+            appendPayloadText(record.payload_tag, payload, dest);
+        }
+        return std::string(dest.data(), dest.size());
+    }
+};
+
+size_t drainRecords(SharedRing& ring, std::vector<Received>& out)
+{
+    size_t count = 0;
+    size_t size  = 0;
+    while (const void* data = ring.front(&size)) {
+        Received received;
+        bool     decoded = SharedMemorySink::decodeRecord(data, size, received.record);
+        assert(decoded);
+        (void)decoded;
+        const SharedRecord& record = received.record;
+        received.logger_name.assign(record.logger_name.data(), record.logger_name.size());
+        received.format.assign(record.format.data(), record.format.size());
+        received.payload.assign(record.payload.data(), record.payload.size());
+        out.push_back(std::move(received));
+        ring.pop();
+        ++count;
+    }
+    return count;
+}
+
+void test_ring_blocks()
+{
+    std::cout << "[TEST] Testing the shared ring...\n";
+
+    std::string                 name = segmentName("t-ring");
+    std::string                 error;
+    std::unique_ptr<SharedRing> ring = SharedRing::open("", 0, error);
+    assert(!ring && !error.empty());
+    ring = SharedRing::open("a/b", 0, error);
+    assert(!ring);
+    ring = SharedRing::open(std::string(SharedRing::kMaxNameLength + 1, 'x'), 0, error);
+    assert(!ring);
+    std::cout << "  [OK] Invalid names rejected\n";
+
+    ring = SharedRing::open(name, 1000, error);
+    assert(ring);
+    assert(ring->capacity() == SharedRing::kMinCapacity && "rounded up to the minimum");
+    const void* data = ring->front();
+    assert(data == nullptr);
+
+    // NOTE: sizes that do not divide the capacity, so blocks keep meeting the end of the ring
+    std::mt19937                          random(11);
+    std::uniform_int_distribution<size_t> pick(0, 700);
+    std::deque<std::pair<size_t, char>>   expected;
+    uint64_t                              bytes = 0;
+    for (int i = 0; i < 20000; ++i) {
+        size_t            size = pick(random);
+        SharedRing::Block block;
+        bool              reserved = ring->tryReserve(size, block);
+        assert(reserved);
+        (void)reserved;
+        std::memset(block.data, static_cast<char>(i), size);
+        ring->commit(block);
+        expected.emplace_back(size, static_cast<char>(i));
+        bytes += size;
+
+        if (i % 7 != 0) continue;
+        size_t got = 0;
+        while ((data = ring->front(&got)) != nullptr) {
+            assert(!expected.empty() && got == expected.front().first);
+            assert(std::string(static_cast<const char*>(data), got) ==
+                   std::string(got, expected.front().second));
+            expected.pop_front();
+            ring->pop();
+        }
+        assert(expected.empty() && ring->usedBytes() == 0);
+    }
+    assert(bytes > 50 * ring->capacity() && "wrapped many times");
+    std::cout << "  [OK] 20000 blocks in order across " << bytes / ring->capacity() << " laps\n";
+
+    // full: what does not fit is refused and counted
+    SharedRing::Block block;
+    size_t            stored = 0;
+    while (ring->tryReserve(1000, block)) {
+        ring->commit(block);
+        ++stored;
+    }
+    assert(stored > 0 && ring->droppedCount() == 1);
+    assert(ring->usedBytes() <= ring->capacity());
+    bool reserved = ring->tryReserve(ring->maxBlockSize() + 1, block);
+    assert(!reserved && ring->droppedCount() == 2);
+    std::cout << "  [OK] " << stored << " blocks fill the ring, the next one is dropped\n";
+
+    // a second mapping shares the blocks and keeps the capacity it was created with
+    std::unique_ptr<SharedRing> again = SharedRing::open(name, 1 << 20, error);
+    assert(again && again->capacity() == ring->capacity());
+    assert(again->usedBytes() == ring->usedBytes() && again->droppedCount() == 2);
+    size_t size = 0;
+    while (again->front(&size)) {
+        assert(size == 1000);
+        again->pop();
+    }
+    assert(ring->usedBytes() == 0);
+    reserved = again->tryReserve(5, block);
+    assert(reserved);
+    std::memcpy(block.data, "hello", 5);
+    again->commit(block);
+    data = ring->front(&size);
+    assert(data && size == 5 && std::memcmp(data, "hello", 5) == 0);
+    ring->pop();
+    std::cout << "  [OK] Two mappings of one segment\n";
+
+    again.reset();
+    ring.reset();
+    bool removed = SharedRing::remove(name);
+    assert(removed);
+    removed = SharedRing::remove(name);
+    assert(!removed);
+    (void)reserved;
+    (void)removed;
+    std::cout << "[PASS] Shared ring tests passed\n\n";
+}
+
+void test_abandoned_block()
+{
+    std::cout << "[TEST] Testing a block its writer never published...\n";
+
+    std::string                 name = segmentName("t-stuck");
+    std::string                 error;
+    std::unique_ptr<SharedRing> ring = SharedRing::open(name, 0, error);
+    assert(ring);
+
+    SharedRing::Block stuck, later;
+    bool              reserved = ring->tryReserve(32, stuck) && ring->tryReserve(3, later);
+    assert(reserved);
+    std::memcpy(later.data, "old", 3);
+    bool committed = ring->commit(later);
+    assert(committed);
+    const void* data = ring->front();
+    assert(data == nullptr && "held up by the unpublished block");
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    data = ring->front();
+    assert(data == nullptr && ring->skippedBytes() == 0);
+
+    // Only the stuck block is skipped, the one published after it is still read
+    std::this_thread::sleep_for(SharedRing::kAbandonTimeout);
+    size_t size = 0;
+    data        = ring->front(&size);
+    assert(data && size == 3 && std::memcmp(data, "old", 3) == 0);
+    assert(ring->skippedBytes() == 48);
+    ring->pop();
+
+    // A writer waking up after the skip cannot publish any more
+    committed = ring->commit(stuck);
+    assert(!committed);
+    data = ring->front();
+    assert(data == nullptr && ring->usedBytes() == 0);
+
+    SharedRing::Block next;
+    reserved = ring->tryReserve(3, next);
+    assert(reserved);
+    std::memcpy(next.data, "new", 3);
+    committed = ring->commit(next);
+    assert(committed);
+    data = ring->front(&size);
+    assert(data && size == 3 && std::memcmp(data, "new", 3) == 0);
+    ring->pop();
+    (void)reserved;
+    (void)committed;
+    (void)data;
+    std::cout << "  [OK] Only the stuck block skipped after " << SharedRing::kAbandonTimeout.count()
+              << "s, its late commit refused\n";
+
+    ring.reset();
+    SharedRing::remove(name);
+    std::cout << "[PASS] Abandoned block tests passed\n\n";
+}
+
+void test_concurrent_writers()
+{
+    std::cout << "[TEST] Testing concurrent writers and flush waits...\n";
+
+    constexpr int               kThreads = 4;
+    constexpr int               kRecords = 20000;
+    std::string                 name     = segmentName("t-threads");
+    std::string                 error;
+    std::unique_ptr<SharedRing> ring = SharedRing::open(name, 0, error);
+    assert(ring);
+
+    // nobody reads: a writer's wait gives up at once
+    SharedRing::Block block;
+    bool              reserved = ring->tryReserve(8, block);
+    assert(reserved);
+    ring->commit(block);
+    auto start = Clock::now();
+    bool read  = ring->waitUntilRead(std::chrono::seconds(5));
+    assert(!read);
+    assert(Clock::now() - start < std::chrono::seconds(1));
+
+    // attached but not reading: it gives up once the reader made no progress for the timeout
+    ring->setReaderAttached(true);
+    start = Clock::now();
+    read  = ring->waitUntilRead(std::chrono::milliseconds(100));
+    assert(!read);
+    assert(Clock::now() - start >= std::chrono::milliseconds(100));
+    (void)reserved;
+    (void)start;
+    (void)read;
+    ring->front();
+    ring->pop();
+    std::cout << "  [OK] waitUntilRead() gives up without a working reader\n";
+
+    std::atomic<bool>     writing{true};
+    std::atomic<uint64_t> retries{0};
+    std::vector<int>      next(kThreads, 0);
+    std::thread           reader([&]() {
+        size_t size = 0;
+        for (;;) {
+            const void* data = ring->front(&size);
+            if (!data) {
+                if (!writing.load() && ring->usedBytes() == 0) break;
+                std::this_thread::yield();
+                continue;
+            }
+            int values[2];
+            assert(size == sizeof(values));
+            std::memcpy(values, data, sizeof(values));
+            assert(values[0] >= 0 && values[0] < kThreads);
+            assert(values[1] == next[values[0]] && "each writer's blocks in order");
+            ++next[values[0]];
+            ring->pop();
+        }
+    });
+
+    std::vector<std::thread> writers;
+    for (int t = 0; t < kThreads; ++t) {
+        writers.emplace_back([&, t]() {
+            for (int i = 0; i < kRecords; ++i) {
+                SharedRing::Block claimed;
+                while (!ring->tryReserve(2 * sizeof(int), claimed)) {
+                    retries.fetch_add(1);
+                    std::this_thread::yield();
+                }
+                int values[2] = {t, i};
+                std::memcpy(claimed.data, values, sizeof(values));
+                ring->commit(claimed);
+                if (i % 5000 == 0) {
+                    bool waited = ring->waitUntilRead(std::chrono::seconds(5));
+                    assert(waited);
+                    (void)waited;
+                }
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    writing = false;
+    reader.join();
+    for (int t = 0; t < kThreads; ++t) {
+        assert(next[t] == kRecords);
+    }
+    std::cout << "  [OK] " << kThreads << " x " << kRecords << " blocks, " << retries.load()
+              << " refused while full\n";
+
+    ring->setReaderAttached(false);
+    ring.reset();
+    SharedRing::remove(name);
+    std::cout << "[PASS] Concurrent writer tests passed\n\n";
+}
+
+bool initShared(const std::string& name, int async_mode, int shared_memory_size = 0)
+{
+    MLoggerOptions options     = defaultOptions("test_logs/test_shared_memory.log", async_mode);
+    options.min_log_level      = LOG_INFO;
+    options.shared_memory_name = name.c_str();
+    options.shared_memory_size = shared_memory_size;
+    return initWithOptions(&options) == 1;
+}
+
+void test_publishing(int async_mode, const char* mode)
+{
+    std::cout << "[TEST] Testing publishing with " << mode << "...\n";
+
+    std::filesystem::remove("test_logs/test_shared_memory.log");
+    std::string name        = segmentName("t-publish");
+    bool        initialized = initShared(name, async_mode, 64 * 1024);
+    assert(initialized);
+    (void)initialized;
+    std::string                 error;
+    std::unique_ptr<SharedRing> ring = SharedRing::open(name, 0, error);
+    assert(ring && ring->capacity() == 64 * 1024 && "created by the logger");
+
+    logMessage(LOG_INFO, "plain text");
+    logMessage(LOG_DEBUG, "filtered out");
+    LogField field{};
+    field.key        = "hp";
+    field.key_length = 2;
+    field.type       = LOG_FIELD_INT;
+    field.int_value  = 7;
+    logStructured(LOG_WARN, "spawned", &field, 1);
+    int           format = registerFormat("tick {}");
+    unsigned char args[9]  = {LOG_ARG_INT};
+    int64_t       value    = 42;
+    std::memcpy(args + 1, &value, sizeof(value));
+    logFormatted(LOG_INFO, format, args, sizeof(args));
+    std::u16string utf16 = u"hé";
+    logMessageUtf16(LOG_INFO, reinterpret_cast<const uint16_t*>(utf16.data()), 2);
+    int channel = createChannel("audio");
+    logChannel(channel, LOG_ERROR, "on a channel");
+
+    auto start = Clock::now();
+    flush();
+    assert(Clock::now() - start < std::chrono::milliseconds(100) && "no reader, no wait");
+    (void)start;
+
+    std::vector<Received> records;
+    size_t                drained = drainRecords(*ring, records);
+    assert(drained == 5 && "written by the logging thread itself");
+    for (const Received& received : records) {
+        assert(received.record.process_id == static_cast<uint32_t>(spdlog::details::os::pid()));
+        assert(received.record.thread_id == spdlog::details::os::thread_id());
+        assert(received.record.time_ns > 0);
+        (void)received;
+    }
+    assert(records[0].record.level == LOG_INFO && records[0].record.payload_tag == nullptr);
+    assert(records[0].logger_name == "mlogger" && records[0].payload == "plain text");
+    assert(records[1].record.level == LOG_WARN && records[1].record.payload_tag == kStructuredTag);
+    assert(records[1].text() == "spawned hp=7" && "structured payload as logged");
+    assert(records[2].record.payload_tag == kFormattedTag && records[2].format == "tick {}");
+    assert(records[2].payload.size() == sizeof(args) && records[2].text() == "tick 42");
+    assert(records[3].record.payload_tag == kUtf16Tag && records[3].payload.size() == 4);
+    assert(records[3].text() == "h\xc3\xa9");
+    assert(records[4].logger_name == "audio" && records[4].record.level == LOG_ERROR);
+    std::cout << "  [OK] Text, structured, formatted, UTF-16 and channel records\n";
+
+    // too large for a block: published as text, cut to fit
+    std::string large(40 * 1024, 'L');
+    logMessage(LOG_INFO, large.c_str());
+    records.clear();
+    drained = drainRecords(*ring, records);
+    assert(drained == 1);
+    assert(records[0].payload.size() ==
+           ring->maxBlockSize() - SharedMemorySink::kRecordHeaderSize - 7);
+    std::cout << "  [OK] Oversized record cut to " << records[0].payload.size() << " bytes\n";
+
+    // nobody drains: the ring fills up and the rest is counted
+    std::string line(1000, 'x');
+    for (int i = 0; i < 200; ++i) {
+        logMessage(LOG_INFO, line.c_str());
+    }
+    MLoggerStats stats{};
+    stats.struct_size = sizeof(MLoggerStats);
+    int result        = getStats(&stats);
+    assert(result == 1);
+    assert(stats.dropped > 0 && stats.dropped == getDroppedCount());
+    assert(stats.messages[LOG_INFO] == 3 + 1 + 200);
+    assert(ring->droppedCount() == stats.dropped);
+    records.clear();
+    drained = drainRecords(*ring, records);
+    assert(drained == 200 - stats.dropped);
+    (void)drained;
+    (void)result;
+    std::cout << "  [OK] " << stats.dropped << " records dropped while the ring was full\n";
+
+    // an attached reader: flush() returns once what was published is read
+    std::atomic<bool>   reading{true};
+    std::atomic<size_t> read_count{0};
+    ring->setReaderAttached(true);
+    std::thread reader([&]() {
+        std::vector<Received> drained;
+        while (reading) {
+            read_count += drainRecords(*ring, drained);
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    });
+    logMessage(LOG_INFO, "flushed");
+    flush();
+    assert(read_count == 1 && "read before flush() returned");
+    reading = false;
+    reader.join();
+    ring->setReaderAttached(false);
+    std::cout << "  [OK] flush() waits for the reader\n";
+
+    terminate();
+    assert(!std::filesystem::exists("test_logs/test_shared_memory.log") && "no file written");
+    ring.reset();
+    SharedRing::remove(name);
+    std::cout << "[PASS] " << mode << " publishing tests passed\n\n";
+}
+
+#if !defined(_WIN32) && !defined(_WIN64)
+void test_processes()
+{
+    std::cout << "[TEST] Testing several processes publishing to one segment...\n";
+
+    constexpr int               kProcesses = 3;
+    constexpr int               kRecords   = 2000;
+    std::string                 name       = segmentName("t-procs");
+    std::string                 error;
+    std::unique_ptr<SharedRing> ring = SharedRing::open(name, 1024 * 1024, error);
+    assert(ring);
+    ring->setReaderAttached(true);
+
+    std::vector<pid_t> children;
+    for (int p = 0; p < kProcesses; ++p) {
+        pid_t child = fork();
+        assert(child >= 0);
+        if (child == 0) {
+            // NOTE: exit codes instead of asserts, the parent checks them
+            if (!initShared(name, ASYNC_MODE_THREAD_POOL)) _exit(1);
+            for (int i = 0; i < kRecords; ++i) {
+                logMessage(LOG_INFO, ("process " + std::to_string(p) + " record " +
+                                      std::to_string(i)).c_str());
+            }
+            flush();
+            terminate();
+            _exit(getDroppedCount() == 0 ? 0 : 2);
+        }
+        children.push_back(child);
+    }
+
+    std::vector<Received> records;
+    auto                  deadline = Clock::now() + std::chrono::seconds(10);
+    while (records.size() < kProcesses * kRecords && Clock::now() < deadline) {
+        if (drainRecords(*ring, records) == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    for (pid_t child : children) {
+        int   status = 0;
+        pid_t waited = waitpid(child, &status, 0);
+        assert(waited == child);
+        (void)waited;
+        assert(WIFEXITED(status) && WEXITSTATUS(status) == 0 && "child published everything");
+    }
+    assert(records.size() == kProcesses * kRecords);
+
+    std::map<uint32_t, int> next;
+    for (const Received& received : records) {
+        int& expected = next[received.record.process_id];
+        assert(received.payload.find(" record " + std::to_string(expected)) != std::string::npos &&
+               "each process's records in order");
+        ++expected;
+    }
+    assert(next.size() == kProcesses);
+    std::cout << "  [OK] " << records.size() << " records of " << kProcesses << " processes\n";
+
+    ring->setReaderAttached(false);
+    ring.reset();
+    SharedRing::remove(name);
+    std::cout << "[PASS] Multi-process tests passed\n\n";
+}
+#endif
+
+int main()
+{
+    std::cout << "========================================\n";
+    std::cout << "MLogger Shared Memory Test Suite\n";
+    std::cout << "========================================\n\n";
+
+    std::filesystem::create_directories("test_logs");
+
+    if (!SharedRing::isSupported()) {
+        std::cout << "[SKIP] Shared memory is not supported on this platform\n";
+        return 0;
+    }
+
+    try {
+        test_ring_blocks();
+        test_abandoned_block();
+        test_concurrent_writers();
+        test_publishing(ASYNC_MODE_OFF, "sync");
+        test_publishing(ASYNC_MODE_THREAD_POOL, "thread_pool");
+#if !defined(_WIN32) && !defined(_WIN64)
+        test_processes();
+#endif
+
+        std::cout << "========================================\n";
+        std::cout << "All shared memory tests passed! [OK]\n";
+        std::cout << "========================================\n";
+
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "\n[FAIL] Test failed with exception: " << e.what() << "\n";
+        terminate();
+        return 1;
+    } catch (...) {
+        std::cerr << "\n[FAIL] Test failed with unknown exception\n";
+        terminate();
+        return 1;
+    }
+}
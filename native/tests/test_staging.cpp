@@ -0,0 +1,400 @@
+#include "../src/bridge/bridge.h"
+#include "../src/utils/slab_arena.h"
+#include "../src/utils/spsc_ring.h"
+#include "test_options.h"
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+std::string readFileContent(const char* path)
+{
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return "";
+    }
+    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return content;
+}
+
+size_t countOccurrences(const std::string& content, const std::string& needle)
+{
+    size_t count = 0;
+    for (size_t pos = content.find(needle); pos != std::string::npos;
+         pos        = content.find(needle, pos + needle.size())) {
+        ++count;
+    }
+    return count;
+}
+
+void test_spsc_ring()
+{
+    std::cout << "[TEST] Testing SPSC ring...\n";
+
+    // Test 1: blocks round-trip in order, including across the wrap point
+    mlogger::SpscRing ring(256);
+    for (int i = 0; i < 1000; ++i) {
+        size_t size  = 1 + (i * 7) % 40;
+        void*  block = ring.tryReserve(size);
+        assert(block != nullptr);
+        std::memset(block, 'a' + (i % 26), size);
+        ring.commit();
+
+        size_t      read_size = 0;
+        const void* front     = ring.front(&read_size);
+        assert(front != nullptr && read_size == size);
+        assert(static_cast<const char*>(front)[size - 1] == 'a' + (i % 26));
+        (void)front;
+        ring.pop();
+    }
+    assert(ring.empty());
+    std::cout << "  [OK] Blocks round-trip across wrap-around\n";
+
+    // Test 2: full ring rejects, oversized blocks are rejected
+    int reserved = 0;
+    while (ring.tryReserve(24) != nullptr) {
+        ring.commit();
+        ++reserved;
+    }
+    void* oversized = ring.tryReserve(ring.maxBlockSize() + 1);
+    assert(reserved > 0);
+    assert(oversized == nullptr);
+    (void)oversized;
+    while (ring.front() != nullptr) {
+        ring.pop();
+    }
+    assert(ring.empty());
+    std::cout << "  [OK] Full and oversized reservations rejected\n";
+
+    // Test 3: concurrent producer/consumer keep order
+    mlogger::SpscRing concurrent(4096);
+    const int         total = 200000;
+    std::thread       producer([&]() {
+        for (int i = 0; i < total; ++i) {
+            void* block;
+            while ((block = concurrent.tryReserve(sizeof(int))) == nullptr) {
+                std::this_thread::yield();
+            }
+            std::memcpy(block, &i, sizeof(int));
+            concurrent.commit();
+        }
+    });
+    for (int expected = 0; expected < total;) {
+        const void* block = concurrent.front();
+        if (!block) {
+            std::this_thread::yield();
+            continue;
+        }
+        int value;
+        std::memcpy(&value, block, sizeof(int));
+        assert(value == expected);
+        concurrent.pop();
+        ++expected;
+    }
+    producer.join();
+    std::cout << "  [OK] Concurrent producer/consumer preserve order\n";
+
+    std::cout << "[PASS] SPSC ring tests passed\n\n";
+}
+
+void test_slab_arena()
+{
+    std::cout << "[TEST] Testing slab arena...\n";
+
+    // Test 1: allocations are carved from one slab until it is full
+    mlogger::SlabArena        arena;
+    mlogger::SlabArena::Slab* first  = nullptr;
+    mlogger::SlabArena::Slab* second = nullptr;
+    char*                     a      = arena.allocate(1000, first);
+    char*                     b      = arena.allocate(1000, second);
+    assert(first == second && b == a + 1000);
+    assert(arena.slabCount() == 1);
+
+    // Test 2: a slab whose allocations were all released is reused as a whole
+    mlogger::SlabArena::release(first);
+    mlogger::SlabArena::release(second);
+    mlogger::SlabArena::Slab* slab  = nullptr;
+    char*                     again = arena.allocate(10, slab);
+    assert(again == a && slab == first);
+    (void)a;
+    (void)b;
+    (void)again;
+    mlogger::SlabArena::release(slab);
+    std::cout << "  [OK] Released slab reused from the front\n";
+
+    // Test 3: a consumer keeping pace leaves the slab count bounded
+    const size_t                           size = mlogger::SlabArena::kSlabSize / 3;
+    std::vector<mlogger::SlabArena::Slab*> in_flight;
+    for (int i = 0; i < 10000; ++i) {
+        mlogger::SlabArena::Slab* owner = nullptr;
+        std::memset(arena.allocate(size, owner), i & 0xFF, size);
+        in_flight.push_back(owner);
+        if (in_flight.size() == 4) {
+            for (auto* pending : in_flight) {
+                mlogger::SlabArena::release(pending);
+            }
+            in_flight.clear();
+        }
+    }
+    assert(arena.slabCount() <= 3);
+    std::cout << "  [OK] " << arena.slabCount() << " slabs after 10000 allocations\n";
+
+    // Test 4: requests larger than a slab get a slab of their own, freed once released, and the
+    // pooled slab keeps serving the small ones around them
+    size_t                    big   = mlogger::SlabArena::kSlabSize * 3 + 5;
+    mlogger::SlabArena::Slab* owner = nullptr;
+    for (auto* pending : in_flight) {
+        mlogger::SlabArena::release(pending);
+    }
+    size_t pooled = arena.slabCount();
+    for (int i = 0; i < 100; ++i) {
+        mlogger::SlabArena::Slab* before = nullptr;
+        mlogger::SlabArena::Slab* after  = nullptr;
+        char*                     small  = arena.allocate(16, before);
+        std::memset(arena.allocate(big, owner), 'B', big);
+        char* next = arena.allocate(16, after);
+        assert(owner != before && owner->capacity >= big);
+        assert(next == small + 16 && after == before);
+        mlogger::SlabArena::release(before);
+        mlogger::SlabArena::release(owner);
+        mlogger::SlabArena::release(after);
+        (void)small;
+        (void)next;
+    }
+    assert(arena.slabCount() == pooled);
+    (void)pooled;
+    std::cout << "  [OK] Oversized requests get a slab of their own, freed on release\n";
+
+    // Test 5: a concurrent consumer releasing in order
+    struct Handoff {
+        char*                     data;
+        mlogger::SlabArena::Slab* slab;
+    };
+    mlogger::SlabArena shared;
+    mlogger::SpscRing  handoff(64 * 1024);
+    const int          total = 200000;
+    std::thread        consumer([&]() {
+        for (int received = 0; received < total;) {
+            const void* block = handoff.front();
+            if (!block) {
+                std::this_thread::yield();
+                continue;
+            }
+            Handoff entry;
+            std::memcpy(&entry, block, sizeof(entry));
+            int value;
+            std::memcpy(&value, entry.data, sizeof(value));
+            assert(value == received);
+            mlogger::SlabArena::release(entry.slab);
+            handoff.pop();
+            ++received;
+        }
+    });
+    for (int i = 0; i < total; ++i) {
+        Handoff entry;
+        void*   block = nullptr;
+        while ((block = handoff.tryReserve(sizeof(entry))) == nullptr) {
+            std::this_thread::yield();
+        }
+        entry.data = shared.allocate(512, entry.slab);
+        std::memcpy(entry.data, &i, sizeof(i));
+        std::memcpy(block, &entry, sizeof(entry));
+        handoff.commit();
+    }
+    consumer.join();
+    std::cout << "  [OK] Concurrent release, " << shared.slabCount() << " slabs in use\n";
+
+    std::cout << "[PASS] Slab arena tests passed\n\n";
+}
+
+void test_staging_logging()
+{
+    std::cout << "[TEST] Testing staging ring backend...\n";
+
+    const char* log_path = "test_logs/test_staging.log";
+    std::filesystem::remove(log_path);
+    int result = init(log_path, 50 * 1024 * 1024, 3, ASYNC_MODE_STAGING, 1, LOG_INFO);
+    assert(result == 1);
+    assert(isInit() == 1);
+    std::cout << "  [OK] init() with staging backend succeeds\n";
+
+    // Test 1: every message from every thread arrives after flush(), no sleep needed
+    const int                num_threads     = 8;
+    const int                logs_per_thread = 5000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([t]() {
+            for (int i = 0; i < logs_per_thread; ++i) {
+                char buffer[128];
+                snprintf(buffer, sizeof(buffer), "Staging thread %d seq %d", t, i);
+                logMessage(LOG_INFO, buffer);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    flush();
+
+    std::string content = readFileContent(log_path);
+    assert(countOccurrences(content, "Staging thread ") ==
+           static_cast<size_t>(num_threads * logs_per_thread));
+    std::cout << "  [OK] All " << num_threads * logs_per_thread << " messages drained on flush\n";
+
+    // Test 2: per-thread order is kept and the merged file is ordered by timestamp
+    // NOTE: a producer preempted between stamping and publishing can still land late
+    std::istringstream lines(content);
+    std::string        line;
+    std::vector<int>   last_seq(num_threads, -1);
+    std::string        last_stamp;
+    int                inversions = 0;
+    while (std::getline(lines, line)) {
+        int t = -1, seq = -1;
+        size_t pos = line.find("Staging thread ");
+        if (pos == std::string::npos) continue;
+        if (sscanf(line.c_str() + pos, "Staging thread %d seq %d", &t, &seq) != 2) continue;
+        assert(t >= 0 && t < num_threads);
+        assert(seq == last_seq[t] + 1);
+        last_seq[t] = seq;
+
+        std::string stamp = line.substr(0, line.find(']'));
+        if (stamp < last_stamp) ++inversions;
+        last_stamp = stamp;
+    }
+    assert(inversions * 100 < num_threads * logs_per_thread);
+    std::cout << "  [OK] Per-thread order kept, records merged by timestamp\n";
+
+    // Test 3: payloads larger than a ring block, from several producers at once
+    std::string huge(600 * 1024, 'H');
+    logMessage(LOG_INFO, huge.c_str());
+    threads.clear();
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([t]() {
+            std::string text(200 * 1024, static_cast<char>('a' + t));
+            for (int i = 0; i < 20; ++i) {
+                logMessage(LOG_INFO, text.c_str());
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    flush();
+    content = readFileContent(log_path);
+    assert(content.find(huge) != std::string::npos);
+    for (int t = 0; t < 4; ++t) {
+        assert(countOccurrences(content, std::string(200 * 1024, static_cast<char>('a' + t))) ==
+               20);
+    }
+    std::cout << "  [OK] Oversized payloads delivered\n";
+
+    // Test 4: many short-lived producer threads
+    for (int round = 0; round < 50; ++round) {
+        std::thread([round]() {
+            char buffer[64];
+            snprintf(buffer, sizeof(buffer), "Short lived %d", round);
+            logMessage(LOG_WARN, buffer);
+        }).join();
+    }
+    flush();
+    content = readFileContent(log_path);
+    assert(countOccurrences(content, "Short lived ") == 50);
+    std::cout << "  [OK] Short-lived producer threads handled\n";
+
+    // Test 5: level filtering and reinitialization
+    logMessage(LOG_DEBUG, "Staging filtered");
+    terminate();
+    content = readFileContent(log_path);
+    assert(content.find("Staging filtered") == std::string::npos);
+
+    for (int i = 0; i < 5; ++i) {
+        result = init(log_path, 50 * 1024 * 1024, 3, ASYNC_MODE_STAGING, 1, LOG_INFO);
+        assert(result == 1);
+        logMessage(LOG_INFO, "Staging reinit");
+        terminate();
+    }
+    content = readFileContent(log_path);
+    assert(countOccurrences(content, "Staging reinit") == 5);
+    (void)result;
+    std::cout << "  [OK] Filtering and reinitialization work\n";
+
+    std::cout << "[PASS] Staging ring backend tests passed\n\n";
+}
+
+void test_staging_overflow()
+{
+    std::cout << "[TEST] Testing staging ring overflow...\n";
+
+    const char* log_path = "test_logs/test_staging_overflow.log";
+    std::filesystem::remove(log_path);
+
+    MLoggerOptions options  = defaultOptions(log_path, ASYNC_MODE_STAGING);
+    options.min_log_level   = LOG_INFO;
+    options.overflow_policy = OVERFLOW_DROP_NEWEST;
+    int result              = initWithOptions(&options);
+    assert(result == 1);
+    (void)result;
+
+    // Test 1: a full ring drops instead of blocking, every record is written or counted
+    const int num_logs = 50000;
+    for (int i = 0; i < num_logs; ++i) {
+        char buffer[128];
+        snprintf(buffer, sizeof(buffer), "Staging overflow %d", i);
+        logMessage(LOG_INFO, buffer);
+    }
+    uint64_t dropped = getDroppedCount();
+    terminate();
+
+    std::string content = readFileContent(log_path);
+    assert(countOccurrences(content, "Staging overflow ") + dropped ==
+           static_cast<size_t>(num_logs));
+    std::cout << "  [OK] " << dropped << " records dropped and accounted for\n";
+
+    // Test 2: drops are summarised once the rings drain
+    uint64_t reported = 0;
+    for (size_t pos = content.find(" messages dropped"); pos != std::string::npos;
+         pos        = content.find(" messages dropped", pos + 1)) {
+        size_t start = content.rfind(' ', pos - 1) + 1;
+        reported += std::stoull(content.substr(start, pos - start));
+    }
+    assert(reported == dropped);
+    std::cout << "  [OK] Dropped records summarised in the log\n";
+
+    std::cout << "[PASS] Staging ring overflow tests passed\n\n";
+}
+
+int main()
+{
+    std::cout << "========================================\n";
+    std::cout << "MLogger Staging Backend Test Suite\n";
+    std::cout << "========================================\n\n";
+
+    std::filesystem::create_directories("test_logs");
+
+    try {
+        test_spsc_ring();
+        test_slab_arena();
+        test_staging_logging();
+        test_staging_overflow();
+
+        std::cout << "========================================\n";
+        std::cout << "All staging backend tests passed! [OK]\n";
+        std::cout << "========================================\n";
+
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "\n[FAIL] Test failed with exception: " << e.what() << "\n";
+        terminate();
+        return 1;
+    } catch (...) {
+        std::cerr << "\n[FAIL] Test failed with unknown exception\n";
+        terminate();
+        return 1;
+    }
+}
@@ -0,0 +1,254 @@
+#include "../src/bridge/bridge.h"
+#include "test_options.h"
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+bool initStats(const char* log_path, size_t max_file_size, int max_files, int async_mode,
+               int min_level)
+{
+    MLoggerOptions options    = defaultOptions(log_path, async_mode);
+    options.max_file_size     = max_file_size;
+    options.max_files         = max_files;
+    options.min_log_level     = min_level;
+    options.flush_interval_ms = -1;   // flushes only where the tests ask for them
+    return initWithOptions(&options) == 1;
+}
+
+MLoggerStats readStats()
+{
+    MLoggerStats stats{};
+    stats.struct_size = sizeof(MLoggerStats);
+    int result        = getStats(&stats);
+    assert(result == 1);
+    (void)result;
+    return stats;
+}
+
+uint64_t totalMessages(const MLoggerStats& stats)
+{
+    uint64_t total = 0;
+    for (uint64_t count : stats.messages) {
+        total += count;
+    }
+    return total;
+}
+
+uintmax_t totalFileSize(const std::string& stem, int max_files)
+{
+    uintmax_t total = 0;
+    for (int i = 0; i <= max_files; ++i) {
+        std::string path = i == 0 ? stem + ".log" : stem + "." + std::to_string(i) + ".log";
+        if (std::filesystem::exists(path)) total += std::filesystem::file_size(path);
+    }
+    return total;
+}
+
+void removeFiles(const std::string& stem, int max_files)
+{
+    for (int i = 0; i <= max_files; ++i) {
+        std::filesystem::remove(i == 0 ? stem + ".log" : stem + "." + std::to_string(i) + ".log");
+    }
+}
+
+void test_stats_arguments()
+{
+    std::cout << "[TEST] Testing getStats arguments...\n";
+
+    // Test 1: null and undersized structs are rejected
+    int result = getStats(nullptr);
+    assert(result == 0);
+    MLoggerStats stats{};
+    stats.struct_size = 8;
+    result            = getStats(&stats);
+    assert(result == 0);
+    std::cout << "  [OK] Invalid arguments rejected\n";
+
+    // Test 2: a larger struct from a newer caller is only filled up to our layout
+    struct {
+        MLoggerStats stats;
+        uint64_t     future_field;
+    } extended{};
+    extended.stats.struct_size = sizeof(extended);
+    extended.future_field      = 42;
+    result = getStats(&extended.stats);
+    assert(result == 1);
+    assert(extended.stats.struct_size == sizeof(extended));
+    assert(extended.stats.latency_bucket_count == MLOGGER_LATENCY_BUCKETS);
+    assert(extended.future_field == 42);
+    (void)result;
+    std::cout << "  [OK] Unknown trailing fields left untouched\n";
+
+    std::cout << "[PASS] getStats argument tests passed\n\n";
+}
+
+void test_stats_sync()
+{
+    std::cout << "[TEST] Testing sync statistics...\n";
+
+    const char* log_path = "test_logs/test_stats_sync.log";
+    std::filesystem::remove(log_path);
+    bool ok = initStats(log_path, 10 * 1024 * 1024, 3, ASYNC_MODE_OFF, LOG_DEBUG);
+    assert(ok);
+
+    // Test 1: per level counters skip filtered messages
+    for (int i = 0; i < 100; ++i) logMessage(LOG_TRACE, "filtered");
+    for (int i = 0; i < 100; ++i) logMessage(LOG_DEBUG, "debug message");
+    for (int i = 0; i < 50; ++i) logMessage(LOG_WARN, "warn message");
+    logException("InvalidOperationException", "counted as an error", "at Game.Update()");
+
+    MLoggerStats stats = readStats();
+    assert(stats.messages[LOG_TRACE] == 0);
+    assert(stats.messages[LOG_DEBUG] == 100);
+    assert(stats.messages[LOG_WARN] == 50);
+    assert(stats.messages[LOG_ERROR] == 1);
+    assert(stats.dropped == 0 && stats.queue_depth == 0 && stats.queue_high_water == 0);
+    std::cout << "  [OK] " << totalMessages(stats) << " messages counted by level\n";
+
+    // Test 2: every 16th call of a thread is timed, buckets add up to the sample count
+    uint64_t bucketed = 0;
+    for (uint64_t count : stats.latency_ns) {
+        bucketed += count;
+    }
+    assert(stats.latency_samples >= totalMessages(stats) / 16);
+    assert(stats.latency_samples <= totalMessages(stats) / 16 + 1);
+    assert(bucketed == stats.latency_samples);
+    std::cout << "  [OK] " << stats.latency_samples << " latency samples\n";
+
+    // Test 3: bytes and flushes, only critical records flush on their own
+    assert(stats.flushes == 0);
+    logExceptionWithLevel(LOG_CRITICAL, "FatalException", "flushes at once", "at Game.Update()");
+    stats = readStats();
+    assert(stats.flushes == 1);
+    flush();
+    assert(readStats().flushes == stats.flushes + 1);
+    terminate();
+
+    MLoggerStats final_stats = readStats();
+    assert(final_stats.bytes_written == std::filesystem::file_size(log_path));
+    assert(final_stats.messages[LOG_DEBUG] == 100);
+    std::cout << "  [OK] " << final_stats.bytes_written << " bytes written, kept after terminate\n";
+
+    // Test 4: a new init starts from zero
+    ok = initStats(log_path, 10 * 1024 * 1024, 3, ASYNC_MODE_OFF, LOG_DEBUG);
+    assert(ok);
+    assert(totalMessages(readStats()) == 0 && readStats().bytes_written == 0);
+    (void)ok;
+    terminate();
+    std::cout << "  [OK] Counters reset on init\n";
+
+    std::cout << "[PASS] Sync statistics tests passed\n\n";
+}
+
+void test_stats_rotation()
+{
+    std::cout << "[TEST] Testing rotation statistics...\n";
+
+    const std::string stem      = "test_logs/test_stats_rotate";
+    const int         max_files = 50;
+    removeFiles(stem, max_files);
+    bool ok = initStats((stem + ".log").c_str(), 4096, max_files, ASYNC_MODE_OFF, LOG_TRACE);
+    assert(ok);
+    (void)ok;
+
+    // Test 1: rotations are counted, and no byte is lost across files
+    std::string message(100, 'r');
+    for (int i = 0; i < 300; ++i) logMessage(LOG_INFO, message.c_str());
+    terminate();
+
+    MLoggerStats stats = readStats();
+    assert(stats.rotations >= 5 && stats.rotations < static_cast<uint64_t>(max_files));
+    assert(stats.bytes_written == totalFileSize(stem, max_files));
+    std::cout << "  [OK] " << stats.rotations << " rotations, " << stats.bytes_written
+              << " bytes\n";
+
+    std::cout << "[PASS] Rotation statistics tests passed\n\n";
+}
+
+void test_stats_async(int async_mode, const char* name)
+{
+    std::cout << "[TEST] Testing " << name << " statistics...\n";
+
+    std::string log_path = std::string("test_logs/test_stats_") + name + ".log";
+    std::filesystem::remove(log_path);
+    bool ok = initStats(log_path.c_str(), 10 * 1024 * 1024, 3, async_mode, LOG_INFO);
+    assert(ok);
+    (void)ok;
+
+    // Test 1: counters from several producer threads add up
+    const int                num_threads     = 4;
+    const int                logs_per_thread = 5000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([t]() {
+            std::string message = "async stats thread " + std::to_string(t);
+            for (int i = 0; i < logs_per_thread; ++i) {
+                logMessage(i % 2 ? LOG_INFO : LOG_WARN, message.c_str());
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    const uint64_t expected = static_cast<uint64_t>(num_threads) * logs_per_thread;
+    MLoggerStats   stats    = readStats();
+    assert(stats.messages[LOG_INFO] == expected / 2);
+    assert(stats.messages[LOG_WARN] == expected / 2);
+    assert(stats.queue_depth <= expected && stats.queue_high_water <= expected);
+    (void)expected;
+    std::cout << "  [OK] " << totalMessages(stats) << " messages, high water "
+              << stats.queue_high_water << "\n";
+
+    // Test 2: the depth falls back to zero once the writer caught up
+    flush();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (readStats().queue_depth != 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    assert(readStats().queue_depth == 0);
+    terminate();
+
+    stats = readStats();
+    assert(stats.queue_depth == 0 && stats.queue_high_water == 0);
+    assert(stats.bytes_written == std::filesystem::file_size(log_path));
+    std::cout << "  [OK] Queue drained, " << stats.bytes_written << " bytes written\n";
+
+    std::cout << "[PASS] " << name << " statistics tests passed\n\n";
+}
+
+int main()
+{
+    std::cout << "========================================\n";
+    std::cout << "MLogger Statistics Test Suite\n";
+    std::cout << "========================================\n\n";
+
+    std::filesystem::create_directories("test_logs");
+
+    try {
+        test_stats_arguments();
+        test_stats_sync();
+        test_stats_rotation();
+        test_stats_async(ASYNC_MODE_THREAD_POOL, "thread_pool");
+        test_stats_async(ASYNC_MODE_STAGING, "staging");
+
+        std::cout << "========================================\n";
+        std::cout << "All statistics tests passed! [OK]\n";
+        std::cout << "========================================\n";
+
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "\n[FAIL] Test failed with exception: " << e.what() << "\n";
+        terminate();
+        return 1;
+    } catch (...) {
+        std::cerr << "\n[FAIL] Test failed with unknown exception\n";
+        terminate();
+        return 1;
+    }
+}
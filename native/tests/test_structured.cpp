@@ -0,0 +1,294 @@
+#include "../src/bridge/bridge.h"
+#include "../src/sinks/binary_format.h"
+#include "test_options.h"
+#include <cassert>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+
+bool initStructured(const char* log_path, const char* json_path, int async_mode,
+                    int file_format = LOG_FILE_TEXT, int ring_buffer_size = 0)
+{
+    std::filesystem::remove(log_path);
+    if (json_path) std::filesystem::remove(json_path);
+
+    MLoggerOptions options   = defaultOptions(log_path, async_mode);
+    options.min_log_level    = LOG_INFO;
+    options.file_format      = file_format;
+    options.ring_buffer_size = ring_buffer_size;
+    options.json_log_path    = json_path;
+    return initWithOptions(&options) == 1;
+}
+
+std::vector<std::string> readLines(const std::string& path)
+{
+    std::ifstream            input(path);
+    std::vector<std::string> lines;
+    std::string              line;
+    while (std::getline(input, line)) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+std::string findLine(const std::vector<std::string>& lines, const std::string& text)
+{
+    for (const auto& line : lines) {
+        if (line.find(text) != std::string::npos) return line;
+    }
+    return "";
+}
+
+LogField intField(const char* key, int64_t value)
+{
+    LogField field{};
+    field.key        = key;
+    field.key_length = static_cast<uint16_t>(std::strlen(key));
+    field.type       = LOG_FIELD_INT;
+    field.int_value  = value;
+    return field;
+}
+
+LogField doubleField(const char* key, double value)
+{
+    LogField field{};
+    field.key          = key;
+    field.key_length   = static_cast<uint16_t>(std::strlen(key));
+    field.type         = LOG_FIELD_DOUBLE;
+    field.double_value = value;
+    return field;
+}
+
+LogField boolField(const char* key, bool value)
+{
+    LogField field = intField(key, value ? 1 : 0);
+    field.type     = LOG_FIELD_BOOL;
+    return field;
+}
+
+LogField stringField(const char* key, const char* value)
+{
+    LogField field{};
+    field.key           = key;
+    field.key_length    = static_cast<uint16_t>(std::strlen(key));
+    field.type          = LOG_FIELD_STRING;
+    field.string_value  = value;
+    field.string_length = static_cast<int32_t>(std::strlen(value));
+    return field;
+}
+
+void test_structured_sync()
+{
+    std::cout << "[TEST] Testing structured records in text and JSON files...\n";
+
+    const char* log_path  = "test_logs/test_structured.log";
+    const char* json_path = "test_logs/test_structured.jsonl";
+    bool ok = initStructured(log_path, json_path, ASYNC_MODE_OFF);
+    assert(ok);
+    (void)ok;
+
+    LogField fields[] = {intField("hp", -42),
+                         doubleField("ratio", 0.5),
+                         boolField("alive", true),
+                         stringField("name", "orc \"boss\""),
+                         stringField("zone", "north"),
+                         doubleField("speed", std::numeric_limits<double>::infinity())};
+    logStructured(LOG_INFO, "spawned", fields, 6);
+    logStructured(LOG_DEBUG, "filtered", fields, 6);
+    logStructured(LOG_WARN, "no fields", nullptr, 0);
+    logMessage(LOG_INFO, "plain\ttext");
+    terminate();
+
+    // Test 1: the text file gets logfmt after the message
+    std::vector<std::string> text = readLines(log_path);
+    std::string              line = findLine(text, "spawned");
+    assert(line.find("[info] spawned hp=-42 ratio=0.5 alive=true name=\"orc \\\"boss\\\"\" "
+                     "zone=north speed=inf") != std::string::npos);
+    assert(findLine(text, "[warning] no fields") != "");
+    assert(findLine(text, "filtered").empty());
+    std::cout << "  [OK] Text file: " << line.substr(line.find("spawned")) << "\n";
+
+    // Test 2: the JSON file gets one object per record with typed members
+    std::vector<std::string> json = readLines(json_path);
+    assert(json.size() == 3);
+    line = findLine(json, "spawned");
+    assert(line.front() == '{' && line.back() == '}');
+    assert(line.find("{\"time\":\"") == 0);
+    assert(line.find("Z\",\"level\":\"info\",\"logger\":\"mlogger\",\"thread\":") !=
+           std::string::npos);
+    assert(line.find(",\"message\":\"spawned\",\"hp\":-42,\"ratio\":0.5,\"alive\":true,"
+                     "\"name\":\"orc \\\"boss\\\"\",\"zone\":\"north\",\"speed\":null}") !=
+           std::string::npos);
+    assert(findLine(json, "\"message\":\"plain\\ttext\"}") != "");
+    assert(findLine(json, "\"level\":\"warning\",").find("\"message\":\"no fields\"}") !=
+           std::string::npos);
+    std::cout << "  [OK] JSON file: " << line << "\n";
+
+    std::cout << "[PASS] Structured sync tests passed\n\n";
+}
+
+void test_structured_fields_validation()
+{
+    std::cout << "[TEST] Testing invalid fields...\n";
+
+    const char* log_path  = "test_logs/test_structured_invalid.log";
+    const char* json_path = "test_logs/test_structured_invalid.jsonl";
+
+    // Test 1: the JSON file must differ from the log file
+    bool ok = initStructured(log_path, log_path, ASYNC_MODE_OFF);
+    assert(!ok);
+    ok = initStructured(log_path, json_path, ASYNC_MODE_OFF);
+    assert(ok);
+    (void)ok;
+
+    // Test 2: broken fields are skipped, the rest of the record is kept
+    LogField unknown       = intField("unknown", 1);
+    unknown.type           = 9;
+    LogField no_key        = intField("no_key", 2);
+    no_key.key             = nullptr;
+    LogField negative      = stringField("negative", "x");
+    negative.string_length = -1;
+    LogField control       = stringField("control", "a\x01z\n");
+    LogField fields[]      = {unknown, no_key, negative, intField("kept", 3), control};
+    logStructured(LOG_ERROR, "validated", fields, 5);
+    logStructured(LOG_ERROR, nullptr, fields, 5);
+    logStructured(LOG_ERROR, "negative count", fields, -1);
+    terminate();
+
+    std::string line = findLine(readLines(json_path), "validated");
+    assert(line.find("\"message\":\"validated\",\"kept\":3,\"control\":\"a\\u0001z\\n\"}") !=
+           std::string::npos);
+    assert(findLine(readLines(json_path), "\"message\":\"negative count\"}") != "");
+    line = findLine(readLines(log_path), "validated");
+    assert(line.find("validated kept=3 control=\"a\x01z\\n\"") != std::string::npos);
+    std::cout << "  [OK] Invalid fields skipped, control characters escaped\n";
+
+    std::cout << "[PASS] Invalid field tests passed\n\n";
+}
+
+void test_structured_ring_and_binary()
+{
+    std::cout << "[TEST] Testing structured records in the ring and binary files...\n";
+
+    const char* log_path  = "test_logs/test_structured.bin.log";
+    const char* dump_path = "test_logs/test_structured.dump.log";
+    bool ok = initStructured(log_path, nullptr, ASYNC_MODE_OFF, LOG_FILE_BINARY, 64 * 1024);
+    assert(ok);
+    (void)ok;
+
+    LogField fields[] = {intField("frame", 7), stringField("scene", "menu")};
+    logStructured(LOG_TRACE, "ring only", fields, 2);
+    logStructured(LOG_INFO, "loaded", fields, 2);
+    int result = dumpRing(dump_path);
+    assert(result == 1);
+    (void)result;
+    terminate();
+
+    // Test 1: the ring keeps the rendered text of every level
+    std::vector<std::string> dump = readLines(dump_path);
+    assert(findLine(dump, "ring only frame=7 scene=menu") != "");
+    assert(findLine(dump, "loaded frame=7 scene=menu") != "");
+
+    // Test 2: binary files store the rendered text
+    std::ifstream            input(log_path, std::ios::binary);
+    mlogger::BinaryLogReader reader(input);
+    mlogger::BinaryLogEntry  entry;
+    std::vector<std::string> texts;
+    while (reader.next(entry)) {
+        texts.push_back(entry.text);
+    }
+    assert(reader.error().empty());
+    assert(texts.size() == 1 && texts[0] == "loaded frame=7 scene=menu");
+    std::cout << "  [OK] Ring and binary file hold the logfmt text\n";
+
+    std::cout << "[PASS] Ring and binary tests passed\n\n";
+}
+
+void test_structured_async(int async_mode, const char* name)
+{
+    std::cout << "[TEST] Testing structured records with " << name << "...\n";
+
+    std::string log_path  = std::string("test_logs/test_structured_") + name + ".log";
+    std::string json_path = std::string("test_logs/test_structured_") + name + ".jsonl";
+    bool ok = initStructured(log_path.c_str(), json_path.c_str(), async_mode);
+    assert(ok);
+    (void)ok;
+
+    // Test 1: fields survive the async queue, every record reaches both files
+    const int                num_threads     = 4;
+    const int                logs_per_thread = 2500;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([t]() {
+            std::string label = "worker" + std::to_string(t);
+            for (int i = 0; i < logs_per_thread; ++i) {
+                LogField fields[] = {intField("thread", t),
+                                     intField("seq", i),
+                                     stringField("label", label.c_str())};
+                logStructured(LOG_INFO, "tick", fields, 3);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    terminate();
+
+    std::vector<std::string> json = readLines(json_path);
+    std::vector<std::string> text = readLines(log_path);
+    assert(json.size() == static_cast<size_t>(num_threads * logs_per_thread));
+    assert(text.size() == json.size());
+    std::vector<int> counts(num_threads, 0);
+    for (const auto& line : json) {
+        size_t at = line.find(",\"message\":\"tick\",\"thread\":");
+        assert(at != std::string::npos && line.back() == '}');
+        int t = line[at + std::strlen(",\"message\":\"tick\",\"thread\":")] - '0';
+        assert(t >= 0 && t < num_threads);
+        assert(line.find("\"label\":\"worker" + std::to_string(t) + "\"}") != std::string::npos);
+        ++counts[t];
+    }
+    for (int count : counts) {
+        assert(count == logs_per_thread);
+        (void)count;
+    }
+    assert(findLine(text, "tick thread=3 seq=2499 label=worker3") != "");
+    std::cout << "  [OK] " << json.size() << " records in both files\n";
+
+    std::cout << "[PASS] " << name << " structured tests passed\n\n";
+}
+
+int main()
+{
+    std::cout << "========================================\n";
+    std::cout << "MLogger Structured Logging Test Suite\n";
+    std::cout << "========================================\n\n";
+
+    std::filesystem::create_directories("test_logs");
+
+    try {
+        test_structured_sync();
+        test_structured_fields_validation();
+        test_structured_ring_and_binary();
+        test_structured_async(ASYNC_MODE_THREAD_POOL, "thread_pool");
+        test_structured_async(ASYNC_MODE_STAGING, "staging");
+
+        std::cout << "========================================\n";
+        std::cout << "All structured logging tests passed! [OK]\n";
+        std::cout << "========================================\n";
+
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "\n[FAIL] Test failed with exception: " << e.what() << "\n";
+        terminate();
+        return 1;
+    } catch (...) {
+        std::cerr << "\n[FAIL] Test failed with unknown exception\n";
+        terminate();
+        return 1;
+    }
+}
@@ -0,0 +1,220 @@
+#include "../src/bridge/bridge.h"
+#include "../src/utils/thread_utils.h"
+#include "test_options.h"
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#    include <pthread.h>
+#    include <sched.h>
+#    include <sys/resource.h>
+#    include <sys/syscall.h>
+#    include <unistd.h>
+#endif
+
+using namespace mlogger;
+
+std::string readFile(const std::string& path)
+{
+    std::ifstream input(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+}
+
+// the first CPU this process may run on, as an affinity mask
+uint64_t firstCpu()
+{
+#if defined(__linux__)
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    int result = sched_getaffinity(0, sizeof(cpus), &cpus);
+    assert(result == 0);
+    (void)result;
+    for (int cpu = 0; cpu < 64; ++cpu) {
+        if (CPU_ISSET(cpu, &cpus)) return uint64_t{1} << cpu;
+    }
+#endif
+    return 1;
+}
+
+#if defined(__linux__)
+// CPU masks of the threads of this process named `name`
+std::vector<uint64_t> threadsNamed(const std::string& name)
+{
+    std::vector<uint64_t> masks;
+    for (const auto& task : std::filesystem::directory_iterator("/proc/self/task")) {
+        std::string comm = readFile(task.path().string() + "/comm");
+        if (!comm.empty() && comm.back() == '\n') comm.pop_back();
+        if (comm != name) continue;
+
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        auto tid    = static_cast<pid_t>(std::stol(task.path().filename().string()));
+        int  result = sched_getaffinity(tid, sizeof(cpus), &cpus);
+        assert(result == 0);
+        (void)result;
+        uint64_t mask = 0;
+        for (int cpu = 0; cpu < 64; ++cpu) {
+            if (CPU_ISSET(cpu, &cpus)) mask |= uint64_t{1} << cpu;
+        }
+        masks.push_back(mask);
+    }
+    return masks;
+}
+#endif
+
+void test_apply_settings()
+{
+    std::cout << "[TEST] Testing thread settings...\n";
+
+    ThreadSettings settings;
+    settings.name     = "mlogger-test-thread-long";
+    settings.affinity = firstCpu();
+    settings.priority = ThreadPriority::background;
+
+    std::vector<std::string> errors;
+    std::thread              worker([&settings, &errors]() {
+        applyThreadSettings(settings,
+                            [&errors](const char* message) { errors.push_back(message); });
+#if defined(__linux__)
+        char name[32] = {};
+        int  result   = pthread_getname_np(pthread_self(), name, sizeof(name));
+        assert(result == 0);
+        assert(std::string(name) == "mlogger-test-th" && "cut to 15 bytes");
+
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        result = sched_getaffinity(0, sizeof(cpus), &cpus);
+        assert(result == 0);
+        assert(CPU_COUNT(&cpus) == 1 && CPU_ISSET(__builtin_ctzll(settings.affinity), &cpus));
+
+        int nice = getpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)));
+        assert(nice == 19);
+        (void)result;
+        (void)nice;
+#endif
+    });
+    worker.join();
+#if defined(__APPLE__)
+    assert(errors.size() == 1 && "no affinity on Apple platforms");
+#else
+    assert(errors.empty());
+#endif
+    std::cout << "  [OK] Name, affinity and priority applied\n";
+
+    // a mask without an existing CPU is reported, the rest still applies
+    settings.affinity = uint64_t{1} << 63;
+    errors.clear();
+    std::thread refused([&settings, &errors]() {
+        applyThreadSettings(settings,
+                            [&errors](const char* message) { errors.push_back(message); });
+    });
+    refused.join();
+    if (std::thread::hardware_concurrency() < 64) {
+        assert(errors.size() == 1);
+    }
+    std::cout << "  [OK] Refused settings reported\n";
+
+    std::cout << "[PASS] Thread settings tests passed\n\n";
+}
+
+void test_writer_threads(int async_mode, const char* name)
+{
+    std::cout << "[TEST] Testing writer thread options, " << name << "...\n";
+
+    std::string log_path = std::string("test_logs/test_thread_options_") + name + ".log";
+    std::filesystem::remove(log_path);
+
+    MLoggerOptions options     = defaultOptions(log_path.c_str(), async_mode);
+    options.thread_pool_size   = 2;
+    options.writer_priority    = LOG_THREAD_BACKGROUND;
+    options.writer_thread_name = "mlog-writer";
+    options.writer_affinity    = firstCpu();
+    int result                 = initWithOptions(&options);
+    assert(result == 1);
+    (void)result;
+
+    for (int i = 0; i < 1000; ++i) {
+        logMessage(LOG_INFO, ("record " + std::to_string(i)).c_str());
+    }
+    flush();
+
+#if defined(__linux__)
+    std::vector<uint64_t> writers  = threadsNamed("mlog-writer");
+    size_t                expected = async_mode == ASYNC_MODE_THREAD_POOL ? 2 : 1;
+    assert(writers.size() == expected);
+    for (uint64_t mask : writers) {
+        assert(mask == options.writer_affinity && "pinned");
+        (void)mask;
+    }
+    (void)expected;
+    assert(threadsNamed("mlog-writer-flu").size() == 1 && "flush worker, cut to 15 bytes");
+    std::cout << "  [OK] " << writers.size() << " writer thread(s) named and pinned\n";
+#endif
+
+    terminate();
+    std::string content = readFile(log_path);
+    assert(content.find("record 0") != std::string::npos);
+    assert(content.find("record 999") != std::string::npos);
+    std::cout << "  [OK] Records written\n";
+
+    std::cout << "[PASS] " << name << " writer thread tests passed\n\n";
+}
+
+void test_invalid_priority()
+{
+    std::cout << "[TEST] Testing priority validation...\n";
+
+    MLoggerOptions options{};
+    options.struct_size     = sizeof(MLoggerOptions);
+    options.log_path        = "test_logs/test_thread_options_invalid.log";
+    options.max_file_size   = 1024 * 1024;
+    options.max_files       = 1;
+    options.min_log_level   = LOG_INFO;
+    options.writer_priority = 3;
+    int result              = initWithOptions(&options);
+    assert(result == 0);
+    options.writer_priority = -1;
+    result                  = initWithOptions(&options);
+    assert(result == 0);
+    assert(isInit() == 0);
+    (void)result;
+    std::cout << "  [OK] Unknown priorities rejected\n";
+
+    std::cout << "[PASS] Validation tests passed\n\n";
+}
+
+int main()
+{
+    std::cout << "========================================\n";
+    std::cout << "MLogger Thread Options Test Suite\n";
+    std::cout << "========================================\n\n";
+
+    std::filesystem::create_directories("test_logs");
+
+    try {
+        test_apply_settings();
+        test_writer_threads(ASYNC_MODE_THREAD_POOL, "thread_pool");
+        test_writer_threads(ASYNC_MODE_STAGING, "staging");
+        test_invalid_priority();
+
+        std::cout << "========================================\n";
+        std::cout << "All thread options tests passed! [OK]\n";
+        std::cout << "========================================\n";
+
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "\n[FAIL] Test failed with exception: " << e.what() << "\n";
+        terminate();
+        return 1;
+    } catch (...) {
+        std::cerr << "\n[FAIL] Test failed with unknown exception\n";
+        terminate();
+        return 1;
+    }
+}
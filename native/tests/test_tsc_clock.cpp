@@ -0,0 +1,205 @@
+#include "../src/bridge/bridge.h"
+#include "../src/sinks/binary_format.h"
+#include "../src/sinks/rotating_file_sink.h"
+#include "../src/utils/tsc_clock.h"
+#include "test_options.h"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mlogger;
+
+// scheduling noise of a loaded test machine, the clock itself is within microseconds
+constexpr int64_t kToleranceNs = 2000000;
+
+int64_t systemNs()
+{
+    auto since_epoch = std::chrono::system_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(since_epoch).count();
+}
+
+int64_t tscNs()
+{
+    auto since_epoch = TscClock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(since_epoch).count();
+}
+
+void test_clock()
+{
+    std::cout << "[TEST] Testing the cycle counter clock...\n";
+
+    if (!TscClock::isSupported()) {
+        assert(TscClock::ticks() == 0);
+        TscClock::recalibrate();
+        assert(std::llabs(tscNs() - systemNs()) < kToleranceNs && "the system clock");
+        std::cout << "  [OK] No usable counter, the system clock is used\n";
+        std::cout << "[PASS] Clock tests passed\n\n";
+        return;
+    }
+
+    TscClock::recalibrate();
+    for (int round = 0; round < 5; ++round) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        int64_t before = systemNs();
+        int64_t now    = tscNs();
+        int64_t after  = systemNs();
+        assert(now > before - kToleranceNs && now < after + kToleranceNs);
+        (void)before;
+        (void)now;
+        (void)after;
+        TscClock::recalibrate();
+    }
+    std::cout << "  [OK] Follows the system clock across calibrations\n";
+
+    int64_t last = tscNs();
+    for (int i = 0; i < 100000; ++i) {
+        int64_t now = tscNs();
+        assert(now >= last && "non-decreasing between calibrations");
+        last = now;
+    }
+    (void)last;
+    std::cout << "  [OK] Non-decreasing\n";
+
+    // readers never see a half-published calibration
+    std::atomic<bool> stop{false};
+    std::thread       calibrator([&stop]() {
+        while (!stop.load()) {
+            TscClock::recalibrate();
+        }
+    });
+    for (int i = 0; i < 200000; ++i) {
+        int64_t before = systemNs();
+        int64_t now    = tscNs();
+        int64_t after  = systemNs();
+        assert(now > before - kToleranceNs && now < after + kToleranceNs);
+        (void)before;
+        (void)now;
+        (void)after;
+    }
+    stop = true;
+    calibrator.join();
+    std::cout << "  [OK] Consistent while recalibrating\n";
+
+    std::cout << "[PASS] Clock tests passed\n\n";
+}
+
+void removeLogs(const char* log_path)
+{
+    for (size_t i = 0; i <= 3; ++i) {
+        std::filesystem::remove(RotatingFileSink::calcFilename(log_path, i));
+    }
+}
+
+bool initClock(const char* log_path, int async_mode, int clock_source)
+{
+    MLoggerOptions options = defaultOptions(log_path, async_mode);
+    options.file_format    = LOG_FILE_BINARY;
+    options.clock_source   = clock_source;
+    return initWithOptions(&options) == 1;
+}
+
+void test_record_times(int async_mode, const char* name)
+{
+    std::cout << "[TEST] Testing record times, " << name << "...\n";
+
+    std::string log_path = std::string("test_logs/test_tsc_clock_") + name + ".mlog";
+    removeLogs(log_path.c_str());
+    bool ok = initClock(log_path.c_str(), async_mode, LOG_CLOCK_TSC);
+    assert(ok);
+    (void)ok;
+
+    const int            count = 2000;
+    std::vector<int64_t> before(count);
+    std::vector<int64_t> after(count);
+    for (int i = 0; i < count; ++i) {
+        before[i] = systemNs();
+        logMessage(LOG_INFO, ("Record " + std::to_string(i)).c_str());
+        after[i] = systemNs();
+    }
+
+    // explicit timestamps are kept as given
+    LogRecord record{};
+    record.timestamp_us = 1700000000123456LL;
+    record.message      = "explicit";
+    record.length       = 8;
+    record.level        = LOG_WARN;
+    int submitted = logBatch(&record, 1);
+    assert(submitted == 1);
+    (void)submitted;
+    terminate();
+
+    std::ifstream               input(log_path, std::ios::binary);
+    BinaryLogReader             reader(input);
+    std::vector<BinaryLogEntry> entries;
+    BinaryLogEntry              entry;
+    while (reader.next(entry)) {
+        entries.push_back(entry);
+    }
+    assert(reader.error().empty() && entries.size() == count + 1);
+
+    for (int i = 0; i < count; ++i) {
+        assert(entries[i].text == "Record " + std::to_string(i));
+        assert(entries[i].time_ns > before[i] - kToleranceNs);
+        assert(entries[i].time_ns < after[i] + kToleranceNs);
+    }
+    assert(entries.back().time_ns == 1700000000123456LL * 1000);
+    std::cout << "  [OK] Stamped within the system clock's bounds\n";
+
+    std::cout << "[PASS] " << name << " record time tests passed\n\n";
+}
+
+void test_invalid_clock()
+{
+    std::cout << "[TEST] Testing clock source validation...\n";
+
+    const char* log_path = "test_logs/test_tsc_clock_invalid.mlog";
+    bool        ok       = initClock(log_path, ASYNC_MODE_OFF, 2);
+    assert(!ok);
+    ok = initClock(log_path, ASYNC_MODE_OFF, -1);
+    assert(!ok);
+    ok = initClock(log_path, ASYNC_MODE_OFF, LOG_CLOCK_SYSTEM);
+    assert(ok);
+    (void)ok;
+    terminate();
+    std::cout << "  [OK] Unknown clock sources rejected\n";
+
+    std::cout << "[PASS] Validation tests passed\n\n";
+}
+
+int main()
+{
+    std::cout << "========================================\n";
+    std::cout << "MLogger TSC Clock Test Suite\n";
+    std::cout << "========================================\n\n";
+
+    std::filesystem::create_directories("test_logs");
+
+    try {
+        test_clock();
+        test_record_times(ASYNC_MODE_OFF, "sync");
+        test_record_times(ASYNC_MODE_THREAD_POOL, "thread_pool");
+        test_record_times(ASYNC_MODE_STAGING, "staging");
+        test_invalid_clock();
+
+        std::cout << "========================================\n";
+        std::cout << "All TSC clock tests passed! [OK]\n";
+        std::cout << "========================================\n";
+
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "\n[FAIL] Test failed with exception: " << e.what() << "\n";
+        terminate();
+        return 1;
+    } catch (...) {
+        std::cerr << "\n[FAIL] Test failed with unknown exception\n";
+        terminate();
+        return 1;
+    }
+}
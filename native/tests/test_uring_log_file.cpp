@@ -0,0 +1,225 @@
+#include "../src/bridge/bridge.h"
+#include "../src/sinks/rotating_file_sink.h"
+#include "../src/sinks/uring_log_file.h"
+#include "test_options.h"
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+bool initUring(const char* log_path, size_t max_file_size, int async_mode, bool direct)
+{
+    MLoggerOptions options = defaultOptions(log_path, async_mode);
+    options.max_file_size  = max_file_size;
+    options.max_files      = 5;
+    options.file_writer    = LOG_WRITER_URING;
+    options.direct_io      = direct ? 1 : 0;
+    return initWithOptions(&options) == 1;
+}
+
+std::string readFile(const std::string& path)
+{
+    std::ifstream      input(path, std::ios::binary);
+    std::ostringstream content;
+    content << input.rdbuf();
+    return content.str();
+}
+
+std::vector<std::string> readLines(const std::string& path)
+{
+    std::ifstream            input(path);
+    std::vector<std::string> lines;
+    std::string              line;
+    while (std::getline(input, line)) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+void removeLogs(const char* log_path)
+{
+    for (size_t i = 0; i <= 5; ++i) {
+        std::filesystem::remove(mlogger::RotatingFileSink::calcFilename(log_path, i));
+    }
+}
+
+void writeText(mlogger::UringLogFile& file, const std::string& text)
+{
+    spdlog::memory_buf_t buffer;
+    buffer.append(text.data(), text.data() + text.size());
+    file.write(buffer);
+}
+
+void test_uring_file(bool direct)
+{
+    const char* mode = direct ? "direct" : "buffered";
+    std::cout << "[TEST] Testing io_uring log file (" << mode << ")...\n";
+
+    const std::string path = std::string("test_logs/test_uring_") + mode + ".log";
+    std::filesystem::remove(path);
+
+    // Test 1: flushed data is in the file, unaligned sizes included
+    mlogger::UringLogFile file(0, direct);
+    file.open(path, true);
+    writeText(file, "first line\n");
+    file.flush();
+    assert(readFile(path).substr(0, 11) == "first line\n");
+    assert(file.size() == 11);
+    std::cout << "  [OK] Flushed data visible\n";
+
+    // Test 2: chunks fill and complete in order, a flush in between rewrites no data
+    std::string expected = "first line\n";
+    for (int i = 0; i < 20000; ++i) {
+        char line[64];
+        snprintf(line, sizeof(line), "uring record %d of a few chunks\n", i);
+        writeText(file, line);
+        expected += line;
+        if (i == 7777) file.flush();
+    }
+    assert(file.size() == expected.size());
+    file.close();
+    assert(readFile(path) == expected);
+    std::cout << "  [OK] " << expected.size() << " bytes written through the ring\n";
+
+    // Test 3: reopening appends after the data, close trims the padding of direct writes
+    file.open(path, false);
+    assert(file.size() == expected.size());
+    writeText(file, "appended line\n");
+    file.close();
+    assert(readFile(path) == expected + "appended line\n");
+    std::cout << "  [OK] Appended after the existing data\n";
+
+    // Test 4: a write larger than every chunk together, past the drop behind window
+    std::string large(9 * 1024 * 1024 + 123, 'u');
+    file.open(path, true);
+    writeText(file, large);
+    file.close();
+    assert(readFile(path) == large);
+    std::cout << "  [OK] Oversized write split over the chunks\n";
+
+    std::cout << "[PASS] io_uring log file tests passed\n\n";
+}
+
+void test_uring_logger(int async_mode, const char* name, bool direct)
+{
+    std::cout << "[TEST] Testing io_uring writer (" << name << (direct ? ", direct" : "")
+              << ")...\n";
+
+    const char* log_path = "test_logs/test_uring_logger.log";
+    removeLogs(log_path);
+    bool ok = initUring(log_path, 64 * 1024, async_mode, direct);
+    assert(ok);
+    (void)ok;
+
+    const int num_logs = 3000;
+    for (int i = 0; i < num_logs; ++i) {
+        char buffer[64];
+        snprintf(buffer, sizeof(buffer), "Uring logger record %d", i);
+        logMessage(LOG_INFO, buffer);
+    }
+    terminate();
+
+    // Test 1: rotation happened, every file within the limit and free of padding
+    assert(std::filesystem::exists(mlogger::RotatingFileSink::calcFilename(log_path, 1)));
+    for (size_t i = 0; i <= 5; ++i) {
+        auto file = mlogger::RotatingFileSink::calcFilename(log_path, i);
+        if (std::filesystem::exists(file)) {
+            assert(std::filesystem::file_size(file) <= 64 * 1024);
+            assert(readFile(file).find('\0') == std::string::npos);
+        }
+    }
+    std::cout << "  [OK] Files rotated within the size limit\n";
+
+    // Test 2: the newest records are intact and in order
+    int last_seq = -1;
+    for (size_t i = 5;; --i) {
+        auto file = mlogger::RotatingFileSink::calcFilename(log_path, i);
+        if (std::filesystem::exists(file)) {
+            for (const auto& line : readLines(file)) {
+                size_t at     = line.find("Uring logger record ");
+                int    seq    = -1;
+                int    parsed = at == std::string::npos
+                                    ? 0
+                                    : sscanf(line.c_str() + at, "Uring logger record %d", &seq);
+                assert(parsed == 1);
+                assert(seq == last_seq + 1 || last_seq == -1);
+                (void)parsed;
+                last_seq = seq;
+            }
+        }
+        if (i == 0) break;
+    }
+    assert(last_seq == num_logs - 1);
+    (void)last_seq;
+    std::cout << "  [OK] Records continuous across files\n";
+
+    std::cout << "[PASS] io_uring writer tests passed\n\n";
+}
+
+void test_uring_fallback()
+{
+    std::cout << "[TEST] Testing io_uring writer fallback...\n";
+
+    // Test 1: the probe and the bridge agree, the other writers are always there
+    bool supported = mlogger::UringLogFile::isSupported();
+    assert(isFileWriterSupported(LOG_WRITER_URING) == (supported ? 1 : 0));
+    assert(isFileWriterSupported(LOG_WRITER_STDIO) == 1);
+    assert(isFileWriterSupported(LOG_WRITER_MAPPED) == 1);
+    assert(isFileWriterSupported(LOG_WRITER_URING + 1) == 0);
+    std::cout << "  [OK] io_uring " << (supported ? "available" : "not available") << "\n";
+
+    // Test 2: the logger writes either way, with stdio when the kernel refuses io_uring
+    const char* log_path = "test_logs/test_uring_fallback.log";
+    removeLogs(log_path);
+    bool ok = initUring(log_path, 1024 * 1024, ASYNC_MODE_THREAD_POOL, true);
+    assert(ok);
+    (void)ok;
+    logMessage(LOG_INFO, "Fallback record");
+    terminate();
+    assert(readFile(log_path).find("Fallback record") != std::string::npos);
+    std::cout << "  [OK] Records written\n";
+
+    std::cout << "[PASS] io_uring writer fallback tests passed\n\n";
+}
+
+int main()
+{
+    std::cout << "========================================\n";
+    std::cout << "MLogger io_uring Log File Test Suite\n";
+    std::cout << "========================================\n\n";
+
+    std::filesystem::create_directories("test_logs");
+
+    try {
+        test_uring_fallback();
+        if (!mlogger::UringLogFile::isSupported()) {
+            std::cout << "[SKIP] io_uring not available here, file tests skipped\n\n";
+        } else {
+            test_uring_file(false);
+            test_uring_file(true);
+            test_uring_logger(ASYNC_MODE_OFF, "sync", false);
+            test_uring_logger(ASYNC_MODE_THREAD_POOL, "thread pool", false);
+            test_uring_logger(ASYNC_MODE_STAGING, "staging", false);
+            test_uring_logger(ASYNC_MODE_THREAD_POOL, "thread pool", true);
+        }
+
+        std::cout << "========================================\n";
+        std::cout << "All io_uring log file tests passed! [OK]\n";
+        std::cout << "========================================\n";
+
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "\n[FAIL] Test failed with exception: " << e.what() << "\n";
+        terminate();
+        return 1;
+    } catch (...) {
+        std::cerr << "\n[FAIL] Test failed with unknown exception\n";
+        terminate();
+        return 1;
+    }
+}
@@ -0,0 +1,229 @@
+#include "../src/bridge/bridge.h"
+#include "../src/sinks/binary_format.h"
+#include "../src/utils/utf16_utils.h"
+#include "test_options.h"
+#include <cassert>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+std::string convert(const std::u16string& text, bool scalar = false, size_t offset = 0)
+{
+    // NOTE: copied to `offset` bytes into the buffer, an odd offset misaligns every unit
+    std::vector<char> buffer(offset + text.size() * 2);
+    std::memcpy(buffer.data() + offset, text.data(), text.size() * 2);
+    spdlog::memory_buf_t dest;
+    dest.append(spdlog::string_view_t("> "));
+    mlogger::appendUtf16AsUtf8(buffer.data() + offset, text.size(), dest, scalar);
+    std::string converted(dest.data(), dest.size());
+    assert(converted.compare(0, 2, "> ") == 0 && "appended after what dest held");
+    return converted.substr(2);
+}
+
+void test_conversion()
+{
+    std::cout << "[TEST] Testing the UTF-16 conversion...\n";
+
+    assert(convert(u"").empty());
+    assert(convert(u"plain ascii") == "plain ascii");
+    assert(convert(u"h\u00e9llo") == "h\xc3\xa9llo");
+    assert(convert(u"\u65e5\u672c\u8a9e") == "\xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e");
+    assert(convert(u"\U0001f600") == "\xf0\x9f\x98\x80" && "surrogate pair");
+    assert(convert(u"\u007f\u0080\u07ff\u0800\uffff") ==
+           "\x7f\xc2\x80\xdf\xbf\xe0\xa0\x80\xef\xbf\xbf");
+    std::cout << "  [OK] One to four bytes per character\n";
+
+    // unpaired surrogates, a high one at the end, a low one alone, a high one before text
+    const std::string replacement = "\xef\xbf\xbd";
+    assert(convert(std::u16string(u"end ") + char16_t(0xd83d)) == "end " + replacement);
+    assert(convert(std::u16string(1, char16_t(0xde00)) + u"x") == replacement + "x");
+    assert(convert(std::u16string(1, char16_t(0xd83d)) + u"ab") == replacement + "ab");
+    assert(convert(std::u16string{char16_t(0xdc00), char16_t(0xd800)}) ==
+           replacement + replacement && "reversed pair");
+    std::cout << "  [OK] Unpaired surrogates become U+FFFD\n";
+
+    // the SIMD blocks agree with the scalar loop at every length, offset and mix
+    std::mt19937                    random(7);
+    const std::vector<char16_t>     alphabet = {u'a', u'Z', u' ', u'\n', u'\u00e9', u'\u4e2d',
+                                                char16_t(0xd83d), char16_t(0xde00)};
+    std::uniform_int_distribution<> pick(0, static_cast<int>(alphabet.size()) - 1);
+    std::uniform_int_distribution<> ascii_only(0, 3);
+    for (size_t length = 0; length < 100; ++length) {
+        for (int mix = 0; mix < 8; ++mix) {
+            std::u16string text;
+            for (size_t i = 0; i < length; ++i) {
+                text += alphabet[mix < 4 ? ascii_only(random) : pick(random)];
+            }
+            std::string expected = convert(text, true);
+            assert(convert(text) == expected);
+            assert(convert(text, false, 1) == expected && "unaligned input");
+        }
+    }
+    std::u16string long_ascii(100000, u'x');
+    long_ascii[77777] = u'\u00e9';
+    assert(convert(long_ascii) == convert(long_ascii, true));
+    std::cout << "  [OK] SIMD and scalar conversion agree\n";
+
+    std::cout << "[PASS] Conversion tests passed\n\n";
+}
+
+const uint16_t* units(const std::u16string& text)
+{
+    return reinterpret_cast<const uint16_t*>(text.data());
+}
+
+int length(const std::u16string& text)
+{
+    return static_cast<int>(text.size());
+}
+
+bool initUtf16(const char* log_path, const char* json_path, int async_mode,
+               int file_format = LOG_FILE_TEXT, int ring_buffer_size = 0)
+{
+    std::filesystem::remove(log_path);
+    if (json_path) std::filesystem::remove(json_path);
+
+    MLoggerOptions options   = defaultOptions(log_path, async_mode);
+    options.min_log_level    = LOG_INFO;
+    options.file_format      = file_format;
+    options.ring_buffer_size = ring_buffer_size;
+    options.json_log_path    = json_path;
+    return initWithOptions(&options) == 1;
+}
+
+std::vector<std::string> readLines(const std::string& path)
+{
+    std::ifstream            input(path, std::ios::binary);
+    std::vector<std::string> lines;
+    std::string              line;
+    while (std::getline(input, line)) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+std::string findLine(const std::vector<std::string>& lines, const std::string& text)
+{
+    for (const auto& line : lines) {
+        if (line.find(text) != std::string::npos) return line;
+    }
+    return "";
+}
+
+void test_utf16_logging(int async_mode, const char* name)
+{
+    std::cout << "[TEST] Testing UTF-16 messages with " << name << "...\n";
+
+    std::string log_path  = std::string("test_logs/test_utf16_") + name + ".log";
+    std::string json_path = std::string("test_logs/test_utf16_") + name + ".jsonl";
+    bool ok = initUtf16(log_path.c_str(), json_path.c_str(), async_mode);
+    assert(ok);
+    (void)ok;
+
+    int channel = createChannel("\xe9\x9f\xb3\xe9\x9f\xbf");
+    assert(channel > 0);
+
+    std::u16string greeting = u"caf\u00e9 \u65e5\u672c \U0001f600 \"quoted\"";
+    logMessageUtf16(LOG_INFO, units(greeting), length(greeting));
+    logMessageUtf16(LOG_DEBUG, units(greeting), length(greeting));
+    std::u16string sized = u"only the first part, not this";
+    logMessageUtf16(LOG_WARN, units(sized), 14);
+    std::u16string on_channel = u"\u4e2d\u6587 on a channel";
+    logChannelUtf16(channel, LOG_ERROR, units(on_channel), length(on_channel));
+    logMessageUtf16(LOG_INFO, units(greeting), 0);
+    logMessageUtf16(LOG_INFO, nullptr, 5);
+    logMessageUtf16(LOG_INFO, units(greeting), -1);
+    flush();
+    terminate();
+
+    std::vector<std::string> lines = readLines(log_path);
+    assert(lines.size() == 4 && "debug, null and negative lengths skipped, the empty one kept");
+    assert(findLine(lines, "[info]").find("caf\xc3\xa9 \xe6\x97\xa5\xe6\x9c\xac \xf0\x9f\x98\x80")
+           != std::string::npos);
+    assert(findLine(lines, "[warning]").find("only the first") != std::string::npos);
+    assert(findLine(lines, "not this").empty() && "length honoured");
+    std::string channel_line = findLine(lines, "[error]");
+    assert(channel_line.find("[\xe9\x9f\xb3\xe9\x9f\xbf]") != std::string::npos);
+    assert(channel_line.find("\xe4\xb8\xad\xe6\x96\x87 on a channel") != std::string::npos);
+    std::cout << "  [OK] Text file holds UTF-8\n";
+
+    std::vector<std::string> json = readLines(json_path);
+    assert(json.size() == 4);
+    assert(findLine(json, "caf\xc3\xa9").find("\\\"quoted\\\"") != std::string::npos);
+    std::cout << "  [OK] JSON-lines file holds escaped UTF-8\n";
+
+    std::cout << "[PASS] " << name << " UTF-16 tests passed\n\n";
+}
+
+void test_utf16_ring_and_binary()
+{
+    std::cout << "[TEST] Testing UTF-16 messages in the ring and binary files...\n";
+
+    const char* log_path  = "test_logs/test_utf16.bin.log";
+    const char* dump_path = "test_logs/test_utf16.dump.log";
+    bool ok = initUtf16(log_path, nullptr, ASYNC_MODE_OFF, LOG_FILE_BINARY, 64 * 1024);
+    assert(ok);
+    (void)ok;
+
+    std::u16string message = u"na\u00efve r\u00e9sum\u00e9";
+    logMessageUtf16(LOG_TRACE, units(message), length(message));
+    logMessageUtf16(LOG_INFO, units(message), length(message));
+    int result = dumpRing(dump_path);
+    assert(result == 1);
+    (void)result;
+    terminate();
+
+    std::vector<std::string> dump = readLines(dump_path);
+    const std::string        utf8 = "na\xc3\xafve r\xc3\xa9sum\xc3\xa9";
+    assert(findLine(dump, "[trace]").find(utf8) != std::string::npos);
+    assert(findLine(dump, "[info]").find(utf8) != std::string::npos);
+    std::cout << "  [OK] Ring keeps UTF-8 of every level\n";
+
+    std::ifstream            input(log_path, std::ios::binary);
+    mlogger::BinaryLogReader reader(input);
+    mlogger::BinaryLogEntry  entry;
+    std::vector<std::string> texts;
+    while (reader.next(entry)) {
+        texts.push_back(entry.text);
+    }
+    assert(reader.error().empty());
+    assert(texts.size() == 1 && texts[0] == utf8);
+    std::cout << "  [OK] Binary file stores UTF-8 text\n";
+
+    std::cout << "[PASS] Ring and binary tests passed\n\n";
+}
+
+int main()
+{
+    std::cout << "========================================\n";
+    std::cout << "MLogger UTF-16 Test Suite\n";
+    std::cout << "========================================\n\n";
+
+    std::filesystem::create_directories("test_logs");
+
+    try {
+        test_conversion();
+        test_utf16_logging(ASYNC_MODE_OFF, "sync");
+        test_utf16_logging(ASYNC_MODE_THREAD_POOL, "thread_pool");
+        test_utf16_logging(ASYNC_MODE_STAGING, "staging");
+        test_utf16_ring_and_binary();
+
+        std::cout << "========================================\n";
+        std::cout << "All UTF-16 tests passed! [OK]\n";
+        std::cout << "========================================\n";
+
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "\n[FAIL] Test failed with exception: " << e.what() << "\n";
+        terminate();
+        return 1;
+    } catch (...) {
+        std::cerr << "\n[FAIL] Test failed with unknown exception\n";
+        terminate();
+        return 1;
+    }
+}
@@ -0,0 +1,342 @@
+// Writes what every process logging with LoggerConfig::shared_memory_name publishes to one shared
+// memory segment into a single set of rotating files, see sinks/shared_memory_sink.h.
+//
+//   mlogger_aggregate [options] <segment> <log path>
+//
+//   --max-size <bytes>     rotation size, default 10MB
+//   --max-files <count>    files kept, default 5
+//   --binary               binary records, read them with mlogger_decode
+//   --json <path>          also one JSON object per record
+//   --compress gzip|zstd   compress rotated files
+//   --capacity <bytes>     ring size if the segment is created here, default 4MB
+//   --pid                  append ":<process id>" to the logger name of every record
+//   --remove               delete the segment's name on exit
+//
+// Runs until interrupted, then writes what is left and closes the files. Records the processes
+// dropped while the ring was full, and those lost with a process that died while publishing,
+// are reported in the log.
+
+#include "core/deferred_format.h"
+#include "sinks/binary_file_sink.h"
+#include "sinks/json_lines_sink.h"
+#include "sinks/rotating_file_sink.h"
+#include "sinks/shared_memory_sink.h"
+#include "utils/path_utils.h"
+#include "utils/shared_ring.h"
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+// NOTE: a full ring of the default size takes a couple of milliseconds to fill at most rates
+constexpr auto   kIdleWait      = std::chrono::milliseconds(2);
+constexpr auto   kFlushInterval = std::chrono::seconds(1);
+constexpr size_t kFlushBytes    = 64 * 1024;
+constexpr int    kIndexLines    = 1024;
+// records written between looks at the loss counters and the flush timer
+constexpr size_t kBatchRecords = 4096;
+// NOTE: the logger name of the notices, the default logger's
+constexpr char kNoticeLogger[] = "mlogger";
+
+volatile std::sig_atomic_t g_stop = 0;
+
+void onSignal(int)
+{
+    g_stop = 1;
+}
+
+struct Output {
+    std::vector<std::shared_ptr<mlogger::RotatingFileSink>> sinks;
+    bool                                                    pid_names = false;
+    bool                                                    dirty     = false;
+    std::string                                             name;      // with the process id
+    spdlog::memory_buf_t                                    payload;   // re-encoded format
+};
+
+void printUsage(const char* program)
+{
+    std::cerr << "usage: " << program
+              << " [--max-size <bytes>] [--max-files <count>] [--binary] [--json <path>]"
+                 " [--compress gzip|zstd] [--capacity <bytes>] [--pid] [--remove]"
+                 " <segment> <log path>\n";
+}
+
+bool parseSize(const char* text, size_t& value)
+{
+    char*              end    = nullptr;
+    unsigned long long parsed = std::strtoull(text, &end, 10);
+    if (end == text || *end != '\0' || parsed == 0) {
+        return false;
+    }
+    value = static_cast<size_t>(parsed);
+    return true;
+}
+
+void writeMessage(Output& output, const spdlog::details::log_msg& msg)
+{
+    for (const auto& sink : output.sinks) {
+        sink->log(msg);
+    }
+    if (msg.level == spdlog::level::critical) {
+        for (const auto& sink : output.sinks) {
+            sink->flush();
+        }
+    } else {
+        output.dirty = true;
+    }
+}
+
+void writeRecord(Output& output, const mlogger::SharedRecord& record)
+{
+    spdlog::string_view_t logger_name = record.logger_name;
+    if (output.pid_names) {
+        output.name.assign(record.logger_name.data(), record.logger_name.size());
+        output.name += ':';
+        output.name += std::to_string(record.process_id);
+        logger_name = output.name;
+    }
+
+    // NOTE: format ids are per process, the format is registered again here so binary files
+    // keep it and its arguments
+    const char*           tag     = record.payload_tag;
+    spdlog::string_view_t payload = record.payload;
+    if (tag == mlogger::kFormattedTag) {
+        std::string format(record.format.data(), record.format.size());
+        int         id = mlogger::FormatRegistry::getInstance().registerFormat(format.c_str());
+        output.payload.clear();
+        if (id >= 0) {
+            uint32_t format_id = static_cast<uint32_t>(id);
+            output.payload.append(reinterpret_cast<const char*>(&format_id),
+                                  reinterpret_cast<const char*>(&format_id) + sizeof(format_id));
+            output.payload.append(record.payload);
+        } else {
+            mlogger::formatArguments(record.format, record.payload.data(), record.payload.size(),
+                                     output.payload);
+            tag = nullptr;
+        }
+        payload = spdlog::string_view_t(output.payload.data(), output.payload.size());
+    }
+
+    auto time = spdlog::log_clock::time_point(
+        std::chrono::duration_cast<spdlog::log_clock::duration>(
+            std::chrono::nanoseconds(record.time_ns)));
+    spdlog::source_loc source;
+    source.funcname = tag;
+    spdlog::details::log_msg msg(time, source, logger_name,
+                                 static_cast<spdlog::level::level_enum>(record.level), payload);
+    msg.thread_id = static_cast<size_t>(record.thread_id);
+    writeMessage(output, msg);
+}
+
+void writeNotice(Output& output, const std::string& text)
+{
+    spdlog::details::log_msg msg(spdlog::log_clock::now(), spdlog::source_loc{}, kNoticeLogger,
+                                 spdlog::level::warn, text);
+    writeMessage(output, msg);
+}
+
+// records written, at most kBatchRecords
+size_t drain(mlogger::SharedRing& ring, Output& output)
+{
+    size_t                written = 0;
+    size_t                size    = 0;
+    mlogger::SharedRecord record;
+    while (written < kBatchRecords) {
+        const void* data = ring.front(&size);
+        if (!data) {
+            break;
+        }
+        if (mlogger::SharedMemorySink::decodeRecord(data, size, record)) {
+            writeRecord(output, record);
+        } else {
+            std::cerr << "malformed record of " << size << " bytes skipped\n";
+        }
+        ring.pop();
+        ++written;
+    }
+    return written;
+}
+
+void reportLosses(mlogger::SharedRing& ring, Output& output, uint64_t& dropped, uint64_t& skipped)
+{
+    uint64_t now_dropped = ring.droppedCount();
+    if (now_dropped != dropped) {
+        writeNotice(output, std::to_string(now_dropped - dropped) +
+                                " records dropped, the shared memory ring was full");
+        dropped = now_dropped;
+    }
+    uint64_t now_skipped = ring.skippedBytes();
+    if (now_skipped != skipped) {
+        writeNotice(output, std::to_string(now_skipped - skipped) +
+                                " bytes of records skipped, a process died or stalled while logging");
+        skipped = now_skipped;
+    }
+}
+
+void flushIfDirty(Output& output)
+{
+    if (!output.dirty) {
+        return;
+    }
+    for (const auto& sink : output.sinks) {
+        sink->flushIfDirty();
+    }
+    output.dirty = false;
+}
+
+}   // namespace
+
+int main(int argc, char** argv)
+{
+    size_t                   max_size  = 10 * 1024 * 1024;
+    size_t                   max_files = 5;
+    size_t                   capacity  = 4 * 1024 * 1024;
+    bool                     binary = false, remove = false;
+    std::string              json_path;
+    mlogger::Compression     compression = mlogger::Compression::none;
+    Output                   output;
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; ++i) {
+        bool has_value = i + 1 < argc;
+        if (std::strcmp(argv[i], "--max-size") == 0 && has_value) {
+            if (!parseSize(argv[++i], max_size)) {
+                std::cerr << "invalid --max-size\n";
+                return 2;
+            }
+        } else if (std::strcmp(argv[i], "--max-files") == 0 && has_value) {
+            if (!parseSize(argv[++i], max_files)) {
+                std::cerr << "invalid --max-files\n";
+                return 2;
+            }
+        } else if (std::strcmp(argv[i], "--capacity") == 0 && has_value) {
+            if (!parseSize(argv[++i], capacity)) {
+                std::cerr << "invalid --capacity\n";
+                return 2;
+            }
+        } else if (std::strcmp(argv[i], "--json") == 0 && has_value) {
+            json_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--compress") == 0 && has_value) {
+            ++i;
+            if (std::strcmp(argv[i], "gzip") == 0) {
+                compression = mlogger::Compression::gzip;
+            } else if (std::strcmp(argv[i], "zstd") == 0) {
+                compression = mlogger::Compression::zstd;
+            } else {
+                std::cerr << "--compress takes gzip or zstd\n";
+                return 2;
+            }
+            if (!mlogger::LogCompressor::isAvailable(compression)) {
+                std::cerr << argv[i] << " is not built in\n";
+                return 2;
+            }
+        } else if (std::strcmp(argv[i], "--binary") == 0) {
+            binary = true;
+        } else if (std::strcmp(argv[i], "--pid") == 0) {
+            output.pid_names = true;
+        } else if (std::strcmp(argv[i], "--remove") == 0) {
+            remove = true;
+        } else if (std::strcmp(argv[i], "--help") == 0 || std::strcmp(argv[i], "-h") == 0) {
+            printUsage(argv[0]);
+            return 0;
+        } else {
+            positional.push_back(argv[i]);
+        }
+    }
+    if (positional.size() != 2) {
+        printUsage(argv[0]);
+        return 2;
+    }
+    const std::string& segment  = positional[0];
+    const std::string& log_path = positional[1];
+
+    std::string                          error;
+    std::unique_ptr<mlogger::SharedRing> ring = mlogger::SharedRing::open(segment, capacity, error);
+    if (!ring) {
+        std::cerr << segment << ": " << error << "\n";
+        return 1;
+    }
+
+    try {
+        if (!mlogger::ensureDirectoryExists(log_path) ||
+            (!json_path.empty() && !mlogger::ensureDirectoryExists(json_path))) {
+            std::cerr << "cannot create the log directory\n";
+            return 1;
+        }
+        auto report = [](const char* message) { std::cerr << "compression: " << message << "\n"; };
+        std::shared_ptr<mlogger::RotatingFileSink> file_sink;
+        if (binary) {
+            file_sink = std::make_shared<mlogger::BinaryFileSink>(
+                log_path, max_size, max_files,
+                std::make_unique<mlogger::StdioLogFile>(kFlushBytes));
+        } else {
+            file_sink = std::make_shared<mlogger::RotatingFileSink>(
+                log_path, max_size, max_files,
+                std::make_unique<mlogger::StdioLogFile>(kFlushBytes));
+            file_sink->setIndex(kIndexLines);
+        }
+        if (compression != mlogger::Compression::none) {
+            file_sink->setCompression(compression, report);
+        }
+        output.sinks.push_back(file_sink);
+        if (!json_path.empty()) {
+            auto json_sink = std::make_shared<mlogger::JsonLinesSink>(
+                json_path, max_size, max_files,
+                std::make_unique<mlogger::StdioLogFile>(kFlushBytes));
+            if (compression != mlogger::Compression::none) {
+                json_sink->setCompression(compression, report);
+            }
+            output.sinks.push_back(json_sink);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << log_path << ": " << e.what() << "\n";
+        return 1;
+    }
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    // NOTE: losses from before this run were reported by the aggregator running then
+    uint64_t dropped    = ring->droppedCount();
+    uint64_t skipped    = ring->skippedBytes();
+    auto     last_flush = std::chrono::steady_clock::now();
+    int      result     = 0;
+    ring->setReaderAttached(true);
+    try {
+        while (!g_stop) {
+            size_t written = drain(*ring, output);
+            reportLosses(*ring, output, dropped, skipped);
+
+            // idle rings flush at once, so a writer's flush() does not wait for the interval
+            auto now = std::chrono::steady_clock::now();
+            if (written == 0 || now - last_flush >= kFlushInterval) {
+                flushIfDirty(output);
+                last_flush = now;
+            }
+            if (written == 0) {
+                std::this_thread::sleep_for(kIdleWait);
+            }
+        }
+        while (drain(*ring, output) > 0) {
+        }
+        reportLosses(*ring, output, dropped, skipped);
+        for (const auto& sink : output.sinks) {
+            sink->flush();
+        }
+    } catch (const std::exception& e) {
+        std::cerr << log_path << ": " << e.what() << "\n";
+        result = 1;
+    }
+    ring->setReaderAttached(false);
+
+    output.sinks.clear();
+    if (remove) mlogger::SharedRing::remove(segment);
+    return result;
+}
@@ -0,0 +1,201 @@
+// Receives the records NetworkSink ships and writes them to stdout as the text file has them.
+//
+//   mlogger_collect [--udp] [--tcp] [--prefix] <host:port>
+//
+// Listens on both protocols unless one is given; ":9999" listens on every interface. With
+// --prefix every line starts with the session id of its sender, so the output of many devices
+// can be told apart. Frames lost on the way are reported on stderr.
+
+#include "sinks/network_sink.h"
+#include "utils/socket_utils.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+struct Client {
+    mlogger::SocketHandle socket = mlogger::kInvalidSocket;
+    std::string           pending;   // received bytes not forming a whole frame yet
+};
+
+// next sequence expected per session
+std::map<uint32_t, uint32_t> g_sessions;
+
+void printUsage(const char* program)
+{
+    std::cerr << "usage: " << program << " [--udp] [--tcp] [--prefix] <host:port>\n";
+}
+
+void writeFrame(const mlogger::NetworkFrame& frame, bool prefix)
+{
+    auto found = g_sessions.find(frame.session);
+    if (found != g_sessions.end() && frame.sequence != found->second) {
+        std::cerr << "session " << std::hex << frame.session << std::dec << ": "
+                  << (frame.sequence - found->second) << " frames lost\n";
+    }
+    g_sessions[frame.session] = frame.sequence + 1;
+
+    if (!prefix) {
+        std::cout.write(frame.text.data(), static_cast<std::streamsize>(frame.text.size()));
+        return;
+    }
+    char tag[16];
+    std::snprintf(tag, sizeof(tag), "[%08x] ", frame.session);
+    size_t start = 0;
+    while (start < frame.text.size()) {
+        size_t end = frame.text.find('\n', start);
+        end        = end == std::string::npos ? frame.text.size() : end + 1;
+        std::cout << tag;
+        std::cout.write(frame.text.data() + start, static_cast<std::streamsize>(end - start));
+        start = end;
+    }
+}
+
+// reads every datagram waiting, true when there was one
+bool readDatagrams(mlogger::SocketHandle socket, std::vector<char>& buffer, bool prefix)
+{
+    bool                 any = false;
+    mlogger::NetworkFrame frame;
+    std::string          error;
+    for (;;) {
+        long received = mlogger::receiveSocket(socket, buffer.data(), buffer.size());
+        if (received <= 0) {
+            return any;
+        }
+        any = true;
+        if (mlogger::NetworkSink::decodeFrame(buffer.data(), static_cast<size_t>(received), frame,
+                                              &error) > 0) {
+            writeFrame(frame, prefix);
+        } else {
+            std::cerr << "datagram dropped: " << (error.empty() ? "truncated frame" : error)
+                      << "\n";
+        }
+    }
+}
+
+// reads what a TCP client sent, false once it is gone
+bool readStream(Client& client, std::vector<char>& buffer, bool prefix)
+{
+    // NOTE: the frames a client sent before it closed are still written
+    bool open = true;
+    for (;;) {
+        long received = mlogger::receiveSocket(client.socket, buffer.data(), buffer.size());
+        if (received == mlogger::kSocketWouldBlock) {
+            break;
+        }
+        if (received <= 0) {
+            open = false;
+            break;
+        }
+        client.pending.append(buffer.data(), static_cast<size_t>(received));
+    }
+
+    mlogger::NetworkFrame frame;
+    std::string           error;
+    size_t                offset = 0;
+    for (;;) {
+        long used = mlogger::NetworkSink::decodeFrame(client.pending.data() + offset,
+                                                      client.pending.size() - offset, frame,
+                                                      &error);
+        if (used < 0) {
+            std::cerr << "connection dropped: " << error << "\n";
+            return false;
+        }
+        if (used == 0) break;
+        writeFrame(frame, prefix);
+        offset += static_cast<size_t>(used);
+    }
+    client.pending.erase(0, offset);
+    return open;
+}
+
+}   // namespace
+
+int main(int argc, char** argv)
+{
+    bool        udp = false, tcp = false, prefix = false;
+    std::string address;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--udp") == 0) {
+            udp = true;
+        } else if (std::strcmp(argv[i], "--tcp") == 0) {
+            tcp = true;
+        } else if (std::strcmp(argv[i], "--prefix") == 0) {
+            prefix = true;
+        } else if (std::strcmp(argv[i], "--help") == 0 || std::strcmp(argv[i], "-h") == 0) {
+            printUsage(argv[0]);
+            return 0;
+        } else {
+            address = argv[i];
+        }
+    }
+    if (address.empty()) {
+        printUsage(argv[0]);
+        return 2;
+    }
+    if (!udp && !tcp) {
+        udp = tcp = true;
+    }
+
+    std::string           error;
+    mlogger::SocketHandle datagrams = mlogger::kInvalidSocket;
+    mlogger::SocketHandle listener  = mlogger::kInvalidSocket;
+    if (udp) {
+        datagrams = mlogger::listenSocket(address, mlogger::SocketType::udp, error);
+        if (datagrams == mlogger::kInvalidSocket) {
+            std::cerr << "udp: " << error << "\n";
+            return 1;
+        }
+    }
+    if (tcp) {
+        listener = mlogger::listenSocket(address, mlogger::SocketType::tcp, error);
+        if (listener == mlogger::kInvalidSocket) {
+            std::cerr << "tcp: " << error << "\n";
+            return 1;
+        }
+    }
+
+    // NOTE: polls every socket in turn and naps when all were idle, plenty for a handful of
+    // devices
+    std::vector<char>   buffer(64 * 1024);
+    std::vector<Client> clients;
+    for (;;) {
+        bool busy = false;
+        if (datagrams != mlogger::kInvalidSocket) {
+            busy = readDatagrams(datagrams, buffer, prefix) || busy;
+        }
+        if (listener != mlogger::kInvalidSocket) {
+            for (mlogger::SocketHandle accepted = mlogger::acceptSocket(listener);
+                 accepted != mlogger::kInvalidSocket;
+                 accepted = mlogger::acceptSocket(listener)) {
+                clients.push_back(Client{accepted, std::string()});
+                busy = true;
+            }
+        }
+        for (size_t i = 0; i < clients.size();) {
+            if (mlogger::waitSocket(clients[i].socket, false, 0) != 1) {
+                ++i;
+                continue;
+            }
+            busy = true;
+            if (readStream(clients[i], buffer, prefix)) {
+                ++i;
+                continue;
+            }
+            mlogger::closeSocket(clients[i].socket);
+            clients.erase(clients.begin() + static_cast<std::ptrdiff_t>(i));
+        }
+
+        std::cout.flush();
+        if (!busy) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+}
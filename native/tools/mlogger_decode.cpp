@@ -0,0 +1,124 @@
+// Turns binary MLogger files back into the text the rotating text sink would have written.
+//
+//   mlogger_decode [--pattern <spdlog pattern>] <file>...
+//
+// Files are decoded in the order given and written to stdout.
+
+#include "core/deferred_format.h"
+#include "sinks/binary_format.h"
+#include "sinks/log_compressor.h"
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <spdlog/details/log_msg.h>
+#include <spdlog/pattern_formatter.h>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+void printUsage(const char* program)
+{
+    std::cerr << "usage: " << program << " [--pattern <spdlog pattern>] <file>...\n";
+}
+
+bool endsWith(const std::string& text, const char* suffix)
+{
+    size_t length = std::strlen(suffix);
+    return text.size() >= length && text.compare(text.size() - length, length, suffix) == 0;
+}
+
+bool decodeFile(const char* path, spdlog::formatter& formatter)
+{
+    // rotated files compressed by LogCompressor are inflated in memory first
+    std::unique_ptr<std::istream> input;
+    if (endsWith(path, ".gz") || endsWith(path, ".zst")) {
+        std::string data, error;
+        if (!mlogger::LogCompressor::decompressFile(path, data, &error)) {
+            std::cerr << path << ": " << error << "\n";
+            return false;
+        }
+        input = std::make_unique<std::istringstream>(std::move(data));
+    } else {
+        auto file = std::make_unique<std::ifstream>(path, std::ios::binary);
+        if (!file->is_open()) {
+            std::cerr << path << ": cannot open file\n";
+            return false;
+        }
+        input = std::move(file);
+    }
+
+    mlogger::BinaryLogReader reader(*input);
+    mlogger::BinaryLogEntry  entry;
+    spdlog::memory_buf_t     line;
+    spdlog::memory_buf_t     text;
+    while (reader.next(entry)) {
+        // entries with arguments carry the format they were logged with
+        text.clear();
+        if (entry.arguments.empty()) {
+            text.append(entry.text.data(), entry.text.data() + entry.text.size());
+        } else {
+            mlogger::formatArguments(entry.text,
+                                     reinterpret_cast<const char*>(entry.arguments.data()),
+                                     entry.arguments.size(),
+                                     text);
+        }
+
+        auto time = spdlog::log_clock::time_point(
+            std::chrono::duration_cast<spdlog::log_clock::duration>(
+                std::chrono::nanoseconds(entry.time_ns)));
+        spdlog::details::log_msg msg(time,
+                                     spdlog::source_loc{},
+                                     entry.logger_name,
+                                     static_cast<spdlog::level::level_enum>(entry.level),
+                                     spdlog::string_view_t(text.data(), text.size()));
+        msg.thread_id = static_cast<size_t>(entry.thread_id);
+
+        line.clear();
+        formatter.format(msg, line);
+        std::cout.write(line.data(), static_cast<std::streamsize>(line.size()));
+    }
+
+    if (!reader.error().empty()) {
+        std::cerr << path << ": " << reader.error() << "\n";
+        return false;
+    }
+    return true;
+}
+
+}   // namespace
+
+int main(int argc, char** argv)
+{
+    std::string              pattern;
+    std::vector<const char*> files;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--pattern") == 0 && i + 1 < argc) {
+            pattern = argv[++i];
+        } else if (std::strcmp(argv[i], "--help") == 0 || std::strcmp(argv[i], "-h") == 0) {
+            printUsage(argv[0]);
+            return 0;
+        } else {
+            files.push_back(argv[i]);
+        }
+    }
+
+    if (files.empty()) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    // same default pattern as the text sink
+    auto formatter = pattern.empty() ? std::make_unique<spdlog::pattern_formatter>()
+                                     : std::make_unique<spdlog::pattern_formatter>(pattern);
+
+    bool ok = true;
+    for (const char* file : files) {
+        ok = decodeFile(file, *formatter) && ok;
+    }
+    return ok ? 0 : 1;
+}
@@ -61,6 +61,29 @@ ENHANCED_TESTS = [
     "test_error_handling",
     "test_stress",
     "test_memory",
+    "test_contention",
+    "test_staging",
+    "test_binary_log",
+    "test_mapped_file",
+    "test_ring_buffer",
+    "test_stats",
+    "test_compression",
+    "test_channels",
+    "test_structured",
+    "test_formatted",
+    "test_log_index",
+    "test_live_tail",
+    "test_log_search",
+    "test_frontend",
+    "test_tsc_clock",
+    "test_reconfigure",
+    "test_lazy_init",
+    "test_thread_options",
+    "test_message_filter",
+    "test_uring_log_file",
+    "test_network_sink",
+    "test_utf16",
+    "test_shared_memory",
 ]
 
 
@@ -190,6 +213,7 @@ def configure_cmake(
     builder: "PlatformBuilder",
     verbose: bool = False,
     clean: bool = False,
+    bench: bool = False,
     **kwargs,
 ):
     _print_section(f"[STEP 1/4] CONFIGURE - Configuring CMake for {platform}-{arch}")
@@ -219,6 +243,8 @@ def configure_cmake(
     args.extend(cmake_args)
     args.append("-DCMAKE_BUILD_TYPE=Release")
     args.append("-DBUILD_TESTS=ON")
+    if bench:
+        args.append("-DBUILD_BENCH=ON")
 
     if verbose:
         print(f"CMake command: cmake {' '.join(args)}")
@@ -363,6 +389,31 @@ def run_tests(
     print(f"[PASS] [STEP 3/4] All tests passed for {platform}-{arch}")
 
 
+def run_bench(platform: str, arch: str, builder: "PlatformBuilder", verbose: bool = False):
+    if not builder.can_run_tests():
+        _print_section(f"[BENCH] Skipping benchmark for {platform} (cannot run executables)")
+        return
+
+    _print_section(f"[BENCH] Running mlogger_bench for {platform}-{arch}")
+
+    bench_path = builder.build_dir / "bin" / f"mlogger_bench{builder.get_executable_extension()}"
+    if not bench_path.exists():
+        raise FileNotFoundError(f"Benchmark executable not found: {bench_path}")
+
+    result_path = builder.build_dir / "mlogger_bench.json"
+    try:
+        subprocess.run(
+            [str(bench_path), "--out", str(result_path)],
+            check=True,
+            cwd=builder.build_dir,
+            stderr=None if verbose else subprocess.DEVNULL,
+        )
+        print(f"[PASS] [BENCH] Results written to {result_path}")
+    except subprocess.CalledProcessError:
+        print("[FAIL] [BENCH] mlogger_bench failed")
+        raise
+
+
 def _find_library_path(
     build_dir: Path, library_name: str, platform: str, builder: "PlatformBuilder"
 ) -> Path:
@@ -470,6 +521,11 @@ def main():
         type=str,
         help="Run only tests matching the filter string (case-insensitive)",
     )
+    parser.add_argument(
+        "--bench",
+        action="store_true",
+        help="Build and run mlogger_bench, results go to mlogger_bench.json in the build directory",
+    )
     parser.add_argument("--skip-copy", action="store_true", help="Skip copying to Unity")
     parser.add_argument("--generator", type=str, help="CMake generator (Windows only)")
     parser.add_argument(
@@ -510,7 +566,9 @@ def main():
         kwargs["ios_sdk"] = args.ios_sdk
 
     try:
-        configure_cmake(args.platform, args.arch, builder, args.verbose, args.clean, **kwargs)
+        configure_cmake(
+            args.platform, args.arch, builder, args.verbose, args.clean, args.bench, **kwargs
+        )
         build_project(args.platform, args.arch, builder, args.verbose)
 
         if not args.skip_tests:
@@ -524,6 +582,9 @@ def main():
         else:
             _print_section("[SKIP] Tests skipped")
 
+        if args.bench:
+            run_bench(args.platform, args.arch, builder, args.verbose)
+
         if not args.skip_copy:
             copy_library_to_unity(args.platform, args.arch, builder, args.verbose)
         else:
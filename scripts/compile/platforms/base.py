@@ -29,6 +29,29 @@ class PlatformBuilder(ABC):
             "test_error_handling",
             "test_stress",
             "test_memory",
+            "test_contention",
+            "test_staging",
+            "test_binary_log",
+            "test_mapped_file",
+            "test_ring_buffer",
+            "test_stats",
+            "test_compression",
+            "test_channels",
+            "test_structured",
+            "test_formatted",
+            "test_log_index",
+            "test_live_tail",
+            "test_log_search",
+            "test_frontend",
+            "test_tsc_clock",
+            "test_reconfigure",
+            "test_lazy_init",
+            "test_thread_options",
+            "test_message_filter",
+            "test_uring_log_file",
+            "test_network_sink",
+            "test_utf16",
+            "test_shared_memory",
         ]
 
     def get_executable_extension(self) -> str:
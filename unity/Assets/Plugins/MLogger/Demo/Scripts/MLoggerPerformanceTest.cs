@@ -203,7 +203,7 @@ private PerformanceTestResult TestMLogger()
                 {
                     var sw = Stopwatch.StartNew();
                     var message = string.Format(messageTemplate, i, UnityEngine.Random.Range(0, 1000));
-                    MLoggerNative.logMessage((int)LogLevel.Info, message);
+                    MLoggerNative.logMessageUtf16((int)LogLevel.Info, message, message.Length);
                     sw.Stop();
                     times.Add(sw.ElapsedTicks);
                 }
@@ -0,0 +1,165 @@
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Text;
+
+namespace MLogger.Editor
+{
+    /// <summary>
+    /// Reader for the "&lt;log file&gt;.idx" sidecar the native sink keeps next to every text log file
+    /// (native/src/sinks/log_index.h). Each block summarizes a run of lines with its byte range, time range and
+    /// records per level, so statistics and the tail of a file are available without reading it all. Bytes no
+    /// block covers, such as the records written since the running process finished its last block, are
+    /// returned as gaps for the caller to scan.
+    /// </summary>
+    internal sealed class MLoggerLogIndex
+    {
+        private const int HeaderSize = 16;
+        private const int BlockSize = 64;
+        private const uint Version = 1;
+        private static readonly byte[] Magic = Encoding.ASCII.GetBytes("MLOGIDX\0");
+
+        public struct Block
+        {
+            public long Offset;
+            public long Size;
+            public long FirstTimeNs;
+            public long LastTimeNs;
+            public int Lines;
+            public int Records;
+            public int[] LevelCounts;
+
+            public bool HasAnyLevel(Func<LogLevel, bool> enabled)
+            {
+                for (var i = 0; i < LevelCounts.Length; i++)
+                {
+                    if (LevelCounts[i] > 0 && enabled((LogLevel)i))
+                        return true;
+                }
+                return false;
+            }
+        }
+
+        /// <summary>A byte range of the log file, summarized by <see cref="Block"/> unless it is a gap.</summary>
+        public readonly struct Segment
+        {
+            public readonly long Offset;
+            public readonly long Size;
+            public readonly int BlockIndex;   // -1 for a gap
+
+            public Segment(long offset, long size, int blockIndex)
+            {
+                Offset = offset;
+                Size = size;
+                BlockIndex = blockIndex;
+            }
+        }
+
+        public readonly List<Block> Blocks = new();
+
+        public static string GetIndexPath(string logPath) => logPath + ".idx";
+
+        /// <summary>
+        /// Loads the index of <paramref name="logPath"/>, null when there is none or it does not belong to the file.
+        /// </summary>
+        public static MLoggerLogIndex TryLoad(string logPath, long logLength)
+        {
+            var indexPath = GetIndexPath(logPath);
+            if (!File.Exists(indexPath))
+                return null;
+
+            try
+            {
+                // NOTE: the native sink keeps the index open for appending while the file is viewed
+                using var stream = new FileStream(indexPath, FileMode.Open, FileAccess.Read, FileShare.ReadWrite);
+                using var reader = new BinaryReader(stream);
+
+                var header = reader.ReadBytes(HeaderSize);
+                if (header.Length < HeaderSize || BitConverter.ToUInt32(header, 8) != Version)
+                    return null;
+                for (var i = 0; i < Magic.Length; i++)
+                {
+                    if (header[i] != Magic[i])
+                        return null;
+                }
+
+                var index = new MLoggerLogIndex();
+                var blockCount = (stream.Length - HeaderSize) / BlockSize;
+                for (long i = 0; i < blockCount; i++)
+                {
+                    var block = new Block
+                    {
+                        Offset = reader.ReadInt64(),
+                        Size = reader.ReadInt64(),
+                        FirstTimeNs = reader.ReadInt64(),
+                        LastTimeNs = reader.ReadInt64(),
+                        Lines = reader.ReadInt32(),
+                        Records = reader.ReadInt32(),
+                        LevelCounts = new int[6]
+                    };
+                    for (var level = 0; level < block.LevelCounts.Length; level++)
+                        block.LevelCounts[level] = reader.ReadInt32();
+
+                    // a file truncated or replaced behind the index's back
+                    if (block.Offset + block.Size > logLength)
+                        return null;
+                    index.Blocks.Add(block);
+                }
+
+                return BitConverter.IsLittleEndian ? index : null;
+            }
+            catch (IOException)
+            {
+                return null;
+            }
+        }
+
+        /// <summary>
+        /// The whole file as blocks and the gaps between them, in file order.
+        /// </summary>
+        public List<Segment> GetSegments(long logLength)
+        {
+            var segments = new List<Segment>(Blocks.Count + 1);
+            var position = 0L;
+            for (var i = 0; i < Blocks.Count; i++)
+            {
+                var block = Blocks[i];
+                if (block.Offset < position)
+                    continue;   // overlaps an earlier block, treat like a gap
+                if (block.Offset > position)
+                    segments.Add(new Segment(position, block.Offset - position, -1));
+                segments.Add(new Segment(block.Offset, block.Size, i));
+                position = block.Offset + block.Size;
+            }
+
+            if (position < logLength)
+                segments.Add(new Segment(position, logLength - position, -1));
+            return segments;
+        }
+
+        /// <summary>
+        /// Lines of a byte range starting at a line boundary, without the trailing empty line.
+        /// </summary>
+        public static string[] ReadLines(FileStream stream, long offset, long size)
+        {
+            if (size <= 0)
+                return Array.Empty<string>();
+
+            var bytes = new byte[size];
+            stream.Seek(offset, SeekOrigin.Begin);
+            var read = 0;
+            while (read < bytes.Length)
+            {
+                var count = stream.Read(bytes, read, bytes.Length - read);
+                if (count == 0)
+                    break;
+                read += count;
+            }
+
+            var text = Encoding.UTF8.GetString(bytes, 0, read);
+            if (text.EndsWith("\n"))
+                text = text.Substring(0, text.Length - 1);
+            return text.Length == 0 ? Array.Empty<string>() : text.Split('\n');
+        }
+    }
+}
@@ -2,6 +2,7 @@
 using System.Collections.Generic;
 using System.IO;
 using System.Linq;
+using System.Text;
 using System.Text.RegularExpressions;
 using UnityEditor;
 using UnityEngine;
@@ -32,12 +33,20 @@ public class MLoggerLogViewer : EditorWindow
         private readonly LogStatistics statistics = new();
         private string currentLogPath = "";
         private long currentFileSize = 0;
+        private MLoggerLogIndex currentIndex;
+        private bool partialView;   // only the tail of the file is loaded
+
+        // live tail of the running logger, polled instead of reloading the file
+        private bool tailing;
+        private ulong tailCursor;
+        private ulong tailRotations;
         private readonly List<string> availableLogFiles = new();
         private int selectedFileIndex = 0;
 
         private string cachedFilteredContent = "";
         private string lastSearchText = "";
         private bool lastUseRegex = false;
+        private Regex searchRegex;
 
         private Dictionary<LogLevel, bool> lastLevelFilters = new()
         {
@@ -65,6 +74,31 @@ private class LogStatistics
             public int errorCount = 0;
             public int criticalCount = 0;
 
+            public void Count(LogLevel level, int count)
+            {
+                switch (level)
+                {
+                    case LogLevel.Trace:
+                        traceCount += count;
+                        break;
+                    case LogLevel.Debug:
+                        debugCount += count;
+                        break;
+                    case LogLevel.Info:
+                        infoCount += count;
+                        break;
+                    case LogLevel.Warn:
+                        warnCount += count;
+                        break;
+                    case LogLevel.Error:
+                        errorCount += count;
+                        break;
+                    case LogLevel.Critical:
+                        criticalCount += count;
+                        break;
+                }
+            }
+
             public void Reset()
             {
                 totalLines = 0;
@@ -125,6 +159,8 @@ private void DrawToolbar()
                 {
                     logContent = "";
                     logLines = Array.Empty<string>();
+                    currentIndex = null;
+                    tailing = false;
                     statistics.Reset();
                 }
             }
@@ -227,11 +263,13 @@ private void CheckFilterChanges()
                 lastUseRegex = useRegex;
             }
 
+            var levelsChanged = false;
             foreach (var kvp in levelFilters)
             {
                 if (!lastLevelFilters.ContainsKey(kvp.Key) || lastLevelFilters[kvp.Key] != kvp.Value)
                 {
                     filtersChanged = true;
+                    levelsChanged = true;
                     break;
                 }
             }
@@ -240,6 +278,12 @@ private void CheckFilterChanges()
             {
                 lastLevelFilters = new Dictionary<LogLevel, bool>(levelFilters);
             }
+
+            // an indexed file only loaded the blocks holding the previously selected levels
+            if (levelsChanged && currentIndex != null)
+            {
+                LoadLogFile(currentLogPath);
+            }
         }
 
         private void UpdateCachedContent()
@@ -251,7 +295,7 @@ private void UpdateCachedContent()
 
             EditorApplication.delayCall += () =>
             {
-                var filteredLines = GetFilteredLines();
+                var filteredLines = GetFilteredLines(maxDisplayLines, out var total);
                 if (filteredLines.Length == 0)
                 {
                     cachedFilteredContent = "";
@@ -265,9 +309,9 @@ private void UpdateCachedContent()
                 var coloredLines = linesToProcess.Select(ApplyColorToLine).ToArray();
                 cachedFilteredContent = string.Join("\n", coloredLines);
 
-                if (filteredLines.Length > maxDisplayLines)
+                if (total > maxDisplayLines)
                 {
-                    cachedFilteredContent = $"[Showing last {maxDisplayLines} of {filteredLines.Length} lines]\n" +
+                    cachedFilteredContent = $"[Showing last {maxDisplayLines} of {total} lines]\n" +
                                             cachedFilteredContent;
                 }
 
@@ -299,13 +343,54 @@ private void DrawStatusBar()
                 GUILayout.Width(150));
 
             EditorGUILayout.EndHorizontal();
+
+            if (MLoggerManager.IsInitialized)
+            {
+                DrawSessionStatistics();
+            }
+        }
+
+        private void DrawSessionStatistics()
+        {
+            // counters kept natively since initialization, cheap to read every repaint
+            var stats = MLoggerManager.GetStats();
+
+            EditorGUILayout.BeginHorizontal(EditorStyles.helpBox);
+
+            EditorGUILayout.LabelField("Session", EditorStyles.boldLabel, GUILayout.Width(60));
+            EditorGUILayout.LabelField($"Written: {FormatFileSize((long)stats.bytesWritten)}", GUILayout.Width(140));
+            EditorGUILayout.LabelField($"Rotations: {stats.rotations}", GUILayout.Width(100));
+            EditorGUILayout.LabelField($"Flushes: {stats.flushes}", GUILayout.Width(100));
+
+            EditorGUILayout.Separator();
+
+            EditorGUILayout.LabelField($"Warn: {stats.GetMessageCount(LogLevel.Warn)}", GUILayout.Width(90));
+            EditorGUILayout.LabelField($"Error: {stats.GetMessageCount(LogLevel.Error)}", GUILayout.Width(90));
+            EditorGUILayout.LabelField($"Critical: {stats.GetMessageCount(LogLevel.Critical)}", GUILayout.Width(100));
+
+            GUILayout.FlexibleSpace();
+
+            EditorGUILayout.LabelField($"Queue: {stats.queueDepth} (peak {stats.queueHighWater})", GUILayout.Width(160));
+            EditorGUILayout.LabelField($"Dropped: {stats.dropped}", GUILayout.Width(100));
+            EditorGUILayout.LabelField($"Filtered: {stats.suppressed + stats.rateLimited}", GUILayout.Width(100));
+            if (stats.shipped + stats.unshipped > 0)
+            {
+                EditorGUILayout.LabelField($"Unshipped: {stats.unshipped}", GUILayout.Width(110));
+            }
+            EditorGUILayout.LabelField($"p99: {FormatLatency(stats.GetLatencyPercentileNs(0.99))}", GUILayout.Width(110));
+
+            EditorGUILayout.EndHorizontal();
         }
 
         private void Update()
         {
             if (autoRefresh && EditorApplication.timeSinceStartup - lastRefreshTime > refreshInterval)
             {
-                RefreshLog();
+                if (!tailing || !PollTail())
+                {
+                    RefreshLog();
+                }
+
                 lastRefreshTime = EditorApplication.timeSinceStartup;
             }
         }
@@ -422,21 +507,31 @@ private void LoadLogFile(string logPath)
                 {
                     if (File.Exists(logPath))
                     {
+                        // NOTE: the cursor is taken before the file is read, so a line logged in between may show
+                        // twice but none is missed
+                        tailing = StartTail(logPath);
+
                         var fileInfo = new FileInfo(logPath);
                         currentFileSize = fileInfo.Length;
+                        currentIndex = MLoggerLogIndex.TryLoad(logPath, fileInfo.Length);
+                        partialView = currentIndex != null || fileInfo.Length > 50 * 1024 * 1024;
 
-                        if (fileInfo.Length > 50 * 1024 * 1024)
+                        if (currentIndex != null)
+                        {
+                            LoadIndexedFile(logPath, currentIndex, fileInfo.Length);
+                        }
+                        else if (fileInfo.Length > 50 * 1024 * 1024)
                         {
                             LoadLargeFile(logPath);
+                            UpdateStatisticsAsync();
                         }
                         else
                         {
                             using var reader = new StreamReader(logPath);
                             logContent = reader.ReadToEnd();
                             logLines = logContent.Split('\n');
+                            UpdateStatisticsAsync();
                         }
-
-                        UpdateStatisticsAsync();
                     }
                     else
                     {
@@ -445,12 +540,16 @@ private void LoadLogFile(string logPath)
                         logLines = Array.Empty<string>();
                         statistics.Reset();
                         currentFileSize = 0;
+                        currentIndex = null;
+                        tailing = false;
                     }
                 }
                 catch (Exception e)
                 {
                     logContent = $"Error reading log file: {e.Message}";
                     logLines = Array.Empty<string>();
+                    currentIndex = null;
+                    tailing = false;
                 }
                 finally
                 {
@@ -462,28 +561,140 @@ private void LoadLogFile(string logPath)
             };
         }
 
+        private bool StartTail(string logPath)
+        {
+            if (!MLoggerManager.IsInitialized || !IsCurrentLog(logPath))
+                return false;
+
+            tailCursor = MLoggerManager.GetTailEnd();
+            if (tailCursor == 0)
+                return false;
+
+            tailRotations = MLoggerManager.GetStats().rotations;
+            MLoggerManager.Flush();
+            return true;
+        }
+
+        /// <summary>
+        /// Appends the lines logged since the file was loaded, read from the native live tail instead of the file.
+        /// </summary>
+        /// <returns>False when the file must be reloaded: the logger restarted, the file rotated or lines were missed.</returns>
+        private bool PollTail()
+        {
+            if (!MLoggerManager.IsInitialized || MLoggerManager.GetStats().rotations != tailRotations)
+                return false;
+
+            var newLines = new List<string>();
+            if (!MLoggerManager.ReadTail(ref tailCursor, newLines))
+                return false;
+            if (newLines.Count == 0)
+                return true;
+
+            statistics.totalLines += newLines.Count;
+            foreach (var line in newLines)
+            {
+                statistics.Count(DetectLogLevel(line), 1);
+            }
+
+            var total = logLines.Length + newLines.Count;
+            var lines = logLines.Concat(newLines);
+            logLines = (partialView && total > maxDisplayLines * 2 ? lines.Skip(total - maxDisplayLines * 2) : lines)
+                .ToArray();
+            filtersChanged = true;
+            Repaint();
+            return true;
+        }
+
+        private static bool IsCurrentLog(string logPath)
+        {
+            var config = MLoggerManager.CurrentConfig;
+            if (config == null)
+                return false;
+
+            var currentPath = string.IsNullOrEmpty(config.logPath) ? MLoggerConfig.CreateDefault().logPath : config.logPath;
+            try
+            {
+                return string.Equals(Path.GetFullPath(currentPath), Path.GetFullPath(logPath),
+                    StringComparison.OrdinalIgnoreCase);
+            }
+            catch
+            {
+                return false;
+            }
+        }
+
         private void LoadLargeFile(string logPath)
         {
-            var lines = new List<string>();
+            var lines = new Queue<string>(maxDisplayLines * 2 + 1);
             using var reader = new StreamReader(logPath);
             string line;
-            var lineCount = 0;
 
             while ((line = reader.ReadLine()) != null)
             {
-                lineCount++;
-                if (lineCount > maxDisplayLines * 2)
+                if (lines.Count == maxDisplayLines * 2)
                 {
-                    lines.RemoveAt(0);
+                    lines.Dequeue();
                 }
 
-                lines.Add(line);
+                lines.Enqueue(line);
             }
 
             logLines = lines.ToArray();
             logContent = string.Join("\n", logLines);
         }
 
+        /// <summary>
+        /// Loads the last lines of the blocks holding an enabled level and takes the statistics from the block
+        /// summaries; only the bytes no block covers are read to count their levels.
+        /// </summary>
+        private void LoadIndexedFile(string logPath, MLoggerLogIndex index, long length)
+        {
+            using var stream = new FileStream(logPath, FileMode.Open, FileAccess.Read, FileShare.ReadWrite);
+            var segments = index.GetSegments(length);
+            var gapLines = new Dictionary<int, string[]>();
+
+            var chunks = new List<string[]>();
+            var collected = 0;
+            for (var i = segments.Count - 1; i >= 0 && collected < maxDisplayLines * 2; i--)
+            {
+                var segment = segments[i];
+                if (segment.BlockIndex >= 0 && !index.Blocks[segment.BlockIndex].HasAnyLevel(l => levelFilters[l]))
+                    continue;
+
+                var lines = MLoggerLogIndex.ReadLines(stream, segment.Offset, segment.Size);
+                if (segment.BlockIndex < 0)
+                    gapLines[i] = lines;
+                chunks.Add(lines);
+                collected += lines.Length;
+            }
+
+            chunks.Reverse();
+            var loaded = chunks.SelectMany(c => c);
+            logLines = (collected > maxDisplayLines * 2 ? loaded.Skip(collected - maxDisplayLines * 2) : loaded)
+                .ToArray();
+            logContent = string.Join("\n", logLines);
+
+            statistics.Reset();
+            for (var i = 0; i < segments.Count; i++)
+            {
+                var segment = segments[i];
+                if (segment.BlockIndex >= 0)
+                {
+                    var block = index.Blocks[segment.BlockIndex];
+                    statistics.totalLines += block.Lines;
+                    for (var level = 0; level < block.LevelCounts.Length; level++)
+                        statistics.Count((LogLevel)level, block.LevelCounts[level]);
+                    continue;
+                }
+
+                if (!gapLines.TryGetValue(i, out var lines))
+                    lines = MLoggerLogIndex.ReadLines(stream, segment.Offset, segment.Size);
+                statistics.totalLines += lines.Length;
+                foreach (var line in lines)
+                    statistics.Count(DetectLogLevel(line), 1);
+            }
+        }
+
         private void UpdateStatisticsAsync()
         {
             EditorApplication.delayCall += () =>
@@ -499,28 +710,7 @@ void ProcessBatch()
                     var end = Math.Min(processed + batchSize, logLines.Length);
                     for (var i = processed; i < end; i++)
                     {
-                        var level = DetectLogLevel(logLines[i]);
-                        switch (level)
-                        {
-                            case LogLevel.Trace:
-                                statistics.traceCount++;
-                                break;
-                            case LogLevel.Debug:
-                                statistics.debugCount++;
-                                break;
-                            case LogLevel.Info:
-                                statistics.infoCount++;
-                                break;
-                            case LogLevel.Warn:
-                                statistics.warnCount++;
-                                break;
-                            case LogLevel.Error:
-                                statistics.errorCount++;
-                                break;
-                            case LogLevel.Critical:
-                                statistics.criticalCount++;
-                                break;
-                        }
+                        statistics.Count(DetectLogLevel(logLines[i]), 1);
                     }
 
                     processed = end;
@@ -561,8 +751,16 @@ private static LogLevel DetectLogLevel(string line)
             return LogLevel.Info;
         }
 
-        private string[] GetFilteredLines()
+        /// <summary>
+        /// The lines passing the filters, at least the newest <paramref name="maxLines"/> of them.
+        /// </summary>
+        /// <param name="total">How many lines pass, which can be more than the array holds.</param>
+        private string[] GetFilteredLines(int maxLines, out long total)
         {
+            var found = SearchCurrentFile(maxLines, out total);
+            if (found != null)
+                return found;
+
             IEnumerable<string> filtered = logLines;
             var filteredList = filtered
                 .Where(line => levelFilters[DetectLogLevel(line)])
@@ -574,8 +772,9 @@ private string[] GetFilteredLines()
                 {
                     try
                     {
-                        var regex = new Regex(searchText, RegexOptions.IgnoreCase);
-                        filteredList = filteredList.Where(line => regex.IsMatch(line)).ToList();
+                        if (searchRegex == null || searchRegex.ToString() != searchText)
+                            searchRegex = new Regex(searchText, RegexOptions.IgnoreCase | RegexOptions.Compiled);
+                        filteredList = filteredList.Where(line => searchRegex.IsMatch(line)).ToList();
                     }
                     catch
                     {
@@ -590,9 +789,69 @@ private string[] GetFilteredLines()
                 }
             }
 
+            total = filteredList.Count;
             return filteredList.ToArray();
         }
 
+        /// <summary>
+        /// Searches the whole file with the native search rather than the loaded lines, which are only the last part of
+        /// a large or indexed file. Null when it does not apply (no plain text search, or no native search), so the
+        /// loaded lines are filtered instead.
+        /// </summary>
+        private string[] SearchCurrentFile(int maxLines, out long total)
+        {
+            total = 0;
+            if (useRegex || string.IsNullOrEmpty(searchText) || !File.Exists(currentLogPath))
+                return null;
+
+            var levelMask = 0;
+            foreach (var kvp in levelFilters)
+            {
+                if (kvp.Value)
+                    levelMask |= 1 << (int)kvp.Key;
+            }
+            if (levelMask == 0)
+                return Array.Empty<string>();
+
+            const LogSearchFlags flags = LogSearchFlags.IgnoreCase | LogSearchFlags.Newest;
+            var offsets = new ulong[Math.Min(maxLines, 100000)];
+            total = MLoggerManager.SearchLog(currentLogPath, searchText, flags, levelMask, offsets);
+            if (total > offsets.Length && offsets.Length < maxLines)
+            {
+                offsets = new ulong[Math.Min(total, maxLines)];
+                total = MLoggerManager.SearchLog(currentLogPath, searchText, flags, levelMask, offsets);
+            }
+            if (total < 0)
+                return null;
+
+            try
+            {
+                return ReadLinesAt(currentLogPath, offsets, (int)Math.Min(total, offsets.Length));
+            }
+            catch (IOException)
+            {
+                return null;
+            }
+        }
+
+        private static string[] ReadLinesAt(string path, ulong[] offsets, int count)
+        {
+            var lines = new string[count];
+            var bytes = new List<byte>(256);
+            using var stream = new FileStream(path, FileMode.Open, FileAccess.Read, FileShare.ReadWrite);
+            for (var i = 0; i < count; i++)
+            {
+                stream.Seek((long)offsets[i], SeekOrigin.Begin);
+                bytes.Clear();
+                int b;
+                while ((b = stream.ReadByte()) >= 0 && b != '\n')
+                    bytes.Add((byte)b);
+                lines[i] = Encoding.UTF8.GetString(bytes.ToArray()).TrimEnd('\r');
+            }
+
+            return lines;
+        }
+
         private static string ApplyColorToLine(string line)
         {
             var level = DetectLogLevel(line);
@@ -625,6 +884,18 @@ private static string FormatFileSize(long bytes)
             };
         }
 
+        private static string FormatLatency(ulong ns)
+        {
+            return ns switch
+            {
+                0 => "-",
+                ulong.MaxValue => $"> {(64UL << (MLoggerStats.LatencyBucketCount - 2)) / (1000.0 * 1000.0):F1} ms",
+                < 1000 => $"< {ns} ns",
+                < 1000 * 1000 => $"< {ns / 1000.0:F1} us",
+                _ => $"< {ns / (1000.0 * 1000.0):F1} ms"
+            };
+        }
+
         private static void OpenLogDirectory()
         {
             var config = MLoggerSettings.Instance?.Config ?? MLoggerConfig.CreateDefault();
@@ -658,7 +929,7 @@ private void ShowExportMenu()
 
         private void ExportLog(bool asCsv)
         {
-            var filteredLines = GetFilteredLines();
+            var filteredLines = GetFilteredLines(int.MaxValue, out _);
             if (filteredLines.Length == 0)
             {
                 EditorUtility.DisplayDialog("Export", "No logs to export with current filters.", "OK");
@@ -811,6 +1082,7 @@ private void CleanLogFiles(int maxCount, long maxTotalSize, int maxAgeDays)
                     try
                     {
                         File.Delete(file.FullName);
+                        File.Delete(MLoggerLogIndex.GetIndexPath(file.FullName));
                         deletedCount++;
                     }
                     catch
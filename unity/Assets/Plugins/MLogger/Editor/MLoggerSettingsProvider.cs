@@ -15,24 +15,120 @@ private class Styles
         {
             public static readonly GUIContent LogPathLabel = new("Log Path", "Path to the log file");
 
+            public static readonly GUIContent JsonLogPathLabel =
+                new("JSON Log Path", "Optional second file with one JSON object per message, for log collectors; empty disables it");
+
             public static readonly GUIContent MaxFileSizeLabel =
                 new("Max File Size (MB)", "Maximum size of each log file in megabytes");
 
             public static readonly GUIContent MaxFilesLabel = new("Max Files", "Maximum number of log files to keep");
 
+            public static readonly GUIContent CompressionLabel =
+                new("Compression", "Compress rotated files on a background thread; the current file stays plain");
+
+            public static readonly GUIContent FileFormatLabel =
+                new("File Format", "Text lines, or compact binary records decoded offline with mlogger_decode");
+
+            public static readonly GUIContent MemoryMappedFilesLabel =
+                new("Memory-Mapped Files", "Preallocate log files and write them through a memory mapping, no flush needed");
+
+            public static readonly GUIContent IndexFilesLabel =
+                new("Index Files", "Keep a small .idx sidecar next to each text log file so the log viewer can seek without reading the whole file");
+
+            public static readonly GUIContent FlushIntervalLabel =
+                new("Flush Interval (ms)", "How long written messages may wait in memory, 0 flushes only on Flush() and critical messages");
+
+            public static readonly GUIContent UringWriterLabel =
+                new("io_uring Writes (Linux)", "Hand the log files to the kernel in large writes through io_uring, stdio where it is not available");
+
+            public static readonly GUIContent DirectIoLabel =
+                new("Direct I/O", "Write the io_uring files with O_DIRECT, keeping them out of the page cache");
+
+            public static readonly GUIContent FlushBytesLabel =
+                new("Flush Buffer (KB)", "Messages collected before one write to the file, 0 keeps stdio's own small buffer");
+
             public static readonly GUIContent AsyncModeLabel =
                 new("Async Mode", "Use asynchronous logging for better performance");
 
             public static readonly GUIContent ThreadPoolSizeLabel =
                 new("Thread Pool Size", "Number of threads in the async thread pool");
 
+            public static readonly GUIContent QueueSizeLabel =
+                new("Queue Size", "Number of messages the async queue holds before the overflow policy applies");
+
+            public static readonly GUIContent OverflowPolicyLabel =
+                new("Overflow Policy", "Block the caller, overwrite the oldest message, or drop the newest one when the queue is full");
+
+            public static readonly GUIContent StagingRingsLabel =
+                new("Staging Rings", "Give every logging thread its own ring drained by a single writer thread");
+
+            public static readonly GUIContent RingBufferSizeLabel =
+                new("Ring Buffer (KB)", "Recent messages of every level kept in memory and dumped on demand or on a crash, 0 disables it");
+
+            public static readonly GUIContent CrashHandlerLabel =
+                new("Dump Ring on Crash", "Write the ring buffer next to the log file when the process crashes");
+
+            public static readonly GUIContent TailBufferSizeLabel =
+                new("Live Tail Buffer (KB)", "Recent lines kept in memory so the Log Viewer's auto refresh receives only new lines instead of rereading the file, 0 disables it");
+
+            public static readonly GUIContent NetworkAddressLabel =
+                new("Ship To", "host:port of a collector such as mlogger_collect that receives every message as well, empty for none");
+
+            public static readonly GUIContent NetworkProtocolLabel =
+                new("Ship Protocol", "UDP datagrams, or a TCP stream that is reconnected when it breaks");
+
+            public static readonly GUIContent NetworkCompressionLabel =
+                new("Ship Compression", "Codec applied to each frame sent, for slow networks");
+
+            public static readonly GUIContent NetworkBufferSizeLabel =
+                new("Ship Buffer (KB)", "Frames kept while the network is slow or the collector away; messages beyond are in the log file only");
+
+            public static readonly GUIContent SharedMemoryNameLabel =
+                new("Shared Memory Segment", "Publish messages to this named segment, written to the files by one mlogger_aggregate process per machine; the game then writes no files. Empty for none");
+
+            public static readonly GUIContent SharedMemorySizeLabel =
+                new("Shared Memory Size (KB)", "Ring size if the game creates the segment; messages it has no room for are dropped");
+
+            public static readonly GUIContent ClockSourceLabel =
+                new("Clock Source", "Stamp messages with the CPU cycle counter instead of the system clock, cheaper at high message rates");
+
+            public static readonly GUIContent WriterPriorityLabel =
+                new("Writer Thread Priority", "Scheduling of the threads writing the log files; Background keeps them on the efficiency cores of iOS and Android devices");
+
+            public static readonly GUIContent WriterAffinityLabel =
+                new("Writer CPU Mask", "CPUs the threads writing the log files may run on, bit i for CPU i, 0 for any; not supported on Apple platforms");
+
+            public static readonly GUIContent WriterThreadNameLabel =
+                new("Writer Thread Name", "Name of the threads writing the log files as shown by profilers and debuggers, empty to leave them unnamed");
+
+            public static readonly GUIContent DedupWindowLabel =
+                new("Repeat Window (ms)", "Repeats of a message within the window are counted and written once as \"last message repeated N times\", 0 disables duplicate suppression");
+
+            public static readonly GUIContent RateLimitLabel =
+                new("Rate Limit (msg/s)", "Messages per second per channel and level, the rest are counted and reported; critical messages are never limited, 0 disables it");
+
+            public static readonly GUIContent RateLimitBurstLabel =
+                new("Rate Limit Burst", "Messages passing at once before the rate limit applies, 0 uses the rate limit");
+
+            public static readonly GUIContent LazyInitLabel =
+                new("Lazy Initialization", "Open the log files on a background thread instead of during startup, messages logged until then are buffered in memory");
+
             public static readonly GUIContent MinLogLevelLabel = new("Min Log Level", "Minimum log level to record");
 
             public static readonly GUIContent AutoInitializeLabel =
                 new("Auto Initialize", "Automatically initialize logger when Unity starts");
 
+            public static readonly GUIContent ShutdownTimeoutLabel =
+                new("Quit Timeout (ms)", "Longest the quit handler waits for queued messages to be written, the rest are written in the background before the process exits");
+
             public static readonly GUIContent AlsoLogToUnityLabel =
                 new("Also Log to Unity", "Also output logs to Unity console");
+
+            public static readonly GUIContent BatchModeLabel =
+                new("Batch Mode", "Collect messages per frame and submit them with a single native call");
+
+            public static readonly GUIContent BatchBufferSizeLabel =
+                new("Batch Buffer (KB)", "Size of the pinned UTF-8 buffer used by batch mode");
         }
 
         public MLoggerSettingsProvider(string path, SettingsScope scope = SettingsScope.Project) : base(path, scope)
@@ -67,11 +163,44 @@ public override void OnGUI(string searchContext)
                 logPath = config.logPath,
                 maxFileSize = config.maxFileSize,
                 maxFiles = config.maxFiles,
+                compression = config.compression,
                 asyncMode = config.asyncMode,
                 threadPoolSize = config.threadPoolSize,
+                stagingRings = config.stagingRings,
+                queueSize = config.queueSize,
+                overflowPolicy = config.overflowPolicy,
+                writerPriority = config.writerPriority,
+                writerAffinityMask = config.writerAffinityMask,
+                writerThreadName = config.writerThreadName,
+                dedupWindowMs = config.dedupWindowMs,
+                rateLimit = config.rateLimit,
+                rateLimitBurst = config.rateLimitBurst,
+                fileFormat = config.fileFormat,
+                memoryMappedFiles = config.memoryMappedFiles,
+                uringWriter = config.uringWriter,
+                directIo = config.directIo,
+                networkAddress = config.networkAddress,
+                networkProtocol = config.networkProtocol,
+                networkCompression = config.networkCompression,
+                networkFrameSize = config.networkFrameSize,
+                networkBufferSize = config.networkBufferSize,
+                sharedMemoryName = config.sharedMemoryName,
+                sharedMemorySize = config.sharedMemorySize,
+                indexFiles = config.indexFiles,
+                flushIntervalMs = config.flushIntervalMs,
+                flushBytes = config.flushBytes,
+                jsonLogPath = config.jsonLogPath,
+                ringBufferSize = config.ringBufferSize,
+                crashHandler = config.crashHandler,
+                tailBufferSize = config.tailBufferSize,
+                clockSource = config.clockSource,
+                lazyInit = config.lazyInit,
                 minLogLevel = config.minLogLevel,
                 autoInitialize = config.autoInitialize,
-                alsoLogToUnity = config.alsoLogToUnity
+                shutdownTimeoutMs = config.shutdownTimeoutMs,
+                alsoLogToUnity = config.alsoLogToUnity,
+                batchMode = config.batchMode,
+                batchBufferSize = config.batchBufferSize
             };
 
             EditorGUILayout.BeginVertical(EditorStyles.helpBox);
@@ -97,6 +226,11 @@ public override void OnGUI(string searchContext)
 
             EditorGUILayout.EndHorizontal();
 
+            EditorGUILayout.BeginHorizontal();
+            EditorGUILayout.LabelField(Styles.JsonLogPathLabel, GUILayout.Width(150));
+            newConfig.jsonLogPath = EditorGUILayout.TextField(newConfig.jsonLogPath);
+            EditorGUILayout.EndHorizontal();
+
             EditorGUILayout.Space(5);
 
             var maxFileSizeMB = newConfig.maxFileSize / (1024.0 * 1024.0);
@@ -104,6 +238,26 @@ public override void OnGUI(string searchContext)
             newConfig.maxFileSize = (long)(maxFileSizeMB * 1024 * 1024);
 
             newConfig.maxFiles = EditorGUILayout.IntSlider(Styles.MaxFilesLabel, newConfig.maxFiles, 1, 50);
+            newConfig.compression =
+                (LogCompression)EditorGUILayout.EnumPopup(Styles.CompressionLabel, newConfig.compression);
+            newConfig.fileFormat = (LogFileFormat)EditorGUILayout.EnumPopup(Styles.FileFormatLabel, newConfig.fileFormat);
+            newConfig.memoryMappedFiles = EditorGUILayout.Toggle(Styles.MemoryMappedFilesLabel, newConfig.memoryMappedFiles);
+            EditorGUI.BeginDisabledGroup(newConfig.memoryMappedFiles);
+            newConfig.uringWriter = EditorGUILayout.Toggle(Styles.UringWriterLabel, newConfig.uringWriter);
+            EditorGUI.BeginDisabledGroup(!newConfig.uringWriter);
+            newConfig.directIo = EditorGUILayout.Toggle(Styles.DirectIoLabel, newConfig.directIo);
+            EditorGUI.EndDisabledGroup();
+            EditorGUI.EndDisabledGroup();
+            EditorGUI.BeginDisabledGroup(newConfig.fileFormat != LogFileFormat.Text);
+            newConfig.indexFiles = EditorGUILayout.Toggle(Styles.IndexFilesLabel, newConfig.indexFiles);
+            EditorGUI.EndDisabledGroup();
+            newConfig.flushIntervalMs =
+                EditorGUILayout.IntSlider(Styles.FlushIntervalLabel, newConfig.flushIntervalMs, 0, 10000);
+
+            EditorGUI.BeginDisabledGroup(newConfig.memoryMappedFiles);
+            newConfig.flushBytes =
+                EditorGUILayout.IntSlider(Styles.FlushBytesLabel, newConfig.flushBytes / 1024, 0, 1024) * 1024;
+            EditorGUI.EndDisabledGroup();
 
             EditorGUILayout.Space(5);
 
@@ -112,17 +266,79 @@ public override void OnGUI(string searchContext)
             EditorGUI.BeginDisabledGroup(!newConfig.asyncMode);
             newConfig.threadPoolSize =
                 EditorGUILayout.IntSlider(Styles.ThreadPoolSizeLabel, newConfig.threadPoolSize, 1, 16);
+            newConfig.stagingRings = EditorGUILayout.Toggle(Styles.StagingRingsLabel, newConfig.stagingRings);
+            newConfig.queueSize = EditorGUILayout.IntSlider(Styles.QueueSizeLabel, newConfig.queueSize, 64, 65536);
+            newConfig.overflowPolicy =
+                (OverflowPolicy)EditorGUILayout.EnumPopup(Styles.OverflowPolicyLabel, newConfig.overflowPolicy);
             EditorGUI.EndDisabledGroup();
 
+            newConfig.writerPriority =
+                (LogThreadPriority)EditorGUILayout.EnumPopup(Styles.WriterPriorityLabel, newConfig.writerPriority);
+            newConfig.writerAffinityMask = EditorGUILayout.LongField(Styles.WriterAffinityLabel, newConfig.writerAffinityMask);
+            newConfig.writerThreadName = EditorGUILayout.TextField(Styles.WriterThreadNameLabel, newConfig.writerThreadName);
+
             EditorGUILayout.Space(5);
 
             newConfig.minLogLevel = (LogLevel)EditorGUILayout.EnumPopup(Styles.MinLogLevelLabel, newConfig.minLogLevel);
+            newConfig.dedupWindowMs = EditorGUILayout.IntSlider(Styles.DedupWindowLabel, newConfig.dedupWindowMs, 0, 60000);
+            newConfig.rateLimit = EditorGUILayout.IntSlider(Styles.RateLimitLabel, newConfig.rateLimit, 0, 10000);
+            EditorGUI.BeginDisabledGroup(newConfig.rateLimit == 0);
+            newConfig.rateLimitBurst = EditorGUILayout.IntSlider(Styles.RateLimitBurstLabel, newConfig.rateLimitBurst, 0, 10000);
+            EditorGUI.EndDisabledGroup();
+            newConfig.ringBufferSize =
+                EditorGUILayout.IntSlider(Styles.RingBufferSizeLabel, newConfig.ringBufferSize / 1024, 0, 4096) * 1024;
+            if (newConfig.ringBufferSize > 0 && newConfig.ringBufferSize < 4096)
+            {
+                newConfig.ringBufferSize = 4096;
+            }
+
+            EditorGUI.BeginDisabledGroup(newConfig.ringBufferSize == 0);
+            newConfig.crashHandler = EditorGUILayout.Toggle(Styles.CrashHandlerLabel, newConfig.crashHandler);
+            EditorGUI.EndDisabledGroup();
+
+            newConfig.tailBufferSize =
+                EditorGUILayout.IntSlider(Styles.TailBufferSizeLabel, newConfig.tailBufferSize / 1024, 0, 4096) * 1024;
+            if (newConfig.tailBufferSize > 0 && newConfig.tailBufferSize < 4096)
+            {
+                newConfig.tailBufferSize = 4096;
+            }
+
+            newConfig.networkAddress = EditorGUILayout.TextField(Styles.NetworkAddressLabel, newConfig.networkAddress);
+            EditorGUI.BeginDisabledGroup(string.IsNullOrEmpty(newConfig.networkAddress));
+            newConfig.networkProtocol =
+                (LogNetworkProtocol)EditorGUILayout.EnumPopup(Styles.NetworkProtocolLabel, newConfig.networkProtocol);
+            newConfig.networkCompression =
+                (LogCompression)EditorGUILayout.EnumPopup(Styles.NetworkCompressionLabel, newConfig.networkCompression);
+            newConfig.networkBufferSize =
+                EditorGUILayout.IntSlider(Styles.NetworkBufferSizeLabel, newConfig.networkBufferSize / 1024, 64, 16384) * 1024;
+            EditorGUI.EndDisabledGroup();
+
+            newConfig.sharedMemoryName = EditorGUILayout.TextField(Styles.SharedMemoryNameLabel, newConfig.sharedMemoryName);
+            EditorGUI.BeginDisabledGroup(string.IsNullOrEmpty(newConfig.sharedMemoryName));
+            newConfig.sharedMemorySize =
+                EditorGUILayout.IntSlider(Styles.SharedMemorySizeLabel, newConfig.sharedMemorySize / 1024, 64, 65536) * 1024;
+            EditorGUI.EndDisabledGroup();
+
+            newConfig.clockSource =
+                (LogClockSource)EditorGUILayout.EnumPopup(Styles.ClockSourceLabel, newConfig.clockSource);
+            newConfig.lazyInit = EditorGUILayout.Toggle(Styles.LazyInitLabel, newConfig.lazyInit);
 
             EditorGUILayout.Space(5);
 
             newConfig.autoInitialize = EditorGUILayout.Toggle(Styles.AutoInitializeLabel, newConfig.autoInitialize);
+            newConfig.shutdownTimeoutMs =
+                EditorGUILayout.IntSlider(Styles.ShutdownTimeoutLabel, newConfig.shutdownTimeoutMs, 0, 10000);
             newConfig.alsoLogToUnity = EditorGUILayout.Toggle(Styles.AlsoLogToUnityLabel, newConfig.alsoLogToUnity);
 
+            EditorGUILayout.Space(5);
+
+            newConfig.batchMode = EditorGUILayout.Toggle(Styles.BatchModeLabel, newConfig.batchMode);
+
+            EditorGUI.BeginDisabledGroup(!newConfig.batchMode);
+            newConfig.batchBufferSize =
+                EditorGUILayout.IntSlider(Styles.BatchBufferSizeLabel, newConfig.batchBufferSize / 1024, 4, 1024) * 1024;
+            EditorGUI.EndDisabledGroup();
+
             EditorGUILayout.EndVertical();
 
             EditorGUILayout.Space(10);
@@ -187,6 +403,7 @@ public override void OnGUI(string searchContext)
             if (MLoggerManager.IsInitialized)
             {
                 EditorGUILayout.EnumPopup("Current Log Level", MLoggerManager.GetLogLevel());
+                EditorGUILayout.LongField("Dropped Messages", (long)MLoggerManager.GetDroppedCount());
                 if (MLoggerManager.CurrentConfig != null)
                 {
                     EditorGUILayout.TextField("Current Log Path", MLoggerManager.CurrentConfig.logPath);
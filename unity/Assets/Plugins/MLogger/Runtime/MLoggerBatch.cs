@@ -0,0 +1,113 @@
+using System;
+using System.Runtime.InteropServices;
+using System.Text;
+
+namespace MLogger
+{
+    /// <summary>
+    /// Collects log messages as UTF-8 records in a pinned buffer and hands them to the native logger
+    /// with a single <see cref="MLoggerNative.logBatch"/> call, instead of one P/Invoke transition per message.
+    /// Safe to use from any thread; submission happens once per frame, on <see cref="MLoggerManager.Flush"/>,
+    /// or whenever the buffer fills up.
+    /// </summary>
+    public sealed class MLoggerBatch : IDisposable
+    {
+        private const long UnixEpochTicks = 621355968000000000L;
+
+        private readonly object _lock = new();
+        private readonly byte[] _buffer;
+        private readonly MLoggerNative.LogRecord[] _records;
+        private GCHandle _bufferHandle;
+        private IntPtr _bufferBase;
+        private int _bufferUsed;
+        private int _recordCount;
+
+        public MLoggerBatch(int bufferSize, int maxRecords)
+        {
+            _buffer = new byte[Math.Max(bufferSize, 1024)];
+            _records = new MLoggerNative.LogRecord[Math.Max(maxRecords, 16)];
+            _bufferHandle = GCHandle.Alloc(_buffer, GCHandleType.Pinned);
+            _bufferBase = _bufferHandle.AddrOfPinnedObject();
+        }
+
+        /// <summary>
+        /// Appends a message to the current batch. Messages that can never fit the buffer are logged directly.
+        /// </summary>
+        public void Enqueue(LogLevel level, string message)
+        {
+            message ??= "";
+            var timestampUs = (DateTime.UtcNow.Ticks - UnixEpochTicks) / 10;
+            var maxBytes = Encoding.UTF8.GetMaxByteCount(message.Length);
+
+            lock (_lock)
+            {
+                if (_bufferBase == IntPtr.Zero)
+                    return;
+
+                if (maxBytes > _buffer.Length)
+                {
+                    SubmitLocked();
+                    MLoggerNative.logMessageUtf16((int)level, message, message.Length);
+                    return;
+                }
+
+                if (_recordCount == _records.Length || _bufferUsed + maxBytes > _buffer.Length)
+                {
+                    SubmitLocked();
+                }
+
+                var length = Encoding.UTF8.GetBytes(message, 0, message.Length, _buffer, _bufferUsed);
+                _records[_recordCount++] = new MLoggerNative.LogRecord
+                {
+                    timestampUs = timestampUs,
+                    message = _bufferBase + _bufferUsed,
+                    length = length,
+                    level = (int)level
+                };
+                _bufferUsed += length;
+            }
+        }
+
+        /// <summary>
+        /// Submits every pending record to the native logger in one call.
+        /// </summary>
+        public void Submit()
+        {
+            lock (_lock)
+            {
+                SubmitLocked();
+            }
+        }
+
+        private void SubmitLocked()
+        {
+            if (_recordCount > 0 && _bufferBase != IntPtr.Zero)
+            {
+                MLoggerNative.logBatch(_records, _recordCount);
+            }
+
+            _recordCount = 0;
+            _bufferUsed = 0;
+        }
+
+        public void Dispose()
+        {
+            lock (_lock)
+            {
+                try
+                {
+                    SubmitLocked();
+                }
+                finally
+                {
+                    if (_bufferHandle.IsAllocated)
+                    {
+                        _bufferHandle.Free();
+                    }
+
+                    _bufferBase = IntPtr.Zero;
+                }
+            }
+        }
+    }
+}
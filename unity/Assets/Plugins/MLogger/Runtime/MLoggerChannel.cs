@@ -0,0 +1,69 @@
+using System;
+using UnityEngine;
+
+namespace MLogger
+{
+    /// <summary>
+    /// A named native channel: its messages go to the same log file as the default logger, tagged with
+    /// <see cref="Name"/>, and are filtered by the channel's own level. Create with
+    /// <see cref="MLoggerManager.CreateChannel"/>; channel messages are written directly, not batched.
+    /// </summary>
+    public sealed class MLoggerChannel
+    {
+        private const int LevelInherit = -1;
+        private const int LevelOff = 6;
+
+        internal MLoggerChannel(int id, string name)
+        {
+            Id = id;
+            Name = name;
+        }
+
+        public int Id { get; }
+
+        public string Name { get; }
+
+        public void Log(LogLevel level, string message)
+        {
+            if (!MLoggerManager.IsInitialized)
+                return;
+
+            try
+            {
+                message ??= "";
+                MLoggerNative.logChannelUtf16(Id, (int)level, message, message.Length);
+            }
+            catch (Exception e)
+            {
+                Debug.LogError($"[MLogger] Failed to log on channel {Name}: {e.Message}");
+            }
+        }
+
+        /// <summary>
+        /// Gives the channel its own minimum level, independent of the global one.
+        /// </summary>
+        public void SetLevel(LogLevel level) => SetNativeLevel((int)level);
+
+        /// <summary>
+        /// Drops every message of this channel.
+        /// </summary>
+        public void Disable() => SetNativeLevel(LevelOff);
+
+        /// <summary>
+        /// Makes the channel follow the global level again, the state of a new channel.
+        /// </summary>
+        public void ResetLevel() => SetNativeLevel(LevelInherit);
+
+        private void SetNativeLevel(int level)
+        {
+            try
+            {
+                MLoggerNative.setChannelLevel(Id, level);
+            }
+            catch (Exception e)
+            {
+                Debug.LogError($"[MLogger] Failed to set channel level: {e.Message}");
+            }
+        }
+    }
+}
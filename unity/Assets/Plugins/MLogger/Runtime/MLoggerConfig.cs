@@ -8,11 +8,44 @@ public class MLoggerConfig
         public string logPath = "";
         public long maxFileSize = 10 * 1024 * 1024;
         public int maxFiles = 5;
+        public LogCompression compression = LogCompression.None;
         public bool asyncMode = true;
         public int threadPoolSize = 2;
+        public bool stagingRings = false;
+        public int queueSize = 8192;
+        public OverflowPolicy overflowPolicy = OverflowPolicy.Block;
+        public LogThreadPriority writerPriority = LogThreadPriority.Normal;
+        public long writerAffinityMask = 0;
+        public string writerThreadName = "mlogger";
+        public int dedupWindowMs = 0;
+        public int rateLimit = 0;
+        public int rateLimitBurst = 0;
+        public LogFileFormat fileFormat = LogFileFormat.Text;
+        public bool memoryMappedFiles = false;
+        public bool uringWriter = false;
+        public bool directIo = false;
+        public string networkAddress = "";
+        public LogNetworkProtocol networkProtocol = LogNetworkProtocol.Udp;
+        public LogCompression networkCompression = LogCompression.None;
+        public int networkFrameSize = 0;
+        public int networkBufferSize = 1024 * 1024;
+        public string sharedMemoryName = "";
+        public int sharedMemorySize = 4 * 1024 * 1024;
+        public bool indexFiles = false;
+        public int flushIntervalMs = 1000;
+        public int flushBytes = 64 * 1024;
+        public string jsonLogPath = "";
+        public int ringBufferSize = 0;
+        public bool crashHandler = false;
+        public int tailBufferSize = 0;
+        public LogClockSource clockSource = LogClockSource.System;
+        public bool lazyInit = false;
         public LogLevel minLogLevel = LogLevel.Info;
         public bool autoInitialize = true;
+        public int shutdownTimeoutMs = 1000;
         public bool alsoLogToUnity = true;
+        public bool batchMode = false;
+        public int batchBufferSize = 64 * 1024;
 
         public static MLoggerConfig CreateDefault()
         {
@@ -21,11 +54,44 @@ public static MLoggerConfig CreateDefault()
                 logPath = GetDefaultLogPath(),
                 maxFileSize = 10 * 1024 * 1024,
                 maxFiles = 5,
+                compression = LogCompression.None,
                 asyncMode = true,
                 threadPoolSize = 2,
+                stagingRings = false,
+                queueSize = 8192,
+                overflowPolicy = OverflowPolicy.Block,
+                writerPriority = LogThreadPriority.Normal,
+                writerAffinityMask = 0,
+                writerThreadName = "mlogger",
+                dedupWindowMs = 0,
+                rateLimit = 0,
+                rateLimitBurst = 0,
+                fileFormat = LogFileFormat.Text,
+                memoryMappedFiles = false,
+                uringWriter = false,
+                directIo = false,
+                networkAddress = "",
+                networkProtocol = LogNetworkProtocol.Udp,
+                networkCompression = LogCompression.None,
+                networkFrameSize = 0,
+                networkBufferSize = 1024 * 1024,
+                sharedMemoryName = "",
+                sharedMemorySize = 4 * 1024 * 1024,
+                indexFiles = false,
+                flushIntervalMs = 1000,
+                flushBytes = 64 * 1024,
+                jsonLogPath = "",
+                ringBufferSize = 0,
+                crashHandler = false,
+                tailBufferSize = 0,
+                clockSource = LogClockSource.System,
+                lazyInit = false,
                 minLogLevel = LogLevel.Info,
                 autoInitialize = true,
-                alsoLogToUnity = true
+                shutdownTimeoutMs = 1000,
+                alsoLogToUnity = true,
+                batchMode = false,
+                batchBufferSize = 64 * 1024
             };
         }
 
@@ -0,0 +1,127 @@
+using System;
+using System.Runtime.InteropServices;
+using System.Text;
+
+namespace MLogger
+{
+    public enum MLoggerFieldType
+    {
+        Int = 0,
+        Double = 1,
+        Bool = 2,
+        String = 3,
+        Float = 4
+    }
+
+    /// <summary>
+    /// A typed key/value pair for <see cref="MLoggerManager.LogStructured"/>. Values are passed to the native
+    /// layer as they are and formatted there, on the writer thread in async modes.
+    /// </summary>
+    public readonly struct MLoggerField
+    {
+        public readonly string Key;
+        public readonly MLoggerFieldType Type;
+        public readonly long IntValue;
+        public readonly double DoubleValue;
+        public readonly string StringValue;
+
+        private MLoggerField(string key, MLoggerFieldType type, long intValue, double doubleValue,
+            string stringValue)
+        {
+            Key = key;
+            Type = type;
+            IntValue = intValue;
+            DoubleValue = doubleValue;
+            StringValue = stringValue;
+        }
+
+        public static MLoggerField Int(string key, long value) =>
+            new(key, MLoggerFieldType.Int, value, 0, null);
+
+        public static MLoggerField Double(string key, double value) =>
+            new(key, MLoggerFieldType.Double, 0, value, null);
+
+        public static MLoggerField Float(string key, float value) =>
+            new(key, MLoggerFieldType.Float, 0, value, null);
+
+        public static MLoggerField Bool(string key, bool value) =>
+            new(key, MLoggerFieldType.Bool, value ? 1 : 0, 0, null);
+
+        public static MLoggerField String(string key, string value) =>
+            new(key, MLoggerFieldType.String, 0, 0, value ?? "");
+    }
+
+    /// <summary>
+    /// Encodes keys and string values into a per-thread UTF-8 buffer that is pinned for the duration of
+    /// one <see cref="MLoggerNative.logStructured"/> call.
+    /// </summary>
+    internal static class MLoggerFieldEncoder
+    {
+        [ThreadStatic] private static byte[] _bytes;
+        [ThreadStatic] private static MLoggerNative.LogField[] _records;
+
+        public static void Submit(LogLevel level, string message, MLoggerField[] fields)
+        {
+            var count = fields?.Length ?? 0;
+            var maxBytes = 0;
+            for (var i = 0; i < count; i++)
+            {
+                maxBytes += Encoding.UTF8.GetMaxByteCount(fields[i].Key?.Length ?? 0);
+                if (fields[i].Type == MLoggerFieldType.String)
+                    maxBytes += Encoding.UTF8.GetMaxByteCount(fields[i].StringValue.Length);
+            }
+
+            if (_bytes == null || _bytes.Length < maxBytes)
+                _bytes = new byte[Math.Max(maxBytes, 1024)];
+            if (_records == null || _records.Length < count)
+                _records = new MLoggerNative.LogField[Math.Max(count, 16)];
+
+            var handle = GCHandle.Alloc(_bytes, GCHandleType.Pinned);
+            try
+            {
+                var bufferBase = handle.AddrOfPinnedObject();
+                var used = 0;
+                for (var i = 0; i < count; i++)
+                {
+                    var field = fields[i];
+                    var key = field.Key ?? "";
+                    var keyLength = Encoding.UTF8.GetBytes(key, 0, key.Length, _bytes, used);
+                    var record = new MLoggerNative.LogField
+                    {
+                        key = bufferBase + used,
+                        keyLength = (ushort)Math.Min(keyLength, ushort.MaxValue),
+                        type = (ushort)field.Type
+                    };
+                    used += keyLength;
+
+                    switch (field.Type)
+                    {
+                        case MLoggerFieldType.Double:
+                            record.doubleValue = field.DoubleValue;
+                            break;
+                        case MLoggerFieldType.Float:
+                            record.floatValue = (float)field.DoubleValue;
+                            break;
+                        case MLoggerFieldType.String:
+                            var value = field.StringValue;
+                            record.stringValue = bufferBase + used;
+                            record.stringLength = Encoding.UTF8.GetBytes(value, 0, value.Length, _bytes, used);
+                            used += record.stringLength;
+                            break;
+                        default:
+                            record.intValue = field.IntValue;
+                            break;
+                    }
+
+                    _records[i] = record;
+                }
+
+                MLoggerNative.logStructured((int)level, message ?? "", _records, count);
+            }
+            finally
+            {
+                handle.Free();
+            }
+        }
+    }
+}
@@ -0,0 +1,190 @@
+using System;
+using System.Collections.Concurrent;
+using System.Globalization;
+using System.Text;
+
+namespace MLogger
+{
+    /// <summary>
+    /// Defers <c>string.Format</c> to the native layer: formats are registered once and each call only encodes its
+    /// arguments, which the native writer thread formats with fmt. Only formats made of plain <c>{n}</c>
+    /// placeholders and <c>{{</c>/<c>}}</c> escapes qualify, as their meaning is the same in both syntaxes.
+    /// Integers, chars, strings and bools qualify as arguments, as fmt writes them the way <c>string.Format</c>
+    /// does. Floating point numbers do not: <c>string.Format</c> writes them with the current culture
+    /// (<c>1E+20</c>, <c>Infinity</c>, <c>1,5</c>), fmt invariantly (<c>1e+20</c>, <c>inf</c>, <c>1.5</c>).
+    /// </summary>
+    internal static class MLoggerFormat
+    {
+        private const byte ArgInt = 0;
+        private const byte ArgString = 3;
+
+        // formats built at runtime would otherwise grow the cache and the native table without bound
+        private const int MaxCachedFormats = 4096;
+
+        private readonly struct Entry
+        {
+            public readonly int Id;
+            public readonly int ArgumentCount;
+
+            public Entry(int id, int argumentCount)
+            {
+                Id = id;
+                ArgumentCount = argumentCount;
+            }
+        }
+
+        // NOTE: an id of -1 marks formats that always go through string.Format
+        private static readonly ConcurrentDictionary<string, Entry> _formats = new();
+        private static readonly Func<string, Entry> _register = Register;
+
+        [ThreadStatic] private static byte[] _bytes;
+
+        /// <summary>
+        /// Logs <paramref name="format"/> with <paramref name="args"/> through the native formatter.
+        /// </summary>
+        /// <returns>False when the format or an argument does not qualify; nothing was logged then.</returns>
+        public static bool TrySubmit(LogLevel level, string format, object[] args)
+        {
+            if (format == null || args == null || !BitConverter.IsLittleEndian)
+                return false;
+
+            if (!_formats.TryGetValue(format, out var entry))
+            {
+                if (_formats.Count >= MaxCachedFormats)
+                    return false;
+                entry = _formats.GetOrAdd(format, _register);
+            }
+            if (entry.Id < 0 || args.Length < entry.ArgumentCount)
+                return false;
+
+            var maxBytes = 0;
+            for (var i = 0; i < entry.ArgumentCount; i++)
+            {
+                var size = MaxEncodedSize(args[i]);
+                if (size < 0)
+                    return false;
+                maxBytes += size;
+            }
+
+            if (_bytes == null || _bytes.Length < maxBytes)
+                _bytes = new byte[Math.Max(maxBytes, 1024)];
+
+            var used = 0;
+            for (var i = 0; i < entry.ArgumentCount; i++)
+                used = Encode(args[i], _bytes, used);
+
+            MLoggerNative.logFormatted((int)level, entry.Id, _bytes, used);
+            return true;
+        }
+
+        private static Entry Register(string format)
+        {
+            var argumentCount = CountArguments(format);
+            if (argumentCount < 0)
+                return new Entry(-1, 0);
+
+            try
+            {
+                return new Entry(MLoggerNative.registerFormat(format), argumentCount);
+            }
+            catch (EntryPointNotFoundException)
+            {
+                // NOTE: older native builds lack the export
+                return new Entry(-1, 0);
+            }
+        }
+
+        /// <summary>
+        /// One more than the highest placeholder index, or -1 when the format uses alignment, format strings
+        /// or unbalanced braces.
+        /// </summary>
+        private static int CountArguments(string format)
+        {
+            var count = 0;
+            for (var i = 0; i < format.Length; i++)
+            {
+                var c = format[i];
+                if (c == '}')
+                {
+                    if (i + 1 < format.Length && format[i + 1] == '}')
+                    {
+                        i++;
+                        continue;
+                    }
+                    return -1;
+                }
+                if (c != '{')
+                    continue;
+                if (i + 1 < format.Length && format[i + 1] == '{')
+                {
+                    i++;
+                    continue;
+                }
+
+                var index = 0;
+                var digits = 0;
+                for (i++; i < format.Length && format[i] >= '0' && format[i] <= '9' && digits < 6; i++, digits++)
+                    index = index * 10 + (format[i] - '0');
+                if (digits == 0 || i >= format.Length || format[i] != '}')
+                    return -1;
+                count = Math.Max(count, index + 1);
+            }
+            return count;
+        }
+
+        private static int MaxEncodedSize(object arg)
+        {
+            switch (arg)
+            {
+                case string text:
+                    return 5 + Encoding.UTF8.GetMaxByteCount(text.Length);
+                case bool:
+                    return 5 + 5;
+                case char:
+                    return 5 + 4;
+                case ulong value when value > long.MaxValue:
+                    return -1;
+                case sbyte or byte or short or ushort or int or uint or long or ulong:
+                    // NOTE: string.Format takes the minus sign from the current culture, a few use U+2212
+                    if (Convert.ToInt64(arg) < 0 && NumberFormatInfo.CurrentInfo.NegativeSign != "-")
+                        return -1;
+                    return 9;
+                default:
+                    return -1;
+            }
+        }
+
+        private static int Encode(object arg, byte[] dest, int offset)
+        {
+            switch (arg)
+            {
+                case string text:
+                    return EncodeString(text, dest, offset);
+                case bool value:
+                    // string.Format writes bools as "True" / "False"
+                    return EncodeString(value ? "True" : "False", dest, offset);
+                case char value:
+                    return EncodeString(value.ToString(), dest, offset);
+                default:
+                    dest[offset] = ArgInt;
+                    return WriteInt64(dest, offset + 1, Convert.ToInt64(arg), 8);
+            }
+        }
+
+        private static int EncodeString(string text, byte[] dest, int offset)
+        {
+            dest[offset] = ArgString;
+            var length = Encoding.UTF8.GetBytes(text, 0, text.Length, dest, offset + 5);
+            WriteInt64(dest, offset + 1, length, 4);
+            return offset + 5 + length;
+        }
+
+        // little endian, checked by TrySubmit
+        private static int WriteInt64(byte[] dest, int offset, long value, int size)
+        {
+            for (var i = 0; i < size; i++)
+                dest[offset + i] = (byte)(value >> (8 * i));
+            return offset + size;
+        }
+    }
+}
@@ -1,4 +1,5 @@
 using System;
+using System.Runtime.InteropServices;
 using UnityEngine;
 using Object = UnityEngine.Object;
 
@@ -12,26 +13,45 @@ public class MLoggerHandler : ILogHandler
     {
         private readonly ILogHandler _defaultHandler;
         private readonly bool _alsoLogToUnity;
+        private readonly IntPtr _levelWord;
+        private readonly MLoggerBatch _batch;
 
-        public MLoggerHandler(bool alsoLogToUnity = true)
+        public MLoggerHandler(bool alsoLogToUnity = true, MLoggerBatch batch = null)
         {
             _defaultHandler = Debug.unityLogger.logHandler;
             _alsoLogToUnity = alsoLogToUnity;
+            _batch = batch;
+
+            try
+            {
+                _levelWord = MLoggerNative.getLogLevelPtr();
+            }
+            catch (Exception)
+            {
+                // NOTE: older native builds lack the export, fall back to native-side filtering.
+                _levelWord = IntPtr.Zero;
+            }
         }
 
         public void LogFormat(LogType logType, Object context, string format, params object[] args)
         {
-            var message = args != null && args.Length > 0
-                ? string.Format(format, args)
-                : format;
-
             var level = MapLogType(logType);
 
-            if (MLoggerManager.IsInitialized)
+            if (MLoggerManager.IsInitialized && IsEnabled(level))
             {
                 try
                 {
-                    MLoggerNative.logMessage((int)level, message);
+                    var hasArgs = args != null && args.Length > 0;
+                    if (_batch != null)
+                        _batch.Enqueue(level, hasArgs ? string.Format(format, args) : format);
+                    else if (!hasArgs)
+                        MLoggerNative.logMessageUtf16((int)level, format, format.Length);
+                    // NOTE: qualifying formats are formatted by the native writer thread instead
+                    else if (!MLoggerFormat.TrySubmit(level, format, args))
+                    {
+                        var message = string.Format(format, args);
+                        MLoggerNative.logMessageUtf16((int)level, message, message.Length);
+                    }
                 }
                 catch (Exception e)
                 {
@@ -48,7 +68,7 @@ public void LogFormat(LogType logType, Object context, string format, params obj
 
         public void LogException(Exception exception, Object context)
         {
-            if (MLoggerManager.IsInitialized && exception != null)
+            if (MLoggerManager.IsInitialized && exception != null && IsEnabled(LogLevel.Error))
             {
                 try
                 {
@@ -56,6 +76,8 @@ public void LogException(Exception exception, Object context)
                     var message = exception.Message ?? "";
                     var stackTrace = exception.StackTrace ?? "";
 
+                    // keep ordering with messages still waiting in the batch
+                    _batch?.Submit();
                     MLoggerNative.logException(exceptionType, message, stackTrace);
                 }
                 catch (Exception e)
@@ -72,6 +94,14 @@ public void LogException(Exception exception, Object context)
             }
         }
 
+        /// <summary>
+        /// Reads the native level word directly, so filtered messages cost neither a P/Invoke call nor formatting.
+        /// </summary>
+        private bool IsEnabled(LogLevel level)
+        {
+            return _levelWord == IntPtr.Zero || (int)level >= Marshal.ReadInt32(_levelWord);
+        }
+
         private static LogLevel MapLogType(LogType logType)
         {
             return logType switch
@@ -1,12 +1,21 @@
 using System;
+using System.Collections.Generic;
 using System.IO;
+using System.Runtime.InteropServices;
+using System.Text;
 using UnityEngine;
+using UnityEngine.LowLevel;
+using UnityEngine.PlayerLoop;
 
 namespace MLogger
 {
     public static class MLoggerManager
     {
         private static MLoggerHandler _handler;
+        private static MLoggerBatch _batch;
+        private static bool _batchPumpInstalled;
+        private static IntPtr _levelWord;
+        private static byte[] _tailBuffer;
 
         public static bool IsInitialized { get; private set; } = false;
 
@@ -37,7 +46,9 @@ public static bool Initialize(MLoggerConfig config)
                 return false;
             }
 
-            if (IsInitialized)
+            // NOTE: options are applied to the running logger, which keeps logging meanwhile
+            var reconfiguring = IsInitialized && config.maxFileSize > 0 && config.maxFiles > 0;
+            if (IsInitialized && !reconfiguring)
             {
                 Debug.LogWarning("[MLogger] Already initialized. Reinitializing...");
                 Shutdown();
@@ -49,8 +60,9 @@ public static bool Initialize(MLoggerConfig config)
                 logPath = GetDefaultLogPath();
             }
 
+            // NOTE: with lazyInit the native background thread creates the directory
             var logDir = Path.GetDirectoryName(logPath);
-            if (!string.IsNullOrEmpty(logDir) && !Directory.Exists(logDir))
+            if (!config.lazyInit && !string.IsNullOrEmpty(logDir) && !Directory.Exists(logDir))
             {
                 try
                 {
@@ -68,14 +80,45 @@ public static bool Initialize(MLoggerConfig config)
             {
                 if (config.maxFileSize > 0 && config.maxFiles > 0)
                 {
-                    result = MLoggerNative.init(
-                        logPath,
-                        new UIntPtr((ulong)config.maxFileSize),
-                        config.maxFiles,
-                        config.asyncMode ? 1 : 0,
-                        config.threadPoolSize,
-                        (int)config.minLogLevel
-                    );
+                    var options = new MLoggerNative.MLoggerOptions
+                    {
+                        structSize = (uint)Marshal.SizeOf<MLoggerNative.MLoggerOptions>(),
+                        logPath = logPath,
+                        maxFileSize = (ulong)config.maxFileSize,
+                        maxFiles = config.maxFiles,
+                        asyncMode = config.asyncMode ? (config.stagingRings ? 2 : 1) : 0,
+                        threadPoolSize = config.threadPoolSize,
+                        minLogLevel = (int)config.minLogLevel,
+                        queueSize = config.queueSize,
+                        overflowPolicy = (int)config.overflowPolicy,
+                        fileFormat = (int)config.fileFormat,
+                        fileWriter = config.memoryMappedFiles ? 1 : (config.uringWriter ? 2 : 0),
+                        ringBufferSize = config.ringBufferSize,
+                        crashHandler = config.ringBufferSize > 0 && config.crashHandler ? 1 : 0,
+                        compression = (int)config.compression,
+                        flushIntervalMs = config.flushIntervalMs > 0 ? config.flushIntervalMs : -1,
+                        flushBytes = config.flushBytes > 0 ? config.flushBytes : -1,
+                        jsonLogPath = string.IsNullOrEmpty(config.jsonLogPath) ? null : config.jsonLogPath,
+                        indexBlockLines = config.indexFiles ? 1024 : 0,
+                        tailBufferSize = config.tailBufferSize,
+                        clockSource = (int)config.clockSource,
+                        lazyInit = config.lazyInit ? 1 : 0,
+                        writerPriority = (int)config.writerPriority,
+                        writerThreadName = config.writerThreadName,
+                        writerAffinity = (ulong)config.writerAffinityMask,
+                        dedupWindowMs = config.dedupWindowMs,
+                        rateLimit = config.rateLimit,
+                        rateLimitBurst = config.rateLimitBurst,
+                        directIo = config.directIo ? 1 : 0,
+                        networkAddress = string.IsNullOrEmpty(config.networkAddress) ? null : config.networkAddress,
+                        networkProtocol = (int)config.networkProtocol,
+                        networkCompression = (int)config.networkCompression,
+                        networkFrameSize = config.networkFrameSize,
+                        networkBufferSize = config.networkBufferSize,
+                        sharedMemoryName = string.IsNullOrEmpty(config.sharedMemoryName) ? null : config.sharedMemoryName,
+                        sharedMemorySize = config.sharedMemorySize
+                    };
+                    result = reconfiguring ? Reconfigure(ref options) : MLoggerNative.initWithOptions(ref options);
                 }
                 else
                 {
@@ -95,11 +138,23 @@ public static bool Initialize(MLoggerConfig config)
 
             if (result == 1)
             {
+                // records batched under the old settings are submitted by Dispose()
+                _batch?.Dispose();
+                _batch = null;
                 IsInitialized = true;
                 CurrentConfig = config;
-                _handler = new MLoggerHandler(config.alsoLogToUnity);
+                _levelWord = MLoggerNative.getLogLevelPtr();
+                if (config.batchMode)
+                {
+                    _batch = new MLoggerBatch(config.batchBufferSize, config.batchBufferSize / 32);
+                    InstallBatchPump();
+                }
+
+                _handler = new MLoggerHandler(config.alsoLogToUnity, _batch);
                 Debug.unityLogger.logHandler = _handler;
-                Debug.Log($"[MLogger] Initialized successfully. Log path: {logPath}");
+                Debug.Log(reconfiguring
+                    ? $"[MLogger] Reconfigured successfully. Log path: {logPath}"
+                    : $"[MLogger] Initialized successfully. Log path: {logPath}");
                 return true;
             }
             else
@@ -109,6 +164,24 @@ public static bool Initialize(MLoggerConfig config)
             }
         }
 
+        /// <summary>
+        /// Applies options to the running native logger. Libraries built before reconfigure() are shut down
+        /// and initialized again.
+        /// </summary>
+        private static int Reconfigure(ref MLoggerNative.MLoggerOptions options)
+        {
+            _batch?.Submit();
+            try
+            {
+                return MLoggerNative.reconfigure(ref options);
+            }
+            catch (EntryPointNotFoundException)
+            {
+                Shutdown();
+                return MLoggerNative.initWithOptions(ref options);
+            }
+        }
+
         public static bool InitializeDefault(string logPath = null)
         {
             var config = MLoggerConfig.CreateDefault();
@@ -143,11 +216,44 @@ private static MLoggerConfig LoadConfig()
                     logPath = settings.Config.logPath,
                     maxFileSize = settings.Config.maxFileSize,
                     maxFiles = settings.Config.maxFiles,
+                    compression = settings.Config.compression,
                     asyncMode = settings.Config.asyncMode,
                     threadPoolSize = settings.Config.threadPoolSize,
+                    stagingRings = settings.Config.stagingRings,
+                    queueSize = settings.Config.queueSize,
+                    overflowPolicy = settings.Config.overflowPolicy,
+                    writerPriority = settings.Config.writerPriority,
+                    writerAffinityMask = settings.Config.writerAffinityMask,
+                    writerThreadName = settings.Config.writerThreadName,
+                    dedupWindowMs = settings.Config.dedupWindowMs,
+                    rateLimit = settings.Config.rateLimit,
+                    rateLimitBurst = settings.Config.rateLimitBurst,
+                    fileFormat = settings.Config.fileFormat,
+                    memoryMappedFiles = settings.Config.memoryMappedFiles,
+                    uringWriter = settings.Config.uringWriter,
+                    directIo = settings.Config.directIo,
+                    networkAddress = settings.Config.networkAddress,
+                    networkProtocol = settings.Config.networkProtocol,
+                    networkCompression = settings.Config.networkCompression,
+                    networkFrameSize = settings.Config.networkFrameSize,
+                    networkBufferSize = settings.Config.networkBufferSize,
+                    sharedMemoryName = settings.Config.sharedMemoryName,
+                    sharedMemorySize = settings.Config.sharedMemorySize,
+                    indexFiles = settings.Config.indexFiles,
+                    flushIntervalMs = settings.Config.flushIntervalMs,
+                    flushBytes = settings.Config.flushBytes,
+                    jsonLogPath = settings.Config.jsonLogPath,
+                    ringBufferSize = settings.Config.ringBufferSize,
+                    crashHandler = settings.Config.crashHandler,
+                    tailBufferSize = settings.Config.tailBufferSize,
+                    clockSource = settings.Config.clockSource,
+                    lazyInit = settings.Config.lazyInit,
                     minLogLevel = settings.Config.minLogLevel,
                     autoInitialize = settings.Config.autoInitialize,
-                    alsoLogToUnity = settings.Config.alsoLogToUnity
+                    shutdownTimeoutMs = settings.Config.shutdownTimeoutMs,
+                    alsoLogToUnity = settings.Config.alsoLogToUnity,
+                    batchMode = settings.Config.batchMode,
+                    batchBufferSize = settings.Config.batchBufferSize
                 };
             }
 
@@ -187,6 +293,270 @@ public static LogLevel GetLogLevel()
             return LogLevel.Info;
         }
 
+        /// <summary>
+        /// Number of messages lost to the overflow policy since initialization.
+        /// </summary>
+        public static ulong GetDroppedCount()
+        {
+            if (!IsInitialized)
+                return 0;
+
+            try
+            {
+                return MLoggerNative.getDroppedCount();
+            }
+            catch (Exception e)
+            {
+                Debug.LogError($"[MLogger] Failed to get dropped count: {e.Message}");
+            }
+
+            return 0;
+        }
+
+        /// <summary>
+        /// Counters kept by the native logger since initialization: messages per level, bytes, rotations,
+        /// flushes, queue depth and call latency. All zero while not initialized.
+        /// </summary>
+        public static MLoggerStats GetStats()
+        {
+            var stats = MLoggerStats.Create();
+            if (!IsInitialized)
+                return stats;
+
+            try
+            {
+                if (MLoggerNative.getStats(ref stats) == 1)
+                    return stats;
+            }
+            catch (Exception e)
+            {
+                Debug.LogError($"[MLogger] Failed to get stats: {e.Message}");
+            }
+
+            return MLoggerStats.Create();
+        }
+
+        /// <summary>
+        /// Whether the native library can compress rotated files with the given codec.
+        /// </summary>
+        public static bool IsCompressionSupported(LogCompression compression)
+        {
+            if (compression == LogCompression.None)
+                return true;
+
+            try
+            {
+                return MLoggerNative.isCompressionSupported((int)compression) == 1;
+            }
+            catch (Exception e)
+            {
+                Debug.LogError($"[MLogger] Failed to query compression support: {e.Message}");
+            }
+
+            return false;
+        }
+
+        /// <summary>
+        /// Whether the log files can be written with io_uring in this process. The native library
+        /// falls back to stdio writes when they cannot.
+        /// </summary>
+        public static bool IsUringWriterSupported()
+        {
+            try
+            {
+                return MLoggerNative.isFileWriterSupported(2) == 1;
+            }
+            catch (Exception e)
+            {
+                Debug.LogError($"[MLogger] Failed to query io_uring support: {e.Message}");
+            }
+
+            return false;
+        }
+
+        /// <summary>
+        /// Logs a message with typed fields, without formatting them on the calling thread. The text log shows them
+        /// as " key=value" after the message, the JSON-lines file (<see cref="MLoggerConfig.jsonLogPath"/>) as members
+        /// of the line's object. Written directly, not batched.
+        /// </summary>
+        public static void LogStructured(LogLevel level, string message, params MLoggerField[] fields)
+        {
+            if (!IsInitialized || (_levelWord != IntPtr.Zero && (int)level < Marshal.ReadInt32(_levelWord)))
+                return;
+
+            try
+            {
+                MLoggerFieldEncoder.Submit(level, message, fields);
+            }
+            catch (Exception e)
+            {
+                Debug.LogError($"[MLogger] Failed to log structured message: {e.Message}");
+            }
+        }
+
+        /// <summary>
+        /// Logs <c>string.Format(format, args)</c>. Formats of plain <c>{0}</c>-style placeholders with primitive or
+        /// string arguments are formatted natively, on the writer thread in async modes; others are formatted here.
+        /// Written directly, not batched.
+        /// </summary>
+        public static void LogFormat(LogLevel level, string format, params object[] args)
+        {
+            if (!IsInitialized || format == null ||
+                (_levelWord != IntPtr.Zero && (int)level < Marshal.ReadInt32(_levelWord)))
+                return;
+
+            try
+            {
+                if (args == null || args.Length == 0)
+                {
+                    MLoggerNative.logMessageUtf16((int)level, format, format.Length);
+                }
+                else if (!MLoggerFormat.TrySubmit(level, format, args))
+                {
+                    var message = string.Format(format, args);
+                    MLoggerNative.logMessageUtf16((int)level, message, message.Length);
+                }
+            }
+            catch (Exception e)
+            {
+                Debug.LogError($"[MLogger] Failed to log formatted message: {e.Message}");
+            }
+        }
+
+        /// <summary>
+        /// Gets the channel with the given name, registering it on first use. Channels can be created before
+        /// initialization and stay valid across re-initialization.
+        /// </summary>
+        /// <returns>The channel, or null for an invalid name or when the native limit of 64 is reached.</returns>
+        public static MLoggerChannel CreateChannel(string name)
+        {
+            if (string.IsNullOrEmpty(name))
+                return null;
+
+            try
+            {
+                var id = MLoggerNative.createChannel(name);
+                if (id >= 0)
+                    return new MLoggerChannel(id, name);
+            }
+            catch (Exception e)
+            {
+                Debug.LogError($"[MLogger] Failed to create channel: {e.Message}");
+            }
+
+            return null;
+        }
+
+        /// <summary>
+        /// Writes the in-memory ring buffer of recent messages (every level) to a text file.
+        /// </summary>
+        /// <param name="path">Target file, or null for the crash dump path next to the log.</param>
+        /// <returns>True if written; false if the ring is disabled or the file cannot be written.</returns>
+        public static bool DumpRing(string path = null)
+        {
+            if (!IsInitialized)
+                return false;
+
+            try
+            {
+                _batch?.Submit();
+                return MLoggerNative.dumpRing(path) == 1;
+            }
+            catch (Exception e)
+            {
+                Debug.LogError($"[MLogger] Failed to dump ring buffer: {e.Message}");
+            }
+
+            return false;
+        }
+
+        /// <summary>
+        /// Appends the lines logged after <paramref name="cursor"/> to <paramref name="lines"/>, without line
+        /// endings, and moves the cursor past them. Reads the native live tail (<see cref="MLoggerConfig.tailBufferSize"/>)
+        /// from memory, never the log file. Start with 0 for the oldest line held or <see cref="GetTailEnd"/> to
+        /// receive only what is logged from now on.
+        /// </summary>
+        /// <returns>False when lines were overwritten before they could be read.</returns>
+        public static bool ReadTail(ref ulong cursor, List<string> lines)
+        {
+            if (!IsInitialized)
+                return true;
+
+            var complete = true;
+            try
+            {
+                _batch?.Submit();
+                _tailBuffer ??= new byte[64 * 1024];
+
+                int copied;
+                while ((copied = MLoggerNative.readSince(ref cursor, _tailBuffer, _tailBuffer.Length, out var skipped)) > 0)
+                {
+                    complete &= skipped == 0;
+                    var text = Encoding.UTF8.GetString(_tailBuffer, 0, copied);
+                    var start = 0;
+                    for (int end; (end = text.IndexOf('\n', start)) >= 0; start = end + 1)
+                        lines.Add(text.Substring(start, end - start).TrimEnd('\r'));
+
+                    // NOTE: only a line longer than the buffer ends without a line ending, its rest is dropped
+                    if (start < text.Length)
+                        lines.Add(text.Substring(start));
+                }
+            }
+            catch (EntryPointNotFoundException)
+            {
+                // NOTE: older native builds lack the export
+            }
+            catch (Exception e)
+            {
+                Debug.LogError($"[MLogger] Failed to read the live tail: {e.Message}");
+            }
+
+            return complete;
+        }
+
+        /// <summary>
+        /// Cursor for <see cref="ReadTail"/> after the newest line, 0 when the live tail is disabled.
+        /// </summary>
+        public static ulong GetTailEnd()
+        {
+            if (!IsInitialized)
+                return 0;
+
+            try
+            {
+                return MLoggerNative.tailEnd();
+            }
+            catch (EntryPointNotFoundException)
+            {
+                return 0;
+            }
+        }
+
+        /// <summary>
+        /// Searches the text log file at <paramref name="path"/> in the native library, which maps the file and scans
+        /// it with SIMD across threads. Works whether or not the logger is running. A line's level is its "[level]"
+        /// field, lines without one count as Info.
+        /// </summary>
+        /// <param name="text">Text the lines must hold, empty for every line.</param>
+        /// <param name="levelMask">Bit 1 &lt;&lt; level for each level to keep, 0 for all.</param>
+        /// <param name="offsets">Receives the byte offsets of the first (or with <see cref="LogSearchFlags.Newest"/>
+        /// the last) matching lines, as many as it holds, in file order.</param>
+        /// <returns>Lines that matched in all; -1 if the file cannot be read or the native library has no search.</returns>
+        public static long SearchLog(string path, string text, LogSearchFlags flags, int levelMask, ulong[] offsets)
+        {
+            try
+            {
+                var bytes = Encoding.UTF8.GetBytes(text ?? "");
+                return MLoggerNative.searchLog(path, bytes, bytes.Length, (int)flags, levelMask, offsets,
+                    offsets?.Length ?? 0);
+            }
+            catch (Exception e) when (e is DllNotFoundException || e is EntryPointNotFoundException)
+            {
+                // NOTE: the caller falls back to searching in managed code
+                return -1;
+            }
+        }
+
         public static void Flush()
         {
             if (!IsInitialized)
@@ -194,6 +564,7 @@ public static void Flush()
 
             try
             {
+                _batch?.Submit();
                 MLoggerNative.flush();
             }
             catch (Exception e)
@@ -207,14 +578,34 @@ public static void Flush()
         /// Flushes logs, terminates native library, and restores Unity log handler.
         /// </summary>
         public static void Shutdown()
+        {
+            Shutdown(-1);
+        }
+
+        /// <summary>
+        /// Shutdown logger waiting at most <paramref name="timeoutMs"/> for queued messages, negative = until
+        /// all are written. Messages not written in time are completed in the background before the
+        /// process exits.
+        /// </summary>
+        /// <returns>True when every message was written within the timeout.</returns>
+        public static bool Shutdown(int timeoutMs)
         {
             if (!IsInitialized)
-                return;
+                return true;
 
+            var done = true;
             try
             {
-                Flush();
-                MLoggerNative.terminate();
+                _batch?.Dispose();
+                if (timeoutMs < 0)
+                {
+                    MLoggerNative.flush();
+                    MLoggerNative.terminate();
+                }
+                else
+                {
+                    done = TerminateAsync(timeoutMs);
+                }
             }
             catch (Exception e)
             {
@@ -226,6 +617,51 @@ public static void Shutdown()
                 CurrentConfig = null;
                 // NOTE: idk how to break the handler binding and switch to default debugger.
                 _handler = null;
+                _batch = null;
+            }
+
+            return done;
+        }
+
+        private static bool TerminateAsync(int timeoutMs)
+        {
+            try
+            {
+                return MLoggerNative.terminateAsync(timeoutMs) == 1;
+            }
+            catch (EntryPointNotFoundException)
+            {
+                MLoggerNative.terminate();
+                return true;
+            }
+        }
+
+        /// <summary>
+        /// Adds a PostLateUpdate player loop step that submits the pending batch once per frame.
+        /// </summary>
+        private static void InstallBatchPump()
+        {
+            if (_batchPumpInstalled)
+                return;
+
+            var loop = PlayerLoop.GetCurrentPlayerLoop();
+            for (var i = 0; i < loop.subSystemList.Length; i++)
+            {
+                if (loop.subSystemList[i].type != typeof(PostLateUpdate))
+                    continue;
+
+                var systems = new List<PlayerLoopSystem>(loop.subSystemList[i].subSystemList)
+                {
+                    new PlayerLoopSystem
+                    {
+                        type = typeof(MLoggerBatch),
+                        updateDelegate = () => _batch?.Submit()
+                    }
+                };
+                loop.subSystemList[i].subSystemList = systems.ToArray();
+                PlayerLoop.SetPlayerLoop(loop);
+                _batchPumpInstalled = true;
+                return;
             }
         }
 
@@ -237,7 +673,11 @@ private static void OnSubsystemRegistration()
 
         private static void OnApplicationQuitting()
         {
-            Shutdown();
+            var timeoutMs = CurrentConfig?.shutdownTimeoutMs ?? -1;
+            if (!Shutdown(timeoutMs))
+            {
+                Debug.LogWarning($"[MLogger] Messages still queued after {timeoutMs} ms, writing them in the background");
+            }
         }
     }
 }
\ No newline at end of file
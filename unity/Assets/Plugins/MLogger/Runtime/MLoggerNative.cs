@@ -13,6 +13,195 @@ public enum LogLevel
         Critical = 5
     }
 
+    /// <summary>
+    /// What a logging call does when the native async queue is full.
+    /// </summary>
+    public enum OverflowPolicy
+    {
+        /// <summary>Wait for the writer thread.</summary>
+        Block = 0,
+
+        /// <summary>Overwrite the oldest queued message.</summary>
+        OverrunOldest = 1,
+
+        /// <summary>Discard the message being logged.</summary>
+        DropNewest = 2
+    }
+
+    /// <summary>
+    /// Encoding of the native log files.
+    /// </summary>
+    public enum LogFileFormat
+    {
+        /// <summary>Formatted text lines.</summary>
+        Text = 0,
+
+        /// <summary>Compact binary records, turned back into text with the mlogger_decode tool.</summary>
+        Binary = 1
+    }
+
+    /// <summary>
+    /// Codec applied to rotated log files by a native background thread. The file being written stays plain.
+    /// </summary>
+    public enum LogCompression
+    {
+        /// <summary>Rotated files are kept as they are.</summary>
+        None = 0,
+
+        /// <summary>gzip (".gz"), readable by any zlib based tool.</summary>
+        Gzip = 1,
+
+        /// <summary>Zstandard (".zst"), faster and smaller; only in builds linked against libzstd.</summary>
+        Zstd = 2
+    }
+
+    /// <summary>
+    /// Clock messages are stamped with when they are logged.
+    /// </summary>
+    public enum LogClockSource
+    {
+        /// <summary>The system clock.</summary>
+        System = 0,
+
+        /// <summary>
+        /// The CPU cycle counter, calibrated against the system clock by a native background thread. Cheaper to read
+        /// at high message rates; CPUs without a constant rate counter keep the system clock.
+        /// </summary>
+        Tsc = 1
+    }
+
+    /// <summary>
+    /// Scheduling of the native threads writing the log files.
+    /// </summary>
+    public enum LogThreadPriority
+    {
+        /// <summary>Left as created.</summary>
+        Normal = 0,
+
+        /// <summary>Below normal; utility QoS on Apple platforms.</summary>
+        Low = 1,
+
+        /// <summary>Lowest; background QoS on Apple platforms, which keeps the threads on the efficiency cores.</summary>
+        Background = 2
+    }
+
+    /// <summary>
+    /// How records are shipped to <see cref="MLoggerConfig.networkAddress"/>.
+    /// </summary>
+    public enum LogNetworkProtocol
+    {
+        /// <summary>One datagram per frame, frames the network loses stay lost.</summary>
+        Udp = 0,
+
+        /// <summary>A stream, reconnected when it breaks; frames pile up while the collector is away.</summary>
+        Tcp = 1
+    }
+
+    /// <summary>
+    /// Options of <see cref="MLoggerManager.SearchLog"/>.
+    /// </summary>
+    [Flags]
+    public enum LogSearchFlags
+    {
+        None = 0,
+
+        /// <summary>ASCII letters match in either case.</summary>
+        IgnoreCase = 1,
+
+        /// <summary>Keep the last matches when there are more than the offsets array holds, instead of the first.</summary>
+        Newest = 2
+    }
+
+    /// <summary>
+    /// Counters kept by the native logger since initialization, mirrors the native MLoggerStats.
+    /// Create instances with <see cref="Create"/> so the arrays and struct size are set up for marshaling.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct MLoggerStats
+    {
+        public const int LevelCount = 6;
+        public const int LatencyBucketCount = 16;
+
+        public uint structSize;
+        public uint latencyBucketCount;
+
+        /// <summary>Messages written to the log file, indexed by <see cref="LogLevel"/>.</summary>
+        [MarshalAs(UnmanagedType.ByValArray, SizeConst = LevelCount)]
+        public ulong[] messages;
+
+        public ulong bytesWritten;
+        public ulong rotations;
+        public ulong flushes;
+
+        /// <summary>Messages lost to the overflow policy, same as <see cref="MLoggerManager.GetDroppedCount"/>.</summary>
+        public ulong dropped;
+
+        /// <summary>Messages waiting for the async writer.</summary>
+        public ulong queueDepth;
+
+        /// <summary>Most messages seen waiting at once; sampled, short peaks may be missed.</summary>
+        public ulong queueHighWater;
+
+        /// <summary>Number of timed calls, every 16th call of each thread.</summary>
+        public ulong latencySamples;
+
+        /// <summary>
+        /// Time a logging call spent handing the message over. Bucket i counts calls under 64 &lt;&lt; i ns,
+        /// the last bucket everything slower.
+        /// </summary>
+        [MarshalAs(UnmanagedType.ByValArray, SizeConst = LatencyBucketCount)]
+        public ulong[] latencyNs;
+
+        /// <summary>Repeated messages held back by duplicate suppression.</summary>
+        public ulong suppressed;
+
+        /// <summary>Messages held back by the rate limit.</summary>
+        public ulong rateLimited;
+
+        /// <summary>Messages sent to the network address.</summary>
+        public ulong shipped;
+
+        /// <summary>Messages the network could not take, they are in the log file only.</summary>
+        public ulong unshipped;
+
+        public static MLoggerStats Create()
+        {
+            return new MLoggerStats
+            {
+                structSize = (uint)Marshal.SizeOf<MLoggerStats>(),
+                messages = new ulong[LevelCount],
+                latencyNs = new ulong[LatencyBucketCount]
+            };
+        }
+
+        public ulong GetMessageCount(LogLevel level)
+        {
+            var index = (int)level;
+            return messages != null && index >= 0 && index < messages.Length ? messages[index] : 0;
+        }
+
+        /// <summary>
+        /// Upper bound in nanoseconds of the latency bucket holding the given percentile (0..1),
+        /// ulong.MaxValue when it falls into the last bucket and 0 without samples.
+        /// </summary>
+        public ulong GetLatencyPercentileNs(double percentile)
+        {
+            if (latencyNs == null || latencySamples == 0)
+                return 0;
+
+            var target = (ulong)Math.Ceiling(Math.Clamp(percentile, 0.0, 1.0) * latencySamples);
+            ulong seen = 0;
+            for (var i = 0; i < latencyNs.Length - 1; i++)
+            {
+                seen += latencyNs[i];
+                if (seen >= target)
+                    return 64UL << i;
+            }
+
+            return ulong.MaxValue;
+        }
+    }
+
     /// <summary>
     /// P/Invoke interface for the native MLogger logging library.
     /// Each static extern method corresponds to a C function in the platform-specific native DLL.
@@ -55,6 +244,127 @@ internal static class MLoggerNative
             int min_log_level
         );
 
+        /// <summary>
+        /// Mirrors the native MLoggerOptions. Set <see cref="structSize"/> to the marshaled size of this struct;
+        /// fields are only ever appended natively, zero means "default" for every optional field.
+        /// </summary>
+        [StructLayout(LayoutKind.Sequential, CharSet = CharSet.Ansi)]
+        public struct MLoggerOptions
+        {
+            public uint structSize;
+            [MarshalAs(UnmanagedType.LPStr)] public string logPath;
+            public ulong maxFileSize;
+            public int maxFiles;
+            public int asyncMode;
+            public int threadPoolSize;
+            public int minLogLevel;
+
+            /// <summary>Async queue capacity in messages, 0 for the native default.</summary>
+            public int queueSize;
+
+            public int overflowPolicy;
+            public int fileFormat;
+
+            /// <summary>0 writes through stdio, 1 through memory-mapped files, 2 through io_uring (Linux, stdio elsewhere).</summary>
+            public int fileWriter;
+
+            /// <summary>Bytes of recent messages of every level kept in memory for <see cref="dumpRing"/>, 0 disables the ring.</summary>
+            public int ringBufferSize;
+
+            /// <summary>1 dumps the ring when the process crashes.</summary>
+            public int crashHandler;
+
+            /// <summary>Where the ring is dumped, null for "&lt;log name&gt;.crash&lt;ext&gt;" next to the log.</summary>
+            [MarshalAs(UnmanagedType.LPStr)] public string crashDumpPath;
+
+            /// <summary>A <see cref="LogCompression"/> value for rotated files.</summary>
+            public int compression;
+
+            /// <summary>Periodic flush in milliseconds, 0 for the native default (1000), negative for none.</summary>
+            public int flushIntervalMs;
+
+            /// <summary>Bytes collected before they are written, 0 for the native default (64 KB), negative for stdio's own buffer.</summary>
+            public int flushBytes;
+
+            /// <summary>Second file receiving every message as one JSON object per line, null for none.</summary>
+            [MarshalAs(UnmanagedType.LPStr)] public string jsonLogPath;
+
+            /// <summary>Lines per block of the "&lt;file&gt;.idx" seek index of text files, 0 or negative for none.</summary>
+            public int indexBlockLines;
+
+            /// <summary>Bytes of recent lines kept in memory for <see cref="readSince"/>, 0 disables the live tail.</summary>
+            public int tailBufferSize;
+
+            /// <summary>A <see cref="LogClockSource"/> value.</summary>
+            public int clockSource;
+
+            /// <summary>1 = return at once and open the log files on a background thread, buffering messages until then.</summary>
+            public int lazyInit;
+
+            /// <summary>Bytes of messages buffered until the files are open, 0 = default (256KB).</summary>
+            public int lazyBufferSize;
+
+            /// <summary>A <see cref="LogThreadPriority"/> value for the threads writing the files.</summary>
+            public int writerPriority;
+
+            /// <summary>Name of the threads writing the files, null for "mlogger", empty to leave them unnamed; cut to 15 bytes.</summary>
+            [MarshalAs(UnmanagedType.LPStr)] public string writerThreadName;
+
+            /// <summary>CPUs the threads writing the files may run on, bit i for CPU i, 0 for any; not supported on Apple platforms.</summary>
+            public ulong writerAffinity;
+
+            /// <summary>Repeats of a message within this many milliseconds are counted and reported as "last message repeated N times" instead of written, 0 = off.</summary>
+            public int dedupWindowMs;
+
+            /// <summary>Messages per second per channel and level, 0 = unlimited; critical messages are never limited.</summary>
+            public int rateLimit;
+
+            /// <summary>Messages passing at once before the rate limit applies, 0 = <see cref="rateLimit"/>.</summary>
+            public int rateLimitBurst;
+
+            /// <summary>1 = files written through io_uring bypass the page cache (O_DIRECT).</summary>
+            public int directIo;
+
+            /// <summary>"host:port" every message is also shipped to by a native thread, null for none.</summary>
+            [MarshalAs(UnmanagedType.LPStr)] public string networkAddress;
+
+            /// <summary>A <see cref="LogNetworkProtocol"/> value.</summary>
+            public int networkProtocol;
+
+            /// <summary>A <see cref="LogCompression"/> value for each frame; unsupported codecs send frames as they are.</summary>
+            public int networkCompression;
+
+            /// <summary>Message bytes per frame, 0 for the native default (1200 for UDP, 64 KB for TCP).</summary>
+            public int networkFrameSize;
+
+            /// <summary>Bytes of frames waiting for the network, 0 for the native default (1 MB); messages beyond are not shipped.</summary>
+            public int networkBufferSize;
+
+            /// <summary>Named shared memory segment messages are published to for mlogger_aggregate; this process then writes no files. Null for none.</summary>
+            [MarshalAs(UnmanagedType.LPStr)] public string sharedMemoryName;
+
+            /// <summary>Ring bytes if the segment is created by this process, 0 for the native default (4 MB).</summary>
+            public int sharedMemorySize;
+        }
+
+        /// <summary>
+        /// Initializes the MLogger native logging system from an options struct.
+        /// </summary>
+        /// <param name="options">Options with <c>structSize</c> set.</param>
+        /// <returns>1 if initialized successfully, 0 otherwise.</returns>
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int initWithOptions([In] ref MLoggerOptions options);
+
+        /// <summary>
+        /// Applies new options to the running logger without stopping it. Logging goes on while the new
+        /// file, level and sinks are set up; records already queued are written by the old backend in the
+        /// background. Initializes the logger when it is not.
+        /// </summary>
+        /// <param name="options">Options with <c>structSize</c> set.</param>
+        /// <returns>1 on success; 0 otherwise, the current settings stay in effect.</returns>
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int reconfigure([In] ref MLoggerOptions options);
+
         /// <summary>
         /// Initializes the MLogger with default configuration and log path.
         /// </summary>
@@ -76,6 +386,105 @@ int min_log_level
             [MarshalAs(UnmanagedType.LPStr)] string message
         );
 
+        /// <summary>
+        /// Logs a message as the UTF-16 characters of the string. The string is pinned and passed as it is, with no
+        /// native copy or ANSI conversion; the native writer converts it to UTF-8, so any text is kept intact.
+        /// </summary>
+        /// <param name="log_level">Severity level (0-Trace ... 5-Critical).</param>
+        /// <param name="message">Log message string.</param>
+        /// <param name="length">Characters of <paramref name="message"/> to log, usually its Length.</param>
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Unicode)]
+        public static extern void logMessageUtf16(
+            int log_level,
+            [MarshalAs(UnmanagedType.LPWStr)] string message,
+            int length
+        );
+
+        /// <summary>
+        /// Mirrors the native LogRecord: a length-delimited UTF-8 message plus its level and timestamp.
+        /// The layout is fixed at 24 bytes on every target.
+        /// </summary>
+        [StructLayout(LayoutKind.Explicit, Size = 24)]
+        public struct LogRecord
+        {
+            /// <summary>Microseconds since the Unix epoch, 0 to stamp at submission.</summary>
+            [FieldOffset(0)] public long timestampUs;
+
+            /// <summary>Address of the UTF-8 bytes, usually inside a pinned buffer.</summary>
+            [FieldOffset(8)] public IntPtr message;
+
+            /// <summary>Message size in bytes, no terminator required.</summary>
+            [FieldOffset(16)] public int length;
+
+            [FieldOffset(20)] public int level;
+        }
+
+        /// <summary>
+        /// Submits several records with a single native transition. The message memory must stay pinned
+        /// for the duration of the call only.
+        /// </summary>
+        /// <param name="records">Records to submit.</param>
+        /// <param name="count">Number of leading entries of <paramref name="records"/> to submit.</param>
+        /// <returns>Number of records that passed the native level filter.</returns>
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int logBatch([In] LogRecord[] records, int count);
+
+        /// <summary>
+        /// Mirrors the native LogField: one key/value pair of a <see cref="logStructured"/> call, keys and strings
+        /// as length-delimited UTF-8. The layout is fixed at 24 bytes on every target.
+        /// </summary>
+        [StructLayout(LayoutKind.Explicit, Size = 24)]
+        public struct LogField
+        {
+            [FieldOffset(0)] public IntPtr key;
+
+            [FieldOffset(8)] public long intValue;
+            [FieldOffset(8)] public double doubleValue;
+            [FieldOffset(8)] public float floatValue;
+            [FieldOffset(8)] public IntPtr stringValue;
+
+            /// <summary>A <see cref="MLoggerFieldType"/> value.</summary>
+            [FieldOffset(16)] public ushort type;
+
+            [FieldOffset(18)] public ushort keyLength;
+
+            [FieldOffset(20)] public int stringLength;
+        }
+
+        /// <summary>
+        /// Logs a message with typed fields: " key=value" after the message in the text file, members of the
+        /// line's object in the JSON-lines file. Key and string memory must stay pinned for the duration of the call only.
+        /// </summary>
+        /// <param name="log_level">Severity level (0-Trace ... 5-Critical).</param>
+        /// <param name="message">Log message string.</param>
+        /// <param name="fields">Fields to attach.</param>
+        /// <param name="field_count">Number of leading entries of <paramref name="fields"/> to attach.</param>
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
+        public static extern void logStructured(
+            int log_level,
+            [MarshalAs(UnmanagedType.LPStr)] string message,
+            [In] LogField[] fields,
+            int field_count
+        );
+
+        /// <summary>
+        /// Interns an fmt format string for <see cref="logFormatted"/>. The same text always yields the same id
+        /// for the process lifetime.
+        /// </summary>
+        /// <returns>The format id, or -1 for null or when the native table of 16384 formats is full.</returns>
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
+        public static extern int registerFormat([MarshalAs(UnmanagedType.LPStr)] string format);
+
+        /// <summary>
+        /// Logs a registered format with encoded arguments, formatted by the native writer thread in async modes.
+        /// </summary>
+        /// <param name="log_level">Severity level (0-Trace ... 5-Critical).</param>
+        /// <param name="format_id">Id returned by <see cref="registerFormat"/>.</param>
+        /// <param name="args">Per argument a type byte followed by its value in native byte order, see bridge.h.</param>
+        /// <param name="args_size">Number of leading bytes of <paramref name="args"/> to use.</param>
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void logFormatted(int log_level, int format_id, [In] byte[] args, int args_size);
+
         /// <summary>
         /// Logs an exception record to the native logger at Error severity, including type, message, and stack trace.
         /// </summary>
@@ -89,6 +498,108 @@ int min_log_level
             [MarshalAs(UnmanagedType.LPStr)] string stack_trace
         );
 
+        /// <summary>
+        /// Logs an exception record at the given severity. Critical severity also dumps the ring buffer to the crash dump path.
+        /// </summary>
+        /// <param name="log_level">Severity level (0-Trace ... 5-Critical).</param>
+        /// <param name="exception_type">Full type name of exception.</param>
+        /// <param name="message">Exception message.</param>
+        /// <param name="stack_trace">Exception stack trace string.</param>
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
+        public static extern void logExceptionWithLevel(
+            int log_level,
+            [MarshalAs(UnmanagedType.LPStr)] string exception_type,
+            [MarshalAs(UnmanagedType.LPStr)] string message,
+            [MarshalAs(UnmanagedType.LPStr)] string stack_trace
+        );
+
+        /// <summary>
+        /// Registers a named channel that shares the native log file and async backend but has its own level.
+        /// May be called before init; ids stay valid across init/terminate for the process lifetime.
+        /// </summary>
+        /// <param name="name">Channel name written in place of "mlogger", 1-63 bytes.</param>
+        /// <returns>Channel id, the same one for the same name; -1 for an invalid name or when all 64 are taken.</returns>
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
+        public static extern int createChannel([MarshalAs(UnmanagedType.LPStr)] string name);
+
+        /// <summary>
+        /// Logs a message on a channel, filtered by the channel's level first.
+        /// </summary>
+        /// <param name="channel">Id returned by <see cref="createChannel"/>, 0 for the default logger.</param>
+        /// <param name="log_level">Severity level (0-Trace ... 5-Critical).</param>
+        /// <param name="message">Log message string.</param>
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
+        public static extern void logChannel(
+            int channel,
+            int log_level,
+            [MarshalAs(UnmanagedType.LPStr)] string message
+        );
+
+        /// <summary>
+        /// Same as <see cref="logMessageUtf16"/> on a channel, filtered by the channel's level first.
+        /// </summary>
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Unicode)]
+        public static extern void logChannelUtf16(
+            int channel,
+            int log_level,
+            [MarshalAs(UnmanagedType.LPWStr)] string message,
+            int length
+        );
+
+        /// <summary>
+        /// Sets a channel's minimum level: 0-5, 6 to silence it or -1 to follow <see cref="setLogLevel"/> again.
+        /// </summary>
+        /// <returns>1 on success; 0 for unknown channels and invalid levels.</returns>
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int setChannelLevel(int channel, int log_level);
+
+        /// <summary>
+        /// Gets a channel's level, -1 when it follows the global level and 6 for unknown channels.
+        /// </summary>
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int getChannelLevel(int channel);
+
+        /// <summary>
+        /// Writes the in-memory ring buffer, which holds recent messages of every level, to a text file.
+        /// </summary>
+        /// <param name="path">Target file, or null for the crash dump path.</param>
+        /// <returns>1 if written; 0 if the ring is disabled or the file cannot be written.</returns>
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
+        public static extern int dumpRing([MarshalAs(UnmanagedType.LPStr)] string path);
+
+        /// <summary>
+        /// Copies the whole lines logged after <paramref name="cursor"/> into <paramref name="buffer"/> (UTF-8, line
+        /// endings included) and moves the cursor past them. A line longer than the buffer is cut.
+        /// </summary>
+        /// <param name="skipped">1 when lines were overwritten before they could be read.</param>
+        /// <returns>Bytes copied; 0 when nothing is new or the live tail is disabled.</returns>
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int readSince(ref ulong cursor, byte[] buffer, int bufferSize, out int skipped);
+
+        /// <summary>
+        /// Cursor after the newest line of the live tail, 0 when it is disabled.
+        /// </summary>
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern ulong tailEnd();
+
+        /// <summary>
+        /// Searches a text log file for the lines holding <paramref name="text"/> (UTF-8, 0 bytes = every line) whose
+        /// level is in <paramref name="levelMask"/> (bit 1 &lt;&lt; LogLevel, 0 = every level). Needs no init.
+        /// </summary>
+        /// <param name="flags">LogSearchFlags.</param>
+        /// <param name="offsets">Receives the byte offsets of up to <paramref name="maxOffsets"/> matching lines.</param>
+        /// <returns>Lines that matched in all; -1 if the file cannot be read.</returns>
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
+        public static extern long searchLog(
+            [MarshalAs(UnmanagedType.LPStr)] string path,
+            byte[] text,
+            int textSize,
+            int flags,
+            int levelMask,
+            [Out] ulong[] offsets,
+            int maxOffsets
+        );
+
         /// <summary>
         /// Immediately flushes all log buffers, forcing the native logger to write pending data to disk.
         /// Useful for ensuring logs are up-to-date during critical operations or shutdown.
@@ -111,6 +622,49 @@ int min_log_level
         [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
         public static extern int getLogLevel();
 
+        /// <summary>
+        /// Gets the address of the native level word. Messages with a level below the value stored there
+        /// are dropped natively, so managed callers can read it with <see cref="Marshal.ReadInt32(IntPtr)"/>
+        /// and skip formatting and marshaling. The address stays valid for the lifetime of the library;
+        /// the value is 6 (off) while the logger is not initialized.
+        /// </summary>
+        /// <returns>Pointer to a 32-bit level word.</returns>
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern IntPtr getLogLevelPtr();
+
+        /// <summary>
+        /// Gets the number of messages lost to the overflow policy since the last successful initialization.
+        /// </summary>
+        /// <returns>Dropped message count.</returns>
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern ulong getDroppedCount();
+
+        /// <summary>
+        /// Reads the native counters collected since the last initialization, without rescanning the log file.
+        /// </summary>
+        /// <param name="stats">Struct from <see cref="MLoggerStats.Create"/>, filled up to its <c>structSize</c>.</param>
+        /// <returns>1 if filled; 0 if the struct size is not supported.</returns>
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int getStats(ref MLoggerStats stats);
+
+        /// <summary>
+        /// Checks whether the native library was built with a codec. Unsupported codecs are reported
+        /// at initialization and leave rotated files uncompressed.
+        /// </summary>
+        /// <param name="compression">A <see cref="LogCompression"/> value.</param>
+        /// <returns>1 if supported; 0 otherwise.</returns>
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int isCompressionSupported(int compression);
+
+        /// <summary>
+        /// Checks whether a file writer works in this process. io_uring needs Linux 5.6 or later and
+        /// is refused by many sandboxes; the logger then writes with stdio.
+        /// </summary>
+        /// <param name="fileWriter">0 for stdio, 1 for memory-mapped files, 2 for io_uring.</param>
+        /// <returns>1 if supported; 0 otherwise.</returns>
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int isFileWriterSupported(int fileWriter);
+
         /// <summary>
         /// Checks whether the native logger has been initialized.
         /// </summary>
@@ -124,5 +678,14 @@ int min_log_level
         /// </summary>
         [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
         public static extern void terminate();
+
+        /// <summary>
+        /// Stops logging like <see cref="terminate"/>, but writes the queued records on a background thread
+        /// and waits for them at most <paramref name="timeout_ms"/> (0 = not at all). Records not written in
+        /// time are completed in the background before the library unloads.
+        /// </summary>
+        /// <returns>1 when every record was written within the timeout; 0 otherwise.</returns>
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int terminateAsync(int timeout_ms);
     }
 }
\ No newline at end of file